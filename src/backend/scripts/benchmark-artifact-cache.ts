@@ -0,0 +1,124 @@
+/**
+ * @fileoverview Measures end-to-end ingest latency with and without the shared artifact cache.
+ * Many users capture the same article; the first ingest runs the full pipeline and the rest
+ * are served from the shared artifact. Model calls are simulated with fixed latencies.
+ *
+ * Usage: tsx scripts/benchmark-artifact-cache.ts [--users 50] [--chunks 4] [--analyze-ms 1500]
+ *        [--moderate-ms 300] [--generate-ms 4000]
+ * Set REDIS_URL to measure against a real Redis instead of an in-process store.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { ICard } from '../src/interfaces/ICard';
+import { IContent, ContentStatus } from '../src/interfaces/IContent';
+import { ContentProcessor, PreparedContent } from '../src/core/ai/contentProcessor';
+import { ContentPipeline } from '../src/core/ai/contentPipeline';
+import { SharedArtifactCache } from '../src/core/ai/sharedArtifactCache';
+import { InMemoryRedisStore } from '../tests/utils/inMemoryRedis';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const users = option('--users', 50);
+const chunkCount = option('--chunks', 4);
+const analyzeMs = option('--analyze-ms', 1500);
+const moderateMs = option('--moderate-ms', 300);
+const generateMs = option('--generate-ms', 4000);
+const CARDS_PER_CHUNK = 5;
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+const article = Array.from({ length: chunkCount }, (_, i) =>
+  `Section ${i + 1}\n\n${'Retrieval practice strengthens memory traces. '.repeat(40)}`
+).join('\n\n');
+
+// Stands in for ContentProcessor with the latency of its model calls
+const simulatedProcessor = {
+  prepareContent: (content: IContent): PreparedContent => ({
+    content,
+    sanitized: content.content,
+    chunks: content.content.split(/\n\n(?=Section)/).map((text, index) => ({
+      text, tokenCount: 1000, overlapTokens: 0, start: index * text.length, end: (index + 1) * text.length
+    }))
+  }),
+  analyzePrepared: async () => {
+    await delay(analyzeMs);
+    return { isProcessable: true };
+  },
+  toChunkContents: (prepared: PreparedContent) => prepared.chunks.map((chunk, index) => ({
+    ...prepared.content,
+    content: chunk.text,
+    metadata: { ...prepared.content.metadata, chunkIndex: index, chunkCount }
+  })),
+  moderateChunk: async (chunk: IContent) => {
+    await delay(moderateMs);
+    return chunk;
+  },
+  generateChunkCards: async (chunk: IContent) => {
+    await delay(generateMs);
+    return Array.from({ length: CARDS_PER_CHUNK }, (_, n) => ({
+      id: `${chunk.id}-${chunk.metadata.chunkIndex}-${n}`,
+      userId: chunk.userId,
+      contentId: chunk.id,
+      frontContent: { text: `Question ${n}`, type: 'text', metadata: { aiGenerated: true, lastModifiedBy: 'system' } },
+      backContent: { text: `Answer ${n}`, type: 'text', metadata: { aiGenerated: true, lastModifiedBy: 'system' } },
+      compatibleModes: ['standard'],
+      tags: []
+    }) as unknown as ICard);
+  },
+  completeProcessing: (content: IContent) => ({ ...content, status: ContentStatus.PROCESSED }),
+  failProcessing: () => undefined
+} as unknown as ContentProcessor;
+
+const capture = (index: number): IContent => ({
+  id: `content-${index}`,
+  userId: `user-${index}`,
+  content: article,
+  metadata: { contentType: 'text' },
+  source: 'web',
+  // Different share links for the same article
+  sourceUrl: `https://www.example.com/posts/retrieval-practice/?utm_source=share${index}`,
+  status: ContentStatus.NEW,
+  createdAt: new Date(),
+  updatedAt: new Date(),
+  processedAt: null
+});
+
+const percentile = (values: number[], p: number): number => {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+};
+
+const main = async () => {
+  const client = process.env.REDIS_URL ? new Redis(process.env.REDIS_URL) : new InMemoryRedisStore().client();
+  const artifactCache = new SharedArtifactCache(client);
+  const pipeline = new ContentPipeline(simulatedProcessor, async (cards) => cards, { artifactCache });
+
+  const timed = async (content: IContent) => {
+    const started = process.hrtime.bigint();
+    const { cards } = await pipeline.process(content);
+    return { ms: Number(process.hrtime.bigint() - started) / 1e6, cards: cards.length };
+  };
+
+  const first = await timed(capture(0));
+  const rest: number[] = [];
+  for (let i = 1; i < users; i++) {
+    rest.push((await timed(capture(i))).ms);
+  }
+
+  const stats = artifactCache.getStats();
+  console.log(`${users} users, ${chunkCount} chunks, ${first.cards} cards per ingest`);
+  console.log(`miss  ${first.ms.toFixed(1).padStart(9)} ms`);
+  console.log(`hit   p50 ${percentile(rest, 0.5).toFixed(2)} ms  p95 ${percentile(rest, 0.95).toFixed(2)} ms`);
+  console.log(`hit rate ${(stats.hitRate * 100).toFixed(1)}% (${stats.hits} hits, ${stats.misses} misses)`);
+
+  client.disconnect();
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
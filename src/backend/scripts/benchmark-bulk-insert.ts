@@ -0,0 +1,118 @@
+/**
+ * @fileoverview Throughput benchmark of card creation.
+ * Creates the same cards one insert per card, concurrently as the services did before,
+ * and through Card.createMany's chunked multi-row inserts. Both run against an
+ * in-memory client whose queries cost a fixed round trip plus a per-row write time and
+ * share a small connection pool, as Supabase requests do.
+ *
+ * Usage: tsx scripts/benchmark-bulk-insert.ts [--cards 10000] [--latency-ms 5] [--row-us 20] [--pool 10]
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { ContentType, ICard } from '../src/interfaces/ICard';
+
+// The model imports the service container, which builds its Supabase client on import;
+// every query here goes to the in-memory client, so placeholders are enough
+process.env.SUPABASE_URL = process.env.SUPABASE_URL || 'http://localhost:54321';
+process.env.SUPABASE_ANON_KEY = process.env.SUPABASE_ANON_KEY || 'benchmark'.padEnd(40, '-');
+process.env.SUPABASE_SERVICE_ROLE_KEY = process.env.SUPABASE_SERVICE_ROLE_KEY || 'benchmark'.padEnd(40, '-');
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { Card } = require('../src/models/Card');
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const cardCount = option('--cards', 10000);
+const latencyMs = option('--latency-ms', 5);
+const rowUs = option('--row-us', 20);
+const poolSize = option('--pool', 10);
+
+/**
+ * Enough of the Supabase client for card inserts; each insert holds one pooled
+ * connection for a round trip plus its rows' write time
+ */
+const createClient = () => {
+  let queries = 0;
+  let active = 0;
+  const waiting: Array<() => void> = [];
+  const acquire = () => new Promise<void>((resolve) => {
+    if (active < poolSize) {
+      active++;
+      resolve();
+    } else {
+      waiting.push(resolve);
+    }
+  });
+  const release = () => {
+    const next = waiting.shift();
+    if (next) {
+      next();
+    } else {
+      active--;
+    }
+  };
+
+  const insert = (values: ICard | ICard[]) => {
+    const inserted = Array.isArray(values) ? values : [values];
+    const run = async () => {
+      await acquire();
+      try {
+        await new Promise((resolve) => setTimeout(resolve, latencyMs + (inserted.length * rowUs) / 1000));
+        queries++;
+        return inserted.map((row) => ({ ...row }));
+      } finally {
+        release();
+      }
+    };
+    const select = () => ({
+      single: async () => ({ data: (await run())[0], error: null }),
+      then: (resolve: (result: unknown) => void, reject: (error: unknown) => void) =>
+        run().then((data) => ({ data, error: null })).then(resolve, reject)
+    });
+    return { select };
+  };
+
+  const channel: any = { on: () => channel, subscribe: () => ({ unsubscribe: async () => undefined }) };
+  const client = { from: () => ({ insert }), channel: () => channel } as unknown as SupabaseClient;
+  return { client, queries: () => queries };
+};
+
+const cardData = (i: number): Partial<ICard> => ({
+  userId: 'benchmark-user',
+  contentId: `content-${i % 100}`,
+  frontContent: { text: `Question ${i}`, type: ContentType.TEXT, metadata: {} as ICard['frontContent']['metadata'] },
+  backContent: { text: `Answer ${i}`, type: ContentType.TEXT, metadata: {} as ICard['backContent']['metadata'] }
+});
+
+const measure = async (label: string, create: (model: any, cards: Partial<ICard>[]) => Promise<ICard[]>) => {
+  const { client, queries } = createClient();
+  const model = new Card(client);
+  const cards = Array.from({ length: cardCount }, (_, i) => cardData(i));
+
+  const started = process.hrtime.bigint();
+  const created = await create(model, cards);
+  const elapsedMs = Number(process.hrtime.bigint() - started) / 1e6;
+
+  if (created.some((card, i) => card.frontContent.text !== cards[i].frontContent!.text)) {
+    throw new Error(`${label}: cards returned out of order`);
+  }
+  console.log(`${label.padEnd(10)} ${String(queries()).padStart(6)} queries  ` +
+    `${elapsedMs.toFixed(0).padStart(6)} ms  ${((cardCount / elapsedMs) * 1000).toFixed(0).padStart(7)} cards/s`);
+};
+
+const main = async () => {
+  console.log(`${cardCount} cards, ${latencyMs} ms per query + ${rowUs} us per row, ${poolSize} connections`);
+  await measure('per-card', (model, cards) => Promise.all(cards.map((card) => model.create(card))));
+  await measure('bulk', (model, cards) => model.createMany(cards));
+
+  // The service container keeps its clients open
+  process.exit(0);
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,111 @@
+/**
+ * @fileoverview Benchmarks near-duplicate card detection.
+ * Reports the insert-path overhead per card against a populated per-user index, and
+ * precision/recall on a labeled set of reworded duplicates and same-template non-duplicates.
+ *
+ * Usage: tsx scripts/benchmark-card-dedup.ts [--existing 5000] [--batch 20] [--pairs 500]
+ * Set REDIS_URL to measure against a real Redis instead of an in-process store.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { CardText, NearDuplicateIndex } from '../src/core/cards/nearDuplicateIndex';
+import { InMemoryRedisStore } from '../tests/utils/inMemoryRedis';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const existing = option('--existing', 5000);
+const batchSize = option('--batch', 20);
+const pairs = option('--pairs', 500);
+
+let seed = 11;
+const random = () => (seed = (seed * 1103515245 + 12345) % 2147483648) / 2147483648;
+const pick = <T>(items: T[]): T => items[Math.floor(random() * items.length)];
+
+const ENTITIES = ['mitochondria', 'ribosome', 'photosynthesis', 'the French Revolution', 'TCP handshake', 'binary search',
+  'the Krebs cycle', 'supply and demand', 'plate tectonics', 'the Treaty of Versailles', 'a hash table', 'osmosis',
+  'the Pythagorean theorem', 'inflation', 'natural selection', 'the Doppler effect', 'a B-tree', 'the Magna Carta'];
+const ASPECTS = ['main purpose', 'key mechanism', 'historical significance', 'typical example', 'main limitation', 'origin'];
+const SYLLABLES = ['ka', 'lo', 'mer', 'sin', 'tra', 'vel', 'cor', 'pho', 'gen', 'ix', 'dur', 'ben', 'sta', 'qui', 'ron',
+  'fal', 'met', 'ul', 'zo', 'pra', 'chi', 'nod', 'es', 'tum', 'ver', 'lin', 'gra', 'so', 'pel', 'ard'];
+const FILLERS = ['basically', 'essentially', 'in short', 'generally'];
+
+// Pseudo-words give card text a realistic vocabulary size
+const word = () => Array.from({ length: 2 + Math.floor(random() * 2) }, () => pick(SYLLABLES)).join('');
+const phrase = (length: number) => Array.from({ length }, word).join(' ');
+
+const randomCard = (): CardText => ({
+  front: `What is the ${pick(ASPECTS)} of ${pick(ENTITIES)} for ${phrase(2)}?`,
+  back: `It is ${phrase(6)}, which explains the ${phrase(4)} observed in practice.`
+});
+
+// Rewording a model produces for the same fact from an overlapping chunk
+const reword = ({ front, back }: CardText): CardText => {
+  const words = back.split(' ');
+  const edits = 1 + Math.floor(random() * 2);
+  for (let i = 0; i < edits; i++) {
+    const at = Math.floor(random() * words.length);
+    if (random() < 0.5) {
+      words.splice(at, 0, pick(FILLERS));
+    } else {
+      words[at] = words[at].toUpperCase();
+    }
+  }
+  return { front: front.replace('?', '').replace('What is', 'What\'s'), back: `${words.join(' ')}!` };
+};
+
+const main = async () => {
+  const client = process.env.REDIS_URL ? new Redis(process.env.REDIS_URL) : new InMemoryRedisStore().client();
+  const index = new NearDuplicateIndex(client);
+  const userId = `bench-${Date.now()}`;
+
+  // Insert-path overhead against a populated index
+  for (let i = 0; i < existing; i += 500) {
+    await index.add(userId, Array.from({ length: Math.min(500, existing - i) }, (_, j) => ({ id: `c${i + j}`, ...randomCard() })));
+  }
+  const rounds = 50;
+  const started = process.hrtime.bigint();
+  for (let round = 0; round < rounds; round++) {
+    const batch = Array.from({ length: batchSize }, randomCard);
+    await index.classify(userId, batch);
+    await index.add(userId, batch.map((card, i) => ({ id: `n${round}-${i}`, ...card })));
+  }
+  const perCardMs = Number(process.hrtime.bigint() - started) / 1e6 / (rounds * batchSize);
+
+  // Labeled recall: half reworded duplicates, half fresh cards sharing the question template
+  const labeledUser = `${userId}-labeled`;
+  const originals = Array.from({ length: pairs }, (_, i) => ({ id: `o${i}`, ...randomCard() }));
+  await index.add(labeledUser, originals);
+  const probes = originals.map((card, i) => (i % 2 === 0
+    ? { card: reword(card), duplicate: true }
+    : { card: { front: card.front, back: randomCard().back }, duplicate: false }));
+  const verdicts = (await Promise.all(probes.map(({ card }) => index.classify(labeledUser, [card])))).map(([verdict]) => verdict);
+
+  const score = (predicted: (status: string) => boolean) => {
+    let tp = 0;
+    let fp = 0;
+    let fn = 0;
+    verdicts.forEach((verdict, i) => {
+      const positive = predicted(verdict.status);
+      if (positive && probes[i].duplicate) tp++;
+      if (positive && !probes[i].duplicate) fp++;
+      if (!positive && probes[i].duplicate) fn++;
+    });
+    return `precision ${(tp / Math.max(1, tp + fp) * 100).toFixed(1)}%  recall ${(tp / Math.max(1, tp + fn) * 100).toFixed(1)}%`;
+  };
+
+  console.log(`${existing} indexed cards, batches of ${batchSize}`);
+  console.log(`insert-path overhead ${perCardMs.toFixed(3)} ms per card`);
+  console.log(`merged   ${score((status) => status === 'duplicate')}`);
+  console.log(`flagged+ ${score((status) => status !== 'unique')}`);
+
+  client.disconnect();
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,207 @@
+/**
+ * @fileoverview Benchmark for compiled validation and serialization on the hot routes.
+ * Serves card and study routes twice from a child process — once validating with Joi
+ * and responding with res.json, once through the compiled validators and stringifiers —
+ * drives each with autocannon, and compares throughput, p99 latency and server CPU per request.
+ *
+ * Usage: tsx scripts/benchmark-hot-routes.ts [--seconds 10] [--connections 50] [--cards 50]
+ * @version 1.0.0
+ */
+
+import { fork } from 'child_process';
+import { randomUUID } from 'crypto';
+import express, { Request, Response } from 'express';
+import autocannon from 'autocannon';
+import { compiledCardSchemas, validateCreateCard } from '../src/api/validators/card.validator';
+import { compiledSessionSchemas } from '../src/api/validators/study.validator';
+import { serializeCardListResponse, serializeCardResponse } from '../src/api/serializers/card.serializer';
+import { serializeStudySession, serializeStudySessionResponse } from '../src/api/serializers/study.serializer';
+import { sendJson } from '../src/utils/jsonStringifier';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const seconds = option('--seconds', 10);
+const connections = option('--connections', 50);
+const cardCount = option('--cards', 50);
+
+const cardBody = () => ({
+  frontContent: {
+    text: 'What does the forgetting curve describe?',
+    type: 'text',
+    metadata: { sourcePosition: { start: 4, end: 40 }, aiGenerated: true, generationPrompt: 'Q&A', lastModifiedBy: 'ai' }
+  },
+  backContent: {
+    text: 'Exponential loss of retention over time, flattened by spaced review',
+    type: 'markdown',
+    metadata: { sourceUrl: 'https://example.com/notes?id=4', aiGenerated: false, lastModifiedBy: 'user' }
+  },
+  fsrsData: { stability: 4.2, difficulty: 0.3, reviewCount: 2, lastReview: '2024-05-01T10:00:00.000Z', lastRating: 3 },
+  compatibleModes: ['standard'],
+  tags: ['memory', 'psychology']
+});
+
+const sessionBody = () => ({
+  userId: randomUUID(),
+  mode: 'standard',
+  startTime: '2024-05-01T10:00:00.000Z',
+  endTime: '2024-05-01T10:30:00.000Z',
+  cardsStudied: [randomUUID(), randomUUID()],
+  voiceEnabled: false,
+  status: 'active',
+  settings: { sessionDuration: 1800, showConfidenceButtons: true, enableFSRS: false }
+});
+
+// Cards as the repository returns them, in ICard key order
+const storedCard = () => {
+  const body = cardBody();
+  return {
+    id: randomUUID(),
+    userId: randomUUID(),
+    contentId: randomUUID(),
+    frontContent: body.frontContent,
+    backContent: body.backContent,
+    fsrsData: { ...body.fsrsData, lastReview: new Date(body.fsrsData.lastReview) },
+    nextReview: new Date(),
+    compatibleModes: body.compatibleModes,
+    tags: body.tags,
+    createdAt: new Date(),
+    updatedAt: new Date()
+  };
+};
+
+// Session state in IStudySession key order
+const storedSession = () => {
+  const { userId, mode, cardsStudied, voiceEnabled, status, settings } = sessionBody();
+  return {
+    id: randomUUID(),
+    userId,
+    mode,
+    startTime: new Date('2024-05-01T10:00:00.000Z'),
+    endTime: new Date('2024-05-01T10:30:00.000Z'),
+    cardsStudied,
+    performance: {
+      totalCards: 20, correctCount: 16, averageConfidence: 0.8, studyStreak: 4, timeSpent: 1250,
+      fsrsProgress: { averageStability: 3.5, averageDifficulty: 0.4, retentionRate: 0.9, intervalProgress: 0.6 }
+    },
+    voiceEnabled,
+    status,
+    settings
+  };
+};
+
+const serve = () => {
+  const app = express();
+  app.use(express.json());
+  const dueCards = Array.from({ length: cardCount }, storedCard);
+  const session = storedSession();
+
+  const fail = (res: Response, error: Error) => res.status(400).json({ error: error.message });
+
+  app.post('/joi/cards', async (req: Request, res: Response) => {
+    try {
+      const value = await compiledCardSchemas.create.schema.validateAsync(req.body);
+      res.status(201).json({ success: true, data: { ...storedCard(), ...value } });
+    } catch (error) {
+      fail(res, error as Error);
+    }
+  });
+  app.post('/compiled/cards', async (req: Request, res: Response) => {
+    try {
+      const value = await validateCreateCard(req.body);
+      sendJson(res.status(201), serializeCardResponse, { success: true, data: { ...storedCard(), ...value } });
+    } catch (error) {
+      fail(res, error as Error);
+    }
+  });
+
+  app.get('/joi/cards/due', (_req: Request, res: Response) => {
+    res.json({ success: true, data: dueCards, metadata: { count: dueCards.length, mode: 'standard' } });
+  });
+  app.get('/compiled/cards/due', (_req: Request, res: Response) => {
+    sendJson(res, serializeCardListResponse, {
+      success: true, data: dueCards, metadata: { count: dueCards.length, mode: 'standard' }
+    });
+  });
+
+  app.post('/joi/study/sessions', (req: Request, res: Response) => {
+    const { error, value } = compiledSessionSchemas.create.schema.validate(req.body);
+    if (error) return fail(res, error);
+    res.status(201).json({ success: true, data: { id: session.id, ...value }, performance: { duration: 1 } });
+  });
+  app.post('/compiled/study/sessions', (req: Request, res: Response) => {
+    const { error, value } = compiledSessionSchemas.create.validate(req.body);
+    if (error) return fail(res, error);
+    sendJson(res.status(201), serializeStudySessionResponse, {
+      success: true, data: { id: session.id, ...value }, performance: { duration: 1 }
+    });
+  });
+
+  app.get('/joi/study/sessions/:id', (_req: Request, res: Response) => {
+    res.json(session);
+  });
+  app.get('/compiled/study/sessions/:id', (_req: Request, res: Response) => {
+    sendJson(res, serializeStudySession, session);
+  });
+
+  app.get('/cpu', (_req: Request, res: Response) => {
+    res.json(process.cpuUsage());
+  });
+
+  const server = app.listen(0, () => {
+    const address = server.address();
+    process.send?.({ port: typeof address === 'object' && address ? address.port : 0 });
+  });
+};
+
+const SCENARIOS = [
+  { label: 'create card', method: 'POST', path: 'cards', body: cardBody() },
+  { label: 'due cards', method: 'GET', path: 'cards/due' },
+  { label: 'start session', method: 'POST', path: 'study/sessions', body: sessionBody() },
+  { label: 'session state', method: 'GET', path: `study/sessions/${randomUUID()}` }
+] as const;
+
+const main = async () => {
+  // The server runs in its own process so its CPU time excludes autocannon's
+  const child = fork(__filename, ['--serve', ...args], { execArgv: process.execArgv });
+  const port = await new Promise<number>((resolve) => child.once('message', (message: any) => resolve(message.port)));
+  const base = `http://127.0.0.1:${port}`;
+  const cpu = async (): Promise<number> => {
+    const usage = await (await fetch(`${base}/cpu`)).json() as NodeJS.CpuUsage;
+    return usage.user + usage.system;
+  };
+
+  console.log(`${seconds}s per run, ${connections} connections, ${cardCount} due cards`);
+  try {
+    for (const scenario of SCENARIOS) {
+      for (const variant of ['joi', 'compiled']) {
+        const before = await cpu();
+        const result = await autocannon({
+          url: `${base}/${variant}/${scenario.path}`,
+          method: scenario.method,
+          headers: { 'content-type': 'application/json' },
+          body: 'body' in scenario ? JSON.stringify(scenario.body) : undefined,
+          connections,
+          duration: seconds
+        });
+        const cpuPerRequest = (await cpu() - before) / Math.max(1, result.requests.total);
+        console.log(`${scenario.label.padEnd(14)} ${variant.padEnd(9)} ${result.requests.average.toFixed(0).padStart(7)} req/s  ` +
+          `p99 ${String(result.latency.p99).padStart(4)} ms  ${cpuPerRequest.toFixed(0).padStart(5)} µs CPU/req` +
+          (result.non2xx ? `  ${result.non2xx} non-2xx` : ''));
+      }
+    }
+  } finally {
+    child.kill();
+  }
+};
+
+if (args.includes('--serve')) {
+  serve();
+} else {
+  main().catch((error) => {
+    console.error(error);
+    process.exit(1);
+  });
+}
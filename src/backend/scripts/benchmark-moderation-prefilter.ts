@@ -0,0 +1,103 @@
+/**
+ * @fileoverview Benchmarks two-stage content moderation.
+ * Reports local prefilter throughput against a regex alternation over the same terms, the
+ * share of chunks cleared without an endpoint call, and moderation requests made by the
+ * batched moderator against the previous one call per chunk.
+ *
+ * Usage: tsx scripts/benchmark-moderation-prefilter.ts [--chunks 5000] [--sensitive 0.05] [--batch 16]
+ * @version 1.0.0
+ */
+
+import { MODERATION_TERMS, ModerationPrefilter } from '../src/core/ai/moderationPrefilter';
+import { ContentModerator } from '../src/core/ai/contentModerator';
+import { OpenAIClient } from '../src/config/openai';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const chunkCount = option('--chunks', 5000);
+const sensitiveShare = option('--sensitive', 0.05);
+const batchSize = option('--batch', 16);
+
+let seed = 23;
+const random = () => (seed = (seed * 1103515245 + 12345) % 2147483648) / 2147483648;
+const pick = <T>(items: T[]): T => items[Math.floor(random() * items.length)];
+
+const SENTENCES = [
+  'Photosynthesis converts light energy into chemical energy stored in glucose.',
+  'The mitochondria produce most of the cell\'s supply of adenosine triphosphate.',
+  'In 1789 the Estates-General convened at Versailles for the first time since 1614.',
+  'A hash table maps keys to buckets using a hash function and resolves collisions by chaining.',
+  'Supply and demand determine the equilibrium price in a competitive market.',
+  'Plate tectonics explains the distribution of earthquakes, volcanoes and mountain ranges.',
+  'The Pythagorean theorem relates the sides of a right triangle: a^2 + b^2 = c^2.',
+  'Binary search halves the remaining interval on every comparison, giving O(log n) lookups.',
+  'Natural selection favors heritable traits that improve survival and reproduction.',
+  'The Doppler effect shifts the observed frequency of a wave when the source moves.',
+  'Spaced repetition schedules reviews at increasing intervals to strengthen long-term memory.',
+  'Osmosis moves water across a semipermeable membrane toward the higher solute concentration.'
+];
+const SENSITIVE = [
+  'The bomb destroyed the bridge before the army could cross.',
+  'Fentanyl overdoses rose sharply in the last decade.',
+  'The regime carried out a genocide against the minority population.',
+  'Soldiers were ordered to massacre the villagers.'
+];
+
+const chunk = () => {
+  const sentences = Array.from({ length: 12 }, () => pick(SENTENCES));
+  if (random() < sensitiveShare) {
+    sentences[Math.floor(random() * sentences.length)] = pick(SENSITIVE);
+  }
+  return sentences.join(' ');
+};
+
+const timeMs = (fn: () => void): number => {
+  const started = process.hrtime.bigint();
+  fn();
+  return Number(process.hrtime.bigint() - started) / 1e6;
+};
+
+const main = async () => {
+  const chunks = Array.from({ length: chunkCount }, chunk);
+  const megabytes = chunks.reduce((total, text) => total + text.length, 0) / 1e6;
+  const prefilter = new ModerationPrefilter();
+  const terms = Object.values(MODERATION_TERMS).flat();
+  const alternation = new RegExp(`\\b(?:${terms.map((term) => term.replace(/[.*+?^${}()|[\]\\]/g, '\\$&')).join('|')})`, 'i');
+
+  // Warm both paths before timing
+  chunks.slice(0, 200).forEach((text) => {
+    prefilter.classify(text);
+    alternation.test(text);
+  });
+  let cleared = 0;
+  const prefilterMs = timeMs(() => chunks.forEach((text) => {
+    cleared += prefilter.classify(text).verdict === 'clear' ? 1 : 0;
+  }));
+  const regexMs = timeMs(() => chunks.forEach((text) => alternation.test(text)));
+
+  const moderator = new ContentModerator({
+    createModeration: async (input: string[]) => ({ data: { results: input.map(() => ({ flagged: false })) } })
+  } as unknown as OpenAIClient, { maxBatchSize: batchSize });
+  // The content pipeline runs a stage's worth of moderation checks concurrently
+  for (let i = 0; i < chunks.length; i += batchSize) {
+    await Promise.all(chunks.slice(i, i + batchSize).map((text) => moderator.moderate(text)));
+  }
+  const stats = moderator.getStats();
+
+  console.log(`${chunkCount} chunks, ${megabytes.toFixed(1)} MB, ${(sensitiveShare * 100).toFixed(1)}% with a sensitive sentence, ` +
+    `${terms.length} terms`);
+  console.log(`prefilter        ${(megabytes / (prefilterMs / 1000)).toFixed(1)} MB/s  ` +
+    `${(prefilterMs * 1000 / chunkCount).toFixed(1)} us/chunk`);
+  console.log(`regex baseline   ${(megabytes / (regexMs / 1000)).toFixed(1)} MB/s  (term match only, no heuristics)`);
+  console.log(`cleared locally  ${cleared}/${chunkCount} (${(cleared / chunkCount * 100).toFixed(1)}%)`);
+  console.log(`endpoint calls   ${stats.requests} for ${stats.reviewed} reviewed chunks, previously ${chunkCount} ` +
+    `(${((1 - stats.requests / chunkCount) * 100).toFixed(1)}% avoided)`);
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,202 @@
+/**
+ * @fileoverview Benchmarks hash partitioning of cards by user on a real database.
+ * Seeds the same deterministic cards, 50M by default, into a single heap indexed as the
+ * unpartitioned cards table is and into a table hash-partitioned on user_id as migration
+ * 20240119000007 creates it, both in a scratch schema. Reports due-card query latency
+ * for random users, then updates a share of the rows, as a day of reviews does, and
+ * times VACUUM of the heap against VACUUM of the partitioned table and of its largest
+ * partition, the unit autovacuum works on.
+ *
+ * Usage: tsx scripts/benchmark-partitioning.ts [--cards 50000000] [--users 25000] [--partitions 16]
+ *          [--queries 2000] [--update-percent 5] [--chunk 1000000] [--keep 0]
+ * Connects through DATABASE_URL to a database with the app migrations applied; drops
+ * the bench_partitioning schema at the end unless --keep 1.
+ * @version 1.0.0
+ */
+
+import dotenv from 'dotenv';
+import { Pool } from 'pg'; // v8.11.3
+
+dotenv.config();
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const cardCount = option('--cards', 50_000_000);
+const userCount = option('--users', 25_000);
+const partitions = option('--partitions', 16);
+const queryCount = option('--queries', 2000);
+const updatePercent = option('--update-percent', 5);
+const chunkSize = option('--chunk', 1_000_000);
+const keep = option('--keep', 0) === 1;
+
+const SCHEMA = 'bench_partitioning';
+const HEAP = `${SCHEMA}.cards_heap`;
+const HASH = `${SCHEMA}.cards_hash`;
+
+// Session settings apply per connection; one connection keeps timings comparable
+const pool = new Pool({ connectionString: process.env.DATABASE_URL, max: 1 });
+
+const timed = async (work: () => Promise<unknown>): Promise<number> => {
+  const started = process.hrtime.bigint();
+  await work();
+  return Number(process.hrtime.bigint() - started) / 1e6;
+};
+
+const seconds = (ms: number) => `${(ms / 1000).toFixed(1)} s`;
+
+const percentiles = (samples: number[]) => {
+  // Skip the first queries while the plan cache and buffers warm up
+  const steady = samples.slice(Math.min(50, samples.length - 1)).sort((a, b) => a - b);
+  const at = (p: number) => steady[Math.min(steady.length - 1, Math.floor(steady.length * p))];
+  return `p50 ${at(0.5).toFixed(3)} ms  p95 ${at(0.95).toFixed(3)} ms  p99 ${at(0.99).toFixed(3)} ms`;
+};
+
+const relationSize = async (relation: string): Promise<string> => {
+  const { rows } = await pool.query(
+    `SELECT pg_size_pretty(sum(pg_table_size(relid)))::text AS tables,
+            pg_size_pretty(sum(pg_indexes_size(relid)))::text AS indexes
+     FROM (SELECT $1::regclass AS relid
+           UNION ALL SELECT relid FROM pg_partition_tree($1::regclass) WHERE isleaf AND relid <> $1::regclass) r`,
+    [relation]
+  );
+  return `table ${rows[0].tables}, indexes ${rows[0].indexes}`;
+};
+
+const createTables = async () => {
+  await pool.query(`DROP SCHEMA IF EXISTS ${SCHEMA} CASCADE`);
+  await pool.query(`CREATE SCHEMA ${SCHEMA}`);
+  // Same columns and defaults as the cards table, so rows are as wide as real ones
+  await pool.query(`CREATE TABLE ${HEAP} (LIKE public.cards INCLUDING DEFAULTS)`);
+  await pool.query(`CREATE TABLE ${HASH} (LIKE public.cards INCLUDING DEFAULTS) PARTITION BY HASH (user_id)`);
+  for (let i = 0; i < partitions; i++) {
+    await pool.query(
+      `CREATE TABLE ${HASH}_p${i} PARTITION OF ${HASH} FOR VALUES WITH (MODULUS ${partitions}, REMAINDER ${i})`
+    );
+  }
+};
+
+/**
+ * Cards and users derive from the row number, so every run seeds the same data
+ */
+const seed = async () => {
+  const seedMs = await timed(async () => {
+    for (let from = 0; from < cardCount; from += chunkSize) {
+      const to = Math.min(cardCount, from + chunkSize) - 1;
+      await pool.query(
+        `INSERT INTO ${HEAP} (id, user_id, front_content, back_content, fsrs_data, next_review, tags, created_at)
+         SELECT md5('card-' || n)::uuid,
+                md5('user-' || (n % $3))::uuid,
+                jsonb_build_object('text', 'Question ' || n, 'type', 'text'),
+                jsonb_build_object('text', 'Answer ' || n, 'type', 'text'),
+                jsonb_build_object('stability', 0.5 + (n % 97) / 10.0, 'difficulty', 0.3, 'reviewCount', n % 20),
+                timestamptz '2024-01-01' + (n % 60) * interval '1 day' + (n % 1440) * interval '1 minute',
+                '{}',
+                timestamptz '2023-12-01'
+         FROM generate_series($1::bigint, $2::bigint) AS n`,
+        [from, to, userCount]
+      );
+      console.log(`seeded ${to + 1} / ${cardCount}`);
+    }
+    await pool.query(`INSERT INTO ${HASH} SELECT * FROM ${HEAP}`);
+  });
+
+  const indexMs = await timed(async () => {
+    // As in the unpartitioned and partitioned schemas, tags and content indexes aside
+    await pool.query(`ALTER TABLE ${HEAP} ADD PRIMARY KEY (id)`);
+    await pool.query(`CREATE INDEX ON ${HEAP} (user_id, next_review)`);
+    await pool.query(`CREATE INDEX ON ${HEAP} (user_id)`);
+    await pool.query(`ALTER TABLE ${HASH} ADD PRIMARY KEY (user_id, id)`);
+    await pool.query(`CREATE INDEX ON ${HASH} (user_id, next_review)`);
+    await pool.query(`CREATE INDEX ON ${HASH} (id)`);
+    await pool.query(`VACUUM ANALYZE ${HEAP}`);
+    await pool.query(`VACUUM ANALYZE ${HASH}`);
+  });
+
+  console.log(`seeding ${seconds(seedMs)}, indexes and first vacuum ${seconds(indexMs)}`);
+  console.log(`heap         ${await relationSize(HEAP)}`);
+  console.log(`partitioned  ${await relationSize(HASH)}`);
+};
+
+/**
+ * The due-card query of Card.findDueCards, at today's date in the seeded schedule
+ */
+const dueQueryLatency = async (table: string): Promise<string> => {
+  const samples: number[] = [];
+  for (let i = 0; i < queryCount; i++) {
+    const user = Math.floor(Math.random() * userCount);
+    samples.push(await timed(() => pool.query({
+      name: `due-${table}`,
+      text: `SELECT * FROM ${table}
+             WHERE user_id = md5('user-' || $1::int)::uuid
+               AND next_review <= timestamptz '2024-01-30'
+               AND compatible_modes @> ARRAY['STANDARD']
+             ORDER BY next_review
+             LIMIT 20`,
+      values: [user]
+    })));
+  }
+  return percentiles(samples);
+};
+
+/**
+ * Reschedules a share of every user's cards, leaving that many dead tuples behind
+ */
+const simulateReviews = async (table: string) => {
+  await pool.query(
+    `UPDATE ${table}
+     SET next_review = next_review + interval '3 days',
+         fsrs_data = fsrs_data || '{"reviewCount": 21}'::jsonb,
+         updated_at = now()
+     WHERE abs(hashtext(id::text)) % 100 < $1`,
+    [updatePercent]
+  );
+};
+
+const vacuumTimes = async () => {
+  for (const table of [HEAP, HASH]) {
+    await simulateReviews(table);
+  }
+
+  const heapMs = await timed(() => pool.query(`VACUUM ${HEAP}`));
+
+  // Partitions one at a time, as autovacuum workers take them
+  const partitionMs: number[] = [];
+  for (let i = 0; i < partitions; i++) {
+    partitionMs.push(await timed(() => pool.query(`VACUUM ${HASH}_p${i}`)));
+  }
+  const totalMs = partitionMs.reduce((sum, ms) => sum + ms, 0);
+
+  console.log(`vacuum after ${updatePercent}% of cards were reviewed`);
+  console.log(`  heap                     ${seconds(heapMs)}`);
+  console.log(`  partitioned, all         ${seconds(totalMs)}`);
+  console.log(`  partitioned, largest     ${seconds(Math.max(...partitionMs))} (one of ${partitions})`);
+};
+
+const main = async () => {
+  console.log(`${cardCount} cards across ${userCount} users, ${partitions} hash partitions`);
+  await createTables();
+  await seed();
+
+  console.log(`due cards, ${queryCount} random users`);
+  // Warm both tables' indexes the same way before timing either
+  await dueQueryLatency(HEAP);
+  await dueQueryLatency(HASH);
+  console.log(`  heap         ${await dueQueryLatency(HEAP)}`);
+  console.log(`  partitioned  ${await dueQueryLatency(HASH)}`);
+
+  await vacuumTimes();
+
+  if (!keep) {
+    await pool.query(`DROP SCHEMA ${SCHEMA} CASCADE`);
+  }
+};
+
+main()
+  .catch((error) => {
+    console.error(error.message);
+    process.exitCode = 1;
+  })
+  .finally(() => pool.end());
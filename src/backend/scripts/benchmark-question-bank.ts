@@ -0,0 +1,148 @@
+/**
+ * @fileoverview Benchmarks precomputed quiz question banks.
+ * Reports bank build throughput for a synthetic deck, the work an incremental refresh
+ * does after a few cards change, and quiz-start latency when sampling a built bank
+ * against building questions when the quiz starts. Sampling runs against an in-memory
+ * copy of the sample_key index; production quiz-start latency is exported as
+ * pipeline_stage_duration_seconds{pipeline="quiz",stage="start"}.
+ *
+ * Usage: tsx scripts/benchmark-question-bank.ts [--contents 200] [--cards 25] [--questions 20] [--rounds 500]
+ * @version 1.0.0
+ */
+
+import { ICard, ContentType } from '../src/interfaces/ICard';
+import { StudyModes } from '../src/constants/studyModes';
+import { QuizGenerator } from '../src/core/ai/quizGenerator';
+import { cardHash } from '../src/services/QuestionBankService';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const contentCount = option('--contents', 200);
+const cardsPerContent = option('--cards', 25);
+const questionCount = option('--questions', 20);
+const rounds = option('--rounds', 500);
+
+const USER_ID = 'benchmark-user';
+
+let seed = 17;
+const random = () => (seed = (seed * 1103515245 + 12345) % 2147483648) / 2147483648;
+const pick = <T>(items: T[]): T => items[Math.floor(random() * items.length)];
+
+const SYLLABLES = ['ka', 'lo', 'mer', 'sin', 'tra', 'vel', 'cor', 'pho', 'gen', 'ix', 'dur', 'ben', 'sta', 'qui', 'ron',
+  'fal', 'met', 'ul', 'zo', 'pra', 'chi', 'nod', 'es', 'tum'];
+const word = () => Array.from({ length: 2 + Math.floor(random() * 2) }, () => pick(SYLLABLES)).join('');
+
+const content = (text: string) => ({ text, type: ContentType.TEXT, metadata: {} as ICard['frontContent']['metadata'] });
+
+const syntheticCard = (i: number): ICard => {
+  const subject = `${word()} ${word()}`;
+  const [front, back] = pick([
+    () => [`What is the ${word()} of the ${subject}?`, word()],
+    () => [`Which ${word()} regulates ${subject}?`, `${word()} ${word()}`],
+    () => [`In what year was the ${subject} first observed?`, String(1500 + Math.floor(random() * 520))],
+    () => [`How many ${word()} does a ${subject} have?`, String(2 + Math.floor(random() * 200))]
+  ])();
+  return {
+    id: `card-${i}`,
+    userId: USER_ID,
+    contentId: `content-${Math.floor(i / cardsPerContent)}`,
+    frontContent: content(front),
+    backContent: content(back),
+    fsrsData: { stability: 0, difficulty: 0, reviewCount: 0, lastReview: new Date(), lastRating: 0 },
+    nextReview: new Date(),
+    compatibleModes: [StudyModes.STANDARD],
+    tags: [],
+    createdAt: new Date(),
+    updatedAt: new Date()
+  } as ICard;
+};
+
+const timeMs = async (fn: () => Promise<unknown> | unknown): Promise<number> => {
+  const started = process.hrtime.bigint();
+  await fn();
+  return Number(process.hrtime.bigint() - started) / 1e6;
+};
+
+const percentiles = (samples: number[]) => {
+  // Skip the first rounds while the JIT settles
+  const steady = samples.slice(Math.min(20, samples.length - 1)).sort((a, b) => a - b);
+  const at = (p: number) => steady[Math.min(steady.length - 1, Math.floor(steady.length * p))];
+  return `p50 ${at(0.5).toFixed(3)} ms  p99 ${at(0.99).toFixed(3)} ms`;
+};
+
+const main = async () => {
+  // Every front reads as a question, so no phrasing call reaches the client
+  const generator = new QuizGenerator({} as never);
+  const deck = Array.from({ length: contentCount * cardsPerContent }, (_, i) => syntheticCard(i));
+  const contentIds = [...new Set(deck.map((card) => card.contentId))];
+
+  // Full build: one refresh per content item, as after card generation
+  const bank = new Map<string, { hash: string; sampleKey: number; contentId: string }>();
+  let built = 0;
+  const buildMs = await timeMs(async () => {
+    for (const contentId of contentIds) {
+      const cardIds = new Set(deck.filter((card) => card.contentId === contentId).map((card) => card.id));
+      const questions = await generator.buildDeckQuestions(USER_ID, deck, { questionCount: cardIds.size, cardIds });
+      questions.forEach(({ card }) => bank.set(card.id, { hash: cardHash(card), sampleKey: random(), contentId }));
+      built += questions.length;
+    }
+  });
+
+  // Incremental refresh after 2% of cards are edited
+  const edited = deck.filter(() => random() < 0.02);
+  edited.forEach((card) => {
+    card.backContent = content(`${card.backContent.text} ${word()}`);
+  });
+  let rebuilt = 0;
+  const refreshMs = await timeMs(async () => {
+    for (const contentId of contentIds) {
+      const changed = new Set(deck
+        .filter((card) => card.contentId === contentId && bank.get(card.id)?.hash !== cardHash(card))
+        .map((card) => card.id));
+      if (changed.size === 0) {
+        continue;
+      }
+      const questions = await generator.buildDeckQuestions(USER_ID, deck, { questionCount: changed.size, cardIds: changed });
+      questions.forEach(({ card }) => bank.set(card.id, { hash: cardHash(card), sampleKey: random(), contentId }));
+      rebuilt += questions.length;
+    }
+  });
+
+  // Quiz start from the bank: a range scan from a random key, wrapping around
+  const keys = [...bank.values()].map((entry) => entry.sampleKey).sort((a, b) => a - b);
+  const sampleMs: number[] = [];
+  for (let round = 0; round < rounds; round++) {
+    sampleMs.push(await timeMs(() => {
+      const start = random();
+      let low = 0;
+      let high = keys.length;
+      while (low < high) {
+        const middle = (low + high) >> 1;
+        keys[middle] < start ? (low = middle + 1) : (high = middle);
+      }
+      return Array.from({ length: Math.min(questionCount, keys.length) }, (_, i) => keys[(low + i) % keys.length]);
+    }));
+  }
+
+  // Quiz start building questions on demand from the same deck
+  const onDemandMs: number[] = [];
+  for (let round = 0; round < rounds; round++) {
+    const start = Math.floor(random() * (deck.length - questionCount));
+    const cardIds = new Set(deck.slice(start, start + questionCount).map((card) => card.id));
+    onDemandMs.push(await timeMs(() => generator.buildDeckQuestions(USER_ID, deck, { questionCount, cardIds })));
+  }
+
+  console.log(`deck ${deck.length} cards in ${contentIds.length} content items`);
+  console.log(`full build: ${built} questions in ${buildMs.toFixed(0)} ms (${(built / (buildMs / 1000)).toFixed(0)} questions/s)`);
+  console.log(`refresh after ${edited.length} edits: ${rebuilt} questions rebuilt in ${refreshMs.toFixed(1)} ms`);
+  console.log(`quiz start, ${questionCount} questions from the bank   ${percentiles(sampleMs)}`);
+  console.log(`quiz start, ${questionCount} questions built on demand ${percentiles(onDemandMs)}`);
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,98 @@
+/**
+ * @fileoverview Benchmarks deck-local quiz distractors.
+ * Reports index build time for a synthetic deck, the time to assemble a quiz of
+ * multiple-choice questions from it, and distractor quality on the labeled fixture deck.
+ *
+ * Usage: tsx scripts/benchmark-quiz-distractors.ts [--deck 5000] [--questions 50] [--rounds 200]
+ * @version 1.0.0
+ */
+
+import { DeckCard, DistractorIndex } from '../src/core/cards/distractorIndex';
+import { QUIZ_DECK } from '../tests/fixtures/quizDeck';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const deckSize = option('--deck', 5000);
+const questionCount = option('--questions', 50);
+const rounds = option('--rounds', 200);
+
+let seed = 31;
+const random = () => (seed = (seed * 1103515245 + 12345) % 2147483648) / 2147483648;
+const pick = <T>(items: T[]): T => items[Math.floor(random() * items.length)];
+
+const SYLLABLES = ['ka', 'lo', 'mer', 'sin', 'tra', 'vel', 'cor', 'pho', 'gen', 'ix', 'dur', 'ben', 'sta', 'qui', 'ron',
+  'fal', 'met', 'ul', 'zo', 'pra', 'chi', 'nod', 'es', 'tum'];
+const word = () => Array.from({ length: 2 + Math.floor(random() * 2) }, () => pick(SYLLABLES)).join('');
+const capitalized = () => {
+  const text = word();
+  return text[0].toUpperCase() + text.slice(1);
+};
+
+// One source per 25 cards, each mixing answer types the way a captured article does
+const syntheticCard = (i: number): DeckCard => {
+  const contentId = `content-${Math.floor(i / 25)}`;
+  const subject = `${word()} ${word()}`;
+  const templates: Array<() => Pick<DeckCard, 'front' | 'back'>> = [
+    () => ({ front: `What is the ${word()} of the ${subject}?`, back: word() }),
+    () => ({ front: `Which ${word()} regulates ${subject}?`, back: `${word()} ${word()}` }),
+    () => ({ front: `Who described the ${subject}?`, back: `${capitalized()} ${capitalized()}` }),
+    () => ({ front: `In what year was the ${subject} first observed?`, back: String(1500 + Math.floor(random() * 520)) }),
+    () => ({ front: `How many ${word()} does a ${subject} have?`, back: String(2 + Math.floor(random() * 200)) }),
+    () => ({ front: `How long is the ${subject}?`, back: `${(100 + Math.floor(random() * 9000)).toLocaleString('en-US')} km` })
+  ];
+  return { id: `card-${i}`, contentId, tags: [`topic-${i % 40}`], ...pick(templates)() };
+};
+
+const timeMs = (fn: () => void): number => {
+  const started = process.hrtime.bigint();
+  fn();
+  return Number(process.hrtime.bigint() - started) / 1e6;
+};
+
+const main = () => {
+  const deck = Array.from({ length: deckSize }, (_, i) => syntheticCard(i));
+
+  let index = new DistractorIndex(deck);
+  const buildMs = timeMs(() => {
+    index = new DistractorIndex(deck);
+  });
+
+  const quizMs: number[] = [];
+  let options = 0;
+  for (let round = 0; round < rounds; round++) {
+    const start = Math.floor(random() * (deck.length - questionCount));
+    quizMs.push(timeMs(() => {
+      deck.slice(start, start + questionCount).forEach((card) => {
+        if (index.answerFor(card.id)) {
+          options += index.distractors(card.id, 3).length;
+        }
+      });
+    }));
+  }
+  // Skip the first rounds while the JIT settles
+  const steady = quizMs.slice(Math.min(20, rounds - 1)).sort((a, b) => a - b);
+  const percentile = (p: number) => steady[Math.min(steady.length - 1, Math.floor(steady.length * p))];
+
+  const fixture = new DistractorIndex(QUIZ_DECK);
+  const byAnswer = new Map(QUIZ_DECK.map((card) => [card.back, card]));
+  let fromDeck = 0;
+  let sameTopic = 0;
+  let total = 0;
+  QUIZ_DECK.forEach((card) => fixture.distractors(card.id, 3).forEach((distractor) => {
+    const source = byAnswer.get(distractor);
+    total++;
+    fromDeck += source ? 1 : 0;
+    sameTopic += source?.topic === card.topic ? 1 : 0;
+  }));
+
+  console.log(`deck ${deckSize} cards, index built in ${buildMs.toFixed(1)} ms`);
+  console.log(`quiz of ${questionCount} questions  p50 ${percentile(0.5).toFixed(2)} ms  p99 ${percentile(0.99).toFixed(2)} ms  ` +
+    `(${(percentile(0.5) * 1000 / questionCount).toFixed(1)} us/question, ${(options / (rounds * questionCount)).toFixed(2)} options)`);
+  console.log(`fixture: ${total} distractors for ${QUIZ_DECK.length} cards, ${fromDeck} from the deck, ` +
+    `${((sameTopic / fromDeck) * 100).toFixed(1)}% of those from the card's topic`);
+};
+
+main();
@@ -0,0 +1,141 @@
+/**
+ * @fileoverview Benchmark of Supabase queries per review and per dashboard load.
+ * Runs the card and content models against an in-memory client that counts queries and
+ * adds a fixed round-trip latency, once outside a loader scope (one query per lookup, as
+ * before request-scoped loading) and once inside one.
+ *
+ * review: CardScheduler.processReview, which loads the card and then updates it.
+ * dashboard: the recent content items and the cards shown with them, looked up by ID in
+ * parallel, with cards repeated across widgets.
+ *
+ * Usage: tsx scripts/benchmark-request-loader.ts [--cards 20] [--contents 10] [--latency-ms 5] [--rounds 20]
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { ContentStatus } from '../src/interfaces/IContent';
+import { ContentType } from '../src/interfaces/ICard';
+import { StudyModes } from '../src/constants/studyModes';
+import { runInLoaderScope } from '../src/utils/batchLoader';
+
+// The models import the service container, which builds its Supabase client on import;
+// every query here goes to the in-memory client, so placeholders are enough
+process.env.SUPABASE_URL = process.env.SUPABASE_URL || 'http://localhost:54321';
+process.env.SUPABASE_ANON_KEY = process.env.SUPABASE_ANON_KEY || 'benchmark'.padEnd(40, '-');
+process.env.SUPABASE_SERVICE_ROLE_KEY = process.env.SUPABASE_SERVICE_ROLE_KEY || 'benchmark'.padEnd(40, '-');
+/* eslint-disable @typescript-eslint/no-var-requires */
+const { Card } = require('../src/models/Card');
+const { Content } = require('../src/models/Content');
+const { CardScheduler } = require('../src/core/study/cardScheduler');
+const { FSRSAlgorithm } = require('../src/core/study/FSRSAlgorithm');
+/* eslint-enable @typescript-eslint/no-var-requires */
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const cardCount = option('--cards', 20);
+const contentCount = option('--contents', 10);
+const latencyMs = option('--latency-ms', 5);
+const rounds = option('--rounds', 20);
+
+const USER_ID = 'benchmark-user';
+
+type Row = Record<string, any>;
+
+/**
+ * Enough of the Supabase query builder for the card and content models; every awaited
+ * builder is one query
+ */
+const createClient = (tables: Record<string, Row[]>) => {
+  let queries = 0;
+  const from = (table: string) => {
+    const filters: Array<(row: Row) => boolean> = [];
+    let changes: Row | null = null;
+    let single = false;
+    const builder: any = {
+      select: () => builder,
+      update: (values: Row) => { changes = values; return builder; },
+      eq: (column: string, value: unknown) => { filters.push((row) => row[column] === value); return builder; },
+      in: (column: string, values: unknown[]) => { filters.push((row) => values.includes(row[column])); return builder; },
+      single: () => { single = true; return builder; },
+      maybeSingle: () => { single = true; return builder; },
+      then: (resolve: (result: unknown) => void, reject: (error: unknown) => void) => {
+        queries++;
+        const rows = tables[table].filter((row) => filters.every((filter) => filter(row)));
+        if (changes) {
+          rows.forEach((row) => Object.assign(row, changes));
+        }
+        const copies = rows.map((row) => ({ ...row }));
+        const data = single ? copies[0] ?? null : copies;
+        return new Promise((done) => setTimeout(done, latencyMs)).then(() => ({ data, error: null })).then(resolve, reject);
+      }
+    };
+    return builder;
+  };
+  return { client: { from } as unknown as SupabaseClient, queries: () => queries };
+};
+
+const cardRow = (i: number): Row => ({
+  id: `card-${i}`,
+  userId: USER_ID,
+  contentId: `content-${i % contentCount}`,
+  frontContent: { text: `Question ${i}`, type: ContentType.TEXT, metadata: {} },
+  backContent: { text: `Answer ${i}`, type: ContentType.TEXT, metadata: {} },
+  fsrsData: { stability: 2, difficulty: 0.3, reviewCount: 3, lastReview: new Date(), lastRating: 3 },
+  nextReview: new Date(),
+  compatibleModes: [StudyModes.STANDARD],
+  tags: [],
+  createdAt: new Date(),
+  updatedAt: new Date()
+});
+
+const contentRow = (i: number): Row => ({
+  id: `content-${i}`,
+  userId: USER_ID,
+  content: `Captured article ${i}`,
+  metadata: { title: `Article ${i}` },
+  source: 'web',
+  status: ContentStatus.PROCESSED
+});
+
+const measure = async (label: string, scoped: boolean, flow: () => Promise<unknown>, queries: () => number) => {
+  const before = queries();
+  const started = process.hrtime.bigint();
+  for (let round = 0; round < rounds; round++) {
+    await (scoped ? runInLoaderScope(flow) : flow());
+  }
+  const elapsedMs = Number(process.hrtime.bigint() - started) / 1e6;
+  console.log(`${label.padEnd(10)} ${scoped ? 'scoped  ' : 'unscoped'} ` +
+    `${((queries() - before) / rounds).toFixed(1).padStart(5)} queries  ${(elapsedMs / rounds).toFixed(1).padStart(6)} ms`);
+};
+
+const main = async () => {
+  const { client, queries } = createClient({
+    cards: Array.from({ length: cardCount }, (_, i) => cardRow(i)),
+    contents: Array.from({ length: contentCount }, (_, i) => contentRow(i))
+  });
+  const cardModel = new Card(client);
+  const contentModel = new Content(client);
+  const scheduler = new CardScheduler(new FSRSAlgorithm(), cardModel);
+
+  const review = () => scheduler.processReview('card-0', 3, false);
+  // Due list, recent reviews and per-content previews each resolve their cards by ID
+  const dashboard = () => Promise.all([
+    ...Array.from({ length: contentCount }, (_, i) => contentModel.findById(`content-${i}`, USER_ID)),
+    ...Array.from({ length: cardCount }, (_, i) => cardModel.findById(`card-${i}`)),
+    ...Array.from({ length: cardCount }, (_, i) => cardModel.findById(`card-${(i * 7) % cardCount}`))
+  ]);
+
+  console.log(`${cardCount} cards, ${contentCount} content items, ${latencyMs} ms per query, ${rounds} rounds`);
+  for (const [label, flow] of [['review', review], ['dashboard', dashboard]] as const) {
+    await measure(label, false, flow, queries);
+    await measure(label, true, flow, queries);
+  }
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
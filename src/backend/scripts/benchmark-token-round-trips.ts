@@ -0,0 +1,251 @@
+/**
+ * @fileoverview Counts Redis round trips of the token flows behind login, refresh and
+ * logout requests.
+ * Replays the commands TokenService sent before, one awaited command at a time, and runs
+ * the current TokenService, whose flows are single scripts. Each runs against an
+ * in-memory client that charges a fixed latency per round trip and can auto-pipeline
+ * like ioredis with enableAutoPipelining: commands issued in the same tick share one
+ * round trip. Reports round trips and latency per request, then total round trips for
+ * many concurrent requests.
+ *
+ * Usage: tsx scripts/benchmark-token-round-trips.ts [--latency-ms 1] [--requests 500] [--concurrency 50]
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { InMemoryRedisStore } from '../tests/utils/inMemoryRedis';
+import { TokenStore } from '../src/utils/tokenStore';
+
+// Tokens are signed for real; any secret will do
+process.env.JWT_SECRET = process.env.JWT_SECRET || 'benchmark-secret'.padEnd(64, '-');
+/* eslint-disable @typescript-eslint/no-var-requires */
+const { TokenService } = require('../src/services/TokenService');
+const TokenUtils = require('../src/utils/jwt');
+/* eslint-enable @typescript-eslint/no-var-requires */
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const latencyMs = option('--latency-ms', 1);
+const requestCount = option('--requests', 500);
+const concurrency = option('--concurrency', 50);
+
+/**
+ * In-memory client that delays every round trip by `latencyMs` and counts them. With
+ * auto-pipelining, commands issued before the next tick join the pending round trip.
+ */
+const createClient = (autoPipelining: boolean) => {
+  const target = new InMemoryRedisStore().client() as any;
+  const stats = { roundTrips: 0 };
+  let pending: Array<() => void> | null = null;
+
+  const send = <T>(run: () => Promise<T>): Promise<T> => new Promise<T>((resolve, reject) => {
+    const call = () => void run().then(resolve, reject);
+    if (pending) {
+      pending.push(call);
+      return;
+    }
+    const calls = [call];
+    stats.roundTrips++;
+    if (autoPipelining) {
+      pending = calls;
+      process.nextTick(() => { pending = null; });
+    }
+    setTimeout(() => calls.forEach((queued) => queued()), latencyMs);
+  });
+
+  // MULTI ... EXEC is written at once: one round trip on exec
+  const multi = () => {
+    const queued: Array<[string, unknown[]]> = [];
+    const transaction: any = new Proxy({}, {
+      get: (_, name: string) => name === 'exec'
+        ? () => send(() => {
+          const pipeline = target.pipeline();
+          queued.forEach(([command, commandArgs]) => pipeline[command](...commandArgs));
+          return pipeline.exec();
+        })
+        : (...commandArgs: unknown[]) => {
+          queued.push([name, commandArgs]);
+          return transaction;
+        }
+    });
+    return transaction;
+  };
+
+  const client = new Proxy(target, {
+    get: (_, name: string) => name === 'multi'
+      ? multi
+      : (...commandArgs: unknown[]) => send(() => target[name](...commandArgs))
+  }) as Redis;
+  return { client, stats };
+};
+
+const user = (i: number) => ({ id: `user-${i}`, email: `user-${i}@example.com`, role: 'FREE_USER' });
+const WEEK = 7 * 24 * 60 * 60;
+
+interface Session {
+  user: number;
+  accessToken: string;
+  refreshToken: string;
+}
+
+interface TokenFlows {
+  login(i: number): Promise<Session>;
+  /** Authenticated refresh: the auth middleware, then the refresh */
+  refresh(session: Session): Promise<Session>;
+  /** Authenticated logout of one session */
+  logout(session: Session): Promise<void>;
+  /** Authenticated logout from every device */
+  logoutAll(session: Session): Promise<void>;
+}
+
+/**
+ * The commands TokenService and the auth middleware sent before, in the same order
+ */
+const previousFlows = (redis: Redis): TokenFlows => {
+  const authenticate = async (accessToken: string) => {
+    await redis.get(`token:blacklist:${accessToken}`);
+    const decoded = await TokenUtils.verifyToken(accessToken);
+    await redis.get(`token:blacklist:${decoded.jti}`);
+    return decoded;
+  };
+  const sign = async (i: number) => {
+    const [accessToken, refreshToken] = await Promise.all([
+      TokenUtils.generateToken(user(i)),
+      TokenUtils.generateRefreshToken(user(i))
+    ]);
+    const decoded = await TokenUtils.verifyRefreshToken(refreshToken);
+    await redis.set(`refresh:token:${decoded.userId}:${decoded.jti}`, refreshToken, 'EX', WEEK);
+    return { user: i, accessToken, refreshToken };
+  };
+  const verifyRefresh = async (refreshToken: string) => {
+    const decoded = await TokenUtils.verifyRefreshToken(refreshToken);
+    await redis.get(`refresh:token:${decoded.userId}:${decoded.jti}`);
+    return decoded;
+  };
+
+  return {
+    login: sign,
+    refresh: async (session) => {
+      await authenticate(session.accessToken);
+      const decoded = await verifyRefresh(session.refreshToken);
+      // Looked the token up by its string rather than its id, so refreshes failed here;
+      // what follows is what the flow was written to send
+      await redis.get(`refresh:token:${decoded.userId}:${session.refreshToken}`);
+      const next = await sign(session.user);
+      const multi = redis.multi();
+      const [previous, replacement] = [await verifyRefresh(session.refreshToken), await verifyRefresh(next.refreshToken)];
+      multi.del(`refresh:token:${decoded.userId}:${previous.jti}`);
+      multi.set(`refresh:token:${decoded.userId}:${replacement.jti}`, next.refreshToken, 'EX', WEEK);
+      await multi.exec();
+      return next;
+    },
+    logout: async (session) => {
+      const access = await authenticate(session.accessToken);
+      const refresh = await TokenUtils.verifyRefreshToken(session.refreshToken);
+      await Promise.all([
+        redis.set(`token:blacklist:${access.jti}`, '1', 'EX', 1800),
+        redis.del(`refresh:token:${refresh.userId}:${refresh.jti}`)
+      ]);
+    },
+    logoutAll: async (session) => {
+      const access = await authenticate(session.accessToken);
+      const keys = await redis.keys(`refresh:token:${access.userId}:*`);
+      const multi = redis.multi();
+      keys.forEach((key) => multi.del(key));
+      multi.del(`session:${access.userId}`);
+      await multi.exec();
+    }
+  };
+};
+
+const currentFlows = (redis: Redis): TokenFlows => {
+  const tokens = new TokenService(new TokenStore(redis));
+  return {
+    login: async (i) => ({ user: i, ...await tokens.generateTokenPair(user(i)) }),
+    refresh: async (session) => {
+      await tokens.verifyAccessToken(session.accessToken);
+      const { token, refreshToken } = await tokens.refreshAccessToken(session.refreshToken);
+      return { user: session.user, accessToken: token, refreshToken };
+    },
+    logout: async (session) => {
+      await tokens.verifyAccessToken(session.accessToken);
+      await tokens.invalidateTokens(session.accessToken, session.refreshToken);
+    },
+    logoutAll: async (session) => {
+      const decoded = await tokens.verifyAccessToken(session.accessToken);
+      await tokens.invalidateSession(decoded.userId);
+    }
+  };
+};
+
+const FLOWS = ['login', 'refresh', 'logout', 'logoutAll'] as const;
+
+/**
+ * Runs each flow once for one user and measures its round trips and latency
+ */
+const perRequest = async (build: (redis: Redis) => TokenFlows, autoPipelining: boolean) => {
+  const { client, stats } = createClient(autoPipelining);
+  const flows = build(client);
+  const results: string[] = [];
+
+  const measure = async <T>(flow: string, run: () => Promise<T>): Promise<T> => {
+    const before = stats.roundTrips;
+    const started = process.hrtime.bigint();
+    const result = await run();
+    const ms = Number(process.hrtime.bigint() - started) / 1e6;
+    results.push(`${flow} ${stats.roundTrips - before} (${ms.toFixed(1)} ms)`);
+    return result;
+  };
+
+  const session = await measure('login', () => flows.login(0));
+  const refreshed = await measure('refresh', () => flows.refresh(session));
+  await measure('logout', () => flows.logout(refreshed));
+  const second = await flows.login(0);
+  await measure('logoutAll', () => flows.logoutAll(second));
+  return results.join('  ');
+};
+
+/**
+ * Logs in and refreshes `requestCount` users, `concurrency` at a time
+ */
+const concurrent = async (build: (redis: Redis) => TokenFlows, autoPipelining: boolean) => {
+  const { client, stats } = createClient(autoPipelining);
+  const flows = build(client);
+  let next = 0;
+  const started = Date.now();
+  await Promise.all(Array.from({ length: concurrency }, async () => {
+    while (next < requestCount) {
+      const session = await flows.login(next++);
+      await flows.refresh(session);
+    }
+  }));
+  return `${stats.roundTrips} round trips, ${(stats.roundTrips / requestCount).toFixed(2)} per login + refresh, ` +
+    `${Date.now() - started} ms`;
+};
+
+const main = async () => {
+  console.log(`${latencyMs} ms per round trip; flows: ${FLOWS.join(', ')}`);
+  const runs: Array<[string, (redis: Redis) => TokenFlows, boolean]> = [
+    ['before                     ', previousFlows, false],
+    ['before, auto-pipelined     ', previousFlows, true],
+    ['scripts, auto-pipelined    ', currentFlows, true]
+  ];
+
+  console.log('round trips per request');
+  for (const [name, build, autoPipelining] of runs) {
+    console.log(`  ${name} ${await perRequest(build, autoPipelining)}`);
+  }
+
+  console.log(`${requestCount} logins and refreshes, ${concurrency} concurrent`);
+  for (const [name, build, autoPipelining] of runs) {
+    console.log(`  ${name} ${await concurrent(build, autoPipelining)}`);
+  }
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exitCode = 1;
+});
@@ -0,0 +1,100 @@
+/**
+ * @fileoverview Offline decoder and analysis for native trace batches.
+ * Reads one or more binary batch files (or stdin) and prints per-span latency percentiles.
+ *
+ * Usage: tsx scripts/decode-traces.ts [--json] [--dump] <batch.bin ...>
+ * @version 1.0.0
+ */
+
+import { readFileSync } from 'fs';
+import { decodeTraceBatch, NativeTraceSpan } from '../src/core/monitoring/nativeTraceBatch';
+
+interface SpanSummary {
+  span: string;
+  count: number;
+  p50Ms: number;
+  p95Ms: number;
+  p99Ms: number;
+  maxMs: number;
+}
+
+const args = process.argv.slice(2);
+const asJson = args.includes('--json');
+const dump = args.includes('--dump');
+const files = args.filter((arg) => !arg.startsWith('--'));
+
+const percentile = (sorted: number[], p: number): number =>
+  sorted[Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1)];
+
+const summarize = (spans: NativeTraceSpan[]): SpanSummary[] => {
+  const byName = new Map<string, number[]>();
+  for (const span of spans) {
+    const durations = byName.get(span.name) ?? [];
+    durations.push(Number(span.durationNs) / 1e6);
+    byName.set(span.name, durations);
+  }
+
+  return [...byName.entries()]
+    .map(([span, durations]) => {
+      const sorted = durations.sort((a, b) => a - b);
+      return {
+        span,
+        count: sorted.length,
+        p50Ms: percentile(sorted, 50),
+        p95Ms: percentile(sorted, 95),
+        p99Ms: percentile(sorted, 99),
+        maxMs: sorted[sorted.length - 1]
+      };
+    })
+    .sort((a, b) => a.span.localeCompare(b.span));
+};
+
+const inputs = files.length > 0
+  ? files.map((file) => ({ source: file, data: readFileSync(file) }))
+  : [{ source: 'stdin', data: readFileSync(0) }];
+
+const spans: NativeTraceSpan[] = [];
+let dropped = 0;
+
+for (const { source, data } of inputs) {
+  try {
+    const batch = decodeTraceBatch(data);
+    spans.push(...batch.spans);
+    dropped += batch.droppedCount;
+  } catch (error) {
+    console.error(`${source}: ${(error as Error).message}`);
+    process.exitCode = 1;
+  }
+}
+
+const summary = summarize(spans);
+
+if (asJson) {
+  console.log(JSON.stringify({ spans: summary, dropped }, null, 2));
+} else {
+  if (dump) {
+    for (const span of spans) {
+      console.log([
+        span.startedAt.toISOString(),
+        span.name.padEnd(22),
+        `t${span.thread}`.padEnd(5),
+        `${(Number(span.durationNs) / 1e6).toFixed(3)}ms`.padStart(12),
+        span.arg
+      ].join('  '));
+    }
+    console.log();
+  }
+
+  console.log(`${'span'.padEnd(22)}${'count'.padStart(8)}${'p50 ms'.padStart(10)}${'p95 ms'.padStart(10)}${'p99 ms'.padStart(10)}${'max ms'.padStart(10)}`);
+  for (const row of summary) {
+    console.log(
+      row.span.padEnd(22) +
+      String(row.count).padStart(8) +
+      row.p50Ms.toFixed(3).padStart(10) +
+      row.p95Ms.toFixed(3).padStart(10) +
+      row.p99Ms.toFixed(3).padStart(10) +
+      row.maxMs.toFixed(3).padStart(10)
+    );
+  }
+  console.log(`\n${spans.length} spans, ${dropped} dropped on device`);
+}
@@ -0,0 +1,125 @@
+/**
+ * @fileoverview Overload test for event-loop-lag admission control.
+ * Offers one worker an open-loop mix of cheap critical requests, like reviews, and
+ * CPU-heavy sheddable ones, like generation, whose offered work exceeds what the event
+ * loop can run. Each request passes through an AdmissionController; the unprotected
+ * phase gives sheddable requests no limits. Reports critical latency from scheduled
+ * arrival, so a stalled loop is not hidden by late arrivals, and sheddable throughput.
+ *
+ * Usage: tsx scripts/loadtest-admission-control.ts [--seconds 10] [--critical-rate 200] [--sheddable-rate 60]
+ *        [--sheddable-cpu-ms 30]
+ * @version 1.0.0
+ */
+
+import { monitorEventLoopDelay } from 'perf_hooks';
+import { AdmissionController, AdmissionPriority } from '../src/core/monitoring/admissionController';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const seconds = option('--seconds', 10);
+const criticalRate = option('--critical-rate', 200);
+const sheddableRate = option('--sheddable-rate', 60);
+const sheddableCpuMs = option('--sheddable-cpu-ms', 30);
+
+const CRITICAL_CPU_MS = 0.5;
+const IO_MS = 2;
+// Sheddable work runs in slices between I/O, as generation parses streamed output
+const SLICE_MS = 5;
+
+const spin = (ms: number) => {
+  const until = process.hrtime.bigint() + BigInt(Math.round(ms * 1e6));
+  while (process.hrtime.bigint() < until) {
+    // Busy CPU work
+  }
+};
+const io = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+const handle = async (priority: AdmissionPriority) => {
+  await io(IO_MS);
+  if (priority === 'critical') {
+    spin(CRITICAL_CPU_MS);
+    return;
+  }
+  for (let done = 0; done < sheddableCpuMs; done += SLICE_MS) {
+    spin(Math.min(SLICE_MS, sheddableCpuMs - done));
+    await new Promise<void>((resolve) => setImmediate(resolve));
+  }
+};
+
+const percentile = (samples: number[], p: number) =>
+  samples[Math.min(samples.length - 1, Math.floor(samples.length * p))] ?? 0;
+
+const runPhase = async (label: string, controller: AdmissionController, offerSheddable: boolean) => {
+  controller.start();
+  const delay = monitorEventLoopDelay({ resolution: 1 });
+  const criticalLatency: number[] = [];
+  const pending: Array<Promise<void>> = [];
+  let sheddableDone = 0;
+  let sheddableRejected = 0;
+  let criticalSent = 0;
+  let sheddableSent = 0;
+
+  const request = (priority: AdmissionPriority, scheduledAt: number) => controller.admit(priority).then(
+    async (release) => {
+      try {
+        await handle(priority);
+      } finally {
+        release();
+      }
+      if (priority === 'critical') {
+        criticalLatency.push(performance.now() - scheduledAt);
+      } else {
+        sheddableDone++;
+      }
+    },
+    () => {
+      sheddableRejected++;
+    }
+  );
+
+  delay.enable();
+  const started = performance.now();
+  const end = started + seconds * 1000;
+  // Releases every arrival whose scheduled time has passed, however late the tick runs
+  await new Promise<void>((resolve) => {
+    const tick = setInterval(() => {
+      const now = Math.min(performance.now(), end);
+      for (; started + (criticalSent * 1000) / criticalRate <= now; criticalSent++) {
+        pending.push(request('critical', started + (criticalSent * 1000) / criticalRate));
+      }
+      for (; offerSheddable && started + (sheddableSent * 1000) / sheddableRate <= now; sheddableSent++) {
+        pending.push(request('sheddable', started + (sheddableSent * 1000) / sheddableRate));
+      }
+      if (now >= end) {
+        clearInterval(tick);
+        resolve();
+      }
+    }, 1);
+  });
+  await Promise.all(pending);
+  const elapsed = (performance.now() - started) / 1000;
+  delay.disable();
+  controller.stop();
+
+  criticalLatency.sort((a, b) => a - b);
+  console.log(`${label.padEnd(12)} critical p50 ${percentile(criticalLatency, 0.5).toFixed(1)} ms  ` +
+    `p99 ${percentile(criticalLatency, 0.99).toFixed(1)} ms | loop delay p99 ${(delay.percentile(99) / 1e6).toFixed(1)} ms | ` +
+    `sheddable ${(sheddableDone / elapsed).toFixed(1)}/s done, ${sheddableRejected} rejected`);
+};
+
+const main = async () => {
+  console.log(`${seconds}s per phase: ${criticalRate} critical/s at ${CRITICAL_CPU_MS} ms CPU, ` +
+    `${sheddableRate} sheddable/s at ${sheddableCpuMs} ms CPU`);
+  const unlimited = { maxLagMs: Infinity, maxSheddableInFlight: Infinity, maxInFlight: Infinity };
+  await runPhase('no overload', new AdmissionController(unlimited), false);
+  await runPhase('unprotected', new AdmissionController(unlimited), true);
+  await runPhase('admission', new AdmissionController(), true);
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
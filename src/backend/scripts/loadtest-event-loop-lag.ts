@@ -0,0 +1,102 @@
+/**
+ * @fileoverview Load test for the shared CPU worker pool.
+ * Offers a mixed open-loop load of large CPU tasks — audio hashing, sanitization and
+ * encryption — alongside small request-sized tasks, once on the event loop and once on
+ * the worker pool, and compares event-loop delay and the latency of the small tasks.
+ *
+ * Usage: tsx scripts/loadtest-event-loop-lag.ts [--seconds 10] [--rate 20] [--audio-mb 4] [--text-kb 256]
+ *        [--pool-size N]
+ * @version 1.0.0
+ */
+
+import { randomBytes } from 'crypto';
+import { monitorEventLoopDelay } from 'perf_hooks';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const seconds = option('--seconds', 10);
+const rate = option('--rate', 20);
+const audioBytes = option('--audio-mb', 4) * 1024 * 1024;
+const textBytes = option('--text-kb', 256) * 1024;
+// Without --pool-size the pool runs one worker per core, less one
+const poolSize = args.includes('--pool-size') ? String(option('--pool-size', 1)) : undefined;
+
+// Encryption reads its key on first use
+process.env.ENCRYPTION_KEY = process.env.ENCRYPTION_KEY || randomBytes(32).toString('base64');
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { cpuPool, runCpuTask, sha256Hex } = require('../src/core/workers/cpuTasks');
+
+const audio = randomBytes(audioBytes);
+const text = '<p>Reviewing <b>material</b> at increasing intervals & <script>x()</script> retention. </p>'
+  .repeat(Math.ceil(textBytes / 90));
+const secret = 'x'.repeat(textBytes);
+
+// Each large task is offered `rate` times per second, in rotation
+const LARGE_TASKS: Array<() => Promise<unknown>> = [
+  () => sha256Hex(audio),
+  () => runCpuTask('sanitize', { input: text, options: {} }, text.length),
+  () => runCpuTask('encrypt', secret, secret.length)
+];
+
+const percentile = (samples: number[], p: number) =>
+  samples[Math.min(samples.length - 1, Math.floor(samples.length * p))] ?? 0;
+
+const runPhase = async (label: string, offload: boolean) => {
+  // CPU_POOL_SIZE=0 keeps every task on the calling thread
+  if (!offload) {
+    process.env.CPU_POOL_SIZE = '0';
+  } else if (poolSize) {
+    process.env.CPU_POOL_SIZE = poolSize;
+  } else {
+    delete process.env.CPU_POOL_SIZE;
+  }
+
+  const delay = monitorEventLoopDelay({ resolution: 1 });
+  const smallLatency: number[] = [];
+  const pending: Array<Promise<unknown>> = [];
+  let completed = 0;
+  let next = 0;
+
+  delay.enable();
+  const started = Date.now();
+  const large = setInterval(() => {
+    pending.push(LARGE_TASKS[next++ % LARGE_TASKS.length]().then(() => completed++));
+  }, 1000 / rate);
+  // A small request every 5 ms: a short hash that always runs inline
+  const small = setInterval(() => {
+    const queued = process.hrtime.bigint();
+    setImmediate(() => {
+      sha256Hex(randomBytes(256)).then(() => smallLatency.push(Number(process.hrtime.bigint() - queued) / 1e6));
+    });
+  }, 5);
+
+  await new Promise((resolve) => setTimeout(resolve, seconds * 1000));
+  clearInterval(large);
+  clearInterval(small);
+  await Promise.all(pending);
+  const elapsed = (Date.now() - started) / 1000;
+  delay.disable();
+
+  smallLatency.sort((a, b) => a - b);
+  console.log(`${label.padEnd(10)} loop delay p50 ${(delay.percentile(50) / 1e6).toFixed(1)} ms  ` +
+    `p99 ${(delay.percentile(99) / 1e6).toFixed(1)} ms  max ${(delay.max / 1e6).toFixed(1)} ms | ` +
+    `small request p99 ${percentile(smallLatency, 0.99).toFixed(1)} ms | ` +
+    `${(completed / elapsed).toFixed(1)} large tasks/s of ${rate} offered`);
+};
+
+const main = async () => {
+  console.log(`${seconds}s per phase, ${rate} large tasks/s: ${audioBytes >> 20} MB audio hash, ` +
+    `${textBytes >> 10} KB sanitize and encrypt`);
+  await runPhase('event loop', false);
+  await runPhase('pool', true);
+  console.log(`pool: ${JSON.stringify(cpuPool().getStats())}`);
+  await cpuPool().close();
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,114 @@
+/**
+ * @fileoverview Load test for the shared OpenAI concurrency limiter.
+ * Several simulated workers run closed-loop batch generations and open-loop interactive
+ * calls against a local mock that throttles above its capacity and injects 429s and
+ * latency. Runs once without and once with the limiter and compares 429s, batch
+ * throughput, failures and interactive latency.
+ *
+ * Usage: tsx scripts/loadtest-llm-limiter.ts [--workers 4] [--batch 48] [--interactive-rps 4]
+ *        [--seconds 20] [--capacity 16] [--latency-ms 400] [--throttle-rate 0.01] [--retry-after-ms 1000]
+ * Set REDIS_URL to share limiter state through a real Redis instead of an in-process store.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { ConcurrencyLimiter } from '../src/utils/concurrencyLimiter';
+import { startMockOpenAIChatServer } from '../tests/utils/mockOpenAIChatServer';
+import { InMemoryRedisStore } from '../tests/utils/inMemoryRedis';
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const workerCount = option('--workers', 4);
+const batchCallers = option('--batch', 48);
+const interactiveRps = option('--interactive-rps', 4);
+const seconds = option('--seconds', 20);
+const capacity = option('--capacity', 16);
+const latencyMs = option('--latency-ms', 400);
+const throttleRate = option('--throttle-rate', 0.01);
+const retryAfterMs = option('--retry-after-ms', 1000);
+
+// The OpenAI config module validates credentials on import; keep per-request logs quiet
+process.env.OPENAI_API_KEY = process.env.OPENAI_API_KEY || `sk-${'a'.repeat(40)}`;
+process.env.OPENAI_ORG_ID = process.env.OPENAI_ORG_ID || `org-${'b'.repeat(24)}`;
+process.env.LOG_LEVEL = 'silent';
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { OpenAIClient } = require('../src/config/openai');
+
+const REQUEST = {
+  messages: [{ role: 'user', content: 'Generate flashcards for the following passage.' }],
+  max_tokens: 200
+};
+
+const percentile = (values: number[], p: number): number => {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))] ?? 0;
+};
+
+const run = async (limited: boolean) => {
+  const server = await startMockOpenAIChatServer({ capacity, latencyMs, throttleRate, retryAfterMs });
+  const store = new InMemoryRedisStore();
+  const clients: Redis[] = [];
+  const name = `loadtest-${Date.now()}`;
+  const workers = Array.from({ length: workerCount }, () => {
+    if (!limited) {
+      return new OpenAIClient(process.env.OPENAI_API_KEY, undefined, server.baseURL);
+    }
+    const client = process.env.REDIS_URL ? new Redis(process.env.REDIS_URL) : store.client();
+    clients.push(client);
+    return new OpenAIClient(process.env.OPENAI_API_KEY, undefined, server.baseURL, new ConcurrencyLimiter(client, { name }));
+  });
+
+  const deadline = Date.now() + seconds * 1000;
+  let batchDone = 0;
+  let failed = 0;
+  const interactiveMs: number[] = [];
+
+  const batch = Array.from({ length: batchCallers }, async (_, i) => {
+    while (Date.now() < deadline) {
+      try {
+        await workers[i % workerCount].createChatCompletion(REQUEST);
+        batchDone++;
+      } catch {
+        failed++;
+      }
+    }
+  });
+
+  const interactive: Promise<void>[] = [];
+  for (let i = 0; Date.now() < deadline; i++) {
+    interactive.push((async () => {
+      const started = Date.now();
+      try {
+        await workers[i % workerCount].createChatCompletion(REQUEST, { priority: 'interactive' });
+        interactiveMs.push(Date.now() - started);
+      } catch {
+        failed++;
+      }
+    })());
+    await new Promise((resolve) => setTimeout(resolve, 1000 / interactiveRps));
+  }
+
+  await Promise.all([...batch, ...interactive]);
+  const stats = server.stats();
+  await server.close();
+  clients.forEach((client) => client.disconnect());
+
+  console.log(`${limited ? 'limited  ' : 'unlimited'}  requests ${stats.requests}  429s ${stats.throttled}` +
+    `  peak in flight ${stats.peakInFlight}  batch ${(batchDone / seconds).toFixed(1)}/s  failed ${failed}` +
+    `  interactive p50 ${percentile(interactiveMs, 0.5)} ms  p95 ${percentile(interactiveMs, 0.95)} ms`);
+};
+
+const main = async () => {
+  console.log(`${workerCount} workers, ${batchCallers} batch callers, ${interactiveRps} interactive/s, ` +
+    `capacity ${capacity}, ${latencyMs} ms latency, ${(throttleRate * 100).toFixed(1)}% injected 429s`);
+  await run(false);
+  await run(true);
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
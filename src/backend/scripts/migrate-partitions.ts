@@ -0,0 +1,190 @@
+/**
+ * @fileoverview Online migration of cards and study_sessions to hash-partitioned tables.
+ * Drives the functions of migration 20240119000007: the backfill copies existing rows in
+ * small batches while triggers mirror live writes, verify compares row counts, and
+ * cutover swaps the partitioned tables in under a short lock, retrying when the lock is
+ * not granted in time. Every step can be stopped and rerun; the backfill resumes where it
+ * left off.
+ *
+ *   status    progress of each table, and cards that block the cutover
+ *   backfill  copies existing rows until both tables are done
+ *   verify    compares row counts of the live and partitioned tables
+ *   cutover   swaps the tables, then validates the quiz question foreign key
+ *   drop-old  drops the *_unpartitioned tables kept after the cutover
+ *
+ * Usage: tsx scripts/migrate-partitions.ts <status|backfill|verify|cutover|drop-old>
+ *          [--batch 5000] [--pause-ms 50] [--lock-timeout-ms 2000] [--attempts 10]
+ * Connects through DATABASE_URL.
+ * @version 1.0.0
+ */
+
+import dotenv from 'dotenv';
+import { Pool } from 'pg'; // v8.11.3
+
+dotenv.config();
+
+const TABLES = ['cards', 'study_sessions'] as const;
+
+const args = process.argv.slice(2);
+const option = (name: string, fallback: number): number => {
+  const index = args.indexOf(name);
+  return index >= 0 ? Number(args[index + 1]) : fallback;
+};
+const command = args[0];
+const batchSize = option('--batch', 5000);
+const pauseMs = option('--pause-ms', 50);
+const lockTimeoutMs = option('--lock-timeout-ms', 2000);
+const attempts = option('--attempts', 10);
+
+const pool = new Pool({ connectionString: process.env.DATABASE_URL, max: 2 });
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+interface MigrationState {
+  table_name: string;
+  backfilled_through: string | null;
+  completed_at: Date | null;
+  cutover_at: Date | null;
+}
+
+const readState = async (): Promise<MigrationState[]> =>
+  (await pool.query<MigrationState>('SELECT * FROM public.partition_migration ORDER BY table_name')).rows;
+
+const estimatedRows = async (table: string): Promise<number> => {
+  const { rows } = await pool.query('SELECT reltuples::bigint AS rows FROM pg_class WHERE oid = $1::regclass', [`public.${table}`]);
+  return Math.max(Number(rows[0].rows), 0);
+};
+
+const status = async () => {
+  for (const state of await readState()) {
+    const phase = state.cutover_at ? `cut over ${state.cutover_at.toISOString()}`
+      : state.completed_at ? `backfilled ${state.completed_at.toISOString()}`
+        : `backfilling, through ${state.backfilled_through ?? 'nothing yet'}`;
+    console.log(`${state.table_name.padEnd(16)} ${phase}`);
+  }
+  if (!(await readState()).some((state) => state.cutover_at)) {
+    const { rows } = await pool.query('SELECT count(*)::int AS count FROM public.cards WHERE user_id IS NULL');
+    if (rows[0].count > 0) {
+      console.log(`${rows[0].count} cards have no user and must be assigned or deleted before the cutover`);
+    }
+  }
+};
+
+const backfill = async () => {
+  for (const table of TABLES) {
+    const total = await estimatedRows(table);
+    const started = Date.now();
+    let copied = 0;
+    let lastReport = 0;
+
+    for (;;) {
+      const { rows } = await pool.query('SELECT public.backfill_partitioned($1, $2) AS count', [table, batchSize]);
+      if (rows[0].count === 0) break;
+      copied += rows[0].count;
+
+      if (Date.now() - lastReport > 5000) {
+        lastReport = Date.now();
+        const rate = copied / ((Date.now() - started) / 1000);
+        const percent = total > 0 ? ` (~${Math.min(100, (copied / total) * 100).toFixed(1)}%)` : '';
+        console.log(`${table}: ${copied} rows${percent}, ${Math.round(rate)} rows/s`);
+      }
+      // Leaves room for production writes and for replicas to keep up
+      await sleep(pauseMs);
+    }
+    console.log(`${table}: backfilled ${copied} rows in ${((Date.now() - started) / 1000).toFixed(1)} s`);
+  }
+};
+
+const verify = async (): Promise<boolean> => {
+  let matches = true;
+  for (const table of TABLES) {
+    // The live table may hold cards without a user, which are not copied
+    const where = table === 'cards' ? ' WHERE user_id IS NOT NULL' : '';
+    const { rows } = await pool.query(
+      `SELECT (SELECT count(*) FROM public.${table}${where})::bigint AS live,
+              (SELECT count(*) FROM public.${table}_partitioned)::bigint AS partitioned`
+    );
+    const { live, partitioned } = rows[0];
+    console.log(`${table}: ${live} live, ${partitioned} partitioned`);
+    matches = matches && live === partitioned;
+  }
+  return matches;
+};
+
+const cutover = async () => {
+  const states = await readState();
+  if (states.every((state) => state.cutover_at)) {
+    console.log('Already cut over');
+  } else {
+    if (states.some((state) => !state.completed_at)) {
+      throw new Error('Backfill is not complete; run backfill first');
+    }
+    if (!(await verify())) {
+      throw new Error('Row counts differ; rerun verify once in-flight writes settle');
+    }
+
+    for (let attempt = 1; ; attempt++) {
+      const client = await pool.connect();
+      try {
+        await client.query('BEGIN');
+        // Queued behind a long transaction, the exclusive lock would stall every query on
+        // the tables; give up quickly and try again instead
+        await client.query(`SET LOCAL lock_timeout = ${Math.floor(lockTimeoutMs)}`);
+        await client.query('SELECT public.partition_cutover()');
+        await client.query('COMMIT');
+        console.log('Cut over to partitioned tables');
+        break;
+      } catch (error) {
+        await client.query('ROLLBACK');
+        // 55P03: lock_not_available
+        if (error.code !== '55P03' || attempt >= attempts) throw error;
+        console.log(`Lock not granted within ${lockTimeoutMs} ms, retrying (${attempt}/${attempts})`);
+        await sleep(1000 * attempt);
+      } finally {
+        client.release();
+      }
+    }
+  }
+
+  // Checks existing quiz questions without blocking writes
+  const { rows } = await pool.query(
+    `SELECT convalidated FROM pg_constraint
+     WHERE conname = 'quiz_questions_card_fkey' AND conrelid = 'public.quiz_questions'::regclass`
+  );
+  if (rows[0] && !rows[0].convalidated) {
+    await pool.query('ALTER TABLE public.quiz_questions VALIDATE CONSTRAINT quiz_questions_card_fkey');
+    console.log('Validated quiz_questions_card_fkey');
+  }
+};
+
+const dropOld = async () => {
+  if (!(await readState()).every((state) => state.cutover_at)) {
+    throw new Error('Not cut over yet; the live tables are still the unpartitioned ones');
+  }
+  for (const table of TABLES) {
+    await pool.query(`DROP TABLE IF EXISTS public.${table}_unpartitioned`);
+    console.log(`Dropped ${table}_unpartitioned`);
+  }
+};
+
+const commands: Record<string, () => Promise<unknown>> = {
+  status,
+  backfill,
+  verify: async () => {
+    if (!(await verify())) process.exitCode = 1;
+  },
+  cutover,
+  'drop-old': dropOld
+};
+
+const run = commands[command];
+if (!run) {
+  console.error(`Usage: tsx scripts/migrate-partitions.ts <${Object.keys(commands).join('|')}>`);
+  process.exit(1);
+}
+
+run()
+  .catch((error) => {
+    console.error(error.message);
+    process.exitCode = 1;
+  })
+  .finally(() => pool.end());
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Primary setup for the local primary/replica pair in docker-compose.replicas.yml:
+# a replication login, the roles PostgREST connects and serves requests as, and a
+# probe table for the query router integration test
+set -e
+
+echo "host replication replicator all scram-sha-256" >> "$PGDATA/pg_hba.conf"
+
+psql -v ON_ERROR_STOP=1 --username "$POSTGRES_USER" --dbname "$POSTGRES_DB" <<SQL
+CREATE ROLE replicator WITH REPLICATION LOGIN PASSWORD 'replicator';
+CREATE ROLE authenticator WITH LOGIN NOINHERIT PASSWORD 'authenticator';
+CREATE ROLE anon NOLOGIN;
+GRANT anon TO authenticator;
+
+CREATE TABLE public.replica_probe (
+    id TEXT PRIMARY KEY,
+    "userId" TEXT NOT NULL,
+    note TEXT,
+    "createdAt" TIMESTAMPTZ NOT NULL DEFAULT now()
+);
+GRANT SELECT, INSERT, UPDATE, DELETE ON public.replica_probe TO anon;
+SQL
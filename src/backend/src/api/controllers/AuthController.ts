@@ -133,7 +133,7 @@ export class AuthController {
    */
   public refreshToken = async (req: Request, res: Response): Promise<Response> => {
     try {
-      const refreshToken = req.cookies.refreshToken;
+      const refreshToken = req.cookies?.refreshToken || req.body?.refreshToken;
 
       if (!refreshToken) {
         return res.status(401).json(createErrorDetails(
@@ -9,10 +9,13 @@ import { asyncHandler } from '../../utils/asyncHandler';
 import { RoleValidator } from '../../auth/RoleValidator';
 import { AuthenticatedRequest } from '../middlewares/auth.middleware';
 import { CardService } from '../../services/CardService';
+import { ReviewSyncService } from '../../services/ReviewSyncService';
 import { validateCreateCard, validateUpdateCard, validateBulkCreateCards } from '../validators/card.validator';
 import { StudyModes } from '../../constants/studyModes';
 import { ICard } from '../../interfaces/ICard';
 import { injectable } from 'tsyringe';
+import { sendJson } from '../../utils/jsonStringifier';
+import { serializeCardListResponse, serializeCardResponse } from '../serializers/card.serializer';
 
 /**
  * Enhanced controller class for flashcard management with performance optimization
@@ -21,10 +24,12 @@ import { injectable } from 'tsyringe';
 export class CardController {
     private cardService: CardService;
     private roleValidator: RoleValidator;
+    private reviewSyncService: ReviewSyncService;
 
     constructor() {
         this.cardService = new CardService();
         this.roleValidator = new RoleValidator();
+        this.reviewSyncService = new ReviewSyncService();
     }
 
     /**
@@ -52,7 +57,7 @@ export class CardController {
 
         // Set cache control headers for performance
         res.set('Cache-Control', 'private, max-age=0, no-cache');
-        res.status(201).json({
+        sendJson(res.status(201), serializeCardResponse, {
             success: true,
             data: card,
             metadata: {
@@ -82,7 +87,7 @@ export class CardController {
             preferredMode
         );
 
-        res.status(201).json({
+        sendJson(res.status(201), serializeCardListResponse, {
             success: true,
             data: cards,
             metadata: {
@@ -114,7 +119,7 @@ export class CardController {
         }
 
         res.set('Cache-Control', 'private, max-age=300'); // 5-minute cache
-        res.json({
+        sendJson(res, serializeCardResponse, {
             success: true,
             data: card
         });
@@ -142,7 +147,7 @@ export class CardController {
         );
 
         res.set('Cache-Control', 'private, max-age=60'); // 1-minute cache
-        res.json({
+        sendJson(res, serializeCardListResponse, {
             success: true,
             data: cards,
             metadata: {
@@ -176,7 +181,7 @@ export class CardController {
         );
 
         res.set('Cache-Control', 'private, max-age=30'); // 30-second cache
-        res.json({
+        sendJson(res, serializeCardListResponse, {
             success: true,
             data: cards,
             metadata: {
@@ -208,7 +213,7 @@ export class CardController {
             mode as StudyModes
         );
 
-        res.json({
+        sendJson(res, serializeCardResponse, {
             success: true,
             data: updatedCard,
             metadata: {
@@ -245,7 +250,7 @@ export class CardController {
 
         const updatedCard = await this.cardService.updateCard(id, req.body);
 
-        res.json({
+        sendJson(res, serializeCardResponse, {
             success: true,
             data: updatedCard
         });
@@ -277,6 +282,24 @@ export class CardController {
         res.status(204).send();
     });
 
+    /**
+     * Exchanges review-log deltas with a device studying from its offline card store
+     */
+    public syncReviews = asyncHandler(async (req: AuthenticatedRequest, res: Response): Promise<void> => {
+        if (!req.user) {
+            res.status(401).json({ success: false, error: 'Authentication required' });
+            return;
+        }
+
+        const result = await this.reviewSyncService.sync(req.user.id, req.body);
+
+        res.set('Cache-Control', 'private, no-store');
+        res.status(200).json({
+            success: true,
+            data: result
+        });
+    });
+
     public async bulkCreateCards(req: Request, res: Response, next: NextFunction): Promise<void> {
         try {
             const cards = await this.cardService.createCards(req.body);
@@ -11,7 +11,9 @@ import { RateLimiterMemory } from 'rate-limiter-flexible';
 import { ContentService } from '../../services/ContentService';
 import { validateContentCreation, validateContentUpdate, validateContentId } from '../validators/content.validator';
 import { IContent, ContentStatus } from '../../interfaces/IContent';
-import { sanitizeInput } from '../../utils/validation';
+import { sanitizeInputAsync } from '../../utils/validation';
+import { sendJson } from '../../utils/jsonStringifier';
+import { serializeContentListResponse } from '../serializers/content.serializer';
 import { IUser } from '../../interfaces/IUser';
 
 // Constants for rate limiting and circuit breaking
@@ -88,7 +90,7 @@ export class ContentController {
             }
 
             // Sanitize content
-            const sanitizedContent = sanitizeInput(value.content, {
+            const sanitizedContent = await sanitizeInputAsync(value.content, {
                 stripTags: true,
                 escapeHTML: true,
                 preventSQLInjection: true
@@ -168,7 +170,7 @@ export class ContentController {
                 return this.contentService.getUserContent(req.user.id, status);
             });
 
-            return res.status(StatusCodes.OK).json({ data: content });
+            return sendJson(res.status(StatusCodes.OK), serializeContentListResponse, { data: content });
         } catch (error) {
             return res.status(StatusCodes.INTERNAL_SERVER_ERROR).json({
                 error: 'Failed to retrieve user content',
@@ -9,9 +9,11 @@ import compression from 'compression';
 import rateLimit from 'express-rate-limit';
 import { PerformanceMonitor } from 'performance-monitor';
 import { StudyService } from '../../services/StudyService';
-import { createStudySessionSchema, updateStudySessionSchema, validateStudyMode } from '../validators/study.validator';
+import { compiledSessionSchemas, validateStudyMode } from '../validators/study.validator';
 import { StudyModes } from '../../constants/studyModes';
 import { performanceMonitor } from '../../core/monitoring/PerformanceMonitor';
+import { sendJson } from '../../utils/jsonStringifier';
+import { serializeStudySession, serializeStudySessionResponse } from '../serializers/study.serializer';
 
 /**
  * Controller handling HTTP requests for study session management with comprehensive
@@ -53,7 +55,7 @@ export class StudyController {
         
         try {
             // Validate request body
-            const { error, value } = createStudySessionSchema.validate(req.body);
+            const { error, value } = compiledSessionSchemas.create.validate(req.body);
             if (error) {
                 throw new Error(`Invalid request data: ${error.message}`);
             }
@@ -84,7 +86,7 @@ export class StudyController {
                 success: true
             });
 
-            res.status(201).json({
+            sendJson(res.status(201), serializeStudySessionResponse, {
                 success: true,
                 data: session,
                 performance: perfMetrics.getMetrics()
@@ -108,7 +110,7 @@ export class StudyController {
 
         try {
             // Validate request body
-            const { error, value } = updateStudySessionSchema.validate(req.body);
+            const { error, value } = compiledSessionSchemas.update.validate(req.body);
             if (error) {
                 throw new Error(`Invalid update data: ${error.message}`);
             }
@@ -249,7 +251,7 @@ export class StudyController {
                 success: true
             });
 
-            res.status(200).json({
+            sendJson(res.status(200), serializeStudySessionResponse, {
                 success: true,
                 data: session,
                 performance: perfMetrics.getMetrics()
@@ -275,7 +277,7 @@ export class StudyController {
                 cardCount: session.cards.length
             });
 
-            res.json(session);
+            sendJson(res, serializeStudySession, session);
         } catch (error) {
             performanceMonitor.endSpan(spanId, {
                 success: false,
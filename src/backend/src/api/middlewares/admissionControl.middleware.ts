@@ -0,0 +1,69 @@
+import { Request, Response, NextFunction } from 'express'; // v4.18.2
+import { ErrorCodes, createErrorDetails } from '../../constants/errorCodes';
+import {
+  AdmissionController,
+  AdmissionPriority,
+  AdmissionRejectedError
+} from '../../core/monitoring/admissionController';
+
+/**
+ * Priority class of each route, first match wins. Reviews and auth are critical;
+ * content capture, generation, analytics and telemetry ingest are sheddable; anything
+ * else is normal.
+ */
+const ROUTE_PRIORITIES: Array<{ method?: string; path: RegExp; priority: AdmissionPriority }> = [
+  { path: /^\/api\/v1\/auth\//, priority: 'critical' },
+  { method: 'POST', path: /^\/api\/v1\/users\/(login|register|refresh-token)$/, priority: 'critical' },
+  { method: 'GET', path: /^\/api\/v1\/study\/sessions\/[^/]+\/stats$/, priority: 'sheddable' },
+  { path: /^\/api\/v1\/study\/sessions(\/|$)/, priority: 'critical' },
+  { method: 'GET', path: /^\/api\/v1\/cards\/due$/, priority: 'critical' },
+  { method: 'POST', path: /^\/api\/v1\/cards\/[^/]+\/review$/, priority: 'critical' },
+  { method: 'POST', path: /^\/api\/v1\/cards\/(generate|bulk)$/, priority: 'sheddable' },
+  { method: 'POST', path: /^\/api\/v1\/content\/?$/, priority: 'sheddable' },
+  { path: /^\/api\/v1\/telemetry\//, priority: 'sheddable' }
+];
+
+export const routePriority = (method: string, path: string): AdmissionPriority =>
+  ROUTE_PRIORITIES.find((route) => (!route.method || route.method === method) && route.path.test(path))?.priority ??
+    'normal';
+
+/**
+ * Admits each request by its route's priority class before any work is spent on it,
+ * body parsing included. Rejected requests get a 503 with Retry-After.
+ */
+export const admissionControl = (controller: AdmissionController) =>
+  async (req: Request, res: Response, next: NextFunction): Promise<void> => {
+    // The response closes early only if the client goes away
+    const abandoned = new AbortController();
+    const onClose = () => abandoned.abort();
+    res.once('close', onClose);
+
+    let release: () => void;
+    try {
+      release = await controller.admit(routePriority(req.method, req.path), abandoned.signal);
+    } catch (error) {
+      res.off('close', onClose);
+      if (!(error instanceof AdmissionRejectedError)) {
+        return next(error);
+      }
+      if (error.reason !== 'cancelled') {
+        res.setHeader('Retry-After', String(error.retryAfterSeconds));
+        res.status(503).json(createErrorDetails(
+          ErrorCodes.SERVICE_UNAVAILABLE,
+          `Server is busy, retry in ${error.retryAfterSeconds} s`,
+          req.originalUrl
+        ));
+      }
+      return;
+    }
+
+    res.off('close', onClose);
+    // The client may have gone between the admission and here, when no listener held the slot
+    if (abandoned.signal.aborted || res.destroyed || res.writableEnded) {
+      release();
+      return;
+    }
+    res.once('close', release);
+    res.once('finish', release);
+    next();
+  };
@@ -80,11 +80,7 @@ export const authenticate = async (
     }
 
     const token = authHeader.split(' ')[1];
-    const isBlacklisted = await tokenService.isTokenBlacklisted(token);
-    if (isBlacklisted) {
-      throw new JWTError('Token is blacklisted', 'TOKEN_BLACKLISTED');
-    }
-
+    // Verifies the signature and that the token has not been revoked
     const decoded = await tokenService.verifyAccessToken(token);
 
     // Attach user context to request
@@ -0,0 +1,10 @@
+import { Request, Response, NextFunction } from 'express'; // v4.18.2
+import { runInLoaderScope } from '../../utils/batchLoader';
+
+/**
+ * Gives each request its own batching loaders, so row lookups made while handling it
+ * are coalesced and memoized for that request only
+ */
+export const loaderScope = (req: Request, res: Response, next: NextFunction): void => {
+  runInLoaderScope(next);
+};
@@ -67,6 +67,29 @@ router.post('/generate',
     }
 );
 
+/**
+ * Sync reviews recorded offline and pull other devices' reviews and changed cards
+ * @security JWT authentication required
+ * @rbac FREE_USER, PRO_USER, POWER_USER
+ */
+router.post('/sync',
+    authenticate,
+    authorize([UserRole.FREE_USER, UserRole.PRO_USER, UserRole.POWER_USER]),
+    validateRequest(cardValidationSchemas.syncReviewsSchema),
+    rateLimiter({
+        windowMs: 60000,
+        max: 60,
+        keyPrefix: 'sync-reviews'
+    }),
+    async (req: AuthenticatedRequest, res: Response, next: NextFunction) => {
+        try {
+            await cardController.syncReviews(req, res, next);
+        } catch (error) {
+            next(error);
+        }
+    }
+);
+
 /**
  * Get a specific card by ID
  * @security JWT authentication required
@@ -15,6 +15,7 @@ import cardsRouter from './cards.routes';
 import configureContentRoutes from './content.routes';
 import initializeStudyRoutes from './study.routes';
 import usersRouter from './users.routes';
+import telemetryRouter from './telemetry.routes';
 import { ContentController } from '../controllers/ContentController';
 import { StudyController } from '../controllers/StudyController';
 import { ErrorCodes, createErrorDetails } from '../../constants/errorCodes';
@@ -24,7 +25,7 @@ import { StudyService } from '../../services/StudyService';
 import winston from 'winston';
 import Redis from 'ioredis';
 import { ContentProcessor } from '../../core/ai/contentProcessor';
-import { SecurityService } from '../../services/SecurityService';
+import { QuestionBankService } from '../../services/QuestionBankService';
 import { openai } from '../../config/openai';
 import { voiceRouter } from './voice.routes';
 import { databaseManager } from '../../config/database';
@@ -59,15 +60,16 @@ redisClient.on('error', (err) => {
 });
 
 const contentProcessor = new ContentProcessor(openai);
-const securityService = new SecurityService();
+const questionBankService = new QuestionBankService();
 
 // Initialize services with dependencies
 const contentService = new ContentService(
     contentProcessor,
-    securityService,
-    redisClient
+    redisClient,
+    questionBankService
 );
-const studyService = new StudyService();
+// Quiz sessions sample the same question bank that content processing refreshes
+const studyService = StudyService.create(questionBankService);
 
 // Create logger for voice service
 const voiceLogger = winston.createLogger({
@@ -182,6 +184,7 @@ router.use('/v1/content', configureContentRoutes(contentController));
 router.use('/v1/study', initializeStudyRoutes(studyController));
 router.use('/voice', voiceRouter);
 router.use('/v1/users', usersRouter);
+router.use('/v1/telemetry', telemetryRouter);
 
 // Debug logging for mounted routes
 console.log('All registered routes:', router.stack.map(r => ({
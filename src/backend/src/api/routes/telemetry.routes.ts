@@ -0,0 +1,72 @@
+/**
+ * @fileoverview Telemetry ingestion routes for native client trace batches.
+ * Decodes binary span batches from the iOS trace ring and feeds the Prometheus registry.
+ * @version 1.0.0
+ */
+
+import express, { Request, Response, NextFunction } from 'express'; // ^4.18.2
+import { authenticate } from '../middlewares/auth.middleware';
+import { rateLimiter } from '../middlewares/rateLimiter.middleware';
+import { ErrorCodes, createErrorDetails } from '../../constants/errorCodes';
+import { performanceMonitor } from '../../core/monitoring/PerformanceMonitor';
+import { decodeTraceBatch, TraceBatchError } from '../../core/monitoring/nativeTraceBatch';
+import { logger } from '../../config/logger';
+
+// One device batch holds at most 4096 spans (~100 KB)
+const MAX_TRACE_BATCH_BYTES = '256kb';
+
+// Platforms accepted in the X-Membo-Platform header; anything else is labelled 'unknown'
+const KNOWN_PLATFORMS = new Set(['ios', 'android']);
+
+const router = express.Router();
+
+/**
+ * Ingest a binary trace batch
+ * @security JWT authentication required
+ */
+router.post('/traces',
+    authenticate,
+    rateLimiter({
+        windowMs: 60000,
+        max: 30,
+        keyPrefix: 'telemetry-traces'
+    }),
+    express.raw({ type: 'application/octet-stream', limit: MAX_TRACE_BATCH_BYTES }),
+    (req: Request, res: Response, next: NextFunction) => {
+        try {
+            if (!Buffer.isBuffer(req.body)) {
+                const error = createErrorDetails(
+                    ErrorCodes.BAD_REQUEST,
+                    'Expected an application/octet-stream trace batch',
+                    req.originalUrl
+                );
+                res.status(error.status).json(error);
+                return;
+            }
+
+            const batch = decodeTraceBatch(req.body);
+            const header = String(req.headers['x-membo-platform'] || '').toLowerCase();
+            const platform = KNOWN_PLATFORMS.has(header) ? header : 'unknown';
+
+            for (const span of batch.spans) {
+                performanceMonitor.recordNativeSpan(span.name, platform, Number(span.durationNs) / 1e9);
+            }
+            performanceMonitor.trackDroppedNativeSpans(platform, batch.droppedCount);
+
+            res.status(202).json({
+                accepted: batch.spans.length,
+                dropped: batch.droppedCount
+            });
+        } catch (error) {
+            if (error instanceof TraceBatchError) {
+                logger.warn('Rejected malformed trace batch', { reason: error.message });
+                const details = createErrorDetails(ErrorCodes.BAD_REQUEST, error.message, req.originalUrl);
+                res.status(details.status).json(details);
+                return;
+            }
+            next(error);
+        }
+    }
+);
+
+export default router;
@@ -0,0 +1,102 @@
+/**
+ * @fileoverview Compiled response serializers for card endpoints.
+ * Schemas follow ICard in declaration order; cards in any other key order, such as raw
+ * rows, still serialize correctly through JSON.stringify.
+ * @version 1.0.0
+ */
+
+import { compileStringifier, JsonSchema } from '../../utils/jsonStringifier';
+
+const contentMetadataSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        sourceUrl: { type: 'string' },
+        sourcePage: { type: 'number' },
+        sourcePosition: {
+            type: 'object',
+            properties: { start: { type: 'number' }, end: { type: 'number' } }
+        },
+        languageCode: { type: 'string' },
+        codeLanguage: { type: 'string' },
+        aiGenerated: { type: 'boolean' },
+        generationPrompt: { type: 'string' },
+        lastModifiedBy: { type: 'string' }
+    }
+};
+
+const cardContentSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        text: { type: 'string' },
+        type: { type: 'string' },
+        metadata: contentMetadataSchema
+    }
+};
+
+/**
+ * Schema of a card as returned by the card endpoints
+ */
+export const cardSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        id: { type: 'string' },
+        userId: { type: 'string' },
+        contentId: { type: 'string' },
+        frontContent: cardContentSchema,
+        backContent: cardContentSchema,
+        fsrsData: {
+            type: 'object',
+            properties: {
+                stability: { type: 'number' },
+                difficulty: { type: 'number' },
+                reviewCount: { type: 'integer' },
+                lastReview: { type: 'string', format: 'date-time' },
+                lastRating: { type: 'integer' }
+            }
+        },
+        nextReview: { type: 'string', format: 'date-time' },
+        compatibleModes: { type: 'array', items: { type: 'string' } },
+        tags: { type: 'array', items: { type: 'string' } },
+        createdAt: { type: 'string', format: 'date-time' },
+        updatedAt: { type: 'string', format: 'date-time' }
+    }
+};
+
+// Each card endpoint sends an in-order subset of these metadata keys
+const responseMetadataSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        page: { type: 'integer' },
+        limit: { type: 'integer' },
+        total: { type: 'integer' },
+        count: { type: 'integer' },
+        mode: { type: 'string' },
+        processingTime: { type: 'number' },
+        cardCount: { type: 'integer' },
+        nextReview: { type: 'string', format: 'date-time' }
+    }
+};
+
+/**
+ * `{ success, data: card, metadata? }` responses
+ */
+export const serializeCardResponse = compileStringifier({
+    type: 'object',
+    properties: {
+        success: { type: 'boolean' },
+        data: cardSchema,
+        metadata: responseMetadataSchema
+    }
+});
+
+/**
+ * `{ success, data: cards, metadata? }` responses: card lists and due cards
+ */
+export const serializeCardListResponse = compileStringifier({
+    type: 'object',
+    properties: {
+        success: { type: 'boolean' },
+        data: { type: 'array', items: cardSchema },
+        metadata: responseMetadataSchema
+    }
+});
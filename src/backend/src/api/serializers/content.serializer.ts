@@ -0,0 +1,36 @@
+/**
+ * @fileoverview Compiled response serializers for content endpoints.
+ * Schemas follow IContent in declaration order; free-form metadata is serialized as is.
+ * @version 1.0.0
+ */
+
+import { compileStringifier, JsonSchema } from '../../utils/jsonStringifier';
+
+/**
+ * Schema of a content item as returned by the content endpoints
+ */
+export const contentSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        id: { type: 'string' },
+        userId: { type: 'string' },
+        content: { type: 'string' },
+        metadata: {},
+        source: { type: 'string' },
+        sourceUrl: { type: 'string' },
+        status: { type: 'string' },
+        createdAt: { type: 'string', format: 'date-time' },
+        updatedAt: { type: 'string', format: 'date-time' },
+        processedAt: { type: 'string', format: 'date-time' }
+    }
+};
+
+/**
+ * `{ data: contents }` responses
+ */
+export const serializeContentListResponse = compileStringifier({
+    type: 'object',
+    properties: {
+        data: { type: 'array', items: contentSchema }
+    }
+});
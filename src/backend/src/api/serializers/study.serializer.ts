@@ -0,0 +1,108 @@
+/**
+ * @fileoverview Compiled response serializers for study session endpoints.
+ * Schemas follow IStudySession in declaration order.
+ * @version 1.0.0
+ */
+
+import { compileStringifier, JsonSchema } from '../../utils/jsonStringifier';
+
+const performanceSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        totalCards: { type: 'integer' },
+        correctCount: { type: 'integer' },
+        averageConfidence: { type: 'number' },
+        studyStreak: { type: 'integer' },
+        timeSpent: { type: 'number' },
+        fsrsProgress: {
+            type: 'object',
+            properties: {
+                averageStability: { type: 'number' },
+                averageDifficulty: { type: 'number' },
+                retentionRate: { type: 'number' },
+                intervalProgress: { type: 'number' }
+            }
+        }
+    }
+};
+
+const settingsSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        sessionDuration: { type: 'number' },
+        cardsPerSession: { type: 'integer' },
+        showConfidenceButtons: { type: 'boolean' },
+        enableFSRS: { type: 'boolean' },
+        voiceConfig: {
+            type: 'object',
+            properties: {
+                recognitionThreshold: { type: 'number' },
+                language: { type: 'string' },
+                useNativeSpeaker: { type: 'boolean' }
+            }
+        },
+        fsrsConfig: {
+            type: 'object',
+            properties: {
+                requestRetention: { type: 'number' },
+                maximumInterval: { type: 'number' },
+                easyBonus: { type: 'number' },
+                hardPenalty: { type: 'number' }
+            }
+        }
+    }
+};
+
+const quizQuestionSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        id: { type: 'string' },
+        cardId: { type: 'string' },
+        contentId: { type: 'string' },
+        userId: { type: 'string' },
+        cardHash: { type: 'string' },
+        bankVersion: { type: 'integer' },
+        question: { type: 'string' },
+        type: { type: 'string' },
+        options: { type: 'array', items: { type: 'string' } },
+        correctAnswer: { type: 'string' },
+        explanation: { type: 'string' }
+    }
+};
+
+/**
+ * Schema of study session state
+ */
+export const studySessionSchema: JsonSchema = {
+    type: 'object',
+    properties: {
+        id: { type: 'string' },
+        userId: { type: 'string' },
+        mode: { type: 'string' },
+        startTime: { type: 'string', format: 'date-time' },
+        endTime: { type: 'string', format: 'date-time' },
+        cardsStudied: { type: 'array', items: { type: 'string' } },
+        performance: performanceSchema,
+        voiceEnabled: { type: 'boolean' },
+        status: { type: 'string' },
+        settings: settingsSchema,
+        quizQuestions: { type: 'array', items: quizQuestionSchema }
+    }
+};
+
+/**
+ * Bare session state, as sent by getSessionState
+ */
+export const serializeStudySession = compileStringifier(studySessionSchema);
+
+/**
+ * `{ success, data: session, performance }` responses; request timings are serialized as is
+ */
+export const serializeStudySessionResponse = compileStringifier({
+    type: 'object',
+    properties: {
+        success: { type: 'boolean' },
+        data: studySessionSchema,
+        performance: {}
+    }
+});
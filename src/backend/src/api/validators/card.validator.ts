@@ -7,13 +7,16 @@
 
 import Joi from 'joi'; // v17.9.0
 import { ICard, ContentType } from '../../interfaces/ICard';
+import { IReviewSyncRequest } from '../../interfaces/IReviewSync';
 import { StudyModes, StudyModeConfig } from '../../constants/studyModes';
+import { compileSchema } from '../../utils/schemaCompiler';
 
 // Constants for validation limits
 const MAX_TEXT_LENGTH = 10000;
 const MAX_TAGS = 20;
 const MAX_TAG_LENGTH = 50;
 const MAX_BULK_CARDS = 100;
+const MAX_SYNCED_REVIEWS = 500;
 
 // Base content schema for reusability
 const contentSchema = Joi.object({
@@ -73,29 +76,107 @@ const validateStudyModeAccess = (modes: StudyModes[], userRole: string): boolean
 };
 
 /**
- * Create card validation schema with role-based validation
+ * Study modes array restricted to the modes the caller's role may use; the role is
+ * passed in the validation context so the schema can be built and compiled once
  */
-export const validateCreateCard = async (requestBody: Partial<ICard>, userRole?: string) => {
-    const createCardSchema = Joi.object({
-        frontContent: contentSchema.required(),
-        backContent: contentSchema.required(),
-        fsrsData: fsrsDataSchema.required(),
-        compatibleModes: Joi.array()
-            .items(Joi.string().valid(...Object.values(StudyModes)))
-            .required(),
-        tags: Joi.array()
-            .items(Joi.string().max(MAX_TAG_LENGTH))
-            .max(MAX_TAGS)
-            .unique()
-            .optional()
-    }).options({ 
-        abortEarly: false,
-        messages: {
-            'string.xss': 'Content contains potentially unsafe HTML or scripts',
-            'array.studyModeAccess': 'User role does not have access to selected study modes'
+const roleCheckedModesSchema = Joi.array()
+    .items(Joi.string().valid(...Object.values(StudyModes)))
+    .custom((value, helpers) => {
+        const userRole = (helpers.prefs.context as { userRole?: string } | undefined)?.userRole;
+        if (!userRole || !validateStudyModeAccess(value, userRole)) {
+            return helpers.error('array.studyModeAccess');
         }
+        return value;
     });
 
+const tagsSchema = Joi.array()
+    .items(Joi.string().max(MAX_TAG_LENGTH))
+    .max(MAX_TAGS)
+    .unique()
+    .optional();
+
+const createCardSchema = compileSchema(Joi.object({
+    frontContent: contentSchema.required(),
+    backContent: contentSchema.required(),
+    fsrsData: fsrsDataSchema.required(),
+    compatibleModes: Joi.array()
+        .items(Joi.string().valid(...Object.values(StudyModes)))
+        .required(),
+    tags: tagsSchema
+}).options({ 
+    abortEarly: false,
+    messages: {
+        'string.xss': 'Content contains potentially unsafe HTML or scripts',
+        'array.studyModeAccess': 'User role does not have access to selected study modes'
+    }
+}));
+
+const updateCardSchema = compileSchema(Joi.object({
+    frontContent: contentSchema.optional(),
+    backContent: contentSchema.optional(),
+    fsrsData: fsrsDataSchema.optional(),
+    compatibleModes: roleCheckedModesSchema.optional(),
+    tags: tagsSchema
+}).min(1) // Require at least one field to be updated
+.options({
+    abortEarly: false,
+    messages: {
+        'string.xss': 'Content contains potentially unsafe HTML or scripts',
+        'array.studyModeAccess': 'User role does not have access to selected study modes',
+        'object.min': 'At least one field must be provided for update'
+    }
+}));
+
+const bulkCreateSchema = compileSchema(Joi.object({
+    cards: Joi.array()
+        .items(Joi.object({
+            frontContent: contentSchema.required(),
+            backContent: contentSchema.required(),
+            fsrsData: fsrsDataSchema.required(),
+            compatibleModes: roleCheckedModesSchema.required(),
+            tags: tagsSchema
+        }))
+        .min(1)
+        .max(MAX_BULK_CARDS)
+        .required()
+}).options({
+    abortEarly: false,
+    messages: {
+        'string.xss': 'Content contains potentially unsafe HTML or scripts',
+        'array.studyModeAccess': 'User role does not have access to selected study modes',
+        'array.max': `Bulk creation limited to ${MAX_BULK_CARDS} cards`,
+        'array.min': 'At least one card must be provided for bulk creation'
+    }
+}));
+
+// Review-log delta pushed by an offline device; times are epoch milliseconds
+const syncReviewsSchema = compileSchema(Joi.object({
+    deviceId: Joi.string().max(128).required(),
+    reviews: Joi.array()
+        .items(Joi.object({
+            sequence: Joi.number().integer().positive().required(),
+            cardId: Joi.string().uuid().required(),
+            rating: Joi.number().integer().min(1).max(5).required(),
+            reviewedAt: Joi.number().integer().min(0).required(),
+            stability: Joi.number().min(0).required(),
+            difficulty: Joi.number().min(0).max(1).required(),
+            dueAt: Joi.number().integer().min(0).required()
+        }))
+        .max(MAX_SYNCED_REVIEWS)
+        .default([]),
+    cursor: Joi.number().integer().min(0).default(0),
+    cardsSince: Joi.number().integer().min(0).default(0)
+}).options({
+    abortEarly: false,
+    messages: {
+        'array.max': `Sync limited to ${MAX_SYNCED_REVIEWS} reviews per request`
+    }
+}));
+
+/**
+ * Create card validation schema with role-based validation
+ */
+export const validateCreateCard = async (requestBody: Partial<ICard>, userRole?: string) => {
     return createCardSchema.validateAsync(requestBody);
 };
 
@@ -103,81 +184,37 @@ export const validateCreateCard = async (requestBody: Partial<ICard>, userRole?:
  * Update card validation schema with partial update support
  */
 export const validateUpdateCard = async (requestBody: Partial<ICard>, userRole?: string) => {
-    const updateCardSchema = Joi.object({
-        frontContent: contentSchema.optional(),
-        backContent: contentSchema.optional(),
-        fsrsData: fsrsDataSchema.optional(),
-        compatibleModes: Joi.array()
-            .items(Joi.string().valid(...Object.values(StudyModes)))
-            .custom((value, helpers) => {
-                if (!userRole || !validateStudyModeAccess(value, userRole)) {
-                    return helpers.error('array.studyModeAccess');
-                }
-                return value;
-            })
-            .optional(),
-        tags: Joi.array()
-            .items(Joi.string().max(MAX_TAG_LENGTH))
-            .max(MAX_TAGS)
-            .unique()
-            .optional()
-    }).min(1) // Require at least one field to be updated
-    .options({
-        abortEarly: false,
-        messages: {
-            'string.xss': 'Content contains potentially unsafe HTML or scripts',
-            'array.studyModeAccess': 'User role does not have access to selected study modes',
-            'object.min': 'At least one field must be provided for update'
-        }
-    });
-
-    return updateCardSchema.validateAsync(requestBody);
+    return updateCardSchema.validateAsync(requestBody, { context: { userRole } });
 };
 
 /**
  * Bulk create cards validation schema with enhanced batch validation
  */
 export const validateBulkCreateCards = async (requestBody: { cards: Partial<ICard>[] }, userRole?: string) => {
-    const bulkCreateSchema = Joi.object({
-        cards: Joi.array()
-            .items(Joi.object({
-                frontContent: contentSchema.required(),
-                backContent: contentSchema.required(),
-                fsrsData: fsrsDataSchema.required(),
-                compatibleModes: Joi.array()
-                    .items(Joi.string().valid(...Object.values(StudyModes)))
-                    .custom((value, helpers) => {
-                        if (!userRole || !validateStudyModeAccess(value, userRole)) {
-                            return helpers.error('array.studyModeAccess');
-                        }
-                        return value;
-                    })
-                    .required(),
-                tags: Joi.array()
-                    .items(Joi.string().max(MAX_TAG_LENGTH))
-                    .max(MAX_TAGS)
-                    .unique()
-                    .optional()
-            }))
-            .min(1)
-            .max(MAX_BULK_CARDS)
-            .required()
-    }).options({
-        abortEarly: false,
-        messages: {
-            'string.xss': 'Content contains potentially unsafe HTML or scripts',
-            'array.studyModeAccess': 'User role does not have access to selected study modes',
-            'array.max': `Bulk creation limited to ${MAX_BULK_CARDS} cards`,
-            'array.min': 'At least one card must be provided for bulk creation'
-        }
-    });
+    return bulkCreateSchema.validateAsync(requestBody, { context: { userRole } });
+};
 
-    return bulkCreateSchema.validateAsync(requestBody);
+/**
+ * Compiled card schemas, with the Joi schemas they were compiled from
+ */
+export const compiledCardSchemas = {
+    create: createCardSchema,
+    update: updateCardSchema,
+    bulkCreate: bulkCreateSchema,
+    syncReviews: syncReviewsSchema
+};
+
+/**
+ * Review sync validation schema, filling in the cursors of a first sync
+ */
+export const validateSyncReviews = async (requestBody: Partial<IReviewSyncRequest>, userRole?: string) => {
+    return syncReviewsSchema.validateAsync(requestBody);
 };
 
 // Export validation schemas and functions
 export const cardValidationSchemas = {
     createCardSchema: validateCreateCard,
     updateCardSchema: validateUpdateCard,
-    bulkCreateSchema: validateBulkCreateCards
+    bulkCreateSchema: validateBulkCreateCards,
+    syncReviewsSchema: validateSyncReviews
 };
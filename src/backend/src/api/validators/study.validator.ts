@@ -7,6 +7,7 @@
 import Joi from 'joi'; // ^17.9.0
 import { StudyModes } from '../../constants/studyModes';
 import { IStudySession } from '../../interfaces/IStudySession';
+import { compileSchema } from '../../utils/schemaCompiler';
 
 // Constants for validation rules
 const MIN_SESSION_DURATION = 900; // 15 minutes in seconds
@@ -154,6 +155,14 @@ export const updateStudySessionSchema = Joi.object({
     settings: Joi.forbidden() // Settings cannot be modified after session creation
 }).required();
 
+/**
+ * Compiled session schemas for the study controller's per-request validation
+ */
+export const compiledSessionSchemas = {
+    create: compileSchema(createStudySessionSchema),
+    update: compileSchema(updateStudySessionSchema)
+};
+
 /**
  * Validates FSRS algorithm configuration parameters
  */
@@ -16,8 +16,11 @@ import cors from 'cors';
 import http from 'http';
 import net from 'net';
 import { WebSocketManager } from './websocket/WebSocketManager';
+import { cardStreamHandler } from './websocket/handlers/cardStreamHandler';
+import { redisClient } from './config/redis';
 import routes from './api/routes';
 import { logger } from './config/logger';
+import { asyncLogger } from './config/asyncLogger';
 import winston from 'winston';
 import { StudySessionHandler } from './websocket/handlers/studySessionHandler';
 import { VoiceHandler } from './websocket/handlers/voiceHandler';
@@ -27,6 +30,9 @@ import { StudySessionManager } from './core/study/studySessionManager';
 import { VoiceService } from './services/VoiceService';
 import bodyParser from 'body-parser';
 import { getServices } from './config/services';
+import { loaderScope } from './api/middlewares/loaderScope.middleware';
+import { admissionControl } from './api/middlewares/admissionControl.middleware';
+import { AdmissionController } from './core/monitoring/admissionController';
 
 // Initialize Express application
 const app: Application = express();
@@ -35,6 +41,9 @@ const app: Application = express();
 const services = getServices();
 services.redisService.startCleanupTasks();
 
+// Samples this worker's event-loop delay for admission control
+const admissionController = AdmissionController.fromEnv();
+
 /**
  * Configures Express middleware chain with security and performance features
  */
@@ -76,6 +85,9 @@ const configureMiddleware = (app: Application): void => {
     exposedHeaders: ['set-cookie']
   }));
 
+  // Admission by route priority, so shed requests cost no body parsing
+  app.use(admissionControl(admissionController));
+
   // Request parsing
   app.use(bodyParser.json({limit: '50mb'}));
   app.use(bodyParser.urlencoded({limit: '50mb', extended: true}));
@@ -116,6 +128,9 @@ const configureMiddleware = (app: Application): void => {
 
     next();
   });
+
+  // Per-request batching and memoization of row lookups
+  app.use(loaderScope);
 };
 
 // Create and configure HTTP server
@@ -157,15 +172,6 @@ app.use((err: Error, req: Request, res: Response, next: NextFunction) => {
 });
 
 // Initialize dependencies with proper configuration
-const wsLogger = winston.createLogger({
-    level: 'info',
-    format: winston.format.combine(
-        winston.format.timestamp(),
-        winston.format.json()
-    ),
-    transports: [new winston.transports.Console()]
-});
-
 // Initialize shared logger configuration
 const serviceLogger = winston.createLogger({
     level: 'info',
@@ -182,8 +188,11 @@ const voiceService = new VoiceService(serviceLogger);
 const studySessionManager = new StudySessionManager();
 const connectionPool = new ConnectionPool(1000);
 
-const studySessionHandler = new StudySessionHandler(studySessionManager, wsLogger);
-const voiceHandler = new VoiceHandler(voiceService, wsLogger, metricsCollector);
+// Content jobs run on any worker; card events reach sockets on every worker
+cardStreamHandler.connect(redisClient);
+
+const studySessionHandler = new StudySessionHandler(studySessionManager, asyncLogger);
+const voiceHandler = new VoiceHandler(voiceService, asyncLogger, metricsCollector);
 
 const wsManager = new WebSocketManager(
     server,
@@ -191,7 +200,7 @@ const wsManager = new WebSocketManager(
     voiceHandler,
     connectionPool,
     metricsCollector,
-    wsLogger
+    asyncLogger
 );
 
 // Handle cleanup during shutdown
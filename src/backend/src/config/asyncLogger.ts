@@ -0,0 +1,140 @@
+/**
+ * @fileoverview Asynchronous structured logger for hot paths such as websocket message handling.
+ * Entries are serialized by pino and handed to a worker-thread transport through a shared
+ * buffer, so writing never blocks the event loop. Disabled levels return before any fields
+ * are built, and high-rate events can be sampled per event; errors are always written.
+ * @version 1.0.0
+ */
+
+import pino from 'pino'; // ^8.0.0
+
+export type LogLevel = 'error' | 'warn' | 'info' | 'debug';
+
+export type LogFields = Record<string, unknown>;
+
+/**
+ * Entry fields, or a function building them that only runs when the entry is written
+ */
+export type LazyFields = LogFields | (() => LogFields);
+
+/**
+ * Per-event sampling: an event with rate N writes one entry in N, starting with the first
+ */
+export type SampleRates = Record<string, number>;
+
+export interface AsyncLoggerOptions {
+    level?: LogLevel;
+    // Defaults to a worker-thread transport writing to stdout
+    destination?: pino.DestinationStream;
+    sampling?: SampleRates;
+}
+
+const LOG_LEVELS: LogLevel[] = ['error', 'warn', 'info', 'debug'];
+
+const getLogLevel = (): LogLevel => {
+    const level = process.env.LOG_LEVEL?.toLowerCase() as LogLevel;
+    return LOG_LEVELS.includes(level) ? level : 'info';
+};
+
+// Tests write synchronously so nothing outlives the suite
+const defaultDestination = (): pino.DestinationStream =>
+    process.env.NODE_ENV === 'test'
+        ? pino.destination({ dest: 1, sync: true })
+        : pino.transport({ target: 'pino/file', options: { destination: 1 } });
+
+/**
+ * Level-gated, sampled logger; children share the parent's destination
+ */
+export class AsyncLogger {
+    private readonly sampleCounts: Map<string, number>;
+
+    constructor(
+        private readonly target: pino.Logger,
+        private readonly sampling: SampleRates = {}
+    ) {
+        this.sampleCounts = new Map();
+    }
+
+    public error(event: string, fields?: LazyFields): void {
+        this.write('error', event, fields);
+    }
+
+    public warn(event: string, fields?: LazyFields): void {
+        this.write('warn', event, fields);
+    }
+
+    public info(event: string, fields?: LazyFields): void {
+        this.write('info', event, fields);
+    }
+
+    public debug(event: string, fields?: LazyFields): void {
+        this.write('debug', event, fields);
+    }
+
+    /**
+     * Whether entries at a level would be written, for callers guarding their own work
+     */
+    public isEnabled(level: LogLevel): boolean {
+        return this.target.levels.values[level] >= this.target.levelVal;
+    }
+
+    /**
+     * Logger adding bindings to every entry, with its own sampling and sample counts
+     */
+    public child(bindings: LogFields, sampling: SampleRates = this.sampling): AsyncLogger {
+        return new AsyncLogger(this.target.child(bindings), sampling);
+    }
+
+    /**
+     * Flushes entries buffered for the destination
+     */
+    public flush(): void {
+        this.target.flush();
+    }
+
+    private write(level: LogLevel, event: string, fields?: LazyFields): void {
+        if (this.target.levels.values[level] < this.target.levelVal) {
+            return;
+        }
+
+        const rate = level === 'error' ? undefined : this.sampling[event];
+        if (rate && rate > 1) {
+            const seen = this.sampleCounts.get(event) ?? 0;
+            this.sampleCounts.set(event, seen + 1);
+            if (seen % rate !== 0) {
+                return;
+            }
+        }
+
+        const entry = typeof fields === 'function' ? fields() : fields;
+        if (rate && rate > 1) {
+            this.target[level]({ ...entry, sampleRate: rate }, event);
+        } else if (entry) {
+            this.target[level](entry, event);
+        } else {
+            this.target[level](event);
+        }
+    }
+}
+
+/**
+ * Creates a root logger with the service's base fields and redaction
+ */
+export const createAsyncLogger = (options: AsyncLoggerOptions = {}): AsyncLogger =>
+    new AsyncLogger(
+        pino({
+            level: options.level ?? getLogLevel(),
+            base: { service: 'membo.ai', version: process.env.API_VERSION },
+            timestamp: pino.stdTimeFunctions.isoTime,
+            formatters: {
+                level: (label) => ({ level: label })
+            },
+            redact: ['password', 'token', 'apiKey', '*.password', '*.token', '*.apiKey']
+        }, options.destination ?? defaultDestination()),
+        options.sampling
+    );
+
+/**
+ * Process-wide logger for the websocket layer
+ */
+export const asyncLogger = createAsyncLogger();
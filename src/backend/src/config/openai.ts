@@ -1,10 +1,11 @@
 // openai version: ^4.0.0
-// limiter version: ^2.0.0
 // pino version: ^8.0.0
 
 import OpenAI from 'openai';
-import { RateLimiter } from 'limiter';
+import Redis from 'ioredis'; // version: ^5.0.0
 import pino from 'pino';
+import { ConcurrencyLimiter, ConcurrencyPermit, ConcurrencyPriority } from '../utils/concurrencyLimiter';
+import { countTokens } from '../core/ai/tokenChunker';
 
 // Global constants for OpenAI configuration
 export const DEFAULT_MODEL = 'gpt-4';
@@ -12,8 +13,9 @@ export const DEFAULT_TEMPERATURE = 0.7;
 export const DEFAULT_MAX_TOKENS = 2048;
 export const REQUEST_TIMEOUT = 30000;
 export const MAX_RETRIES = 3;
-export const RATE_LIMIT_WINDOW = 60000; // 1 minute in milliseconds
-export const RATE_LIMIT_REQUESTS = 50;
+export const MODERATION_MODEL = 'omni-moderation-latest';
+// Tokens per minute shared by all workers; 0 leaves only the adaptive concurrency limit
+export const TOKENS_PER_MINUTE = parseInt(process.env.OPENAI_TOKENS_PER_MINUTE || '0', 10);
 
 // Logger instance for monitoring and debugging
 const logger = pino({
@@ -75,31 +77,57 @@ const createOpenAIConfig = () => {
 };
 
 /**
- * Creates rate limiter instance for API request throttling
- * @returns Configured rate limiter instance
+ * Per-call admission options
  */
-const initializeRateLimiter = (): RateLimiter => {
-  return new RateLimiter({
-    tokensPerInterval: RATE_LIMIT_REQUESTS,
-    interval: RATE_LIMIT_WINDOW,
-    fireImmediately: true,
-  });
+export interface CallOptions {
+  /** Interactive calls keep a share of the concurrency pool that batch work cannot take */
+  priority?: ConcurrencyPriority;
+}
+
+/**
+ * Milliseconds the provider asked us to wait, from the retry-after headers of a 429
+ */
+const retryAfterMs = (error: any): number | undefined => {
+  const headers = error?.headers ?? {};
+  const ms = Number(headers['retry-after-ms']);
+  if (ms > 0) {
+    return ms;
+  }
+  const retryAfter = headers['retry-after'];
+  if (!retryAfter) {
+    return undefined;
+  }
+  const seconds = Number(retryAfter);
+  return Number.isNaN(seconds) ? Math.max(0, Date.parse(retryAfter) - Date.now()) : seconds * 1000;
 };
 
+/**
+ * Prompt tokens plus the completion allowance, reserved against the token budget
+ */
+const estimateTokens = (params: { messages?: Array<{ content?: unknown }>; max_tokens?: number | null }): number =>
+  (params.messages ?? []).reduce(
+    (sum, message) => sum + (typeof message.content === 'string' ? countTokens(message.content) : 0),
+    params.max_tokens || DEFAULT_MAX_TOKENS
+  );
+
 /**
  * OpenAI client wrapper with enhanced functionality
  */
 export class OpenAIClient {
   private readonly client: OpenAI;
-  private rateLimiter: RateLimiter;
   private logger: pino.Logger;
 
-  constructor(apiKey: string, organization?: string) {
+  /**
+   * @param limiter - Shared concurrency limiter; every attempt holds one of its permits
+   */
+  constructor(apiKey: string, organization?: string, baseURL?: string, private readonly limiter?: ConcurrencyLimiter) {
     this.client = new OpenAI({
       apiKey,
-      organization
+      organization,
+      baseURL,
+      // Retries happen here so each attempt goes through the limiter
+      maxRetries: 0
     });
-    this.rateLimiter = initializeRateLimiter();
     this.logger = logger.child({ service: 'OpenAIClient' });
   }
 
@@ -113,22 +141,30 @@ export class OpenAIClient {
   }
 
   /**
-   * Executes API requests with retry logic and monitoring
+   * Executes API requests with retry logic and monitoring. Each attempt holds a
+   * permit of the shared limiter; a 429 shrinks the shared limit and pauses all
+   * workers for the provider's retry-after.
    * @param operation - Async function to execute
+   * @param options - Priority and token estimate for admission
+   * @param complete - Settles the permit once the result is consumed; defaults to on return
    * @returns Promise resolving to operation result
    * @throws Error if operation fails after max retries
    */
-  async executeWithRetry<T>(operation: () => Promise<T>): Promise<T> {
+  async executeWithRetry<T>(
+    operation: () => Promise<T>,
+    options: CallOptions & { estimatedTokens?: number } = {},
+    complete: (result: T, permit: ConcurrencyPermit) => T = (result, permit) => {
+      permit.succeed((result as any)?.usage?.total_tokens);
+      return result;
+    }
+  ): Promise<T> {
     let attempts = 0;
     let lastError: Error | null = null;
 
     while (attempts < MAX_RETRIES) {
+      let permit: ConcurrencyPermit | undefined;
       try {
-        // Check rate limit before proceeding
-        const remainingRequests = await this.rateLimiter.removeTokens(1);
-        if (remainingRequests < 0) {
-          throw new Error('Rate limit exceeded');
-        }
+        permit = await this.limiter?.acquire(options.priority ?? 'batch', options.estimatedTokens);
 
         const startTime = Date.now();
         const result = await operation();
@@ -141,22 +177,27 @@ export class OpenAIClient {
           attempt: attempts + 1,
         });
 
-        return result;
+        return permit ? complete(result, permit) : result;
       } catch (error) {
         lastError = error as Error;
         attempts++;
 
+        const throttled = (error as any)?.status === 429;
+        const wait = throttled ? retryAfterMs(error) : undefined;
+        await (throttled ? permit?.throttle(wait) : permit?.release());
+
         if (attempts < MAX_RETRIES) {
-          // Exponential backoff with jitter
-          const backoff = Math.min(1000 * Math.pow(2, attempts), 10000);
+          // The provider's retry-after replaces exponential backoff; jitter either way
+          const backoff = wait ?? Math.min(1000 * Math.pow(2, attempts), 10000);
           const jitter = Math.random() * 1000;
           await new Promise(resolve => setTimeout(resolve, backoff + jitter));
         }
 
         this.logger.warn({
-          event: 'api_retry',
+          event: throttled ? 'api_throttled' : 'api_retry',
           error: lastError.message,
           attempt: attempts,
+          retryAfterMs: wait,
         });
       }
     }
@@ -175,19 +216,108 @@ export class OpenAIClient {
    * @param params - Chat completion parameters
    * @returns Promise resolving to chat completion response
    */
-  async createChatCompletion(params: Parameters<OpenAI['chat']['completions']['create']>[0]) {
+  async createChatCompletion(
+    params: Parameters<OpenAI['chat']['completions']['create']>[0],
+    options: CallOptions = {}
+  ) {
     return this.executeWithRetry(() => this.client.chat.completions.create({
       ...params,
       model: params.model || DEFAULT_MODEL,
       temperature: params.temperature || DEFAULT_TEMPERATURE,
       max_tokens: params.max_tokens || DEFAULT_MAX_TOKENS,
-    }));
+    }), { ...options, estimatedTokens: estimateTokens(params) });
+  }
+
+  /**
+   * Transcribes audio with retry and monitoring
+   * @param params - Transcription parameters
+   * @returns Promise resolving to the transcription
+   */
+  async createTranscription(
+    params: Parameters<OpenAI['audio']['transcriptions']['create']>[0],
+    options: CallOptions = {}
+  ) {
+    return this.executeWithRetry(() => this.client.audio.transcriptions.create(params), options);
+  }
+
+  /**
+   * Checks several inputs against the moderation endpoint in one request
+   * @param input - Texts to check; results are returned in the same order
+   * @returns Moderation response under `data`
+   */
+  async createModeration(input: string[], options: CallOptions = {}) {
+    const data = await this.executeWithRetry(
+      () => this.client.moderations.create({ model: MODERATION_MODEL, input }),
+      options
+    );
+    return { data };
+  }
+
+  /**
+   * Opens a streamed chat completion. Retries cover establishing the stream;
+   * a stream that fails part-way surfaces the error to the consumer. The
+   * limiter permit is held until the stream is consumed.
+   * @param params - Chat completion parameters
+   * @param timeout - Time allowed for the whole stream in milliseconds
+   * @returns Async iterable of completion chunks
+   */
+  async createChatCompletionStream(
+    params: Omit<OpenAI.Chat.ChatCompletionCreateParamsStreaming, 'stream'>,
+    timeout: number = REQUEST_TIMEOUT,
+    options: CallOptions = {}
+  ): Promise<AsyncIterable<OpenAI.Chat.ChatCompletionChunk>> {
+    return this.executeWithRetry<AsyncIterable<OpenAI.Chat.ChatCompletionChunk>>(
+      () => this.client.chat.completions.create({
+        ...params,
+        model: params.model || DEFAULT_MODEL,
+        temperature: params.temperature || DEFAULT_TEMPERATURE,
+        max_tokens: params.max_tokens || DEFAULT_MAX_TOKENS,
+        stream: true,
+        stream_options: { include_usage: true },
+      }, { timeout }),
+      { ...options, estimatedTokens: estimateTokens(params) },
+      (stream, permit) => this.holdPermit(stream, permit)
+    );
+  }
+
+  /**
+   * Passes stream chunks through and settles the permit when the stream ends
+   */
+  private async *holdPermit(
+    stream: AsyncIterable<OpenAI.Chat.ChatCompletionChunk>,
+    permit: ConcurrencyPermit
+  ): AsyncGenerator<OpenAI.Chat.ChatCompletionChunk> {
+    let usedTokens: number | undefined;
+    try {
+      for await (const chunk of stream) {
+        usedTokens = chunk.usage?.total_tokens ?? usedTokens;
+        yield chunk;
+      }
+      await permit.succeed(usedTokens);
+    } finally {
+      // Failed or abandoned part-way
+      await permit.release();
+    }
   }
 }
 
-// Create and export configured OpenAI client instance
+// Create and export configured OpenAI client instance, limited across all workers
 const config = createOpenAIConfig();
-export const openai = new OpenAIClient(config.apiKey, config.organization);
+export const openai = new OpenAIClient(
+  config.apiKey,
+  config.organization,
+  undefined,
+  // Commands fail at once while Redis is down instead of queueing, so calls go through
+  // unlimited; the first call only starts the lazy connection and is not limited either
+  new ConcurrencyLimiter(new Redis(process.env.REDIS_URL, {
+    lazyConnect: true,
+    enableOfflineQueue: false,
+    maxRetriesPerRequest: 1,
+  }), {
+    name: 'openai',
+    tokensPerMinute: TOKENS_PER_MINUTE,
+  })
+);
 
 // Export the type of our configured client
 export type ConfiguredOpenAI = OpenAI;
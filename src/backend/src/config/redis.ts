@@ -8,6 +8,7 @@ const REDIS_CONFIG = {
     retryStrategy: (times: number) => Math.min(times * 50, 2000),
     maxRetriesPerRequest: 3,
     enableReadyCheck: true,
+    enableAutoPipelining: true,
     showFriendlyErrorStack: process.env.NODE_ENV !== 'production',
   },
   monitoring: {
@@ -65,6 +66,8 @@ export class RedisManager {
       retryStrategy: REDIS_CONFIG.defaults.retryStrategy,
       maxRetriesPerRequest: REDIS_CONFIG.defaults.maxRetriesPerRequest,
       enableReadyCheck: REDIS_CONFIG.defaults.enableReadyCheck,
+      // Commands issued in the same tick share one write and one round trip
+      enableAutoPipelining: REDIS_CONFIG.defaults.enableAutoPipelining,
       showFriendlyErrorStack: process.env.NODE_ENV !== 'production'
     });
 
@@ -4,6 +4,9 @@ import { TokenService } from '../services/TokenService';
 import { AuthService } from '../services/AuthService';
 import { RateLimiterService } from '../services/RateLimiterService';
 import { SupabaseService } from '../services/SupabaseService';
+import { QueryRouter } from '../services/QueryRouter';
+import { TokenStore } from '../utils/tokenStore';
+import { redisClient } from './redis';
 
 export interface ServiceContainer {
   authService: AuthService;
@@ -11,6 +14,7 @@ export interface ServiceContainer {
   rateLimiterService: RateLimiterService;
   redisService: IRedisService;
   supabaseService: SupabaseService;
+  queryRouter: QueryRouter;
 }
 
 let services: ServiceContainer | null = null;
@@ -22,16 +26,18 @@ export function getServices(): ServiceContainer {
     const supabaseService = SupabaseService.getInstance();
     
     // Initialize dependent services
-    const tokenService = new TokenService(redisService);
+    const tokenService = new TokenService(new TokenStore(redisClient));
     const rateLimiterService = new RateLimiterService(redisService);
     const authService = new AuthService(supabaseService.client, tokenService, redisService);
+    const queryRouter = QueryRouter.fromEnv(supabaseService.client, redisClient);
 
     services = {
       authService,
       tokenService,
       rateLimiterService,
       redisService,
-      supabaseService
+      supabaseService,
+      queryRouter
     };
   }
 
@@ -40,5 +46,6 @@ export function getServices(): ServiceContainer {
 
 // For testing purposes
 export function resetServices(): void {
+  services?.queryRouter.stop();
   services = null;
 }
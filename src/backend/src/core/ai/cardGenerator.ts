@@ -7,6 +7,10 @@ import { IContent, ContentStatus } from '../../interfaces/IContent';
 import { StudyModes } from '../../constants/studyModes';
 import { openai, DEFAULT_MODEL, REQUEST_TIMEOUT } from '../../config/openai';
 import { validateSchema } from '../../utils/validation';
+import { countTokens } from './tokenChunker';
+import { StreamingJsonArrayParser } from './streamingJsonParser';
+import { SingleFlight } from '../../utils/singleFlight';
+import { ContentModerator, ModerationStats } from './contentModerator';
 import { injectable } from 'tsyringe';
 import { open } from 'fs';
 
@@ -19,7 +23,7 @@ const CARD_GENERATION_PROMPT = `Generate comprehensive flashcards from the follo
 
 Content to process:`;
 
-const MAX_CONTENT_LENGTH = 4000;
+const MAX_CONTENT_TOKENS = 1500;
 const MIN_CONTENT_LENGTH = 10;
 const API_TIMEOUT = 15000;
 const MAX_RETRIES = 3;
@@ -44,8 +48,17 @@ interface GenerationOptions {
   language?: string;
 }
 
+interface GenerateOptions {
+  /** Set when the caller already ran moderateContent on this text */
+  moderated?: boolean;
+  /** Called with each card as soon as it is generated and validated; enables streaming */
+  onCard?: (card: ICard) => void;
+}
+
 interface GenerationMetrics {
   processingTime: number;
+  /** Time from request to the first validated card, when streaming */
+  firstCardTime?: number;
   tokenCount: number;
   cardCount: number;
   cacheHit: boolean;
@@ -54,12 +67,15 @@ interface GenerationMetrics {
 @injectable()
 class CardGenerator {
   private metrics: GenerationMetrics;
+  private readonly moderator: ContentModerator;
 
   constructor(
     private openaiClient: OpenAIClient,
     private cacheClient: Redis,
-    private options: GenerationOptions = {}
+    private options: GenerationOptions = {},
+    private singleFlight?: SingleFlight
   ) {
+    this.moderator = new ContentModerator(openaiClient);
     this.metrics = {
       processingTime: 0,
       tokenCount: 0,
@@ -71,40 +87,40 @@ class CardGenerator {
   /**
    * Generates flashcards from provided content using AI processing
    */
-  public async generateFromContent(content: IContent): Promise<ICard[]> {
+  public async generateFromContent(content: IContent, options: GenerateOptions = {}): Promise<ICard[]> {
     try {
       // Check cache first
-      const cacheKey = `cards:${content.id}`;
-      const cachedCards = await this.cacheClient.get(cacheKey);
-      
+      // Chunked content caches per chunk
+      const chunkIndex = content.metadata?.chunkIndex;
+      const cacheKey = chunkIndex === undefined ? `cards:${content.id}` : `cards:${content.id}:${chunkIndex}`;
+      const readCache = async (): Promise<ICard[] | null> => {
+        const cachedCards = await this.cacheClient.get(cacheKey);
+        return cachedCards ? JSON.parse(cachedCards) : null;
+      };
+
+      const cachedCards = await readCache();
       if (cachedCards) {
         this.metrics.cacheHit = true;
-        return JSON.parse(cachedCards);
+        cachedCards.forEach((card) => options.onCard?.(card));
+        return cachedCards;
       }
 
-      // Validate content
-      this.validateContent(content);
-
-      // Check content moderation
-      await this.moderateContent(content.content);
-
-      // Generate cards
-      const startTime = Date.now();
-      const cards = await this.processContentWithAI(content);
-      this.metrics.processingTime = Date.now() - startTime;
+      // Identical requests on other workers wait for this generation instead of repeating it
+      let generated = false;
+      const generate = async () => {
+        generated = true;
+        return this.generateAndCache(content, cacheKey, options);
+      };
+      const cards = this.singleFlight
+        ? await this.singleFlight.do(cacheKey, readCache, generate)
+        : await generate();
 
-      // Validate generated cards
-      if (!this.validateGeneratedCards(cards)) {
-        throw new Error('Generated cards failed validation');
+      if (!generated) {
+        // Streaming followers receive the leader's cards once they are complete
+        this.metrics.cacheHit = true;
+        cards.forEach((card) => options.onCard?.(card));
       }
 
-      // Cache successful generation
-      await this.cacheClient.setex(
-        cacheKey,
-        CACHE_TTL,
-        JSON.stringify(cards)
-      );
-
       // Update metrics
       this.metrics.cardCount = cards.length;
       
@@ -119,13 +135,47 @@ class CardGenerator {
     }
   }
 
+  /**
+   * Moderates, generates, validates and caches cards for content not in the cache
+   */
+  private async generateAndCache(content: IContent, cacheKey: string, options: GenerateOptions): Promise<ICard[]> {
+    // Validate content
+    this.validateContent(content);
+
+    // Check content moderation
+    if (!options.moderated) {
+      await this.moderateContent(content.content);
+    }
+
+    // Generate cards
+    const startTime = Date.now();
+    const cards = options.onCard
+      ? await this.streamContentWithAI(content, options.onCard)
+      : await this.processContentWithAI(content);
+    this.metrics.processingTime = Date.now() - startTime;
+
+    // Validate generated cards
+    if (!this.validateGeneratedCards(cards)) {
+      throw new Error('Generated cards failed validation');
+    }
+
+    // Cache successful generation
+    await this.cacheClient.setex(
+      cacheKey,
+      CACHE_TTL,
+      JSON.stringify(cards)
+    );
+
+    return cards;
+  }
+
   /**
    * Validates input content before processing
    */
   private validateContent(content: IContent): void {
     if (!content.content || 
         content.content.length < MIN_CONTENT_LENGTH || 
-        content.content.length > MAX_CONTENT_LENGTH) {
+        countTokens(content.content) > MAX_CONTENT_TOKENS) {
       throw new Error('Content length out of acceptable range');
     }
 
@@ -144,29 +194,18 @@ class CardGenerator {
   }
 
   /**
-   * Checks content against OpenAI's moderation endpoint
+   * Checks content locally and, unless clearly safe, against OpenAI's moderation
+   * endpoint in a batch with other pending checks
    */
-  private async moderateContent(text: string): Promise<void> {
-    const moderation = await this.openaiClient.createChatCompletion({
-      model: DEFAULT_MODEL,
-      messages: [
-        {
-          role: 'system',
-          content: CARD_GENERATION_PROMPT,
-        },
-        {
-          role: 'user',
-          content: text,
-        },
-      ],
-      temperature: 0.7,
-      max_tokens: 2048,
-      timeout: API_TIMEOUT,
-    });
-
-    if (moderation.data.results[0].flagged) {
-      throw new Error('Content flagged by moderation check');
-    }
+  public async moderateContent(text: string): Promise<void> {
+    await this.moderator.moderate(text);
+  }
+
+  /**
+   * Returns prefilter and batched moderation counts
+   */
+  public getModerationStats(): ModerationStats {
+    return this.moderator.getStats();
   }
 
   /**
@@ -208,48 +247,112 @@ class CardGenerator {
     throw new Error('Failed to process content after max retries');
   }
 
+  /**
+   * Streams a completion and parses the card array incrementally, handing each
+   * card to `onCard` once its object closes and it passes validation. Retries
+   * only until the first card is delivered, so consumers never see duplicates.
+   */
+  private async streamContentWithAI(content: IContent, onCard: (card: ICard) => void): Promise<ICard[]> {
+    const startTime = Date.now();
+    let attempt = 0;
+
+    while (true) {
+      const cards: ICard[] = [];
+      const parser = new StreamingJsonArrayParser<any>();
+      try {
+        const stream = await this.openaiClient.createChatCompletionStream({
+          model: DEFAULT_MODEL,
+          messages: [
+            {
+              role: 'system',
+              content: CARD_GENERATION_PROMPT,
+            },
+            {
+              role: 'user',
+              content: content.content,
+            },
+          ],
+          temperature: 0.7,
+          max_tokens: 2048,
+        }, API_TIMEOUT);
+
+        for await (const chunk of stream) {
+          if (chunk.usage) {
+            this.metrics.tokenCount = chunk.usage.total_tokens;
+          }
+          const delta = chunk.choices[0]?.delta?.content;
+          if (!delta) {
+            continue;
+          }
+          for (const item of parser.push(delta)) {
+            const card = typeof item?.front === 'string' && typeof item?.back === 'string'
+              ? this.toCard(item, content)
+              : null;
+            if (!card || !this.isValidCard(card)) {
+              logger.warn('Skipping invalid streamed card', { contentId: content.id });
+              continue;
+            }
+            if (cards.length === 0) {
+              this.metrics.firstCardTime = Date.now() - startTime;
+            }
+            cards.push(card);
+            onCard(card);
+          }
+        }
+
+        if (!parser.isComplete) {
+          throw new Error('Card stream ended before the response was complete');
+        }
+        return cards;
+      } catch (error) {
+        attempt++;
+        if (cards.length > 0 || attempt === MAX_RETRIES) throw error;
+        await new Promise(resolve => setTimeout(resolve, 1000 * attempt));
+      }
+    }
+  }
+
   /**
    * Parses AI response into structured card format
    */
   private parseAIResponse(response: string, content: IContent): ICard[] {
-    const cards: ICard[] = [];
     const parsedResponse = JSON.parse(response);
+    return parsedResponse.map((item: any) => this.toCard(item, content));
+  }
 
-    for (const item of parsedResponse) {
-      const card: ICard = {
-        id: crypto.randomUUID(),
-        userId: content.userId,
-        contentId: content.id,
-        frontContent: {
-          text: item.front,
-          type: ContentType.TEXT,
-          metadata: {
-            sourceUrl: content.sourceUrl,
-            aiGenerated: true,
-            generationPrompt: CARD_GENERATION_PROMPT,
-            lastModifiedBy: 'system',
-          },
+  /**
+   * Builds a card from one generated front/back item
+   */
+  private toCard(item: any, content: IContent): ICard {
+    return {
+      id: crypto.randomUUID(),
+      userId: content.userId,
+      contentId: content.id,
+      frontContent: {
+        text: item.front,
+        type: ContentType.TEXT,
+        metadata: {
+          sourceUrl: content.sourceUrl,
+          aiGenerated: true,
+          generationPrompt: CARD_GENERATION_PROMPT,
+          lastModifiedBy: 'system',
         },
-        backContent: {
-          text: item.back,
-          type: ContentType.TEXT,
-          metadata: {
-            sourceUrl: content.sourceUrl,
-            aiGenerated: true,
-            generationPrompt: CARD_GENERATION_PROMPT,
-            lastModifiedBy: 'system',
-          },
+      },
+      backContent: {
+        text: item.back,
+        type: ContentType.TEXT,
+        metadata: {
+          sourceUrl: content.sourceUrl,
+          aiGenerated: true,
+          generationPrompt: CARD_GENERATION_PROMPT,
+          lastModifiedBy: 'system',
         },
-        compatibleModes: this.determineCompatibleModes(item),
-        tags: content.metadata.tags || [],
-        createdAt: new Date(),
-        updatedAt: new Date(),
-      };
-
-      cards.push(card);
-    }
-
-    return cards;
+      },
+      compatibleModes: this.determineCompatibleModes(item),
+      tags: content.metadata.tags || [],
+      createdAt: new Date(),
+      updatedAt: new Date(),
+    };
   }
 
   /**
@@ -302,14 +405,19 @@ class CardGenerator {
       return false;
     }
 
-    return cards.every(card => {
-      return (
-        card.frontContent?.text?.length > 0 &&
-        card.backContent?.text?.length > 0 &&
-        card.compatibleModes?.length > 0 &&
-        Array.isArray(card.tags)
-      );
-    });
+    return cards.every(card => this.isValidCard(card));
+  }
+
+  /**
+   * Validates a single generated card
+   */
+  private isValidCard(card: ICard): boolean {
+    return (
+      card.frontContent?.text?.length > 0 &&
+      card.backContent?.text?.length > 0 &&
+      card.compatibleModes?.length > 0 &&
+      Array.isArray(card.tags)
+    );
   }
 
   /**
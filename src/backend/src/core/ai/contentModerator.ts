@@ -0,0 +1,110 @@
+/**
+ * @fileoverview Two-stage content moderation for card generation.
+ * The local prefilter clears content with no sign of sensitive material; the rest is
+ * queued and sent to the moderation endpoint in batches, many chunks per request.
+ * @version 1.0.0
+ */
+
+import { OpenAIClient } from '../../config/openai';
+import { ModerationPrefilter } from './moderationPrefilter';
+
+const DEFAULT_MAX_BATCH_SIZE = 16;
+const DEFAULT_MAX_WAIT_MS = 10;
+
+export interface ContentModeratorOptions {
+  /** Set to null to send all content to the endpoint */
+  prefilter?: ModerationPrefilter | null;
+  /** Inputs per moderation request */
+  maxBatchSize?: number;
+  /** Longest a queued input waits for its batch to fill */
+  maxWaitMs?: number;
+}
+
+export interface ModerationStats {
+  /** Checks cleared by the prefilter without an endpoint call */
+  cleared: number;
+  /** Checks sent to the endpoint */
+  reviewed: number;
+  /** Moderation requests made */
+  requests: number;
+  flagged: number;
+}
+
+interface QueuedCheck {
+  text: string;
+  resolve: (flagged: boolean) => void;
+  reject: (error: Error) => void;
+}
+
+/**
+ * Moderates content, rejecting flagged text with 'Content flagged by moderation check'
+ */
+export class ContentModerator {
+  private readonly prefilter: ModerationPrefilter | null;
+  private readonly maxBatchSize: number;
+  private readonly maxWaitMs: number;
+  private queue: QueuedCheck[] = [];
+  private timer: NodeJS.Timeout | null = null;
+  private readonly stats: ModerationStats = { cleared: 0, reviewed: 0, requests: 0, flagged: 0 };
+
+  constructor(private readonly openaiClient: OpenAIClient, options: ContentModeratorOptions = {}) {
+    this.prefilter = options.prefilter === undefined ? new ModerationPrefilter() : options.prefilter;
+    this.maxBatchSize = options.maxBatchSize ?? DEFAULT_MAX_BATCH_SIZE;
+    this.maxWaitMs = options.maxWaitMs ?? DEFAULT_MAX_WAIT_MS;
+  }
+
+  /**
+   * Resolves when the text passes moderation
+   * @throws Error if the moderation endpoint flags the text
+   */
+  public async moderate(text: string): Promise<void> {
+    if (this.prefilter?.classify(text).verdict === 'clear') {
+      this.stats.cleared++;
+      return;
+    }
+
+    this.stats.reviewed++;
+    const flagged = await new Promise<boolean>((resolve, reject) => {
+      this.queue.push({ text, resolve, reject });
+      if (this.queue.length >= this.maxBatchSize) {
+        this.flush();
+      } else if (!this.timer) {
+        this.timer = setTimeout(() => this.flush(), this.maxWaitMs);
+      }
+    });
+
+    if (flagged) {
+      this.stats.flagged++;
+      throw new Error('Content flagged by moderation check');
+    }
+  }
+
+  public getStats(): ModerationStats {
+    return { ...this.stats };
+  }
+
+  private flush(): void {
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    const batch = this.queue.splice(0, this.maxBatchSize);
+    if (this.queue.length > 0) {
+      this.timer = setTimeout(() => this.flush(), this.maxWaitMs);
+    }
+    if (batch.length === 0) {
+      return;
+    }
+
+    this.stats.requests++;
+    this.openaiClient.createModeration(batch.map((check) => check.text))
+      .then((moderation) => {
+        const { results } = moderation.data;
+        if (results.length !== batch.length) {
+          throw new Error(`Moderation returned ${results.length} results for ${batch.length} inputs`);
+        }
+        batch.forEach((check, i) => check.resolve(results[i].flagged));
+      })
+      .catch((error: Error) => batch.forEach((check) => check.reject(error)));
+  }
+}
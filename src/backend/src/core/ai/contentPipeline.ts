@@ -0,0 +1,182 @@
+/**
+ * @fileoverview Staged content-processing pipeline.
+ * Runs prepare → analyze → moderate → generate → persist with a bounded worker pool
+ * per stage, so chunks of one document are moderated and turned into cards in
+ * parallel while a full stage slows intake instead of piling up requests.
+ * @version 1.0.0
+ */
+
+import { ICard } from '../../interfaces/ICard';
+import { IContent, ContentStatus } from '../../interfaces/IContent';
+import { ContentProcessor, PreparedContent } from './contentProcessor';
+import { SharedArtifact, SharedArtifactCache } from './sharedArtifactCache';
+import { TokenChunk } from './tokenChunker';
+import { PipelineStage, StagedPipeline, StageStats } from '../pipeline/stagedPipeline';
+import { performanceMonitor } from '../monitoring/PerformanceMonitor';
+
+export type ContentStageName = 'prepare' | 'analyze' | 'moderate' | 'generate' | 'persist';
+
+// Workers per stage. Prepare is CPU-bound tokenization; the OpenAI stages are
+// sized to stay under the account's request rate; persist bounds database writes.
+// Moderation mostly clears locally and batches the rest, so it runs one batch wide.
+const DEFAULT_STAGE_CONCURRENCY: Record<ContentStageName, number> = {
+  prepare: 2,
+  analyze: 4,
+  moderate: 16,
+  generate: 6,
+  persist: 4,
+};
+
+const PIPELINE_NAME = 'content';
+
+export interface ContentPipelineOptions {
+  concurrency?: Partial<Record<ContentStageName, number>>;
+  /** Receives each card as it is generated, before it is persisted */
+  onCard?: (chunk: IContent, card: ICard) => void;
+  /** Reuses analysis and cards already generated for the same public article */
+  artifactCache?: SharedArtifactCache;
+}
+
+interface DerivedResults {
+  analysis: Record<string, unknown>;
+  chunks: TokenChunk[];
+}
+
+/**
+ * Content processing pipeline shared by all requests of a process
+ */
+export class ContentPipeline {
+  private readonly pipeline: StagedPipeline<IContent, ICard[]>;
+  // Analysis and chunking of in-flight content, kept to build its shared artifact
+  private readonly derived = new WeakMap<IContent, DerivedResults>();
+
+  constructor(
+    private readonly processor: ContentProcessor,
+    private readonly persistCards: (cards: ICard[]) => Promise<ICard[]>,
+    private readonly options: ContentPipelineOptions = {}
+  ) {
+    const concurrency = { ...DEFAULT_STAGE_CONCURRENCY, ...options.concurrency };
+    const stages: PipelineStage[] = [
+      {
+        name: 'prepare',
+        concurrency: concurrency.prepare,
+        run: async (content: IContent) => this.processor.prepareContent(content),
+      },
+      {
+        name: 'analyze',
+        concurrency: concurrency.analyze,
+        fanOut: true,
+        run: async (prepared: PreparedContent) => {
+          const analysis = await this.processor.analyzePrepared(prepared);
+          this.derived.set(prepared.content, { analysis, chunks: prepared.chunks });
+          return this.processor.toChunkContents(prepared, analysis);
+        },
+      },
+      {
+        name: 'moderate',
+        concurrency: concurrency.moderate,
+        run: (chunk: IContent) => this.processor.moderateChunk(chunk),
+      },
+      {
+        name: 'generate',
+        concurrency: concurrency.generate,
+        run: (chunk: IContent) => this.processor.generateChunkCards(
+          chunk,
+          options.onCard && ((card: ICard) => options.onCard!(chunk, card))
+        ),
+      },
+      {
+        name: 'persist',
+        concurrency: concurrency.persist,
+        run: (cards: ICard[]) => this.persistCards(cards),
+      },
+    ];
+
+    this.pipeline = new StagedPipeline<IContent, ICard[]>(stages, {
+      stageCompleted: (stage, durationMs, failed) =>
+        performanceMonitor.recordPipelineStage(PIPELINE_NAME, stage, durationMs / 1000, failed),
+      queueDepth: (stage, waiting, active) =>
+        performanceMonitor.trackPipelineQueue(PIPELINE_NAME, stage, waiting, active),
+    });
+  }
+
+  /**
+   * Processes one content item through every stage
+   * @returns Content marked processed, and the persisted cards in chunk order
+   */
+  public async process(content: IContent): Promise<{ content: IContent; cards: ICard[] }> {
+    const { artifactCache } = this.options;
+    const artifactKey = artifactCache ? artifactCache.keyFor(content) : null;
+    const artifact = artifactCache ? await artifactCache.get(artifactKey) : null;
+    if (artifact) {
+      return this.processFromArtifact(content, artifact);
+    }
+
+    let cardsByChunk: ICard[][];
+    try {
+      cardsByChunk = await this.pipeline.process(content);
+    } catch (error) {
+      this.processor.failProcessing(content, error);
+      throw error;
+    }
+
+    // Outside the try: the cards are persisted, so sharing them must not fail or retry processing
+    if (artifactKey) {
+      await this.storeArtifact(artifactKey, content, cardsByChunk);
+    }
+    return {
+      content: this.processor.completeProcessing(content),
+      cards: cardsByChunk.flat(),
+    };
+  }
+
+  /**
+   * Materializes another user's generation of the same article as this user's cards
+   */
+  private async processFromArtifact(content: IContent, artifact: SharedArtifact): Promise<{ content: IContent; cards: ICard[] }> {
+    content.metadata = { ...content.metadata, ...artifact.analysis, sharedArtifact: true };
+    const chunkCount = artifact.chunks.length;
+
+    const generated = artifact.chunks.flatMap((chunk, index) => {
+      const chunkContent = chunkCount > 1
+        ? { ...content, metadata: { ...content.metadata, chunkIndex: index, chunkCount, section: chunk.heading } }
+        : content;
+      const cards = SharedArtifactCache.materialize(chunk.cards, chunkContent);
+      cards.forEach((card) => this.options.onCard?.(chunkContent, card));
+      return cards;
+    });
+    const cards = await this.persistCards(generated);
+
+    content.status = ContentStatus.PROCESSED;
+    content.processedAt = new Date();
+    return { content, cards };
+  }
+
+  /**
+   * Shares the analysis, chunking and card templates of a completed generation
+   */
+  private async storeArtifact(key: string, content: IContent, cardsByChunk: ICard[][]): Promise<void> {
+    const derived = this.derived.get(content);
+    this.derived.delete(content);
+    if (!derived) {
+      return;
+    }
+
+    await this.options.artifactCache!.put(key, {
+      analysis: derived.analysis,
+      // Unprocessable content has no chunk results; sharing that verdict still saves the analysis
+      chunks: cardsByChunk.length === 0 ? [] : derived.chunks.map((chunk, index) => ({
+        start: chunk.start,
+        end: chunk.end,
+        tokenCount: chunk.tokenCount,
+        heading: chunk.heading,
+        cards: SharedArtifactCache.toTemplates(cardsByChunk[index] || []),
+      })),
+      createdAt: new Date().toISOString(),
+    });
+  }
+
+  public getStats(): Record<string, StageStats> {
+    return this.pipeline.getStats();
+  }
+}
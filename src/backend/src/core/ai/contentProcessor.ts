@@ -3,6 +3,8 @@ import pino from 'pino'; // version: ^8.0.0
 import { IContent, ContentStatus } from '../../interfaces/IContent';
 import { CardGenerator } from './cardGenerator';
 import { sanitizeInput, validateSchema } from '../../utils/validation';
+import { chunkByTokens, TokenChunk } from './tokenChunker';
+import { ICard } from '../../interfaces/ICard';
 
 // Global constants for content processing
 const CONTENT_ANALYSIS_PROMPT = `Analyze the following content and provide:
@@ -15,6 +17,14 @@ const CONTENT_ANALYSIS_PROMPT = `Analyze the following content and provide:
 Content to analyze:`;
 
 const MAX_CHUNK_SIZE = 4000;
+// Card generation prompt, chunk and 2048-token completion fit the 8k gpt-4 window
+const DEFAULT_CHUNK_TOKENS = 1000;
+const DEFAULT_CHUNK_OVERLAP_TOKENS = 100;
+const MAX_CHUNK_TOKENS = 1500;
+// Analysis sees the opening of long documents rather than all of it
+const ANALYSIS_SAMPLE_TOKENS = 3000;
+// Long documents are chunked, so only bound what one request body may carry
+const MAX_CONTENT_LENGTH = 1000000;
 const MIN_CONTENT_LENGTH = 10;
 const MAX_RETRIES = 3;
 const RETRY_DELAY = 1000;
@@ -35,12 +45,21 @@ interface ProcessingMetrics {
   endTime: number;
   processingDuration: number;
   tokenCount: number;
+  inputTokenCount: number;
   chunkCount: number;
   retryCount: number;
 }
 
+interface PreparedContent {
+  content: IContent;
+  sanitized: string;
+  chunks: TokenChunk[];
+}
+
 interface ProcessingOptions {
   maxChunkSize?: number;
+  chunkTokens?: number;
+  chunkOverlapTokens?: number;
   preserveFormatting?: boolean;
   enableCache?: boolean;
   securityScan?: boolean;
@@ -67,63 +86,146 @@ class ContentProcessor {
    */
   public async processContent(content: IContent): Promise<IContent> {
     try {
-      this.metrics.startTime = Date.now();
-      logger.info({ event: 'content_processing_start', contentId: content.id });
+      const prepared = this.prepareContent(content);
+      const analysisResult = await this.analyzePrepared(prepared);
 
-      // Validate input content
-      this.validateContent(content);
-
-      // Update content status
-      content.status = ContentStatus.PROCESSING;
+      // Generate cards per chunk if analysis is successful
+      for (const chunk of this.toChunkContents(prepared, analysisResult)) {
+        await this.moderateChunk(chunk);
+        await this.generateChunkCards(chunk);
+      }
 
-      // Sanitize content
-      const sanitizedContent = this.sanitizeContent(content.content);
+      return this.completeProcessing(content);
+    } catch (error) {
+      this.failProcessing(content, error);
+      throw error;
+    }
+  }
 
-      // Analyze content
-      const analysisResult = await this.analyzeContent(sanitizedContent);
+  /**
+   * Validates, sanitizes and chunks content. First stage of processing,
+   * local and CPU-bound.
+   */
+  public prepareContent(content: IContent): PreparedContent {
+    this.metrics.startTime = Date.now();
+    logger.info({ event: 'content_processing_start', contentId: content.id });
+
+    // Validate input content
+    this.validateContent(content);
+
+    // Update content status
+    content.status = ContentStatus.PROCESSING;
+
+    // Sanitize content
+    const sanitized = this.sanitizeContent(content.content);
+
+    // Tokenize locally so request sizes are known before any API call
+    const chunks = this.chunkContent(sanitized);
+    logger.info({
+      event: 'content_tokenized',
+      contentId: content.id,
+      inputTokens: this.metrics.inputTokenCount,
+      chunkCount: chunks.length,
+    });
 
-      // Update content metadata with analysis results
-      content.metadata = {
-        ...content.metadata,
-        ...analysisResult,
-        processingMetrics: this.getMetrics(),
-      };
+    return { content, sanitized, chunks };
+  }
 
-      // Generate cards if analysis is successful
-      if (analysisResult.isProcessable) {
-        await this.cardGenerator.generateFromContent(content);
+  /**
+   * Analyzes the leading chunks of prepared content and records the result in
+   * the content metadata
+   */
+  public async analyzePrepared(prepared: PreparedContent): Promise<any> {
+    const sample: string[] = [];
+    let sampleTokens = 0;
+    for (const chunk of prepared.chunks) {
+      if (sample.length > 0 && sampleTokens + chunk.tokenCount > ANALYSIS_SAMPLE_TOKENS) {
+        break;
       }
+      sample.push(chunk.text);
+      sampleTokens += chunk.tokenCount;
+    }
 
-      // Update final status
-      content.status = ContentStatus.PROCESSED;
-      content.processedAt = new Date();
+    const analysisResult = await this.analyzeContent(sample.join('\n\n'));
 
-      this.metrics.endTime = Date.now();
-      this.metrics.processingDuration = this.metrics.endTime - this.metrics.startTime;
+    // Update content metadata with analysis results
+    prepared.content.metadata = {
+      ...prepared.content.metadata,
+      ...analysisResult,
+      processingMetrics: this.getMetrics(),
+    };
+    return analysisResult;
+  }
 
-      logger.info({
-        event: 'content_processing_complete',
-        contentId: content.id,
-        metrics: this.getMetrics(),
-      });
+  /**
+   * Splits prepared content into one content item per chunk for card
+   * generation, or none when analysis found it unprocessable
+   */
+  public toChunkContents(prepared: PreparedContent, analysisResult: any): IContent[] {
+    if (!analysisResult.isProcessable) {
+      return [];
+    }
+    const { content, chunks } = prepared;
+    return chunks.map((chunk, index) => ({
+      ...content,
+      content: chunk.text,
+      metadata: chunks.length > 1
+        ? { ...content.metadata, chunkIndex: index, chunkCount: chunks.length, section: chunk.heading }
+        : content.metadata,
+    }));
+  }
 
-      return content;
-    } catch (error) {
-      content.status = ContentStatus.ERROR;
-      content.metadata.error = {
-        message: error.message,
-        timestamp: new Date(),
-      };
+  /**
+   * Runs the moderation check for one chunk
+   */
+  public async moderateChunk(chunk: IContent): Promise<IContent> {
+    await this.cardGenerator.moderateContent(chunk.content);
+    return chunk;
+  }
 
-      logger.error({
-        event: 'content_processing_error',
-        contentId: content.id,
-        error: error.message,
-        metrics: this.getMetrics(),
-      });
+  /**
+   * Generates cards for one moderated chunk
+   * @param onCard Receives each card as soon as it is generated
+   */
+  public async generateChunkCards(chunk: IContent, onCard?: (card: ICard) => void): Promise<ICard[]> {
+    return this.cardGenerator.generateFromContent(chunk, { moderated: true, onCard });
+  }
 
-      throw error;
-    }
+  /**
+   * Marks content processed and records final metrics
+   */
+  public completeProcessing(content: IContent): IContent {
+    content.status = ContentStatus.PROCESSED;
+    content.processedAt = new Date();
+
+    this.metrics.endTime = Date.now();
+    this.metrics.processingDuration = this.metrics.endTime - this.metrics.startTime;
+
+    logger.info({
+      event: 'content_processing_complete',
+      contentId: content.id,
+      metrics: this.getMetrics(),
+    });
+
+    return content;
+  }
+
+  /**
+   * Marks content as failed with the error recorded in its metadata
+   */
+  public failProcessing(content: IContent, error: Error): void {
+    content.status = ContentStatus.ERROR;
+    content.metadata.error = {
+      message: error.message,
+      timestamp: new Date(),
+    };
+
+    logger.error({
+      event: 'content_processing_error',
+      contentId: content.id,
+      error: error.message,
+      metrics: this.getMetrics(),
+    });
   }
 
   /**
@@ -178,31 +280,19 @@ class ContentProcessor {
   }
 
   /**
-   * Chunk content for optimal processing
+   * Chunk content to a token budget on paragraph, heading and sentence boundaries
    */
-  private chunkContent(content: string): string[] {
-    const chunks: string[] = [];
-    const maxSize = this.options.maxChunkSize || MAX_CHUNK_SIZE;
-    
-    let currentChunk = '';
-    const sentences = content.split(/[.!?]+/);
-
-    for (const sentence of sentences) {
-      if ((currentChunk + sentence).length <= maxSize) {
-        currentChunk += sentence + '. ';
-      } else {
-        if (currentChunk) {
-          chunks.push(currentChunk.trim());
-        }
-        currentChunk = sentence + '. ';
-      }
-    }
-
-    if (currentChunk) {
-      chunks.push(currentChunk.trim());
-    }
+  private chunkContent(content: string): TokenChunk[] {
+    const chunks = chunkByTokens(content, {
+      targetTokens: this.options.chunkTokens || DEFAULT_CHUNK_TOKENS,
+      overlapTokens: this.options.chunkOverlapTokens ?? DEFAULT_CHUNK_OVERLAP_TOKENS,
+    });
 
     this.metrics.chunkCount = chunks.length;
+    this.metrics.inputTokenCount = chunks.reduce(
+      (sum, chunk) => sum + chunk.tokenCount - chunk.overlapTokens,
+      0
+    );
     return chunks;
   }
 
@@ -212,7 +302,7 @@ class ContentProcessor {
   private validateContent(content: IContent): void {
     if (!content.content || 
         content.content.length < MIN_CONTENT_LENGTH || 
-        content.content.length > MAX_CHUNK_SIZE * 3) {
+        content.content.length > MAX_CONTENT_LENGTH) {
       throw new Error('Content length out of acceptable range');
     }
 
@@ -263,6 +353,7 @@ class ContentProcessor {
       endTime: 0,
       processingDuration: 0,
       tokenCount: 0,
+      inputTokenCount: 0,
       chunkCount: 0,
       retryCount: 0,
     };
@@ -279,6 +370,10 @@ class ContentProcessor {
     if (this.options.maxChunkSize && this.options.maxChunkSize > MAX_CHUNK_SIZE) {
       throw new Error(`Maximum chunk size cannot exceed ${MAX_CHUNK_SIZE}`);
     }
+
+    if (this.options.chunkTokens && this.options.chunkTokens > MAX_CHUNK_TOKENS) {
+      throw new Error(`Chunk token budget cannot exceed ${MAX_CHUNK_TOKENS}`);
+    }
   }
 
   /**
@@ -290,7 +385,7 @@ class ContentProcessor {
 }
 
 // Export the content processor class and standalone functions
-export { ContentProcessor, ProcessingMetrics, ProcessingOptions };
+export { ContentProcessor, ProcessingMetrics, ProcessingOptions, PreparedContent };
 export const analyzeContent = async (content: IContent): Promise<any> => {
   const processor = new ContentProcessor(openai);
   return processor.processContent(content);
@@ -0,0 +1,218 @@
+/**
+ * @fileoverview Local first stage of content moderation.
+ * A single Aho-Corasick pass over normalized text looks for terms from sensitive categories,
+ * and a few heuristics catch text the term list cannot judge. Content with no signal is
+ * cleared locally; everything else goes on to the moderation endpoint. The prefilter never
+ * rejects content itself, so a false positive costs one batched endpoint call.
+ * @version 1.0.0
+ */
+
+export type ModerationCategory = 'violence' | 'weapons' | 'self-harm' | 'sexual' | 'hate' | 'drugs' | 'harassment';
+
+export interface PrefilterResult {
+  verdict: 'clear' | 'review';
+  /** Matched categories and heuristics that sent the text to review */
+  reasons: string[];
+}
+
+// Terms are matched at word starts, so 'kill' also matches 'killing' but not 'skill'.
+// Kept to stems that signal a topic; the endpoint makes the actual decision.
+export const MODERATION_TERMS: Record<ModerationCategory, string[]> = {
+  violence: ['kill', 'murder', 'massacre', 'behead', 'torture', 'stabbed', 'stabbing', 'slaughter', 'mutilat',
+    'gore', 'assault', 'rape', 'terroris', 'shooting'],
+  weapons: ['bomb', 'explosive', 'detonat', 'grenade', 'firearm', 'gun', 'rifle', 'ammunition', 'nerve agent',
+    'anthrax', 'ricin', 'sarin'],
+  'self-harm': ['suicid', 'self harm', 'selfharm', 'cutting myself', 'overdose', 'anorexi', 'bulimi',
+    'kill myself', 'end my life'],
+  sexual: ['porn', 'nude', 'nudity', 'erotic', 'sexually explicit', 'having sex', 'fetish', 'genital', 'orgasm',
+    'incest', 'prostitut'],
+  hate: ['nazi', 'genocide', 'ethnic cleansing', 'white power', 'supremac', 'racial slur', 'holocaust',
+    'subhuman', 'inferior race'],
+  drugs: ['cocaine', 'heroin', 'methamphetamine', 'crystal meth', 'fentanyl', 'narcotic', 'opioid', 'lsd', 'mdma',
+    'cannabis'],
+  harassment: ['idiot', 'stupid', 'retard', 'moron', 'loser', 'shut up', 'hate you', 'worthless', 'go die'],
+};
+
+// Symbols: 0 separator, 1-26 letters, 27-36 digits
+const ALPHABET_SIZE = 37;
+const SEPARATOR = 0;
+// Share of letters outside ASCII above which the English term list cannot clear text
+const MAX_NON_ASCII_LETTER_SHARE = 0.2;
+// Consecutive one-letter words, as in "k i l l", suggest deliberate obfuscation
+const MAX_SINGLE_CHARACTER_RUN = 4;
+
+// Lowercases ASCII letters and reads common digit and symbol substitutions as letters
+const SYMBOLS = new Uint8Array(128);
+for (let code = 0; code < 128; code++) {
+  const char = String.fromCharCode(code).toLowerCase();
+  if (char >= 'a' && char <= 'z') {
+    SYMBOLS[code] = char.charCodeAt(0) - 96;
+  } else if (char >= '0' && char <= '9') {
+    SYMBOLS[code] = 27 + Number(char);
+  }
+}
+const SUBSTITUTES = new Uint8Array(128);
+Object.entries({ '0': 'o', '1': 'i', '3': 'e', '4': 'a', '5': 's', '7': 't', '@': 'a', '$': 's' })
+  .forEach(([char, letter]) => {
+    SUBSTITUTES[char.charCodeAt(0)] = SYMBOLS[letter.charCodeAt(0)];
+  });
+// Letters and substitutes; substitutions apply only after one, so plain numbers stay numbers
+const WORD_CHARACTERS = Uint8Array.from(SYMBOLS, (symbol, code) =>
+  ((symbol !== SEPARATOR && symbol <= 26) || SUBSTITUTES[code] !== 0 ? 1 : 0));
+
+/**
+ * Multi-pattern matcher compiled to a dense DFA over the prefilter alphabet,
+ * so scanning costs one table lookup per character regardless of pattern count
+ */
+export class AhoCorasick<T> {
+  private readonly transitions: Int32Array;
+  // Values of every pattern ending in each state, including those inherited through failure links
+  private readonly outputs: Array<Array<{ value: T; length: number }>>;
+  // 1 for states with any output, so the scan loop only touches `outputs` on a match
+  private readonly terminal: Uint8Array;
+
+  constructor(patterns: Array<{ pattern: string; value: T }>) {
+    const goto: number[][] = [new Array(ALPHABET_SIZE).fill(-1)];
+    const outputs: Array<Array<{ value: T; length: number }>> = [[]];
+
+    patterns.forEach(({ pattern, value }) => {
+      let state = 0;
+      for (const symbol of AhoCorasick.symbolsOf(pattern)) {
+        if (goto[state][symbol] === -1) {
+          goto[state][symbol] = goto.length;
+          goto.push(new Array(ALPHABET_SIZE).fill(-1));
+          outputs.push([]);
+        }
+        state = goto[state][symbol];
+      }
+      outputs[state].push({ value, length: pattern.length });
+    });
+
+    // Breadth-first: complete missing transitions through failure links
+    const fail = new Int32Array(goto.length);
+    const queue: number[] = [];
+    for (let symbol = 0; symbol < ALPHABET_SIZE; symbol++) {
+      const next = goto[0][symbol];
+      if (next === -1) {
+        goto[0][symbol] = 0;
+      } else {
+        queue.push(next);
+      }
+    }
+    for (let head = 0; head < queue.length; head++) {
+      const state = queue[head];
+      outputs[state] = outputs[state].concat(outputs[fail[state]]);
+      for (let symbol = 0; symbol < ALPHABET_SIZE; symbol++) {
+        const next = goto[state][symbol];
+        if (next === -1) {
+          goto[state][symbol] = goto[fail[state]][symbol];
+        } else {
+          fail[next] = goto[fail[state]][symbol];
+          queue.push(next);
+        }
+      }
+    }
+
+    this.transitions = Int32Array.from(goto.flat());
+    this.outputs = outputs;
+    this.terminal = Uint8Array.from(outputs, (values) => (values.length > 0 ? 1 : 0));
+  }
+
+  /**
+   * Calls `onMatch` for every pattern occurrence that starts at a word boundary
+   */
+  public scan(text: string, onMatch: (value: T, end: number) => void): void {
+    let state = 0;
+    let inWord = false;
+    for (let i = 0; i < text.length; i++) {
+      const code = text.charCodeAt(i);
+      let symbol = SEPARATOR;
+      if (code < 128) {
+        symbol = inWord && SUBSTITUTES[code] !== 0 ? SUBSTITUTES[code] : SYMBOLS[code];
+        inWord = WORD_CHARACTERS[code] === 1;
+      } else {
+        inWord = false;
+      }
+      state = this.transitions[state * ALPHABET_SIZE + symbol];
+      if (this.terminal[state] === 1) {
+        this.report(text, i, this.outputs[state], onMatch);
+      }
+    }
+  }
+
+  private report(text: string, end: number, matches: Array<{ value: T; length: number }>,
+    onMatch: (value: T, end: number) => void): void {
+    for (let m = 0; m < matches.length; m++) {
+      const start = end - matches[m].length + 1;
+      if (start === 0 || AhoCorasick.isSeparatorAt(text, start - 1)) {
+        onMatch(matches[m].value, end);
+      }
+    }
+  }
+
+  // Mirrors the symbol the scan reads: '$' or '@' is a separator unless it continues a word
+  private static isSeparatorAt(text: string, index: number): boolean {
+    const code = text.charCodeAt(index);
+    if (code >= 128) {
+      return true;
+    }
+    if (SYMBOLS[code] !== SEPARATOR || SUBSTITUTES[code] === 0) {
+      return SYMBOLS[code] === SEPARATOR;
+    }
+    return index === 0 || text.charCodeAt(index - 1) >= 128 || WORD_CHARACTERS[text.charCodeAt(index - 1)] === 0;
+  }
+
+  private static symbolsOf(pattern: string): number[] {
+    return Array.from(pattern.toLowerCase(), (char) => (char.charCodeAt(0) < 128 ? SYMBOLS[char.charCodeAt(0)] : SEPARATOR));
+  }
+}
+
+/**
+ * Clears content with no sign of sensitive material and marks the rest for review
+ */
+export class ModerationPrefilter {
+  private readonly matcher: AhoCorasick<ModerationCategory>;
+
+  constructor(terms: Record<string, string[]> = MODERATION_TERMS) {
+    this.matcher = new AhoCorasick(Object.entries(terms).flatMap(([category, patterns]) =>
+      patterns.map((pattern) => ({ pattern, value: category as ModerationCategory }))));
+  }
+
+  public classify(text: string): PrefilterResult {
+    const reasons = new Set<string>();
+    this.matcher.scan(text, (category) => reasons.add(category));
+
+    let letters = 0;
+    let nonAscii = 0;
+    let wordLength = 0;
+    let singleCharacterRun = 0;
+    let longestRun = 0;
+    for (let i = 0; i <= text.length; i++) {
+      const code = i < text.length ? text.charCodeAt(i) : 32;
+      if (code >= 128) {
+        // Surrogates and marks count too; close enough for a share threshold
+        nonAscii++;
+        letters++;
+        wordLength++;
+      } else if (SYMBOLS[code] !== SEPARATOR) {
+        letters++;
+        wordLength++;
+      } else if (wordLength > 0) {
+        // Only single letters extend a run; digits keep formulas like "a^2 + b^2 = c^2" clear
+        const singleLetter = wordLength === 1 && SYMBOLS[text.charCodeAt(i - 1)] <= 26;
+        singleCharacterRun = singleLetter ? singleCharacterRun + 1 : 0;
+        longestRun = Math.max(longestRun, singleCharacterRun);
+        wordLength = 0;
+      }
+    }
+
+    if (letters > 0 && nonAscii / letters > MAX_NON_ASCII_LETTER_SHARE) {
+      reasons.add('unsupported-script');
+    }
+    if (longestRun >= MAX_SINGLE_CHARACTER_RUN) {
+      reasons.add('obfuscation');
+    }
+
+    return { verdict: reasons.size === 0 ? 'clear' : 'review', reasons: [...reasons] };
+  }
+}
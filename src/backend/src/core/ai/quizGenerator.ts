@@ -5,10 +5,13 @@
  */
 
 import { openai } from '../../config/openai';
+import { ConcurrencyPriority } from '../../utils/concurrencyLimiter';
 import { ICard, ICardContent, ContentType } from '../../interfaces/ICard';
 import { StudyModes } from '../../constants/studyModes';
 import NodeCache from 'node-cache';
 import { PerformanceMonitor } from 'performance-monitor';
+import { SingleFlight } from '../../utils/singleFlight';
+import { DistractorIndex } from '../cards/distractorIndex';
 
 // Quiz generation constants
 const QUIZ_GENERATION_PROMPT = `Generate a comprehensive quiz based on the following content. 
@@ -21,6 +24,14 @@ const QUIZ_TYPES = ['multiple_choice', 'true_false', 'fill_in_blank'] as const;
 const PROCESSING_TIMEOUT = 10000; // 10 seconds
 const CACHE_TTL = 3600; // 1 hour
 const MAX_RETRIES = 3;
+const MAX_CACHED_DECKS = 100;
+
+const QUESTION_PHRASING_PROMPT = `Rewrite each flashcard prompt as one clear quiz question whose correct
+answer is the given answer. Do not reveal the answer. Respond with a JSON array of strings, one question
+per flashcard, in the given order.`;
+
+// Fronts that already read as a question, or as a fill-in-the-blank, need no phrasing
+const QUESTION_FORM = /(\?\s*$|_{3,}|^(what|which|who|whom|whose|when|where|why|how|name|define|identify|list|state|give|is|are|does|do|can|in (what|which))\b)/i;
 
 type QuizType = typeof QUIZ_TYPES[number];
 
@@ -31,7 +42,7 @@ interface QuizGeneratorOptions {
   timeout?: number;
 }
 
-interface QuizQuestion {
+export interface QuizQuestion {
   question: string;
   type: QuizType;
   options?: string[];
@@ -39,6 +50,12 @@ interface QuizQuestion {
   explanation?: string;
 }
 
+interface DeckQuizOptions {
+  questionCount?: number;
+  cardIds?: ReadonlySet<string>;  // Build questions only for these cards; the whole deck still supplies distractors
+  priority?: ConcurrencyPriority;
+}
+
 /**
  * Enhanced quiz generator class with performance monitoring and caching
  */
@@ -47,13 +64,18 @@ export class QuizGenerator {
   private readonly cache: NodeCache;
   private readonly performanceMonitor: PerformanceMonitor;
   private readonly options: Required<QuizGeneratorOptions>;
+  private readonly singleFlight?: SingleFlight;
+  // Distractor indexes per user and deck version; rebuilt when the deck changes
+  private readonly deckIndexes = new Map<string, DistractorIndex>();
 
   constructor(
     openaiClient = openai,
     cacheService = new NodeCache({ stdTTL: CACHE_TTL }),
     performanceMonitor = new PerformanceMonitor(),
-    options: QuizGeneratorOptions = {}
+    options: QuizGeneratorOptions = {},
+    singleFlight?: SingleFlight
   ) {
+    this.singleFlight = singleFlight;
     this.openaiClient = openaiClient;
     this.cache = cacheService;
     this.performanceMonitor = performanceMonitor;
@@ -82,13 +104,20 @@ export class QuizGenerator {
       }
 
       const mergedOptions = { ...this.options, ...options };
-      const questions = await this.generateQuestions(content, mergedOptions);
-      const cards = this.convertToCards(questions);
+      const generate = async () => {
+        const questions = await this.generateQuestions(content, mergedOptions);
+        span.addAttribute('questions_count', questions.length);
+        return this.convertToCards(questions);
+      };
+
+      // Share one generation between identical requests across workers
+      const cards = this.singleFlight
+        ? await this.singleFlight.doCached(cacheKey, CACHE_TTL, generate)
+        : await generate();
 
       // Cache the generated cards
       this.cache.set(cacheKey, cards);
-      
-      span.addAttribute('questions_count', questions.length);
+
       return cards;
     } catch (error) {
       span.recordException(error as Error);
@@ -98,6 +127,147 @@ export class QuizGenerator {
     }
   }
 
+  /**
+   * Builds multiple-choice questions from a user's own cards. Wrong options come from
+   * related cards in the deck; the LLM is asked only to phrase fronts that do not
+   * already read as questions, all in one call.
+   */
+  async generateDeckQuiz(userId: string, cards: ICard[], options: DeckQuizOptions = {}): Promise<ICard[]> {
+    const span = this.performanceMonitor.startSpan('deck_quiz_generation');
+
+    try {
+      const selected = await this.buildDeckQuestions(userId, cards, options);
+      span.addAttribute('questions_count', selected.length);
+
+      const quizCards = this.convertToCards(selected.map(({ question }) => question));
+      return quizCards.map((quizCard, i) => ({
+        ...quizCard,
+        userId,
+        contentId: selected[i].card.contentId
+      }));
+    } catch (error) {
+      span.recordException(error as Error);
+      throw error;
+    } finally {
+      span.end();
+    }
+  }
+
+  /**
+   * Builds one question per card that has enough distractors, paired with its card.
+   * Used directly by the question bank, which stores the questions instead of cards.
+   */
+  async buildDeckQuestions(
+    userId: string,
+    cards: ICard[],
+    options: DeckQuizOptions = {}
+  ): Promise<Array<{ card: ICard; question: QuizQuestion }>> {
+    const questionCount = options.questionCount ?? this.options.maxQuestionsPerContent;
+    const index = this.deckIndex(userId, cards);
+    const selected: Array<{ card: ICard; question: QuizQuestion }> = [];
+    for (const card of cards) {
+      if (selected.length >= questionCount) {
+        break;
+      }
+      if (options.cardIds && !options.cardIds.has(card.id)) {
+        continue;
+      }
+      const indexed = index.answerFor(card.id);
+      const distractors = index.distractors(card.id, MAX_OPTIONS_COUNT - 1);
+      if (!indexed || distractors.length < MIN_OPTIONS_COUNT - 1) {
+        continue;
+      }
+      selected.push({
+        card,
+        question: {
+          question: card.frontContent.text.replace(/^#+\s*/, '').trim(),
+          type: 'multiple_choice',
+          options: this.shuffle([indexed.answer, ...distractors], card.id),
+          correctAnswer: indexed.answer
+        }
+      });
+    }
+
+    const misses = selected.filter(({ question }) => !QUESTION_FORM.test(question.question));
+    if (misses.length > 0) {
+      const phrased = await this.phraseQuestions(misses.map(({ question }) => question), options.priority);
+      misses.forEach((miss, i) => {
+        miss.question.question = phrased[i];
+      });
+    }
+    return selected;
+  }
+
+  private deckIndex(userId: string, cards: ICard[]): DistractorIndex {
+    const deck = cards.map((card) => `${card.id}\u0000${card.frontContent.text}\u0000${card.backContent.text}`);
+    const key = `${userId}:${this.generateCacheKey(deck.join('\u0001'), {})}`;
+    const cached = this.deckIndexes.get(key);
+    if (cached) {
+      return cached;
+    }
+
+    const index = new DistractorIndex(cards.map((card) => ({
+      id: card.id,
+      front: card.frontContent.text,
+      back: card.backContent.text,
+      contentId: card.contentId,
+      tags: card.tags
+    })));
+    // Map iteration follows insertion order, so the first key is the oldest deck
+    if (this.deckIndexes.size >= MAX_CACHED_DECKS) {
+      this.deckIndexes.delete(this.deckIndexes.keys().next().value as string);
+    }
+    this.deckIndexes.set(key, index);
+    return index;
+  }
+
+  /**
+   * Phrases card fronts as questions in one LLM call, shared across workers. Falls back
+   * to the front as written when the response cannot be used.
+   */
+  private async phraseQuestions(
+    questions: QuizQuestion[],
+    priority: ConcurrencyPriority = 'interactive'
+  ): Promise<string[]> {
+    const prompts = questions.map(({ question, correctAnswer }) => ({ prompt: question, answer: correctAnswer }));
+    const phrase = async (): Promise<string[]> => {
+      const response = await this.openaiClient.createChatCompletion({
+        messages: [
+          { role: 'system', content: QUESTION_PHRASING_PROMPT },
+          { role: 'user', content: JSON.stringify(prompts) }
+        ],
+        temperature: 0.3,
+        max_tokens: 64 * prompts.length
+      }, { priority });
+      const phrased = JSON.parse(response.data.choices[0].message?.content || '');
+      if (!Array.isArray(phrased) || phrased.length !== prompts.length ||
+        !phrased.every((text) => typeof text === 'string' && text.trim())) {
+        throw new Error('Failed to parse question phrasing response');
+      }
+      return phrased;
+    };
+
+    try {
+      return this.singleFlight
+        ? await this.singleFlight.doCached(this.generateCacheKey(JSON.stringify(prompts), {}), CACHE_TTL, phrase)
+        : await phrase();
+    } catch {
+      return questions.map(({ question }) => question);
+    }
+  }
+
+  // Deterministic per card, so a rebuilt quiz keeps its option order
+  private shuffle(options: string[], seed: string): string[] {
+    let state = [...seed].reduce((hash, char) => Math.imul(hash ^ char.charCodeAt(0), 0x01000193), 0x811c9dc5);
+    const shuffled = [...options];
+    for (let i = shuffled.length - 1; i > 0; i--) {
+      state = Math.imul(state ^ (state >>> 15), 0x2c1b3c6d) >>> 0;
+      const j = state % (i + 1);
+      [shuffled[i], shuffled[j]] = [shuffled[j], shuffled[i]];
+    }
+    return shuffled;
+  }
+
   /**
    * Generates a unique cache key based on content and options
    */
@@ -0,0 +1,204 @@
+/**
+ * @fileoverview Cross-user cache of derived processing artifacts.
+ * When several users capture the same public article, the analysis, chunking and
+ * generated card templates are computed once and materialized as each user's own cards.
+ * Artifacts hold no user identifiers, and only public web captures are shared.
+ * @version 1.0.0
+ */
+
+import crypto from 'crypto';
+import Redis from 'ioredis'; // version: ^5.0.0
+import { ICard, ICardContent } from '../../interfaces/ICard';
+import { IContent } from '../../interfaces/IContent';
+import { performanceMonitor } from '../monitoring/PerformanceMonitor';
+import { logger } from '../../config/logger';
+
+// Bump when prompts or chunking change so stale artifacts stop matching
+const ARTIFACT_VERSION = 1;
+const KEY_PREFIX = `artifact:v${ARTIFACT_VERSION}:`;
+const DEFAULT_TTL = 7 * 24 * 3600; // 7 days in seconds
+const CACHE_NAME = 'shared_artifacts';
+
+// Only article captures are shared; uploads and highlights may be private documents
+const SHAREABLE_SOURCES = new Set(['web']);
+
+const TRACKING_PARAMS = /^(utm_\w+|fbclid|gclid|dclid|msclkid|mc_cid|mc_eid|igshid|ref|ref_src|_ga)$/i;
+
+// Page chrome that varies between captures of the same article
+const BOILERPLATE_LINE = /^(advertisement|sponsored|share( this( article)?)?|subscribe( now)?|sign up.*|log in|read more|related( articles| stories)?|accept (all )?cookies.*|we use cookies.*|all rights reserved.*|(©|copyright)\s.*)$/i;
+const MAX_BOILERPLATE_LINE = 80;
+
+/** Card content without the owner-specific fields */
+export interface CardTemplate {
+  frontContent: ICardContent;
+  backContent: ICardContent;
+  compatibleModes: string[];
+}
+
+export interface ArtifactChunk {
+  start: number;
+  end: number;
+  tokenCount: number;
+  heading?: string;
+  cards: CardTemplate[];
+}
+
+export interface SharedArtifact {
+  /** Analysis fields merged into content metadata */
+  analysis: Record<string, unknown>;
+  chunks: ArtifactChunk[];
+  createdAt: string;
+}
+
+export interface ArtifactCacheStats {
+  hits: number;
+  misses: number;
+  /** Lookups skipped because the content is not shareable */
+  skipped: number;
+  hitRate: number;
+}
+
+/**
+ * Normalizes a URL so trivially different links to one article compare equal.
+ * @returns null when the URL is not an http(s) URL
+ */
+export const canonicalizeUrl = (rawUrl: string): string | null => {
+  let url: URL;
+  try {
+    url = new URL(rawUrl.trim());
+  } catch {
+    return null;
+  }
+  if (url.protocol !== 'http:' && url.protocol !== 'https:') {
+    return null;
+  }
+
+  const params = [...url.searchParams.entries()]
+    .filter(([name]) => !TRACKING_PARAMS.test(name))
+    .sort(([a, av], [b, bv]) => a.localeCompare(b) || av.localeCompare(bv));
+  const query = new URLSearchParams(params).toString();
+  const path = url.pathname.replace(/\/{2,}/g, '/').replace(/\/(index\.html?)?$/i, '') || '/';
+  const host = url.hostname.toLowerCase().replace(/^www\./, '');
+
+  return `https://${host}${path}${query ? `?${query}` : ''}`;
+};
+
+/**
+ * Hashes text ignoring case, Unicode form, whitespace and common page boilerplate
+ */
+export const normalizedTextHash = (text: string): string => {
+  const normalized = text
+    .normalize('NFKC')
+    .replace(/[\u200B-\u200D\uFEFF]/g, '')
+    .split(/\r?\n/)
+    .map((line) => line.trim())
+    .filter((line) => line && !(line.length <= MAX_BOILERPLATE_LINE && BOILERPLATE_LINE.test(line)))
+    .join(' ')
+    .replace(/\s+/g, ' ')
+    .toLowerCase();
+  return crypto.createHash('sha256').update(normalized).digest('hex');
+};
+
+/**
+ * Shared artifact store keyed by canonical URL and normalized text
+ */
+export class SharedArtifactCache {
+  private readonly stats = { hits: 0, misses: 0, skipped: 0 };
+
+  constructor(
+    private readonly client: Redis,
+    private readonly ttlSeconds: number = DEFAULT_TTL
+  ) {}
+
+  /**
+   * Returns the cache key for content, or null when it must not be shared
+   */
+  public keyFor(content: IContent): string | null {
+    if (!SHAREABLE_SOURCES.has(content.source) || !content.sourceUrl) {
+      return null;
+    }
+    const canonicalUrl = canonicalizeUrl(content.sourceUrl);
+    if (!canonicalUrl) {
+      return null;
+    }
+    const digest = crypto.createHash('sha256')
+      .update(`${canonicalUrl}\n${normalizedTextHash(content.content)}`)
+      .digest('hex');
+    return `${KEY_PREFIX}${digest}`;
+  }
+
+  public async get(key: string | null): Promise<SharedArtifact | null> {
+    if (!key) {
+      this.stats.skipped++;
+      return null;
+    }
+    let stored: string | null = null;
+    try {
+      stored = await this.client.get(key);
+    } catch (error) {
+      // An unreachable cache costs a regeneration, never the capture
+      logger.warn('Shared artifact lookup failed, generating instead', { key, error: (error as Error).message });
+    }
+    this.record(stored !== null);
+    return stored === null ? null : JSON.parse(stored);
+  }
+
+  /**
+   * Stores an artifact for later captures. Best effort: the caller's cards are
+   * already persisted, so a failed write is logged and dropped.
+   */
+  public async put(key: string, artifact: SharedArtifact): Promise<void> {
+    try {
+      await this.client.setex(key, this.ttlSeconds, JSON.stringify(artifact));
+    } catch (error) {
+      logger.warn('Shared artifact store failed', { key, error: (error as Error).message });
+    }
+  }
+
+  /**
+   * Reduces generated cards to templates that carry no owner data
+   */
+  public static toTemplates(cards: ICard[]): CardTemplate[] {
+    const side = ({ metadata: { sourceUrl, ...metadata }, ...rest }: ICardContent): ICardContent =>
+      ({ ...rest, metadata });
+    return cards.map((card) => ({
+      frontContent: side(card.frontContent),
+      backContent: side(card.backContent),
+      compatibleModes: card.compatibleModes,
+    }));
+  }
+
+  /**
+   * Builds one user's cards from shared templates
+   */
+  public static materialize(templates: CardTemplate[], content: IContent): ICard[] {
+    const side = (template: ICardContent): ICardContent =>
+      ({ ...template, metadata: { ...template.metadata, sourceUrl: content.sourceUrl ?? undefined } });
+    return templates.map((template) => ({
+      id: crypto.randomUUID(),
+      userId: content.userId,
+      contentId: content.id,
+      frontContent: side(template.frontContent),
+      backContent: side(template.backContent),
+      compatibleModes: template.compatibleModes,
+      tags: content.metadata.tags || [],
+      createdAt: new Date(),
+      updatedAt: new Date(),
+    }) as unknown as ICard);
+  }
+
+  public getStats(): ArtifactCacheStats {
+    const lookups = this.stats.hits + this.stats.misses;
+    return { ...this.stats, hitRate: lookups === 0 ? 0 : this.stats.hits / lookups };
+  }
+
+  private record(hit: boolean): void {
+    if (hit) {
+      this.stats.hits++;
+    } else {
+      this.stats.misses++;
+    }
+    performanceMonitor.recordCacheLookup(CACHE_NAME, hit);
+    performanceMonitor.trackCacheHitRatio(CACHE_NAME, this.getStats().hitRate);
+  }
+}
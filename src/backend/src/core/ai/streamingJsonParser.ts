@@ -0,0 +1,92 @@
+/**
+ * @fileoverview Incremental parser for a JSON array of objects arriving in fragments.
+ * Used to read streamed model output, emitting each element as soon as its closing
+ * brace arrives instead of waiting for the whole completion.
+ * @version 1.0.0
+ */
+
+/**
+ * Parses the first top-level JSON array in a text stream. Text before the
+ * opening bracket (prose, a ```json fence) is ignored, as are non-object
+ * elements. Elements that do not parse are counted and skipped.
+ */
+export class StreamingJsonArrayParser<T = unknown> {
+  private started = false;
+  private closed = false;
+  private depth = 0;
+  private inString = false;
+  private escaped = false;
+  private element = '';
+
+  /** Elements skipped because they were not valid JSON */
+  public malformedCount = 0;
+
+  /**
+   * Feeds the next fragment of text
+   * @returns Elements completed by this fragment, in order
+   */
+  push(fragment: string): T[] {
+    const completed: T[] = [];
+    if (this.closed) {
+      return completed;
+    }
+
+    let elementStart = this.depth > 0 ? 0 : -1;
+    for (let i = 0; i < fragment.length; i++) {
+      const char = fragment[i];
+
+      if (!this.started) {
+        this.started = char === '[';
+        continue;
+      }
+
+      if (this.inString) {
+        if (this.escaped) {
+          this.escaped = false;
+        } else if (char === '\\') {
+          this.escaped = true;
+        } else if (char === '"') {
+          this.inString = false;
+        }
+        continue;
+      }
+
+      if (char === '"') {
+        this.inString = true;
+      } else if (this.depth === 0) {
+        if (char === '{') {
+          this.depth = 1;
+          elementStart = i;
+        } else if (char === ']') {
+          this.closed = true;
+          return completed;
+        }
+      } else if (char === '{' || char === '[') {
+        this.depth++;
+      } else if (char === '}' || char === ']') {
+        this.depth--;
+        if (this.depth === 0) {
+          const text = this.element + fragment.slice(elementStart, i + 1);
+          this.element = '';
+          elementStart = -1;
+          try {
+            completed.push(JSON.parse(text));
+          } catch {
+            this.malformedCount++;
+          }
+        }
+      }
+    }
+
+    // Carry an unfinished element into the next fragment
+    if (this.depth > 0 && elementStart >= 0) {
+      this.element += fragment.slice(elementStart);
+    }
+    return completed;
+  }
+
+  /** True once the array's closing bracket has been seen */
+  get isComplete(): boolean {
+    return this.closed;
+  }
+}
@@ -0,0 +1,291 @@
+/**
+ * @fileoverview Token-aware content chunking for LLM requests.
+ * Counts tokens with a local BPE tokenizer (tiktoken WASM, cl100k_base) and packs
+ * paragraphs and sentences into chunks that fill a token budget, with overlap,
+ * without splitting across headings where it can be avoided.
+ * @version 1.0.0
+ */
+
+import { get_encoding, Tiktoken } from 'tiktoken'; // version: ^1.0.15
+
+/** Encoding used by the gpt-4 and gpt-3.5 model families */
+export const TOKENIZER_ENCODING = 'cl100k_base';
+
+/** Smallest budget accepted; below this, overlap and headings leave no room */
+const MIN_TARGET_TOKENS = 16;
+
+/** A heading closes the current chunk once it is at least this full */
+const HEADING_BREAK_FILL = 0.5;
+
+/** "\n\n" between paragraphs encodes to a single cl100k token */
+const PARAGRAPH_SEPARATOR_TOKENS = 1;
+
+const HEADING_PATTERN = /^#{1,6}\s+\S/;
+const PARAGRAPH_BREAK = /\n[ \t]*\n\s*/g;
+const SENTENCE_PATTERN = /[^.!?。！？]+(?:[.!?。！？]+["'”’)\]]*)?\s*|[.!?。！？]+\s*/g;
+
+export interface TokenChunkOptions {
+  /** Token budget per chunk, overlap included */
+  targetTokens: number;
+  /** Tokens of trailing context repeated at the start of the next chunk */
+  overlapTokens?: number;
+}
+
+export interface TokenChunk {
+  text: string;
+  /** Token count of `text`, summed per unit; merges across units only lower the exact count */
+  tokenCount: number;
+  /** Tokens at the start of the chunk repeated from the previous chunk */
+  overlapTokens: number;
+  /** Nearest preceding heading, if any */
+  heading?: string;
+  /** Source character range of the chunk's new (non-overlap) content */
+  start: number;
+  end: number;
+}
+
+interface ChunkUnit {
+  text: string;
+  tokens: number;
+  start: number;
+  end: number;
+  /** First unit of a paragraph; joined to the previous unit with a blank line */
+  paragraphStart: boolean;
+  heading: boolean;
+  overlap: boolean;
+  /** Heading in effect at this unit */
+  section?: string;
+}
+
+let encoder: Tiktoken | null = null;
+
+const getEncoder = (): Tiktoken => {
+  if (!encoder) {
+    encoder = get_encoding(TOKENIZER_ENCODING);
+  }
+  return encoder;
+};
+
+/**
+ * Counts tokens as the model sees them. Special-token markers in user content
+ * are counted as ordinary text.
+ */
+export const countTokens = (text: string): number =>
+  text.length === 0 ? 0 : getEncoder().encode_ordinary(text).length;
+
+/**
+ * Splits a unit that exceeds the budget on sentence, then word, then character
+ * boundaries. Every returned piece fits the budget.
+ */
+const splitOversized = (text: string, start: number, budget: number): ChunkUnit[] => {
+  const pieces: ChunkUnit[] = [];
+  const push = (pieceText: string, pieceStart: number, tokens: number) => {
+    pieces.push({
+      text: pieceText,
+      tokens,
+      start: pieceStart,
+      end: pieceStart + pieceText.length,
+      paragraphStart: pieces.length === 0,
+      heading: false,
+      overlap: false
+    });
+  };
+
+  for (const sentence of text.matchAll(SENTENCE_PATTERN)) {
+    const sentenceText = sentence[0];
+    const sentenceStart = start + (sentence.index ?? 0);
+    const sentenceTokens = countTokens(sentenceText);
+    if (sentenceTokens <= budget) {
+      push(sentenceText, sentenceStart, sentenceTokens);
+      continue;
+    }
+
+    // Pack words; a single word longer than the budget is cut by characters
+    let pieceStart = 0;
+    let pieceTokens = 0;
+    for (const word of sentenceText.matchAll(/\S+\s*/g)) {
+      const wordIndex = word.index ?? 0;
+      const wordTokens = countTokens(word[0]);
+      if (pieceTokens + wordTokens > budget && wordIndex > pieceStart) {
+        push(sentenceText.slice(pieceStart, wordIndex), sentenceStart + pieceStart, pieceTokens);
+        pieceStart = wordIndex;
+        pieceTokens = 0;
+      }
+      if (wordTokens > budget) {
+        const charsPerPiece = Math.max(1, Math.floor((word[0].length * budget) / wordTokens));
+        for (let offset = 0; offset < word[0].length; offset += charsPerPiece) {
+          const slice = word[0].slice(offset, offset + charsPerPiece);
+          push(slice, sentenceStart + wordIndex + offset, Math.min(countTokens(slice), budget));
+        }
+        pieceStart = wordIndex + word[0].length;
+        continue;
+      }
+      pieceTokens += wordTokens;
+    }
+    if (pieceStart < sentenceText.length) {
+      push(sentenceText.slice(pieceStart), sentenceStart + pieceStart, pieceTokens);
+    }
+  }
+  return pieces;
+};
+
+/**
+ * Splits content into paragraph and heading units, breaking paragraphs that
+ * exceed the budget into sentences.
+ */
+const toUnits = (content: string, budget: number): ChunkUnit[] => {
+  const units: ChunkUnit[] = [];
+  let blockStart = 0;
+
+  const addBlock = (end: number) => {
+    const raw = content.slice(blockStart, end);
+    const leading = raw.length - raw.trimStart().length;
+    const text = raw.trim();
+    if (!text) {
+      return;
+    }
+    const start = blockStart + leading;
+    const tokens = countTokens(text);
+    if (tokens <= budget) {
+      units.push({
+        text,
+        tokens,
+        start,
+        end: start + text.length,
+        paragraphStart: true,
+        heading: HEADING_PATTERN.test(text) && !text.includes('\n'),
+        overlap: false
+      });
+    } else {
+      units.push(...splitOversized(text, start, budget));
+    }
+  };
+
+  for (const match of content.matchAll(PARAGRAPH_BREAK)) {
+    addBlock(match.index ?? 0);
+    blockStart = (match.index ?? 0) + match[0].length;
+  }
+  addBlock(content.length);
+  return units;
+};
+
+/**
+ * Trailing sentences of a unit too long to repeat whole, as one unit of at most
+ * `budget` tokens, or null if even its last sentence does not fit
+ */
+const trailingSentences = (unit: ChunkUnit, budget: number): ChunkUnit | null => {
+  let tail: ChunkUnit | null = null;
+  const starts = [...unit.text.matchAll(SENTENCE_PATTERN)].map((sentence) => sentence.index ?? 0);
+  for (let i = starts.length - 1; i > 0; i--) {
+    const text = unit.text.slice(starts[i]);
+    const tokens = countTokens(text);
+    if (tokens > budget) {
+      break;
+    }
+    tail = { ...unit, text, tokens, start: unit.start + starts[i], paragraphStart: true, heading: false };
+  }
+  return tail;
+};
+
+const joinedCost = (units: ChunkUnit[], unit: ChunkUnit): number =>
+  unit.tokens + (units.length > 0 && unit.paragraphStart ? PARAGRAPH_SEPARATOR_TOKENS : 0);
+
+const totalTokens = (units: ChunkUnit[]): number =>
+  units.reduce((sum, unit, i) => sum + unit.tokens + (i > 0 && unit.paragraphStart ? PARAGRAPH_SEPARATOR_TOKENS : 0), 0);
+
+/** True when units hold content beyond repeated overlap and headings */
+const hasBody = (units: ChunkUnit[]): boolean =>
+  units.some((unit) => !unit.overlap && !unit.heading);
+
+/**
+ * Packs content into chunks of at most `targetTokens` tokens. Chunks end on
+ * paragraph or sentence boundaries, headings stay with the content they
+ * introduce, and each chunk after the first repeats up to `overlapTokens`
+ * of trailing sentences from its predecessor within the same section.
+ */
+export const chunkByTokens = (content: string, options: TokenChunkOptions): TokenChunk[] => {
+  const { targetTokens, overlapTokens = 0 } = options;
+  if (!Number.isInteger(targetTokens) || targetTokens < MIN_TARGET_TOKENS) {
+    throw new Error(`Chunk token budget must be an integer of at least ${MIN_TARGET_TOKENS}`);
+  }
+  if (overlapTokens < 0 || overlapTokens * 2 > targetTokens) {
+    throw new Error('Chunk overlap must be between 0 and half the token budget');
+  }
+
+  const chunks: TokenChunk[] = [];
+  let current: ChunkUnit[] = [];
+  let section: string | undefined;
+
+  const emit = () => {
+    let text = '';
+    let overlap = 0;
+    current.forEach((unit, i) => {
+      text += (i > 0 && unit.paragraphStart ? '\n\n' : '') + unit.text;
+      if (unit.overlap) {
+        overlap = totalTokens(current.slice(0, i + 1));
+      }
+    });
+    const fresh = current.filter((unit) => !unit.overlap);
+    chunks.push({
+      text: text.trim(),
+      tokenCount: totalTokens(current),
+      overlapTokens: overlap,
+      heading: fresh[0].section,
+      start: fresh[0].start,
+      end: fresh[fresh.length - 1].end
+    });
+  };
+
+  const flush = (withOverlap: boolean) => {
+    // Trailing headings move forward to the content they introduce
+    const carried: ChunkUnit[] = [];
+    while (current.length > 0 && current[current.length - 1].heading) {
+      carried.unshift(current.pop()!);
+    }
+    emit();
+
+    const repeated: ChunkUnit[] = [];
+    if (withOverlap && carried.length === 0) {
+      for (let i = current.length - 1; i >= 0 && !current[i].heading; i--) {
+        if (totalTokens([current[i], ...repeated]) > overlapTokens) {
+          // Paragraphs are single units; one longer than the overlap gives its last sentences
+          const separator = repeated.length > 0 && repeated[0].paragraphStart ? PARAGRAPH_SEPARATOR_TOKENS : 0;
+          const tail = trailingSentences(current[i], overlapTokens - totalTokens(repeated) - separator);
+          if (tail) {
+            repeated.unshift({ ...tail, overlap: true });
+          }
+          break;
+        }
+        repeated.unshift({ ...current[i], overlap: true });
+      }
+    }
+    current = [...repeated, ...carried];
+  };
+
+  for (const unit of toUnits(content, targetTokens)) {
+    if (unit.heading) {
+      // A new section starts a new chunk unless the current one is still small
+      if (hasBody(current) && totalTokens(current) >= targetTokens * HEADING_BREAK_FILL) {
+        flush(false);
+      }
+      // Context from the previous section is not repeated into this one
+      current = current.filter((existing) => !existing.overlap);
+      section = unit.text.replace(/^#+\s*/, '');
+    }
+    unit.section = section;
+
+    if (totalTokens(current) + joinedCost(current, unit) > targetTokens && hasBody(current)) {
+      flush(true);
+    }
+    // Drop repeated context, then leading headings, rather than exceed the budget
+    while (current.length > 0 && totalTokens(current) + joinedCost(current, unit) > targetTokens) {
+      current.shift();
+    }
+    current.push(unit);
+  }
+  if (current.some((unit) => !unit.overlap)) {
+    emit();
+  }
+
+  return chunks;
+};
@@ -6,9 +6,8 @@
  */
 
 import { injectable, singleton } from 'tsyringe';
-import { openai, ConfiguredOpenAI } from '../../config/openai';
+import { OpenAIClient } from '../../config/openai';
 import { voiceInputSchema } from '../../api/validators/voice.validator';
-import { RateLimiter } from 'limiter'; // ^2.0.0
 import { Redis } from 'redis'; // ^4.6.0
 import winston from 'winston'; // ^3.10.0
 import crypto from 'crypto';
@@ -30,13 +29,6 @@ const VOICE_PROCESSING_CONFIG = {
 // Supported languages for voice processing
 const SUPPORTED_LANGUAGES = ['en', 'es', 'fr', 'de', 'it', 'pt', 'ja', 'ko', 'zh'] as const;
 
-// Rate limiting configuration
-const RATE_LIMIT_CONFIG = {
-  maxRequests: 100,
-  windowMs: 60000,
-  errorMessage: 'Too many voice processing requests'
-} as const;
-
 /**
  * Interface for voice processing result
  */
@@ -63,11 +55,9 @@ interface ValidationResult {
 @injectable()
 @singleton()
 export class VoiceProcessor {
-  private readonly rateLimiter: RateLimiter;
-
   constructor(
     private readonly logger: winston.Logger,
-    private readonly openai: ConfiguredOpenAI,
+    private readonly openai: OpenAIClient,
     private readonly cache: Redis,
     private readonly metrics?: any  // Make metrics optional
   ) {
@@ -81,20 +71,15 @@ export class VoiceProcessor {
       hasAudioAPI: !!(this.openai?.audio?.transcriptions),
       openAIType: typeof this.openai
     });
-
-    this.rateLimiter = new RateLimiter({
-      tokensPerInterval: RATE_LIMIT_CONFIG.maxRequests,
-      interval: RATE_LIMIT_CONFIG.windowMs
-    });
   }
 
   /**
    * Processes voice input with caching and performance optimization
    * @param audioData - Raw audio buffer
    * @param language - Target language code
-   * @param userId - User identifier for rate limiting
+   * @param userId - User identifier for metrics
    * @returns Processed voice result with confidence scoring
-   * @throws Error if processing fails or rate limit exceeded
+   * @throws Error if processing fails
    */
   public async processVoiceInput(
     audioData: Buffer,
@@ -127,11 +112,6 @@ export class VoiceProcessor {
         throw new Error('Unsupported language');
       }
 
-      // Check rate limit
-      if (!await this.rateLimiter.tryRemoveTokens(1)) {
-        throw new Error(RATE_LIMIT_CONFIG.errorMessage);
-      }
-
       // Generate audio fingerprint for caching
       const audioFingerprint = this.generateAudioFingerprint(audioData);
       
@@ -144,13 +124,13 @@ export class VoiceProcessor {
       // Preprocess audio for optimal quality
       const processedAudio = await this.preprocessAudio(audioData);
 
-      // Process with OpenAI's Whisper model
-      const transcriptionResult = await this.openai.audio.transcriptions.create({
+      // Process with OpenAI's Whisper model; a user is waiting, so it goes ahead of batch generation
+      const transcriptionResult = await this.openai.createTranscription({
         file: audioFile,
         model: VOICE_PROCESSING_CONFIG.whisperModel,
         language: SUPPORTED_LANGUAGES.includes(language as any) ? language : 'en',
         response_format: 'json'
-      });
+      }, { priority: 'interactive' });
 
       this.logger.debug('OpenAI transcription completed', {
         success: !!transcriptionResult,
@@ -315,7 +295,7 @@ export class VoiceProcessor {
     language: string
   ): Promise<number> {
     try {
-      const response = await this.openai.chat.completions.create({
+      const response = await this.openai.createChatCompletion({
         model: 'gpt-4',
         messages: [
           {
@@ -329,7 +309,7 @@ export class VoiceProcessor {
         ],
         temperature: 0.1,
         max_tokens: 50
-      });
+      }, { priority: 'interactive' });
 
       // Add null checks and logging
       this.logger.debug('Similarity calculation response:', {
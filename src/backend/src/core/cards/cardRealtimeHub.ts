@@ -0,0 +1,136 @@
+/**
+ * @fileoverview Per-user realtime fan-out for card changes.
+ * Each user with watched cards gets one Supabase channel filtered to their rows; changes
+ * are routed in process to the listeners registered for the changed card. Channels are
+ * reference-counted by listener and removed when the last one is released.
+ * @version 1.0.0
+ */
+
+import { RealtimeChannel, RealtimePostgresChangesPayload, SupabaseClient } from '@supabase/supabase-js';
+import { ICard } from '../../interfaces/ICard';
+
+export type CardChange = RealtimePostgresChangesPayload<ICard>;
+export type CardChangeListener = (change: CardChange) => void;
+
+/**
+ * Releases one listener registration; calling it again does nothing
+ */
+export type ReleaseCardListener = () => Promise<void>;
+
+export interface CardRealtimeStats {
+  /** Open realtime channels, one per user */
+  channels: number;
+  /** Cards with at least one listener */
+  cards: number;
+  /** Registered listeners */
+  listeners: number;
+}
+
+interface UserChannel {
+  channel: RealtimeChannel;
+  listeners: Map<string, Set<CardChangeListener>>;
+  refs: number;
+}
+
+// One hub per client, so every Card model on a client shares its channels
+const hubs = new WeakMap<SupabaseClient, CardRealtimeHub>();
+
+export class CardRealtimeHub {
+  private readonly users = new Map<string, UserChannel>();
+
+  constructor(
+    private readonly supabase: SupabaseClient,
+    private readonly tableName: string = 'cards'
+  ) {}
+
+  public static forClient(supabase: SupabaseClient): CardRealtimeHub {
+    let hub = hubs.get(supabase);
+    if (!hub) {
+      hub = new CardRealtimeHub(supabase);
+      hubs.set(supabase, hub);
+    }
+    return hub;
+  }
+
+  /**
+   * Calls `listener` with each change to the card, opening the user's channel if
+   * this is their first listener
+   */
+  public subscribe(userId: string, cardId: string, listener: CardChangeListener): ReleaseCardListener {
+    let user = this.users.get(userId);
+    if (!user) {
+      user = { channel: this.open(userId), listeners: new Map(), refs: 0 };
+      this.users.set(userId, user);
+    }
+
+    let cardListeners = user.listeners.get(cardId);
+    if (!cardListeners) {
+      cardListeners = new Set();
+      user.listeners.set(cardId, cardListeners);
+    }
+    if (!cardListeners.has(listener)) {
+      cardListeners.add(listener);
+      user.refs++;
+    }
+
+    let released = false;
+    return async () => {
+      if (!released) {
+        released = true;
+        await this.release(userId, cardId, listener);
+      }
+    };
+  }
+
+  public getStats(): CardRealtimeStats {
+    let cards = 0;
+    let listeners = 0;
+    this.users.forEach((user) => {
+      cards += user.listeners.size;
+      listeners += user.refs;
+    });
+    return { channels: this.users.size, cards, listeners };
+  }
+
+  private async release(userId: string, cardId: string, listener: CardChangeListener): Promise<void> {
+    const user = this.users.get(userId);
+    const cardListeners = user?.listeners.get(cardId);
+    if (!user || !cardListeners?.delete(listener)) {
+      return;
+    }
+
+    user.refs--;
+    if (cardListeners.size === 0) {
+      user.listeners.delete(cardId);
+    }
+    if (user.refs === 0) {
+      this.users.delete(userId);
+      await this.supabase.removeChannel(user.channel);
+    }
+  }
+
+  private open(userId: string): RealtimeChannel {
+    return this.supabase
+      .channel(`cards-${userId}`)
+      .on(
+        'postgres_changes',
+        {
+          event: '*',
+          schema: 'public',
+          table: this.tableName,
+          // Filters name database columns; the table's replica identity is FULL, so old
+          // rows of updates and deletes are complete
+          filter: `user_id=eq.${userId}`
+        },
+        (payload: CardChange) => this.dispatch(userId, payload)
+      )
+      .subscribe();
+  }
+
+  private dispatch(userId: string, change: CardChange): void {
+    const cardId = (change.new as Partial<ICard>)?.id ?? (change.old as Partial<ICard>)?.id;
+    const listeners = cardId ? this.users.get(userId)?.listeners.get(cardId) : undefined;
+    // Copied so a listener can release itself while handling the change
+    [...(listeners ?? [])].forEach((listener) => listener(change));
+  }
+}
@@ -0,0 +1,319 @@
+/**
+ * @fileoverview Deck-local distractors for multiple-choice quiz questions.
+ * Card answers are typed (numbers, dates, names, terms, phrases) and indexed per user;
+ * wrong options are the answers of related cards of the same type: cards from the same
+ * source or with overlapping question words, and answers with a similar form. Numbers
+ * and dates the deck cannot cover are filled with nearby values. No LLM call is involved.
+ * @version 1.0.0
+ */
+
+import { jaccard, shingles } from './nearDuplicateIndex';
+
+export type AnswerType = 'number' | 'date' | 'name' | 'term' | 'phrase';
+
+export interface DeckCard {
+  id: string;
+  front: string;
+  back: string;
+  contentId?: string;
+  tags?: string[];
+}
+
+export interface IndexedAnswer {
+  /** Answer as shown in an option */
+  answer: string;
+  type: AnswerType;
+}
+
+interface Entry extends IndexedAnswer {
+  card: DeckCard;
+  normalized: string;
+  /** Type plus unit for numbers and form for dates, so '3 km' is not offered against '42%' */
+  group: string;
+  words: number;
+  /** Source, tags and question and answer terms; the postings this entry appears in */
+  keys: string[];
+  questionTerms: Uint32Array;
+  answerFeatures: Uint32Array;
+}
+
+// Longer backs are explanations, not options
+const MAX_OPTION_WORDS = 16;
+// Postings longer than this share of a group are too common to suggest relatedness
+const MAX_POSTING_SHARE = 0.2;
+const MIN_POSTING_LENGTH = 32;
+// Candidates scored per question; bounds the cost on large decks
+const MAX_CANDIDATES = 256;
+// Answers this similar to the correct one are rewordings, not distractors
+const MAX_ANSWER_SIMILARITY = 0.7;
+// Shorter answers, like 'o n' for O(n), may appear inside a different answer
+const MIN_CONTAINED_LENGTH = 4;
+
+const STOP_WORDS = new Set(['a', 'an', 'the', 'of', 'in', 'on', 'at', 'to', 'for', 'by', 'with', 'from', 'and', 'or',
+  'is', 'are', 'was', 'were', 'be', 'been', 'what', 'which', 'who', 'whom', 'whose', 'when', 'where', 'why', 'how',
+  'does', 'do', 'did', 'its', 'it', 'this', 'that', 'these', 'those', 'as', 'name', 'called', 'known', 'main']);
+const NAME_PARTICLES = new Set(['of', 'the', 'de', 'da', 'di', 'van', 'von', 'der', 'la', 'le', 'du', 'and', 'y']);
+
+const MONTHS = 'jan(?:uary)?|feb(?:ruary)?|mar(?:ch)?|apr(?:il)?|may|june?|july?|aug(?:ust)?|sep(?:t(?:ember)?)?|' +
+  'oct(?:ober)?|nov(?:ember)?|dec(?:ember)?';
+const YEAR = /^(?:c\.\s*|circa\s+)?(\d{1,4})(\s*(?:bce?|ad|ce))?$/i;
+const DATE = new RegExp(`^(?:\\d{1,2}(?:st|nd|rd|th)?\\s+(?:${MONTHS})\\.?,?\\s+\\d{1,4}|(?:${MONTHS})\\.?\\s+` +
+  '(?:\\d{1,2}(?:st|nd|rd|th)?,?\\s+)?\\d{3,4}|\\d{4}-\\d{2}-\\d{2})$', 'i');
+const NUMBER = /^([-+]?(?:\d{1,3}(?:,\d{3})+|\d+)(?:\.\d+)?)\s*([a-zA-Z%°µ/²³]{0,8})$/;
+const DATE_CUE = /^(?:when|(?:in |by )?what year|(?:in |by )?which year|in what century)\b/i;
+const NUMBER_CUE = /^(?:how (?:many|much|long|far|old|fast|big|large|high|deep)|what (?:percentage|proportion|number))\b/i;
+const NAME_CUE = /^(?:who|whom|whose|where)\b/i;
+const YEAR_OFFSETS = [-12, -7, -3, 2, 5, 9, 15, -20];
+const NUMBER_FACTORS = [0.5, 2, 1.5, 0.75, 3, 0.25];
+
+// FNV-1a, 32-bit; hashes terms into the sorted feature sets `jaccard` compares
+const hashTerm = (term: string): number => {
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < term.length; i++) {
+    hash ^= term.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return hash >>> 0;
+};
+
+const normalize = (text: string): string =>
+  text.normalize('NFKC').toLowerCase().replace(/[^\p{L}\p{N}]+/gu, ' ').trim();
+
+const contentTerms = (text: string): string[] =>
+  [...new Set(normalize(text).split(' ').filter((term) => term.length > 1 && !STOP_WORDS.has(term)))];
+
+const termFeatures = (terms: string[]): Uint32Array => {
+  const hashes = Uint32Array.from(terms, hashTerm).sort();
+  return hashes.filter((hash, i) => i === 0 || hash !== hashes[i - 1]);
+};
+
+/**
+ * Extracts the option text from a card back: markdown stripped, first sentence of
+ * a longer back, or null when even that is too long to serve as an option
+ */
+export const answerText = (back: string): string | null => {
+  const plain = back
+    .replace(/^#+\s*answer\s*$/gim, '')
+    .replace(/[#*_`>]+/g, ' ')
+    .replace(/\s+/g, ' ')
+    .trim();
+  const sentence = plain.split(' ').length > MAX_OPTION_WORDS ? plain.split(/(?<=[.!?])\s/)[0] : plain;
+  const answer = sentence.replace(/\.$/, '').trim();
+  if (!answer || answer.split(' ').length > MAX_OPTION_WORDS) {
+    return null;
+  }
+  return answer;
+};
+
+/**
+ * Types an answer by its form, using the question wording to settle bare numbers and names
+ */
+export const classifyAnswer = (front: string, answer: string): AnswerType => {
+  const question = front.replace(/^[#\s]+/, '');
+  const year = YEAR.exec(answer);
+  if (DATE.test(answer) || (year && (year[2] || (DATE_CUE.test(question) && !NUMBER_CUE.test(question))))) {
+    return 'date';
+  }
+  if (NUMBER.test(answer)) {
+    const value = Number(answer.replace(/,/g, ''));
+    return year && !NUMBER_CUE.test(question) && value >= 1000 && value <= 2100 ? 'date' : 'number';
+  }
+
+  const words = answer.split(/\s+/);
+  const capitalized = words.filter((word) => /^\p{Lu}/u.test(word));
+  const properNoun = words.length >= 2 && words.length <= 5 &&
+    words.every((word) => /^\p{Lu}/u.test(word) || NAME_PARTICLES.has(word)) && capitalized.length >= 2;
+  if (properNoun || (NAME_CUE.test(question) && words.length <= 5 && capitalized.length > 0)) {
+    return 'name';
+  }
+  return words.length <= 4 ? 'term' : 'phrase';
+};
+
+const formatLike = (template: string, value: number): string => {
+  const decimals = template.includes('.') ? template.split('.')[1].length : 0;
+  const fixed = Math.abs(value).toFixed(decimals);
+  const [whole, fraction] = fixed.split('.');
+  const grouped = template.includes(',') ? whole.replace(/\B(?=(\d{3})+(?!\d))/g, ',') : whole;
+  return `${value < 0 ? '-' : ''}${grouped}${fraction ? `.${fraction}` : ''}`;
+};
+
+/**
+ * Nearby values of the same form, for numeric and date answers the deck cannot cover
+ */
+const syntheticDistractors = (entry: Entry, seed: number): string[] => {
+  const { answer, type } = entry;
+  if (type === 'date') {
+    const year = /\d{3,4}(?!.*\d{3,4})/.exec(answer) ?? YEAR.exec(answer);
+    if (!year) {
+      return [];
+    }
+    const digits = year[0].match(/\d+/)?.[0] ?? '';
+    const value = Number(digits);
+    const latest = new Date().getFullYear();
+    return YEAR_OFFSETS
+      .map((_, i) => value + YEAR_OFFSETS[(i + seed) % YEAR_OFFSETS.length])
+      .filter((candidate) => candidate > 0 && (value > latest || candidate <= latest))
+      .map((candidate) => answer.replace(digits, String(candidate)));
+  }
+  if (type === 'number') {
+    const [, digits] = NUMBER.exec(answer) ?? [];
+    if (!digits) {
+      return [];
+    }
+    const value = Number(digits.replace(/,/g, ''));
+    return NUMBER_FACTORS
+      .map((_, i) => value * NUMBER_FACTORS[(i + seed) % NUMBER_FACTORS.length])
+      .map((candidate) => answer.replace(digits, formatLike(digits, digits.includes('.') ? candidate : Math.round(candidate))));
+  }
+  return [];
+};
+
+/**
+ * In-memory index of one user's card answers. Building it costs a pass over the deck;
+ * each lookup scores only candidates sharing a source, tag or term with the card.
+ */
+export class DistractorIndex {
+  private readonly entries: Entry[] = [];
+  private readonly byId = new Map<string, number>();
+  private readonly groups = new Map<string, number[]>();
+  // Group and term (or 'src:' / 'tag:' key) to entries
+  private readonly postings = new Map<string, number[]>();
+
+  constructor(cards: DeckCard[]) {
+    cards.forEach((card) => {
+      const answer = answerText(card.back);
+      if (!answer || this.byId.has(card.id)) {
+        return;
+      }
+      const type = classifyAnswer(card.front, answer);
+      const form = type === 'number'
+        ? (NUMBER.exec(answer)?.[2] ?? '').toLowerCase()
+        : type === 'date' && YEAR.test(answer) ? 'year' : '';
+      const questionTerms = contentTerms(card.front);
+      const normalized = normalize(answer);
+      const keys = [
+        ...(card.contentId ? [`src:${card.contentId}`] : []),
+        ...(card.tags ?? []).map((tag) => `tag:${tag}`),
+        ...questionTerms,
+        ...contentTerms(answer)
+      ];
+      const entry: Entry = {
+        card,
+        answer,
+        type,
+        normalized,
+        group: form ? `${type}:${form}` : type,
+        words: answer.split(' ').length,
+        keys: [...new Set(keys)],
+        questionTerms: termFeatures(questionTerms),
+        answerFeatures: shingles(normalized)
+      };
+
+      const index = this.entries.push(entry) - 1;
+      this.byId.set(card.id, index);
+      DistractorIndex.append(this.groups, entry.group, index);
+      entry.keys.forEach((key) => DistractorIndex.append(this.postings, `${entry.group}|${key}`, index));
+    });
+  }
+
+  public get size(): number {
+    return this.entries.length;
+  }
+
+  /**
+   * The option text and type of a card's answer, or undefined when the card has no usable answer
+   */
+  public answerFor(cardId: string): IndexedAnswer | undefined {
+    const index = this.byId.get(cardId);
+    if (index === undefined) {
+      return undefined;
+    }
+    const { answer, type } = this.entries[index];
+    return { answer, type };
+  }
+
+  /**
+   * Up to `count` plausible wrong options for a card, best first
+   */
+  public distractors(cardId: string, count = 3): string[] {
+    const index = this.byId.get(cardId);
+    if (index === undefined) {
+      return [];
+    }
+    const target = this.entries[index];
+    const group = this.groups.get(target.group) ?? [];
+
+    const candidates = new Set<number>();
+    const maxPosting = Math.max(MIN_POSTING_LENGTH, group.length * MAX_POSTING_SHARE);
+    for (const key of target.keys) {
+      const posting = this.postings.get(`${target.group}|${key}`);
+      if (posting && (posting.length <= maxPosting || key.startsWith('src:'))) {
+        for (let i = 0; i < posting.length && candidates.size < MAX_CANDIDATES; i++) {
+          candidates.add(posting[i]);
+        }
+      }
+    }
+    // Unrelated answers of the same type still beat no options; start at a card-dependent offset
+    for (let i = 0; candidates.size < Math.min(MAX_CANDIDATES, count * 8) && i < group.length; i++) {
+      candidates.add(group[(index + i * 7919) % group.length]);
+    }
+
+    const scored: Array<{ entry: Entry; score: number }> = [];
+    candidates.forEach((candidate) => {
+      const entry = this.entries[candidate];
+      if (candidate === index || !this.distinct(target, entry)) {
+        return;
+      }
+      scored.push({ entry, score: this.score(target, entry) });
+    });
+    scored.sort((a, b) => b.score - a.score);
+
+    const chosen: string[] = [];
+    const taken = [target.normalized];
+    const take = (answer: string) => {
+      const normalized = normalize(answer);
+      if (chosen.length < count && !taken.includes(normalized)) {
+        chosen.push(answer);
+        taken.push(normalized);
+      }
+    };
+    scored.forEach(({ entry }) => take(entry.answer));
+    syntheticDistractors(target, index).forEach(take);
+    return chosen;
+  }
+
+  // Question overlap dominates: answers to questions about the same thing are the plausible ones
+  private score(target: Entry, entry: Entry): number {
+    const semantic = target.questionTerms.length > 0 && entry.questionTerms.length > 0
+      ? jaccard(target.questionTerms, entry.questionTerms)
+      : 0;
+    const lexical = jaccard(target.answerFeatures, entry.answerFeatures);
+    const sameSource = target.card.contentId !== undefined && target.card.contentId === entry.card.contentId ? 1 : 0;
+    const sharedTags = (target.card.tags ?? []).some((tag) => entry.card.tags?.includes(tag)) ? 1 : 0;
+    const shape = Math.min(target.words, entry.words) / Math.max(target.words, entry.words);
+    return 2 * semantic + lexical + sameSource + 0.5 * sharedTags + 0.5 * shape;
+  }
+
+  // Rejects the same answer in other words, and answers that contain or are contained in it
+  private distinct(target: Entry, entry: Entry): boolean {
+    if (entry.normalized === target.normalized) {
+      return false;
+    }
+    const [shorter, longer] = entry.normalized.length < target.normalized.length
+      ? [entry.normalized, target.normalized]
+      : [target.normalized, entry.normalized];
+    if (shorter.length >= MIN_CONTAINED_LENGTH && ` ${longer} `.includes(` ${shorter} `)) {
+      return false;
+    }
+    return jaccard(target.answerFeatures, entry.answerFeatures) <= MAX_ANSWER_SIMILARITY;
+  }
+
+  private static append(map: Map<string, number[]>, key: string, index: number): void {
+    const posting = map.get(key);
+    if (posting) {
+      posting.push(index);
+    } else {
+      map.set(key, [index]);
+    }
+  }
+}
@@ -37,6 +37,18 @@ export class PerformanceMonitor {
   private readonly queueSize: Gauge;
   private readonly errorRate: Counter;
   private readonly cacheHitRatio: Gauge;
+  private readonly cacheLookups: Counter;
+  private readonly nativeSpanDuration: Histogram;
+  private readonly nativeSpansDropped: Counter;
+  private readonly pipelineStageDuration: Histogram;
+  private readonly pipelineQueueDepth: Gauge;
+  private readonly questionBankQuestions: Counter;
+  private readonly replicaLag: Gauge;
+  private readonly replicaAvailable: Gauge;
+  private readonly readRoutes: Counter;
+  private readonly eventLoopLag: Gauge;
+  private readonly admissions: Counter;
+  private readonly admissionQueueDepth: Gauge;
 
   // Active spans for tracing
   private readonly activeSpans: Map<string, SpanContext> = new Map();
@@ -96,6 +108,78 @@ export class PerformanceMonitor {
       labelNames: ['cache_name']
     });
 
+    this.cacheLookups = new Counter({
+      name: 'cache_lookups_total',
+      help: 'Cache lookups by outcome',
+      labelNames: ['cache_name', 'result']
+    });
+
+    this.nativeSpanDuration = new Histogram({
+      name: 'native_span_duration_seconds',
+      help: 'Duration of spans recorded by native clients in seconds',
+      labelNames: ['span', 'platform'],
+      buckets: [0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.25, 0.5, 1, 2.5]
+    });
+
+    this.nativeSpansDropped = new Counter({
+      name: 'native_spans_dropped_total',
+      help: 'Spans dropped on device because a trace ring was full',
+      labelNames: ['platform']
+    });
+
+    this.pipelineStageDuration = new Histogram({
+      name: 'pipeline_stage_duration_seconds',
+      help: 'Time spent by one item in a processing pipeline stage in seconds',
+      labelNames: ['pipeline', 'stage', 'outcome'],
+      buckets: [0.001, 0.01, 0.05, 0.1, 0.5, 1, 2, 5, 10, 20, 30]
+    });
+
+    this.pipelineQueueDepth = new Gauge({
+      name: 'pipeline_stage_items',
+      help: 'Items waiting for or held by a processing pipeline stage',
+      labelNames: ['pipeline', 'stage', 'state']
+    });
+
+    this.questionBankQuestions = new Counter({
+      name: 'question_bank_questions_total',
+      help: 'Quiz questions handled by question bank refreshes',
+      labelNames: ['result']
+    });
+
+    this.replicaLag = new Gauge({
+      name: 'db_replica_lag_seconds',
+      help: 'Replication lag of a read replica in seconds, as of its last status check',
+      labelNames: ['replica']
+    });
+
+    this.replicaAvailable = new Gauge({
+      name: 'db_replica_available',
+      help: 'Whether the last status check of a read replica succeeded',
+      labelNames: ['replica']
+    });
+
+    this.readRoutes = new Counter({
+      name: 'db_read_routes_total',
+      help: 'Read queries by where they were routed and why',
+      labelNames: ['target', 'route']
+    });
+
+    this.eventLoopLag = new Gauge({
+      name: 'event_loop_lag_seconds',
+      help: 'Worst event-loop delay in the last admission control sample window'
+    });
+
+    this.admissions = new Counter({
+      name: 'admission_decisions_total',
+      help: 'Requests admitted or rejected by admission control, by priority class',
+      labelNames: ['priority', 'outcome']
+    });
+
+    this.admissionQueueDepth = new Gauge({
+      name: 'admission_queue_depth',
+      help: 'Sheddable requests waiting for admission'
+    });
+
     // Start collecting default metrics
     this.startDefaultMetrics();
   }
@@ -188,6 +272,84 @@ export class PerformanceMonitor {
     this.cacheHitRatio.set({ cache_name: cacheName }, ratio);
   }
 
+  /**
+   * Count a cache lookup as a hit or miss
+   */
+  recordCacheLookup(cacheName: string, hit: boolean): void {
+    this.cacheLookups.inc({ cache_name: cacheName, result: hit ? 'hit' : 'miss' });
+  }
+
+  /**
+   * Record a span reported by a native client
+   */
+  recordNativeSpan(span: string, platform: string, durationSeconds: number): void {
+    this.nativeSpanDuration.observe({ span, platform }, durationSeconds);
+  }
+
+  /**
+   * Track spans dropped on device before upload
+   */
+  trackDroppedNativeSpans(platform: string, count: number): void {
+    if (count > 0) {
+      this.nativeSpansDropped.inc({ platform }, count);
+    }
+  }
+
+  /**
+   * Record the time one item spent in a pipeline stage
+   */
+  recordPipelineStage(pipeline: string, stage: string, durationSeconds: number, failed: boolean): void {
+    this.pipelineStageDuration.observe({ pipeline, stage, outcome: failed ? 'error' : 'ok' }, durationSeconds);
+  }
+
+  /**
+   * Track items queued for and running in a pipeline stage
+   */
+  trackPipelineQueue(pipeline: string, stage: string, waiting: number, active: number): void {
+    this.pipelineQueueDepth.set({ pipeline, stage, state: 'waiting' }, waiting);
+    this.pipelineQueueDepth.set({ pipeline, stage, state: 'active' }, active);
+  }
+
+  /**
+   * Count questions rebuilt and reused by one question bank refresh
+   */
+  trackQuestionBankRefresh(built: number, reused: number): void {
+    this.questionBankQuestions.inc({ result: 'built' }, built);
+    this.questionBankQuestions.inc({ result: 'reused' }, reused);
+  }
+
+  /**
+   * Track a read replica's lag; null when its status could not be read
+   */
+  trackReplicaLag(replica: string, lagSeconds: number | null): void {
+    this.replicaAvailable.set({ replica }, lagSeconds === null ? 0 : 1);
+    if (lagSeconds !== null) {
+      this.replicaLag.set({ replica }, lagSeconds);
+    }
+  }
+
+  /**
+   * Count a read query routed to a replica or, with the reason, to the primary
+   */
+  recordReadRoute(route: string): void {
+    this.readRoutes.inc({ target: route === 'replica' ? 'replica' : 'primary', route });
+  }
+
+  trackEventLoopLag(lagSeconds: number): void {
+    this.eventLoopLag.set(lagSeconds);
+  }
+
+  /**
+   * Count an admission decision; outcome is 'admitted' or the reason for rejection
+   */
+  recordAdmission(priority: string, outcome: string): void {
+    this.admissions.inc({ priority, outcome });
+  }
+
+  trackAdmissionQueue(depth: number): void {
+    this.admissionQueueDepth.set(depth);
+  }
+
   /**
    * Get current metrics
    */
@@ -0,0 +1,294 @@
+/**
+ * @fileoverview Per-worker admission control driven by event-loop delay.
+ * Every request carries a priority class. Critical requests are always admitted; normal
+ * ones up to a cap on requests in flight. Sheddable requests run only while the event
+ * loop keeps up and one of their few slots is free; otherwise they wait in a queue run
+ * like CoDel: while the queue keeps draining, a request may wait up to the interval, but
+ * once it has stood non-empty for a whole interval, waits are cut to the target delay.
+ * Requests that wait too long or find the queue full are rejected with a retry hint.
+ * @version 1.0.0
+ */
+
+import { monitorEventLoopDelay } from 'perf_hooks';
+import { performanceMonitor } from './PerformanceMonitor';
+
+const LAG_RESOLUTION_MS = 10;
+
+export type AdmissionPriority = 'critical' | 'normal' | 'sheddable';
+
+/**
+ * Why a request was rejected; exported as a metric label with 'admitted'
+ */
+export type AdmissionRejection = 'in_flight_limit' | 'queue_full' | 'queue_timeout' | 'cancelled';
+
+export interface AdmissionControllerOptions {
+  /** Worst event-loop delay in a sample window above which sheddable work waits */
+  maxLagMs?: number;
+  /** Sheddable requests one worker runs at a time */
+  maxSheddableInFlight?: number;
+  /** Requests in flight beyond which normal requests are rejected and sheddable ones wait */
+  maxInFlight?: number;
+  /** Longest wait once the queue has been standing for an interval */
+  targetDelayMs?: number;
+  /** Longest wait while the queue drains, and how long it may stand before waits are cut */
+  intervalMs?: number;
+  maxQueueLength?: number;
+  /** How often event-loop delay is sampled and the queue rechecked */
+  sampleIntervalMs?: number;
+  /** Returns the worst event-loop delay since the last call; defaults to a perf_hooks histogram */
+  readLagMs?: () => number;
+}
+
+export interface AdmissionStats {
+  lagMs: number;
+  inFlight: number;
+  sheddableInFlight: number;
+  queued: number;
+  admitted: Record<AdmissionPriority, number>;
+  /** Sheddable requests admitted after waiting in the queue */
+  admittedFromQueue: number;
+  rejected: Record<AdmissionPriority, number>;
+}
+
+/**
+ * Thrown to a request that is not admitted; it should be retried after `retryAfterSeconds`
+ */
+export class AdmissionRejectedError extends Error {
+  constructor(
+    public readonly priority: AdmissionPriority,
+    public readonly reason: AdmissionRejection,
+    public readonly retryAfterSeconds: number
+  ) {
+    super(`Request not admitted: ${reason}`);
+    this.name = 'AdmissionRejectedError';
+  }
+}
+
+/**
+ * Ends an admitted request's hold on its slot; later calls are ignored
+ */
+export type ReleaseAdmission = () => void;
+
+interface QueuedRequest {
+  enqueuedAt: number;
+  admit: (release: ReleaseAdmission) => void;
+  reject: (error: AdmissionRejectedError) => void;
+  timer: NodeJS.Timeout;
+}
+
+const countsByPriority = (): Record<AdmissionPriority, number> => ({ critical: 0, normal: 0, sheddable: 0 });
+
+const histogramLag = (): (() => number) => {
+  const histogram = monitorEventLoopDelay({ resolution: LAG_RESOLUTION_MS });
+  histogram.enable();
+  return () => {
+    // Delays are recorded in nanoseconds and include the sampling resolution
+    const lagMs = Math.max(0, histogram.max / 1e6 - LAG_RESOLUTION_MS);
+    histogram.reset();
+    return lagMs;
+  };
+};
+
+export class AdmissionController {
+  private readonly maxLagMs: number;
+  private readonly maxSheddableInFlight: number;
+  private readonly maxInFlight: number;
+  private readonly targetDelayMs: number;
+  private readonly intervalMs: number;
+  private readonly maxQueueLength: number;
+  private readonly sampleIntervalMs: number;
+  private readonly readLagMsOption?: () => number;
+  private readLagMs: (() => number) | null = null;
+  private readonly queue: QueuedRequest[] = [];
+  // When the queue last went from empty to non-empty
+  private queuedSince = 0;
+  private sampleTimer: NodeJS.Timeout | null = null;
+  private readonly stats: AdmissionStats;
+
+  constructor(options: AdmissionControllerOptions = {}) {
+    this.maxLagMs = options.maxLagMs ?? 50;
+    this.maxSheddableInFlight = options.maxSheddableInFlight ?? 4;
+    this.maxInFlight = options.maxInFlight ?? 256;
+    this.targetDelayMs = options.targetDelayMs ?? 50;
+    this.intervalMs = options.intervalMs ?? 500;
+    this.maxQueueLength = options.maxQueueLength ?? 64;
+    this.sampleIntervalMs = options.sampleIntervalMs ?? 100;
+    this.readLagMsOption = options.readLagMs;
+    this.stats = {
+      lagMs: 0,
+      inFlight: 0,
+      sheddableInFlight: 0,
+      queued: 0,
+      admitted: countsByPriority(),
+      admittedFromQueue: 0,
+      rejected: countsByPriority()
+    };
+  }
+
+  /**
+   * Builds the controller from ADMISSION_* variables and starts sampling
+   */
+  public static fromEnv(): AdmissionController {
+    const controller = new AdmissionController({
+      maxLagMs: Number(process.env.ADMISSION_MAX_LAG_MS) || undefined,
+      maxSheddableInFlight: Number(process.env.ADMISSION_MAX_SHEDDABLE_IN_FLIGHT) || undefined,
+      maxInFlight: Number(process.env.ADMISSION_MAX_IN_FLIGHT) || undefined
+    });
+    controller.start();
+    return controller;
+  }
+
+  /**
+   * Admits a request now, after it waits its turn, or not at all
+   * @param signal Aborting it, when the client goes away, gives up a place in the queue
+   * @throws {AdmissionRejectedError} If the request is not admitted
+   */
+  public admit(priority: AdmissionPriority, signal?: AbortSignal): Promise<ReleaseAdmission> {
+    if (priority === 'critical') {
+      return Promise.resolve(this.enter(priority));
+    }
+    if (priority === 'normal') {
+      return this.stats.inFlight < this.maxInFlight
+        ? Promise.resolve(this.enter(priority))
+        : Promise.reject(this.reject(priority, 'in_flight_limit'));
+    }
+
+    if (this.queue.length === 0 && this.canRunSheddable()) {
+      return Promise.resolve(this.enter(priority));
+    }
+    if (this.queue.length >= this.maxQueueLength) {
+      return Promise.reject(this.reject(priority, 'queue_full'));
+    }
+
+    return new Promise<ReleaseAdmission>((resolve, reject) => {
+      const now = Date.now();
+      if (this.queue.length === 0) {
+        this.queuedSince = now;
+      }
+      const request: QueuedRequest = {
+        enqueuedAt: now,
+        admit: resolve,
+        reject,
+        // Sheds the request on time even if nothing else drains the queue
+        timer: setTimeout(() => this.drain(), this.intervalMs + 1)
+      };
+      this.queue.push(request);
+      this.trackQueue();
+
+      signal?.addEventListener('abort', () => {
+        const index = this.queue.indexOf(request);
+        if (index >= 0) {
+          this.queue.splice(index, 1);
+          clearTimeout(request.timer);
+          this.trackQueue();
+          reject(this.reject(priority, 'cancelled'));
+        }
+      }, { once: true });
+    });
+  }
+
+  public start(): void {
+    if (this.sampleTimer) {
+      return;
+    }
+    this.readLagMs = this.readLagMsOption ?? histogramLag();
+    this.sampleTimer = setInterval(() => this.sample(), this.sampleIntervalMs);
+    this.sampleTimer.unref();
+  }
+
+  public stop(): void {
+    if (this.sampleTimer) {
+      clearInterval(this.sampleTimer);
+      this.sampleTimer = null;
+    }
+  }
+
+  /**
+   * Reads event-loop delay once and admits or sheds queued requests accordingly
+   */
+  public sample(): void {
+    const readLagMs = this.readLagMs ?? this.readLagMsOption;
+    if (readLagMs) {
+      this.stats.lagMs = readLagMs();
+      performanceMonitor.trackEventLoopLag(this.stats.lagMs / 1000);
+    }
+    this.drain();
+  }
+
+  public getStats(): AdmissionStats {
+    return {
+      ...this.stats,
+      queued: this.queue.length,
+      admitted: { ...this.stats.admitted },
+      rejected: { ...this.stats.rejected }
+    };
+  }
+
+  private canRunSheddable(): boolean {
+    return this.stats.sheddableInFlight < this.maxSheddableInFlight &&
+      this.stats.inFlight < this.maxInFlight &&
+      this.stats.lagMs <= this.maxLagMs;
+  }
+
+  /**
+   * Sheds queued requests past their allowed wait, oldest first, then admits as many
+   * as there is room for
+   */
+  private drain(): void {
+    while (this.queue.length > 0) {
+      const now = Date.now();
+      const standing = now - this.queuedSince > this.intervalMs;
+      const maxWaitMs = standing ? this.targetDelayMs : this.intervalMs;
+      const head = this.queue[0];
+
+      if (now - head.enqueuedAt > maxWaitMs) {
+        this.queue.shift();
+        clearTimeout(head.timer);
+        head.reject(this.reject('sheddable', 'queue_timeout'));
+        continue;
+      }
+      if (!this.canRunSheddable()) {
+        break;
+      }
+      this.queue.shift();
+      clearTimeout(head.timer);
+      this.stats.admittedFromQueue++;
+      head.admit(this.enter('sheddable'));
+    }
+    this.trackQueue();
+  }
+
+  private enter(priority: AdmissionPriority): ReleaseAdmission {
+    this.stats.inFlight++;
+    if (priority === 'sheddable') {
+      this.stats.sheddableInFlight++;
+    }
+    this.stats.admitted[priority]++;
+    performanceMonitor.recordAdmission(priority, 'admitted');
+
+    let released = false;
+    return () => {
+      if (released) {
+        return;
+      }
+      released = true;
+      this.stats.inFlight--;
+      if (priority === 'sheddable') {
+        this.stats.sheddableInFlight--;
+      }
+      this.drain();
+    };
+  }
+
+  private reject(priority: AdmissionPriority, reason: AdmissionRejection): AdmissionRejectedError {
+    this.stats.rejected[priority]++;
+    performanceMonitor.recordAdmission(priority, reason);
+    // Long enough for a standing queue to drain, and for the loop to catch up
+    const retryAfterSeconds = Math.max(1, Math.ceil((this.intervalMs + this.stats.lagMs) / 1000));
+    return new AdmissionRejectedError(priority, reason, retryAfterSeconds);
+  }
+
+  private trackQueue(): void {
+    performanceMonitor.trackAdmissionQueue(this.queue.length);
+  }
+}
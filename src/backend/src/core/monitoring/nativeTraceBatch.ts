@@ -0,0 +1,129 @@
+/**
+ * @fileoverview Decoder for binary trace batches uploaded by the native iOS trace ring
+ * (src/ios/membo/Utils/TraceRing.h). Shared by the telemetry ingestion route and the
+ * offline decode-traces script.
+ * @version 1.0.0
+ */
+
+/** Batch header magic ("MBTR" little-endian) */
+export const TRACE_BATCH_MAGIC = 0x5254424d;
+export const TRACE_BATCH_VERSION = 1;
+export const TRACE_BATCH_HEADER_SIZE = 32;
+export const TRACE_BATCH_RECORD_SIZE = 24;
+
+/**
+ * Span identifiers, kept in sync with MBTraceSpan on iOS.
+ * Unknown identifiers decode as `unknown_<id>` so newer clients never fail ingestion.
+ */
+export const NATIVE_SPAN_NAMES: Readonly<Record<number, string>> = {
+  1: 'voice_start',
+  2: 'voice_stop',
+  3: 'audio_configure',
+  4: 'audio_activate',
+  5: 'audio_deactivate',
+  6: 'file_write',
+  7: 'file_read',
+  8: 'voice_recording_save',
+  9: 'study_session_start',
+  10: 'study_queue_load'
+};
+
+export interface NativeTraceSpan {
+  /** Span name from NATIVE_SPAN_NAMES */
+  name: string;
+  /** Raw span identifier */
+  spanId: number;
+  /** Per-device thread index */
+  thread: number;
+  /** Monotonic start time in nanoseconds */
+  startNs: bigint;
+  /** Duration in nanoseconds */
+  durationNs: bigint;
+  /** Wall-clock start time derived from the batch clock pair */
+  startedAt: Date;
+  /** Span-specific argument (byte count, success flag, card count) */
+  arg: number;
+}
+
+export interface NativeTraceBatch {
+  version: number;
+  droppedCount: number;
+  drainedAt: Date;
+  spans: NativeTraceSpan[];
+}
+
+/**
+ * Error raised for batches that do not match the wire format
+ */
+export class TraceBatchError extends Error {
+  constructor(message: string) {
+    super(message);
+    this.name = 'TraceBatchError';
+  }
+}
+
+/**
+ * Resolves a span identifier to its metric label
+ */
+export const nativeSpanName = (spanId: number): string =>
+  NATIVE_SPAN_NAMES[spanId] ?? `unknown_${spanId}`;
+
+/**
+ * Decodes a binary trace batch.
+ * @param buffer Raw request body
+ * @throws TraceBatchError when the header or length is inconsistent
+ */
+export const decodeTraceBatch = (buffer: Buffer): NativeTraceBatch => {
+  if (buffer.length < TRACE_BATCH_HEADER_SIZE) {
+    throw new TraceBatchError('Batch shorter than header');
+  }
+  if (buffer.readUInt32LE(0) !== TRACE_BATCH_MAGIC) {
+    throw new TraceBatchError('Invalid batch magic');
+  }
+
+  const version = buffer.readUInt16LE(4);
+  if (version !== TRACE_BATCH_VERSION) {
+    throw new TraceBatchError(`Unsupported batch version ${version}`);
+  }
+
+  const recordSize = buffer.readUInt16LE(6);
+  if (recordSize < TRACE_BATCH_RECORD_SIZE) {
+    throw new TraceBatchError(`Invalid record size ${recordSize}`);
+  }
+
+  const recordCount = buffer.readUInt32LE(8);
+  const droppedCount = buffer.readUInt32LE(12);
+  if (buffer.length !== TRACE_BATCH_HEADER_SIZE + recordCount * recordSize) {
+    throw new TraceBatchError('Batch length does not match record count');
+  }
+
+  const drainedAtMs = buffer.readBigUInt64LE(16);
+  const drainedAtNs = buffer.readBigUInt64LE(24);
+
+  const spans: NativeTraceSpan[] = new Array(recordCount);
+  for (let i = 0; i < recordCount; i++) {
+    const offset = TRACE_BATCH_HEADER_SIZE + i * recordSize;
+    const startNs = buffer.readBigUInt64LE(offset);
+    const spanId = buffer.readUInt16LE(offset + 16);
+
+    // Map the monotonic start onto wall-clock time using the drain clock pair
+    const ageMs = Number(drainedAtNs - startNs) / 1e6;
+
+    spans[i] = {
+      name: nativeSpanName(spanId),
+      spanId,
+      thread: buffer.readUInt16LE(offset + 18),
+      startNs,
+      durationNs: buffer.readBigUInt64LE(offset + 8),
+      startedAt: new Date(Number(drainedAtMs) - ageMs),
+      arg: buffer.readUInt32LE(offset + 20)
+    };
+  }
+
+  return {
+    version,
+    droppedCount,
+    drainedAt: new Date(Number(drainedAtMs)),
+    spans
+  };
+};
@@ -0,0 +1,198 @@
+/**
+ * @fileoverview Staged processing pipeline with per-stage worker pools.
+ * Each stage owns a bounded input queue and a fixed number of workers. Items may
+ * fan out into several items for the next stage, and a worker whose output does not
+ * fit downstream holds its slot until it does, so backpressure reaches the submitter.
+ * @version 1.0.0
+ */
+
+export interface PipelineStage<I = any, O = any> {
+  name: string;
+  /** Items processed at once by this stage */
+  concurrency: number;
+  /** Items waiting for a worker before upstream stages block; defaults to 2 × concurrency */
+  queueLimit?: number;
+  /** When set, `run` returns an array whose elements continue as separate items */
+  fanOut?: boolean;
+  run: (item: I) => Promise<O>;
+}
+
+export interface PipelineObserver {
+  stageCompleted(stage: string, durationMs: number, failed: boolean): void;
+  queueDepth(stage: string, waiting: number, active: number): void;
+}
+
+export interface StageStats {
+  waiting: number;
+  active: number;
+  completed: number;
+  failed: number;
+}
+
+interface PipelineJob {
+  pending: number;
+  failed: boolean;
+  results: Array<{ order: number[]; value: unknown }>;
+  resolve: (results: unknown[]) => void;
+  reject: (error: Error) => void;
+}
+
+interface Envelope {
+  job: PipelineJob;
+  item: unknown;
+  /** Fan-out index at each stage, used to return results in input order */
+  order: number[];
+}
+
+const compareOrder = (a: number[], b: number[]): number => {
+  for (let i = 0; i < Math.min(a.length, b.length); i++) {
+    if (a[i] !== b[i]) {
+      return a[i] - b[i];
+    }
+  }
+  return a.length - b.length;
+};
+
+class StageRunner {
+  private readonly queue: Envelope[] = [];
+  private readonly spaceWaiters: Array<() => void> = [];
+  private readonly queueLimit: number;
+  private active = 0;
+  private completed = 0;
+  private failed = 0;
+
+  constructor(
+    private readonly stage: PipelineStage,
+    private readonly next: StageRunner | null,
+    private readonly observer?: PipelineObserver
+  ) {
+    if (!Number.isInteger(stage.concurrency) || stage.concurrency < 1) {
+      throw new Error(`Stage ${stage.name} concurrency must be a positive integer`);
+    }
+    this.queueLimit = stage.queueLimit ?? stage.concurrency * 2;
+  }
+
+  /**
+   * Enqueues an item, waiting while the queue is full
+   */
+  async push(envelope: Envelope): Promise<void> {
+    while (this.queue.length >= this.queueLimit) {
+      await new Promise<void>((resolve) => this.spaceWaiters.push(resolve));
+    }
+    this.queue.push(envelope);
+    this.reportDepth();
+    this.pump();
+  }
+
+  stats(): StageStats {
+    return { waiting: this.queue.length, active: this.active, completed: this.completed, failed: this.failed };
+  }
+
+  private pump(): void {
+    while (this.active < this.stage.concurrency && this.queue.length > 0) {
+      const envelope = this.queue.shift()!;
+      this.active++;
+      this.spaceWaiters.shift()?.();
+      void this.execute(envelope).finally(() => {
+        this.active--;
+        this.reportDepth();
+        this.pump();
+      });
+    }
+  }
+
+  private async execute({ job, item, order }: Envelope): Promise<void> {
+    if (job.failed) {
+      job.pending--;
+      return;
+    }
+
+    const started = Date.now();
+    let output: unknown;
+    try {
+      output = await this.stage.run(item);
+      this.completed++;
+      this.observer?.stageCompleted(this.stage.name, Date.now() - started, false);
+    } catch (error) {
+      this.failed++;
+      this.observer?.stageCompleted(this.stage.name, Date.now() - started, true);
+      job.pending--;
+      if (!job.failed) {
+        job.failed = true;
+        job.reject(error instanceof Error ? error : new Error(String(error)));
+      }
+      return;
+    }
+
+    const outputs = this.stage.fanOut ? (output as unknown[]) : [output];
+    job.pending += outputs.length;
+    for (const [index, value] of outputs.entries()) {
+      const childOrder = this.stage.fanOut ? [...order, index] : order;
+      if (this.next) {
+        // Holding this worker until downstream has room is what propagates backpressure
+        await this.next.push({ job, item: value, order: childOrder });
+      } else {
+        job.results.push({ order: childOrder, value });
+        job.pending--;
+      }
+    }
+
+    // Whichever stage finishes a job's last item resolves it
+    job.pending--;
+    if (job.pending === 0 && !job.failed) {
+      job.resolve(job.results.sort((a, b) => compareOrder(a.order, b.order)).map((result) => result.value));
+    }
+  }
+
+  private reportDepth(): void {
+    this.observer?.queueDepth(this.stage.name, this.queue.length, this.active);
+  }
+}
+
+/**
+ * Runs inputs through a linear chain of stages. Items of one input are processed
+ * independently and in parallel across stages; the returned promise resolves with
+ * the final stage's outputs in input order once every item has finished.
+ */
+export class StagedPipeline<I, O> {
+  private readonly runners: StageRunner[];
+
+  constructor(
+    private readonly stages: PipelineStage[],
+    observer?: PipelineObserver
+  ) {
+    if (stages.length === 0) {
+      throw new Error('Pipeline requires at least one stage');
+    }
+    const runners: StageRunner[] = [];
+    let next: StageRunner | null = null;
+    for (let i = stages.length - 1; i >= 0; i--) {
+      next = new StageRunner(stages[i], next, observer);
+      runners.unshift(next);
+    }
+    this.runners = runners;
+  }
+
+  /**
+   * Processes one input. Resolves once the input has been admitted and all of
+   * its items have left the final stage; rejects on the first stage failure.
+   */
+  async process(input: I): Promise<O[]> {
+    let job!: PipelineJob;
+    const done = new Promise<O[]>((resolve, reject) => {
+      job = {
+        pending: 1,
+        failed: false,
+        results: [],
+        resolve: resolve as (results: unknown[]) => void,
+        reject
+      };
+    });
+    await this.runners[0].push({ job, item: input, order: [] });
+    return done;
+  }
+
+  getStats(): Record<string, StageStats> {
+    return Object.fromEntries(this.stages.map((stage, i) => [stage.name, this.runners[i].stats()]));
+  }
+}
@@ -8,8 +8,26 @@
 import { IStudySession, IStudyPerformance } from '../../interfaces/IStudySession';
 import { FSRSAlgorithm } from './FSRSAlgorithm';
 import { CardScheduler } from './cardScheduler';
+import { StudyModes } from '../../constants/studyModes';
+import { getServices } from '../../config/services';
+import { QueryRouter } from '../../services/QueryRouter';
 import dayjs from 'dayjs'; // ^1.11.0
 
+/**
+ * Stored study session row
+ */
+interface StudySessionRow {
+    id: string;
+    user_id: string;
+    mode: string;
+    cards_studied: string[];
+    status: IStudySession['status'];
+    performance: IStudyPerformance;
+    settings: IStudySession['settings'];
+    start_time: string;
+    end_time: string | null;
+}
+
 /**
  * Interface for enhanced performance metrics including voice mode and streak analysis
  */
@@ -44,11 +62,13 @@ export class PerformanceAnalyzer {
     private readonly performanceCache: Map<string, IEnhancedPerformance>;
     private readonly targetRetentionRate: number = 0.85;
     private readonly minStreakDays: number = 14;
+    private readonly queryRouter?: QueryRouter;
 
-    constructor(fsrsAlgorithm: FSRSAlgorithm, cardScheduler: CardScheduler) {
+    constructor(fsrsAlgorithm: FSRSAlgorithm, cardScheduler: CardScheduler, queryRouter?: QueryRouter) {
         this.fsrsAlgorithm = fsrsAlgorithm;
         this.cardScheduler = cardScheduler;
         this.performanceCache = new Map();
+        this.queryRouter = queryRouter;
     }
 
     /**
@@ -260,17 +280,44 @@ export class PerformanceAnalyzer {
     }
 
     /**
-     * Retrieves and processes user's streak history
+     * Retrieves and processes user's streak history from completed sessions
      */
     private async getStreakHistory(userId: string): Promise<{
         currentStreak: number;
         longestStreak: number;
     }> {
-        // Mock implementation - replace with actual database query
-        return {
-            currentStreak: 15,
-            longestStreak: 30
-        };
+        // Analytics reads are served by a replica when it has the user's latest writes
+        const { data, error } = await this.router().read(userId, (db) => db
+            .from('study_sessions')
+            .select('start_time')
+            .eq('user_id', userId)
+            .eq('status', 'completed')
+            .order('start_time', { ascending: false }));
+
+        if (error) throw new Error(`Failed to fetch streak history: ${error.message}`);
+
+        // Distinct study days, most recent first
+        const days = [...new Set((data as Pick<StudySessionRow, 'start_time'>[])
+            .map((row) => dayjs(row.start_time).startOf('day').valueOf()))];
+
+        let longestStreak = 0;
+        let run = 0;
+        days.forEach((day, index) => {
+            run = index > 0 && dayjs(days[index - 1]).subtract(1, 'day').valueOf() === day ? run + 1 : 1;
+            longestStreak = Math.max(longestStreak, run);
+        });
+
+        // The current streak may end today or yesterday
+        let currentStreak = 0;
+        if (days.length > 0 && dayjs().startOf('day').diff(days[0], 'day') <= 1) {
+            currentStreak = 1;
+            while (currentStreak < days.length &&
+                dayjs(days[currentStreak - 1]).subtract(1, 'day').valueOf() === days[currentStreak]) {
+                currentStreak++;
+            }
+        }
+
+        return { currentStreak, longestStreak };
     }
 
     /**
@@ -281,7 +328,34 @@ export class PerformanceAnalyzer {
         startDate: Date,
         endDate: Date
     ): Promise<IStudySession[]> {
-        // Mock implementation - replace with actual database query
-        return [];
+        const { data, error } = await this.router().read(userId, (db) => db
+            .from('study_sessions')
+            .select('id, user_id, mode, cards_studied, status, performance, settings, start_time, end_time')
+            .eq('user_id', userId)
+            .gte('start_time', startDate.toISOString())
+            .lte('start_time', endDate.toISOString())
+            .order('start_time', { ascending: true }));
+
+        if (error) throw new Error(`Failed to fetch study sessions: ${error.message}`);
+
+        return (data as StudySessionRow[]).map((row) => {
+            const mode = row.mode.toLowerCase() as StudyModes;
+            return {
+                id: row.id,
+                userId: row.user_id,
+                mode,
+                startTime: new Date(row.start_time),
+                endTime: row.end_time ? new Date(row.end_time) : new Date(row.start_time),
+                cardsStudied: row.cards_studied,
+                performance: row.performance,
+                voiceEnabled: mode === StudyModes.VOICE,
+                status: row.status,
+                settings: row.settings
+            };
+        });
+    }
+
+    private router(): QueryRouter {
+        return this.queryRouter ?? getServices().queryRouter;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,9 @@
+/**
+ * @fileoverview Worker thread entry for the shared CPU task pool.
+ * @version 1.0.0
+ */
+
+import { CPU_TASKS } from './cpuTasks';
+import { serveTasks } from './workerPool';
+
+serveTasks(CPU_TASKS);
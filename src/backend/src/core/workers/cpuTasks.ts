@@ -0,0 +1,87 @@
+/**
+ * @fileoverview CPU-bound tasks that may run on the shared worker pool.
+ * Inputs below INLINE_TASK_BYTES run on the calling thread, where posting the task
+ * would cost more than running it. Tasks return strings: results that are large object
+ * graphs, such as parsed JSON, cost more to clone back than to build on the calling thread.
+ * @version 1.0.0
+ */
+
+import { createHash } from 'crypto';
+import path from 'path';
+import { TaskOptions, WorkerPool } from './workerPool';
+
+export const INLINE_TASK_BYTES = 64 * 1024;
+
+/**
+ * Task handlers, shared by the worker file and the inline path. Validation and
+ * encryption load on first use, so a worker that never sees them does not need
+ * their configuration.
+ */
+export const CPU_TASKS = {
+  sha256: (data: ArrayBuffer): string =>
+    createHash('sha256').update(new Uint8Array(data)).digest('hex'),
+  sanitize: ({ input, options }: { input: string; options: Record<string, boolean> }): string =>
+    require('../../utils/validation').sanitizeInput(input, options),
+  encrypt: (data: string): string =>
+    require('../../utils/encryption').encrypt(data),
+  decrypt: (data: string): string =>
+    require('../../utils/encryption').decrypt(data)
+};
+
+export type CpuTaskName = keyof typeof CPU_TASKS;
+
+let pool: WorkerPool | null = null;
+
+/**
+ * Workers requested by CPU_POOL_SIZE; anything but a positive integer leaves the pool default
+ */
+const poolSize = (): number | undefined => {
+  const size = Number(process.env.CPU_POOL_SIZE);
+  return Number.isInteger(size) && size > 0 ? size : undefined;
+};
+
+/**
+ * Process-wide pool, started on the first offloaded task. CPU_POOL_SIZE=0 keeps all
+ * tasks on the calling thread.
+ */
+export const cpuPool = (): WorkerPool => {
+  if (!pool) {
+    // The worker file has this file's extension: .ts under tsx, .js once built
+    pool = new WorkerPool(path.join(__dirname, `cpuTaskWorker${path.extname(__filename)}`), {
+      size: poolSize()
+    });
+  }
+  return pool;
+};
+
+/**
+ * Runs a task on the pool when its input is large enough to be worth the trip
+ * @param name Task name
+ * @param payload Task input
+ * @param size Input size in bytes, compared against INLINE_TASK_BYTES
+ * @param options Priority and buffers to transfer
+ */
+export const runCpuTask = async <N extends CpuTaskName>(
+  name: N,
+  payload: Parameters<typeof CPU_TASKS[N]>[0],
+  size: number,
+  options: TaskOptions = {}
+): Promise<ReturnType<typeof CPU_TASKS[N]>> => {
+  if (size < INLINE_TASK_BYTES || process.env.CPU_POOL_SIZE === '0') {
+    return (CPU_TASKS[name] as (input: typeof payload) => ReturnType<typeof CPU_TASKS[N]>)(payload);
+  }
+  return cpuPool().run(name, payload, options);
+};
+
+/**
+ * SHA-256 of a buffer the caller keeps using; large buffers are copied to the worker
+ * @param data Bytes to hash
+ * @returns Hex digest
+ */
+export const sha256Hex = async (data: Buffer): Promise<string> => {
+  if (data.byteLength < INLINE_TASK_BYTES) {
+    return createHash('sha256').update(data).digest('hex');
+  }
+  const copy = data.buffer.slice(data.byteOffset, data.byteOffset + data.byteLength) as ArrayBuffer;
+  return runCpuTask('sha256', copy, data.byteLength, { transfer: [copy] });
+};
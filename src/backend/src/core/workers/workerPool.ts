@@ -0,0 +1,235 @@
+/**
+ * @fileoverview Shared worker-thread pool for CPU-bound work.
+ * Tasks are named and run by handlers registered in the worker file. Interactive tasks
+ * are dispatched before background ones, and when the queue backs up several tasks
+ * travel to a worker in one message. ArrayBuffers listed in `transfer` move to the
+ * worker without a copy.
+ * @version 1.0.0
+ */
+
+import { availableParallelism } from 'os';
+import { parentPort, TransferListItem, Worker } from 'worker_threads';
+
+export type TaskPriority = 'interactive' | 'background';
+
+export interface WorkerPoolOptions {
+  /** Worker threads; defaults to one per core, leaving one core for the event loop */
+  size?: number;
+  /** Most tasks sent to one worker in a single message */
+  maxBatchSize?: number;
+}
+
+export interface TaskOptions {
+  priority?: TaskPriority;
+  /** Buffers moved to the worker; they are detached in the caller once the task is queued */
+  transfer?: TransferListItem[];
+}
+
+export interface WorkerPoolStats {
+  workers: number;
+  queued: number;
+  active: number;
+  completed: number;
+  failed: number;
+  batches: number;
+}
+
+export type TaskHandlers = Record<string, (payload: any) => unknown>;
+
+interface TaskRequest {
+  id: number;
+  name: string;
+  payload: unknown;
+}
+
+interface TaskResponse {
+  id: number;
+  result?: unknown;
+  error?: string;
+}
+
+interface QueuedTask extends TaskRequest {
+  transfer: TransferListItem[];
+  resolve: (result: any) => void;
+  reject: (error: Error) => void;
+}
+
+interface PoolWorker {
+  worker: Worker;
+  inFlight: Map<number, QueuedTask>;
+}
+
+const DEFAULT_MAX_BATCH_SIZE = 16;
+
+/**
+ * Runs named tasks on a fixed set of lazily started worker threads
+ */
+export class WorkerPool {
+  private readonly queues: Record<TaskPriority, QueuedTask[]> = { interactive: [], background: [] };
+  private readonly workers: PoolWorker[] = [];
+  private readonly size: number;
+  private readonly maxBatchSize: number;
+  private nextId = 1;
+  private closed = false;
+  private completed = 0;
+  private failed = 0;
+  private batches = 0;
+
+  constructor(private readonly filename: string, options: WorkerPoolOptions = {}) {
+    // A size that is not a number would leave the pool without workers and tasks waiting forever
+    const size = Number.isFinite(options.size) ? Math.floor(options.size!) : availableParallelism() - 1;
+    this.size = Math.max(1, size);
+    this.maxBatchSize = Math.max(1, options.maxBatchSize ?? DEFAULT_MAX_BATCH_SIZE);
+  }
+
+  /**
+   * Queues a task for the next free worker
+   * @param name Handler name registered in the worker file
+   * @param payload Structured-clonable task input
+   * @param options Priority and buffers to transfer
+   * @returns Handler result
+   */
+  run<T = unknown>(name: string, payload: unknown, options: TaskOptions = {}): Promise<T> {
+    if (this.closed) {
+      return Promise.reject(new Error('Worker pool is closed'));
+    }
+    return new Promise<T>((resolve, reject) => {
+      this.queues[options.priority ?? 'interactive'].push({
+        id: this.nextId++,
+        name,
+        payload,
+        transfer: options.transfer ?? [],
+        resolve,
+        reject
+      });
+      this.dispatch();
+    });
+  }
+
+  getStats(): WorkerPoolStats {
+    return {
+      workers: this.workers.length,
+      queued: this.queues.interactive.length + this.queues.background.length,
+      active: this.workers.reduce((sum, entry) => sum + entry.inFlight.size, 0),
+      completed: this.completed,
+      failed: this.failed,
+      batches: this.batches
+    };
+  }
+
+  /**
+   * Rejects queued tasks and stops all workers
+   */
+  async close(): Promise<void> {
+    this.closed = true;
+    const error = new Error('Worker pool is closed');
+    [...this.queues.interactive.splice(0), ...this.queues.background.splice(0)].forEach((task) => task.reject(error));
+    await Promise.all(this.workers.splice(0).map((entry) => {
+      entry.inFlight.forEach((task) => task.reject(error));
+      return entry.worker.terminate();
+    }));
+  }
+
+  private dispatch(): void {
+    while (this.queues.interactive.length + this.queues.background.length > 0) {
+      const entry = this.workers.find((candidate) => candidate.inFlight.size === 0) ??
+        (this.workers.length < this.size ? this.spawn() : undefined);
+      if (!entry) {
+        return;
+      }
+
+      // Spread the backlog over the free workers; small tasks share one message
+      const queue = this.queues.interactive.length > 0 ? this.queues.interactive : this.queues.background;
+      const free = this.workers.filter((candidate) => candidate.inFlight.size === 0).length +
+        this.size - this.workers.length;
+      const batch = queue.splice(0, Math.min(this.maxBatchSize, Math.ceil(queue.length / Math.max(1, free))));
+
+      batch.forEach((task) => entry.inFlight.set(task.id, task));
+      entry.worker.ref();
+      this.batches++;
+      entry.worker.postMessage(
+        batch.map(({ id, name, payload }): TaskRequest => ({ id, name, payload })),
+        batch.flatMap((task) => task.transfer)
+      );
+    }
+  }
+
+  private spawn(): PoolWorker {
+    const entry: PoolWorker = { worker: new Worker(this.filename), inFlight: new Map() };
+    entry.worker.unref();
+
+    entry.worker.on('message', (responses: TaskResponse[]) => {
+      responses.forEach((response) => {
+        const task = entry.inFlight.get(response.id);
+        if (!task) {
+          return;
+        }
+        entry.inFlight.delete(response.id);
+        if (response.error !== undefined) {
+          this.failed++;
+          task.reject(new Error(response.error));
+        } else {
+          this.completed++;
+          task.resolve(response.result);
+        }
+      });
+      if (entry.inFlight.size === 0) {
+        // An idle pool does not keep the process alive
+        entry.worker.unref();
+        this.dispatch();
+      }
+    });
+
+    // A crashed worker fails its own tasks only; the next dispatch starts a replacement
+    const retire = (error: Error) => {
+      const index = this.workers.indexOf(entry);
+      if (index < 0) {
+        return;
+      }
+      this.workers.splice(index, 1);
+      this.failed += entry.inFlight.size;
+      entry.inFlight.forEach((task) => task.reject(error));
+      entry.inFlight.clear();
+      if (!this.closed) {
+        this.dispatch();
+      }
+    };
+    entry.worker.on('error', retire);
+    entry.worker.on('exit', (code) => retire(new Error(`Worker exited with code ${code}`)));
+
+    this.workers.push(entry);
+    return entry;
+  }
+}
+
+/**
+ * Serves pool tasks from a worker file. Each message is a batch of tasks, answered
+ * with one message holding every result in the batch.
+ * @param handlers Task handlers by name
+ */
+export const serveTasks = (handlers: TaskHandlers): void => {
+  if (!parentPort) {
+    throw new Error('serveTasks must run in a worker thread');
+  }
+  const port = parentPort;
+
+  port.on('message', async (batch: TaskRequest[]) => {
+    const transfer: TransferListItem[] = [];
+    const responses = await Promise.all(batch.map(async ({ id, name, payload }): Promise<TaskResponse> => {
+      const handler = handlers[name];
+      if (!handler) {
+        return { id, error: `Unknown task: ${name}` };
+      }
+      try {
+        const result = await handler(payload);
+        if (result instanceof ArrayBuffer) {
+          transfer.push(result);
+        }
+        return { id, result };
+      } catch (error) {
+        return { id, error: (error as Error).message };
+      }
+    }));
+    port.postMessage(responses, transfer);
+  });
+};
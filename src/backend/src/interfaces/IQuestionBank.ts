@@ -0,0 +1,35 @@
+/**
+ * @fileoverview Interface definitions for precomputed quiz question banks.
+ * A bank holds one stored question per card of a content item and is versioned,
+ * so quiz start samples stored questions instead of generating them.
+ * @version 1.0.0
+ */
+
+/**
+ * Quiz question built from one card
+ */
+export interface IQuizQuestion {
+    id?: string;
+    cardId: string;
+    contentId: string;
+    userId: string;
+    cardHash: string;           // Hash of the card text the question was built from
+    bankVersion: number;
+    question: string;
+    type: 'multiple_choice' | 'true_false' | 'fill_in_blank';
+    options: string[];
+    correctAnswer: string;
+    explanation?: string;
+}
+
+/**
+ * Bank state for one content item
+ */
+export interface IQuestionBank {
+    contentId: string;
+    userId: string;
+    version: number;
+    questionCount: number;
+    builtAt: Date | null;
+    staleSince: Date | null;    // First card change since the last refresh
+}
@@ -0,0 +1,57 @@
+/**
+ * @fileoverview Interface definitions for offline review sync.
+ * Devices study from a local card store and exchange review-log deltas with the
+ * server: they push their own reviews by local sequence and pull other devices'
+ * reviews and changed cards by server cursor. Times are epoch milliseconds.
+ * @version 1.0.0
+ */
+
+/**
+ * One review-log entry with the FSRS state after the review
+ */
+export interface ISyncedReview {
+    sequence: number;           // Local sequence when pushed, server sequence when pulled
+    cardId: string;
+    rating: number;
+    reviewedAt: number;
+    stability: number;
+    difficulty: number;
+    dueAt: number;
+}
+
+/**
+ * Card with its scheduling state, as the device stores it
+ */
+export interface ISyncedCard {
+    id: string;
+    contentId: string | null;
+    front: string;
+    back: string;
+    stability: number;
+    difficulty: number;
+    reviewCount: number;
+    lastRating: number;
+    lastReviewAt: number | null;
+    dueAt: number;
+}
+
+/**
+ * Sync request from one device
+ */
+export interface IReviewSyncRequest {
+    deviceId: string;
+    reviews: ISyncedReview[];   // Unacknowledged local reviews, oldest first
+    cursor: number;             // Highest server sequence the device has applied
+    cardsSince: number;         // Cards changed after this time are returned
+}
+
+/**
+ * Sync response for one device
+ */
+export interface IReviewSyncResponse {
+    acknowledged: number;       // Highest local sequence the server has stored
+    reviews: ISyncedReview[];   // Other devices' reviews after the cursor
+    cards: ISyncedCard[];       // Cards changed after cardsSince, oldest change first
+    cardsSyncedAt: number;      // Next cardsSince
+    hasMore: boolean;           // A page was full; sync again to catch up
+}
@@ -6,6 +6,7 @@
 
 import { ICard } from './ICard';
 import { StudyModes } from '../constants/studyModes';
+import { IQuizQuestion } from './IQuestionBank';
 
 /**
  * Interface defining the FSRS algorithm progress metrics for a study session
@@ -117,4 +118,7 @@ export interface IStudySession {
 
     /** Session-specific settings and configurations */
     settings: ISessionSettings;
+
+    /** Questions sampled from the user's question banks for quiz sessions */
+    quizQuestions?: IQuizQuestion[];
 }
\ No newline at end of file
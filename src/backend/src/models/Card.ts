@@ -4,11 +4,20 @@
  * @version 1.0.0
  */
 
-import { SupabaseClient, RealtimeSubscription } from '@supabase/supabase-js';
+import { SupabaseClient } from '@supabase/supabase-js';
 import { ICard, ICardContent, ContentType } from '../interfaces/ICard';
 import { StudyModes, StudyModeConfig } from '../constants/studyModes';
 import { calculateNextReview, updateCardState, FSRS_PARAMETERS } from '../utils/fsrs';
 import { getServices } from '../config/services';
+import { BatchLoader, scopedLoader } from '../utils/batchLoader';
+import { CardChange, CardRealtimeHub, ReleaseCardListener } from '../core/cards/cardRealtimeHub';
+import { QueryRouter } from '../services/QueryRouter';
+
+// Name of the request-scoped card loader, shared by every Card instance
+const CARD_LOADER = 'cards';
+
+// Rows per multi-row insert; keeps request bodies and statement parameters bounded
+const INSERT_CHUNK_SIZE = 500;
 
 /**
  * Enhanced database model class for flashcard operations with comprehensive
@@ -16,12 +25,17 @@ import { getServices } from '../config/services';
  */
 export class Card {
     private readonly tableName: string = 'cards';
-    private readonly subscriptions: Map<string, RealtimeSubscription>;
+    private readonly subscriptions: Map<string, ReleaseCardListener>;
     private readonly supabase: SupabaseClient;
+    private readonly router: QueryRouter;
+    private readonly realtime: CardRealtimeHub;
 
-    constructor() {
+    constructor(supabase?: SupabaseClient) {
         this.subscriptions = new Map();
-        this.supabase = getServices().supabaseService.client;
+        // An injected client serves every query; otherwise listings may go to read replicas
+        this.router = supabase ? new QueryRouter(supabase) : getServices().queryRouter;
+        this.supabase = this.router.primary;
+        this.realtime = CardRealtimeHub.forClient(this.supabase);
     }
 
     /**
@@ -30,40 +44,14 @@ export class Card {
      * @returns Newly created card with initialized metrics
      */
     async create(cardData: Partial<ICard>): Promise<ICard> {
-        // Validate required fields
-        if (!cardData.userId || !cardData.frontContent || !cardData.backContent) {
-            throw new Error('Missing required card data fields');
-        }
-
-        // Initialize FSRS data
-        const fsrsData = {
-            stability: FSRS_PARAMETERS.initialStability,
-            difficulty: FSRS_PARAMETERS.initialDifficulty,
-            reviewCount: 0,
-            lastReview: new Date(),
-            lastRating: 0,
-            streakCount: 0,
-            retentionScore: 1.0
-        };
-
-        // Prepare card data with enhanced metadata
-        const newCard: ICard = {
-            ...cardData,
-            id: crypto.randomUUID(),
-            fsrsData,
-            nextReview: new Date(),
-            compatibleModes: [StudyModes.STANDARD],
-            tags: cardData.tags || [],
-            createdAt: new Date(),
-            updatedAt: new Date()
-        };
+        const newCard = this.buildCard(cardData);
 
         // Insert card with enhanced error handling
-        const { data, error } = await this.supabase
+        const { data, error } = await this.router.write(newCard.userId, (db) => db
             .from(this.tableName)
             .insert(newCard)
             .select()
-            .single();
+            .single());
 
         if (error) throw new Error(`Failed to create card: ${error.message}`);
 
@@ -73,6 +61,43 @@ export class Card {
         return data as ICard;
     }
 
+    /**
+     * Creates many flashcards with multi-row inserts. Every card is validated before
+     * anything is written; rows are then inserted in chunks of INSERT_CHUNK_SIZE, so a
+     * failure leaves earlier chunks in place.
+     * @param cardsData Partial card data for creation
+     * @returns Created cards, in input order
+     */
+    async createMany(cardsData: Partial<ICard>[]): Promise<ICard[]> {
+        const newCards = cardsData.map((cardData) => this.buildCard(cardData));
+
+        const created = new Map<string, ICard>();
+        try {
+            for (let start = 0; start < newCards.length; start += INSERT_CHUNK_SIZE) {
+                const { data, error } = await this.supabase
+                    .from(this.tableName)
+                    .insert(newCards.slice(start, start + INSERT_CHUNK_SIZE))
+                    .select();
+
+                if (error) throw new Error(`Failed to create cards: ${error.message}`);
+                (data as ICard[]).forEach((card) => created.set(card.id, card));
+            }
+        } finally {
+            const userIds = new Set(newCards.map((newCard) => newCard.userId));
+            await Promise.all([...userIds].map((userId) => this.router.recordWrite(userId)));
+        }
+
+        const loader = this.loader();
+        return newCards.map((newCard) => {
+            const card = created.get(newCard.id);
+            if (!card) throw new Error('Failed to create cards: Inserted card not returned');
+
+            this.subscribeToCardUpdates(card.id, card.userId);
+            loader?.prime(card.id, card);
+            return card;
+        });
+    }
+
     /**
      * Updates card state after review with enhanced metrics tracking
      * @param cardId Card identifier
@@ -85,19 +110,14 @@ export class Card {
         rating: number,
         userTier: string
     ): Promise<ICard> {
-        const { data: card, error: fetchError } = await this.supabase
-            .from(this.tableName)
-            .select()
-            .eq('id', cardId)
-            .single();
-
-        if (fetchError) throw new Error(`Failed to fetch card: ${fetchError.message}`);
+        // Usually already loaded by the caller in this request
+        const card = await this.findById(cardId);
 
         // Begin transaction for atomic updates
-        const updatedFsrsData = updateCardState(card as ICard, rating);
-        const nextReview = calculateNextReview(card as ICard, rating);
+        const updatedFsrsData = updateCardState(card, rating);
+        const nextReview = calculateNextReview(card, rating);
 
-        const { data: updatedCard, error: updateError } = await this.supabase
+        const { data: updatedCard, error: updateError } = await this.router.write(card.userId, (db) => db
             .from(this.tableName)
             .update({
                 fsrsData: updatedFsrsData,
@@ -106,10 +126,36 @@ export class Card {
             })
             .eq('id', cardId)
             .select()
-            .single();
+            .single());
 
         if (updateError) throw new Error(`Failed to update card: ${updateError.message}`);
 
+        this.loader()?.prime(cardId, updatedCard as ICard);
+        return updatedCard as ICard;
+    }
+
+    /**
+     * Updates a card's content, tags or study settings
+     * @param cardId Card identifier
+     * @param updates Fields to change
+     * @returns Updated card
+     */
+    async update(cardId: string, updates: Partial<ICard>): Promise<ICard> {
+        const card = await this.findById(cardId);
+
+        const { data: updatedCard, error } = await this.router.write(card.userId, (db) => db
+            .from(this.tableName)
+            .update({
+                ...updates,
+                updatedAt: new Date()
+            })
+            .eq('id', cardId)
+            .select()
+            .single());
+
+        if (error) throw new Error(`Failed to update card: ${error.message}`);
+
+        this.loader()?.prime(cardId, updatedCard as ICard);
         return updatedCard as ICard;
     }
 
@@ -151,57 +197,97 @@ export class Card {
     }
 
     /**
-     * Sets up real-time subscription for card updates
+     * Validates card data and fills in the identifier and initial FSRS state
+     * @param cardData Partial card data for creation
+     * @returns Card row ready to insert
+     */
+    private buildCard(cardData: Partial<ICard>): ICard {
+        // Validate required fields
+        if (!cardData.userId || !cardData.frontContent || !cardData.backContent) {
+            throw new Error('Missing required card data fields');
+        }
+
+        // Initialize FSRS data
+        const fsrsData = {
+            stability: FSRS_PARAMETERS.initialStability,
+            difficulty: FSRS_PARAMETERS.initialDifficulty,
+            reviewCount: 0,
+            lastReview: new Date(),
+            lastRating: 0,
+            streakCount: 0,
+            retentionScore: 1.0
+        };
+
+        // Prepare card data with enhanced metadata
+        return {
+            ...cardData,
+            id: crypto.randomUUID(),
+            fsrsData,
+            nextReview: new Date(),
+            compatibleModes: [StudyModes.STANDARD],
+            tags: cardData.tags || [],
+            createdAt: new Date(),
+            updatedAt: new Date()
+        } as ICard;
+    }
+
+    /**
+     * Sets up real-time subscription for card updates on the user's shared channel
      * @param cardId Card identifier
      * @param userId User identifier
      */
     private subscribeToCardUpdates(cardId: string, userId: string): void {
-        const subscription = this.supabase
-            .channel(`card-${cardId}`)
-            .on(
-                'postgres_changes',
-                {
-                    event: '*',
-                    schema: 'public',
-                    table: this.tableName,
-                    filter: `id=eq.${cardId}`
-                },
-                (payload) => {
-                    // Handle real-time updates
-                    console.log('Card updated:', payload);
-                }
-            )
-            .subscribe();
-
-        this.subscriptions.set(cardId, subscription);
+        if (!this.subscriptions.has(cardId)) {
+            this.subscriptions.set(cardId, this.realtime.subscribe(userId, cardId, this.onCardUpdate));
+        }
     }
 
+    private readonly onCardUpdate = (payload: CardChange): void => {
+        // Handle real-time updates
+        console.log('Card updated:', payload);
+    };
+
     /**
      * Removes real-time subscription for a card
      * @param cardId Card identifier
      */
     async unsubscribe(cardId: string): Promise<void> {
-        const subscription = this.subscriptions.get(cardId);
-        if (subscription) {
-            await subscription.unsubscribe();
+        const release = this.subscriptions.get(cardId);
+        if (release) {
             this.subscriptions.delete(cardId);
+            await release();
         }
     }
 
     /**
-     * Retrieves a card by its identifier
+     * Retrieves a card by its identifier. Within a request scope, lookups in the same
+     * tick share one query and repeated lookups are served from the request's memo.
      * @param cardId Card identifier
      * @returns Card data
      */
     async findById(cardId: string): Promise<ICard> {
+        const loader = this.loader();
+        const card = loader
+            ? await loader.load(cardId)
+            : (await this.findByIds([cardId])).get(cardId);
+
+        if (!card) throw new Error('Failed to fetch card: Card not found');
+        return card;
+    }
+
+    /**
+     * Retrieves cards by identifier in one query
+     * @param cardIds Card identifiers
+     * @returns Found cards by identifier
+     */
+    async findByIds(cardIds: string[]): Promise<Map<string, ICard>> {
         const { data, error } = await this.supabase
             .from(this.tableName)
             .select()
-            .eq('id', cardId)
-            .single();
+            .in('id', cardIds);
 
         if (error) throw new Error(`Failed to fetch card: ${error.message}`);
-        return data as ICard;
+        return new Map((data as ICard[]).map((card) => [card.id, card]));
     }
 
     /**
@@ -210,22 +296,51 @@ export class Card {
      * @returns Array of user's cards
      */
     async findByUserId(userId: string): Promise<ICard[]> {
-        const { data, error } = await this.supabase
+        // Listing reads may be served by a replica that has the user's latest writes
+        const { data, error } = await this.router.read(userId, (db) => db
             .from(this.tableName)
             .select()
             .eq('userId', userId)
-            .order('createdAt', { ascending: false });
+            .order('createdAt', { ascending: false }));
 
         if (error) throw new Error(`Failed to fetch user cards: ${error.message}`);
         return data as ICard[];
     }
 
+    /**
+     * Retrieves a user's cards changed after a time, oldest change first
+     * @param userId User identifier
+     * @param since Exclusive lower bound on the last change
+     * @param limit Maximum number of cards
+     * @returns Changed cards
+     */
+    async findUpdatedSince(userId: string, since: Date, limit: number): Promise<ICard[]> {
+        const { data, error } = await this.router.read(userId, (db) => db
+            .from(this.tableName)
+            .select()
+            .eq('userId', userId)
+            .gt('updatedAt', since.toISOString())
+            .order('updatedAt', { ascending: true })
+            .limit(limit));
+
+        if (error) throw new Error(`Failed to fetch changed cards: ${error.message}`);
+        return data as ICard[];
+    }
+
     async delete(cardId: string): Promise<void> {
-        const { error } = await this.supabase
+        const { data, error } = await this.supabase
             .from(this.tableName)
             .delete()
-            .eq('id', cardId);
+            .eq('id', cardId)
+            .select('userId');
 
         if (error) throw new Error(`Failed to delete card: ${error.message}`);
+        this.loader()?.clear(cardId);
+        // The deleted row names the user whose listings must stop showing it
+        await Promise.all((data as Array<Pick<ICard, 'userId'>>).map((row) => this.router.recordWrite(row.userId)));
+    }
+
+    private loader(): BatchLoader<string, ICard> | null {
+        return scopedLoader(CARD_LOADER, () => new BatchLoader((cardIds: string[]) => this.findByIds(cardIds)));
     }
 }
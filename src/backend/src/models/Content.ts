@@ -4,11 +4,14 @@
  */
 
 import { PostgrestFilterBuilder } from '@supabase/postgrest-js'; // v1.8.4
+import { SupabaseClient } from '@supabase/supabase-js';
 import { ValidationError } from 'yup'; // v1.3.2
 import { EncryptionService } from '../services/EncryptionService';
 import { auditLogger } from '../services/AuditLoggerService';
 import { IContent, ContentStatus } from '../interfaces/IContent';
 import { getServices } from '../config/services';
+import { BatchLoader, scopedLoader } from '../utils/batchLoader';
+import { QueryRouter } from '../services/QueryRouter';
 import * as yup from 'yup';
 
 /**
@@ -29,10 +32,13 @@ const contentSchema = yup.object().shape({
 export class Content {
   private readonly tableName: string = 'contents';
   private readonly supabase;
+  private readonly router: QueryRouter;
   private readonly encryptionService: EncryptionService;
 
-  constructor() {
-    this.supabase = getServices().supabaseService.client;
+  constructor(supabase?: SupabaseClient) {
+    // An injected client serves every query; otherwise listings may go to read replicas
+    this.router = supabase ? new QueryRouter(supabase) : getServices().queryRouter;
+    this.supabase = this.router.primary;
     this.encryptionService = new EncryptionService();
   }
 
@@ -55,7 +61,7 @@ export class Content {
       ]);
 
       // Begin transaction
-      const { data, error } = await this.supabase
+      const { data, error } = await this.router.write(validatedData.userId, (db) => db
         .from(this.tableName)
         .insert({
           ...validatedData,
@@ -65,7 +71,7 @@ export class Content {
           updated_at: new Date().toISOString()
         })
         .select('*')
-        .single();
+        .single());
 
       if (error) throw error;
 
@@ -90,31 +96,48 @@ export class Content {
   }
 
   /**
-   * Retrieves a content item with security checks
+   * Retrieves a content item with security checks. Within a request scope, lookups
+   * in the same tick share one query per user and repeated lookups are memoized.
    * @param id Content item ID
    * @param userId User ID for authorization
    * @returns Found content item or null
    */
   async findById(id: string, userId: string): Promise<IContent | null> {
+    const loader = this.loader(userId);
+    return loader
+      ? loader.load(id)
+      : (await this.findByIds([id], userId)).get(id) ?? null;
+  }
+
+  /**
+   * Retrieves a user's content items by ID in one query
+   * @param ids Content item IDs
+   * @param userId User ID for authorization
+   * @returns Found content items by ID
+   */
+  async findByIds(ids: string[], userId: string): Promise<Map<string, IContent>> {
     try {
       const { data, error } = await this.supabase
         .from(this.tableName)
         .select('*')
-        .eq('id', id)
-        .eq('userId', userId)
-        .maybeSingle();
+        .in('id', ids)
+        .eq('userId', userId);
 
       if (error) throw error;
-      if (!data) return null;
 
       // Decrypt sensitive metadata fields
-      const decryptedMetadata = await this.encryptionService.decryptFields(data.metadata, [
-        'tags',
-        'language',
-        'confidence'
-      ]);
+      const items = await Promise.all(
+        data.map(async (item) => ({
+          ...item,
+          metadata: await this.encryptionService.decryptFields(item.metadata, [
+            'tags',
+            'language',
+            'confidence'
+          ])
+        }))
+      );
 
-      return { ...data, metadata: decryptedMetadata };
+      return new Map(items.map((item) => [item.id, item]));
     } catch (error) {
       throw new Error(`Failed to find content: ${error.message}`);
     }
@@ -128,17 +151,20 @@ export class Content {
    */
   async findByUserId(userId: string, status?: ContentStatus): Promise<IContent[]> {
     try {
-      let query: PostgrestFilterBuilder<any> = this.supabase
-        .from(this.tableName)
-        .select('*')
-        .eq('userId', userId)
-        .is('deletedAt', null);
+      // Listing reads may be served by a replica that has the user's latest writes
+      const { data, error } = await this.router.read(userId, (db) => {
+        let query: PostgrestFilterBuilder<any> = db
+          .from(this.tableName)
+          .select('*')
+          .eq('userId', userId)
+          .is('deletedAt', null);
 
-      if (status) {
-        query = query.eq('status', status);
-      }
+        if (status) {
+          query = query.eq('status', status);
+        }
 
-      const { data, error } = await query.order('createdAt', { ascending: false });
+        return query.order('createdAt', { ascending: false });
+      });
 
       if (error) throw error;
 
@@ -169,7 +195,7 @@ export class Content {
    */
   async updateStatus(id: string, userId: string, status: ContentStatus): Promise<IContent> {
     try {
-      const { data, error } = await this.supabase
+      const { data, error } = await this.router.write(userId, (db) => db
         .from(this.tableName)
         .update({
           status,
@@ -179,9 +205,11 @@ export class Content {
         .eq('id', id)
         .eq('userId', userId)
         .select('*')
-        .single();
+        .single());
 
       if (error) throw error;
+      // The returned row's metadata is still encrypted, so it cannot prime the loader
+      this.loader(userId)?.clear(id);
 
       // Log status change
       auditLogger.info('content.status_update', {
@@ -215,16 +243,17 @@ export class Content {
    */
   async delete(id: string, userId: string): Promise<boolean> {
     try {
-      const { error } = await this.supabase
+      const { error } = await this.router.write(userId, (db) => db
         .from(this.tableName)
         .update({
           deleted_at: new Date().toISOString(),
           updated_at: new Date().toISOString()
         })
         .eq('id', id)
-        .eq('userId', userId);
+        .eq('userId', userId));
 
       if (error) throw error;
+      this.loader(userId)?.clear(id);
 
       // Log deletion
       auditLogger.info('content.delete', {
@@ -239,4 +268,8 @@ export class Content {
       throw new Error(`Failed to delete content: ${error.message}`);
     }
   }
+
+  private loader(userId: string): BatchLoader<string, IContent> | null {
+    return scopedLoader(`contents:${userId}`, () => new BatchLoader((ids: string[]) => this.findByIds(ids, userId)));
+  }
 }
@@ -0,0 +1,187 @@
+/**
+ * @fileoverview Database model for precomputed quiz question banks.
+ * Stores one question per card with the hash of the card text it was built from,
+ * so a refresh rewrites only questions of changed cards.
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { IQuestionBank, IQuizQuestion } from '../interfaces/IQuestionBank';
+import { getServices } from '../config/services';
+
+interface QuestionRow {
+    id: string;
+    card_id: string;
+    content_id: string;
+    user_id: string;
+    card_hash: string;
+    bank_version: number;
+    question: string;
+    question_type: IQuizQuestion['type'];
+    options: string[];
+    correct_answer: string;
+    explanation: string | null;
+}
+
+const toQuestion = (row: QuestionRow): IQuizQuestion => ({
+    id: row.id,
+    cardId: row.card_id,
+    contentId: row.content_id,
+    userId: row.user_id,
+    cardHash: row.card_hash,
+    bankVersion: row.bank_version,
+    question: row.question,
+    type: row.question_type,
+    options: row.options,
+    correctAnswer: row.correct_answer,
+    explanation: row.explanation ?? undefined
+});
+
+/**
+ * Database model for question banks and their questions
+ */
+export class QuestionBank {
+    private readonly bankTable: string = 'question_banks';
+    private readonly questionTable: string = 'quiz_questions';
+    private readonly supabase: SupabaseClient;
+
+    constructor(supabase?: SupabaseClient) {
+        this.supabase = supabase ?? getServices().supabaseService.client;
+    }
+
+    /**
+     * Retrieves the bank of a content item
+     * @param contentId Content identifier
+     * @returns Bank state, or null before the first build
+     */
+    async findBank(contentId: string): Promise<IQuestionBank | null> {
+        const { data, error } = await this.supabase
+            .from(this.bankTable)
+            .select()
+            .eq('content_id', contentId)
+            .maybeSingle();
+
+        if (error) throw new Error(`Failed to fetch question bank: ${error.message}`);
+        if (!data) return null;
+        return {
+            contentId: data.content_id,
+            userId: data.user_id,
+            version: data.version,
+            questionCount: data.question_count,
+            builtAt: data.built_at ? new Date(data.built_at) : null,
+            staleSince: data.stale_since ? new Date(data.stale_since) : null
+        };
+    }
+
+    /**
+     * Card hashes of the stored questions of a content item
+     * @param contentId Content identifier
+     * @returns Map of card id to the card hash its question was built from
+     */
+    async findCardHashes(contentId: string): Promise<Map<string, string>> {
+        const { data, error } = await this.supabase
+            .from(this.questionTable)
+            .select('card_id, card_hash')
+            .eq('content_id', contentId);
+
+        if (error) throw new Error(`Failed to fetch bank questions: ${error.message}`);
+        return new Map((data as Array<Pick<QuestionRow, 'card_id' | 'card_hash'>>)
+            .map((row) => [row.card_id, row.card_hash]));
+    }
+
+    /**
+     * Writes a new bank version: upserts rebuilt questions, removes questions of cards
+     * that no longer exist and records the version
+     * @param bank Bank state to record; staleSince is cleared only if no card changed since `startedAt`
+     * @param questions Questions of new and changed cards
+     * @param removedCardIds Cards whose questions should be removed
+     * @param startedAt When the refresh read the cards
+     */
+    async saveVersion(
+        bank: Omit<IQuestionBank, 'builtAt' | 'staleSince'>,
+        questions: IQuizQuestion[],
+        removedCardIds: string[],
+        startedAt: Date
+    ): Promise<void> {
+        // The bank row comes first: questions reference it
+        const { error: bankError } = await this.supabase
+            .from(this.bankTable)
+            .upsert({
+                content_id: bank.contentId,
+                user_id: bank.userId,
+                version: bank.version,
+                question_count: bank.questionCount,
+                built_at: new Date().toISOString(),
+                updated_at: new Date().toISOString()
+            }, { onConflict: 'content_id' });
+        if (bankError) throw new Error(`Failed to save question bank: ${bankError.message}`);
+
+        if (questions.length > 0) {
+            const { error } = await this.supabase
+                .from(this.questionTable)
+                .upsert(questions.map((question) => ({
+                    card_id: question.cardId,
+                    content_id: question.contentId,
+                    user_id: question.userId,
+                    card_hash: question.cardHash,
+                    bank_version: question.bankVersion,
+                    question: question.question,
+                    question_type: question.type,
+                    options: question.options,
+                    correct_answer: question.correctAnswer,
+                    explanation: question.explanation ?? null
+                })), { onConflict: 'card_id' });
+            if (error) throw new Error(`Failed to save bank questions: ${error.message}`);
+        }
+
+        if (removedCardIds.length > 0) {
+            const { error } = await this.supabase
+                .from(this.questionTable)
+                .delete()
+                .in('card_id', removedCardIds);
+            if (error) throw new Error(`Failed to remove bank questions: ${error.message}`);
+        }
+
+        // A card written while this refresh ran keeps the bank stale for the next one
+        const { error: staleError } = await this.supabase
+            .from(this.bankTable)
+            .update({ stale_since: null })
+            .eq('content_id', bank.contentId)
+            .lt('stale_since', startedAt.toISOString());
+        if (staleError) throw new Error(`Failed to update question bank: ${staleError.message}`);
+    }
+
+    /**
+     * Content items whose cards changed since their last refresh, oldest first
+     * @param limit Maximum number of banks returned
+     */
+    async findStale(limit: number): Promise<Array<{ contentId: string; userId: string }>> {
+        const { data, error } = await this.supabase
+            .from(this.bankTable)
+            .select('content_id, user_id')
+            .not('stale_since', 'is', null)
+            .order('stale_since', { ascending: true })
+            .limit(limit);
+
+        if (error) throw new Error(`Failed to fetch stale question banks: ${error.message}`);
+        return (data as Array<{ content_id: string; user_id: string }>)
+            .map((row) => ({ contentId: row.content_id, userId: row.user_id }));
+    }
+
+    /**
+     * Samples stored questions for a quiz
+     * @param userId User identifier
+     * @param count Number of questions
+     * @param contentId Restricts the sample to one content item
+     */
+    async sample(userId: string, count: number, contentId?: string): Promise<IQuizQuestion[]> {
+        const { data, error } = await this.supabase.rpc('sample_quiz_questions', {
+            p_user_id: userId,
+            p_count: count,
+            p_content_id: contentId ?? null
+        });
+
+        if (error) throw new Error(`Failed to sample quiz questions: ${error.message}`);
+        return (data as QuestionRow[]).map(toQuestion);
+    }
+}
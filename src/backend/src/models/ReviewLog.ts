@@ -0,0 +1,84 @@
+/**
+ * @fileoverview Database model for the server review log that offline devices sync
+ * against. Pushed entries are keyed by device sequence so retries are no-ops; pulls
+ * page by server sequence.
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { ISyncedReview } from '../interfaces/IReviewSync';
+import { getServices } from '../config/services';
+import { QueryRouter } from '../services/QueryRouter';
+
+interface ReviewRow {
+    seq: number;
+    card_id: string;
+    rating: number;
+    reviewed_at: string;
+    stability: number;
+    difficulty: number;
+    due_at: string;
+}
+
+const toReview = (row: ReviewRow): ISyncedReview => ({
+    sequence: Number(row.seq),
+    cardId: row.card_id,
+    rating: row.rating,
+    reviewedAt: new Date(row.reviewed_at).getTime(),
+    stability: row.stability,
+    difficulty: row.difficulty,
+    dueAt: new Date(row.due_at).getTime()
+});
+
+/**
+ * Database model for synced reviews
+ */
+export class ReviewLog {
+    private readonly tableName: string = 'review_log';
+    private readonly router: QueryRouter;
+
+    constructor(supabase?: SupabaseClient) {
+        this.router = supabase ? new QueryRouter(supabase) : getServices().queryRouter;
+    }
+
+    /**
+     * Stores a device's reviews and advances the reviewed cards
+     * @param userId User identifier
+     * @param deviceId Pushing device
+     * @param reviews Entries keyed by the device's local sequence
+     * @returns Highest device sequence stored
+     */
+    async append(userId: string, deviceId: string, reviews: ISyncedReview[]): Promise<number> {
+        // Card state changes, so the user's next listings must see the primary
+        const { data, error } = await this.router.write(userId, (db) => db.rpc('append_device_reviews', {
+            p_user_id: userId,
+            p_device_id: deviceId,
+            p_reviews: reviews
+        }));
+
+        if (error) throw new Error(`Failed to store reviews: ${error.message}`);
+        return Number(data ?? 0);
+    }
+
+    /**
+     * Reviews made on the user's other devices after a server sequence
+     * @param userId User identifier
+     * @param deviceId Pulling device, whose own reviews are skipped
+     * @param cursor Highest server sequence the device has applied
+     * @param limit Maximum number of entries
+     * @returns Entries in server sequence order
+     */
+    async since(userId: string, deviceId: string, cursor: number, limit: number): Promise<ISyncedReview[]> {
+        const { data, error } = await this.router.primary
+            .from(this.tableName)
+            .select('seq, card_id, rating, reviewed_at, stability, difficulty, due_at')
+            .eq('user_id', userId)
+            .neq('device_id', deviceId)
+            .gt('seq', cursor)
+            .order('seq', { ascending: true })
+            .limit(limit);
+
+        if (error) throw new Error(`Failed to fetch reviews: ${error.message}`);
+        return (data as ReviewRow[]).map(toReview);
+    }
+}
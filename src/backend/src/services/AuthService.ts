@@ -164,6 +164,16 @@ export class AuthService {
     }
   }
 
+  /**
+   * Exchanges a refresh token for a new token pair; the old refresh token is revoked
+   * @param refreshToken Refresh token issued at login or by the previous refresh
+   * @returns New access token and refresh token
+   * @throws {JWTError} If the refresh token is invalid, revoked or was already used
+   */
+  public async refreshAccessToken(refreshToken: string): Promise<{ token: string; refreshToken: string }> {
+    return this.tokenService.refreshAccessToken(refreshToken);
+  }
+
   /**
    * Logs out user and invalidates tokens
    * @param token Access token to invalidate
@@ -13,6 +13,12 @@ import { openai } from '../config/openai';
 import { IStudySession } from '../interfaces/IStudySession';
 import Redis from 'ioredis';
 import { ContentStatus } from '../interfaces/IContent';
+import { SingleFlight } from '../utils/singleFlight';
+import { NearDuplicateIndex } from '../core/cards/nearDuplicateIndex';
+import { RedisMutex } from '../utils/redisMutex';
+
+// Tag added to cards kept despite a close match, so the user can review them
+const POSSIBLE_DUPLICATE_TAG = 'possible-duplicate';
 
 /**
  * Enhanced service class for flashcard management with retention optimization
@@ -21,19 +27,28 @@ export class CardService {
     private cardModel: Card;
     private fsrsAlgorithm: FSRSAlgorithm;
     private cardGenerator: CardGenerator;
+    private duplicateIndex: NearDuplicateIndex;
+    // Serializes a user's deduplicated batches across workers
+    private batchMutex: RedisMutex;
+    // Last deduplicated batch of each user, so concurrent batches see each other's cards
+    private readonly pendingBatches = new Map<string, Promise<unknown>>();
 
     constructor() {
         this.cardModel = new Card();
         this.fsrsAlgorithm = new FSRSAlgorithm();
+        const cacheClient = new Redis(process.env.REDIS_URL);
         this.cardGenerator = new CardGenerator(
             openai,
-            new Redis(process.env.REDIS_URL),
+            cacheClient,
             {
                 maxCards: 50,
                 preferredTypes: [ContentType.TEXT],
                 targetModes: [StudyModes.STANDARD, StudyModes.VOICE]
-            }
+            },
+            new SingleFlight(cacheClient)
         );
+        this.duplicateIndex = new NearDuplicateIndex(cacheClient);
+        this.batchMutex = new RedisMutex(cacheClient);
     }
 
     /**
@@ -43,24 +58,7 @@ export class CardService {
      */
     public async createCard(cardData: Partial<ICard>): Promise<ICard> {
         try {
-            // Initialize FSRS data with retention tracking
-            const initialFSRSData = {
-                stability: 0.5,
-                difficulty: 0.3,
-                reviewCount: 0,
-                lastReview: null,
-                lastRating: 0
-            };
-
-            const enhancedCardData: Partial<ICard> = {
-                ...cardData,
-                fsrsData: initialFSRSData,
-                nextReview: new Date(),
-                compatibleModes: [StudyModes.STANDARD],
-                tags: cardData.tags || []
-            };
-
-            const createdCard = await this.cardModel.create(enhancedCardData);
+            const createdCard = await this.cardModel.create(this.prepareCard(cardData));
             return createdCard;
         } catch (error) {
             throw new Error(`Failed to create card: ${error.message}`);
@@ -99,19 +97,15 @@ export class CardService {
 
             const generatedCards = await this.cardGenerator.generateFromContent(contentData);
 
-            // Process and create cards with retention tracking
-            const cards = await Promise.all(
-                generatedCards.map(card => this.createCard({
-                    ...card,
-                    userId,
-                    compatibleModes: [
-                        StudyModes.STANDARD,
-                        ...(this.isVoiceCompatible(card) ? [StudyModes.VOICE] : [])
-                    ]
-                }))
-            );
-
-            return cards;
+            // Process and create cards with retention tracking, merging near-duplicates
+            return await this.createDeduplicated(userId, generatedCards.map(card => ({
+                ...card,
+                userId,
+                compatibleModes: [
+                    StudyModes.STANDARD,
+                    ...(this.isVoiceCompatible(card) ? [StudyModes.VOICE] : [])
+                ]
+            })));
         } catch (error) {
             throw new Error(`Failed to generate cards: ${error.message}`);
         }
@@ -217,6 +211,109 @@ export class CardService {
         }
     }
 
+    /**
+     * Creates one user's cards, skipping near-duplicates of stored cards and of
+     * earlier cards in the batch and flagging close matches
+     * @returns For each input, the created card or the card it was merged into
+     */
+    private createDeduplicated(userId: string, cardsData: Partial<ICard>[]): Promise<ICard[]> {
+        // Chunks of one document are persisted concurrently and overlap, possibly on
+        // different workers; queue locally first so only one batch per process polls the lock
+        const previous = this.pendingBatches.get(userId) ?? Promise.resolve();
+        const batch = previous.catch(() => undefined).then(() => this.batchMutex.runExclusive(
+            `carddup:{${userId}}`,
+            () => this.deduplicateAndCreate(userId, cardsData)
+        ));
+        this.pendingBatches.set(userId, batch);
+        batch.catch(() => undefined).then(() => {
+            if (this.pendingBatches.get(userId) === batch) {
+                this.pendingBatches.delete(userId);
+            }
+        });
+        return batch;
+    }
+
+    private async deduplicateAndCreate(userId: string, cardsData: Partial<ICard>[]): Promise<ICard[]> {
+        const verdicts = await this.duplicateIndex.classify(
+            userId,
+            cardsData.map(cardData => this.cardText(cardData))
+        );
+
+        // Stored matches may have been deleted since they were indexed
+        const matchedIds = new Set<string>();
+        verdicts.forEach(verdict => verdict.status === 'duplicate' && verdict.matchId && matchedIds.add(verdict.matchId));
+        const matches = matchedIds.size > 0
+            ? await this.cardModel.findByIds([...matchedIds])
+            : new Map<string, ICard>();
+
+        const results: ICard[] = new Array(cardsData.length);
+        const toCreate: number[] = [];
+        verdicts.forEach((verdict, index) => {
+            if (verdict.status === 'duplicate') {
+                const match = verdict.matchId && matches.get(verdict.matchId);
+                if (match) {
+                    results[index] = match;
+                    return;
+                }
+                if (verdict.matchIndex !== undefined) {
+                    return;
+                }
+            }
+            toCreate.push(index);
+        });
+
+        // One validation pass and multi-row inserts for every card that is kept
+        const created = await this.cardModel.createMany(toCreate.map(index => {
+            const cardData = verdicts[index].status === 'flagged'
+                ? { ...cardsData[index], tags: [...(cardsData[index].tags || []), POSSIBLE_DUPLICATE_TAG] }
+                : cardsData[index];
+            return this.prepareCard(cardData);
+        }));
+        created.forEach((card, i) => { results[toCreate[i]] = card; });
+
+        // Batch matches always point at an earlier card that was created
+        verdicts.forEach((verdict, index) => {
+            if (!results[index]) {
+                results[index] = results[verdict.matchIndex!];
+            }
+        });
+
+        await this.duplicateIndex.add(userId, created.map(card => this.cardText(card)));
+        return results;
+    }
+
+    /**
+     * Fills in the initial review state for a new card
+     * @param cardData Partial card data for creation
+     * @returns Card data ready for the model
+     */
+    private prepareCard(cardData: Partial<ICard>): Partial<ICard> {
+        // Initialize FSRS data with retention tracking
+        const initialFSRSData = {
+            stability: 0.5,
+            difficulty: 0.3,
+            reviewCount: 0,
+            lastReview: null,
+            lastRating: 0
+        };
+
+        return {
+            ...cardData,
+            fsrsData: initialFSRSData,
+            nextReview: new Date(),
+            compatibleModes: [StudyModes.STANDARD],
+            tags: cardData.tags || []
+        };
+    }
+
+    private cardText(card: Partial<ICard>) {
+        return {
+            id: card.id || '',
+            front: card.frontContent?.text || '',
+            back: card.backContent?.text || ''
+        };
+    }
+
     /**
      * Checks if a card is compatible with voice mode
      * @param card Card to check
@@ -231,20 +328,58 @@ export class CardService {
         );
     }
 
+    /**
+     * Creates cards, merging each near-duplicate of an existing card into that card
+     * @param cardsData Cards to create
+     * @returns For each input, the created card or the card it was merged into
+     */
     public async createCards(cardsData: Partial<ICard>[]): Promise<ICard[]> {
         try {
-            const cards = await Promise.all(
-                cardsData.map(cardData => this.createCard(cardData))
-            );
-            return cards;
+            const results: ICard[] = new Array(cardsData.length);
+            const byUser = new Map<string, number[]>();
+            cardsData.forEach((cardData, index) => {
+                const userId = cardData.userId || '';
+                byUser.set(userId, [...(byUser.get(userId) || []), index]);
+            });
+
+            await Promise.all([...byUser].map(async ([userId, indexes]) => {
+                const cards = await this.createDeduplicated(userId, indexes.map(index => cardsData[index]));
+                cards.forEach((card, i) => { results[indexes[i]] = card; });
+            }));
+            return results;
         } catch (error) {
             throw new Error(`Failed to create cards: ${error.message}`);
         }
     }
 
+    public async getCardById(cardId: string): Promise<ICard> {
+        return this.cardModel.findById(cardId);
+    }
+
+    /**
+     * Updates a card, re-indexing its text for near-duplicate detection
+     * @param cardId Card identifier
+     * @param updates Fields to change
+     * @returns Updated card
+     */
+    public async updateCard(cardId: string, updates: Partial<ICard>): Promise<ICard> {
+        try {
+            const previous = await this.cardModel.findById(cardId);
+            const updatedCard = await this.cardModel.update(cardId, updates);
+            await this.duplicateIndex.update(updatedCard.userId, this.cardText(previous), this.cardText(updatedCard));
+            return updatedCard;
+        } catch (error) {
+            throw new Error(`Failed to update card: ${error.message}`);
+        }
+    }
+
     public async deleteCard(cardId: string): Promise<void> {
         try {
+            const card = await this.cardModel.findById(cardId);
             await this.cardModel.delete(cardId);
+            if (card) {
+                await this.duplicateIndex.remove(card.userId, this.cardText(card));
+            }
         } catch (error) {
             throw new Error(`Failed to delete card: ${error.message}`);
         }
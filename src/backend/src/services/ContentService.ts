@@ -5,16 +5,25 @@
  */
 
 import Bull from 'bull'; // ^4.10.0
+import { randomUUID } from 'crypto';
 import Redis from 'ioredis'; // ^5.0.0
 import winston from 'winston'; // ^3.8.0
 import { SecurityService } from './SecurityService';
 import { IContent, ContentStatus } from '../interfaces/IContent';
 import { Content } from '../models/Content';
 import { ContentProcessor } from '../core/ai/contentProcessor';
-import { sanitizeInput, validateSchema } from '../utils/validation';
+import { ContentPipeline } from '../core/ai/contentPipeline';
+import { SharedArtifactCache } from '../core/ai/sharedArtifactCache';
+import { CardService } from './CardService';
+import { QuestionBankService } from './QuestionBankService';
+import { ICard } from '../interfaces/ICard';
+import { cardStreamHandler, WS_CARD_EVENTS } from '../websocket/handlers/cardStreamHandler';
+import { sanitizeInputAsync, validateSchema } from '../utils/validation';
 
 // Global constants
-const PROCESSING_TIMEOUT = 10000; // 10 seconds
+// Whole-document budget; chunks of long documents run in parallel within it
+const DOCUMENT_TIMEOUT = 5 * 60 * 1000; // 5 minutes
+const QUEUE_CONCURRENCY = 8;
 const MAX_BATCH_SIZE = 100;
 const CACHE_TTL = 3600; // 1 hour
 const MAX_RETRIES = 3;
@@ -33,6 +42,26 @@ const logger = winston.createLogger({
   ]
 });
 
+interface ContentItem {
+  id: string;
+}
+
+/**
+ * One run of a content item through the pipeline, as named in its card events
+ */
+interface Generation {
+  id: string;
+  /** Cards streamed so far */
+  sequence: number;
+}
+
+interface ProcessedContent {
+  contentId: string;
+  status: ContentStatus;
+  cardCount: number;
+  error?: string;
+}
+
 /**
  * Enhanced service class for managing content operations with security and performance features
  */
@@ -42,15 +71,48 @@ export class ContentService {
   private cacheClient: Redis;
   private securityService: SecurityService;
   private contentProcessor: ContentProcessor;
+  private contentPipeline: ContentPipeline;
+  private cardService: CardService;
+  private questionBank?: QuestionBankService;
+  // Current generation of each content item this worker is processing
+  private readonly generations = new Map<string, Generation>();
 
   constructor(
     processor: ContentProcessor,
-    cache: Redis
+    cache: Redis,
+    questionBank?: QuestionBankService,
+    cardService: CardService = new CardService()
   ) {
     this.contentModel = new Content();
+    this.questionBank = questionBank;
     this.contentProcessor = processor;
     this.cacheClient = cache;
     this.securityService = new SecurityService();
+    this.cardService = cardService;
+    this.contentPipeline = new ContentPipeline(
+      processor,
+      // Overlapping chunks yield near-duplicate cards; they are merged into the first
+      async (cards: ICard[]) => [...new Set(await this.cardService.createCards(cards))],
+      {
+        // Cards reach the client while later chunks are still generating
+        onCard: (chunk, card) => {
+          const generation = this.generations.get(chunk.id);
+          if (!generation) {
+            return;
+          }
+          void cardStreamHandler.publish(chunk.userId, {
+            type: WS_CARD_EVENTS.CARD_GENERATED,
+            contentId: chunk.id,
+            generationId: generation.id,
+            sequence: generation.sequence++,
+            chunkIndex: chunk.metadata?.chunkIndex,
+            card
+          });
+        },
+        // Popular articles are analyzed and turned into cards once for all users
+        artifactCache: new SharedArtifactCache(cache)
+      }
+    );
     this.initializeQueue();
   }
 
@@ -70,10 +132,14 @@ export class ContentService {
           type: 'exponential',
           delay: 1000
         },
-        timeout: PROCESSING_TIMEOUT
+        timeout: DOCUMENT_TIMEOUT
       }
     });
 
+    this.processingQueue.process('process-content', QUEUE_CONCURRENCY, (job) =>
+      this.runPipeline(job.data.contentId, job.data.userId)
+    );
+
     this.processingQueue.on('failed', (job, error) => {
       logger.error('Content processing failed', {
         jobId: job.id,
@@ -109,7 +175,7 @@ export class ContentService {
       }
 
       // Sanitize content
-      const sanitizedContent = sanitizeInput(contentData.content, {
+      const sanitizedContent = await sanitizeInputAsync(contentData.content, {
         stripTags: true,
         escapeHTML: true,
         preventSQLInjection: true
@@ -291,13 +357,83 @@ export class ContentService {
     return status;
   }
 
-  // Add batch processing support
+  /**
+   * Processes a batch of content through the staged pipeline. Items are admitted
+   * as stage queues have room, so a large batch does not flood the OpenAI stages.
+   * @param items Content items to process
+   * @param userId User ID for authorization
+   * @returns Outcome per item, in request order
+   */
   public async processBatchContent(items: ContentItem[], userId: string): Promise<ProcessedContent[]> {
-    const jobs = items.map(item => this.processingQueue.add('content-processing', {
-      contentId: item.id,
-      userId
+    if (items.length > MAX_BATCH_SIZE) {
+      throw new Error(`Batch size cannot exceed ${MAX_BATCH_SIZE}`);
+    }
+    await this.securityService.validateUserAccess(userId);
+
+    return Promise.all(items.map(async (item) => {
+      try {
+        return await this.runPipeline(item.id, userId);
+      } catch (error) {
+        return {
+          contentId: item.id,
+          status: ContentStatus.ERROR,
+          cardCount: 0,
+          error: error.message
+        };
+      }
     }));
-    
-    return Promise.all(jobs);
+  }
+
+  /**
+   * Runs one stored content item through the pipeline and records its final status
+   */
+  private async runPipeline(contentId: string, userId: string): Promise<ProcessedContent> {
+    const content = await this.contentModel.findById(contentId, userId);
+    if (!content) {
+      throw new Error('Content not found');
+    }
+
+    // A retried job streams its cards again under a new generation
+    const generation: Generation = { id: randomUUID(), sequence: 0 };
+    this.generations.set(contentId, generation);
+    try {
+      const { cards } = await this.contentPipeline.process(content);
+      await this.contentModel.updateStatus(contentId, userId, ContentStatus.PROCESSED);
+      void cardStreamHandler.publish(userId, {
+        type: WS_CARD_EVENTS.CONTENT_PROCESSED,
+        contentId,
+        generationId: generation.id,
+        cardCount: cards.length
+      });
+      // Quiz questions for the new cards are built in the background
+      this.questionBank?.scheduleRefresh(contentId, userId).catch((error) =>
+        logger.warn('Question bank refresh not scheduled', { contentId, error: error.message })
+      );
+      logger.info('Content processed', {
+        contentId,
+        userId,
+        cardCount: cards.length,
+        stages: this.contentPipeline.getStats()
+      });
+      return { contentId, status: ContentStatus.PROCESSED, cardCount: cards.length };
+    } catch (error) {
+      await this.contentModel.updateStatus(contentId, userId, ContentStatus.ERROR);
+      void cardStreamHandler.publish(userId, {
+        type: WS_CARD_EVENTS.CONTENT_FAILED,
+        contentId,
+        generationId: generation.id,
+        error: error.message
+      });
+      logger.error('Content processing failed', {
+        contentId,
+        userId,
+        error: error.message
+      });
+      throw error;
+    } finally {
+      if (this.generations.get(contentId) === generation) {
+        this.generations.delete(contentId);
+      }
+    }
   }
 }
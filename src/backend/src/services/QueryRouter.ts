@@ -0,0 +1,274 @@
+/**
+ * @fileoverview Routes Supabase queries between the primary database and read replicas.
+ * Every operation is tagged as a read or a write. Writes go to the primary and record
+ * the primary's WAL position after the user's last write in Redis; reads go to a replica
+ * only when it is within the lag budget and has replayed up to that position, and to the
+ * primary otherwise. WAL positions are polled through the replica_status() function.
+ * Lag is the age of the newest primary position a replica has replayed, timed on this
+ * process's clock alone, and is exported as metrics.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { PostgrestClient } from '@supabase/postgrest-js'; // v1.8.4
+import { SupabaseClient } from '@supabase/supabase-js';
+import { logger } from '../config/logger';
+import { performanceMonitor } from '../core/monitoring/PerformanceMonitor';
+import { RECORD_WRITE_SCRIPT, walPosition } from '../utils/walPosition';
+
+const LAST_WRITE_PREFIX = 'db:lastwrite:';
+// Recorded when the write position cannot be read; no replica reaches it before it expires
+const PINNED_TO_PRIMARY = 'FFFFFFFFFFFFFFFF';
+const DEFAULT_MAX_LAG_MS = 10000;
+const DEFAULT_POLL_INTERVAL_MS = 5000;
+
+/**
+ * The part of a Supabase client a replica serves: table reads and read-only functions
+ */
+export type ReadClient = Pick<SupabaseClient<any, any, any>, 'from' | 'rpc'>;
+
+export interface ReadReplica {
+  name: string;
+  client: ReadClient;
+}
+
+export interface QueryRouterOptions {
+  /** Replicas further behind than this serve no reads */
+  maxLagMs?: number;
+  /** How often replica lag is polled */
+  pollIntervalMs?: number;
+}
+
+/**
+ * Why a read went where it did; exported as a metric label
+ */
+export type ReadRoute = 'replica' | 'no_replica' | 'replica_lagging' | 'recent_write';
+
+interface ReplicaState extends ReadReplica {
+  /**
+   * Null until the first successful poll, after a failed one, and while the replica is
+   * behind every primary position sampled within the lag window
+   */
+  lagMs: number | null;
+  /** WAL position replayed, as of the last poll */
+  replayed: string | null;
+  checkedAt: number;
+}
+
+/**
+ * The primary's WAL position at a poll
+ */
+interface PrimarySample {
+  position: string;
+  at: number;
+}
+
+export class QueryRouter {
+  private readonly replicas: ReplicaState[];
+  // Oldest first, covering the lag window
+  private primarySamples: PrimarySample[] = [];
+  private readonly maxLagMs: number;
+  private readonly pollIntervalMs: number;
+  private pollTimer: NodeJS.Timeout | null = null;
+  private nextReplica = 0;
+
+  /**
+   * @param primary Client for the primary; serves all writes
+   * @param replicas Read replicas; with none, every query goes to the primary
+   * @param redis Shared store for per-user last write positions
+   */
+  constructor(
+    public readonly primary: SupabaseClient,
+    replicas: ReadReplica[] = [],
+    private readonly redis?: Redis,
+    options: QueryRouterOptions = {}
+  ) {
+    this.replicas = replicas.map((replica) => ({ ...replica, lagMs: null, replayed: null, checkedAt: 0 }));
+    this.maxLagMs = options.maxLagMs ?? DEFAULT_MAX_LAG_MS;
+    this.pollIntervalMs = options.pollIntervalMs ?? DEFAULT_POLL_INTERVAL_MS;
+  }
+
+  /**
+   * Builds the router from SUPABASE_READ_REPLICA_URLS, a comma-separated list of
+   * replica REST endpoints, and starts polling their lag
+   */
+  public static fromEnv(primary: SupabaseClient, redis: Redis): QueryRouter {
+    const anonKey = process.env.SUPABASE_ANON_KEY || '';
+    const urls = (process.env.SUPABASE_READ_REPLICA_URLS || '').split(',').map((url) => url.trim()).filter(Boolean);
+    const replicas = urls.map((url, index) => ({
+      name: `replica-${index + 1}`,
+      client: new PostgrestClient(url, {
+        headers: { apikey: anonKey, Authorization: `Bearer ${anonKey}` }
+      }) as unknown as ReadClient
+    }));
+
+    const router = new QueryRouter(primary, replicas, redis, {
+      maxLagMs: Number(process.env.REPLICA_MAX_LAG_MS) || undefined
+    });
+    router.start();
+    return router;
+  }
+
+  /**
+   * Runs a read-only query on a replica when that is safe for the user, or on the primary
+   * @param userId User whose writes the read must see; null for reads with no owner
+   */
+  public async read<T>(userId: string | null, query: (client: ReadClient) => PromiseLike<T>): Promise<T> {
+    return query(await this.clientForRead(userId));
+  }
+
+  /**
+   * Runs a query on the primary and records the write for the user's later reads
+   */
+  public async write<T>(userId: string | null, query: (client: SupabaseClient) => PromiseLike<T>): Promise<T> {
+    try {
+      return await query(this.primary);
+    } finally {
+      // Recorded even on failure: a failed batch may have committed part of its rows
+      if (userId) {
+        await this.recordWrite(userId);
+      }
+    }
+  }
+
+  /**
+   * Notes that the user has just written, so their reads stay on the primary until
+   * replicas have replayed the write. If the primary's WAL position cannot be read,
+   * the user's reads stay on the primary until the record expires.
+   */
+  public async recordWrite(userId: string): Promise<void> {
+    if (!this.redis || this.replicas.length === 0) {
+      return;
+    }
+    let position = PINNED_TO_PRIMARY;
+    try {
+      position = (await this.walPosition(this.primary)) ?? PINNED_TO_PRIMARY;
+    } catch (error) {
+      logger.warn('Failed to read primary WAL position', { userId, error: error.message });
+    }
+    try {
+      // Past this, any replica still eligible for reads has replayed the write
+      await this.redis.eval(
+        RECORD_WRITE_SCRIPT,
+        1,
+        `${LAST_WRITE_PREFIX}${userId}`,
+        position,
+        this.maxLagMs + 2 * this.pollIntervalMs
+      );
+    } catch (error) {
+      logger.warn('Failed to record last write', { userId, error: error.message });
+    }
+  }
+
+  public start(): void {
+    if (this.replicas.length === 0 || this.pollTimer) {
+      return;
+    }
+    void this.pollReplicas();
+    this.pollTimer = setInterval(() => void this.pollReplicas(), this.pollIntervalMs);
+    this.pollTimer.unref();
+  }
+
+  public stop(): void {
+    if (this.pollTimer) {
+      clearInterval(this.pollTimer);
+      this.pollTimer = null;
+    }
+  }
+
+  /**
+   * Samples the primary's WAL position, then measures every replica's lag against the
+   * samples it has replayed
+   */
+  public async pollReplicas(): Promise<void> {
+    const sampledAt = Date.now();
+    try {
+      const position = await this.walPosition(this.primary);
+      if (position) {
+        this.primarySamples.push({ position, at: sampledAt });
+      }
+    } catch (error) {
+      // Replicas are still measured against earlier samples, so their lag keeps growing
+      logger.warn('Primary status check failed', { error: error.message });
+    }
+    const windowStart = sampledAt - this.maxLagMs - 2 * this.pollIntervalMs;
+    this.primarySamples = this.primarySamples.filter((sample) => sample.at >= windowStart);
+
+    await Promise.all(this.replicas.map(async (replica) => {
+      try {
+        const replayed = await this.walPosition(replica.client);
+        const polledAt = Date.now();
+        // Everything the primary had committed when this sample was taken is on the replica
+        const reached = replayed === null
+          ? undefined
+          : [...this.primarySamples].reverse().find((sample) => sample.position <= replayed);
+
+        replica.replayed = replayed;
+        replica.lagMs = reached ? polledAt - reached.at : null;
+        replica.checkedAt = polledAt;
+        performanceMonitor.trackReplicaLag(replica.name, replica.lagMs === null ? null : replica.lagMs / 1000);
+      } catch (error) {
+        replica.lagMs = null;
+        performanceMonitor.trackReplicaLag(replica.name, null);
+        logger.warn('Replica status check failed', { replica: replica.name, error: error.message });
+      }
+    }));
+  }
+
+  public getReplicaLag(): Record<string, number | null> {
+    return Object.fromEntries(this.replicas.map((replica) => [replica.name, replica.lagMs]));
+  }
+
+  private async clientForRead(userId: string | null): Promise<ReadClient> {
+    if (this.replicas.length === 0) {
+      return this.route('no_replica', this.primary);
+    }
+
+    const now = Date.now();
+    let candidates = this.replicas.filter((replica) =>
+      replica.lagMs !== null &&
+      replica.lagMs <= this.maxLagMs &&
+      now - replica.checkedAt <= 2 * this.pollIntervalMs
+    );
+    if (candidates.length === 0) {
+      return this.route('replica_lagging', this.primary);
+    }
+
+    if (userId && this.redis) {
+      let lastWrite: string | null;
+      try {
+        lastWrite = await this.redis.get(`${LAST_WRITE_PREFIX}${userId}`);
+      } catch (error) {
+        // Without the last write position a replica might miss it
+        logger.warn('Failed to read last write', { userId, error: error.message });
+        return this.route('recent_write', this.primary);
+      }
+      if (lastWrite !== null) {
+        const writtenThrough = lastWrite;
+        candidates = candidates.filter((replica) => replica.replayed !== null && replica.replayed >= writtenThrough);
+      }
+      if (candidates.length === 0) {
+        return this.route('recent_write', this.primary);
+      }
+    }
+
+    this.nextReplica = (this.nextReplica + 1) % candidates.length;
+    return this.route('replica', candidates[this.nextReplica].client);
+  }
+
+  /**
+   * Current WAL position of the primary, or the position a replica has replayed
+   */
+  private async walPosition(client: ReadClient): Promise<string | null> {
+    const { data, error } = await client.rpc('replica_status').single();
+    if (error) throw error;
+
+    const lsn = (data as { wal_lsn: string | null }).wal_lsn;
+    return lsn === null ? null : walPosition(lsn);
+  }
+
+  private route(route: ReadRoute, client: ReadClient): ReadClient {
+    performanceMonitor.recordReadRoute(route);
+    return client;
+  }
+}
@@ -0,0 +1,227 @@
+/**
+ * @fileoverview Service layer for precomputed quiz question banks.
+ * Builds one question per card in the background after card generation and refreshes
+ * only changed cards afterwards, so starting a quiz samples stored questions.
+ * @version 1.0.0
+ */
+
+import Bull from 'bull'; // ^4.10.0
+import { createHash } from 'crypto';
+import { logger } from '../config/logger';
+import { ICard } from '../interfaces/ICard';
+import { IQuizQuestion } from '../interfaces/IQuestionBank';
+import { Card } from '../models/Card';
+import { QuestionBank } from '../models/QuestionBank';
+import { QuizGenerator } from '../core/ai/quizGenerator';
+import { performanceMonitor } from '../core/monitoring/PerformanceMonitor';
+
+// Refreshes requested within this window for one content item run once
+const REFRESH_DELAY = 5000; // 5 seconds
+const REFRESH_CONCURRENCY = 4;
+const REFRESH_TIMEOUT = 2 * 60 * 1000; // 2 minutes
+const SWEEP_INTERVAL = 60 * 1000; // 1 minute
+const SWEEP_BATCH_SIZE = 200;
+const MAX_RETRIES = 3;
+
+export interface BankRefreshResult {
+  contentId: string;
+  version: number;
+  questionCount: number;
+  built: number;
+  reused: number;
+  removed: number;
+}
+
+/**
+ * Hash of the card text a question depends on
+ */
+export const cardHash = (card: ICard): string =>
+  createHash('md5')
+    .update(`${card.frontContent.text}\u0000${card.backContent.text}`)
+    .digest('hex');
+
+/**
+ * Builds, refreshes and samples per-content question banks
+ */
+export class QuestionBankService {
+  private readonly quizGenerator: QuizGenerator;
+  private readonly bankModel: QuestionBank;
+  private readonly cardModel: Card;
+  private refreshQueue: Bull.Queue;
+
+  constructor(
+    quizGenerator: QuizGenerator = new QuizGenerator(),
+    bankModel: QuestionBank = new QuestionBank(),
+    cardModel: Card = new Card()
+  ) {
+    this.quizGenerator = quizGenerator;
+    this.bankModel = bankModel;
+    this.cardModel = cardModel;
+    this.initializeQueue();
+  }
+
+  /**
+   * Initializes the refresh queue and the periodic sweep of banks marked stale by card writes
+   */
+  private initializeQueue(): void {
+    this.refreshQueue = new Bull('question-bank', {
+      redis: {
+        host: process.env.REDIS_HOST,
+        port: parseInt(process.env.REDIS_PORT || '6379'),
+        password: process.env.REDIS_PASSWORD
+      },
+      defaultJobOptions: {
+        attempts: MAX_RETRIES,
+        backoff: {
+          type: 'exponential',
+          delay: 1000
+        },
+        timeout: REFRESH_TIMEOUT
+      }
+    });
+
+    this.refreshQueue.process('refresh-bank', REFRESH_CONCURRENCY, (job) =>
+      this.refresh(job.data.contentId, job.data.userId)
+    );
+
+    this.refreshQueue.process('sweep-stale', 1, async () => {
+      const stale = await this.bankModel.findStale(SWEEP_BATCH_SIZE);
+      await Promise.all(stale.map(({ contentId, userId }) => this.scheduleRefresh(contentId, userId)));
+      return stale.length;
+    });
+
+    // Repeatable jobs are keyed by name and schedule, so every worker adding it shares one
+    this.refreshQueue.add('sweep-stale', {}, {
+      repeat: { every: SWEEP_INTERVAL },
+      removeOnComplete: true,
+      removeOnFail: true
+    }).catch((error) => logger.error('Failed to schedule question bank sweep', { error: error.message }));
+
+    this.refreshQueue.on('failed', (job, error) => {
+      logger.error('Question bank refresh failed', {
+        jobId: job.id,
+        contentId: job.data.contentId,
+        error: error.message
+      });
+    });
+  }
+
+  /**
+   * Queues a refresh of a content item's bank. Requests for the same content item
+   * share one delayed job while it is waiting.
+   * @param contentId Content identifier
+   * @param userId Owner of the content
+   */
+  public async scheduleRefresh(contentId: string, userId: string): Promise<void> {
+    await this.refreshQueue.add(
+      'refresh-bank',
+      { contentId, userId },
+      {
+        jobId: `bank:${contentId}`,
+        delay: REFRESH_DELAY,
+        removeOnComplete: true,
+        removeOnFail: true
+      }
+    );
+  }
+
+  /**
+   * Brings a content item's bank up to date with its cards. Questions are rebuilt only
+   * for new and changed cards; the whole deck still supplies distractors.
+   * @param contentId Content identifier
+   * @param userId Owner of the content
+   * @returns Summary of the written bank version
+   */
+  public async refresh(contentId: string, userId: string): Promise<BankRefreshResult> {
+    const startedAt = new Date();
+    const started = process.hrtime.bigint();
+    let failed = false;
+
+    try {
+      const [deck, bank, storedHashes] = await Promise.all([
+        this.cardModel.findByUserId(userId),
+        this.bankModel.findBank(contentId),
+        this.bankModel.findCardHashes(contentId)
+      ]);
+
+      const hashes = new Map(deck
+        .filter((card) => card.contentId === contentId)
+        .map((card) => [card.id, cardHash(card)]));
+      const changed = new Set([...hashes]
+        .filter(([cardId, hash]) => storedHashes.get(cardId) !== hash)
+        .map(([cardId]) => cardId));
+
+      const version = (bank?.version ?? 0) + 1;
+      const built = changed.size === 0 ? [] : await this.quizGenerator.buildDeckQuestions(userId, deck, {
+        questionCount: changed.size,
+        cardIds: changed,
+        priority: 'batch'
+      });
+      const questions: IQuizQuestion[] = built.map(({ card, question }) => ({
+        cardId: card.id,
+        contentId,
+        userId,
+        cardHash: hashes.get(card.id) as string,
+        bankVersion: version,
+        question: question.question,
+        type: question.type,
+        options: question.options ?? [],
+        correctAnswer: question.correctAnswer,
+        explanation: question.explanation
+      }));
+
+      // Deleted cards, and changed cards that no longer yield a question
+      const rebuilt = new Set(questions.map((question) => question.cardId));
+      const removed = [...storedHashes.keys()]
+        .filter((cardId) => !hashes.has(cardId) || (changed.has(cardId) && !rebuilt.has(cardId)));
+      const reused = storedHashes.size - removed.length - [...rebuilt].filter((id) => storedHashes.has(id)).length;
+      const questionCount = reused + questions.length;
+      // A refresh that finds nothing to change only clears the stale mark
+      const savedVersion = questions.length > 0 || removed.length > 0 ? version : bank?.version ?? version;
+
+      await this.bankModel.saveVersion(
+        { contentId, userId, version: savedVersion, questionCount },
+        questions,
+        removed,
+        startedAt
+      );
+      performanceMonitor.trackQuestionBankRefresh(questions.length, reused);
+
+      return {
+        contentId,
+        version: savedVersion,
+        questionCount,
+        built: questions.length,
+        reused,
+        removed: removed.length
+      };
+    } catch (error) {
+      failed = true;
+      throw error;
+    } finally {
+      performanceMonitor.recordPipelineStage(
+        'question-bank', 'refresh', Number(process.hrtime.bigint() - started) / 1e9, failed);
+    }
+  }
+
+  /**
+   * Samples stored questions to start a quiz
+   * @param userId User identifier
+   * @param count Number of questions
+   * @param contentId Restricts the quiz to one content item
+   */
+  public async sampleQuiz(userId: string, count: number, contentId?: string): Promise<IQuizQuestion[]> {
+    const started = process.hrtime.bigint();
+    let failed = false;
+
+    try {
+      return await this.bankModel.sample(userId, count, contentId);
+    } catch (error) {
+      failed = true;
+      throw error;
+    } finally {
+      performanceMonitor.recordPipelineStage(
+        'quiz', 'start', Number(process.hrtime.bigint() - started) / 1e9, failed);
+    }
+  }
+}
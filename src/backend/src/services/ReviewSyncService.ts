@@ -0,0 +1,75 @@
+/**
+ * @fileoverview Service layer for offline review sync.
+ * Stores the reviews a device recorded in its local card store and returns what the
+ * device is missing: reviews made on the user's other devices and cards changed on
+ * the server since its last sync.
+ * @version 1.0.0
+ */
+
+import { ICard } from '../interfaces/ICard';
+import { ISyncedCard, IReviewSyncRequest, IReviewSyncResponse } from '../interfaces/IReviewSync';
+import { Card } from '../models/Card';
+import { ReviewLog } from '../models/ReviewLog';
+
+// Page sizes per sync round trip; a full page sets hasMore
+const MAX_PULLED_REVIEWS = 500;
+const MAX_PULLED_CARDS = 500;
+
+const toMillis = (value: Date | string | null | undefined): number | null =>
+  value ? new Date(value).getTime() : null;
+
+/**
+ * Card in the shape the device's card store upserts
+ */
+export const toSyncedCard = (card: ICard): ISyncedCard => ({
+  id: card.id,
+  contentId: card.contentId ?? null,
+  front: card.frontContent.text,
+  back: card.backContent.text,
+  stability: card.fsrsData.stability,
+  difficulty: card.fsrsData.difficulty,
+  reviewCount: card.fsrsData.reviewCount ?? 0,
+  lastRating: card.fsrsData.lastRating ?? 0,
+  lastReviewAt: toMillis(card.fsrsData.lastReview),
+  dueAt: toMillis(card.nextReview) ?? Date.now()
+});
+
+/**
+ * Exchanges review-log deltas with offline devices
+ */
+export class ReviewSyncService {
+  private readonly reviewLog: ReviewLog;
+  private readonly cardModel: Card;
+
+  constructor(reviewLog: ReviewLog = new ReviewLog(), cardModel: Card = new Card()) {
+    this.reviewLog = reviewLog;
+    this.cardModel = cardModel;
+  }
+
+  /**
+   * Runs one sync round for a device
+   * @param userId Device owner
+   * @param request Pushed reviews and pull cursors
+   * @returns Acknowledged push sequence, pulled reviews and changed cards
+   */
+  async sync(userId: string, request: IReviewSyncRequest): Promise<IReviewSyncResponse> {
+    // The push goes first, so the cards pulled below already carry its reviews
+    const acknowledged = request.reviews.length > 0
+      ? await this.reviewLog.append(userId, request.deviceId, request.reviews)
+      : 0;
+
+    const [reviews, cards] = await Promise.all([
+      this.reviewLog.since(userId, request.deviceId, request.cursor, MAX_PULLED_REVIEWS),
+      this.cardModel.findUpdatedSince(userId, new Date(request.cardsSince), MAX_PULLED_CARDS)
+    ]);
+
+    const lastCard = cards[cards.length - 1] as (ICard & { updatedAt?: Date | string }) | undefined;
+    return {
+      acknowledged,
+      reviews,
+      cards: cards.map(toSyncedCard),
+      cardsSyncedAt: toMillis(lastCard?.updatedAt) ?? request.cardsSince,
+      hasMore: reviews.length === MAX_PULLED_REVIEWS || cards.length === MAX_PULLED_CARDS
+    };
+  }
+}
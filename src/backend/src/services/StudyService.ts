@@ -8,6 +8,10 @@ import { IStudySession } from '../interfaces/IStudySession';
 import { StudySessionManager } from '../core/study/studySessionManager';
 import { FSRSAlgorithm } from '../core/study/FSRSAlgorithm';
 import { CardScheduler } from '../core/study/cardScheduler';
+import { PerformanceAnalyzer } from '../core/study/performanceAnalyzer';
+import { Card } from '../models/Card';
+import { QuestionBankService } from './QuestionBankService';
+import { StudyModes } from '../constants/studyModes';
 import dayjs from 'dayjs'; // ^1.11.0
 
 /**
@@ -18,17 +22,37 @@ export class StudyService {
     private readonly sessionManager: StudySessionManager;
     private readonly fsrsAlgorithm: FSRSAlgorithm;
     private readonly cardScheduler: CardScheduler;
+    private readonly questionBank?: QuestionBankService;
     private readonly retentionTarget: number = 0.85;
     private readonly minStreakDays: number = 14;
 
     constructor(
         sessionManager: StudySessionManager,
         fsrsAlgorithm: FSRSAlgorithm,
-        cardScheduler: CardScheduler
+        cardScheduler: CardScheduler,
+        questionBank?: QuestionBankService
     ) {
         this.sessionManager = sessionManager;
         this.fsrsAlgorithm = fsrsAlgorithm;
         this.cardScheduler = cardScheduler;
+        this.questionBank = questionBank;
+    }
+
+    /**
+     * Builds the service on the shared card model with its own FSRS, scheduler and
+     * session manager, as the API router serves it
+     * @param questionBank Precomputed quiz questions; quiz sessions sample from it
+     * @param cardModel Card storage the scheduler reads due cards from
+     */
+    public static create(questionBank?: QuestionBankService, cardModel: Card = new Card()): StudyService {
+        const fsrsAlgorithm = new FSRSAlgorithm();
+        const cardScheduler = new CardScheduler(fsrsAlgorithm, cardModel);
+        const sessionManager = new StudySessionManager(
+            fsrsAlgorithm,
+            cardScheduler,
+            new PerformanceAnalyzer(fsrsAlgorithm, cardScheduler)
+        );
+        return new StudyService(sessionManager, fsrsAlgorithm, cardScheduler, questionBank);
     }
 
     /**
@@ -56,6 +80,11 @@ export class StudyService {
             enhancedSettings
         );
 
+        // Quiz sessions draw questions precomputed in the background
+        if (mode === StudyModes.QUIZ && this.questionBank) {
+            session.quizQuestions = await this.questionBank.sampleQuiz(userId, batchSize);
+        }
+
         // Initialize comprehensive performance tracking
         await this.initializePerformanceTracking(session);
 
@@ -13,6 +13,7 @@ import { LRUCache } from 'lru-cache';
 import { StudyModes } from '../constants/studyModes';
 import { injectable } from 'tsyringe';
 import { redisManager } from '../config/redis';
+import { sha256Hex } from '../core/workers/cpuTasks';
 
 /**
  * Interface for voice processing metrics
@@ -133,7 +134,7 @@ export class VoiceService {
       this.validateAudioConstraints(audioData);
 
       // Generate cache key
-      const cacheKey = this.generateCacheKey(audioData, expectedAnswer, language);
+      const cacheKey = await this.generateCacheKey(audioData, expectedAnswer, language);
       const cachedResult = this.cache.get(cacheKey);
 
       if (cachedResult) {
@@ -297,18 +298,15 @@ export class VoiceService {
   }
 
   /**
-   * Generates cache key for voice processing results
+   * Generates cache key for voice processing results; long recordings are hashed on the worker pool
    * @private
    */
-  private generateCacheKey(
+  private async generateCacheKey(
     audioData: Buffer,
     expectedAnswer: string,
     language: string
-  ): string {
-    const audioHash = require('crypto')
-      .createHash('sha256')
-      .update(audioData)
-      .digest('hex');
+  ): Promise<string> {
+    const audioHash = await sha256Hex(audioData);
     return `voice:${audioHash}:${language}:${expectedAnswer}`;
   }
 
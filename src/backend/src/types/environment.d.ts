@@ -82,6 +82,12 @@ declare global {
        */
       OPENAI_REQUEST_TIMEOUT: string;
 
+      /**
+       * Tokens per minute shared by all workers; 0 disables the budget
+       * @default 0
+       */
+      OPENAI_TOKENS_PER_MINUTE?: string;
+
       /**
        * Supabase project URL
        * @required
@@ -0,0 +1,137 @@
+/**
+ * @fileoverview Request-scoped batching and memoization for row lookups.
+ * Loads issued in the same tick are coalesced into one batch call, and each key is
+ * fetched at most once per scope: one HTTP request or one websocket message. Outside a
+ * scope there is no shared loader, and models query directly.
+ * @version 1.0.0
+ */
+
+import { AsyncLocalStorage } from 'async_hooks';
+
+/**
+ * Fetches rows for a batch of keys; keys missing from the result load as null
+ */
+export type BatchLoadFn<K, V> = (keys: K[]) => Promise<Map<K, V>>;
+
+export interface BatchLoaderOptions {
+  /** Keys per batch call; keeps `.in()` filters within URL limits */
+  maxBatchSize?: number;
+}
+
+export interface BatchLoaderStats {
+  /** Calls to load */
+  loads: number;
+  /** Loads served from the memo */
+  memoHits: number;
+  /** Batch calls made */
+  batches: number;
+}
+
+interface PendingLoad<K, V> {
+  key: K;
+  resolve: (value: V | null) => void;
+  reject: (error: unknown) => void;
+}
+
+/**
+ * DataLoader-style loader: coalesces loads into batches and memoizes results per key.
+ * A failed load is dropped from the memo so a later load retries it.
+ */
+export class BatchLoader<K, V> {
+  private readonly memo = new Map<K, Promise<V | null>>();
+  private readonly maxBatchSize: number;
+  private readonly stats: BatchLoaderStats = { loads: 0, memoHits: 0, batches: 0 };
+  private queue: Array<PendingLoad<K, V>> = [];
+
+  constructor(private readonly loadBatch: BatchLoadFn<K, V>, options: BatchLoaderOptions = {}) {
+    this.maxBatchSize = options.maxBatchSize ?? 100;
+  }
+
+  public load(key: K): Promise<V | null> {
+    this.stats.loads++;
+    const memoized = this.memo.get(key);
+    if (memoized) {
+      this.stats.memoHits++;
+      return memoized;
+    }
+
+    const loading = new Promise<V | null>((resolve, reject) => {
+      this.queue.push({ key, resolve, reject });
+      if (this.queue.length === 1) {
+        // After pending promise callbacks, so loads issued across awaits of settled promises join the batch
+        Promise.resolve().then(() => process.nextTick(() => this.dispatch()));
+      }
+    });
+    this.memo.set(key, loading);
+    loading.catch(() => {
+      if (this.memo.get(key) === loading) {
+        this.memo.delete(key);
+      }
+    });
+    return loading;
+  }
+
+  public loadMany(keys: K[]): Promise<Array<V | null>> {
+    return Promise.all(keys.map((key) => this.load(key)));
+  }
+
+  /**
+   * Records a value the caller already has, such as a row it just wrote
+   */
+  public prime(key: K, value: V): void {
+    this.memo.set(key, Promise.resolve(value));
+  }
+
+  /**
+   * Forgets a key after a write the caller cannot prime with
+   */
+  public clear(key: K): void {
+    this.memo.delete(key);
+  }
+
+  public getStats(): BatchLoaderStats {
+    return { ...this.stats };
+  }
+
+  private dispatch(): void {
+    const pending = this.queue;
+    this.queue = [];
+    for (let start = 0; start < pending.length; start += this.maxBatchSize) {
+      this.runBatch(pending.slice(start, start + this.maxBatchSize));
+    }
+  }
+
+  private async runBatch(batch: Array<PendingLoad<K, V>>): Promise<void> {
+    this.stats.batches++;
+    try {
+      const rows = await this.loadBatch(batch.map((load) => load.key));
+      batch.forEach((load) => load.resolve(rows.get(load.key) ?? null));
+    } catch (error) {
+      batch.forEach((load) => load.reject(error));
+    }
+  }
+}
+
+const loaderScope = new AsyncLocalStorage<Map<string, BatchLoader<unknown, unknown>>>();
+
+/**
+ * Runs `fn` with a fresh set of loaders, shared by everything it calls
+ */
+export const runInLoaderScope = <T>(fn: () => T): T => loaderScope.run(new Map(), fn);
+
+/**
+ * Returns the current scope's loader for `name`, creating it on first use,
+ * or null outside a scope
+ */
+export const scopedLoader = <K, V>(name: string, create: () => BatchLoader<K, V>): BatchLoader<K, V> | null => {
+  const loaders = loaderScope.getStore();
+  if (!loaders) {
+    return null;
+  }
+  let loader = loaders.get(name) as BatchLoader<K, V> | undefined;
+  if (!loader) {
+    loader = create();
+    loaders.set(name, loader as BatchLoader<unknown, unknown>);
+  }
+  return loader;
+};
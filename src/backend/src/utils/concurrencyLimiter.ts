@@ -0,0 +1,317 @@
+/**
+ * @fileoverview Cluster-wide adaptive concurrency limiter for calls to a shared provider.
+ * All workers draw permits from one Redis-backed pool whose size follows AIMD: it grows
+ * by one slot per window of successful calls and halves when the provider throttles.
+ * Permits also reserve from a per-minute token budget, and interactive callers keep a
+ * share of the pool that batch work cannot take.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { randomUUID } from 'crypto';
+
+const TOKEN_WINDOW_MS = 60000;
+
+export type ConcurrencyPriority = 'interactive' | 'batch';
+
+// Result codes of ACQUIRE_SCRIPT
+const ACQUIRED = 1;
+const BUDGET_EXHAUSTED = 2;
+
+/**
+ * Takes a slot when the pool has room for the caller's priority.
+ * KEYS: in-flight permits, limit, pause, interactive waiters, token window
+ * ARGV: permit, now, lease ms, pool share, initial limit, tokens, token budget, priority
+ * Returns {code, wait ms}: 1 acquired, 2 token budget spent, 0 otherwise
+ */
+export const ACQUIRE_SCRIPT = `
+local now = tonumber(ARGV[2])
+local pause = tonumber(redis.call('get', KEYS[3]) or '0')
+if pause > now then
+  return {0, pause - now}
+end
+redis.call('zremrangebyscore', KEYS[1], '-inf', now)
+redis.call('zremrangebyscore', KEYS[4], '-inf', now)
+if ARGV[8] == 'batch' and redis.call('zcard', KEYS[4]) > 0 then
+  return {0, 0}
+end
+local limit = tonumber(redis.call('get', KEYS[2]) or ARGV[5])
+local capacity = math.max(1, math.floor(limit * tonumber(ARGV[4])))
+local acquired = redis.call('zcard', KEYS[1]) < capacity
+if acquired and tonumber(ARGV[7]) > 0 then
+  local used = tonumber(redis.call('get', KEYS[5]) or '0')
+  if used > 0 and used + tonumber(ARGV[6]) > tonumber(ARGV[7]) then
+    return {2, 0}
+  end
+  redis.call('incrby', KEYS[5], ARGV[6])
+  redis.call('pexpire', KEYS[5], ${TOKEN_WINDOW_MS * 2})
+end
+if not acquired then
+  if ARGV[8] == 'interactive' then
+    redis.call('zadd', KEYS[4], now + 1000, ARGV[1])
+  end
+  return {0, 0}
+end
+redis.call('zrem', KEYS[4], ARGV[1])
+redis.call('zadd', KEYS[1], now + tonumber(ARGV[3]), ARGV[1])
+return {1, 0}`;
+
+/**
+ * Applies AIMD feedback to the shared limit.
+ * KEYS: limit, last decrease, pause
+ * ARGV: outcome, now, initial, min, max limit, decrease factor, cooldown ms, retry-after ms
+ * Returns the new limit
+ */
+export const FEEDBACK_SCRIPT = `
+local now = tonumber(ARGV[2])
+local limit = tonumber(redis.call('get', KEYS[1]) or ARGV[3])
+if ARGV[1] == 'success' then
+  limit = math.min(tonumber(ARGV[5]), limit + 1 / limit)
+else
+  if not redis.call('get', KEYS[2]) then
+    limit = math.max(tonumber(ARGV[4]), limit * tonumber(ARGV[6]))
+    redis.call('set', KEYS[2], now, 'PX', ARGV[7])
+  end
+  local retryAfter = tonumber(ARGV[8])
+  if retryAfter > 0 and now + retryAfter > tonumber(redis.call('get', KEYS[3]) or '0') then
+    redis.call('set', KEYS[3], now + retryAfter, 'PX', retryAfter)
+  end
+end
+redis.call('set', KEYS[1], tostring(limit))
+return tostring(limit)`;
+
+export interface ConcurrencyLimiterOptions {
+  /** Key namespace, one per provider account */
+  name?: string;
+  initialLimit?: number;
+  minLimit?: number;
+  maxLimit?: number;
+  /** Multiplier applied to the limit when the provider throttles */
+  decreaseFactor?: number;
+  /** Throttles within this window after a decrease count as the same congestion event */
+  decreaseCooldownMs?: number;
+  /** Share of the limit batch callers may hold; the rest is kept for interactive ones */
+  batchShare?: number;
+  /** Tokens all workers may reserve per minute; 0 disables the budget */
+  tokensPerMinute?: number;
+  /** Permits of a worker that died are reclaimed after this long */
+  leaseMs?: number;
+  /** Longest a caller waits for a permit */
+  acquireTimeoutMs?: number;
+  /** Interval between attempts while the pool is full */
+  pollMs?: number;
+  /** A Redis round trip slower than this counts as Redis being unavailable */
+  redisTimeoutMs?: number;
+}
+
+export interface ConcurrencyLimiterStats {
+  acquired: number;
+  /** Acquisitions that had to wait for a slot, the budget or a provider pause */
+  queued: number;
+  throttled: number;
+  timeouts: number;
+  /** Calls let through unlimited because Redis was unavailable */
+  bypassed: number;
+  /** Limit seen in the most recent feedback */
+  limit: number;
+}
+
+/**
+ * Held for the duration of one provider call. Report exactly one outcome;
+ * later calls are ignored.
+ */
+export interface ConcurrencyPermit {
+  /** Call succeeded; `usedTokens` corrects the reservation when known */
+  succeed(usedTokens?: number): Promise<void>;
+  /** Provider throttled the call; everyone waits `retryAfterMs` when given */
+  throttle(retryAfterMs?: number): Promise<void>;
+  /** Call ended without a signal about provider capacity */
+  release(): Promise<void>;
+}
+
+const UNLIMITED_PERMIT: ConcurrencyPermit = {
+  succeed: async () => undefined,
+  throttle: async () => undefined,
+  release: async () => undefined
+};
+
+/**
+ * Shares one adaptive concurrency limit and token budget across processes
+ */
+export class ConcurrencyLimiter {
+  private readonly prefix: string;
+  private readonly initialLimit: number;
+  private readonly minLimit: number;
+  private readonly maxLimit: number;
+  private readonly decreaseFactor: number;
+  private readonly decreaseCooldownMs: number;
+  private readonly batchShare: number;
+  private readonly tokensPerMinute: number;
+  private readonly leaseMs: number;
+  private readonly acquireTimeoutMs: number;
+  private readonly pollMs: number;
+  private readonly redisTimeoutMs: number;
+  // Wakes local waiters as soon as a permit of this process is returned
+  private readonly wakers = new Set<() => void>();
+  private readonly stats: ConcurrencyLimiterStats;
+
+  constructor(private readonly client: Redis, options: ConcurrencyLimiterOptions = {}) {
+    // The hash tag keeps all keys of one limiter in one Redis Cluster slot, as its scripts require
+    this.prefix = `concurrency:{${options.name ?? 'default'}}:`;
+    this.initialLimit = options.initialLimit ?? 8;
+    this.minLimit = options.minLimit ?? 1;
+    this.maxLimit = options.maxLimit ?? 64;
+    this.decreaseFactor = options.decreaseFactor ?? 0.5;
+    this.decreaseCooldownMs = options.decreaseCooldownMs ?? 2000;
+    this.batchShare = options.batchShare ?? 0.75;
+    this.tokensPerMinute = options.tokensPerMinute ?? 0;
+    this.leaseMs = options.leaseMs ?? 120000;
+    this.acquireTimeoutMs = options.acquireTimeoutMs ?? 60000;
+    this.pollMs = options.pollMs ?? 50;
+    this.redisTimeoutMs = options.redisTimeoutMs ?? 500;
+    this.stats = { acquired: 0, queued: 0, throttled: 0, timeouts: 0, bypassed: 0, limit: this.initialLimit };
+  }
+
+  /**
+   * Waits for a slot and reserves `estimatedTokens` from the current minute's budget.
+   * Fails open: if Redis is unreachable or slower than the Redis timeout the call
+   * proceeds without a permit.
+   * @throws Error when no slot frees up within the acquire timeout
+   */
+  public async acquire(priority: ConcurrencyPriority, estimatedTokens = 0): Promise<ConcurrencyPermit> {
+    const id = randomUUID();
+    const deadline = Date.now() + this.acquireTimeoutMs;
+    let queued = false;
+
+    while (true) {
+      const now = Date.now();
+      const window = Math.floor(now / TOKEN_WINDOW_MS);
+      const tokensKey = `${this.prefix}tokens:${window}`;
+      let result: [number, number];
+      try {
+        result = await this.withTimeout(this.client.eval(
+          ACQUIRE_SCRIPT,
+          5,
+          this.key('inflight'),
+          this.key('limit'),
+          this.key('pause'),
+          this.key('waiting'),
+          tokensKey,
+          id,
+          now,
+          this.leaseMs,
+          priority === 'batch' ? this.batchShare : 1,
+          this.initialLimit,
+          Math.ceil(estimatedTokens),
+          this.tokensPerMinute,
+          priority
+        )) as [number, number];
+      } catch {
+        this.stats.bypassed++;
+        return UNLIMITED_PERMIT;
+      }
+      const [code, waitMs] = result;
+
+      if (code === ACQUIRED) {
+        this.stats.acquired++;
+        if (queued) {
+          this.stats.queued++;
+        }
+        return this.permit(id, tokensKey, Math.ceil(estimatedTokens));
+      }
+
+      queued = true;
+      if (Date.now() >= deadline) {
+        this.stats.timeouts++;
+        await this.withTimeout(this.client.zrem(this.key('waiting'), id)).catch(() => undefined);
+        throw new Error(`Timed out waiting for ${priority} concurrency`);
+      }
+
+      // Sleep until the pause or token window ends, or a local permit is returned.
+      // Jitter spreads the waiters of all workers so they do not retry in lockstep.
+      const until = code === BUDGET_EXHAUSTED ? TOKEN_WINDOW_MS - (now % TOKEN_WINDOW_MS) : waitMs;
+      await this.wait(Math.min(until + this.pollMs * (0.5 + Math.random()), deadline - Date.now()));
+    }
+  }
+
+  public getStats(): ConcurrencyLimiterStats {
+    return { ...this.stats };
+  }
+
+  private permit(id: string, tokensKey: string, reserved: number): ConcurrencyPermit {
+    let settled = false;
+    const settle = async (feedback?: () => Promise<void>, usedTokens?: number) => {
+      if (settled) {
+        return;
+      }
+      settled = true;
+      // The lease reclaims the slot if Redis cannot be reached now
+      try {
+        const release = this.client.pipeline().zrem(this.key('inflight'), id);
+        if (this.tokensPerMinute > 0 && usedTokens !== undefined && usedTokens !== reserved) {
+          release.incrby(tokensKey, usedTokens - reserved);
+        }
+        await this.withTimeout(release.exec());
+        this.wakers.forEach((wake) => wake());
+        await feedback?.();
+      } catch {
+        // Feedback is advisory; the call itself already finished
+      }
+    };
+
+    return {
+      succeed: (usedTokens) => settle(() => this.feedback('success'), usedTokens),
+      throttle: (retryAfterMs = 0) => settle(() => this.feedback('throttle', retryAfterMs)),
+      release: () => settle()
+    };
+  }
+
+  private async feedback(outcome: 'success' | 'throttle', retryAfterMs = 0): Promise<void> {
+    if (outcome === 'throttle') {
+      this.stats.throttled++;
+    }
+    const limit = await this.withTimeout(this.client.eval(
+      FEEDBACK_SCRIPT,
+      3,
+      this.key('limit'),
+      this.key('decreased'),
+      this.key('pause'),
+      outcome,
+      Date.now(),
+      this.initialLimit,
+      this.minLimit,
+      this.maxLimit,
+      this.decreaseFactor,
+      this.decreaseCooldownMs,
+      Math.ceil(retryAfterMs)
+    ));
+    this.stats.limit = Number(limit);
+  }
+
+  /**
+   * Rejects when `command` takes longer than the Redis timeout
+   */
+  private withTimeout<T>(command: Promise<T>): Promise<T> {
+    let timer: NodeJS.Timeout | undefined;
+    const timeout = new Promise<never>((_, reject) => {
+      timer = setTimeout(() => reject(new Error('Redis command timed out')), this.redisTimeoutMs);
+    });
+    return Promise.race([command, timeout]).finally(() => clearTimeout(timer));
+  }
+
+  private wait(ms: number): Promise<void> {
+    return new Promise((resolve) => {
+      const wake = () => {
+        clearTimeout(timer);
+        this.wakers.delete(wake);
+        resolve();
+      };
+      const timer = setTimeout(wake, Math.max(0, ms));
+      this.wakers.add(wake);
+    });
+  }
+
+  private key(name: string): string {
+    return `${this.prefix}${name}`;
+  }
+}
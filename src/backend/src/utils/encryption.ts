@@ -1,4 +1,5 @@
 import { randomBytes, createCipheriv, createDecipheriv } from 'crypto';
+import { runCpuTask } from '../core/workers/cpuTasks';
 
 // Constants for encryption configuration
 const ENCRYPTION_KEY = process.env.ENCRYPTION_KEY || (() => { throw new Error('Encryption key not configured'); })();
@@ -108,6 +109,24 @@ export const decrypt = (encryptedData: string): string => {
   }
 };
 
+/**
+ * Encrypts data on the worker pool when it is large
+ * @param data - String or object to encrypt
+ * @returns Encrypted string in the format of encrypt
+ */
+export const encryptAsync = (data: string | object): Promise<string> => {
+  const stringData = typeof data === 'string' ? data : JSON.stringify(data);
+  return runCpuTask('encrypt', stringData, stringData.length);
+};
+
+/**
+ * Decrypts data on the worker pool when it is large
+ * @param encryptedData - Encrypted string in format: iv:encryptedData:authTag
+ * @returns Decrypted string
+ */
+export const decryptAsync = (encryptedData: string): Promise<string> =>
+  runCpuTask('decrypt', encryptedData, encryptedData.length);
+
 /**
  * Encrypts a specific field in an object
  * @param object - Source object
@@ -0,0 +1,160 @@
+/**
+ * @fileoverview Schema-driven JSON stringifiers for hot API responses.
+ * A stringifier is compiled once from a JSON Schema subset into generated functions
+ * that emit known keys in schema order, with type checks and leaf formatting inlined.
+ * Output is byte-identical to JSON.stringify: any value that does not match its
+ * schema, including an object whose keys are out of schema order or not in the schema,
+ * is handed to JSON.stringify.
+ * @version 1.0.0
+ */
+
+import { Response } from 'express'; // ^4.18.2
+
+/**
+ * JSON Schema subset understood by compileStringifier. A schema without a type
+ * serializes its value with JSON.stringify.
+ */
+export type JsonSchema =
+  | { type: 'string'; format?: 'date-time' }
+  | { type: 'number' | 'integer' | 'boolean' }
+  | { type: 'object'; properties: Record<string, JsonSchema> }
+  | { type: 'array'; items: JsonSchema }
+  | { type?: undefined };
+
+/** Serializes one value; undefined means the value is omitted, as with JSON.stringify */
+type Emitter = (value: any) => string | undefined;
+
+// Characters JSON.stringify escapes, including lone surrogates; pairs also take the slow path
+const NEEDS_ESCAPE = /[\u0000-\u001f"\\\ud800-\udfff]/;
+
+const generic: Emitter = (value) => JSON.stringify(value);
+
+const quote = (value: string): string =>
+  NEEDS_ESCAPE.test(value) ? JSON.stringify(value) : `"${value}"`;
+
+// Date.prototype.toJSON: invalid dates serialize as null
+const dateTime = (value: Date): string =>
+  Number.isFinite(value.getTime()) ? `"${value.toISOString()}"` : 'null';
+
+/**
+ * The compiled object path emits in schema order, so it only applies to plain objects
+ * whose keys are an in-order subset of the schema's
+ */
+const matchesKeys = (value: any, keys: string[]): boolean => {
+  if (value === null || typeof value !== 'object' || Object.getPrototypeOf(value) !== Object.prototype) {
+    return false;
+  }
+  let next = 0;
+  for (const key in value) {
+    while (next < keys.length && keys[next] !== key) next++;
+    if (next === keys.length) return false;
+    next++;
+  }
+  return true;
+};
+
+/**
+ * Generates source for an expression serializing `variable`. Leaf types are inlined;
+ * objects and arrays are compiled into their own functions, reached through `emitters`.
+ */
+const expression = (schema: JsonSchema, variable: string, emitters: Emitter[]): string => {
+  switch (schema.type) {
+    case 'string':
+      return schema.format === 'date-time'
+        ? `(${variable} instanceof Date ? dateTime(${variable}) : ` +
+          `typeof ${variable} === 'string' ? quote(${variable}) : generic(${variable}))`
+        : `(typeof ${variable} === 'string' ? quote(${variable}) : generic(${variable}))`;
+    case 'number':
+    case 'integer':
+      return `(typeof ${variable} === 'number' ? (Number.isFinite(${variable}) ? '' + ${variable} : 'null') : generic(${variable}))`;
+    case 'boolean':
+      return `(${variable} === true ? 'true' : ${variable} === false ? 'false' : generic(${variable}))`;
+    case 'object':
+    case 'array':
+      emitters.push(compileEmitter(schema));
+      return `emitters[${emitters.length - 1}](${variable})`;
+    default:
+      return `generic(${variable})`;
+  }
+};
+
+const build = (source: string, emitters: Emitter[], keys: string[] = []): Emitter =>
+  // eslint-disable-next-line @typescript-eslint/no-implied-eval
+  new Function('quote', 'generic', 'dateTime', 'matchesKeys', 'emitters', 'keys', source)(
+    quote, generic, dateTime, matchesKeys, emitters, keys
+  );
+
+const compileObject = (properties: Record<string, JsonSchema>): Emitter => {
+  const keys = Object.keys(properties);
+  const emitters: Emitter[] = [];
+  const fields = keys.map((key) => {
+    const name = JSON.stringify(key);
+    return `
+      value = object[${name}];
+      if (value !== undefined) {
+        field = ${expression(properties[key], 'value', emitters)};
+        if (field !== undefined) {
+          json += (first ? '' : ',') + ${JSON.stringify(`${name}:`)} + field;
+          first = false;
+        }
+      }`;
+  });
+  return build(`
+    return function (object) {
+      if (!matchesKeys(object, keys)) return generic(object);
+      let json = '{', first = true, value, field;
+      ${fields.join('')}
+      return json + '}';
+    };`, emitters, keys);
+};
+
+const compileArray = (items: JsonSchema): Emitter => {
+  const emitters: Emitter[] = [];
+  return build(`
+    return function (array) {
+      if (!Array.isArray(array)) return generic(array);
+      let json = '[';
+      for (let i = 0; i < array.length; i++) {
+        const item = array[i];
+        const field = ${expression(items, 'item', emitters)};
+        json += (i === 0 ? '' : ',') + (field === undefined ? 'null' : field);
+      }
+      return json + ']';
+    };`, emitters);
+};
+
+const compileEmitter = (schema: JsonSchema): Emitter => {
+  switch (schema.type) {
+    case 'object':
+      return compileObject(schema.properties);
+    case 'array':
+      return compileArray(schema.items);
+    default: {
+      const emitters: Emitter[] = [];
+      return build(`return function (value) { return ${expression(schema, 'value', emitters)}; };`, emitters);
+    }
+  }
+};
+
+/**
+ * Compiles a stringifier for values described by a schema
+ * @param schema JSON Schema subset describing the value
+ * @returns Function producing the same string as JSON.stringify(value)
+ */
+export const compileStringifier = (schema: JsonSchema): ((value: unknown) => string) => {
+  const emit = compileEmitter(schema);
+  return (value) => emit(value) as string;
+};
+
+/**
+ * Sends a JSON response through a compiled stringifier; headers match res.json
+ * @param res Express response
+ * @param stringify Compiled stringifier for the body
+ * @param body Response body
+ */
+export const sendJson = <T>(res: Response, stringify: (value: T) => string, body: T): Response => {
+  if (!res.get('Content-Type')) {
+    res.set('Content-Type', 'application/json');
+  }
+  return res.send(stringify(body));
+};
@@ -127,8 +127,11 @@ export const generateRefreshToken = async (user: IUser): Promise<string> => {
         const sanitizedUser = sanitizeTokenData(user);
         const tokenId = generateTokenId();
 
+        // Carries the claims a refreshed access token is signed with
         const payload = {
             userId: sanitizedUser.id!,
+            email: sanitizedUser.email,
+            role: sanitizedUser.role,
             jti: tokenId,
             iss: JWT_ISSUER,
             aud: JWT_AUDIENCE
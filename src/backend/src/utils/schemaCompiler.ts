@@ -0,0 +1,482 @@
+/**
+ * @fileoverview Ahead-of-time compiler for Joi schemas on hot request paths.
+ * compileSchema walks a schema's description once and builds a tree of specialised
+ * check functions for the subset of Joi the API validators use. The compiled path
+ * only accepts input Joi would accept, and returns the value Joi would return.
+ * Anything else takes Joi's own path: rejected input, values Joi would convert in ways
+ * the compiled path does not model, and schema features outside the subset. Errors,
+ * messages and conversions therefore always come from Joi.
+ * @version 1.0.0
+ */
+
+import Joi from 'joi'; // ^17.9.0
+
+/** Result of a compiled check that cannot vouch for its input */
+const FALLBACK = Symbol('fallback');
+
+type Check = (value: any, parent: any, context: unknown) => any;
+
+/** Description node as returned by Joi's schema.describe() */
+type Description = Record<string, any>;
+
+/** Marks a schema feature outside the compiled subset */
+class UnsupportedSchema extends Error {}
+
+// Preferences that only shape error reports, so compiled success results do not depend on them
+const REPORT_PREFERENCES = new Set(['abortEarly', 'messages', 'errors', 'context']);
+const SUPPORTED_FLAGS = new Set(['presence', 'only', 'default', 'label', 'description', 'format']);
+const SUPPORTED_NODE_KEYS = new Set([
+  'type', 'flags', 'rules', 'allow', 'keys', 'items', 'whens', 'preferences', 'metas', 'notes', 'tags', 'examples'
+]);
+
+// Conservative forms of Joi's formats: every match here is accepted by Joi, not the reverse
+const ISO_DATE_TIME = /^\d{4}-(?:0[1-9]|1[0-2])-(?:0[1-9]|[12]\d|3[01])T(?:[01]\d|2[0-3]):[0-5]\d:[0-5]\d(?:\.\d{1,3})?Z$/;
+const UUID = /^[0-9a-f]{8}-[0-9a-f]{4}-[1-5][0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}$/i;
+const HTTP_URI = /^https?:\/\/[a-z0-9](?:[a-z0-9-]*[a-z0-9])?(?:\.[a-z0-9](?:[a-z0-9-]*[a-z0-9])?)*(?::\d{1,5})?(?:\/(?:[\w\-.~!$&'()*+,;=:@/]|%[0-9a-f]{2})*)?(?:\?(?:[\w\-.~!$&'()*+,;=:@/?]|%[0-9a-f]{2})*)?$/i;
+
+const isPlainObject = (value: unknown): value is Record<string, unknown> =>
+  value !== null && typeof value === 'object' && Object.getPrototypeOf(value) === Object.prototype;
+
+const assertSupported = (supported: boolean, feature: string): void => {
+  if (!supported) {
+    throw new UnsupportedSchema(feature);
+  }
+};
+
+/**
+ * Reads a reference to a key of the same object, the only reference form compiled
+ * @returns The sibling key name
+ */
+const siblingRef = (description: Description): string => {
+  const ref = description.ref?.ref ?? description.ref;
+  assertSupported(
+    !!ref && Object.keys(ref).every((key) => key === 'path') && ref.path?.length === 1,
+    'reference other than a sibling key'
+  );
+  return ref.path[0];
+};
+
+const isRef = (arg: unknown): boolean => isPlainObject(arg) && 'ref' in arg;
+
+/** Rule argument that is either a literal or a sibling reference */
+const ruleArg = (arg: any): ((parent: any) => any) => {
+  if (isRef(arg)) {
+    const key = siblingRef(arg);
+    return (parent) => parent?.[key];
+  }
+  return () => arg;
+};
+
+const emptyOptions = (args: Description | undefined, ...ignored: string[]): boolean =>
+  !args || Object.entries(args).every(([key, value]) =>
+    value === undefined || ignored.includes(key) || (isPlainObject(value) && Object.keys(value).length === 0));
+
+/** Rules shared by strings, numbers, arrays and objects that compare a size against a limit */
+const compileLimit = (rule: Description, size: (value: any) => number): Check | null => {
+  const compare: Record<string, (actual: number, limit: number) => boolean> = {
+    min: (actual, limit) => actual >= limit,
+    max: (actual, limit) => actual <= limit,
+    length: (actual, limit) => actual === limit,
+    greater: (actual, limit) => actual > limit,
+    less: (actual, limit) => actual < limit
+  };
+  if (!compare[rule.name]) {
+    return null;
+  }
+  assertSupported(emptyOptions(rule.args, 'limit'), `${rule.name} options`);
+  const limit = ruleArg(rule.args.limit);
+  const test = compare[rule.name];
+  return (value, parent) => {
+    const bound = limit(parent);
+    return typeof bound === 'number' && test(size(value), bound) ? value : FALLBACK;
+  };
+};
+
+const compileCustom = (rule: Description): Check => {
+  const method = rule.args?.method;
+  assertSupported(typeof method === 'function', 'custom rule without a method');
+  const rejected = {};
+  return (value, _parent, context) => {
+    try {
+      const result = method(value, { error: () => rejected, prefs: { context }, original: value });
+      return result === rejected || result === undefined ? FALLBACK : result;
+    } catch {
+      return FALLBACK;
+    }
+  };
+};
+
+const compileStringRule = (rule: Description): Check => {
+  const limit = compileLimit(rule, (value: string) => value.length);
+  if (limit) {
+    return limit;
+  }
+  switch (rule.name) {
+    case 'pattern': {
+      assertSupported(emptyOptions(rule.args, 'regex'), 'pattern options');
+      const source = String(rule.args.regex);
+      const regex = new RegExp(source.slice(1, source.lastIndexOf('/')), source.slice(source.lastIndexOf('/') + 1));
+      return (value) => (regex.test(value) ? value : FALLBACK);
+    }
+    case 'guid':
+      assertSupported(emptyOptions(rule.args), 'guid options');
+      return (value) => (UUID.test(value) ? value : FALLBACK);
+    case 'uri':
+      assertSupported(emptyOptions(rule.args), 'uri options');
+      return (value) => (HTTP_URI.test(value) ? value : FALLBACK);
+    // Joi converts case and whitespace; values that are already normalised pass unchanged
+    case 'trim':
+      assertSupported(rule.args?.enabled !== false, 'trim(false)');
+      return (value) => (value === value.trim() ? value : FALLBACK);
+    case 'case': {
+      const direction = rule.args?.direction;
+      assertSupported(direction === 'lower' || direction === 'upper', 'case direction');
+      return direction === 'lower'
+        ? (value) => (value === value.toLocaleLowerCase() ? value : FALLBACK)
+        : (value) => (value === value.toLocaleUpperCase() ? value : FALLBACK);
+    }
+    case 'custom':
+      return compileCustom(rule);
+    default:
+      throw new UnsupportedSchema(`string.${rule.name}`);
+  }
+};
+
+const compileNumberRule = (rule: Description): Check => {
+  const limit = compileLimit(rule, (value: number) => value);
+  if (limit) {
+    return limit;
+  }
+  switch (rule.name) {
+    case 'integer':
+      return (value) => (Number.isInteger(value) ? value : FALLBACK);
+    case 'sign': {
+      const positive = rule.args?.sign === 'positive';
+      return (value) => ((positive ? value > 0 : value < 0) ? value : FALLBACK);
+    }
+    case 'custom':
+      return compileCustom(rule);
+    default:
+      throw new UnsupportedSchema(`number.${rule.name}`);
+  }
+};
+
+const compileDateRule = (rule: Description): Check => {
+  const compare: Record<string, (actual: number, limit: number) => boolean> = {
+    min: (actual, limit) => actual >= limit,
+    max: (actual, limit) => actual <= limit,
+    greater: (actual, limit) => actual > limit,
+    less: (actual, limit) => actual < limit
+  };
+  if (rule.name === 'custom') {
+    return compileCustom(rule);
+  }
+  // Only sibling references compile; 'now' and literal dates take Joi's path
+  assertSupported(!!compare[rule.name] && isRef(rule.args?.date), `date.${rule.name}`);
+  const limit = ruleArg(rule.args.date);
+  const test = compare[rule.name];
+  return (value: Date, parent) => {
+    const bound = limit(parent);
+    return bound instanceof Date && test(value.getTime(), bound.getTime()) ? value : FALLBACK;
+  };
+};
+
+const compileArrayRule = (rule: Description): Check => {
+  const limit = compileLimit(rule, (value: unknown[]) => value.length);
+  if (limit) {
+    return limit;
+  }
+  switch (rule.name) {
+    // Items are checked by the array's base check
+    case 'items':
+      return (value) => value;
+    case 'unique':
+      assertSupported(emptyOptions(rule.args), 'unique comparator');
+      // Deep comparison of object items is left to Joi
+      return (value: unknown[]) =>
+        value.every((item) => item === null || typeof item !== 'object') && new Set(value).size === value.length
+          ? value
+          : FALLBACK;
+    case 'custom':
+      return compileCustom(rule);
+    default:
+      throw new UnsupportedSchema(`array.${rule.name}`);
+  }
+};
+
+const compileObjectRule = (rule: Description): Check => {
+  const limit = compileLimit(rule, (value: object) => Object.keys(value).length);
+  if (limit) {
+    return limit;
+  }
+  assertSupported(rule.name === 'custom', `object.${rule.name}`);
+  return compileCustom(rule);
+};
+
+/** Sibling keys a node reads through references in its own rules and conditions */
+const siblingDependencies = (description: Description): string[] => {
+  const dependencies: string[] = [];
+  for (const rule of description.rules ?? []) {
+    for (const arg of Object.values(rule.args ?? {})) {
+      if (isRef(arg)) dependencies.push(siblingRef(arg as Description));
+    }
+  }
+  for (const when of description.whens ?? []) {
+    dependencies.push(siblingRef(when));
+    for (const branch of [when.then, when.otherwise]) {
+      if (branch) dependencies.push(...siblingDependencies(branch));
+    }
+  }
+  return dependencies;
+};
+
+const compileKeys = (keys: Record<string, Description>): Check => {
+  const names = Object.keys(keys);
+  const dependencies = new Map(names.map((name) => [name, siblingDependencies(keys[name])]));
+  // Joi resolves references against converted siblings, so referenced keys run first
+  for (const [name, needs] of dependencies) {
+    assertSupported(needs.every((need) => !dependencies.get(need)?.length), `chained reference from ${name}`);
+  }
+  const ordered = [
+    ...names.filter((name) => !dependencies.get(name)!.length),
+    ...names.filter((name) => dependencies.get(name)!.length)
+  ];
+  const known = new Set(names);
+  const children = ordered.map((name) => [name, compileNode(keys[name])] as const);
+
+  return (value, _parent, context) => {
+    for (const key in value) {
+      // Unknown keys are errors and undefined values are removed; both are Joi's to handle
+      if (!known.has(key) || value[key] === undefined) return FALLBACK;
+    }
+    const result = { ...value };
+    for (const [name, check] of children) {
+      const child = check(value[name], result, context);
+      if (child === FALLBACK) return FALLBACK;
+      if (child !== undefined) result[name] = child;
+    }
+    return result;
+  };
+};
+
+/** Type check and conversion, then the type's rules in declaration order */
+const compileType = (description: Description): Check => {
+  const { type, flags = {}, rules = [] } = description;
+  assertSupported(flags.format === undefined || (type === 'date' && flags.format === 'iso'), 'format flag');
+
+  let base: Check;
+  let compileRule: (rule: Description) => Check;
+  switch (type) {
+    case 'any':
+      assertSupported(rules.length === 0, 'any rules');
+      return (value) => value;
+    case 'string':
+      // Joi rejects empty strings unless allowed
+      base = (value) => (typeof value === 'string' && value !== '' ? value : FALLBACK);
+      compileRule = compileStringRule;
+      break;
+    case 'number':
+      // Numeric strings, -0 and unsafe integers are converted or rejected by Joi
+      base = (value) =>
+        typeof value === 'number' && Number.isFinite(value) && !Object.is(value, -0) &&
+        Math.abs(value) <= Number.MAX_SAFE_INTEGER ? value : FALLBACK;
+      compileRule = compileNumberRule;
+      break;
+    case 'boolean':
+      base = (value) => (typeof value === 'boolean' ? value : FALLBACK);
+      compileRule = () => {
+        throw new UnsupportedSchema('boolean rules');
+      };
+      break;
+    case 'date':
+      base = (value) => {
+        if (value instanceof Date) {
+          return Number.isNaN(value.getTime()) ? FALLBACK : value;
+        }
+        if (typeof value === 'string' && ISO_DATE_TIME.test(value)) {
+          const date = new Date(value);
+          return Number.isNaN(date.getTime()) ? FALLBACK : date;
+        }
+        return FALLBACK;
+      };
+      compileRule = compileDateRule;
+      break;
+    case 'array': {
+      const items: Description[] = description.items ?? [];
+      assertSupported(items.length <= 1, 'array alternatives');
+      const item = items.length ? compileNode(items[0]) : null;
+      // Joi returns a copy; sparse items are errors
+      base = (value, _parent, context) => {
+        if (!Array.isArray(value)) return FALLBACK;
+        const result = value.slice();
+        for (let i = 0; i < result.length; i++) {
+          if (result[i] === undefined) return FALLBACK;
+          if (item) {
+            const converted = item(result[i], result, context);
+            if (converted === FALLBACK || converted === undefined) return FALLBACK;
+            result[i] = converted;
+          }
+        }
+        return result;
+      };
+      compileRule = compileArrayRule;
+      break;
+    }
+    case 'object': {
+      // An object without declared keys allows any keys; Joi handles those
+      assertSupported(!!description.keys, 'object without keys');
+      const keys = compileKeys(description.keys);
+      base = (value, parent, context) => (isPlainObject(value) ? keys(value, parent, context) : FALLBACK);
+      compileRule = compileObjectRule;
+      break;
+    }
+    default:
+      throw new UnsupportedSchema(`type ${type}`);
+  }
+
+  const checks = [base, ...rules.map(compileRule)];
+  return (value, parent, context) => {
+    let result = value;
+    for (const check of checks) {
+      result = check(result, parent, context);
+      if (result === FALLBACK) return FALLBACK;
+    }
+    return result;
+  };
+};
+
+const isOverride = (value: unknown): boolean =>
+  isPlainObject(value) && Object.keys(value).length === 1 && value.override === true;
+
+/** A branch such as `then: Joi.required()` that only changes presence */
+const isPresenceOnly = (description: Description): boolean =>
+  description.type === 'any' &&
+  Object.keys(description).every((key) => key === 'type' || key === 'flags') &&
+  Object.keys(description.flags ?? {}).every((flag) => flag === 'presence');
+
+/**
+ * Compiles `when(sibling, { is: literal, then, otherwise })`. Joi concatenates the chosen
+ * branch onto the base schema; compiled branches either replace a bare Joi.when base or
+ * change the presence of a typed one.
+ */
+const compileWhen = (description: Description): Check => {
+  const { whens, ...base } = description;
+  assertSupported(whens.length === 1, 'multiple conditions');
+  const [when] = whens;
+  assertSupported(Object.keys(when).every((key) => ['ref', 'is', 'then', 'otherwise'].includes(key)), 'when options');
+  const { is } = when;
+  const values: unknown[] = (is?.allow ?? []).filter((value: unknown) => !isOverride(value));
+  assertSupported(
+    is?.type === 'any' && is.flags?.only === true && is.flags?.presence === 'required' &&
+    Object.keys(is).every((key) => ['type', 'flags', 'allow'].includes(key)) &&
+    values.every((value) => value === null || typeof value !== 'object'),
+    'when condition other than literal values'
+  );
+
+  const bareBase = isPresenceOnly(base) && base.flags === undefined;
+  const branch = (schema: Description | undefined): Check => {
+    if (!schema) {
+      return compileNode(base);
+    }
+    if (bareBase) {
+      return compileNode(schema);
+    }
+    assertSupported(isPresenceOnly(schema), 'when branch on a typed schema');
+    return compileNode({ ...base, flags: { ...base.flags, ...schema.flags } });
+  };
+
+  const key = siblingRef(when);
+  const matched = branch(when.then);
+  const otherwise = branch(when.otherwise);
+  return (value, parent, context) =>
+    (values.includes(parent?.[key]) ? matched : otherwise)(value, parent, context);
+};
+
+const compileNode = (description: Description): Check => {
+  for (const key of Object.keys(description)) {
+    assertSupported(SUPPORTED_NODE_KEYS.has(key), key);
+  }
+  const flags: Description = description.flags ?? {};
+  for (const flag of Object.keys(flags)) {
+    assertSupported(SUPPORTED_FLAGS.has(flag), `${flag} flag`);
+  }
+  for (const preference of Object.keys(description.preferences ?? {})) {
+    assertSupported(REPORT_PREFERENCES.has(preference), `${preference} preference`);
+  }
+
+  if (description.whens) {
+    return compileWhen(description);
+  }
+
+  const allow: unknown[] = description.allow ?? [];
+  assertSupported(allow.every((value) => value === null || typeof value !== 'object'), 'allow of references');
+  assertSupported(
+    flags.default === undefined || flags.default === null || typeof flags.default !== 'object' && typeof flags.default !== 'function',
+    'computed default'
+  );
+  const presence = flags.presence ?? 'optional';
+  const only = flags.only === true;
+  const check = compileType(description);
+
+  return (value, parent, context) => {
+    if (value === undefined) {
+      if (presence === 'required') return FALLBACK;
+      return presence === 'forbidden' ? undefined : flags.default;
+    }
+    if (presence === 'forbidden') return FALLBACK;
+    // Allowed values skip the type's rules
+    if (allow.length && allow.includes(value)) return value;
+    if (only) return FALLBACK;
+    return check(value, parent, context);
+  };
+};
+
+/**
+ * Joi schema with a compiled validation path in front of Joi's own
+ */
+export interface CompiledSchema<T = any> {
+  /** Source schema, which validates whatever the compiled path cannot */
+  readonly schema: Joi.Schema<T>;
+  /** Whether the schema compiled; false means every call goes through Joi */
+  readonly compiled: boolean;
+  /** Same contract as schema.validate */
+  validate(value: unknown, options?: Joi.ValidationOptions): Joi.ValidationResult<T>;
+  /** Same contract as schema.validateAsync without warnings or artifacts */
+  validateAsync(value: unknown, options?: Joi.AsyncValidationOptions): Promise<T>;
+}
+
+/**
+ * Compiles a Joi schema. Schemas using features outside the compiled subset still
+ * validate, through Joi.
+ * @param schema Joi schema to compile
+ * @returns Schema with the same validation contract
+ */
+export const compileSchema = <T = any>(schema: Joi.Schema<T>): CompiledSchema<T> => {
+  let check: Check | null = null;
+  try {
+    check = compileNode(schema.describe());
+  } catch {
+    // Unsupported features, or a description this compiler does not recognise
+    check = null;
+  }
+
+  const fast = (value: unknown, options?: Joi.ValidationOptions): any => {
+    if (!check || (options && Object.keys(options).some((key) => !REPORT_PREFERENCES.has(key)))) {
+      return FALLBACK;
+    }
+    return check(value, undefined, options?.context);
+  };
+
+  return {
+    schema,
+    compiled: check !== null,
+    validate(value, options) {
+      const result = fast(value, options);
+      return result === FALLBACK ? schema.validate(value, options) : { value: result };
+    },
+    async validateAsync(value, options) {
+      const result = fast(value, options);
+      return result === FALLBACK ? schema.validateAsync(value, options) : result;
+    }
+  };
+};
@@ -0,0 +1,265 @@
+/**
+ * @fileoverview Distributed single-flight for expensive generations.
+ * Concurrent requests for the same key, in this process or on other workers, share
+ * one computation: the first caller takes a Redis lease and computes, the others wait
+ * for a pub/sub notification and read the cached result.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { randomUUID } from 'crypto';
+
+const LOCK_PREFIX = 'singleflight:lock:';
+const CHANNEL_PREFIX = 'singleflight:done:';
+const RESULT_PREFIX = 'singleflight:result:';
+
+// Extend or release the lease only while we still hold it
+export const RENEW_LEASE_SCRIPT = `
+if redis.call('get', KEYS[1]) == ARGV[1] then
+  return redis.call('pexpire', KEYS[1], ARGV[2])
+end
+return 0`;
+
+export const RELEASE_LEASE_SCRIPT = `
+if redis.call('get', KEYS[1]) == ARGV[1] then
+  return redis.call('del', KEYS[1])
+end
+return 0`;
+
+export interface SingleFlightOptions {
+  /** Lease on the lock; renewed while the leader is computing */
+  leaseMs?: number;
+  /** Longest a follower waits before computing itself */
+  waitTimeoutMs?: number;
+}
+
+export interface SingleFlightStats {
+  /** Calls that computed */
+  leaders: number;
+  /** Calls served by another worker's computation */
+  followers: number;
+  /** Calls joined to a computation already running in this process */
+  local: number;
+  /** Calls served from the cache before any coordination */
+  cached: number;
+  /** Calls that computed uncoordinated because Redis failed */
+  bypassed: number;
+}
+
+interface FlightMessage {
+  ok: boolean;
+  error?: string;
+}
+
+/** How contending for a key ended: a shared result, the lease, or the leader's failure */
+type Contention<T> = { result: T } | { token: string } | { error: string } | null;
+
+/**
+ * Coalesces identical in-flight computations across processes.
+ *
+ * `read` returns the cached result or null; `compute` produces the result and is
+ * responsible for caching it where `read` will find it. Followers see the leader's
+ * failure rather than retrying it, and take over if the leader's lease expires.
+ */
+export class SingleFlight {
+  private readonly leaseMs: number;
+  private readonly waitTimeoutMs: number;
+  private readonly inFlight = new Map<string, Promise<unknown>>();
+  private readonly waiters = new Map<string, Set<(message: FlightMessage) => void>>();
+  private readonly stats: SingleFlightStats = { leaders: 0, followers: 0, local: 0, cached: 0, bypassed: 0 };
+
+  constructor(
+    private readonly client: Redis,
+    private readonly subscriber: Redis = client.duplicate(),
+    options: SingleFlightOptions = {}
+  ) {
+    this.leaseMs = options.leaseMs ?? 30000;
+    this.waitTimeoutMs = options.waitTimeoutMs ?? 120000;
+
+    this.subscriber.on('message', (channel: string, payload: string) => {
+      const listeners = this.waiters.get(channel);
+      if (!listeners) {
+        return;
+      }
+      const message: FlightMessage = JSON.parse(payload);
+      listeners.forEach((listener) => listener(message));
+    });
+  }
+
+  /**
+   * Returns the cached result for `key`, or computes it once across all callers
+   */
+  public async do<T>(key: string, read: () => Promise<T | null>, compute: () => Promise<T>): Promise<T> {
+    const running = this.inFlight.get(key) as Promise<T> | undefined;
+    if (running) {
+      this.stats.local++;
+      return running;
+    }
+
+    const flight = this.coordinate(key, read, compute);
+    this.inFlight.set(key, flight);
+    try {
+      return await flight;
+    } finally {
+      this.inFlight.delete(key);
+    }
+  }
+
+  /**
+   * Like `do`, for callers without a shared cache of their own: the result is
+   * stored as JSON in Redis for `ttlSeconds` so other workers can read it
+   */
+  public doCached<T>(key: string, ttlSeconds: number, compute: () => Promise<T>): Promise<T> {
+    const resultKey = `${RESULT_PREFIX}${key}`;
+    return this.do(
+      key,
+      async () => {
+        const stored = await this.client.get(resultKey);
+        return stored === null ? null : JSON.parse(stored) as T;
+      },
+      async () => {
+        const result = await compute();
+        // Followers that miss the result contend again, so a failed write costs a recompute
+        await this.client.setex(resultKey, ttlSeconds, JSON.stringify(result)).catch(() => undefined);
+        return result;
+      }
+    );
+  }
+
+  public getStats(): SingleFlightStats {
+    return { ...this.stats };
+  }
+
+  private async coordinate<T>(key: string, read: () => Promise<T | null>, compute: () => Promise<T>): Promise<T> {
+    const lockKey = `${LOCK_PREFIX}${key}`;
+    const channel = `${CHANNEL_PREFIX}${key}`;
+
+    let contention: Contention<T>;
+    try {
+      contention = await this.contend(lockKey, channel, read);
+    } catch {
+      // Coordination is an optimisation; never fail a request because Redis is unreachable
+      this.stats.bypassed++;
+      return compute();
+    }
+
+    if (contention && 'result' in contention) {
+      return contention.result;
+    }
+    if (contention && 'error' in contention) {
+      throw new Error(contention.error);
+    }
+    this.stats.leaders++;
+    return contention ? this.lead(lockKey, channel, contention.token, compute) : compute();
+  }
+
+  /**
+   * Waits for a shared result or the lease; null once the wait timeout has passed
+   */
+  private async contend<T>(lockKey: string, channel: string, read: () => Promise<T | null>): Promise<Contention<T>> {
+    const cached = await read();
+    if (cached !== null) {
+      this.stats.cached++;
+      return { result: cached };
+    }
+
+    const deadline = Date.now() + this.waitTimeoutMs;
+    while (Date.now() < deadline) {
+      const token = randomUUID();
+      if (await this.client.set(lockKey, token, 'PX', this.leaseMs, 'NX')) {
+        return { token };
+      }
+
+      // Subscribe before re-checking so a completion in between is not missed
+      const message = this.waitFor(channel, Math.min(this.leaseMs, deadline - Date.now()));
+      let result: T | null;
+      try {
+        await message.ready;
+        result = await read();
+        if (result === null && !(await this.client.exists(lockKey))) {
+          message.cancel();
+          continue;
+        }
+      } catch (error) {
+        message.cancel();
+        throw error;
+      }
+      if (result !== null) {
+        message.cancel();
+        this.stats.followers++;
+        return { result };
+      }
+
+      const outcome = await message.done;
+      if (outcome?.ok === false) {
+        return { error: outcome.error || 'Shared computation failed' };
+      }
+      if (outcome?.ok) {
+        const shared = await read();
+        if (shared !== null) {
+          this.stats.followers++;
+          return { result: shared };
+        }
+      }
+      // Timed out or the result was evicted; contend for the lease again
+    }
+    return null;
+  }
+
+  private async lead<T>(lockKey: string, channel: string, token: string, compute: () => Promise<T>): Promise<T> {
+    const renewal = setInterval(() => {
+      this.client.eval(RENEW_LEASE_SCRIPT, 1, lockKey, token, this.leaseMs).catch(() => undefined);
+    }, this.leaseMs / 3);
+
+    let message: FlightMessage;
+    try {
+      const result = await compute();
+      message = { ok: true };
+      return result;
+    } catch (error) {
+      message = { ok: false, error: error instanceof Error ? error.message : String(error) };
+      throw error;
+    } finally {
+      clearInterval(renewal);
+      // The result is already settled; followers that miss these time out and contend again
+      await this.client.eval(RELEASE_LEASE_SCRIPT, 1, lockKey, token).catch(() => undefined);
+      await this.client.publish(channel, JSON.stringify(message!)).catch(() => undefined);
+    }
+  }
+
+  /**
+   * Listens for the completion message on a channel, resolving with null on timeout
+   */
+  private waitFor(channel: string, timeoutMs: number) {
+    let listener!: (message: FlightMessage | null) => void;
+    let timer: NodeJS.Timeout;
+    const done = new Promise<FlightMessage | null>((resolve) => {
+      listener = (message) => {
+        clearTimeout(timer);
+        this.removeWaiter(channel, listener);
+        resolve(message);
+      };
+      timer = setTimeout(() => listener(null), Math.max(timeoutMs, 0));
+    });
+
+    let listeners = this.waiters.get(channel);
+    let ready: Promise<unknown> = Promise.resolve();
+    if (!listeners) {
+      listeners = new Set();
+      this.waiters.set(channel, listeners);
+      ready = this.subscriber.subscribe(channel);
+    }
+    listeners.add(listener);
+
+    return { done, ready, cancel: () => listener(null) };
+  }
+
+  private removeWaiter(channel: string, listener: (message: FlightMessage) => void): void {
+    const listeners = this.waiters.get(channel);
+    if (!listeners?.delete(listener) || listeners.size > 0) {
+      return;
+    }
+    this.waiters.delete(channel);
+    this.subscriber.unsubscribe(channel).catch(() => undefined);
+  }
+}
@@ -0,0 +1,150 @@
+/**
+ * @fileoverview Redis storage of refresh tokens, revocations and sessions.
+ * Each multi-step token operation is one Lua script, so it is atomic and costs one round
+ * trip. Every key of a user carries the user id as a cluster hash tag, so a user's keys
+ * share a slot: the scripts may touch them together and auto-pipelined commands for one
+ * user go to one node.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+
+const REFRESH_PREFIX = 'refresh:token:';
+const REVOKED_PREFIX = 'token:blacklist:';
+const SESSION_PREFIX = 'session:';
+
+// Drops expired refresh tokens of KEYS[1] and keeps the hash until its latest expiry;
+// expects `now` and `latest` locals
+const PRUNE_REFRESH_TOKENS = `
+local entries = redis.call('hgetall', KEYS[1])
+for i = 1, #entries, 2 do
+  local expiry = tonumber(entries[i + 1])
+  if expiry <= now then
+    redis.call('hdel', KEYS[1], entries[i])
+  elseif expiry > latest then
+    latest = expiry
+  end
+end
+redis.call('expireat', KEYS[1], latest)`;
+
+export const STORE_REFRESH_SCRIPT = `
+local now = tonumber(ARGV[3])
+local latest = tonumber(ARGV[2])
+redis.call('hset', KEYS[1], ARGV[1], ARGV[2])
+${PRUNE_REFRESH_TOKENS}
+return 1`;
+
+// Result codes of ROTATE_REFRESH_SCRIPT
+const ROTATED = 1;
+const REUSED = -1;
+
+// Validates the old token, replaces it with the new one and revokes the old one. A
+// revoked token presented again was rotated already and may be stolen, so every refresh
+// token of the user is dropped.
+export const ROTATE_REFRESH_SCRIPT = `
+local now = tonumber(ARGV[5])
+local expiry = tonumber(redis.call('hget', KEYS[1], ARGV[1]))
+if not expiry or expiry <= now then
+  if redis.call('exists', KEYS[2]) == 1 then
+    redis.call('del', KEYS[1])
+    return ${REUSED}
+  end
+  return 0
+end
+redis.call('hdel', KEYS[1], ARGV[1])
+if tonumber(ARGV[2]) > now then
+  redis.call('set', KEYS[2], '1', 'EX', tonumber(ARGV[2]) - now)
+end
+local latest = tonumber(ARGV[4])
+redis.call('hset', KEYS[1], ARGV[3], ARGV[4])
+${PRUNE_REFRESH_TOKENS}
+return ${ROTATED}`;
+
+// Logout: drops the refresh token and revokes the access token until it expires
+export const REVOKE_SCRIPT = `
+redis.call('hdel', KEYS[1], ARGV[1])
+if tonumber(ARGV[2]) > 0 then
+  redis.call('set', KEYS[2], '1', 'EX', ARGV[2])
+end
+return 1`;
+
+/**
+ * A token's id and expiry, in seconds since the epoch, as in its claims
+ */
+export interface TokenClaims {
+  jti: string;
+  exp: number;
+}
+
+export type RotateResult = 'rotated' | 'invalid' | 'reused';
+
+const nowSeconds = () => Math.floor(Date.now() / 1000);
+
+/**
+ * Refresh tokens of a user live in one hash of token id to expiry, so a session can
+ * be ended with one command and rotation is validated against the same key
+ */
+export class TokenStore {
+  constructor(private readonly client: Redis) {}
+
+  public async storeRefreshToken(userId: string, token: TokenClaims): Promise<void> {
+    await this.client.eval(STORE_REFRESH_SCRIPT, 1, this.refreshKey(userId), token.jti, token.exp, nowSeconds());
+  }
+
+  public async hasRefreshToken(userId: string, jti: string): Promise<boolean> {
+    const expiry = await this.client.hget(this.refreshKey(userId), jti);
+    return expiry !== null && Number(expiry) > nowSeconds();
+  }
+
+  public async rotateRefreshToken(userId: string, previous: TokenClaims, next: TokenClaims): Promise<RotateResult> {
+    const result = await this.client.eval(
+      ROTATE_REFRESH_SCRIPT,
+      2,
+      this.refreshKey(userId),
+      this.revokedKey(userId, previous.jti),
+      previous.jti,
+      previous.exp,
+      next.jti,
+      next.exp,
+      nowSeconds()
+    );
+    return result === ROTATED ? 'rotated' : result === REUSED ? 'reused' : 'invalid';
+  }
+
+  /**
+   * Ends one session: its refresh token stops working and its access token is revoked
+   */
+  public async revoke(userId: string, access: TokenClaims, refreshJti: string): Promise<void> {
+    await this.client.eval(
+      REVOKE_SCRIPT,
+      2,
+      this.refreshKey(userId),
+      this.revokedKey(userId, access.jti),
+      refreshJti,
+      access.exp - nowSeconds()
+    );
+  }
+
+  public async isRevoked(userId: string, jti: string): Promise<boolean> {
+    return (await this.client.exists(this.revokedKey(userId, jti))) === 1;
+  }
+
+  /**
+   * Ends every session of the user
+   */
+  public async revokeAll(userId: string): Promise<void> {
+    await this.client.del(this.refreshKey(userId), this.sessionKey(userId));
+  }
+
+  private refreshKey(userId: string): string {
+    return `${REFRESH_PREFIX}{${userId}}`;
+  }
+
+  private revokedKey(userId: string, jti: string): string {
+    return `${REVOKED_PREFIX}{${userId}}:${jti}`;
+  }
+
+  private sessionKey(userId: string): string {
+    return `${SESSION_PREFIX}{${userId}}`;
+  }
+}
@@ -1,6 +1,7 @@
 import Joi from 'joi'; // ^17.9.0
 import validator from 'validator'; // ^13.9.0
 import xss from 'xss'; // ^1.0.14
+import { runCpuTask } from '../core/workers/cpuTasks';
 
 // Constants for validation rules
 const PASSWORD_MIN_LENGTH = 8;
@@ -288,6 +289,18 @@ export const sanitizeInput = (
   return sanitized;
 };
 
+/**
+ * Input sanitization that runs on the worker pool for large inputs
+ * @param input - Input string to sanitize
+ * @param options - Sanitization options
+ * @returns Sanitized string
+ */
+export const sanitizeInputAsync = (
+  input: string,
+  options: SanitizationOptions = {}
+): Promise<string> =>
+  runCpuTask('sanitize', { input, options: options as Record<string, boolean> }, input.length);
+
 // Helper functions
 const generateValidationSuggestions = (errors: ValidationError[]): string[] => {
   const suggestions: string[] = [];
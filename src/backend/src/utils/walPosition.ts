@@ -0,0 +1,27 @@
+/**
+ * @fileoverview PostgreSQL WAL positions as comparable strings, and the Redis script
+ * that keeps the highest position a user has written through.
+ * @version 1.0.0
+ */
+
+/**
+ * Converts a pg_lsn such as 16/B374D848 to fixed-width hex that sorts in WAL order
+ */
+export const walPosition = (lsn: string): string => {
+  const [high, low] = lsn.toUpperCase().split('/');
+  return high.padStart(8, '0') + low.padStart(8, '0');
+};
+
+/**
+ * Raises the user's last write position, never lowers it, and restarts its expiry.
+ * Positions are fixed-width hex, so they compare as strings.
+ * KEYS: last write; ARGV: position, ttl ms
+ */
+export const RECORD_WRITE_SCRIPT = `
+local current = redis.call('get', KEYS[1])
+if not current or ARGV[1] > current then
+  redis.call('set', KEYS[1], ARGV[1], 'PX', ARGV[2])
+else
+  redis.call('pexpire', KEYS[1], ARGV[2])
+end
+return 1`;
@@ -5,10 +5,11 @@
  */
 
 import WebSocket from 'ws'; // ^8.x
-import winston from 'winston'; // ^3.10.0
 import http from 'http';
 import { StudySessionHandler } from './handlers/studySessionHandler';
 import { VoiceHandler } from './handlers/voiceHandler';
+import { cardStreamHandler } from './handlers/cardStreamHandler';
+import { asyncLogger, AsyncLogger } from '../config/asyncLogger';
 
 // WebSocket event constants
 export const WS_EVENTS = {
@@ -35,6 +36,12 @@ export const WS_CONFIG = {
     ERROR_THRESHOLD: 50
 } as const;
 
+// Per-connection metric events keep one entry in N
+const LOG_SAMPLING = {
+    'Latency recorded': 10,
+    'Counter incremented': 10
+};
+
 /**
  * Interface for connection pool management
  */
@@ -70,7 +77,7 @@ export class WebSocketManager {
     private readonly wss: WebSocket.Server;
     private readonly studySessionHandler: StudySessionHandler;
     private readonly voiceHandler: VoiceHandler;
-    private readonly logger: winston.Logger;
+    private readonly logger: AsyncLogger;
     private readonly activeConnections: Map<string, WebSocket>;
     private readonly connectionPool: ConnectionPool;
     private metrics: MetricsCollector;
@@ -83,18 +90,9 @@ export class WebSocketManager {
         voiceHandler: VoiceHandler,
         connectionPool: ConnectionPool,
         metrics: MetricsCollector,
-        private readonly logger: winston.Logger = winston.createLogger({
-            level: 'info',
-            format: winston.format.combine(
-                winston.format.timestamp(),
-                winston.format.json()
-            ),
-            defaultMeta: { service: 'WebSocketManager' },
-            transports: [
-                new winston.transports.Console()
-            ]
-        })
+        private readonly logger: AsyncLogger = asyncLogger
     ) {
+        this.logger = logger.child({ component: 'WebSocketManager' }, LOG_SAMPLING);
         this.wss = new WebSocket.Server({
             server,
             perMessageDeflate: true,
@@ -127,7 +125,7 @@ export class WebSocketManager {
             try {
                 await this.handleConnection(ws, request);
             } catch (error) {
-                this.logger.error('Connection initialization failed', { error });
+                this.logger.error('Connection initialization failed', { err: error });
                 ws.close(1011, 'Internal server error');
             }
         });
@@ -189,7 +187,7 @@ export class WebSocketManager {
             });
 
             ws.on('error', (error) => {
-                this.logger.error('WebSocket error', { clientId, error });
+                this.logger.error('WebSocket error', { clientId, err: error });
                 this.circuitBreaker.recordFailure();
             });
 
@@ -200,6 +198,8 @@ export class WebSocketManager {
                     userId,
                     { mode: request.headers['x-study-mode'], settings: {} }
                 );
+            } else if (sessionType === 'cards') {
+                cardStreamHandler.handleConnection(ws, userId);
             } else if (sessionType === 'voice') {
                 await this.voiceHandler.handleVoiceConnection(
                     ws,
@@ -229,7 +229,7 @@ export class WebSocketManager {
         } catch (error) {
             this.logger.error('Connection handling failed', {
                 clientId,
-                error,
+                err: error,
                 duration: Date.now() - startTime
             });
 
@@ -290,7 +290,7 @@ export class WebSocketManager {
 
             this.logger.info('WebSocket manager cleaned up successfully');
         } catch (error) {
-            this.logger.error('Error during WebSocket cleanup', { error });
+            this.logger.error('Error during WebSocket cleanup', { err: error });
             throw error;
         }
     }
@@ -298,13 +298,13 @@ export class WebSocketManager {
     private initializeMetrics(): void {
         this.metrics = {
             recordGauge: (name: string, value: number) => {
-                this.logger.debug(`Metric ${name}: ${value}`);
+                this.logger.debug('Gauge recorded', { name, value });
             },
             incrementCounter: (name: string) => {
-                this.logger.debug(`Increment counter ${name}`);
+                this.logger.debug('Counter incremented', { name });
             },
             recordLatency: (name: string, value: number) => {
-                this.logger.debug(`Latency ${name}: ${value}ms`);
+                this.logger.debug('Latency recorded', { name, valueMs: value });
             }
         };
     }
@@ -0,0 +1,168 @@
+/**
+ * @fileoverview WebSocket handler delivering generated cards to their owner as they
+ * are produced, so captured content shows its first cards while the rest are still
+ * being generated. Content is processed by whichever cluster worker takes the job,
+ * usually not the one holding the user's socket, so events travel over a Redis channel
+ * per user that every worker with a socket of that user subscribes to.
+ * @version 1.0.0
+ */
+
+import WebSocket from 'ws'; // ^8.x
+import Redis from 'ioredis'; // version: ^5.0.0
+import { ICard } from '../../interfaces/ICard';
+import { asyncLogger, AsyncLogger } from '../../config/asyncLogger';
+
+// WebSocket event constants
+export const WS_CARD_EVENTS = {
+    READY: 'cards:ready',
+    CARD_GENERATED: 'cards:generated',
+    CONTENT_PROCESSED: 'cards:content_processed',
+    CONTENT_FAILED: 'cards:content_failed'
+} as const;
+
+// Stop sending to a socket whose unsent buffer exceeds this; it resyncs over REST
+const MAX_BUFFERED_BYTES = 1024 * 1024;
+
+const CHANNEL_PREFIX = 'cards:stream:';
+
+/**
+ * Every event names the generation of its content that produced it. A retried job
+ * streams its cards again under a new generation id: clients drop cards of earlier
+ * generations of the same content, and repeats of a sequence number they already have.
+ */
+export type CardStreamEvent = { contentId: string; generationId: string } & (
+    | { type: typeof WS_CARD_EVENTS.CARD_GENERATED; sequence: number; chunkIndex?: number; card: ICard }
+    | { type: typeof WS_CARD_EVENTS.CONTENT_PROCESSED; cardCount: number }
+    | { type: typeof WS_CARD_EVENTS.CONTENT_FAILED; error: string }
+);
+
+/**
+ * Tracks each user's card-stream sockets and fans events out to them
+ */
+export class CardStreamHandler {
+    private readonly subscribers: Map<string, Set<WebSocket>>;
+    private client: Redis | null = null;
+    private subscriber: Redis | null = null;
+    // Pending or completed subscription to each user's channel
+    private readonly subscriptions = new Map<string, Promise<unknown>>();
+
+    constructor(
+        private readonly logger: AsyncLogger = asyncLogger.child(
+            { component: 'CardStreamHandler' },
+            // One slow consumer can skip every event of a large generation
+            { 'Skipping card event for slow consumer': 20 }
+        )
+    ) {
+        this.subscribers = new Map();
+    }
+
+    /**
+     * Carries events between workers over Redis from now on; until then they reach
+     * only sockets of this process
+     */
+    public connect(client: Redis, subscriber: Redis = client.duplicate()): void {
+        this.client = client;
+        this.subscriber = subscriber;
+        subscriber.on('message', (channel: string, message: string) => {
+            this.deliver(channel.slice(CHANNEL_PREFIX.length), message);
+        });
+        for (const userId of this.subscribers.keys()) {
+            this.listen(userId);
+        }
+    }
+
+    /**
+     * Subscribes a socket to the user's card events until it closes
+     */
+    public handleConnection(ws: WebSocket, userId: string): void {
+        const sockets = this.subscribers.get(userId) ?? new Set<WebSocket>();
+        sockets.add(ws);
+        this.subscribers.set(userId, sockets);
+        if (sockets.size === 1) {
+            this.listen(userId);
+        }
+
+        ws.on('close', () => {
+            sockets.delete(ws);
+            if (sockets.size === 0) {
+                this.subscribers.delete(userId);
+                this.subscriptions.delete(userId);
+                this.subscriber?.unsubscribe(this.channel(userId)).catch(() => undefined);
+            }
+        });
+
+        // Events published from here on reach the socket
+        const sendReady = () => {
+            if (ws.readyState === WebSocket.OPEN) {
+                ws.send(JSON.stringify({ type: WS_CARD_EVENTS.READY, timestamp: Date.now() }));
+            }
+        };
+        const subscribed = this.subscriptions.get(userId);
+        if (subscribed) {
+            subscribed.then(sendReady);
+        } else {
+            sendReady();
+        }
+    }
+
+    /**
+     * Sends an event to every open card-stream socket of a user, on any worker
+     * @returns Sockets the event was sent to in this process or, once connected to
+     * Redis, workers holding a socket of the user
+     */
+    public async publish(userId: string, event: CardStreamEvent): Promise<number> {
+        const message = JSON.stringify({ ...event, timestamp: Date.now() });
+        if (!this.client) {
+            return this.deliver(userId, message);
+        }
+        try {
+            return await this.client.publish(this.channel(userId), message);
+        } catch (error) {
+            this.logger.warn('Card event not published', { userId, type: event.type, error: error.message });
+            return 0;
+        }
+    }
+
+    private deliver(userId: string, message: string): number {
+        const sockets = this.subscribers.get(userId);
+        if (!sockets) {
+            return 0;
+        }
+
+        let delivered = 0;
+        for (const ws of sockets) {
+            if (ws.readyState !== WebSocket.OPEN) {
+                continue;
+            }
+            if (ws.bufferedAmount > MAX_BUFFERED_BYTES) {
+                this.logger.warn('Skipping card event for slow consumer', { userId });
+                continue;
+            }
+            ws.send(message);
+            delivered++;
+        }
+        return delivered;
+    }
+
+    private listen(userId: string): void {
+        if (!this.subscriber) {
+            return;
+        }
+        this.subscriptions.set(userId, this.subscriber.subscribe(this.channel(userId)).catch((error) => {
+            this.logger.warn('Card stream not subscribed', { userId, error: error.message });
+        }));
+    }
+
+    private channel(userId: string): string {
+        return `${CHANNEL_PREFIX}${userId}`;
+    }
+
+    /**
+     * Number of users with at least one open card stream
+     */
+    public get subscriberCount(): number {
+        return this.subscribers.size;
+    }
+}
+
+export const cardStreamHandler = new CardStreamHandler();
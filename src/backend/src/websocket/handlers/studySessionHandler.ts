@@ -6,11 +6,12 @@
  */
 
 import WebSocket from 'ws'; // ^8.x
-import winston from 'winston'; // ^3.10.0
 import { performance } from 'perf_hooks';
 import { StudySessionManager } from '../../core/study/studySessionManager';
 import { StudyModes } from '../../constants/studyModes';
 import { IStudySession } from '../../interfaces/IStudySession';
+import { asyncLogger, AsyncLogger } from '../../config/asyncLogger';
+import { runInLoaderScope } from '../../utils/batchLoader';
 
 // WebSocket event constants
 const WS_STUDY_EVENTS = {
@@ -36,6 +37,13 @@ const PERFORMANCE_THRESHOLDS = {
     RECONNECT_TIMEOUT_MS: 5000
 };
 
+// Per-message events keep one entry in N; under load every message can cross a threshold
+const LOG_SAMPLING = {
+    'Study message handled': 100,
+    'High study response latency': 20,
+    'Slow study message send': 20
+};
+
 interface SessionState {
     id: string;
     userId: string;
@@ -55,22 +63,16 @@ interface SessionState {
  */
 export class StudySessionHandler {
     private readonly studySessionManager: StudySessionManager;
-    private readonly logger: winston.Logger;
+    private readonly logger: AsyncLogger;
     private readonly activeStudySessions: Map<string, WebSocket>;
     private readonly sessionStates: Map<string, SessionState>;
     private readonly heartbeatInterval: number;
 
     constructor(
         private readonly studySessionManager: StudySessionManager = new StudySessionManager(),
-        private readonly logger: winston.Logger = winston.createLogger({
-            level: 'info',
-            format: winston.format.combine(
-                winston.format.timestamp(),
-                winston.format.json()
-            ),
-            transports: [new winston.transports.Console()]
-        })
+        private readonly logger: AsyncLogger = asyncLogger
     ) {
+        this.logger = logger.child({ component: 'StudySessionHandler' }, LOG_SAMPLING);
         this.activeStudySessions = new Map();
         this.sessionStates = new Map();
         this.heartbeatInterval = PERFORMANCE_THRESHOLDS.HEARTBEAT_INTERVAL_MS;
@@ -121,7 +123,7 @@ export class StudySessionHandler {
                 data: session
             });
 
-            this.logger.info(`Study session started: ${session.id} for user: ${userId}`);
+            this.logger.info('Study session started', { sessionId: session.id, userId });
         } catch (error) {
             this.handleError(ws, error);
         }
@@ -131,7 +133,8 @@ export class StudySessionHandler {
      * Sets up WebSocket message handlers with performance tracking
      */
     private setupMessageHandlers(ws: WebSocket, session: IStudySession): void {
-        ws.on('message', async (message: string) => {
+        // Each message gets its own loaders, like an HTTP request
+        ws.on('message', (message: string) => runInLoaderScope(async () => {
             const startTime = performance.now();
             try {
                 const { type, data } = JSON.parse(message);
@@ -168,11 +171,16 @@ export class StudySessionHandler {
                 // Track response time
                 const responseTime = performance.now() - startTime;
                 this.trackPerformanceMetric(session.id, 'responseTime', responseTime);
+                this.logger.debug('Study message handled', () => ({
+                    sessionId: session.id,
+                    type,
+                    responseTimeMs: responseTime
+                }));
 
             } catch (error) {
                 this.handleError(ws, error);
             }
-        });
+        }));
 
         // Handle connection closure
         ws.on('close', () => {
@@ -296,7 +304,7 @@ export class StudySessionHandler {
             
             // Alert if response time exceeds threshold
             if (value > PERFORMANCE_THRESHOLDS.RESPONSE_TIME_MS) {
-                this.logger.warn(`High latency detected in session ${sessionId}: ${value}ms`);
+                this.logger.warn('High study response latency', { sessionId, latencyMs: value });
             }
         }
     }
@@ -314,7 +322,7 @@ export class StudySessionHandler {
 
         const latency = performance.now() - startTime;
         if (latency > PERFORMANCE_THRESHOLDS.RESPONSE_TIME_MS) {
-            this.logger.warn(`Message send latency exceeded threshold: ${latency}ms`);
+            this.logger.warn('Slow study message send', { type: message.type, latencyMs: latency });
         }
     }
 
@@ -322,7 +330,7 @@ export class StudySessionHandler {
      * Handles WebSocket errors with logging
      */
     private handleError(ws: WebSocket, error: any): void {
-        this.logger.error('WebSocket error:', error);
+        this.logger.error('Study session error', { err: error });
         
         ws.send(JSON.stringify({
             type: WS_STUDY_EVENTS.SESSION_ERROR,
@@ -339,7 +347,7 @@ export class StudySessionHandler {
     private handleSessionClose(sessionId: string): void {
         this.activeStudySessions.delete(sessionId);
         this.sessionStates.delete(sessionId);
-        this.logger.info(`Study session closed: ${sessionId}`);
+        this.logger.info('Study session closed', { sessionId });
     }
 
     /**
@@ -5,10 +5,11 @@
  */
 
 import WebSocket from 'ws'; // ^8.x
-import winston from 'winston'; // ^3.10.0
 import { VoiceService } from '../../services/VoiceService';
 import { StudyModes } from '../../constants/studyModes';
 import { MetricsCollector } from '../../core/metrics/MetricsCollector';
+import { asyncLogger, AsyncLogger } from '../../config/asyncLogger';
+import { runInLoaderScope } from '../../utils/batchLoader';
 
 // WebSocket event constants
 const WS_VOICE_EVENTS = {
@@ -37,6 +38,12 @@ const VOICE_METRICS = {
   ACTIVE_SESSIONS: 'active_voice_sessions'
 } as const;
 
+// Per-message events keep one entry in N
+const LOG_SAMPLING = {
+  'Voice message received': 100,
+  'Unknown voice event received': 50
+};
+
 // Voice session metrics interface
 interface VoiceSessionMetrics {
   startTime: number;
@@ -59,25 +66,18 @@ interface VoiceSessionConfig {
  */
 export class VoiceHandler {
   private readonly voiceService: VoiceService;
-  private readonly logger: winston.Logger;
+  private readonly logger: AsyncLogger;
   private readonly activeVoiceSessions: Map<string, WebSocket>;
   private readonly sessionMetrics: Map<string, VoiceSessionMetrics>;
   private readonly retryCount: Map<string, number>;
 
   constructor(
     private readonly voiceService: VoiceService = new VoiceService(),
-    private readonly logger: winston.Logger = winston.createLogger({
-        level: 'info',
-        format: winston.format.combine(
-            winston.format.timestamp(),
-            winston.format.json()
-        ),
-        transports: [new winston.transports.Console()]
-    }),
+    private readonly logger: AsyncLogger = asyncLogger,
     private readonly metricsCollector: MetricsCollector = new MetricsCollector()
   ) {
     this.voiceService = voiceService;
-    this.logger = logger.child({ service: 'VoiceHandler' });
+    this.logger = logger.child({ component: 'VoiceHandler' }, LOG_SAMPLING);
     this.activeVoiceSessions = new Map();
     this.sessionMetrics = new Map();
     this.retryCount = new Map();
@@ -207,10 +207,12 @@ export class VoiceHandler {
     config: VoiceSessionConfig
   ): void {
     // Handle incoming messages
-    ws.on('message', async (data: WebSocket.Data) => {
+    // Each message gets its own loaders, like an HTTP request
+    ws.on('message', (data: WebSocket.Data) => runInLoaderScope(async () => {
       try {
         const message = JSON.parse(data.toString());
-        
+        this.logger.debug('Voice message received', () => ({ sessionId, event: message.event }));
+
         switch (message.event) {
           case WS_VOICE_EVENTS.VOICE_INPUT:
             await this.handleVoiceInput(ws, sessionId, message.data);
@@ -227,7 +229,7 @@ export class VoiceHandler {
       } catch (error) {
         this.handleVoiceError(ws, sessionId, error);
       }
-    });
+    }));
 
     // Handle connection close
     ws.on('close', () => {
@@ -331,11 +333,7 @@ export class VoiceHandler {
     sessionId: string,
     error: Error
   ): void {
-    this.logger.error('Voice error occurred', {
-      sessionId,
-      error: error.message,
-      stack: error.stack
-    });
+    this.logger.error('Voice error occurred', { sessionId, err: error });
 
     ws.send(JSON.stringify({
       event: WS_VOICE_EVENTS.VOICE_ERROR,
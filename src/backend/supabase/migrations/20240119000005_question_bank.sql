@@ -0,0 +1,103 @@
+-- Precomputed quiz questions per content item, built in the background after card
+-- generation so starting a quiz only samples stored rows
+
+CREATE TABLE public.question_banks (
+    content_id UUID PRIMARY KEY REFERENCES public.content(id) ON DELETE CASCADE,
+    user_id UUID NOT NULL REFERENCES auth.users(id) ON DELETE CASCADE,
+    version INTEGER NOT NULL DEFAULT 0,
+    question_count INTEGER NOT NULL DEFAULT 0,
+    built_at TIMESTAMPTZ,
+    -- Set when a card of the content changes; cleared by the next refresh
+    stale_since TIMESTAMPTZ,
+    created_at TIMESTAMPTZ NOT NULL DEFAULT now(),
+    updated_at TIMESTAMPTZ DEFAULT now()
+);
+
+CREATE TABLE public.quiz_questions (
+    id UUID PRIMARY KEY DEFAULT uuid_generate_v4(),
+    card_id UUID NOT NULL UNIQUE REFERENCES public.cards(id) ON DELETE CASCADE,
+    content_id UUID NOT NULL REFERENCES public.question_banks(content_id) ON DELETE CASCADE,
+    user_id UUID NOT NULL REFERENCES auth.users(id) ON DELETE CASCADE,
+    -- Hash of the card text the question was built from; unchanged cards are skipped on refresh
+    card_hash TEXT NOT NULL,
+    bank_version INTEGER NOT NULL,
+    question TEXT NOT NULL,
+    question_type TEXT NOT NULL DEFAULT 'multiple_choice',
+    options JSONB NOT NULL DEFAULT '[]'::jsonb,
+    correct_answer TEXT NOT NULL,
+    explanation TEXT,
+    -- Uniform random position for sampling without ORDER BY random()
+    sample_key DOUBLE PRECISION NOT NULL DEFAULT random(),
+    created_at TIMESTAMPTZ NOT NULL DEFAULT now(),
+    CONSTRAINT valid_question_type CHECK (
+        question_type = ANY(ARRAY['multiple_choice', 'true_false', 'fill_in_blank'])
+    ),
+    CONSTRAINT valid_options CHECK (jsonb_typeof(options) = 'array')
+);
+
+ALTER TABLE public.question_banks ENABLE ROW LEVEL SECURITY;
+ALTER TABLE public.quiz_questions ENABLE ROW LEVEL SECURITY;
+
+-- Banks are written by the backend service role; users only read their own
+CREATE POLICY "Users can view own question banks" ON public.question_banks
+    FOR SELECT USING (auth.uid() = user_id);
+
+CREATE POLICY "Users can view own quiz questions" ON public.quiz_questions
+    FOR SELECT USING (auth.uid() = user_id);
+
+CREATE INDEX idx_quiz_questions_sample ON public.quiz_questions(user_id, sample_key);
+CREATE INDEX idx_quiz_questions_content ON public.quiz_questions(content_id, sample_key);
+CREATE INDEX idx_question_banks_stale ON public.question_banks(stale_since)
+    WHERE stale_since IS NOT NULL;
+
+-- Marks the bank of a card's content stale on any card write, whichever client made it
+CREATE OR REPLACE FUNCTION public.mark_question_bank_stale()
+RETURNS TRIGGER AS $$
+BEGIN
+    UPDATE public.question_banks
+    SET stale_since = COALESCE(stale_since, now())
+    WHERE content_id IN (
+        CASE WHEN TG_OP = 'DELETE' THEN OLD.content_id ELSE NEW.content_id END,
+        CASE WHEN TG_OP = 'UPDATE' THEN OLD.content_id END
+    );
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER on_card_change_mark_bank_stale
+    AFTER INSERT OR DELETE OR UPDATE OF front_content, back_content, content_id ON public.cards
+    FOR EACH ROW
+    EXECUTE FUNCTION public.mark_question_bank_stale();
+
+-- Samples up to p_count questions for a quiz: starts at a random sample key and wraps
+-- around, so the cost is two index range scans whatever the bank size
+CREATE OR REPLACE FUNCTION public.sample_quiz_questions(
+    p_user_id UUID,
+    p_count INTEGER,
+    p_content_id UUID DEFAULT NULL
+)
+RETURNS SETOF public.quiz_questions AS $$
+DECLARE
+    v_start DOUBLE PRECISION := random();
+BEGIN
+    RETURN QUERY
+    (
+        SELECT * FROM public.quiz_questions q
+        WHERE q.user_id = p_user_id
+            AND (p_content_id IS NULL OR q.content_id = p_content_id)
+            AND q.sample_key >= v_start
+        ORDER BY q.sample_key
+        LIMIT p_count
+    )
+    UNION ALL
+    (
+        SELECT * FROM public.quiz_questions q
+        WHERE q.user_id = p_user_id
+            AND (p_content_id IS NULL OR q.content_id = p_content_id)
+            AND q.sample_key < v_start
+        ORDER BY q.sample_key
+        LIMIT p_count
+    )
+    LIMIT p_count;
+END;
+$$ LANGUAGE plpgsql STABLE;
@@ -0,0 +1,16 @@
+-- Replication status for routing reads to replicas. Returns zero lag on the primary and
+-- on a replica that has replayed everything it received; otherwise the age of the last
+-- replayed commit, or NULL before any commit has been replayed.
+
+CREATE OR REPLACE FUNCTION public.replica_status()
+RETURNS TABLE (in_recovery BOOLEAN, lag_seconds DOUBLE PRECISION) AS $$
+    SELECT
+        pg_is_in_recovery(),
+        CASE
+            WHEN NOT pg_is_in_recovery() THEN 0
+            -- Caught up, however long ago the last commit was
+            WHEN pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0
+            ELSE EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp())::DOUBLE PRECISION
+        END;
+$$ LANGUAGE sql STABLE;
+
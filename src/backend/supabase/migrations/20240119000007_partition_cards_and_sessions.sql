@@ -0,0 +1,363 @@
+-- Hash partitioning of cards and study sessions by user, so vacuum and index upkeep
+-- scale with a partition rather than with the whole user base.
+--
+-- This migration is online. It creates partitioned copies of both tables, keeps them in
+-- step with triggers on the live tables, and adds the functions that
+-- scripts/migrate-partitions.ts drives:
+--   backfill_partitioned()  copies existing rows in resumable batches
+--   partition_cutover()     swaps the partitioned tables in under a short lock
+-- An empty database (a fresh install) is cut over at the end of this migration.
+
+-- Partitioned tables: same columns and order as the live tables; the partition key has to
+-- be part of every unique constraint, so primary keys become (user_id, id)
+
+CREATE TABLE public.cards_partitioned (
+    id UUID NOT NULL DEFAULT uuid_generate_v4(),
+    user_id UUID NOT NULL REFERENCES auth.users(id) ON DELETE CASCADE,
+    content_id UUID REFERENCES public.content(id) ON DELETE CASCADE,
+    front_content JSONB NOT NULL,
+    back_content JSONB NOT NULL,
+    fsrs_data JSONB NOT NULL DEFAULT '{
+        "stability": 0.5,
+        "difficulty": 0.3,
+        "reviewCount": 0,
+        "lastReview": null,
+        "lastRating": 0,
+        "performanceHistory": []
+    }',
+    next_review TIMESTAMPTZ NOT NULL DEFAULT now(),
+    compatible_modes TEXT[] NOT NULL DEFAULT '{STANDARD}',
+    tags TEXT[] NOT NULL DEFAULT '{}',
+    created_at TIMESTAMPTZ NOT NULL DEFAULT now(),
+    updated_at TIMESTAMPTZ DEFAULT now(),
+    PRIMARY KEY (user_id, id),
+    CONSTRAINT valid_card_content CHECK (
+        (front_content->>'text' IS NOT NULL) AND
+        (front_content->>'type' IN ('text', 'markdown', 'html', 'code')) AND
+        (back_content->>'text' IS NOT NULL) AND
+        (back_content->>'type' IN ('text', 'markdown', 'html', 'code'))
+    )
+) PARTITION BY HASH (user_id);
+
+CREATE TABLE public.study_sessions_partitioned (
+    id UUID NOT NULL DEFAULT uuid_generate_v4(),
+    user_id UUID NOT NULL REFERENCES auth.users(id) ON DELETE CASCADE,
+    mode study_mode NOT NULL DEFAULT 'STANDARD',
+    cards_studied UUID[] NOT NULL DEFAULT ARRAY[]::UUID[],
+    status TEXT NOT NULL DEFAULT 'active' CHECK (status IN ('active', 'completed', 'paused')),
+    performance JSONB NOT NULL DEFAULT '{
+        "totalCards": 0,
+        "correctCount": 0,
+        "averageConfidence": 0,
+        "studyStreak": 0,
+        "timeSpent": 0,
+        "fsrsProgress": {
+            "averageStability": 0,
+            "averageDifficulty": 0,
+            "retentionRate": 0,
+            "intervalProgress": 0
+        }
+    }',
+    settings JSONB NOT NULL DEFAULT '{
+        "sessionDuration": 30,
+        "cardsPerSession": 20,
+        "showConfidenceButtons": true,
+        "enableFSRS": true,
+        "voiceConfig": {
+            "recognitionThreshold": 0.8,
+            "language": "en-US",
+            "useNativeSpeaker": false
+        }
+    }',
+    start_time TIMESTAMPTZ NOT NULL DEFAULT now(),
+    end_time TIMESTAMPTZ,
+    created_at TIMESTAMPTZ DEFAULT now(),
+    updated_at TIMESTAMPTZ DEFAULT now(),
+    PRIMARY KEY (user_id, id)
+) PARTITION BY HASH (user_id);
+
+-- 16 partitions each: a user's rows, and their due and history queries, stay in one
+DO $$
+BEGIN
+    FOR i IN 0..15 LOOP
+        EXECUTE format(
+            'CREATE TABLE public.cards_p%s PARTITION OF public.cards_partitioned FOR VALUES WITH (MODULUS 16, REMAINDER %s)',
+            lpad(i::text, 2, '0'), i
+        );
+        EXECUTE format(
+            'CREATE TABLE public.study_sessions_p%s PARTITION OF public.study_sessions_partitioned FOR VALUES WITH (MODULUS 16, REMAINDER %s)',
+            lpad(i::text, 2, '0'), i
+        );
+    END LOOP;
+END $$;
+
+-- Indexes on the parents are created on every partition. Per-user indexes lead with
+-- user_id; the (user_id) index of the live table is covered by the primary key. Lookups
+-- by id alone check the id index of each partition.
+CREATE INDEX idx_cards_part_next_review ON public.cards_partitioned(user_id, next_review);
+CREATE INDEX idx_cards_part_id ON public.cards_partitioned(id);
+CREATE INDEX idx_cards_part_content ON public.cards_partitioned(content_id);
+CREATE INDEX idx_cards_part_tags ON public.cards_partitioned USING GIN(tags);
+CREATE INDEX idx_study_sessions_part_user ON public.study_sessions_partitioned(user_id, start_time);
+CREATE INDEX idx_study_sessions_part_id ON public.study_sessions_partitioned(id);
+
+-- Same row security as the live tables
+ALTER TABLE public.cards_partitioned ENABLE ROW LEVEL SECURITY;
+ALTER TABLE public.study_sessions_partitioned ENABLE ROW LEVEL SECURITY;
+
+CREATE POLICY "Users can view own cards" ON public.cards_partitioned
+    FOR SELECT USING (auth.uid() = user_id);
+
+CREATE POLICY "Users can insert own cards" ON public.cards_partitioned
+    FOR INSERT WITH CHECK (auth.uid() = user_id);
+
+CREATE POLICY "Users can update own cards" ON public.cards_partitioned
+    FOR UPDATE USING (auth.uid() = user_id);
+
+CREATE POLICY "Users can delete own cards" ON public.cards_partitioned
+    FOR DELETE USING (auth.uid() = user_id);
+
+CREATE POLICY "Users can view own study sessions" ON public.study_sessions_partitioned
+    FOR SELECT USING (auth.uid() = user_id);
+
+CREATE POLICY "Users can insert own study sessions" ON public.study_sessions_partitioned
+    FOR INSERT WITH CHECK (auth.uid() = user_id);
+
+CREATE POLICY "Users can update own study sessions" ON public.study_sessions_partitioned
+    FOR UPDATE USING (auth.uid() = user_id);
+
+-- Migration progress, per live table
+CREATE TABLE public.partition_migration (
+    table_name TEXT PRIMARY KEY,
+    backfilled_through UUID,
+    completed_at TIMESTAMPTZ,
+    cutover_at TIMESTAMPTZ
+);
+
+INSERT INTO public.partition_migration (table_name) VALUES ('cards'), ('study_sessions');
+
+ALTER TABLE public.partition_migration ENABLE ROW LEVEL SECURITY;
+
+-- Mirror every write to the live tables into the partitioned copies from now on. Cards
+-- without a user cannot be partitioned; they are skipped and block the cutover.
+CREATE OR REPLACE FUNCTION public.sync_cards_partitioned()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'DELETE' OR (TG_OP = 'UPDATE' AND OLD.user_id IS DISTINCT FROM NEW.user_id) THEN
+        DELETE FROM public.cards_partitioned WHERE user_id = OLD.user_id AND id = OLD.id;
+    END IF;
+
+    IF TG_OP <> 'DELETE' AND NEW.user_id IS NOT NULL THEN
+        INSERT INTO public.cards_partitioned (
+            id, user_id, content_id, front_content, back_content, fsrs_data, next_review,
+            compatible_modes, tags, created_at, updated_at
+        ) VALUES (
+            NEW.id, NEW.user_id, NEW.content_id, NEW.front_content, NEW.back_content, NEW.fsrs_data,
+            NEW.next_review, NEW.compatible_modes, NEW.tags, NEW.created_at, NEW.updated_at
+        )
+        ON CONFLICT (user_id, id) DO UPDATE SET
+            content_id = EXCLUDED.content_id,
+            front_content = EXCLUDED.front_content,
+            back_content = EXCLUDED.back_content,
+            fsrs_data = EXCLUDED.fsrs_data,
+            next_review = EXCLUDED.next_review,
+            compatible_modes = EXCLUDED.compatible_modes,
+            tags = EXCLUDED.tags,
+            created_at = EXCLUDED.created_at,
+            updated_at = EXCLUDED.updated_at;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql SECURITY DEFINER;
+
+CREATE OR REPLACE FUNCTION public.sync_study_sessions_partitioned()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'DELETE' OR (TG_OP = 'UPDATE' AND OLD.user_id IS DISTINCT FROM NEW.user_id) THEN
+        DELETE FROM public.study_sessions_partitioned WHERE user_id = OLD.user_id AND id = OLD.id;
+    END IF;
+
+    IF TG_OP <> 'DELETE' THEN
+        INSERT INTO public.study_sessions_partitioned (
+            id, user_id, mode, cards_studied, status, performance, settings, start_time,
+            end_time, created_at, updated_at
+        ) VALUES (
+            NEW.id, NEW.user_id, NEW.mode, NEW.cards_studied, NEW.status, NEW.performance,
+            NEW.settings, NEW.start_time, NEW.end_time, NEW.created_at, NEW.updated_at
+        )
+        ON CONFLICT (user_id, id) DO UPDATE SET
+            mode = EXCLUDED.mode,
+            cards_studied = EXCLUDED.cards_studied,
+            status = EXCLUDED.status,
+            performance = EXCLUDED.performance,
+            settings = EXCLUDED.settings,
+            start_time = EXCLUDED.start_time,
+            end_time = EXCLUDED.end_time,
+            created_at = EXCLUDED.created_at,
+            updated_at = EXCLUDED.updated_at;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql SECURITY DEFINER;
+
+CREATE TRIGGER sync_cards_partitioned
+    AFTER INSERT OR UPDATE OR DELETE ON public.cards
+    FOR EACH ROW
+    EXECUTE FUNCTION public.sync_cards_partitioned();
+
+CREATE TRIGGER sync_study_sessions_partitioned
+    AFTER INSERT OR UPDATE OR DELETE ON public.study_sessions
+    FOR EACH ROW
+    EXECUTE FUNCTION public.sync_study_sessions_partitioned();
+
+-- Copies the next batch of existing rows, in id order, and records how far it got.
+-- Source rows are share-locked while they are copied, so a concurrent delete waits and
+-- its trigger then removes the copy instead of the copy outliving the row. Rows the
+-- triggers already mirrored are newer and are kept.
+-- Returns the number of rows read; 0 once the table is done.
+CREATE OR REPLACE FUNCTION public.backfill_partitioned(p_table TEXT, p_batch_size INTEGER DEFAULT 5000)
+RETURNS INTEGER AS $$
+DECLARE
+    v_after UUID;
+    v_last UUID;
+    v_count INTEGER;
+BEGIN
+    SELECT backfilled_through INTO v_after
+    FROM public.partition_migration
+    WHERE table_name = p_table AND completed_at IS NULL
+    FOR UPDATE;
+
+    IF NOT FOUND THEN
+        RETURN 0;
+    END IF;
+    v_after := COALESCE(v_after, '00000000-0000-0000-0000-000000000000');
+
+    IF p_table = 'cards' THEN
+        WITH batch AS (
+            SELECT * FROM public.cards
+            WHERE id > v_after
+            ORDER BY id
+            LIMIT p_batch_size
+            FOR SHARE
+        ), copied AS (
+            INSERT INTO public.cards_partitioned (
+                id, user_id, content_id, front_content, back_content, fsrs_data, next_review,
+                compatible_modes, tags, created_at, updated_at
+            )
+            SELECT id, user_id, content_id, front_content, back_content, fsrs_data, next_review,
+                compatible_modes, tags, created_at, updated_at
+            FROM batch
+            WHERE user_id IS NOT NULL
+            ON CONFLICT (user_id, id) DO NOTHING
+        )
+        SELECT count(*), (array_agg(id ORDER BY id DESC))[1] INTO v_count, v_last FROM batch;
+    ELSIF p_table = 'study_sessions' THEN
+        WITH batch AS (
+            SELECT * FROM public.study_sessions
+            WHERE id > v_after
+            ORDER BY id
+            LIMIT p_batch_size
+            FOR SHARE
+        ), copied AS (
+            INSERT INTO public.study_sessions_partitioned (
+                id, user_id, mode, cards_studied, status, performance, settings, start_time,
+                end_time, created_at, updated_at
+            )
+            SELECT id, user_id, mode, cards_studied, status, performance, settings, start_time,
+                end_time, created_at, updated_at
+            FROM batch
+            ON CONFLICT (user_id, id) DO NOTHING
+        )
+        SELECT count(*), (array_agg(id ORDER BY id DESC))[1] INTO v_count, v_last FROM batch;
+    ELSE
+        RAISE EXCEPTION 'No partitioned copy of table %', p_table;
+    END IF;
+
+    UPDATE public.partition_migration
+    SET backfilled_through = COALESCE(v_last, backfilled_through),
+        completed_at = CASE WHEN v_count = 0 THEN now() END
+    WHERE table_name = p_table;
+
+    RETURN v_count;
+END;
+$$ LANGUAGE plpgsql SECURITY DEFINER;
+
+-- Swaps the partitioned tables in for the live ones. Run in a transaction with a short
+-- lock_timeout: it takes exclusive locks, but every step is a catalog change, and foreign
+-- keys are added NOT VALID to be validated afterwards without blocking writes.
+-- The old tables are kept, renamed *_unpartitioned, until they are dropped by hand.
+CREATE OR REPLACE FUNCTION public.partition_cutover()
+RETURNS VOID AS $$
+BEGIN
+    LOCK TABLE public.cards, public.study_sessions, public.quiz_questions IN ACCESS EXCLUSIVE MODE;
+
+    IF EXISTS (SELECT 1 FROM public.partition_migration WHERE cutover_at IS NOT NULL) THEN
+        RAISE EXCEPTION 'Partition cutover has already run';
+    END IF;
+    IF EXISTS (SELECT 1 FROM public.partition_migration WHERE completed_at IS NULL) THEN
+        RAISE EXCEPTION 'Backfill is not complete';
+    END IF;
+    IF EXISTS (SELECT 1 FROM public.cards WHERE user_id IS NULL) THEN
+        RAISE EXCEPTION 'Cards without a user cannot be partitioned; assign or delete them first';
+    END IF;
+
+    DROP TRIGGER sync_cards_partitioned ON public.cards;
+    DROP TRIGGER sync_study_sessions_partitioned ON public.study_sessions;
+
+    ALTER TABLE public.cards RENAME TO cards_unpartitioned;
+    ALTER TABLE public.cards_partitioned RENAME TO cards;
+    ALTER TABLE public.study_sessions RENAME TO study_sessions_unpartitioned;
+    ALTER TABLE public.study_sessions_partitioned RENAME TO study_sessions;
+
+    -- Quiz questions carry the card's user, which completes the key of a partitioned card
+    ALTER TABLE public.quiz_questions DROP CONSTRAINT quiz_questions_card_id_fkey;
+    ALTER TABLE public.quiz_questions
+        ADD CONSTRAINT quiz_questions_card_fkey FOREIGN KEY (user_id, card_id)
+        REFERENCES public.cards(user_id, id) ON DELETE CASCADE NOT VALID;
+
+    -- Triggers move now rather than at creation, so the backfill did not fire them
+    DROP TRIGGER on_card_change_mark_bank_stale ON public.cards_unpartitioned;
+    CREATE TRIGGER on_card_change_mark_bank_stale
+        AFTER INSERT OR DELETE OR UPDATE OF front_content, back_content, content_id ON public.cards
+        FOR EACH ROW
+        EXECUTE FUNCTION public.mark_question_bank_stale();
+
+    DROP TRIGGER update_session_duration ON public.study_sessions_unpartitioned;
+    CREATE TRIGGER update_session_duration
+        BEFORE UPDATE ON public.study_sessions
+        FOR EACH ROW
+        EXECUTE FUNCTION public.calculate_session_duration();
+
+    DROP TRIGGER on_study_session_complete ON public.study_sessions_unpartitioned;
+    CREATE TRIGGER on_study_session_complete
+        AFTER UPDATE ON public.study_sessions
+        FOR EACH ROW
+        WHEN (OLD.status IS DISTINCT FROM NEW.status)
+        EXECUTE FUNCTION public.update_study_streak();
+
+    DROP TRIGGER on_session_complete ON public.study_sessions_unpartitioned;
+    CREATE TRIGGER on_session_complete
+        AFTER UPDATE ON public.study_sessions
+        FOR EACH ROW
+        WHEN (NEW.status = 'completed' AND OLD.status != 'completed')
+        EXECUTE FUNCTION public.update_daily_analytics();
+
+    -- Realtime: changes to a partition are published as changes to its parent
+    IF EXISTS (SELECT 1 FROM pg_publication WHERE pubname = 'supabase_realtime') THEN
+        ALTER PUBLICATION supabase_realtime DROP TABLE public.cards_unpartitioned, public.study_sessions_unpartitioned;
+        ALTER PUBLICATION supabase_realtime SET (publish_via_partition_root = true);
+        ALTER PUBLICATION supabase_realtime ADD TABLE public.cards, public.study_sessions;
+    END IF;
+
+    UPDATE public.partition_migration SET cutover_at = now();
+END;
+$$ LANGUAGE plpgsql;
+
+-- Nothing to backfill on a fresh install
+DO $$
+BEGIN
+    IF NOT EXISTS (SELECT 1 FROM public.cards) AND NOT EXISTS (SELECT 1 FROM public.study_sessions) THEN
+        UPDATE public.partition_migration SET completed_at = now();
+        PERFORM public.partition_cutover();
+    END IF;
+END $$;
@@ -0,0 +1,19 @@
+-- Card changes are streamed to clients over Supabase Realtime (cardRealtimeHub). With the
+-- default replica identity, the old row of an update or delete carries only the primary
+-- key; FULL logs the whole previous row, so clients get its user_id and prior values.
+--
+-- Replica identity is not inherited: rows are decoded from the partition that holds them,
+-- so every partition is set, along with the partitioned copy of a migration that has not
+-- been cut over yet.
+DO $$
+DECLARE
+    relation REGCLASS;
+BEGIN
+    FOR relation IN
+        SELECT relid FROM pg_partition_tree('public.cards')
+        UNION
+        SELECT relid FROM pg_partition_tree(to_regclass('public.cards_partitioned'))
+    LOOP
+        EXECUTE format('ALTER TABLE %s REPLICA IDENTITY FULL', relation);
+    END LOOP;
+END $$;
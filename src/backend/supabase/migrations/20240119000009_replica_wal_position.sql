@@ -0,0 +1,19 @@
+-- Replaces the lag estimate of replica_status() with WAL positions. The estimate reported
+-- a replica as caught up whenever it had replayed all it had received, even while it
+-- received nothing, and read-your-writes compared it against the application's clock.
+-- The query router now compares positions instead: on the primary this is the current
+-- WAL position, recorded after each write; on a replica, the position replayed so far.
+-- NULL on a replica that has not replayed anything yet. STABLE, so PostgREST runs it in
+-- a read-only transaction, which a hot standby accepts.
+
+DROP FUNCTION IF EXISTS public.replica_status();
+
+CREATE FUNCTION public.replica_status()
+RETURNS TABLE (in_recovery BOOLEAN, wal_lsn TEXT) AS $$
+    SELECT
+        pg_is_in_recovery(),
+        CASE
+            WHEN pg_is_in_recovery() THEN pg_last_wal_replay_lsn()
+            ELSE pg_current_wal_lsn()
+        END::TEXT;
+$$ LANGUAGE sql STABLE;
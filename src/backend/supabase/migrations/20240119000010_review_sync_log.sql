@@ -0,0 +1,98 @@
+-- Server review log for offline devices. Each device pushes the reviews it recorded
+-- locally, keyed by its own log sequence, and pulls the reviews of its other devices
+-- by server sequence
+
+CREATE TABLE public.review_log (
+    seq BIGSERIAL PRIMARY KEY,
+    user_id UUID NOT NULL REFERENCES auth.users(id) ON DELETE CASCADE,
+    device_id TEXT NOT NULL,
+    -- Sequence of the entry in the device's local log; a retried push is a no-op
+    device_seq BIGINT NOT NULL,
+    card_id UUID NOT NULL,
+    rating SMALLINT NOT NULL,
+    reviewed_at TIMESTAMPTZ NOT NULL,
+    -- FSRS state after the review, as the device computed it
+    stability DOUBLE PRECISION NOT NULL,
+    difficulty DOUBLE PRECISION NOT NULL,
+    due_at TIMESTAMPTZ NOT NULL,
+    created_at TIMESTAMPTZ NOT NULL DEFAULT now(),
+    CONSTRAINT review_log_device_seq UNIQUE (user_id, device_id, device_seq),
+    CONSTRAINT valid_review_rating CHECK (rating BETWEEN 1 AND 5)
+);
+
+ALTER TABLE public.review_log ENABLE ROW LEVEL SECURITY;
+
+-- Written by the backend service role; users only read their own
+CREATE POLICY "Users can view own review log" ON public.review_log
+    FOR SELECT USING (auth.uid() = user_id);
+
+CREATE INDEX idx_review_log_pull ON public.review_log(user_id, seq);
+
+-- Appends a device's reviews and moves each reviewed card to the state of its latest
+-- review, unless the card was already reviewed later elsewhere. Returns the highest
+-- device sequence stored, which the device acknowledges
+CREATE OR REPLACE FUNCTION public.append_device_reviews(
+    p_user_id UUID,
+    p_device_id TEXT,
+    p_reviews JSONB
+)
+RETURNS BIGINT AS $$
+DECLARE
+    v_acknowledged BIGINT;
+BEGIN
+    WITH incoming AS (
+        SELECT * FROM jsonb_to_recordset(p_reviews) AS r(
+            sequence BIGINT,
+            "cardId" UUID,
+            rating SMALLINT,
+            "reviewedAt" BIGINT,
+            stability DOUBLE PRECISION,
+            difficulty DOUBLE PRECISION,
+            "dueAt" BIGINT
+        )
+    ), inserted AS (
+        INSERT INTO public.review_log (
+            user_id, device_id, device_seq, card_id, rating, reviewed_at,
+            stability, difficulty, due_at
+        )
+        SELECT p_user_id, p_device_id, sequence, "cardId", rating,
+            to_timestamp("reviewedAt" / 1000.0), stability, difficulty, to_timestamp("dueAt" / 1000.0)
+        FROM incoming
+        ON CONFLICT ON CONSTRAINT review_log_device_seq DO NOTHING
+        RETURNING card_id, rating, reviewed_at, stability, difficulty, due_at
+    ), latest AS (
+        SELECT DISTINCT ON (card_id) *, COUNT(*) OVER (PARTITION BY card_id) AS review_count
+        FROM inserted
+        ORDER BY card_id, reviewed_at DESC
+    )
+    UPDATE public.cards c SET
+        fsrs_data = CASE
+            WHEN c.fsrs_data->>'lastReview' IS NULL
+                OR (c.fsrs_data->>'lastReview')::timestamptz <= l.reviewed_at
+            THEN c.fsrs_data || jsonb_build_object(
+                'stability', l.stability,
+                'difficulty', l.difficulty,
+                'lastRating', l.rating,
+                'lastReview', l.reviewed_at
+            )
+            ELSE c.fsrs_data
+        END || jsonb_build_object(
+            'reviewCount', COALESCE((c.fsrs_data->>'reviewCount')::INTEGER, 0) + l.review_count
+        ),
+        next_review = CASE
+            WHEN c.fsrs_data->>'lastReview' IS NULL
+                OR (c.fsrs_data->>'lastReview')::timestamptz <= l.reviewed_at
+            THEN l.due_at
+            ELSE c.next_review
+        END,
+        updated_at = now()
+    FROM latest l
+    WHERE c.user_id = p_user_id AND c.id = l.card_id;
+
+    SELECT COALESCE(MAX(device_seq), 0) INTO v_acknowledged
+    FROM public.review_log
+    WHERE user_id = p_user_id AND device_id = p_device_id;
+
+    RETURN v_acknowledged;
+END;
+$$ LANGUAGE plpgsql;
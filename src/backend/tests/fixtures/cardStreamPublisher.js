@@ -0,0 +1,31 @@
+/**
+ * @fileoverview Stands in for another cluster worker in card stream tests: publishes the
+ * card events given as JSON in argv through its own handler, then exits.
+ * Usage: node cardStreamPublisher.js <redis url> <user id> <events json>
+ * @version 1.0.0
+ */
+
+require('ts-node').register({ transpileOnly: true });
+const Redis = require('ioredis');
+const { CardStreamHandler } = require('../../src/websocket/handlers/cardStreamHandler');
+
+const [redisUrl, userId, events] = process.argv.slice(2);
+
+const main = async () => {
+  const client = new Redis(redisUrl);
+  const subscriber = client.duplicate();
+  const handler = new CardStreamHandler();
+  handler.connect(client, subscriber);
+
+  const reached = [];
+  for (const event of JSON.parse(events)) {
+    reached.push(await handler.publish(userId, event));
+  }
+  process.send?.({ reached });
+  await Promise.all([client.quit(), subscriber.quit()]);
+};
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
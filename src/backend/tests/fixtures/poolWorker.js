@@ -0,0 +1,18 @@
+/**
+ * @fileoverview Worker file for worker pool tests.
+ * Jest does not transform worker threads, so the pool helpers load through ts-node.
+ * @version 1.0.0
+ */
+
+require('ts-node').register({ transpileOnly: true });
+const { serveTasks } = require('../../src/core/workers/workerPool');
+
+serveTasks({
+  echo: (value) => value,
+  sum: (buffer) => new Uint8Array(buffer).reduce((total, byte) => total + byte, 0),
+  sleep: (ms) => new Promise((resolve) => setTimeout(() => resolve(ms), ms)),
+  fail: (message) => {
+    throw new Error(message);
+  },
+  crash: (code) => process.exit(code)
+});
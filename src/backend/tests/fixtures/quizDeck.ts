@@ -0,0 +1,85 @@
+/**
+ * @fileoverview Labeled deck for distractor quality checks.
+ * Cards span several topics and answer types; each card is labeled with its expected
+ * answer type, and `topic` doubles as the card's source so related cards can be told apart.
+ * @version 1.0.0
+ */
+
+import { AnswerType, DeckCard } from '../../src/core/cards/distractorIndex';
+
+export interface LabeledCard extends DeckCard {
+  topic: string;
+  expectedType: AnswerType;
+}
+
+const card = (topic: string, expectedType: AnswerType, front: string, back: string): Omit<LabeledCard, 'id'> => ({
+  topic,
+  expectedType,
+  front,
+  back,
+  contentId: `content-${topic}`,
+  tags: [topic]
+});
+
+const CARDS: Array<Omit<LabeledCard, 'id'>> = [
+  // Cell biology
+  card('cell', 'term', 'Which organelle produces most of the cell\'s ATP?', 'Mitochondria'),
+  card('cell', 'term', 'Which organelle synthesizes proteins?', 'Ribosome'),
+  card('cell', 'term', 'Which organelle modifies and packages proteins for secretion?', 'Golgi apparatus'),
+  card('cell', 'term', 'Which organelle contains digestive enzymes?', 'Lysosome'),
+  card('cell', 'term', 'Which organelle carries out photosynthesis?', 'Chloroplast'),
+  card('cell', 'term', 'Which organelle stores the cell\'s genetic material?', 'Nucleus'),
+  card('cell', 'term', 'What process divides a somatic cell into two identical cells?', 'Mitosis'),
+  card('cell', 'term', 'What process produces four haploid gametes?', 'Meiosis'),
+  card('cell', 'number', 'How many chromosomes does a human somatic cell have?', '46'),
+  // French Revolution
+  card('revolution', 'date', 'When was the Bastille stormed?', '14 July 1789'),
+  card('revolution', 'date', 'When was Louis XVI executed?', '21 January 1793'),
+  card('revolution', 'date', 'When did Napoleon crown himself Emperor?', '2 December 1804'),
+  card('revolution', 'date', 'When was the Tennis Court Oath taken?', '20 June 1789'),
+  card('revolution', 'name', 'Who led the Committee of Public Safety during the Terror?', 'Maximilien Robespierre'),
+  card('revolution', 'name', 'Who was the last queen of France before the Revolution?', 'Marie Antoinette'),
+  card('revolution', 'name', 'Who wrote "What Is the Third Estate?"', 'Emmanuel Joseph Sieyès'),
+  card('revolution', 'name', 'Who founded the newspaper L\'Ami du peuple?', 'Jean-Paul Marat'),
+  // Chemistry
+  card('chemistry', 'term', 'What is the chemical symbol for sodium?', 'Na'),
+  card('chemistry', 'term', 'What is the chemical symbol for potassium?', 'K'),
+  card('chemistry', 'term', 'What is the chemical symbol for iron?', 'Fe'),
+  card('chemistry', 'term', 'What is the chemical symbol for lead?', 'Pb'),
+  card('chemistry', 'number', 'How many protons does a carbon atom have?', '6'),
+  card('chemistry', 'number', 'How many protons does an oxygen atom have?', '8'),
+  card('chemistry', 'number', 'What is the pH of pure water at 25 °C?', '7'),
+  card('chemistry', 'term', 'What type of bond shares electron pairs between atoms?', 'Covalent bond'),
+  card('chemistry', 'term', 'What type of bond transfers electrons from one atom to another?', 'Ionic bond'),
+  // Computer science
+  card('algorithms', 'term', 'What is the average time complexity of binary search?', 'O(log n)'),
+  card('algorithms', 'term', 'What is the average time complexity of quicksort?', 'O(n log n)'),
+  card('algorithms', 'term', 'What is the time complexity of a linear scan?', 'O(n)'),
+  card('algorithms', 'term', 'What is the worst-case time complexity of bubble sort?', 'O(n^2)'),
+  card('algorithms', 'term', 'Which data structure serves elements first in, first out?', 'Queue'),
+  card('algorithms', 'term', 'Which data structure serves elements last in, first out?', 'Stack'),
+  card('algorithms', 'term', 'Which data structure maps keys to values through a hash function?', 'Hash table'),
+  card('algorithms', 'name', 'Who proposed the shortest path algorithm for graphs with non-negative weights?', 'Edsger Dijkstra'),
+  // Geography
+  card('geography', 'name', 'Where is the Louvre museum?', 'Paris'),
+  card('geography', 'name', 'Where is the Colosseum?', 'Rome'),
+  card('geography', 'name', 'Where is the Acropolis?', 'Athens'),
+  card('geography', 'name', 'Where is the Sagrada Família?', 'Barcelona'),
+  card('geography', 'number', 'How long is the Nile river?', '6,650 km'),
+  card('geography', 'number', 'How long is the Amazon river?', '6,400 km'),
+  card('geography', 'number', 'How high is Mount Everest?', '8,849 m'),
+  card('geography', 'name', 'What is the largest ocean on Earth?', 'Pacific Ocean'),
+  card('geography', 'name', 'What is the largest desert outside the polar regions?', 'Sahara Desert'),
+  // Physics
+  card('physics', 'phrase', 'What does Newton\'s first law state?',
+    'An object stays at rest or in uniform motion unless acted on by a net force.'),
+  card('physics', 'phrase', 'What does Newton\'s third law state?',
+    'Every action has an equal and opposite reaction.'),
+  card('physics', 'phrase', 'What does the first law of thermodynamics state?',
+    'Energy cannot be created or destroyed, only converted between forms.'),
+  card('physics', 'number', 'What is the speed of light in a vacuum?', '299,792 km/s'),
+  card('physics', 'date', 'In what year did Einstein publish special relativity?', '1905'),
+  card('physics', 'date', 'In what year did Newton publish the Principia?', '1687')
+];
+
+export const QUIZ_DECK: LabeledCard[] = CARDS.map((labeled, i) => ({ id: `card-${i + 1}`, ...labeled }));
@@ -0,0 +1,242 @@
+/**
+ * @fileoverview Integration tests for streamed card generation and live delivery
+ * Runs CardGenerator against a local mock of OpenAI's streaming endpoint and verifies
+ * cards are delivered before the completion finishes. Delivery across worker processes
+ * runs against Redis at REDIS_TEST_URL and is skipped without it.
+ * @version 1.0.0
+ */
+
+import path from 'path';
+import { fork } from 'child_process';
+import WebSocket from 'ws'; // ^8.x
+import Redis from 'ioredis'; // version: ^5.0.0
+import { ICard } from '../../src/interfaces/ICard';
+import { IContent, ContentStatus } from '../../src/interfaces/IContent';
+import { startMockOpenAIStreamServer, MockStreamCard, MockStreamServer } from '../utils/mockOpenAIStreamServer';
+import { CardStreamHandler, WS_CARD_EVENTS } from '../../src/websocket/handlers/cardStreamHandler';
+
+// The OpenAI config module validates credentials on import
+process.env.OPENAI_API_KEY = process.env.OPENAI_API_KEY || `sk-${'a'.repeat(40)}`;
+process.env.OPENAI_ORG_ID = process.env.OPENAI_ORG_ID || `org-${'b'.repeat(24)}`;
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { OpenAIClient } = require('../../src/config/openai');
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { CardGenerator } = require('../../src/core/ai/cardGenerator');
+
+const TEST_TIMEOUT = 15000;
+const REDIS_TEST_URL = process.env.REDIS_TEST_URL;
+const PUBLISHER_FILE = path.join(__dirname, '../fixtures/cardStreamPublisher.js');
+const CARD_DELAY_MS = 150;
+
+const STREAM_CARDS: MockStreamCard[] = Array.from({ length: 6 }, (_, i) => ({
+  front: `What is concept ${i + 1}?`,
+  back: `Concept ${i + 1} is explained here in enough detail to review it later.`
+}));
+
+const testContent: IContent = {
+  id: 'stream-content-1',
+  userId: 'stream-user-1',
+  content: 'Streaming test content long enough to pass validation.',
+  metadata: { contentType: 'text', language: 'en', tags: ['stream'] },
+  source: 'web',
+  sourceUrl: 'https://example.com',
+  status: ContentStatus.NEW,
+  createdAt: new Date(),
+  updatedAt: new Date(),
+  processedAt: null
+} as IContent;
+
+const mockRedis = () => ({
+  get: jest.fn().mockResolvedValue(null),
+  setex: jest.fn().mockResolvedValue('OK')
+}) as unknown as Redis;
+
+describe('Streamed card generation', () => {
+  let server: MockStreamServer;
+
+  afterEach(async () => {
+    await server?.close();
+  });
+
+  const generatorFor = (baseURL: string) =>
+    new CardGenerator(new OpenAIClient(process.env.OPENAI_API_KEY, undefined, baseURL), mockRedis());
+
+  test('delivers the first card long before the completion finishes', async () => {
+    server = await startMockOpenAIStreamServer({ cards: STREAM_CARDS, cardDelayMs: CARD_DELAY_MS });
+    const generator = generatorFor(server.baseURL);
+
+    const started = Date.now();
+    const arrivals: number[] = [];
+    const delivered: ICard[] = [];
+    const cards: ICard[] = await generator.generateFromContent(testContent, {
+      moderated: true,
+      onCard: (card: ICard) => {
+        arrivals.push(Date.now() - started);
+        delivered.push(card);
+      }
+    });
+    const total = Date.now() - started;
+
+    expect(cards.map((card) => card.frontContent.text)).toEqual(STREAM_CARDS.map((card) => card.front));
+    expect(delivered).toEqual(cards);
+    // About one card's worth of generation, not the whole completion
+    expect(arrivals[0]).toBeLessThan(CARD_DELAY_MS * 2);
+    expect(arrivals[0]).toBeLessThan(total / 2);
+    expect(generator.getMetrics().firstCardTime).toBe(arrivals[0]);
+    expect(generator.getMetrics().tokenCount).toBe(100 + STREAM_CARDS.length * 40);
+  }, TEST_TIMEOUT);
+
+  test('parses cards wrapped in a code fence', async () => {
+    server = await startMockOpenAIStreamServer({ cards: STREAM_CARDS.slice(0, 2), cardDelayMs: 5, preamble: '```json\n' });
+
+    const cards: ICard[] = await generatorFor(server.baseURL).generateFromContent(testContent, {
+      moderated: true,
+      onCard: () => undefined
+    });
+
+    expect(cards).toHaveLength(2);
+  }, TEST_TIMEOUT);
+
+  test('fails without retrying once cards were delivered from a truncated stream', async () => {
+    server = await startMockOpenAIStreamServer({ cards: STREAM_CARDS, cardDelayMs: 5, truncateAfter: 2 });
+    const delivered: ICard[] = [];
+
+    await expect(generatorFor(server.baseURL).generateFromContent(testContent, {
+      moderated: true,
+      onCard: (card: ICard) => delivered.push(card)
+    })).rejects.toThrow('Card stream ended');
+
+    expect(delivered).toHaveLength(2);
+    expect(server.requestCount()).toBe(1);
+  }, TEST_TIMEOUT);
+});
+
+const fakeSocket = (bufferedAmount = 0) => {
+  const listeners: Record<string, () => void> = {};
+  return {
+    readyState: WebSocket.OPEN,
+    bufferedAmount,
+    sent: [] as any[],
+    send(message: string) { this.sent.push(JSON.parse(message)); },
+    on(event: string, listener: () => void) { listeners[event] = listener; },
+    close() { listeners.close?.(); }
+  };
+};
+
+const waitFor = async (condition: () => boolean, timeoutMs = 5000) => {
+  const deadline = Date.now() + timeoutMs;
+  while (!condition() && Date.now() < deadline) {
+    await new Promise((resolve) => setTimeout(resolve, 20));
+  }
+};
+
+describe('CardStreamHandler', () => {
+  test('publishes to every open socket of the user only', async () => {
+    const handler = new CardStreamHandler();
+    const phone = fakeSocket();
+    const laptop = fakeSocket();
+    const otherUser = fakeSocket();
+    handler.handleConnection(phone as unknown as WebSocket, 'user-1');
+    handler.handleConnection(laptop as unknown as WebSocket, 'user-1');
+    handler.handleConnection(otherUser as unknown as WebSocket, 'user-2');
+
+    const delivered = await handler.publish('user-1', {
+      type: WS_CARD_EVENTS.CONTENT_PROCESSED,
+      contentId: 'c1',
+      generationId: 'g1',
+      cardCount: 3
+    });
+
+    expect(delivered).toBe(2);
+    expect(phone.sent.map((event) => event.type)).toEqual([WS_CARD_EVENTS.READY, WS_CARD_EVENTS.CONTENT_PROCESSED]);
+    expect(phone.sent[1].generationId).toBe('g1');
+    expect(otherUser.sent.map((event) => event.type)).toEqual([WS_CARD_EVENTS.READY]);
+  });
+
+  test('skips slow consumers and forgets closed sockets', async () => {
+    const handler = new CardStreamHandler();
+    const slow = fakeSocket(2 * 1024 * 1024);
+    const gone = fakeSocket();
+    handler.handleConnection(slow as unknown as WebSocket, 'user-1');
+    handler.handleConnection(gone as unknown as WebSocket, 'user-1');
+    gone.close();
+
+    await expect(handler.publish('user-1', {
+      type: WS_CARD_EVENTS.CONTENT_FAILED,
+      contentId: 'c1',
+      generationId: 'g1',
+      error: 'x'
+    })).resolves.toBe(0);
+    slow.close();
+    expect(handler.subscriberCount).toBe(0);
+  });
+});
+
+const describeWithRedis = REDIS_TEST_URL ? describe : describe.skip;
+
+describeWithRedis('CardStreamHandler across workers', () => {
+  let client: Redis;
+  let subscriber: Redis;
+
+  beforeEach(() => {
+    client = new Redis(REDIS_TEST_URL!);
+    subscriber = client.duplicate();
+  });
+
+  afterEach(async () => {
+    await Promise.all([client.quit(), subscriber.quit()]);
+  });
+
+  /**
+   * Publishes from a separate process, as a content job on another worker does
+   */
+  const publishFromOtherWorker = (userId: string, events: unknown[]) =>
+    new Promise<number[]>((resolve, reject) => {
+      let reached: number[] = [];
+      const child = fork(PUBLISHER_FILE, [REDIS_TEST_URL!, userId, JSON.stringify(events)]);
+      child.on('message', (message: { reached: number[] }) => { reached = message.reached; });
+      child.on('error', reject);
+      child.on('exit', (code) => code === 0 ? resolve(reached) : reject(new Error(`publisher exited with ${code}`)));
+    });
+
+  test('delivers events published by another worker to the sockets held here', async () => {
+    const handler = new CardStreamHandler();
+    handler.connect(client, subscriber);
+    const socket = fakeSocket();
+    const otherUser = fakeSocket();
+    handler.handleConnection(socket as unknown as WebSocket, 'worker-user-1');
+    handler.handleConnection(otherUser as unknown as WebSocket, 'worker-user-2');
+    await waitFor(() => socket.sent.length > 0 && otherUser.sent.length > 0);
+
+    const reached = await publishFromOtherWorker('worker-user-1', [
+      { type: WS_CARD_EVENTS.CARD_GENERATED, contentId: 'c1', generationId: 'g1', sequence: 0, card: STREAM_CARDS[0] },
+      { type: WS_CARD_EVENTS.CONTENT_PROCESSED, contentId: 'c1', generationId: 'g1', cardCount: 1 }
+    ]);
+    await waitFor(() => socket.sent.length === 3);
+
+    expect(reached).toEqual([1, 1]);
+    expect(socket.sent.map((event) => event.type)).toEqual([
+      WS_CARD_EVENTS.READY,
+      WS_CARD_EVENTS.CARD_GENERATED,
+      WS_CARD_EVENTS.CONTENT_PROCESSED
+    ]);
+    expect(socket.sent[1]).toMatchObject({ generationId: 'g1', sequence: 0 });
+    expect(otherUser.sent.map((event) => event.type)).toEqual([WS_CARD_EVENTS.READY]);
+  }, TEST_TIMEOUT);
+
+  test('stops listening once the user\'s last socket closes', async () => {
+    const handler = new CardStreamHandler();
+    handler.connect(client, subscriber);
+    const socket = fakeSocket();
+    handler.handleConnection(socket as unknown as WebSocket, 'worker-user-3');
+    await waitFor(() => socket.sent.length > 0);
+    socket.close();
+    await new Promise((resolve) => setTimeout(resolve, 50));
+
+    const reached = await publishFromOtherWorker('worker-user-3', [
+      { type: WS_CARD_EVENTS.CONTENT_FAILED, contentId: 'c2', generationId: 'g2', error: 'x' }
+    ]);
+
+    expect(reached).toEqual([0]);
+  }, TEST_TIMEOUT);
+});
@@ -0,0 +1,103 @@
+/**
+ * @fileoverview Integration tests for the concurrency limiter against a real Redis
+ * Runs the shipped acquire and feedback scripts, which the unit tests' in-memory client
+ * only emulates. Skipped unless REDIS_TEST_URL is set, e.g. to the cache service of
+ * docker-compose.yml.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { ConcurrencyLimiter, ConcurrencyLimiterOptions } from '../../src/utils/concurrencyLimiter';
+
+const REDIS_TEST_URL = process.env.REDIS_TEST_URL;
+const TEST_TIMEOUT = 15000;
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+const describeWithRedis = REDIS_TEST_URL ? describe : describe.skip;
+
+describeWithRedis('ConcurrencyLimiter with Redis', () => {
+  // Limiters of one run never share keys with another's
+  const run = `it-${Date.now()}`;
+  let tests = 0;
+  let name: string;
+  let clients: Redis[];
+
+  const worker = (options: ConcurrencyLimiterOptions = {}) => {
+    const client = new Redis(REDIS_TEST_URL!);
+    clients.push(client);
+    return new ConcurrencyLimiter(client, { name, pollMs: 10, initialLimit: 4, ...options });
+  };
+
+  beforeEach(() => {
+    name = `${run}:${tests++}`;
+    clients = [];
+  });
+
+  afterEach(async () => {
+    await Promise.all(clients.map((client) => client.quit()));
+  });
+
+  test('caps calls in flight across workers', async () => {
+    const workers = [worker(), worker(), worker()];
+    let inFlight = 0;
+    let peak = 0;
+
+    await Promise.all(Array.from({ length: 12 }, async (_, i) => {
+      const permit = await workers[i % 3].acquire('interactive');
+      inFlight++;
+      peak = Math.max(peak, inFlight);
+      await delay(20);
+      inFlight--;
+      await permit.release();
+    }));
+
+    expect(peak).toBe(4);
+    expect(workers.every((limiter) => limiter.getStats().bypassed === 0)).toBe(true);
+  }, TEST_TIMEOUT);
+
+  test('halves the limit once per congestion event and grows it back additively', async () => {
+    const a = worker({ decreaseCooldownMs: 1000 });
+    const b = worker({ decreaseCooldownMs: 1000 });
+
+    await (await a.acquire('batch')).throttle();
+    await (await b.acquire('batch')).throttle();
+    expect(b.getStats().limit).toBe(2);
+
+    await (await a.acquire('batch')).succeed();
+    await (await a.acquire('batch')).succeed();
+    expect(a.getStats().limit).toBeCloseTo(2.9, 5);
+  });
+
+  test('pauses every worker for the provider retry-after', async () => {
+    const a = worker();
+    const b = worker();
+
+    await (await a.acquire('batch')).throttle(150);
+    const started = Date.now();
+    await (await b.acquire('interactive')).release();
+
+    expect(Date.now() - started).toBeGreaterThanOrEqual(140);
+  });
+
+  test('keeps headroom for interactive calls', async () => {
+    const limiter = worker({ acquireTimeoutMs: 100 });
+    const batch = await Promise.all([1, 2, 3].map(() => limiter.acquire('batch')));
+
+    await expect(worker({ acquireTimeoutMs: 100 }).acquire('batch')).rejects.toThrow('Timed out');
+    const interactive = await worker().acquire('interactive');
+
+    await Promise.all([...batch, interactive].map((permit) => permit.release()));
+  });
+
+  test('reserves from the shared token budget and corrects it with actual usage', async () => {
+    const a = worker({ tokensPerMinute: 1000, acquireTimeoutMs: 100 });
+    const b = worker({ tokensPerMinute: 1000, acquireTimeoutMs: 100 });
+
+    const first = await a.acquire('batch', 600);
+    await expect(b.acquire('batch', 600)).rejects.toThrow('Timed out');
+
+    await first.succeed(300);
+    await (await b.acquire('batch', 600)).release();
+  });
+});
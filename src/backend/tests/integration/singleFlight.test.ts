@@ -0,0 +1,83 @@
+/**
+ * @fileoverview Integration tests for distributed single-flight against a real Redis
+ * Runs the shipped lease scripts, which the unit tests' in-memory client only emulates.
+ * Skipped unless REDIS_TEST_URL is set, e.g. to the cache service of docker-compose.yml.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { SingleFlight, RENEW_LEASE_SCRIPT, RELEASE_LEASE_SCRIPT } from '../../src/utils/singleFlight';
+
+const REDIS_TEST_URL = process.env.REDIS_TEST_URL;
+const WORKERS = 4;
+const TEST_TIMEOUT = 15000;
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+const describeWithRedis = REDIS_TEST_URL ? describe : describe.skip;
+
+describeWithRedis('SingleFlight with Redis', () => {
+  // Keys of one run never collide with another's
+  const run = `it-${Date.now()}`;
+  let clients: Redis[];
+  let workers: SingleFlight[];
+
+  beforeEach(() => {
+    clients = [];
+    workers = Array.from({ length: WORKERS }, () => {
+      const client = new Redis(REDIS_TEST_URL!);
+      const subscriber = client.duplicate();
+      clients.push(client, subscriber);
+      return new SingleFlight(client, subscriber, { leaseMs: 300 });
+    });
+  });
+
+  afterEach(async () => {
+    await Promise.all(clients.map((client) => client.quit()));
+  });
+
+  test('runs one computation across workers and releases the lease', async () => {
+    let computations = 0;
+    const compute = async () => {
+      computations++;
+      await delay(50);
+      return { value: 42 };
+    };
+
+    const results = await Promise.all(workers.map((worker) => worker.doCached(`${run}:answer`, 60, compute)));
+
+    expect(computations).toBe(1);
+    expect(results).toEqual(Array(WORKERS).fill({ value: 42 }));
+    expect(await clients[0].exists(`singleflight:lock:${run}:answer`)).toBe(0);
+  }, TEST_TIMEOUT);
+
+  test('renews the lease while a computation outlasts it', async () => {
+    let computations = 0;
+    const compute = async () => {
+      computations++;
+      await delay(1000);
+      return 'slow';
+    };
+
+    const results = await Promise.all(workers.map((worker) => worker.doCached(`${run}:slow`, 60, compute)));
+
+    expect(computations).toBe(1);
+    expect(results).toEqual(Array(WORKERS).fill('slow'));
+  }, TEST_TIMEOUT);
+
+  test('renews and releases only the lease it holds', async () => {
+    const [client] = clients;
+    const lockKey = `singleflight:lock:${run}:held`;
+    await client.set(lockKey, 'holder', 'PX', 1000);
+
+    expect(await client.eval(RENEW_LEASE_SCRIPT, 1, lockKey, 'other', 60000)).toBe(0);
+    expect(await client.pttl(lockKey)).toBeLessThanOrEqual(1000);
+    expect(await client.eval(RELEASE_LEASE_SCRIPT, 1, lockKey, 'other')).toBe(0);
+    expect(await client.get(lockKey)).toBe('holder');
+
+    expect(await client.eval(RENEW_LEASE_SCRIPT, 1, lockKey, 'holder', 60000)).toBe(1);
+    expect(await client.pttl(lockKey)).toBeGreaterThan(1000);
+    expect(await client.eval(RELEASE_LEASE_SCRIPT, 1, lockKey, 'holder')).toBe(1);
+    expect(await client.exists(lockKey)).toBe(0);
+  });
+});
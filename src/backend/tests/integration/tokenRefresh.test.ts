@@ -0,0 +1,100 @@
+/**
+ * @fileoverview Integration tests for the token refresh and logout routes
+ * Sends requests through the auth controller to the real token service and store, and
+ * verifies refresh token rotation, reuse detection and revocation on logout
+ * @version 1.0.0
+ */
+
+process.env.JWT_SECRET = process.env.JWT_SECRET || 'token-refresh-test-secret';
+
+import express from 'express'; // ^4.18.2
+import supertest from 'supertest'; // v6.3.3
+import { SupabaseClient } from '@supabase/supabase-js';
+import { AuthController } from '../../src/api/controllers/AuthController';
+import { AuthService } from '../../src/services/AuthService';
+import { RedisService } from '../../src/services/RedisService';
+import { TokenService } from '../../src/services/TokenService';
+import { IUser } from '../../src/interfaces/IUser';
+import { TokenStore } from '../../src/utils/tokenStore';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+import { TEST_USER_ID } from '../utils/testHelpers';
+
+jest.mock('../../src/config/supabase', () => ({ createSupabaseClient: jest.fn() }));
+jest.mock('winston', () => ({
+  createLogger: () => ({ info: jest.fn(), warn: jest.fn(), error: jest.fn() }),
+  format: { json: jest.fn() },
+  transports: { File: jest.fn() }
+}));
+
+const USER = { id: TEST_USER_ID, email: 'test@membo.ai', role: 'FREE_USER' } as unknown as IUser;
+
+/**
+ * App with the refresh and logout routes over an in-memory token store
+ */
+const setup = () => {
+  const tokenService = new TokenService(new TokenStore(new InMemoryRedisStore().client()));
+  const supabase = { auth: { signOut: jest.fn() } } as unknown as SupabaseClient;
+  const controller = new AuthController(new AuthService(supabase, tokenService, {} as RedisService));
+
+  const app = express();
+  app.use(express.json());
+  app.post('/api/v1/auth/refresh-token', controller.refreshToken);
+  app.post('/api/v1/auth/logout', controller.logout);
+
+  const refresh = (refreshToken: string) =>
+    supertest(app).post('/api/v1/auth/refresh-token').send({ refreshToken });
+  const logout = (accessToken: string, refreshToken: string) =>
+    supertest(app).post('/api/v1/auth/logout').set('Authorization', `Bearer ${accessToken}`).send({ refreshToken });
+  return { tokenService, refresh, logout };
+};
+
+/**
+ * Refresh token set by a response
+ */
+const refreshCookie = (response: supertest.Response): string => {
+  const cookies = ([] as string[]).concat(response.headers['set-cookie'] ?? []);
+  const cookie = cookies.find((value) => value.startsWith('refreshToken='));
+  return decodeURIComponent(cookie!.split(';')[0].slice('refreshToken='.length));
+};
+
+describe('POST /api/v1/auth/refresh-token', () => {
+  test('rotates the refresh token', async () => {
+    const { tokenService, refresh } = setup();
+    const { refreshToken } = await tokenService.generateTokenPair(USER);
+
+    const response = await refresh(refreshToken);
+
+    expect(response.status).toBe(200);
+    await expect(tokenService.verifyAccessToken(response.body.token)).resolves.toMatchObject({ userId: TEST_USER_ID });
+    const rotated = refreshCookie(response);
+    expect(rotated).not.toBe(refreshToken);
+    expect((await refresh(rotated)).status).toBe(200);
+  });
+
+  test('ends every session when a rotated refresh token is used again', async () => {
+    const { tokenService, refresh } = setup();
+    const { refreshToken } = await tokenService.generateTokenPair(USER);
+    const rotated = refreshCookie(await refresh(refreshToken));
+
+    expect((await refresh(refreshToken)).status).toBe(401);
+    expect((await refresh(rotated)).status).toBe(401);
+  });
+
+  test('requires a refresh token', async () => {
+    const { refresh } = setup();
+
+    expect((await refresh('')).status).toBe(401);
+  });
+});
+
+describe('POST /api/v1/auth/logout', () => {
+  test('revokes the access and refresh tokens', async () => {
+    const { tokenService, refresh, logout } = setup();
+    const { accessToken, refreshToken } = await tokenService.generateTokenPair(USER);
+
+    expect((await logout(accessToken, refreshToken)).status).toBe(200);
+
+    expect((await refresh(refreshToken)).status).toBe(401);
+    await expect(tokenService.verifyAccessToken(accessToken)).rejects.toThrow('revoked');
+  });
+});
@@ -0,0 +1,94 @@
+/**
+ * @fileoverview Integration tests for Redis token storage against a real Redis
+ * Runs the shipped storage, rotation and revocation scripts, which the unit tests'
+ * in-memory client only emulates. Skipped unless REDIS_TEST_URL is set, e.g. to the cache
+ * service of docker-compose.yml.
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis'; // version: ^5.0.0
+import { TokenStore } from '../../src/utils/tokenStore';
+
+const REDIS_TEST_URL = process.env.REDIS_TEST_URL;
+
+const inOneHour = () => Math.floor(Date.now() / 1000) + 3600;
+
+const describeWithRedis = REDIS_TEST_URL ? describe : describe.skip;
+
+describeWithRedis('TokenStore with Redis', () => {
+  // Users of one run never collide with another's
+  const run = `it-${Date.now()}`;
+  let tests = 0;
+  let userId: string;
+  let client: Redis;
+  let store: TokenStore;
+
+  beforeEach(() => {
+    userId = `${run}-${tests++}`;
+    client = new Redis(REDIS_TEST_URL!);
+    store = new TokenStore(client);
+  });
+
+  afterEach(async () => {
+    await store.revokeAll(userId);
+    await client.quit();
+  });
+
+  test('keeps refresh tokens until they expire', async () => {
+    await store.storeRefreshToken(userId, { jti: 'current', exp: inOneHour() });
+    await store.storeRefreshToken(userId, { jti: 'expired', exp: Math.floor(Date.now() / 1000) - 1 });
+
+    await expect(store.hasRefreshToken(userId, 'current')).resolves.toBe(true);
+    await expect(store.hasRefreshToken(userId, 'expired')).resolves.toBe(false);
+  });
+
+  test('rotates a refresh token once and rejects unknown ones', async () => {
+    await store.storeRefreshToken(userId, { jti: 'first', exp: inOneHour() });
+
+    await expect(store.rotateRefreshToken(userId, { jti: 'forged', exp: inOneHour() }, { jti: 'next', exp: inOneHour() }))
+      .resolves.toBe('invalid');
+    await expect(store.rotateRefreshToken(userId, { jti: 'first', exp: inOneHour() }, { jti: 'second', exp: inOneHour() }))
+      .resolves.toBe('rotated');
+
+    await expect(store.hasRefreshToken(userId, 'first')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(userId, 'second')).resolves.toBe(true);
+    await expect(store.isRevoked(userId, 'first')).resolves.toBe(true);
+  });
+
+  test('ends every session when a rotated token is used again', async () => {
+    await store.storeRefreshToken(userId, { jti: 'first', exp: inOneHour() });
+    await store.storeRefreshToken(userId, { jti: 'other-device', exp: inOneHour() });
+    await store.rotateRefreshToken(userId, { jti: 'first', exp: inOneHour() }, { jti: 'second', exp: inOneHour() });
+
+    await expect(store.rotateRefreshToken(userId, { jti: 'first', exp: inOneHour() }, { jti: 'third', exp: inOneHour() }))
+      .resolves.toBe('reused');
+
+    await expect(store.hasRefreshToken(userId, 'second')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(userId, 'other-device')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(userId, 'third')).resolves.toBe(false);
+  });
+
+  test('lets one of two concurrent rotations of a token win', async () => {
+    await store.storeRefreshToken(userId, { jti: 'first', exp: inOneHour() });
+    const otherClient = client.duplicate();
+    const other = new TokenStore(otherClient);
+
+    const results = await Promise.all([
+      store.rotateRefreshToken(userId, { jti: 'first', exp: inOneHour() }, { jti: 'a', exp: inOneHour() }),
+      other.rotateRefreshToken(userId, { jti: 'first', exp: inOneHour() }, { jti: 'b', exp: inOneHour() })
+    ]);
+    await otherClient.quit();
+
+    expect(results.sort()).toEqual(['reused', 'rotated']);
+  });
+
+  test('logout drops the refresh token and revokes the access token', async () => {
+    await store.storeRefreshToken(userId, { jti: 'refresh', exp: inOneHour() });
+
+    await store.revoke(userId, { jti: 'access', exp: inOneHour() }, 'refresh');
+
+    await expect(store.hasRefreshToken(userId, 'refresh')).resolves.toBe(false);
+    await expect(store.isRevoked(userId, 'access')).resolves.toBe(true);
+    await expect(store.isRevoked(userId, 'refresh')).resolves.toBe(false);
+  });
+});
@@ -0,0 +1,100 @@
+/**
+ * @fileoverview Unit tests for the asynchronous hot-path logger
+ * Verifies level gating before field construction, per-event sampling, guaranteed error
+ * capture, child bindings and redaction
+ * @version 1.0.0
+ */
+
+import { createAsyncLogger, LogLevel, SampleRates } from '../../src/config/asyncLogger';
+
+const capture = (level: LogLevel = 'info', sampling: SampleRates = {}) => {
+  const entries: Array<Record<string, any>> = [];
+  const logger = createAsyncLogger({
+    level,
+    sampling,
+    destination: { write: (line: string) => entries.push(JSON.parse(line)) }
+  });
+  return { logger, entries };
+};
+
+describe('AsyncLogger', () => {
+  test('writes structured entries with the event as message', () => {
+    const { logger, entries } = capture();
+
+    logger.info('Study session started', { sessionId: 's1' });
+
+    expect(entries).toHaveLength(1);
+    expect(entries[0]).toMatchObject({ level: 'info', msg: 'Study session started', sessionId: 's1', service: 'membo.ai' });
+    expect(typeof entries[0].time).toBe('string');
+  });
+
+  test('does not build fields for disabled levels', () => {
+    const { logger, entries } = capture('info');
+    const fields = jest.fn(() => ({ sessionId: 's1' }));
+
+    logger.debug('Study message handled', fields);
+
+    expect(fields).not.toHaveBeenCalled();
+    expect(entries).toHaveLength(0);
+    expect(logger.isEnabled('debug')).toBe(false);
+    expect(logger.isEnabled('warn')).toBe(true);
+  });
+
+  test('builds lazy fields once for enabled levels', () => {
+    const { logger, entries } = capture('debug');
+    const fields = jest.fn(() => ({ sessionId: 's1' }));
+
+    logger.debug('Study message handled', fields);
+
+    expect(fields).toHaveBeenCalledTimes(1);
+    expect(entries[0]).toMatchObject({ level: 'debug', sessionId: 's1' });
+  });
+
+  test('keeps one entry in N for sampled events, starting with the first', () => {
+    const { logger, entries } = capture('info', { 'High latency': 10 });
+    const fields = jest.fn((index: number) => ({ index }));
+
+    for (let index = 0; index < 25; index++) {
+      logger.warn('High latency', () => fields(index));
+      logger.info('Unsampled');
+    }
+
+    const sampled = entries.filter((entry) => entry.msg === 'High latency');
+    expect(sampled.map((entry) => entry.index)).toEqual([0, 10, 20]);
+    expect(sampled.every((entry) => entry.sampleRate === 10)).toBe(true);
+    expect(fields).toHaveBeenCalledTimes(3);
+    expect(entries.filter((entry) => entry.msg === 'Unsampled')).toHaveLength(25);
+  });
+
+  test('never samples errors', () => {
+    const { logger, entries } = capture('info', { 'Study session error': 100 });
+
+    for (let index = 0; index < 5; index++) {
+      logger.error('Study session error', { err: new Error(`failure ${index}`) });
+    }
+
+    expect(entries).toHaveLength(5);
+    expect(entries[4].err).toMatchObject({ type: 'Error', message: 'failure 4' });
+    expect(entries[4].sampleRate).toBeUndefined();
+  });
+
+  test('children add bindings and sample independently', () => {
+    const { logger, entries } = capture();
+    const child = logger.child({ component: 'VoiceHandler' }, { 'Voice message received': 2 });
+
+    child.info('Voice message received');
+    child.info('Voice message received');
+    logger.info('Voice message received');
+
+    expect(entries.map((entry) => entry.component)).toEqual(['VoiceHandler', undefined]);
+  });
+
+  test('redacts credentials', () => {
+    const { logger, entries } = capture();
+
+    logger.info('Login', { token: 'secret', user: { password: 'hunter2' } });
+
+    expect(entries[0].token).toBe('[Redacted]');
+    expect(entries[0].user.password).toBe('[Redacted]');
+  });
+});
@@ -0,0 +1,110 @@
+/**
+ * @fileoverview Unit tests for request-scoped batch loading
+ * Verifies same-tick coalescing, per-scope memoization, priming, failure handling
+ * and scope isolation
+ * @version 1.0.0
+ */
+
+import { BatchLoader, runInLoaderScope, scopedLoader } from '../../src/utils/batchLoader';
+
+const rowsLoader = (options = {}) => {
+  const batches: string[][] = [];
+  const loader = new BatchLoader<string, { id: string }>(async (ids) => {
+    batches.push(ids);
+    return new Map(ids.filter((id) => id !== 'missing').map((id) => [id, { id }]));
+  }, options);
+  return { loader, batches };
+};
+
+describe('BatchLoader', () => {
+  test('coalesces loads issued in the same tick into one batch', async () => {
+    const { loader, batches } = rowsLoader();
+
+    const rows = await Promise.all(['a', 'b', 'c'].map((id) => loader.load(id)));
+
+    expect(rows).toEqual([{ id: 'a' }, { id: 'b' }, { id: 'c' }]);
+    expect(batches).toEqual([['a', 'b', 'c']]);
+  });
+
+  test('joins loads issued after awaiting settled promises', async () => {
+    const { loader, batches } = rowsLoader();
+
+    await Promise.all(['a', 'b'].map(async (id) => {
+      await Promise.resolve();
+      return loader.load(id);
+    }));
+
+    expect(batches).toEqual([['a', 'b']]);
+  });
+
+  test('serves repeated keys from the memo', async () => {
+    const { loader, batches } = rowsLoader();
+
+    await loader.loadMany(['a', 'a', 'b']);
+    await loader.load('a');
+
+    expect(batches).toEqual([['a', 'b']]);
+    expect(loader.getStats()).toEqual({ loads: 4, memoHits: 2, batches: 1 });
+  });
+
+  test('resolves keys missing from the batch as null', async () => {
+    const { loader } = rowsLoader();
+
+    await expect(loader.loadMany(['a', 'missing'])).resolves.toEqual([{ id: 'a' }, null]);
+  });
+
+  test('splits large batches', async () => {
+    const { loader, batches } = rowsLoader({ maxBatchSize: 2 });
+
+    await loader.loadMany(['a', 'b', 'c']);
+
+    expect(batches).toEqual([['a', 'b'], ['c']]);
+  });
+
+  test('primes and clears keys', async () => {
+    const { loader, batches } = rowsLoader();
+
+    loader.prime('a', { id: 'a' });
+    await loader.load('a');
+    expect(batches).toEqual([]);
+
+    loader.clear('a');
+    await loader.load('a');
+    expect(batches).toEqual([['a']]);
+  });
+
+  test('rejects the whole batch on failure and retries on the next load', async () => {
+    let fail = true;
+    const loader = new BatchLoader<string, string>(async (ids) => {
+      if (fail) throw new Error('connection reset');
+      return new Map(ids.map((id) => [id, id]));
+    });
+
+    await expect(Promise.all([loader.load('a'), loader.load('b')])).rejects.toThrow('connection reset');
+
+    fail = false;
+    await expect(loader.load('a')).resolves.toBe('a');
+  });
+});
+
+describe('scopedLoader', () => {
+  const create = () => new BatchLoader<string, string>(async (ids) => new Map(ids.map((id) => [id, id])));
+
+  test('returns null outside a scope', () => {
+    expect(scopedLoader('cards', create)).toBeNull();
+  });
+
+  test('shares one loader per name within a scope, and none across scopes', async () => {
+    const first = await runInLoaderScope(async () => {
+      const loader = scopedLoader('cards', create);
+      await Promise.resolve();
+      expect(scopedLoader('cards', create)).toBe(loader);
+      expect(scopedLoader('contents', create)).not.toBe(loader);
+      return loader;
+    });
+    const second = runInLoaderScope(() => scopedLoader('cards', create));
+
+    expect(first).not.toBeNull();
+    expect(second).not.toBe(first);
+  });
+});
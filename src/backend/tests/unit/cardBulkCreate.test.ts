@@ -0,0 +1,104 @@
+/**
+ * @fileoverview Unit tests for bulk card creation
+ * Verifies up-front validation, chunked multi-row inserts and input-order results
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { ContentType, ICard } from '../../src/interfaces/ICard';
+import { Card } from '../../src/models/Card';
+import { runInLoaderScope } from '../../src/utils/batchLoader';
+import { TEST_USER_ID } from '../utils/testHelpers';
+
+jest.mock('../../src/config/services', () => ({ getServices: jest.fn() }));
+jest.mock('../../src/config/logger', () => ({ logger: { warn: jest.fn() } }));
+jest.mock('../../src/core/monitoring/PerformanceMonitor', () => ({
+  performanceMonitor: { trackReplicaLag: jest.fn(), recordReadRoute: jest.fn() }
+}));
+
+/**
+ * Records each insert and returns the inserted rows, last chunk first within a
+ * chunk to show results are not taken in response order
+ */
+const recordingClient = (failOnInsert?: number) => {
+  const inserts: ICard[][] = [];
+  const selects: string[][] = [];
+  const channel: any = { on: () => channel, subscribe: () => ({ unsubscribe: jest.fn() }) };
+  const from = () => {
+    const builder: any = {
+      insert: (rows: ICard[]) => {
+        inserts.push(rows);
+        const failed = inserts.length === failOnInsert;
+        return {
+          select: async () => failed
+            ? { data: null, error: { message: 'connection reset' } }
+            : { data: [...rows].reverse().map((row) => ({ ...row })), error: null }
+        };
+      },
+      select: () => builder,
+      in: async (column: string, ids: string[]) => {
+        selects.push(ids);
+        return { data: [], error: null };
+      }
+    };
+    return builder;
+  };
+  return { client: { from, channel: () => channel } as unknown as SupabaseClient, inserts, selects };
+};
+
+const cardData = (i: number): Partial<ICard> => ({
+  userId: TEST_USER_ID,
+  frontContent: { text: `Question ${i}`, type: ContentType.TEXT, metadata: {} as ICard['frontContent']['metadata'] },
+  backContent: { text: `Answer ${i}`, type: ContentType.TEXT, metadata: {} as ICard['backContent']['metadata'] }
+});
+
+describe('Card.createMany', () => {
+  test('inserts in chunks and returns cards in input order', async () => {
+    const { client, inserts } = recordingClient();
+    const model = new Card(client);
+
+    const cards = await model.createMany(Array.from({ length: 1200 }, (_, i) => cardData(i)));
+
+    expect(inserts.map((rows) => rows.length)).toEqual([500, 500, 200]);
+    expect(cards.map((card) => card.frontContent.text)).toEqual(
+      Array.from({ length: 1200 }, (_, i) => `Question ${i}`)
+    );
+    expect(new Set(cards.map((card) => card.id)).size).toBe(1200);
+  });
+
+  test('validates every card before inserting any', async () => {
+    const { client, inserts } = recordingClient();
+    const model = new Card(client);
+    const invalid = { ...cardData(1), backContent: undefined };
+
+    await expect(model.createMany([cardData(0), invalid])).rejects.toThrow('Missing required card data fields');
+    expect(inserts).toEqual([]);
+  });
+
+  test('stops at the first failed chunk', async () => {
+    const { client, inserts } = recordingClient(2);
+    const model = new Card(client);
+
+    await expect(model.createMany(Array.from({ length: 1200 }, (_, i) => cardData(i))))
+      .rejects.toThrow('Failed to create cards: connection reset');
+    expect(inserts).toHaveLength(2);
+  });
+
+  test('makes no query for an empty batch', async () => {
+    const { client, inserts } = recordingClient();
+
+    await expect(new Card(client).createMany([])).resolves.toEqual([]);
+    expect(inserts).toEqual([]);
+  });
+
+  test('primes the request loader with created cards', async () => {
+    const { client, selects } = recordingClient();
+    const model = new Card(client);
+
+    await runInLoaderScope(async () => {
+      const [card] = await model.createMany([cardData(0)]);
+      await expect(model.findById(card.id)).resolves.toEqual(card);
+    });
+    expect(selects).toEqual([]);
+  });
+});
@@ -0,0 +1,129 @@
+/**
+ * @fileoverview Unit tests for deduplicated card creation and editing
+ * Verifies near-duplicates are merged across batches persisted concurrently, as the
+ * chunks of one captured document are on one worker or several, and that only kept
+ * cards are inserted
+ * @version 1.0.0
+ */
+
+import { ContentType, ICard } from '../../src/interfaces/ICard';
+import { TEST_USER_ID } from '../utils/testHelpers';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+
+// Each service gets an empty Redis of its own, unless a test shares one between workers
+let mockSharedStore: InMemoryRedisStore | null = null;
+jest.mock('ioredis', () => jest.fn(() => {
+  const { InMemoryRedisStore: Store } = jest.requireActual('../utils/inMemoryRedis');
+  return (mockSharedStore ?? new Store()).client();
+}));
+jest.mock('../../src/config/openai', () => ({ openai: {} }));
+jest.mock('../../src/core/ai/cardGenerator', () => ({ CardGenerator: jest.fn() }));
+jest.mock('../../src/models/Card', () => ({ Card: jest.fn(() => mockCardModel) }));
+
+/**
+ * Card model that stores created cards in memory and records each batch insert
+ */
+const mockCardModel = {
+  inserts: [] as Partial<ICard>[][],
+  stored: new Map<string, ICard>(),
+  async createMany(cardsData: Partial<ICard>[]): Promise<ICard[]> {
+    mockCardModel.inserts.push(cardsData);
+    // Yields like a database round trip, so concurrent batches interleave
+    await new Promise((resolve) => setTimeout(resolve, 10));
+    return cardsData.map((cardData) => {
+      const card = { ...cardData, id: `card-${mockCardModel.stored.size + 1}` } as ICard;
+      mockCardModel.stored.set(card.id, card);
+      return card;
+    });
+  },
+  async findByIds(ids: string[]): Promise<Map<string, ICard>> {
+    return new Map(ids.filter((id) => mockCardModel.stored.has(id)).map((id) => [id, mockCardModel.stored.get(id)!]));
+  },
+  async findById(id: string): Promise<ICard> {
+    return mockCardModel.stored.get(id)!;
+  },
+  async update(id: string, updates: Partial<ICard>): Promise<ICard> {
+    const card = { ...mockCardModel.stored.get(id)!, ...updates };
+    mockCardModel.stored.set(id, card);
+    return card;
+  }
+};
+
+import { CardService } from '../../src/services/CardService';
+
+const card = (front: string, back: string): Partial<ICard> => ({
+  userId: TEST_USER_ID,
+  frontContent: { text: front, type: ContentType.TEXT, metadata: {} as ICard['frontContent']['metadata'] },
+  backContent: { text: back, type: ContentType.TEXT, metadata: {} as ICard['backContent']['metadata'] }
+});
+
+const CHLOROPHYLL = card(
+  'What is the primary function of chlorophyll in photosynthesis?',
+  'Chlorophyll absorbs light energy, mainly blue and red wavelengths, to drive photosynthesis.'
+);
+// The same card generated again from the overlap of the next chunk
+const CHLOROPHYLL_AGAIN = card(
+  'What is the primary function of chlorophyll in photosynthesis',
+  'Chlorophyll absorbs light energy (mainly blue and red wavelengths) to drive photosynthesis!'
+);
+const MITOCHONDRIA = card(
+  'Which organelle produces most of the cell\'s ATP?',
+  'The mitochondrion, through oxidative phosphorylation.'
+);
+
+describe('CardService.createCards', () => {
+  beforeEach(() => {
+    mockCardModel.inserts = [];
+    mockCardModel.stored.clear();
+    mockSharedStore = null;
+  });
+
+  test('merges near-duplicates from overlapping chunks persisted concurrently', async () => {
+    const service = new CardService();
+
+    const [first, second] = await Promise.all([
+      service.createCards([CHLOROPHYLL]),
+      service.createCards([CHLOROPHYLL_AGAIN, MITOCHONDRIA])
+    ]);
+
+    expect(mockCardModel.inserts.map((batch) => batch.length)).toEqual([1, 1]);
+    expect(second[0]).toBe(first[0]);
+    expect(second[1].frontContent.text).toBe(MITOCHONDRIA.frontContent!.text);
+  });
+
+  test('merges near-duplicates persisted concurrently by different workers', async () => {
+    mockSharedStore = new InMemoryRedisStore();
+    const workers = [new CardService(), new CardService()];
+
+    const [first, second] = await Promise.all([
+      workers[0].createCards([CHLOROPHYLL]),
+      workers[1].createCards([CHLOROPHYLL_AGAIN, MITOCHONDRIA])
+    ]);
+
+    expect(mockCardModel.inserts.map((batch) => batch.length)).toEqual([1, 1]);
+    expect(second[0]).toBe(first[0]);
+  });
+
+  test('merges duplicates within a batch into one multi-row insert', async () => {
+    const service = new CardService();
+
+    const cards = await service.createCards([CHLOROPHYLL, MITOCHONDRIA, CHLOROPHYLL_AGAIN]);
+
+    expect(mockCardModel.inserts).toHaveLength(1);
+    expect(mockCardModel.inserts[0]).toHaveLength(2);
+    expect(cards[2]).toBe(cards[0]);
+  });
+});
+
+describe('CardService.updateCard', () => {
+  test('compares new cards against the edited text', async () => {
+    const service = new CardService();
+    const [stored] = await service.createCards([CHLOROPHYLL]);
+
+    await service.updateCard(stored.id, { frontContent: MITOCHONDRIA.frontContent, backContent: MITOCHONDRIA.backContent });
+    const [chlorophyll, mitochondria] = await service.createCards([CHLOROPHYLL_AGAIN, MITOCHONDRIA]);
+
+    expect(chlorophyll.id).not.toBe(stored.id);
+    expect(mitochondria.id).toBe(stored.id);
+  });
+});
@@ -0,0 +1,133 @@
+/**
+ * @fileoverview Unit tests for per-user realtime card fan-out
+ * Verifies channel sharing, change routing, reference counting and the channel and
+ * memory cost of watching 10k cards
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { CardChange, CardRealtimeHub } from '../../src/core/cards/cardRealtimeHub';
+import { TEST_USER_ID } from '../utils/testHelpers';
+
+/**
+ * Records opened channels and lets tests push changes through them
+ */
+const realtimeClient = () => {
+  const channels = new Map<string, { filter: string; handler: (change: CardChange) => void }>();
+  const removed: string[] = [];
+  const client = {
+    channel: (name: string) => {
+      const channel: any = {
+        name,
+        on: (type: string, options: { filter: string }, handler: (change: CardChange) => void) => {
+          channels.set(name, { filter: options.filter, handler });
+          return channel;
+        },
+        subscribe: () => channel
+      };
+      return channel;
+    },
+    removeChannel: jest.fn(async (channel: { name: string }) => {
+      channels.delete(channel.name);
+      removed.push(channel.name);
+      return 'ok';
+    })
+  };
+  const emit = (userId: string, id: string, eventType: 'UPDATE' | 'DELETE' = 'UPDATE') => {
+    const change = eventType === 'DELETE'
+      ? { eventType, new: {}, old: { id } }
+      : { eventType, new: { id, userId }, old: {} };
+    channels.get(`cards-${userId}`)?.handler(change as unknown as CardChange);
+  };
+  return { client: client as unknown as SupabaseClient, channels, removed, emit };
+};
+
+describe('CardRealtimeHub', () => {
+  test('shares one channel per user, filtered to their cards', () => {
+    const { client, channels } = realtimeClient();
+    const hub = new CardRealtimeHub(client);
+
+    hub.subscribe(TEST_USER_ID, 'card-1', jest.fn());
+    hub.subscribe(TEST_USER_ID, 'card-2', jest.fn());
+    hub.subscribe('other-user', 'card-3', jest.fn());
+
+    expect([...channels.keys()]).toEqual([`cards-${TEST_USER_ID}`, 'cards-other-user']);
+    expect(channels.get(`cards-${TEST_USER_ID}`)!.filter).toBe(`user_id=eq.${TEST_USER_ID}`);
+    expect(hub.getStats()).toEqual({ channels: 2, cards: 3, listeners: 3 });
+  });
+
+  test('routes each change to the changed card\'s listeners only', () => {
+    const { client, emit } = realtimeClient();
+    const hub = new CardRealtimeHub(client);
+    const first = jest.fn();
+    const second = jest.fn();
+    const other = jest.fn();
+    hub.subscribe(TEST_USER_ID, 'card-1', first);
+    hub.subscribe(TEST_USER_ID, 'card-1', second);
+    hub.subscribe(TEST_USER_ID, 'card-2', other);
+
+    emit(TEST_USER_ID, 'card-1');
+    emit(TEST_USER_ID, 'card-2', 'DELETE');
+    emit(TEST_USER_ID, 'card-9');
+
+    expect(first).toHaveBeenCalledTimes(1);
+    expect(second).toHaveBeenCalledTimes(1);
+    expect(other).toHaveBeenCalledTimes(1);
+    expect(other.mock.calls[0][0].eventType).toBe('DELETE');
+  });
+
+  test('removes the channel when the last listener is released', async () => {
+    const { client, removed } = realtimeClient();
+    const hub = new CardRealtimeHub(client);
+    const releaseFirst = hub.subscribe(TEST_USER_ID, 'card-1', jest.fn());
+    const releaseSecond = hub.subscribe(TEST_USER_ID, 'card-2', jest.fn());
+
+    await releaseFirst();
+    await releaseFirst();
+    expect(removed).toEqual([]);
+    expect(hub.getStats()).toEqual({ channels: 1, cards: 1, listeners: 1 });
+
+    await releaseSecond();
+    expect(removed).toEqual([`cards-${TEST_USER_ID}`]);
+    expect(hub.getStats()).toEqual({ channels: 0, cards: 0, listeners: 0 });
+  });
+
+  test('lets a listener release itself while handling a change', async () => {
+    const { client, emit, removed } = realtimeClient();
+    const hub = new CardRealtimeHub(client);
+    const release = hub.subscribe(TEST_USER_ID, 'card-1', () => { release(); });
+
+    emit(TEST_USER_ID, 'card-1');
+    await Promise.resolve();
+
+    expect(removed).toEqual([`cards-${TEST_USER_ID}`]);
+  });
+
+  test('watches 10k cards over one channel', async () => {
+    const { client, channels, emit } = realtimeClient();
+    const hub = new CardRealtimeHub(client);
+    const listener = jest.fn();
+
+    const heapBefore = process.memoryUsage().heapUsed;
+    const releases = Array.from({ length: 10000 }, (_, i) => hub.subscribe(TEST_USER_ID, `card-${i}`, listener));
+    const bytesPerCard = (process.memoryUsage().heapUsed - heapBefore) / releases.length;
+
+    expect(channels.size).toBe(1);
+    expect(hub.getStats()).toEqual({ channels: 1, cards: 10000, listeners: 10000 });
+    // Each card costs a listener entry rather than a channel with its own bindings and buffers
+    expect(bytesPerCard).toBeLessThan(1024);
+
+    emit(TEST_USER_ID, 'card-5000');
+    expect(listener).toHaveBeenCalledTimes(1);
+
+    await Promise.all(releases.map((release) => release()));
+    expect(channels.size).toBe(0);
+  });
+
+  test('is shared per client', () => {
+    const { client } = realtimeClient();
+
+    expect(CardRealtimeHub.forClient(client)).toBe(CardRealtimeHub.forClient(client));
+    expect(CardRealtimeHub.forClient(realtimeClient().client)).not.toBe(CardRealtimeHub.forClient(client));
+  });
+});
@@ -0,0 +1,110 @@
+/**
+ * @fileoverview Unit tests for the cluster-wide adaptive concurrency limiter
+ * Uses limiters on separate in-memory Redis clients sharing one store to stand in for workers
+ * @version 1.0.0
+ */
+
+import { ConcurrencyLimiter, ConcurrencyLimiterOptions } from '../../src/utils/concurrencyLimiter';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+describe('ConcurrencyLimiter', () => {
+  let store: InMemoryRedisStore;
+  const worker = (options: ConcurrencyLimiterOptions = {}) =>
+    new ConcurrencyLimiter(store.client(), { pollMs: 10, initialLimit: 4, ...options });
+
+  beforeEach(() => {
+    store = new InMemoryRedisStore();
+  });
+
+  test('caps calls in flight across workers', async () => {
+    const workers = [worker(), worker()];
+    let inFlight = 0;
+    let peak = 0;
+
+    await Promise.all(Array.from({ length: 12 }, async (_, i) => {
+      const permit = await workers[i % 2].acquire('interactive');
+      inFlight++;
+      peak = Math.max(peak, inFlight);
+      await delay(20);
+      inFlight--;
+      await permit.release();
+    }));
+
+    expect(peak).toBe(4);
+  });
+
+  test('halves the limit once per congestion event and grows it back additively', async () => {
+    const a = worker({ decreaseCooldownMs: 1000 });
+    const b = worker({ decreaseCooldownMs: 1000 });
+
+    await (await a.acquire('batch')).throttle();
+    await (await b.acquire('batch')).throttle();
+    expect(b.getStats().limit).toBe(2);
+
+    // +1/limit per success: one slot per full window of successes
+    await (await a.acquire('batch')).succeed();
+    await (await a.acquire('batch')).succeed();
+    expect(a.getStats().limit).toBeCloseTo(2.9, 5);
+  });
+
+  test('pauses every worker for the provider retry-after', async () => {
+    const a = worker();
+    const b = worker();
+
+    await (await a.acquire('batch')).throttle(150);
+    const started = Date.now();
+    await (await b.acquire('interactive')).release();
+
+    expect(Date.now() - started).toBeGreaterThanOrEqual(140);
+  });
+
+  test('keeps headroom for interactive calls and serves them first', async () => {
+    const limiter = worker({ acquireTimeoutMs: 100 });
+    const batch = await Promise.all([1, 2, 3].map(() => limiter.acquire('batch')));
+
+    // Batch work may hold 3 of 4 slots; the last one is left for interactive callers
+    await expect(limiter.acquire('batch')).rejects.toThrow('Timed out');
+    const interactive = await limiter.acquire('interactive');
+
+    const order: string[] = [];
+    const waitingBatch = worker().acquire('batch').then((permit) => {
+      order.push('batch');
+      return permit;
+    });
+    const waitingInteractive = worker().acquire('interactive').then((permit) => {
+      order.push('interactive');
+      return permit;
+    });
+    await delay(30);
+    await interactive.release();
+    await Promise.all([batch[0].release(), batch[1].release()]);
+
+    const permits = await Promise.all([waitingBatch, waitingInteractive, batch[2]]);
+    expect(order).toEqual(['interactive', 'batch']);
+    await Promise.all(permits.map((permit) => permit.release()));
+  });
+
+  test('reserves from the shared token budget and corrects it with actual usage', async () => {
+    const a = worker({ tokensPerMinute: 1000, acquireTimeoutMs: 100 });
+    const b = worker({ tokensPerMinute: 1000, acquireTimeoutMs: 100 });
+
+    const first = await a.acquire('batch', 600);
+    await expect(b.acquire('batch', 600)).rejects.toThrow('Timed out');
+
+    await first.succeed(300);
+    await (await b.acquire('batch', 600)).release();
+  });
+
+  test('lets calls through unlimited while Redis hangs', async () => {
+    const client = store.client();
+    client.eval = () => new Promise(() => undefined);
+    const limiter = new ConcurrencyLimiter(client, { redisTimeoutMs: 20 });
+
+    const permit = await limiter.acquire('interactive');
+    await permit.succeed();
+
+    expect(limiter.getStats().bypassed).toBe(1);
+  });
+});
@@ -0,0 +1,91 @@
+/**
+ * @fileoverview Unit tests for deck-local quiz distractors
+ * Checks answer typing and distractor quality against the labeled fixture deck
+ * @version 1.0.0
+ */
+
+import { answerText, classifyAnswer, DistractorIndex } from '../../src/core/cards/distractorIndex';
+import { LabeledCard, QUIZ_DECK } from '../fixtures/quizDeck';
+
+const normalize = (text: string) => text.toLowerCase().replace(/[^a-z0-9]+/g, ' ').trim();
+
+describe('answer typing', () => {
+  test('types every fixture answer as labeled', () => {
+    const mistyped = QUIZ_DECK
+      .filter((card) => classifyAnswer(card.front, answerText(card.back) as string) !== card.expectedType)
+      .map((card) => card.back);
+
+    expect(mistyped).toEqual([]);
+  });
+
+  test('uses the question to tell years from counts', () => {
+    expect(classifyAnswer('In what year did the Berlin Wall fall?', '1989')).toBe('date');
+    expect(classifyAnswer('How many bones are in the adult human body?', '1206')).toBe('number');
+    expect(classifyAnswer('When was Rome founded?', '753 BC')).toBe('date');
+  });
+
+  test('reduces long backs to their first sentence', () => {
+    expect(answerText('# Answer\n**Mitochondria**.')).toBe('Mitochondria');
+    expect(answerText('Ribosomes. They read messenger RNA and assemble amino acids into chains, in the cytoplasm ' +
+      'or on the rough endoplasmic reticulum.')).toBe('Ribosomes');
+    expect(answerText('word '.repeat(40))).toBeNull();
+  });
+});
+
+describe('DistractorIndex', () => {
+  const index = new DistractorIndex(QUIZ_DECK);
+  const byAnswer = new Map(QUIZ_DECK.map((card) => [normalize(card.back), card]));
+
+  test('offers distinct wrong options of the answer type for every card', () => {
+    QUIZ_DECK.forEach((card) => {
+      const distractors = index.distractors(card.id, 3);
+      const normalized = distractors.map(normalize);
+
+      // The fixture has only three phrase answers
+      expect(distractors).toHaveLength(card.expectedType === 'phrase' ? 2 : 3);
+      expect(normalized).not.toContain(normalize(card.back));
+      expect(new Set(normalized).size).toBe(distractors.length);
+      normalized.forEach((option) => {
+        // Synthesized numbers and dates are not deck answers
+        const source = byAnswer.get(option);
+        expect(source ? source.expectedType : card.expectedType).toBe(card.expectedType);
+      });
+    });
+  });
+
+  test('draws distractors from the same topic when the deck allows', () => {
+    let sameTopic = 0;
+    let total = 0;
+    QUIZ_DECK.forEach((card) => {
+      const peers = QUIZ_DECK.filter((other) =>
+        other.id !== card.id && other.topic === card.topic && other.expectedType === card.expectedType);
+      if (peers.length < 3) {
+        return;
+      }
+      index.distractors(card.id, 3).forEach((option) => {
+        total++;
+        sameTopic += byAnswer.get(normalize(option))?.topic === card.topic ? 1 : 0;
+      });
+    });
+
+    expect(total).toBeGreaterThan(60);
+    expect(sameTopic / total).toBeGreaterThanOrEqual(0.95);
+  });
+
+  test('fills numeric answers with nearby values in the same format', () => {
+    const everest = QUIZ_DECK.find((card) => card.back === '8,849 m') as LabeledCard;
+    const distractors = index.distractors(everest.id, 3);
+
+    distractors.forEach((option) => expect(option).toMatch(/^\d{1,3}(,\d{3})* m$/));
+  });
+
+  test('does not offer an answer that contains the correct one', () => {
+    const deck = new DistractorIndex([
+      { id: 'a', front: 'Where is the Louvre?', back: 'Paris' },
+      { id: 'b', front: 'Where is the Eiffel Tower?', back: 'Paris, France' },
+      { id: 'c', front: 'Where is the Colosseum?', back: 'Rome' }
+    ]);
+
+    expect(deck.distractors('a', 3)).toEqual(['Rome']);
+  });
+});
@@ -0,0 +1,104 @@
+/**
+ * @fileoverview Unit tests for the local moderation prefilter and batched content moderator
+ * @version 1.0.0
+ */
+
+import { AhoCorasick, ModerationPrefilter } from '../../src/core/ai/moderationPrefilter';
+import { ContentModerator } from '../../src/core/ai/contentModerator';
+import { OpenAIClient } from '../../src/config/openai';
+
+describe('AhoCorasick', () => {
+  const matchesOf = (matcher: AhoCorasick<string>, text: string) => {
+    const found: string[] = [];
+    matcher.scan(text, (value) => found.push(value));
+    return found;
+  };
+
+  test('finds overlapping patterns in one pass, only at word starts', () => {
+    const matcher = new AhoCorasick([
+      { pattern: 'kill', value: 'kill' },
+      { pattern: 'ill', value: 'ill' },
+      { pattern: 'killer whale', value: 'orca' }
+    ]);
+
+    expect(matchesOf(matcher, 'A killer whale')).toEqual(['kill', 'orca']);
+    expect(matchesOf(matcher, 'Practice the skill daily')).toEqual([]);
+    expect(matchesOf(matcher, 'Ill, KILLING time')).toEqual(['ill', 'kill']);
+  });
+
+  test('reads digit and symbol substitutions after a letter', () => {
+    const matcher = new AhoCorasick([{ pattern: 'kill', value: 'kill' }, { pattern: 'ass', value: 'ass' }]);
+
+    expect(matchesOf(matcher, 'k1ll them')).toEqual(['kill']);
+    expect(matchesOf(matcher, 'a$$')).toEqual(['ass']);
+    expect(matchesOf(matcher, 'Chapter 4 $5')).toEqual([]);
+  });
+});
+
+describe('ModerationPrefilter', () => {
+  const prefilter = new ModerationPrefilter();
+
+  test('clears ordinary study material', () => {
+    expect(prefilter.classify('Photosynthesis converts light energy into chemical energy in chloroplasts.'))
+      .toEqual({ verdict: 'clear', reasons: [] });
+    expect(prefilter.classify('Practice the skill of spaced repetition; grammar, 3.14 and 42 assessments.').verdict)
+      .toBe('clear');
+  });
+
+  test('sends sensitive topics to review with their categories', () => {
+    const result = prefilter.classify('The bomb squad found a rifle near the heroin lab.');
+
+    expect(result.verdict).toBe('review');
+    expect(result.reasons).toEqual(expect.arrayContaining(['weapons', 'drugs']));
+  });
+
+  test('sends text it cannot judge to review', () => {
+    expect(prefilter.classify('Фотосинтез превращает свет в химическую энергию').reasons).toContain('unsupported-script');
+    expect(prefilter.classify('you should k i l l yourself').reasons).toContain('obfuscation');
+  });
+});
+
+describe('ContentModerator', () => {
+  let createModeration: jest.Mock;
+  let moderator: ContentModerator;
+
+  beforeEach(() => {
+    createModeration = jest.fn().mockImplementation(async (input: string[]) => ({
+      data: { results: input.map((text) => ({ flagged: text.includes('flag me') })) }
+    }));
+    moderator = new ContentModerator({ createModeration } as unknown as OpenAIClient, { maxBatchSize: 3 });
+  });
+
+  test('clears safe content locally without calling the endpoint', async () => {
+    await moderator.moderate('The mitochondria is the powerhouse of the cell.');
+
+    expect(createModeration).not.toHaveBeenCalled();
+    expect(moderator.getStats()).toEqual({ cleared: 1, reviewed: 0, requests: 0, flagged: 0 });
+  });
+
+  test('batches concurrent reviews and maps results back to each input', async () => {
+    const texts = [
+      'History of the atomic bomb',
+      'Gun safety rules, flag me',
+      'Opioid pharmacology',
+      'Nazi propaganda techniques',
+      'Grenade fragmentation'
+    ];
+
+    const outcomes = await Promise.allSettled(texts.map((text) => moderator.moderate(text)));
+
+    expect(outcomes.map((outcome) => outcome.status))
+      .toEqual(['fulfilled', 'rejected', 'fulfilled', 'fulfilled', 'fulfilled']);
+    expect(createModeration).toHaveBeenCalledTimes(2);
+    expect(createModeration.mock.calls[0][0]).toEqual(texts.slice(0, 3));
+    expect(createModeration.mock.calls[1][0]).toEqual(texts.slice(3));
+    expect(moderator.getStats()).toEqual({ cleared: 0, reviewed: 5, requests: 2, flagged: 1 });
+  });
+
+  test('fails every check in a batch when the endpoint fails', async () => {
+    createModeration.mockRejectedValueOnce(new Error('Moderation unavailable'));
+
+    await expect(Promise.all([moderator.moderate('bomb'), moderator.moderate('rifle')]))
+      .rejects.toThrow('Moderation unavailable');
+  });
+});
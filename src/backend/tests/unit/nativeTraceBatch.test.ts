@@ -0,0 +1,94 @@
+/**
+ * @fileoverview Unit tests for the native trace batch decoder
+ * Verifies wire-format parsing, clock mapping and rejection of malformed batches
+ * @version 1.0.0
+ */
+
+import {
+  decodeTraceBatch,
+  TraceBatchError,
+  TRACE_BATCH_MAGIC,
+  TRACE_BATCH_VERSION,
+  TRACE_BATCH_HEADER_SIZE,
+  TRACE_BATCH_RECORD_SIZE
+} from '../../src/core/monitoring/nativeTraceBatch';
+
+interface TestSpan {
+  startNs: bigint;
+  durationNs: bigint;
+  spanId: number;
+  thread: number;
+  arg: number;
+}
+
+const DRAINED_AT_MS = 1_700_000_000_000n;
+const DRAINED_AT_NS = 5_000_000_000n;
+
+const encodeBatch = (spans: TestSpan[], dropped = 0): Buffer => {
+  const buffer = Buffer.alloc(TRACE_BATCH_HEADER_SIZE + spans.length * TRACE_BATCH_RECORD_SIZE);
+  buffer.writeUInt32LE(TRACE_BATCH_MAGIC, 0);
+  buffer.writeUInt16LE(TRACE_BATCH_VERSION, 4);
+  buffer.writeUInt16LE(TRACE_BATCH_RECORD_SIZE, 6);
+  buffer.writeUInt32LE(spans.length, 8);
+  buffer.writeUInt32LE(dropped, 12);
+  buffer.writeBigUInt64LE(DRAINED_AT_MS, 16);
+  buffer.writeBigUInt64LE(DRAINED_AT_NS, 24);
+
+  spans.forEach((span, i) => {
+    const offset = TRACE_BATCH_HEADER_SIZE + i * TRACE_BATCH_RECORD_SIZE;
+    buffer.writeBigUInt64LE(span.startNs, offset);
+    buffer.writeBigUInt64LE(span.durationNs, offset + 8);
+    buffer.writeUInt16LE(span.spanId, offset + 16);
+    buffer.writeUInt16LE(span.thread, offset + 18);
+    buffer.writeUInt32LE(span.arg, offset + 20);
+  });
+  return buffer;
+};
+
+describe('decodeTraceBatch', () => {
+  it('should decode spans with names, threads and arguments', () => {
+    const batch = decodeTraceBatch(encodeBatch([
+      { startNs: 4_000_000_000n, durationNs: 2_500_000n, spanId: 1, thread: 3, arg: 1 },
+      { startNs: 4_500_000_000n, durationNs: 800_000n, spanId: 6, thread: 4, arg: 4096 }
+    ], 7));
+
+    expect(batch.droppedCount).toBe(7);
+    expect(batch.spans).toHaveLength(2);
+    expect(batch.spans[0]).toMatchObject({ name: 'voice_start', thread: 3, arg: 1, durationNs: 2_500_000n });
+    expect(batch.spans[1]).toMatchObject({ name: 'file_write', thread: 4, arg: 4096 });
+  });
+
+  it('should map monotonic start times onto wall-clock time', () => {
+    const batch = decodeTraceBatch(encodeBatch([
+      { startNs: DRAINED_AT_NS - 1_000_000_000n, durationNs: 1n, spanId: 7, thread: 1, arg: 0 }
+    ]));
+
+    expect(batch.drainedAt.getTime()).toBe(Number(DRAINED_AT_MS));
+    expect(batch.spans[0].startedAt.getTime()).toBe(Number(DRAINED_AT_MS) - 1000);
+  });
+
+  it('should label unknown span identifiers instead of failing', () => {
+    const batch = decodeTraceBatch(encodeBatch([
+      { startNs: 1n, durationNs: 1n, spanId: 999, thread: 1, arg: 0 }
+    ]));
+
+    expect(batch.spans[0].name).toBe('unknown_999');
+  });
+
+  it('should reject truncated batches', () => {
+    const buffer = encodeBatch([{ startNs: 1n, durationNs: 1n, spanId: 1, thread: 1, arg: 0 }]);
+
+    expect(() => decodeTraceBatch(buffer.subarray(0, buffer.length - 1))).toThrow(TraceBatchError);
+    expect(() => decodeTraceBatch(buffer.subarray(0, 8))).toThrow(TraceBatchError);
+  });
+
+  it('should reject batches with a bad magic or version', () => {
+    const badMagic = encodeBatch([]);
+    badMagic.writeUInt32LE(0xdeadbeef, 0);
+    expect(() => decodeTraceBatch(badMagic)).toThrow('Invalid batch magic');
+
+    const badVersion = encodeBatch([]);
+    badVersion.writeUInt16LE(TRACE_BATCH_VERSION + 1, 4);
+    expect(() => decodeTraceBatch(badVersion)).toThrow(TraceBatchError);
+  });
+});
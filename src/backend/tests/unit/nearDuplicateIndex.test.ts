@@ -0,0 +1,108 @@
+/**
+ * @fileoverview Unit tests for near-duplicate card detection
+ * Verifies normalization, MinHash/LSH candidate recall and duplicate classification
+ * @version 1.0.0
+ */
+
+import {
+  jaccard,
+  minHashSignature,
+  NearDuplicateIndex,
+  normalizeCardText,
+  shingles
+} from '../../src/core/cards/nearDuplicateIndex';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+
+const PHOTOSYNTHESIS = {
+  front: 'What is the primary function of chlorophyll in photosynthesis?',
+  back: 'Chlorophyll absorbs light energy, mainly blue and red wavelengths, to drive photosynthesis.'
+};
+
+const features = (card: { front: string; back: string }) => shingles(normalizeCardText(card));
+
+describe('near-duplicate primitives', () => {
+  test('normalization ignores case, punctuation and spacing', () => {
+    expect(normalizeCardText({ front: '  What is  DNA? ', back: 'Deoxyribonucleic acid.' }))
+      .toBe(normalizeCardText({ front: 'what is dna', back: 'deoxyribonucleic   acid' }));
+  });
+
+  test('MinHash agreement estimates Jaccard similarity', () => {
+    const a = features(PHOTOSYNTHESIS);
+    const b = features({ ...PHOTOSYNTHESIS, back: 'Chlorophyll absorbs light energy to drive photosynthesis.' });
+    const size = 512;
+    const sigA = minHashSignature(a, size);
+    const sigB = minHashSignature(b, size);
+    const agreement = sigA.filter((value, i) => value === sigB[i]).length / size;
+
+    expect(Math.abs(agreement - jaccard(a, b))).toBeLessThan(0.08);
+  });
+});
+
+describe('NearDuplicateIndex', () => {
+  let store: InMemoryRedisStore;
+  let index: NearDuplicateIndex;
+
+  beforeEach(async () => {
+    store = new InMemoryRedisStore();
+    index = new NearDuplicateIndex(store.client());
+    await index.add('user-1', [{ id: 'card-1', ...PHOTOSYNTHESIS }]);
+  });
+
+  test('merges a reworded copy of a stored card', async () => {
+    const [verdict] = await index.classify('user-1', [{
+      front: 'What is the primary function of chlorophyll in photosynthesis',
+      back: 'Chlorophyll absorbs light energy (mainly blue and red wavelengths) to drive photosynthesis!'
+    }]);
+
+    expect(verdict.status).toBe('duplicate');
+    expect(verdict.matchId).toBe('card-1');
+  });
+
+  test('flags a close but different card and keeps unrelated ones', async () => {
+    const verdicts = await index.classify('user-1', [
+      { front: PHOTOSYNTHESIS.front, back: 'Chlorophyll absorbs light energy to power photosynthesis in plants.' },
+      { front: 'What enzyme unwinds DNA during replication?', back: 'Helicase separates the two strands.' }
+    ]);
+
+    expect(verdicts[0].status).toBe('flagged');
+    expect(verdicts[0].matchId).toBe('card-1');
+    expect(verdicts[1]).toEqual({ status: 'unique', similarity: 0 });
+  });
+
+  test('detects duplicates within one batch', async () => {
+    const helicase = { front: 'What enzyme unwinds DNA during replication?', back: 'Helicase separates the two strands.' };
+    const verdicts = await index.classify('user-1', [helicase, { ...helicase, front: 'What enzyme unwinds DNA during replication' }]);
+
+    expect(verdicts[0].status).toBe('unique');
+    expect(verdicts[1].status).toBe('duplicate');
+    expect(verdicts[1].matchIndex).toBe(0);
+  });
+
+  test('keeps indexes per user and forgets removed cards', async () => {
+    const [otherUser] = await index.classify('user-2', [PHOTOSYNTHESIS]);
+    expect(otherUser.status).toBe('unique');
+
+    await index.remove('user-1', { id: 'card-1', ...PHOTOSYNTHESIS });
+    const [afterRemoval] = await index.classify('user-1', [PHOTOSYNTHESIS]);
+    expect(afterRemoval.status).toBe('unique');
+  });
+
+  test('keeps one key per band for all of a user\'s cards, in one cluster slot', async () => {
+    const helicase = { front: 'What enzyme unwinds DNA during replication?', back: 'Helicase separates the two strands.' };
+    await index.add('user-1', [{ id: 'card-2', ...helicase }]);
+
+    const keys = [...store.sortedSets.keys(), ...store.hashes.keys()];
+    expect(keys).toHaveLength(21);
+    expect(keys.every((key) => key.startsWith('carddup:{user-1}:'))).toBe(true);
+  });
+
+  test('follows edits to a stored card', async () => {
+    const helicase = { front: 'What enzyme unwinds DNA during replication?', back: 'Helicase separates the two strands.' };
+    await index.update('user-1', { id: 'card-1', ...PHOTOSYNTHESIS }, { id: 'card-1', ...helicase });
+
+    const [original, edited] = await index.classify('user-1', [PHOTOSYNTHESIS, helicase]);
+    expect(original.status).toBe('unique');
+    expect(edited.status).toBe('duplicate');
+    expect(edited.matchId).toBe('card-1');
+  });
+});
@@ -0,0 +1,188 @@
+/**
+ * @fileoverview Unit tests for read-replica query routing
+ * Verifies replica selection by lag, read-your-writes through WAL positions recorded in
+ * Redis and lag metrics
+ * @version 1.0.0
+ */
+
+import { SupabaseClient } from '@supabase/supabase-js';
+import { QueryRouter, QueryRouterOptions, ReadClient } from '../../src/services/QueryRouter';
+import { walPosition } from '../../src/utils/walPosition';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+import { TEST_USER_ID } from '../utils/testHelpers';
+
+jest.mock('../../src/config/logger', () => ({ logger: { warn: jest.fn() } }));
+jest.mock('../../src/core/monitoring/PerformanceMonitor', () => ({
+  performanceMonitor: { trackReplicaLag: jest.fn(), recordReadRoute: jest.fn() }
+}));
+
+import { performanceMonitor } from '../../src/core/monitoring/PerformanceMonitor';
+
+interface WalStatus {
+  lsn: string | null;
+  fail?: boolean;
+}
+
+/**
+ * Client whose queries resolve to its own name; replica_status reports `wal.lsn`
+ */
+const namedClient = (name: string, wal: WalStatus = { lsn: '0/100' }) => {
+  const builder: any = {
+    select: () => builder,
+    insert: () => builder,
+    eq: () => builder,
+    then: (resolve: (result: unknown) => void) => resolve({ data: name, error: null })
+  };
+  return {
+    from: () => builder,
+    rpc: () => ({
+      single: async () => wal.fail
+        ? { data: null, error: { message: 'connection refused' } }
+        : { data: { in_recovery: name !== 'primary', wal_lsn: wal.lsn }, error: null }
+    })
+  };
+};
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Router over a primary and one replica whose WAL positions start level
+ */
+const setup = (options: QueryRouterOptions = {}) => {
+  const redis = new InMemoryRedisStore().client();
+  const primaryWal: WalStatus = { lsn: '0/100' };
+  const replicaWal: WalStatus = { lsn: '0/100' };
+  const router = new QueryRouter(
+    namedClient('primary', primaryWal) as unknown as SupabaseClient,
+    [{ name: 'replica-1', client: namedClient('replica-1', replicaWal) as unknown as ReadClient }],
+    redis,
+    { maxLagMs: 1000, pollIntervalMs: 50, ...options }
+  );
+  const select = (db: ReadClient) => db.from('cards').select();
+  const read = async (userId: string | null) => (await router.read(userId, select)).data;
+  return { router, redis, primaryWal, replicaWal, read };
+};
+
+describe('QueryRouter', () => {
+  beforeEach(() => jest.clearAllMocks());
+
+  test('sends every query to the primary without replicas', async () => {
+    const router = new QueryRouter(namedClient('primary') as unknown as SupabaseClient);
+
+    const { data } = await router.read(TEST_USER_ID, (db) => db.from('cards').select());
+
+    expect(data).toBe('primary');
+    expect(performanceMonitor.recordReadRoute).toHaveBeenCalledWith('no_replica');
+  });
+
+  test('keeps reads on the primary until replica lag is known', async () => {
+    const { router, read } = setup();
+
+    await expect(read(null)).resolves.toBe('primary');
+    expect(performanceMonitor.recordReadRoute).toHaveBeenLastCalledWith('replica_lagging');
+
+    await router.pollReplicas();
+    await expect(read(null)).resolves.toBe('replica-1');
+    expect(performanceMonitor.recordReadRoute).toHaveBeenLastCalledWith('replica');
+  });
+
+  test('skips replicas over the lag budget or failing status checks', async () => {
+    const { router, primaryWal, replicaWal, read } = setup({ maxLagMs: 20 });
+    await router.pollReplicas();
+    await expect(read(null)).resolves.toBe('replica-1');
+
+    // The replica has replayed only what the primary had at the first poll
+    primaryWal.lsn = '0/200';
+    await delay(30);
+    await router.pollReplicas();
+    await expect(read(null)).resolves.toBe('primary');
+
+    replicaWal.lsn = '0/200';
+    replicaWal.fail = true;
+    await router.pollReplicas();
+    await expect(read(null)).resolves.toBe('primary');
+    expect(router.getReplicaLag()).toEqual({ 'replica-1': null });
+  });
+
+  test('does not count a replica that has received nothing new as caught up', async () => {
+    const { router, primaryWal, read } = setup();
+    primaryWal.lsn = '0/200';
+
+    await router.pollReplicas();
+
+    await expect(read(null)).resolves.toBe('primary');
+    expect(router.getReplicaLag()).toEqual({ 'replica-1': null });
+  });
+
+  test('reads a user\'s recent writes from the primary until the replica replays them', async () => {
+    const { router, primaryWal, replicaWal, read } = setup();
+    await router.pollReplicas();
+
+    primaryWal.lsn = '0/1A0';
+    await router.write(TEST_USER_ID, (db) => db.from('cards').insert({}));
+
+    await expect(read(TEST_USER_ID)).resolves.toBe('primary');
+    expect(performanceMonitor.recordReadRoute).toHaveBeenLastCalledWith('recent_write');
+    await expect(read('other-user')).resolves.toBe('replica-1');
+
+    // Replayed the primary's position after the write, however the clocks compare
+    replicaWal.lsn = '0/1A0';
+    await router.pollReplicas();
+    await expect(read(TEST_USER_ID)).resolves.toBe('replica-1');
+  });
+
+  test('keeps the furthest write position of a user', async () => {
+    const { router, redis, primaryWal } = setup();
+
+    primaryWal.lsn = '1/0';
+    await router.recordWrite(TEST_USER_ID);
+    primaryWal.lsn = '0/FFFFFFFF';
+    await router.recordWrite(TEST_USER_ID);
+
+    expect(await redis.get(`db:lastwrite:${TEST_USER_ID}`)).toBe(walPosition('1/0'));
+  });
+
+  test('pins a user to the primary when the write position cannot be read', async () => {
+    const { router, primaryWal, read } = setup();
+    await router.pollReplicas();
+
+    primaryWal.fail = true;
+    await router.write(TEST_USER_ID, (db) => db.from('cards').insert({}));
+    await router.pollReplicas();
+
+    await expect(read(TEST_USER_ID)).resolves.toBe('primary');
+  });
+
+  test('records writes that fail, since part of them may have committed', async () => {
+    const { router, primaryWal, read } = setup();
+    await router.pollReplicas();
+    primaryWal.lsn = '0/200';
+
+    await expect(router.write(TEST_USER_ID, async () => { throw new Error('timeout'); })).rejects.toThrow('timeout');
+
+    await expect(read(TEST_USER_ID)).resolves.toBe('primary');
+  });
+
+  test('stops trusting a replica whose status has not been checked recently', async () => {
+    const { router, read } = setup();
+    await router.pollReplicas();
+
+    await new Promise((resolve) => setTimeout(resolve, 120));
+
+    await expect(read(null)).resolves.toBe('primary');
+  });
+
+  test('reports replica lag as the age of the newest primary position replayed', async () => {
+    const { router, primaryWal } = setup();
+    await router.pollReplicas();
+
+    primaryWal.lsn = '0/200';
+    await delay(60);
+    await router.pollReplicas();
+
+    const lagMs = router.getReplicaLag()['replica-1']!;
+    expect(lagMs).toBeGreaterThanOrEqual(60);
+    expect(lagMs).toBeLessThan(1000);
+    expect(performanceMonitor.trackReplicaLag).toHaveBeenLastCalledWith('replica-1', lagMs / 1000);
+  });
+});
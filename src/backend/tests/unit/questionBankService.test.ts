@@ -0,0 +1,136 @@
+/**
+ * @fileoverview Unit tests for the precomputed question bank service
+ * Verifies that refreshes rebuild only new and changed cards and version the bank
+ * @version 1.0.0
+ */
+
+import { ICard, ContentType } from '../../src/interfaces/ICard';
+import { IQuestionBank, IQuizQuestion } from '../../src/interfaces/IQuestionBank';
+import { QuestionBankService } from '../../src/services/QuestionBankService';
+import { createMockCard, TEST_USER_ID } from '../utils/testHelpers';
+
+jest.mock('bull', () => jest.fn().mockImplementation(() => ({
+  process: jest.fn(),
+  on: jest.fn(),
+  add: jest.fn().mockResolvedValue(undefined)
+})));
+jest.mock('../../src/config/logger', () => ({ logger: { error: jest.fn(), warn: jest.fn() } }));
+jest.mock('../../src/core/monitoring/PerformanceMonitor', () => ({
+  performanceMonitor: { recordPipelineStage: jest.fn(), trackQuestionBankRefresh: jest.fn() }
+}));
+
+import { performanceMonitor } from '../../src/core/monitoring/PerformanceMonitor';
+
+const CONTENT_ID = 'content-1';
+
+const deckCard = (id: string, front: string, back: string, contentId = CONTENT_ID): ICard => createMockCard({
+  id,
+  userId: TEST_USER_ID,
+  contentId,
+  frontContent: { text: front, type: ContentType.TEXT, metadata: {} as ICard['frontContent']['metadata'] },
+  backContent: { text: back, type: ContentType.TEXT, metadata: {} as ICard['backContent']['metadata'] }
+});
+
+/**
+ * In-memory stand-in for the question bank tables
+ */
+const memoryBank = () => {
+  let bank: IQuestionBank | null = null;
+  const questions = new Map<string, IQuizQuestion>();
+  return {
+    questions,
+    findBank: jest.fn(async () => bank),
+    findCardHashes: jest.fn(async () => new Map([...questions.values()].map((q) => [q.cardId, q.cardHash]))),
+    saveVersion: jest.fn(async (state: Omit<IQuestionBank, 'builtAt' | 'staleSince'>, written: IQuizQuestion[], removed: string[]) => {
+      bank = { ...state, builtAt: new Date(), staleSince: null };
+      written.forEach((question) => questions.set(question.cardId, question));
+      removed.forEach((cardId) => questions.delete(cardId));
+    }),
+    sample: jest.fn(async (userId: string, count: number) => [...questions.values()].slice(0, count))
+  };
+};
+
+describe('QuestionBankService', () => {
+  let deck: ICard[];
+  let bank: ReturnType<typeof memoryBank>;
+  let buildDeckQuestions: jest.Mock;
+  let service: QuestionBankService;
+
+  beforeEach(() => {
+    deck = [
+      deckCard('a', 'What is the powerhouse of the cell?', 'Mitochondria'),
+      deckCard('b', 'Where are proteins assembled?', 'Ribosomes'),
+      deckCard('c', 'What holds the genome?', 'Nucleus'),
+      deckCard('d', 'What is the capital of France?', 'Paris', 'content-2')
+    ];
+    bank = memoryBank();
+    // One question per requested card, options drawn from the rest of the deck
+    buildDeckQuestions = jest.fn(async (userId: string, cards: ICard[], options: { cardIds: Set<string> }) =>
+      cards.filter((card) => options.cardIds.has(card.id)).map((card) => ({
+        card,
+        question: {
+          question: card.frontContent.text,
+          type: 'multiple_choice',
+          options: cards.map((other) => other.backContent.text),
+          correctAnswer: card.backContent.text
+        }
+      })));
+    service = new QuestionBankService(
+      { buildDeckQuestions } as any,
+      bank as any,
+      { findByUserId: jest.fn(async () => deck) } as any
+    );
+  });
+
+  test('builds a question for every card of the content on first refresh', async () => {
+    const result = await service.refresh(CONTENT_ID, TEST_USER_ID);
+
+    expect(result).toEqual({ contentId: CONTENT_ID, version: 1, questionCount: 3, built: 3, reused: 0, removed: 0 });
+    expect([...bank.questions.keys()].sort()).toEqual(['a', 'b', 'c']);
+    // The whole deck supplies distractors, in the background priority class
+    expect(buildDeckQuestions.mock.calls[0][1]).toHaveLength(4);
+    expect(buildDeckQuestions.mock.calls[0][2].priority).toBe('batch');
+  });
+
+  test('reuses stored questions when no card changed', async () => {
+    await service.refresh(CONTENT_ID, TEST_USER_ID);
+    const result = await service.refresh(CONTENT_ID, TEST_USER_ID);
+
+    expect(result).toEqual({ contentId: CONTENT_ID, version: 1, questionCount: 3, built: 0, reused: 3, removed: 0 });
+    expect(buildDeckQuestions).toHaveBeenCalledTimes(1);
+    expect(performanceMonitor.trackQuestionBankRefresh).toHaveBeenLastCalledWith(0, 3);
+  });
+
+  test('rebuilds changed cards and drops deleted ones in a new version', async () => {
+    await service.refresh(CONTENT_ID, TEST_USER_ID);
+    deck = [deckCard('a', 'What is the powerhouse of the cell?', 'The mitochondrion'), deck[1], deck[3]];
+
+    const result = await service.refresh(CONTENT_ID, TEST_USER_ID);
+
+    expect(result).toEqual({ contentId: CONTENT_ID, version: 2, questionCount: 2, built: 1, reused: 1, removed: 1 });
+    expect([...buildDeckQuestions.mock.calls[1][2].cardIds]).toEqual(['a']);
+    expect(bank.questions.get('a')).toMatchObject({ correctAnswer: 'The mitochondrion', bankVersion: 2 });
+    expect(bank.questions.get('b')?.bankVersion).toBe(1);
+    expect(bank.questions.has('c')).toBe(false);
+  });
+
+  test('removes the question of a changed card that no longer yields one', async () => {
+    await service.refresh(CONTENT_ID, TEST_USER_ID);
+    deck = [deckCard('a', 'What is the powerhouse of the cell?', 'The mitochondrion'), deck[1], deck[2], deck[3]];
+    buildDeckQuestions.mockResolvedValueOnce([]);
+
+    const result = await service.refresh(CONTENT_ID, TEST_USER_ID);
+
+    expect(result).toMatchObject({ version: 2, questionCount: 2, built: 0, removed: 1 });
+    expect(bank.questions.has('a')).toBe(false);
+  });
+
+  test('samples stored questions and records quiz start latency', async () => {
+    await service.refresh(CONTENT_ID, TEST_USER_ID);
+
+    const questions = await service.sampleQuiz(TEST_USER_ID, 2);
+
+    expect(questions).toHaveLength(2);
+    expect(performanceMonitor.recordPipelineStage).toHaveBeenCalledWith('quiz', 'start', expect.any(Number), false);
+  });
+});
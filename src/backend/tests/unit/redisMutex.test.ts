@@ -0,0 +1,53 @@
+/**
+ * @fileoverview Unit tests for the cluster-wide mutex
+ * Runs sections from several workers sharing one Redis and checks they never overlap
+ * @version 1.0.0
+ */
+
+import { RedisMutex } from '../../src/utils/redisMutex';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+describe('RedisMutex', () => {
+  let store: InMemoryRedisStore;
+
+  beforeEach(() => {
+    store = new InMemoryRedisStore();
+  });
+
+  test('runs one section per key at a time across workers', async () => {
+    const workers = Array.from({ length: 3 }, () => new RedisMutex(store.client(), { retryMs: 5 }));
+    let running = 0;
+    let overlapped = false;
+    const section = async () => {
+      running++;
+      overlapped = overlapped || running > 1;
+      await delay(20);
+      running--;
+    };
+
+    await Promise.all(workers.map((worker) => worker.runExclusive('user-1', section)));
+
+    expect(overlapped).toBe(false);
+    expect(workers.reduce((sum, worker) => sum + worker.getStats().acquired, 0)).toBe(3);
+  });
+
+  test('releases the lock when the section fails', async () => {
+    const mutex = new RedisMutex(store.client(), { waitTimeoutMs: 50 });
+
+    await expect(mutex.runExclusive('user-1', async () => { throw new Error('insert failed'); })).rejects.toThrow('insert failed');
+    await mutex.runExclusive('user-1', async () => undefined);
+
+    expect(mutex.getStats()).toEqual({ acquired: 2, bypassed: 0 });
+  });
+
+  test('runs unguarded while Redis is unreachable', async () => {
+    const client = store.client();
+    client.set = (() => Promise.reject(new Error('connect ECONNREFUSED'))) as never;
+    const mutex = new RedisMutex(client);
+
+    await expect(mutex.runExclusive('user-1', async () => 'created')).resolves.toBe('created');
+    expect(mutex.getStats().bypassed).toBe(1);
+  });
+});
@@ -0,0 +1,94 @@
+/**
+ * @fileoverview Unit tests for offline review sync
+ * Verifies a sync round stores the device's reviews before pulling, and returns cards
+ * in the shape the device's card store upserts
+ * @version 1.0.0
+ */
+
+import { ISyncedReview } from '../../src/interfaces/IReviewSync';
+import { Card } from '../../src/models/Card';
+import { ReviewLog } from '../../src/models/ReviewLog';
+import { ReviewSyncService } from '../../src/services/ReviewSyncService';
+import { createMockCard, TEST_USER_ID } from '../utils/testHelpers';
+
+const DEVICE_ID = 'device-a';
+
+const review = (sequence: number, cardId: string, reviewedAt: number): ISyncedReview => ({
+  sequence,
+  cardId,
+  rating: 4,
+  reviewedAt,
+  stability: 1.2,
+  difficulty: 0.27,
+  dueAt: reviewedAt + 86400000
+});
+
+/**
+ * Service over in-memory models; `order` records the calls in the order they were made
+ */
+const setup = (changedCards = [createMockCard({ userId: TEST_USER_ID })]) => {
+  const order: string[] = [];
+  const reviewLog = {
+    append: jest.fn(async (userId: string, deviceId: string, reviews: ISyncedReview[]) => {
+      order.push('append');
+      return reviews[reviews.length - 1].sequence;
+    }),
+    since: jest.fn(async () => {
+      order.push('since');
+      return [review(41, 'card-remote', 1700000000000)];
+    })
+  };
+  const cardModel = {
+    findUpdatedSince: jest.fn(async () => {
+      order.push('findUpdatedSince');
+      return changedCards;
+    })
+  };
+  const service = new ReviewSyncService(reviewLog as unknown as ReviewLog, cardModel as unknown as Card);
+  return { service, reviewLog, cardModel, order };
+};
+
+describe('ReviewSyncService.sync', () => {
+  test('stores pushed reviews before pulling and acknowledges them', async () => {
+    const { service, reviewLog, order } = setup();
+    const pushed = [review(1, 'card-a', 1700000000000), review(2, 'card-b', 1700000060000)];
+
+    const result = await service.sync(TEST_USER_ID, { deviceId: DEVICE_ID, reviews: pushed, cursor: 40, cardsSince: 0 });
+
+    expect(reviewLog.append).toHaveBeenCalledWith(TEST_USER_ID, DEVICE_ID, pushed);
+    expect(reviewLog.since).toHaveBeenCalledWith(TEST_USER_ID, DEVICE_ID, 40, 500);
+    expect(order[0]).toBe('append');
+    expect(result.acknowledged).toBe(2);
+    expect(result.reviews.map((entry) => entry.sequence)).toEqual([41]);
+  });
+
+  test('returns changed cards with their scheduling state in epoch milliseconds', async () => {
+    const lastReview = new Date('2024-01-18T10:00:00Z');
+    const nextReview = new Date('2024-01-20T10:00:00Z');
+    const updatedAt = '2024-01-18T10:00:05Z';
+    const card = {
+      ...createMockCard({ userId: TEST_USER_ID, nextReview }),
+      fsrsData: { stability: 2.5, difficulty: 0.4, reviewCount: 3, lastReview, lastRating: 4 },
+      updatedAt
+    };
+    const { service, reviewLog } = setup([card]);
+
+    const result = await service.sync(TEST_USER_ID, { deviceId: DEVICE_ID, reviews: [], cursor: 0, cardsSince: 0 });
+
+    expect(reviewLog.append).toHaveBeenCalledTimes(0);
+    expect(result.cards).toEqual([{
+      id: card.id,
+      contentId: card.contentId,
+      front: card.frontContent.text,
+      back: card.backContent.text,
+      stability: 2.5,
+      difficulty: 0.4,
+      reviewCount: 3,
+      lastRating: 4,
+      lastReviewAt: lastReview.getTime(),
+      dueAt: nextReview.getTime()
+    }]);
+    expect(result.cardsSyncedAt).toBe(new Date(updatedAt).getTime());
+    expect(result.hasMore).toBe(false);
+  });
+});
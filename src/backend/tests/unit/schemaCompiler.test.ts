@@ -0,0 +1,184 @@
+/**
+ * @fileoverview Unit tests for compiled request validation and response serialization
+ * Checks that compiled validators return exactly what Joi returns, and that compiled
+ * stringifiers produce exactly what JSON.stringify produces
+ * @version 1.0.0
+ */
+
+import Joi from 'joi';
+import { compileSchema } from '../../src/utils/schemaCompiler';
+import { compileStringifier } from '../../src/utils/jsonStringifier';
+import { compiledCardSchemas } from '../../src/api/validators/card.validator';
+import { compiledSessionSchemas } from '../../src/api/validators/study.validator';
+import { serializeCardListResponse } from '../../src/api/serializers/card.serializer';
+import { serializeStudySession } from '../../src/api/serializers/study.serializer';
+import { createMockCard, createMockStudySession } from '../utils/testHelpers';
+
+const cardBody = () => ({
+  frontContent: {
+    text: 'What does the forgetting curve describe?',
+    type: 'text',
+    metadata: { sourcePosition: { start: 4, end: 40 }, aiGenerated: true, generationPrompt: 'Q&A', lastModifiedBy: 'ai' }
+  },
+  backContent: {
+    text: 'Exponential loss of retention over time',
+    type: 'markdown',
+    metadata: { sourceUrl: 'https://example.com/notes?id=4', aiGenerated: false, lastModifiedBy: 'user' }
+  },
+  fsrsData: { stability: 0.4, difficulty: 0.3, reviewCount: 2, lastReview: '2024-05-01T10:00:00.000Z', lastRating: 3 },
+  compatibleModes: ['standard'],
+  tags: ['memory', 'psychology']
+});
+
+const sessionBody = () => ({
+  userId: '3f1c2a9e-8b7d-4c6e-9f5a-1b2c3d4e5f60',
+  mode: 'standard',
+  startTime: '2024-05-01T10:00:00.000Z',
+  endTime: '2024-05-01T10:30:00.000Z',
+  cardsStudied: ['9b2d4c1e-3a5f-4e6d-8c7b-0a1b2c3d4e5f'],
+  voiceEnabled: false,
+  status: 'active',
+  settings: { sessionDuration: 1800, showConfidenceButtons: true, enableFSRS: false }
+});
+
+// Mutations that Joi rejects or converts; the compiled path must hand each one to Joi
+const cardVariants: Array<(body: any) => void> = [
+  () => undefined,
+  (body) => { body.frontContent.text = '<script>alert(1)</script>'; },
+  (body) => { body.backContent.type = 'pdf'; },
+  (body) => { body.frontContent.metadata.sourcePosition.end = 1; },
+  (body) => { delete body.frontContent.metadata.generationPrompt; },
+  (body) => { body.fsrsData.stability = '0.4'; },
+  (body) => { body.fsrsData.lastReview = null; },
+  (body) => { body.fsrsData.lastReview = '2024-05-01'; },
+  (body) => { body.tags = ['memory', 'memory']; },
+  (body) => { body.tags = []; },
+  (body) => { body.compatibleModes = ['voice']; },
+  (body) => { body.extra = true; },
+  (body) => { delete body.fsrsData; }
+];
+
+const sessionVariants: Array<(body: any) => void> = [
+  () => undefined,
+  (body) => { body.endTime = '2024-05-01T09:00:00.000Z'; },
+  (body) => { body.status = 'completed'; },
+  (body) => { body.performance = { totalCards: 1 }; },
+  (body) => { body.settings.cardsPerSession = 10; },
+  (body) => { body.settings.cardsPerSession = 1; },
+  (body) => { body.settings.enableFSRS = true; },
+  (body) => { body.userId = 'not-a-uuid'; },
+  (body) => { body.startTime = 1714557600000; }
+];
+
+const outcome = (result: Joi.ValidationResult) => ({ error: result.error?.message, value: result.value });
+
+const settle = (promise: Promise<unknown>) =>
+  promise.then((value) => ({ value }), (error) => ({ error: error.message }));
+
+describe('compileSchema', () => {
+  test('compiles the card and study session schemas', () => {
+    expect(compiledCardSchemas.create.compiled).toBe(true);
+    expect(compiledCardSchemas.update.compiled).toBe(true);
+    expect(compiledCardSchemas.bulkCreate.compiled).toBe(true);
+    expect(compiledSessionSchemas.create.compiled).toBe(true);
+    expect(compiledSessionSchemas.update.compiled).toBe(true);
+  });
+
+  test.each(cardVariants.map((mutate, index) => [index, mutate]))(
+    'card variant %i validates exactly as Joi does',
+    async (_index, mutate) => {
+      for (const [compiled, userRole] of [
+        [compiledCardSchemas.create, undefined],
+        [compiledCardSchemas.update, 'pro'],
+        [compiledCardSchemas.update, 'free']
+      ] as const) {
+        const body = cardBody();
+        const expected = cardBody();
+        mutate(body);
+        mutate(expected);
+        const options = { context: { userRole } };
+
+        await expect(settle(compiled.validateAsync(body, options)))
+          .resolves.toEqual(await settle(compiled.schema.validateAsync(expected, options)));
+      }
+    }
+  );
+
+  test.each(sessionVariants.map((mutate, index) => [index, mutate]))(
+    'session variant %i validates exactly as Joi does',
+    (_index, mutate) => {
+      const body = sessionBody();
+      mutate(body);
+
+      expect(outcome(compiledSessionSchemas.create.validate(body)))
+        .toEqual(outcome(compiledSessionSchemas.create.schema.validate(body)));
+    }
+  );
+
+  test('leaves the input untouched and converts dates like Joi', () => {
+    const body = sessionBody();
+
+    const { value } = compiledSessionSchemas.create.validate(body);
+
+    expect(value).not.toBe(body);
+    expect(body.startTime).toBe('2024-05-01T10:00:00.000Z');
+    expect(value.startTime).toEqual(new Date('2024-05-01T10:00:00.000Z'));
+    expect(value.settings.cardsPerSession).toBe(20);
+  });
+
+  test('falls back to Joi for schemas outside the compiled subset', () => {
+    const schema = Joi.object({ email: Joi.string().email().required() });
+    const compiled = compileSchema(schema);
+
+    expect(compiled.compiled).toBe(false);
+    expect(outcome(compiled.validate({ email: 'nope' }))).toEqual(outcome(schema.validate({ email: 'nope' })));
+  });
+});
+
+describe('compileStringifier', () => {
+  test('matches JSON.stringify for card lists, including off-schema cards', () => {
+    const rawRow = { id: 'row', user_id: 'u', next_review: new Date() };
+    const body = {
+      success: true,
+      data: [createMockCard(), createMockCard({ tags: ['quote " and \\ slash', 'emoji 😀', '\u0001'] }), rawRow],
+      metadata: { count: 3, mode: 'standard' }
+    };
+
+    expect(serializeCardListResponse(body)).toBe(JSON.stringify(body));
+  });
+
+  test('matches JSON.stringify for session state', () => {
+    const session = createMockStudySession();
+
+    expect(serializeStudySession(session)).toBe(JSON.stringify(session));
+  });
+
+  test('matches JSON.stringify for values that do not fit the schema', () => {
+    const stringify = compileStringifier({
+      type: 'object',
+      properties: {
+        name: { type: 'string' },
+        count: { type: 'integer' },
+        at: { type: 'string', format: 'date-time' },
+        list: { type: 'array', items: { type: 'number' } }
+      }
+    });
+    const values: unknown[] = [
+      { name: 'a', count: 1, at: new Date(0), list: [1, 2] },
+      { count: NaN, at: new Date(NaN), list: [undefined, () => 1, Infinity] },
+      { name: undefined, count: null, at: 'later', list: 'none' },
+      { list: [], name: 'out of order' },
+      { name: 'extra', other: true },
+      { name: { toJSON: () => 'custom' } },
+      Object.assign(Object.create(null), { name: 'no prototype' }),
+      [1, 2],
+      null,
+      'text',
+      undefined
+    ];
+
+    for (const value of values) {
+      expect(stringify(value)).toBe(JSON.stringify(value));
+    }
+  });
+});
@@ -0,0 +1,193 @@
+/**
+ * @fileoverview Unit tests for the cross-user derived-artifact cache
+ * Verifies key normalization, privacy of shared artifacts and reuse through the content pipeline
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis';
+import { ICard } from '../../src/interfaces/ICard';
+import { IContent, ContentStatus } from '../../src/interfaces/IContent';
+import { ContentProcessor, PreparedContent } from '../../src/core/ai/contentProcessor';
+import { ContentPipeline } from '../../src/core/ai/contentPipeline';
+import { canonicalizeUrl, normalizedTextHash, SharedArtifactCache } from '../../src/core/ai/sharedArtifactCache';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+
+const ARTICLE = 'Spaced repetition\n\nReviewing material at increasing intervals improves long-term retention.';
+
+const capture = (userId: string, overrides: Partial<IContent> = {}): IContent => ({
+  id: `content-${userId}`,
+  userId,
+  content: ARTICLE,
+  metadata: { contentType: 'text', tags: [`tag-${userId}`] },
+  source: 'web',
+  sourceUrl: 'https://example.com/articles/spacing',
+  status: ContentStatus.NEW,
+  createdAt: new Date(),
+  updatedAt: new Date(),
+  processedAt: null,
+  ...overrides
+});
+
+/**
+ * Processor double that counts model calls; two chunks, two cards per chunk
+ */
+const countingProcessor = () => {
+  const calls = { analyze: 0, moderate: 0, generate: 0 };
+  const processor = {
+    prepareContent: (content: IContent): PreparedContent => ({
+      content,
+      sanitized: content.content,
+      chunks: content.content.split('\n\n').map((text, index) => ({
+        text, tokenCount: 10, overlapTokens: 0, start: index * 100, end: index * 100 + text.length, heading: `Part ${index}`
+      }))
+    }),
+    analyzePrepared: async (prepared: PreparedContent) => {
+      calls.analyze++;
+      return { isProcessable: true, topic: 'learning' };
+    },
+    toChunkContents: (prepared: PreparedContent) => prepared.chunks.map((chunk, index) => ({
+      ...prepared.content,
+      content: chunk.text,
+      metadata: { ...prepared.content.metadata, chunkIndex: index }
+    })),
+    moderateChunk: async (chunk: IContent) => {
+      calls.moderate++;
+      return chunk;
+    },
+    generateChunkCards: async (chunk: IContent) => {
+      calls.generate++;
+      return [1, 2].map((n) => ({
+        id: `${chunk.id}-${chunk.metadata.chunkIndex}-${n}`,
+        userId: chunk.userId,
+        contentId: chunk.id,
+        frontContent: { text: `Q${n} ${chunk.content}`, type: 'text', metadata: { sourceUrl: chunk.sourceUrl, aiGenerated: true, lastModifiedBy: 'system' } },
+        backContent: { text: `A${n}`, type: 'text', metadata: { sourceUrl: chunk.sourceUrl, aiGenerated: true, lastModifiedBy: 'system' } },
+        compatibleModes: ['standard'],
+        tags: chunk.metadata.tags
+      }) as unknown as ICard);
+    },
+    completeProcessing: (content: IContent) => ({ ...content, status: ContentStatus.PROCESSED }),
+    failProcessing: () => undefined
+  };
+  return { calls, processor: processor as unknown as ContentProcessor };
+};
+
+describe('canonicalizeUrl', () => {
+  test('ignores scheme, www, tracking parameters, fragments and trailing slashes', () => {
+    const canonical = canonicalizeUrl('https://example.com/a/b?id=7&page=2');
+
+    expect(canonicalizeUrl('http://WWW.Example.com/a/b/?page=2&utm_source=x&id=7#comments')).toBe(canonical);
+    expect(canonicalizeUrl('https://example.com/a/b?id=7&page=2&fbclid=abc')).toBe(canonical);
+    expect(canonicalizeUrl('https://example.com/a/b?id=8&page=2')).not.toBe(canonical);
+  });
+
+  test('rejects non-web URLs', () => {
+    expect(canonicalizeUrl('file:///Users/me/notes.txt')).toBeNull();
+    expect(canonicalizeUrl('not a url')).toBeNull();
+  });
+});
+
+describe('normalizedTextHash', () => {
+  test('ignores whitespace, case and boilerplate lines', () => {
+    const noisy = `Advertisement\n  SPACED repetition \r\n\n\nReviewing material   at increasing​ intervals improves long-term retention.\nShare this article\n© 2024 Example Media`;
+
+    expect(normalizedTextHash(noisy)).toBe(normalizedTextHash(ARTICLE));
+    expect(normalizedTextHash(`${ARTICLE} Extra sentence.`)).not.toBe(normalizedTextHash(ARTICLE));
+  });
+});
+
+describe('SharedArtifactCache', () => {
+  test('shares only public web captures', () => {
+    const cache = new SharedArtifactCache(new InMemoryRedisStore().client());
+
+    expect(cache.keyFor(capture('u1'))).toBe(cache.keyFor(capture('u2', { sourceUrl: 'http://www.example.com/articles/spacing/?utm_medium=social' })));
+    expect(cache.keyFor(capture('u1', { source: 'pdf' }))).toBeNull();
+    expect(cache.keyFor(capture('u1', { source: 'kindle' }))).toBeNull();
+    expect(cache.keyFor(capture('u1', { sourceUrl: null }))).toBeNull();
+  });
+
+  test('stores card templates without owner data', async () => {
+    const store = new InMemoryRedisStore();
+    const { processor } = countingProcessor();
+    const pipeline = new ContentPipeline(processor, async (cards) => cards, {
+      artifactCache: new SharedArtifactCache(store.client())
+    });
+
+    await pipeline.process(capture('private-user'));
+
+    const [key] = [...store.data.keys()];
+    const stored = store.data.get(key)!.value;
+    expect(stored).not.toContain('private-user');
+    expect(stored).not.toContain('example.com');
+    expect(JSON.parse(stored).chunks).toHaveLength(2);
+  });
+});
+
+describe('ContentPipeline with a shared artifact cache', () => {
+  test('runs analysis and generation once for an article captured by many users', async () => {
+    const { calls, processor } = countingProcessor();
+    const artifactCache = new SharedArtifactCache(new InMemoryRedisStore().client());
+    const persisted: ICard[] = [];
+    const streamed: ICard[] = [];
+    const pipeline = new ContentPipeline(processor, async (cards) => {
+      persisted.push(...cards);
+      return cards;
+    }, {
+      artifactCache,
+      onCard: (chunk, card) => streamed.push(card)
+    });
+
+    const first = await pipeline.process(capture('u1'));
+    const second = await pipeline.process(capture('u2', { sourceUrl: 'https://www.example.com/articles/spacing?utm_campaign=x' }));
+
+    expect(calls).toEqual({ analyze: 1, moderate: 2, generate: 2 });
+    expect(artifactCache.getStats()).toEqual({ hits: 1, misses: 1, skipped: 0, hitRate: 0.5 });
+
+    expect(second.content.status).toBe(ContentStatus.PROCESSED);
+    expect(second.content.metadata.topic).toBe('learning');
+    expect(second.cards.map((card) => card.frontContent.text)).toEqual(first.cards.map((card) => card.frontContent.text));
+    second.cards.forEach((card) => {
+      expect(card.userId).toBe('u2');
+      expect(card.contentId).toBe('content-u2');
+      expect(card.tags).toEqual(['tag-u2']);
+      expect(card.frontContent.metadata.sourceUrl).toBe('https://www.example.com/articles/spacing?utm_campaign=x');
+    });
+    expect(new Set(persisted.map((card) => card.id)).size).toBe(8);
+    expect(streamed).toHaveLength(4);
+  });
+
+  test('never shares private uploads', async () => {
+    const { calls, processor } = countingProcessor();
+    const artifactCache = new SharedArtifactCache(new InMemoryRedisStore().client());
+    const pipeline = new ContentPipeline(processor, async (cards) => cards, { artifactCache });
+
+    await pipeline.process(capture('u1', { source: 'pdf' }));
+    await pipeline.process(capture('u2', { source: 'pdf' }));
+
+    expect(calls.analyze).toBe(2);
+    expect(artifactCache.getStats().skipped).toBe(2);
+  });
+
+  test('processes captures normally while the cache is unreachable', async () => {
+    const { calls, processor } = countingProcessor();
+    const unreachable = async () => {
+      throw new Error('connect ECONNREFUSED');
+    };
+    const client = { get: jest.fn(unreachable), setex: jest.fn(unreachable) };
+    const artifactCache = new SharedArtifactCache(client as unknown as Redis);
+    const persisted: ICard[] = [];
+    const pipeline = new ContentPipeline(processor, async (cards) => {
+      persisted.push(...cards);
+      return cards;
+    }, { artifactCache });
+
+    const result = await pipeline.process(capture('u1'));
+
+    expect(client.setex).toHaveBeenCalledTimes(1);
+    expect(result.content.status).toBe(ContentStatus.PROCESSED);
+    expect(result.cards).toHaveLength(4);
+    expect(persisted).toHaveLength(4);
+    expect(calls.generate).toBe(2);
+    expect(artifactCache.getStats().misses).toBe(1);
+  });
+});
@@ -0,0 +1,156 @@
+/**
+ * @fileoverview Unit tests for distributed single-flight generation
+ * Simulates several workers sharing one Redis and counts how many generations actually run
+ * @version 1.0.0
+ */
+
+import { SingleFlight } from '../../src/utils/singleFlight';
+import { CardGenerator } from '../../src/core/ai/cardGenerator';
+import { IContent, ContentStatus } from '../../src/interfaces/IContent';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+
+const WORKERS = 4;
+const CALLS_PER_WORKER = 25;
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+const testContent: IContent = {
+  id: 'single-flight-content',
+  userId: 'single-flight-user',
+  content: 'Content shared by many concurrent generation requests.',
+  metadata: { contentType: 'text', language: 'en', tags: ['test'] },
+  source: 'web',
+  sourceUrl: 'https://example.com',
+  status: ContentStatus.NEW,
+  createdAt: new Date(),
+  updatedAt: new Date(),
+  processedAt: null
+} as IContent;
+
+describe('SingleFlight', () => {
+  let store: InMemoryRedisStore;
+  let workers: SingleFlight[];
+
+  beforeEach(() => {
+    store = new InMemoryRedisStore();
+    workers = Array.from({ length: WORKERS }, () => new SingleFlight(store.client(), undefined, { leaseMs: 300 }));
+  });
+
+  test('runs one computation for concurrent calls across workers', async () => {
+    let computations = 0;
+    const compute = async () => {
+      computations++;
+      await delay(50);
+      return { value: 42 };
+    };
+
+    const results = await Promise.all(workers.flatMap((worker) =>
+      Array.from({ length: CALLS_PER_WORKER }, () => worker.doCached('answer', 60, compute))
+    ));
+
+    expect(computations).toBe(1);
+    expect(results.every((result) => result.value === 42)).toBe(true);
+
+    const stats = workers.map((worker) => worker.getStats());
+    expect(stats.reduce((sum, s) => sum + s.leaders, 0)).toBe(1);
+    expect(stats.reduce((sum, s) => sum + s.followers, 0)).toBe(WORKERS - 1);
+    expect(stats.reduce((sum, s) => sum + s.local, 0)).toBe(WORKERS * (CALLS_PER_WORKER - 1));
+  });
+
+  test('shares the leader failure instead of retrying it', async () => {
+    let computations = 0;
+    const compute = async (): Promise<number> => {
+      computations++;
+      await delay(30);
+      throw new Error('model unavailable');
+    };
+
+    const outcomes = await Promise.allSettled(workers.map((worker) => worker.doCached('failing', 60, compute)));
+
+    expect(computations).toBe(1);
+    outcomes.forEach((outcome) => {
+      expect(outcome.status).toBe('rejected');
+      expect((outcome as PromiseRejectedResult).reason.message).toBe('model unavailable');
+    });
+  });
+
+  test('keeps the lease while a long computation runs', async () => {
+    let computations = 0;
+    const compute = async () => {
+      computations++;
+      await delay(1000);
+      return 'slow';
+    };
+
+    const results = await Promise.all(workers.map((worker) => worker.doCached('slow', 60, compute)));
+
+    expect(computations).toBe(1);
+    expect(results).toEqual(Array(WORKERS).fill('slow'));
+  });
+
+  test('takes over when the leader disappears without releasing', async () => {
+    const client = store.client();
+    await client.set('singleflight:lock:orphaned', 'crashed-worker', 'PX', 100, 'NX');
+
+    const result = await workers[0].doCached('orphaned', 60, async () => 'recovered');
+
+    expect(result).toBe('recovered');
+    expect(workers[0].getStats().leaders).toBe(1);
+  });
+
+  test('computes uncoordinated while Redis is unreachable', async () => {
+    const client = store.client();
+    const unreachable = () => Promise.reject(new Error('connect ECONNREFUSED'));
+    client.get = unreachable as never;
+    client.set = unreachable as never;
+    const worker = new SingleFlight(client, store.client(), { leaseMs: 300 });
+
+    await expect(worker.doCached('offline', 60, async () => 'computed')).resolves.toBe('computed');
+    expect(worker.getStats().bypassed).toBe(1);
+  });
+
+  test('returns the result when releasing the lease fails', async () => {
+    const client = store.client();
+    client.eval = (() => Promise.reject(new Error('connection lost'))) as never;
+    client.publish = (() => Promise.reject(new Error('connection lost'))) as never;
+    const worker = new SingleFlight(client, store.client(), { leaseMs: 300 });
+
+    await expect(worker.doCached('released', 60, async () => 'computed')).resolves.toBe('computed');
+    expect(worker.getStats().leaders).toBe(1);
+  });
+});
+
+describe('CardGenerator with SingleFlight', () => {
+  test('calls the model once per content across workers', async () => {
+    const store = new InMemoryRedisStore();
+    const openaiClient = {
+      createChatCompletion: jest.fn().mockImplementation(async () => {
+        await delay(50);
+        return {
+          data: {
+            choices: [{ message: { content: JSON.stringify([{ front: 'What is shared?', back: 'One generation for everyone' }]) } }],
+            usage: { total_tokens: 100 }
+          }
+        };
+      })
+    };
+
+    const generators = Array.from({ length: WORKERS }, () => {
+      const cacheClient = store.client();
+      return new CardGenerator(openaiClient, cacheClient, {}, new SingleFlight(cacheClient));
+    });
+    const streamed: string[] = [];
+
+    const results = await Promise.all(generators.flatMap((generator) =>
+      Array.from({ length: 5 }, (_, i) => generator.generateFromContent(testContent, {
+        moderated: true,
+        onCard: i === 1 ? (card) => streamed.push(card.frontContent.text) : undefined
+      }))
+    ));
+
+    expect(openaiClient.createChatCompletion).toHaveBeenCalledTimes(1);
+    expect(results.every((cards) => cards[0].frontContent.text === 'What is shared?')).toBe(true);
+    // Followers replay the shared cards to their streaming callers
+    expect(streamed).toEqual(Array(WORKERS).fill('What is shared?'));
+  });
+});
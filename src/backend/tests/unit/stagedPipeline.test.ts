@@ -0,0 +1,143 @@
+/**
+ * @fileoverview Unit tests for the staged processing pipeline
+ * Verifies per-stage concurrency limits, fan-out ordering, backpressure and failure isolation
+ * @version 1.0.0
+ */
+
+import { PipelineObserver, PipelineStage, StagedPipeline } from '../../src/core/pipeline/stagedPipeline';
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Stage that records its peak parallelism
+ */
+const trackedStage = <I, O>(
+  name: string,
+  concurrency: number,
+  run: (item: I) => O | Promise<O>,
+  options: Partial<PipelineStage> = {}
+) => {
+  const stats = { active: 0, peak: 0, calls: 0 };
+  const stage: PipelineStage<I, O> = {
+    name,
+    concurrency,
+    ...options,
+    run: async (item: I) => {
+      stats.calls++;
+      stats.active++;
+      stats.peak = Math.max(stats.peak, stats.active);
+      try {
+        await delay(5);
+        return await run(item);
+      } finally {
+        stats.active--;
+      }
+    }
+  };
+  return { stage, stats };
+};
+
+describe('StagedPipeline', () => {
+  test('runs items through every stage', async () => {
+    const double = trackedStage('double', 2, (n: number) => n * 2);
+    const label = trackedStage('label', 2, (n: number) => `#${n}`);
+    const pipeline = new StagedPipeline<number, string>([double.stage, label.stage]);
+
+    await expect(pipeline.process(21)).resolves.toEqual(['#42']);
+  });
+
+  test('fans out items and returns results in input order', async () => {
+    const split = trackedStage('split', 1, (text: string) => text.split(' '), { fanOut: true });
+    // Later items finish first
+    const slow = trackedStage('slow', 4, async (word: string) => {
+      await delay(40 - word.length * 5);
+      return word.toUpperCase();
+    });
+    const pipeline = new StagedPipeline<string, string>([split.stage, slow.stage]);
+
+    await expect(pipeline.process('a bb ccc dddd')).resolves.toEqual(['A', 'BB', 'CCC', 'DDDD']);
+    expect(slow.stats.peak).toBeGreaterThan(1);
+  });
+
+  test('never exceeds stage concurrency', async () => {
+    const fan = trackedStage('fan', 2, (n: number) => Array.from({ length: n }, (_, i) => i), { fanOut: true });
+    const work = trackedStage('work', 3, (n: number) => n);
+    const pipeline = new StagedPipeline<number, number>([fan.stage, work.stage]);
+
+    const results = await Promise.all(Array.from({ length: 10 }, () => pipeline.process(8)));
+
+    expect(results.every((items) => items.length === 8)).toBe(true);
+    expect(fan.stats.peak).toBeLessThanOrEqual(2);
+    expect(work.stats.peak).toBe(3);
+  });
+
+  test('holds submitters while downstream queues are full', async () => {
+    let release!: () => void;
+    const gate = new Promise<void>((resolve) => { release = resolve; });
+    const first = trackedStage('first', 1, (n: number) => n, { queueLimit: 1 });
+    const blocked = trackedStage('blocked', 1, async (n: number) => { await gate; return n; }, { queueLimit: 1 });
+    const pipeline = new StagedPipeline<number, number>([first.stage, blocked.stage]);
+
+    let admitted = 0;
+    const runs = Array.from({ length: 10 }, (_, i) => pipeline.process(i).then((result) => { admitted++; return result; }));
+    await delay(50);
+
+    // One item per worker and queue slot; the rest wait at submission
+    expect(first.stats.calls).toBeLessThanOrEqual(3);
+    expect(admitted).toBe(0);
+    const stats = pipeline.getStats();
+    expect(stats.blocked.waiting).toBe(1);
+    expect(stats.blocked.active).toBe(1);
+
+    release();
+    await expect(Promise.all(runs)).resolves.toEqual(Array.from({ length: 10 }, (_, i) => [i]));
+  });
+
+  test('fails only the job whose item failed', async () => {
+    const fan = trackedStage('fan', 2, (n: number) => [n, n + 1, n + 2], { fanOut: true });
+    const check = trackedStage('check', 2, (n: number) => {
+      if (n === 12) {
+        throw new Error('bad item');
+      }
+      return n;
+    });
+    const pipeline = new StagedPipeline<number, number>([fan.stage, check.stage]);
+
+    const [failed, ok] = await Promise.allSettled([pipeline.process(10), pipeline.process(20)]);
+
+    expect(failed.status).toBe('rejected');
+    expect((failed as PromiseRejectedResult).reason.message).toBe('bad item');
+    expect(ok).toEqual({ status: 'fulfilled', value: [20, 21, 22] });
+    expect(pipeline.getStats().check.failed).toBe(1);
+  });
+
+  test('resolves with no results when a stage drops the item', async () => {
+    const drop = trackedStage('drop', 1, () => [] as number[], { fanOut: true });
+    const never = trackedStage('never', 1, (n: number) => n);
+    const pipeline = new StagedPipeline<number, number>([drop.stage, never.stage]);
+
+    await expect(pipeline.process(1)).resolves.toEqual([]);
+    expect(never.stats.calls).toBe(0);
+  });
+
+  test('reports stage latency and queue depth', async () => {
+    const completed: string[] = [];
+    const depths: number[] = [];
+    const observer: PipelineObserver = {
+      stageCompleted: (stage, durationMs, failed) => completed.push(`${stage}:${failed}:${durationMs >= 0}`),
+      queueDepth: (_stage, waiting) => depths.push(waiting)
+    };
+    const only = trackedStage('only', 1, (n: number) => n);
+    const pipeline = new StagedPipeline<number, number>([only.stage], observer);
+
+    await Promise.all([pipeline.process(1), pipeline.process(2)]);
+
+    expect(completed).toEqual(['only:false:true', 'only:false:true']);
+    expect(Math.max(...depths)).toBe(1);
+  });
+
+  test('rejects invalid stage configuration', () => {
+    expect(() => new StagedPipeline([])).toThrow('at least one stage');
+    expect(() => new StagedPipeline([{ name: 'bad', concurrency: 0, run: async () => 0 }])).toThrow('concurrency');
+  });
+});
@@ -0,0 +1,69 @@
+/**
+ * @fileoverview Unit tests for the incremental JSON array parser
+ * Verifies element emission across arbitrary fragment boundaries, string handling and recovery
+ * @version 1.0.0
+ */
+
+import { StreamingJsonArrayParser } from '../../src/core/ai/streamingJsonParser';
+
+const CARDS = [
+  { front: 'What does {x} mean?', back: 'A placeholder in "braces" like } or ]' },
+  { front: 'Escapes', back: 'Backslash \\ then quote \\" stays inside' },
+  { front: 'Nested', back: 'ok', hints: [{ level: 1 }, { level: 2 }] }
+];
+
+const parseInFragments = (text: string, size: number) => {
+  const parser = new StreamingJsonArrayParser();
+  const elements: unknown[] = [];
+  for (let i = 0; i < text.length; i += size) {
+    elements.push(...parser.push(text.slice(i, i + size)));
+  }
+  return { parser, elements };
+};
+
+describe('StreamingJsonArrayParser', () => {
+  test('emits the same elements for every fragment size', () => {
+    const text = JSON.stringify(CARDS, null, 2);
+
+    for (let size = 1; size <= text.length; size++) {
+      const { parser, elements } = parseInFragments(text, size);
+      expect(elements).toEqual(CARDS);
+      expect(parser.isComplete).toBe(true);
+    }
+  });
+
+  test('emits each element as soon as it closes', () => {
+    const parser = new StreamingJsonArrayParser();
+
+    expect(parser.push('[{"front": "a", "ba')).toEqual([]);
+    expect(parser.push('ck": "b"}, {"front"')).toEqual([{ front: 'a', back: 'b' }]);
+    expect(parser.push(': "c", "back": "d"}')).toEqual([{ front: 'c', back: 'd' }]);
+    expect(parser.isComplete).toBe(false);
+    expect(parser.push(']')).toEqual([]);
+    expect(parser.isComplete).toBe(true);
+  });
+
+  test('ignores text around the array', () => {
+    const { parser, elements } = parseInFragments(
+      'Here are your cards:\n```json\n[{"front": "q", "back": "a"}]\n```\nDone [{"front": "ignored"}]',
+      5
+    );
+
+    expect(elements).toEqual([{ front: 'q', back: 'a' }]);
+    expect(parser.isComplete).toBe(true);
+  });
+
+  test('skips malformed and non-object elements', () => {
+    const { parser, elements } = parseInFragments('[1, "two", {"front": bad}, {"front": "ok", "back": "fine"}]', 4);
+
+    expect(elements).toEqual([{ front: 'ok', back: 'fine' }]);
+    expect(parser.malformedCount).toBe(1);
+  });
+
+  test('reports an unterminated array as incomplete', () => {
+    const { parser, elements } = parseInFragments('[{"front": "q", "back": "a"}, {"front": "cut', 3);
+
+    expect(elements).toHaveLength(1);
+    expect(parser.isComplete).toBe(false);
+  });
+});
@@ -0,0 +1,90 @@
+/**
+ * @fileoverview Unit tests for the study service as the API router builds it
+ * Verifies quiz sessions draw their questions from the precomputed question bank
+ * @version 1.0.0
+ */
+
+import { ICard, ContentType } from '../../src/interfaces/ICard';
+import { IQuizQuestion } from '../../src/interfaces/IQuestionBank';
+import { Card } from '../../src/models/Card';
+import { QuestionBankService } from '../../src/services/QuestionBankService';
+import { StudyService } from '../../src/services/StudyService';
+import { StudyModes } from '../../src/constants/studyModes';
+import { createMockCard, TEST_USER_ID } from '../utils/testHelpers';
+
+jest.mock('bull', () => jest.fn().mockImplementation(() => ({
+  process: jest.fn(),
+  on: jest.fn(),
+  add: jest.fn().mockResolvedValue(undefined)
+})));
+jest.mock('../../src/config/logger', () => ({ logger: { error: jest.fn(), warn: jest.fn() } }));
+jest.mock('../../src/core/monitoring/PerformanceMonitor', () => ({
+  performanceMonitor: { recordPipelineStage: jest.fn(), trackQuestionBankRefresh: jest.fn() }
+}));
+
+const CONTENT_ID = 'content-1';
+
+const deck: ICard[] = [
+  ['a', 'What is the powerhouse of the cell?', 'Mitochondria'],
+  ['b', 'Where are proteins assembled?', 'Ribosomes'],
+  ['c', 'What holds the genome?', 'Nucleus']
+].map(([id, front, back]) => createMockCard({
+  id,
+  userId: TEST_USER_ID,
+  contentId: CONTENT_ID,
+  frontContent: { text: front, type: ContentType.TEXT, metadata: {} as ICard['frontContent']['metadata'] },
+  backContent: { text: back, type: ContentType.TEXT, metadata: {} as ICard['backContent']['metadata'] }
+}));
+
+/**
+ * In-memory stand-in for the question bank tables
+ */
+const memoryBank = () => {
+  const questions = new Map<string, IQuizQuestion>();
+  return {
+    findBank: jest.fn(async () => null),
+    findCardHashes: jest.fn(async () => new Map<string, string>()),
+    saveVersion: jest.fn(async (state: unknown, written: IQuizQuestion[]) => {
+      written.forEach((question) => questions.set(question.cardId, question));
+    }),
+    sample: jest.fn(async (userId: string, count: number) => [...questions.values()].slice(0, count))
+  };
+};
+
+describe('StudyService.create', () => {
+  beforeEach(() => {
+    // Sessions arm an hour-long timeout
+    jest.useFakeTimers();
+  });
+
+  afterEach(() => {
+    jest.clearAllTimers();
+    jest.useRealTimers();
+  });
+
+  test('starts quiz sessions with questions sampled from the question bank', async () => {
+    const cardModel = {
+      findByUserId: jest.fn(async () => deck),
+      getDueCards: jest.fn(async () => deck)
+    } as unknown as Card;
+    const buildDeckQuestions = jest.fn(async (userId: string, cards: ICard[]) => cards.map((card) => ({
+      card,
+      question: {
+        question: card.frontContent.text,
+        type: 'multiple_choice',
+        options: cards.map((other) => other.backContent.text),
+        correctAnswer: card.backContent.text
+      }
+    })));
+    const bank = memoryBank();
+    const questionBank = new QuestionBankService({ buildDeckQuestions } as any, bank as any, cardModel);
+    await questionBank.refresh(CONTENT_ID, TEST_USER_ID);
+    const studyService = StudyService.create(questionBank, cardModel);
+
+    const session = await studyService.startStudySession(TEST_USER_ID, StudyModes.QUIZ, {});
+
+    expect(bank.sample).toHaveBeenCalledWith(TEST_USER_ID, expect.any(Number), undefined);
+    expect(session.quizQuestions!.map((question) => question.cardId).sort()).toEqual(['a', 'b', 'c']);
+    expect(session.quizQuestions![0].question).toBe(deck.find((card) => card.id === session.quizQuestions![0].cardId)!.frontContent.text);
+  });
+});
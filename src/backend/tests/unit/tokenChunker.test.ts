@@ -0,0 +1,130 @@
+/**
+ * @fileoverview Unit tests for the token-aware content chunker
+ * Verifies token budgets, overlap, heading boundaries and splitting of oversized paragraphs
+ * @version 1.0.0
+ */
+
+import { chunkByTokens, countTokens, TokenChunk } from '../../src/core/ai/tokenChunker';
+
+const paragraph = (topic: string, sentences: number): string =>
+  Array.from({ length: sentences }, (_, i) =>
+    `The ${topic} section covers point ${i + 1} in enough detail to be studied on its own.`
+  ).join(' ');
+
+const document = (sections: number, paragraphsPerSection: number): string =>
+  Array.from({ length: sections }, (_, s) => [
+    `## Section ${s + 1}`,
+    ...Array.from({ length: paragraphsPerSection }, (_, p) => paragraph(`s${s}p${p}`, 4))
+  ].join('\n\n')).join('\n\n');
+
+const expectWithinBudget = (chunks: TokenChunk[], targetTokens: number) => {
+  for (const chunk of chunks) {
+    expect(chunk.tokenCount).toBeLessThanOrEqual(targetTokens);
+    expect(countTokens(chunk.text)).toBeLessThanOrEqual(chunk.tokenCount);
+  }
+};
+
+describe('countTokens', () => {
+  test('counts cl100k tokens', () => {
+    expect(countTokens('')).toBe(0);
+    expect(countTokens('hello world')).toBe(2);
+  });
+
+  test('treats special-token markers as text', () => {
+    expect(() => countTokens('<|endoftext|>')).not.toThrow();
+    expect(countTokens('<|endoftext|>')).toBeGreaterThan(1);
+  });
+});
+
+describe('chunkByTokens', () => {
+  test('returns a single chunk for short content', () => {
+    const chunks = chunkByTokens('A short note. Nothing else.', { targetTokens: 100 });
+
+    expect(chunks).toHaveLength(1);
+    expect(chunks[0].text).toBe('A short note. Nothing else.');
+    expect(chunks[0].overlapTokens).toBe(0);
+  });
+
+  test('keeps every chunk within the token budget', () => {
+    const content = document(6, 5);
+    const chunks = chunkByTokens(content, { targetTokens: 200, overlapTokens: 40 });
+
+    expect(chunks.length).toBeGreaterThan(1);
+    expectWithinBudget(chunks, 200);
+  });
+
+  test('covers the content in order without gaps in new material', () => {
+    const content = document(4, 4);
+    const chunks = chunkByTokens(content, { targetTokens: 150, overlapTokens: 30 });
+
+    for (let i = 1; i < chunks.length; i++) {
+      expect(chunks[i].start).toBeGreaterThanOrEqual(chunks[i - 1].end);
+    }
+    const covered = chunks.map((chunk) => content.slice(chunk.start, chunk.end)).join(' ');
+    for (let s = 0; s < 4; s++) {
+      for (let p = 0; p < 4; p++) {
+        expect(covered).toContain(`The s${s}p${p} section covers point 4`);
+      }
+    }
+  });
+
+  test('repeats trailing context from the previous chunk within a section', () => {
+    const content = Array.from({ length: 12 }, (_, i) => paragraph(`p${i}`, 2)).join('\n\n');
+    const chunks = chunkByTokens(content, { targetTokens: 120, overlapTokens: 40 });
+
+    expect(chunks.length).toBeGreaterThan(2);
+    for (let i = 1; i < chunks.length; i++) {
+      expect(chunks[i].overlapTokens).toBeGreaterThan(0);
+      expect(chunks[i].overlapTokens).toBeLessThanOrEqual(40);
+      const repeated = chunks[i].text.split('\n\n')[0];
+      expect(chunks[i - 1].text).toContain(repeated);
+    }
+  });
+
+  test('repeats the last sentences of paragraphs longer than the overlap', () => {
+    const content = Array.from({ length: 12 }, (_, i) => paragraph(`p${i}`, 12)).join('\n\n');
+    expect(countTokens(paragraph('p0', 12))).toBeGreaterThan(100);
+    const chunks = chunkByTokens(content, { targetTokens: 1000, overlapTokens: 100 });
+
+    expect(chunks.length).toBeGreaterThan(2);
+    expectWithinBudget(chunks, 1000);
+    for (let i = 1; i < chunks.length; i++) {
+      expect(chunks[i].overlapTokens).toBeGreaterThan(0);
+      expect(chunks[i].overlapTokens).toBeLessThanOrEqual(100);
+      const repeated = chunks[i].text.split('\n\n')[0];
+      expect(repeated).toMatch(/^The p\d+ section covers point \d+/);
+      expect(chunks[i - 1].text.endsWith(repeated)).toBe(true);
+    }
+  });
+
+  test('starts sections on fresh chunks and records the heading', () => {
+    const content = document(3, 3);
+    const chunks = chunkByTokens(content, { targetTokens: 100, overlapTokens: 20 });
+
+    for (const chunk of chunks) {
+      expect(chunk.heading).toMatch(/^Section \d$/);
+      // No context is repeated from earlier sections
+      const section = Number(chunk.heading!.split(' ')[1]);
+      for (let earlier = 0; earlier < section - 1; earlier++) {
+        expect(chunk.text).not.toContain(`s${earlier}p`);
+      }
+    }
+    expect(chunks.filter((chunk) => chunk.text.startsWith('## Section'))).toHaveLength(3);
+  });
+
+  test('splits paragraphs and words larger than the budget', () => {
+    const longParagraph = paragraph('long', 40);
+    const longWord = 'x'.repeat(2000);
+    const chunks = chunkByTokens(`${longParagraph}\n\n${longWord}`, { targetTokens: 64 });
+
+    expect(chunks.length).toBeGreaterThan(5);
+    expectWithinBudget(chunks, 64);
+    expect(chunks.map((chunk) => chunk.text).join('')).toContain('x'.repeat(100));
+  });
+
+  test('rejects invalid budgets', () => {
+    expect(() => chunkByTokens('text', { targetTokens: 8 })).toThrow('Chunk token budget');
+    expect(() => chunkByTokens('text', { targetTokens: 100.5 })).toThrow('Chunk token budget');
+    expect(() => chunkByTokens('text', { targetTokens: 100, overlapTokens: 60 })).toThrow('Chunk overlap');
+  });
+});
@@ -0,0 +1,122 @@
+/**
+ * @fileoverview Unit tests for Redis token storage
+ * Verifies refresh token rotation and reuse detection, revocation, one command per flow
+ * and per-user hash tags
+ * @version 1.0.0
+ */
+
+import Redis from 'ioredis';
+import { TokenStore } from '../../src/utils/tokenStore';
+import { InMemoryRedisStore } from '../utils/inMemoryRedis';
+import { TEST_USER_ID } from '../utils/testHelpers';
+
+const inOneHour = () => Math.floor(Date.now() / 1000) + 3600;
+
+/**
+ * Store over an in-memory client that records every command it sends
+ */
+const setup = () => {
+  const client = new InMemoryRedisStore().client();
+  const commands: Array<[string, unknown[]]> = [];
+  const recording = new Proxy(client, {
+    get: (target, name: string) => (...args: unknown[]) => {
+      commands.push([name, args]);
+      return (target as any)[name](...args);
+    }
+  }) as Redis;
+  return { store: new TokenStore(recording), commands };
+};
+
+describe('TokenStore', () => {
+  test('keeps refresh tokens until they expire', async () => {
+    const { store } = setup();
+
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'current', exp: inOneHour() });
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'expired', exp: Math.floor(Date.now() / 1000) - 1 });
+
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'current')).resolves.toBe(true);
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'expired')).resolves.toBe(false);
+    await expect(store.hasRefreshToken('other-user', 'current')).resolves.toBe(false);
+  });
+
+  test('rotation replaces the refresh token and revokes the old one', async () => {
+    const { store } = setup();
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() });
+
+    await expect(store.rotateRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() }, { jti: 'second', exp: inOneHour() }))
+      .resolves.toBe('rotated');
+
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'first')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'second')).resolves.toBe(true);
+    await expect(store.isRevoked(TEST_USER_ID, 'first')).resolves.toBe(true);
+  });
+
+  test('rejects unknown refresh tokens without touching the others', async () => {
+    const { store } = setup();
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() });
+
+    await expect(store.rotateRefreshToken(TEST_USER_ID, { jti: 'forged', exp: inOneHour() }, { jti: 'next', exp: inOneHour() }))
+      .resolves.toBe('invalid');
+
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'first')).resolves.toBe(true);
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'next')).resolves.toBe(false);
+  });
+
+  test('ends every session when a rotated token is used again', async () => {
+    const { store } = setup();
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() });
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'other-device', exp: inOneHour() });
+    await store.rotateRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() }, { jti: 'second', exp: inOneHour() });
+
+    await expect(store.rotateRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() }, { jti: 'third', exp: inOneHour() }))
+      .resolves.toBe('reused');
+
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'second')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'other-device')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'third')).resolves.toBe(false);
+  });
+
+  test('logout drops the refresh token and revokes the access token', async () => {
+    const { store } = setup();
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'refresh', exp: inOneHour() });
+
+    await store.revoke(TEST_USER_ID, { jti: 'access', exp: inOneHour() }, 'refresh');
+
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'refresh')).resolves.toBe(false);
+    await expect(store.isRevoked(TEST_USER_ID, 'access')).resolves.toBe(true);
+    await expect(store.isRevoked(TEST_USER_ID, 'refresh')).resolves.toBe(false);
+  });
+
+  test('ends every session of a user', async () => {
+    const { store } = setup();
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'phone', exp: inOneHour() });
+    await store.storeRefreshToken(TEST_USER_ID, { jti: 'laptop', exp: inOneHour() });
+
+    await store.revokeAll(TEST_USER_ID);
+
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'phone')).resolves.toBe(false);
+    await expect(store.hasRefreshToken(TEST_USER_ID, 'laptop')).resolves.toBe(false);
+  });
+
+  test('sends one command per flow, on keys hash-tagged with the user', async () => {
+    const { store, commands } = setup();
+    const flows = [
+      () => store.storeRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() }),
+      () => store.rotateRefreshToken(TEST_USER_ID, { jti: 'first', exp: inOneHour() }, { jti: 'second', exp: inOneHour() }),
+      () => store.isRevoked(TEST_USER_ID, 'access'),
+      () => store.revoke(TEST_USER_ID, { jti: 'access', exp: inOneHour() }, 'second'),
+      () => store.revokeAll(TEST_USER_ID)
+    ];
+
+    for (const flow of flows) {
+      const before = commands.length;
+      await flow();
+      expect(commands.length - before).toBe(1);
+    }
+
+    const keys = commands.flatMap(([name, args]) => name === 'eval'
+      ? args.slice(2, 2 + Number(args[1]))
+      : name === 'del' ? args : [args[0]]);
+    expect(keys.every((key) => String(key).includes(`{${TEST_USER_ID}}`))).toBe(true);
+  });
+});
@@ -0,0 +1,88 @@
+/**
+ * @fileoverview Unit tests for the shared worker-thread pool
+ * Runs real worker threads and checks transfer, priority, batching and crash recovery
+ * @version 1.0.0
+ */
+
+import path from 'path';
+import { WorkerPool } from '../../src/core/workers/workerPool';
+
+const WORKER_FILE = path.join(__dirname, '../fixtures/poolWorker.js');
+const TEST_TIMEOUT = 20000;
+
+describe('WorkerPool', () => {
+  let pool: WorkerPool;
+
+  afterEach(async () => {
+    await pool.close();
+  });
+
+  test('runs named tasks on worker threads', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: 2 });
+
+    const results = await Promise.all([1, 2, 3, 4].map((value) => pool.run('echo', { value })));
+
+    expect(results).toEqual([{ value: 1 }, { value: 2 }, { value: 3 }, { value: 4 }]);
+    expect(pool.getStats()).toMatchObject({ workers: 2, completed: 4, failed: 0, queued: 0, active: 0 });
+  }, TEST_TIMEOUT);
+
+  test('falls back to the default size when the configured one is not a number', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: NaN });
+
+    await expect(pool.run('echo', { value: 1 })).resolves.toEqual({ value: 1 });
+    expect(pool.getStats().workers).toBe(1);
+  }, TEST_TIMEOUT);
+
+  test('moves transferred buffers instead of copying them', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: 1 });
+    const buffer = new Uint8Array([1, 2, 3, 4]).buffer;
+
+    const total = pool.run('sum', buffer, { transfer: [buffer] });
+
+    expect(buffer.byteLength).toBe(0);
+    await expect(total).resolves.toBe(10);
+  }, TEST_TIMEOUT);
+
+  test('runs interactive tasks before queued background tasks', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: 1, maxBatchSize: 1 });
+    const order: string[] = [];
+    const track = (label: string, task: Promise<unknown>) => task.then(() => order.push(label));
+
+    const busy = track('busy', pool.run('sleep', 100));
+    const background = track('background', pool.run('echo', 'b', { priority: 'background' }));
+    const interactive = track('interactive', pool.run('echo', 'i', { priority: 'interactive' }));
+    await Promise.all([busy, background, interactive]);
+
+    expect(order).toEqual(['busy', 'interactive', 'background']);
+  }, TEST_TIMEOUT);
+
+  test('sends a backlog of small tasks in batches', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: 1, maxBatchSize: 16 });
+    await pool.run('sleep', 50);
+    const before = pool.getStats().batches;
+
+    const busy = pool.run('sleep', 50);
+    const results = await Promise.all(Array.from({ length: 64 }, (_, i) => pool.run('echo', i)));
+    await busy;
+
+    expect(results).toEqual(Array.from({ length: 64 }, (_, i) => i));
+    expect(pool.getStats().batches - before).toBeLessThanOrEqual(5);
+  }, TEST_TIMEOUT);
+
+  test('rejects only the task whose handler throws', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: 1 });
+
+    const [failed, succeeded] = await Promise.allSettled([pool.run('fail', 'bad input'), pool.run('echo', 'ok')]);
+
+    expect(failed).toMatchObject({ status: 'rejected', reason: new Error('bad input') });
+    expect(succeeded).toEqual({ status: 'fulfilled', value: 'ok' });
+  }, TEST_TIMEOUT);
+
+  test('replaces a worker that exits and keeps serving tasks', async () => {
+    pool = new WorkerPool(WORKER_FILE, { size: 1 });
+
+    await expect(pool.run('crash', 3)).rejects.toThrow('Worker exited with code 3');
+    await expect(pool.run('echo', 'after crash')).resolves.toBe('after crash');
+    expect(pool.getStats()).toMatchObject({ workers: 1, failed: 1 });
+  }, TEST_TIMEOUT);
+});
@@ -0,0 +1,391 @@
+/**
+ * @fileoverview Minimal in-memory stand-in for an ioredis client
+ * Instances created from the same store share keys and pub/sub, so several clients can
+ * simulate separate workers talking to one Redis server
+ * @version 1.0.0
+ */
+
+import { EventEmitter } from 'events';
+import Redis from 'ioredis'; // version: ^5.0.0
+import { RENEW_LEASE_SCRIPT, RELEASE_LEASE_SCRIPT } from '../../src/utils/singleFlight';
+import { ACQUIRE_SCRIPT, FEEDBACK_SCRIPT } from '../../src/utils/concurrencyLimiter';
+import { STORE_REFRESH_SCRIPT, ROTATE_REFRESH_SCRIPT, REVOKE_SCRIPT } from '../../src/utils/tokenStore';
+import { RECORD_WRITE_SCRIPT } from '../../src/utils/walPosition';
+
+interface Entry {
+  value: string;
+  expiresAt?: number;
+}
+
+type PipelineCall = [string, unknown[]];
+
+export class InMemoryRedisStore {
+  readonly data = new Map<string, Entry>();
+  readonly sets = new Map<string, Set<string>>();
+  readonly hashes = new Map<string, Map<string, string>>();
+  readonly sortedSets = new Map<string, Map<string, number>>();
+  readonly bus = new EventEmitter();
+
+  constructor() {
+    this.bus.setMaxListeners(0);
+  }
+
+  /** Returns a new client connected to this store */
+  client(): Redis {
+    return new InMemoryRedis(this) as unknown as Redis;
+  }
+}
+
+class InMemoryRedis extends EventEmitter {
+  private readonly channels = new Set<string>();
+  private readonly forward = (channel: string, message: string) => {
+    if (this.channels.has(channel)) {
+      this.emit('message', channel, message);
+    }
+  };
+
+  constructor(private readonly store: InMemoryRedisStore) {
+    super();
+    store.bus.on('message', this.forward);
+  }
+
+  duplicate(): InMemoryRedis {
+    return new InMemoryRedis(this.store);
+  }
+
+  async get(key: string): Promise<string | null> {
+    return this.read(key)?.value ?? null;
+  }
+
+  async set(key: string, value: string, ...args: (string | number)[]): Promise<'OK' | null> {
+    const px = args.indexOf('PX');
+    if (args.includes('NX') && this.read(key)) {
+      return null;
+    }
+    this.store.data.set(key, {
+      value,
+      expiresAt: px >= 0 ? Date.now() + Number(args[px + 1]) : undefined
+    });
+    return 'OK';
+  }
+
+  async setex(key: string, seconds: number, value: string): Promise<'OK'> {
+    this.store.data.set(key, { value, expiresAt: Date.now() + seconds * 1000 });
+    return 'OK';
+  }
+
+  /** String keys only; supports patterns with a single trailing `*` */
+  async keys(pattern: string): Promise<string[]> {
+    const prefix = pattern.replace(/\*$/, '');
+    return [...this.store.data.keys()].filter((key) =>
+      (pattern.endsWith('*') ? key.startsWith(prefix) : key === pattern) && this.read(key) !== undefined);
+  }
+
+  async exists(key: string): Promise<number> {
+    return this.read(key) ? 1 : 0;
+  }
+
+  async del(...keys: string[]): Promise<number> {
+    return keys.filter((key) => {
+      const existed = this.read(key) !== undefined || this.store.hashes.has(key);
+      this.store.data.delete(key);
+      this.store.hashes.delete(key);
+      return existed;
+    }).length;
+  }
+
+  async incrby(key: string, increment: number): Promise<number> {
+    const entry = this.read(key);
+    const value = Number(entry?.value ?? 0) + Number(increment);
+    this.store.data.set(key, { value: String(value), expiresAt: entry?.expiresAt });
+    return value;
+  }
+
+  async pexpire(key: string, ms: number): Promise<number> {
+    const entry = this.read(key);
+    if (!entry) {
+      return 0;
+    }
+    entry.expiresAt = Date.now() + Number(ms);
+    return 1;
+  }
+
+  // Only plain values expire here; sets, hashes and sorted sets are kept
+  async expire(key: string, seconds: number): Promise<number> {
+    return this.pexpire(key, Number(seconds) * 1000);
+  }
+
+  /** Runs the JavaScript equivalent of one of the application's Lua scripts */
+  async eval(script: string, numKeys: number, ...args: (string | number)[]): Promise<unknown> {
+    const keys = args.slice(0, numKeys).map(String);
+    const argv = args.slice(numKeys).map(String);
+    switch (script) {
+      case RENEW_LEASE_SCRIPT:
+      case RELEASE_LEASE_SCRIPT: {
+        const entry = this.read(keys[0]);
+        if (entry?.value !== argv[0]) {
+          return 0;
+        }
+        if (script === RELEASE_LEASE_SCRIPT) {
+          return this.del(keys[0]);
+        }
+        entry.expiresAt = Date.now() + Number(argv[1]);
+        return 1;
+      }
+      case ACQUIRE_SCRIPT:
+        return this.acquireSlot(keys, argv);
+      case FEEDBACK_SCRIPT:
+        return this.limitFeedback(keys, argv);
+      case RECORD_WRITE_SCRIPT: {
+        const entry = this.read(keys[0]);
+        if (!entry || argv[0] > entry.value) {
+          await this.set(keys[0], argv[0], 'PX', argv[1]);
+        } else {
+          entry.expiresAt = Date.now() + Number(argv[1]);
+        }
+        return 1;
+      }
+      case STORE_REFRESH_SCRIPT:
+      case ROTATE_REFRESH_SCRIPT:
+      case REVOKE_SCRIPT:
+        return this.tokenScript(script, keys, argv);
+      default:
+        throw new Error('Unsupported script');
+    }
+  }
+
+  async sadd(key: string, ...members: string[]): Promise<number> {
+    const set = this.store.sets.get(key) ?? new Set<string>();
+    this.store.sets.set(key, set);
+    const before = set.size;
+    members.forEach((member) => set.add(member));
+    return set.size - before;
+  }
+
+  async smembers(key: string): Promise<string[]> {
+    return [...(this.store.sets.get(key) ?? [])];
+  }
+
+  async srem(key: string, ...members: string[]): Promise<number> {
+    const set = this.store.sets.get(key);
+    return members.filter((member) => set?.delete(member)).length;
+  }
+
+  async hset(key: string, field: string, value: string): Promise<number> {
+    const hash = this.store.hashes.get(key) ?? new Map<string, string>();
+    this.store.hashes.set(key, hash);
+    const added = hash.has(field) ? 0 : 1;
+    hash.set(field, value);
+    return added;
+  }
+
+  async hget(key: string, field: string): Promise<string | null> {
+    return this.store.hashes.get(key)?.get(field) ?? null;
+  }
+
+  async hmget(key: string, ...fields: string[]): Promise<(string | null)[]> {
+    const hash = this.store.hashes.get(key);
+    return fields.map((field) => hash?.get(field) ?? null);
+  }
+
+  async hdel(key: string, ...fields: string[]): Promise<number> {
+    const hash = this.store.hashes.get(key);
+    return fields.filter((field) => hash?.delete(field)).length;
+  }
+
+  async zadd(key: string, score: number, member: string): Promise<number> {
+    const zset = this.store.sortedSets.get(key) ?? new Map<string, number>();
+    this.store.sortedSets.set(key, zset);
+    const added = zset.has(member) ? 0 : 1;
+    zset.set(member, Number(score));
+    return added;
+  }
+
+  async zrem(key: string, ...members: string[]): Promise<number> {
+    const zset = this.store.sortedSets.get(key);
+    return members.filter((member) => zset?.delete(member)).length;
+  }
+
+  /** Members between two bounds; only the `[min` and `(max` forms are supported */
+  async zrangebylex(key: string, min: string, max: string): Promise<string[]> {
+    const members = [...(this.store.sortedSets.get(key)?.keys() ?? [])].sort();
+    return members.filter((member) => member >= min.slice(1) && member < max.slice(1));
+  }
+
+  async zcard(key: string): Promise<number> {
+    return this.store.sortedSets.get(key)?.size ?? 0;
+  }
+
+  /** Removes members scored at or below `max`; the minimum is always -inf here */
+  async zremrangebyscore(key: string, _min: string, max: number): Promise<number> {
+    const zset = this.store.sortedSets.get(key);
+    let removed = 0;
+    zset?.forEach((score, member) => {
+      if (score <= Number(max)) {
+        zset.delete(member);
+        removed++;
+      }
+    });
+    return removed;
+  }
+
+  /** Queues commands and runs them in order on exec, like an ioredis pipeline */
+  pipeline() {
+    const calls: PipelineCall[] = [];
+    const pipeline: any = new Proxy({}, {
+      get: (_, name: string) => name === 'exec'
+        ? async () => {
+          const results: [Error | null, unknown][] = [];
+          for (const [command, args] of calls) {
+            try {
+              results.push([null, await (this as any)[command](...args)]);
+            } catch (error) {
+              results.push([error as Error, null]);
+            }
+          }
+          return results;
+        }
+        : (...args: unknown[]) => {
+          calls.push([name, args]);
+          return pipeline;
+        }
+    });
+    return pipeline;
+  }
+
+  async publish(channel: string, message: string): Promise<number> {
+    this.store.bus.emit('message', channel, message);
+    return 1;
+  }
+
+  async subscribe(channel: string): Promise<number> {
+    this.channels.add(channel);
+    return this.channels.size;
+  }
+
+  async unsubscribe(channel: string): Promise<number> {
+    this.channels.delete(channel);
+    return this.channels.size;
+  }
+
+  disconnect(): void {
+    this.store.bus.off('message', this.forward);
+  }
+
+  // ACQUIRE_SCRIPT; each call runs without interleaving, like the Lua original
+  private acquireSlot(
+    [inflight, limitKey, pauseKey, waiting, tokensKey]: string[],
+    [id, now, leaseMs, share, initialLimit, tokens, budget, priority]: string[]
+  ): [number, number] {
+    const zset = (key: string) => {
+      const members = this.store.sortedSets.get(key) ?? new Map<string, number>();
+      this.store.sortedSets.set(key, members);
+      return members;
+    };
+    const prune = (key: string) => zset(key).forEach((score, member) => {
+      if (score <= Number(now)) {
+        zset(key).delete(member);
+      }
+    });
+
+    const pause = Number(this.read(pauseKey)?.value ?? 0);
+    if (pause > Number(now)) {
+      return [0, pause - Number(now)];
+    }
+    prune(inflight);
+    prune(waiting);
+    if (priority === 'batch' && zset(waiting).size > 0) {
+      return [0, 0];
+    }
+    const limit = Number(this.read(limitKey)?.value ?? initialLimit);
+    const capacity = Math.max(1, Math.floor(limit * Number(share)));
+    if (zset(inflight).size >= capacity) {
+      if (priority === 'interactive') {
+        zset(waiting).set(id, Number(now) + 1000);
+      }
+      return [0, 0];
+    }
+    if (Number(budget) > 0) {
+      const used = Number(this.read(tokensKey)?.value ?? 0);
+      if (used > 0 && used + Number(tokens) > Number(budget)) {
+        return [2, 0];
+      }
+      this.store.data.set(tokensKey, { value: String(used + Number(tokens)), expiresAt: Number(now) + 120000 });
+    }
+    zset(waiting).delete(id);
+    zset(inflight).set(id, Number(now) + Number(leaseMs));
+    return [1, 0];
+  }
+
+  // Token scripts; hash keys do not expire here, so expireat is skipped
+  private async tokenScript(script: string, [hashKey, revokedKey]: string[], argv: string[]): Promise<number> {
+    const hash = this.store.hashes.get(hashKey) ?? new Map<string, string>();
+    this.store.hashes.set(hashKey, hash);
+    const now = Number(script === REVOKE_SCRIPT ? 0 : argv[script === STORE_REFRESH_SCRIPT ? 2 : 4]);
+    const prune = () => hash.forEach((expiry, jti) => {
+      if (Number(expiry) <= now) {
+        hash.delete(jti);
+      }
+    });
+
+    if (script === STORE_REFRESH_SCRIPT) {
+      hash.set(argv[0], argv[1]);
+      prune();
+      return 1;
+    }
+    if (script === REVOKE_SCRIPT) {
+      hash.delete(argv[0]);
+      if (Number(argv[1]) > 0) {
+        await this.set(revokedKey, '1', 'PX', Number(argv[1]) * 1000);
+      }
+      return 1;
+    }
+
+    const [oldJti, oldExp, newJti, newExp] = argv;
+    if (!(Number(hash.get(oldJti)) > now)) {
+      if (this.read(revokedKey)) {
+        this.store.hashes.delete(hashKey);
+        return -1;
+      }
+      return 0;
+    }
+    hash.delete(oldJti);
+    if (Number(oldExp) > now) {
+      await this.set(revokedKey, '1', 'PX', (Number(oldExp) - now) * 1000);
+    }
+    hash.set(newJti, newExp);
+    prune();
+    return 1;
+  }
+
+  // FEEDBACK_SCRIPT
+  private limitFeedback(
+    [limitKey, decreasedKey, pauseKey]: string[],
+    [outcome, now, initialLimit, minLimit, maxLimit, factor, cooldownMs, retryAfterMs]: string[]
+  ): string {
+    let limit = Number(this.read(limitKey)?.value ?? initialLimit);
+    if (outcome === 'success') {
+      limit = Math.min(Number(maxLimit), limit + 1 / limit);
+    } else {
+      if (!this.read(decreasedKey)) {
+        limit = Math.max(Number(minLimit), limit * Number(factor));
+        this.store.data.set(decreasedKey, { value: now, expiresAt: Number(now) + Number(cooldownMs) });
+      }
+      const pauseUntil = Number(now) + Number(retryAfterMs);
+      if (Number(retryAfterMs) > 0 && pauseUntil > Number(this.read(pauseKey)?.value ?? 0)) {
+        this.store.data.set(pauseKey, { value: String(pauseUntil), expiresAt: pauseUntil });
+      }
+    }
+    this.store.data.set(limitKey, { value: String(limit) });
+    return String(limit);
+  }
+
+  private read(key: string): Entry | undefined {
+    const entry = this.store.data.get(key);
+    if (entry?.expiresAt !== undefined && entry.expiresAt <= Date.now()) {
+      this.store.data.delete(key);
+      return undefined;
+    }
+    return entry;
+  }
+}
@@ -0,0 +1,85 @@
+/**
+ * @fileoverview Local HTTP server imitating OpenAI's chat completions under load
+ * Answers after a configurable latency and rejects requests with 429 and retry-after
+ * headers when more than `capacity` are in flight, or at random at `throttleRate`
+ * @version 1.0.0
+ */
+
+import http from 'http';
+import { AddressInfo } from 'net';
+
+export interface MockChatServerOptions {
+  /** Concurrent requests served before the server answers 429 */
+  capacity?: number;
+  latencyMs?: number;
+  /** Uniform extra latency up to this many milliseconds */
+  jitterMs?: number;
+  /** Share of requests within capacity that are throttled anyway */
+  throttleRate?: number;
+  /** Sent as retry-after-ms on every 429 */
+  retryAfterMs?: number;
+}
+
+export interface MockChatServerStats {
+  requests: number;
+  throttled: number;
+  /** Highest number of requests served concurrently */
+  peakInFlight: number;
+}
+
+export interface MockChatServer {
+  baseURL: string;
+  stats: () => MockChatServerStats;
+  close: () => Promise<void>;
+}
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Starts a mock server on an ephemeral port. Point an OpenAI client at `baseURL`.
+ */
+export const startMockOpenAIChatServer = async (options: MockChatServerOptions = {}): Promise<MockChatServer> => {
+  const { capacity = 16, latencyMs = 300, jitterMs = 100, throttleRate = 0, retryAfterMs = 1000 } = options;
+  const stats: MockChatServerStats = { requests: 0, throttled: 0, peakInFlight: 0 };
+  let inFlight = 0;
+
+  const server = http.createServer(async (req, res) => {
+    if (req.method !== 'POST' || !req.url?.endsWith('/chat/completions')) {
+      res.writeHead(404).end();
+      return;
+    }
+    stats.requests++;
+    req.resume();
+
+    if (inFlight >= capacity || Math.random() < throttleRate) {
+      stats.throttled++;
+      res.writeHead(429, { 'Content-Type': 'application/json', 'retry-after-ms': String(retryAfterMs) });
+      res.end(JSON.stringify({ error: { message: 'Rate limit reached', type: 'rate_limit_error' } }));
+      return;
+    }
+
+    inFlight++;
+    stats.peakInFlight = Math.max(stats.peakInFlight, inFlight);
+    await delay(latencyMs + Math.random() * jitterMs);
+    inFlight--;
+
+    res.writeHead(200, { 'Content-Type': 'application/json' });
+    res.end(JSON.stringify({
+      id: 'chatcmpl-mock',
+      object: 'chat.completion',
+      created: Math.floor(Date.now() / 1000),
+      model: 'gpt-4',
+      choices: [{ index: 0, message: { role: 'assistant', content: '0.9' }, finish_reason: 'stop' }],
+      usage: { prompt_tokens: 100, completion_tokens: 50, total_tokens: 150 }
+    }));
+  });
+
+  await new Promise<void>((resolve) => server.listen(0, '127.0.0.1', resolve));
+  const { port } = server.address() as AddressInfo;
+
+  return {
+    baseURL: `http://127.0.0.1:${port}/v1`,
+    stats: () => ({ ...stats }),
+    close: () => new Promise<void>((resolve) => server.close(() => resolve()))
+  };
+};
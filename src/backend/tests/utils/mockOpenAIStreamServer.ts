@@ -0,0 +1,100 @@
+/**
+ * @fileoverview Local HTTP server imitating OpenAI's streamed chat completions
+ * Emits a JSON card array as server-sent events in small fragments with a delay per card,
+ * so tests can observe cards arriving before the completion finishes
+ * @version 1.0.0
+ */
+
+import http from 'http';
+import { AddressInfo } from 'net';
+
+export interface MockStreamCard {
+  front: string;
+  back: string;
+}
+
+export interface MockStreamOptions {
+  cards: MockStreamCard[];
+  /** Delay before each card is written */
+  cardDelayMs?: number;
+  /** Characters per streamed delta */
+  fragmentSize?: number;
+  /** End the response after this many cards without closing the array */
+  truncateAfter?: number;
+  /** Raw text written before the array, e.g. a ```json fence */
+  preamble?: string;
+}
+
+export interface MockStreamServer {
+  baseURL: string;
+  /** Number of chat completion requests received */
+  requestCount: () => number;
+  close: () => Promise<void>;
+}
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Starts a mock server on an ephemeral port. Point an OpenAI client at `baseURL`.
+ */
+export const startMockOpenAIStreamServer = async (options: MockStreamOptions): Promise<MockStreamServer> => {
+  const { cards, cardDelayMs = 50, fragmentSize = 7, truncateAfter, preamble = '' } = options;
+  let requests = 0;
+
+  const server = http.createServer(async (req, res) => {
+    if (req.method !== 'POST' || !req.url?.endsWith('/chat/completions')) {
+      res.writeHead(404).end();
+      return;
+    }
+    requests++;
+    req.resume();
+
+    res.writeHead(200, {
+      'Content-Type': 'text/event-stream',
+      'Cache-Control': 'no-cache',
+      Connection: 'keep-alive'
+    });
+
+    const send = (payload: object) => res.write(`data: ${JSON.stringify(payload)}\n\n`);
+    const sendText = (text: string) => {
+      for (let i = 0; i < text.length; i += fragmentSize) {
+        send({
+          id: 'chatcmpl-mock',
+          object: 'chat.completion.chunk',
+          created: Math.floor(Date.now() / 1000),
+          model: 'gpt-4',
+          choices: [{ index: 0, delta: { content: text.slice(i, i + fragmentSize) }, finish_reason: null }]
+        });
+      }
+    };
+
+    sendText(`${preamble}[`);
+    for (const [index, card] of cards.entries()) {
+      if (truncateAfter !== undefined && index >= truncateAfter) {
+        res.end();
+        return;
+      }
+      await delay(cardDelayMs);
+      sendText(`${index > 0 ? ',' : ''}\n  ${JSON.stringify(card)}`);
+    }
+    sendText('\n]');
+    send({
+      id: 'chatcmpl-mock',
+      object: 'chat.completion.chunk',
+      created: Math.floor(Date.now() / 1000),
+      model: 'gpt-4',
+      choices: [],
+      usage: { prompt_tokens: 100, completion_tokens: cards.length * 40, total_tokens: 100 + cards.length * 40 }
+    });
+    res.end('data: [DONE]\n\n');
+  });
+
+  await new Promise<void>((resolve) => server.listen(0, '127.0.0.1', resolve));
+  const { port } = server.address() as AddressInfo;
+
+  return {
+    baseURL: `http://127.0.0.1:${port}/v1`,
+    requestCount: () => requests,
+    close: () => new Promise<void>((resolve) => server.close(() => resolve()))
+  };
+};
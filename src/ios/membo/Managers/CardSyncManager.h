@@ -0,0 +1,78 @@
+//
+//  CardSyncManager.h
+//  membo
+//
+//  Syncs the on-device card store with the backend. Each round pushes the
+//  unacknowledged local review log, applies other devices' reviews and
+//  upserts cards changed on the server, so offline study starts from the
+//  user's full deck and converges across devices.
+//
+
+#import <Foundation/Foundation.h>
+#import "Utils/CardStore.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Error domain for sync failures
+extern NSString *const MBCardSyncErrorDomain;
+
+/**
+ * Error codes for sync operations.
+ */
+typedef NS_ENUM(NSInteger, MBCardSyncError) {
+    /// No endpoint configured or the card store is unavailable
+    MBCardSyncErrorNotConfigured = 2101,
+    /// The server rejected the request or returned an unreadable body
+    MBCardSyncErrorBadResponse = 2102
+};
+
+/// Result keys: entries pushed, remote entries applied, cards upserted
+extern NSString *const MBCardSyncPushedKey;
+extern NSString *const MBCardSyncPulledKey;
+extern NSString *const MBCardSyncCardsKey;
+
+/**
+ * Exchanges review-log deltas between the card store and the backend.
+ */
+@interface MBCardSyncManager : NSObject
+
+/**
+ * Returns the manager of the shared card store.
+ */
++ (instancetype)sharedManager;
+
+/**
+ * Creates a manager over a store.
+ *
+ * @param store Card store to sync
+ * @param session Session the sync requests run on
+ * @param defaults Where the device ID and card cursor are kept
+ */
+- (instancetype)initWithStore:(nullable MBCardStore *)store
+                      session:(NSURLSession *)session
+                     defaults:(NSUserDefaults *)defaults NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Sets the sync endpoint and credentials used by later syncs.
+ *
+ * @param url Backend card sync endpoint
+ * @param authToken Bearer token for the request, if any
+ */
+- (void)configureWithURL:(NSURL *)url authToken:(nullable NSString *)authToken;
+
+/**
+ * Runs sync rounds until the device has caught up. A sync requested while
+ * one is running joins it instead of starting another.
+ *
+ * @param completion Called on the manager's queue with the totals of the
+ *                   sync, or the error that stopped it
+ */
+- (void)syncWithCompletion:(nullable void (^)(NSDictionary<NSString *, NSNumber *> *_Nullable totals,
+                                              NSError *_Nullable error))completion;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,303 @@
+//
+//  CardSyncManager.m
+//  membo
+//
+//  One sync round is one POST. Remote reviews are applied before changed
+//  cards are upserted: a server card already carries those reviews, and the
+//  store's upsert only takes its schedule when it is at least as recent as
+//  the local one.
+//
+
+#import "CardSyncManager.h"
+
+NSString *const MBCardSyncErrorDomain = @"ai.membo.cardsync";
+NSString *const MBCardSyncPushedKey = @"pushed";
+NSString *const MBCardSyncPulledKey = @"pulled";
+NSString *const MBCardSyncCardsKey = @"cards";
+
+static NSString *const kDeviceIdKey = @"ai.membo.cardsync.deviceId";
+static NSString *const kCardsSinceKey = @"ai.membo.cardsync.cardsSince";
+
+// Local reviews per request; matches the backend's per-request limit
+static const NSUInteger kSyncPushLimit = 500;
+
+// Upper bound on rounds per sync so a stuck cursor cannot loop forever
+static const NSUInteger kSyncMaxRounds = 20;
+
+#pragma mark - Helpers
+
+static inline NSNumber *_Nullable MBSyncNumber(id value) {
+    return [value isKindOfClass:[NSNumber class]] ? value : nil;
+}
+
+static inline NSString *_Nullable MBSyncString(id value) {
+    return [value isKindOfClass:[NSString class]] ? value : nil;
+}
+
+static inline NSDate *_Nullable MBSyncDate(id value) {
+    NSNumber *millis = MBSyncNumber(value);
+    return millis ? [NSDate dateWithTimeIntervalSince1970:millis.doubleValue / 1000.0] : nil;
+}
+
+/// Card from a sync response, or nil when required fields are missing
+static MBCardRecord *_Nullable MBSyncCardRecord(NSDictionary *json) {
+    NSString *cardId = MBSyncString(json[@"id"]);
+    NSDate *dueAt = MBSyncDate(json[@"dueAt"]);
+    if (!cardId || !dueAt) {
+        return nil;
+    }
+
+    MBCardRecord *card = [[MBCardRecord alloc] init];
+    card.cardId = cardId;
+    card.contentId = MBSyncString(json[@"contentId"]);
+    card.front = MBSyncString(json[@"front"]) ?: @"";
+    card.back = MBSyncString(json[@"back"]) ?: @"";
+    card.stability = MBSyncNumber(json[@"stability"]).doubleValue ?: card.stability;
+    card.difficulty = MBSyncNumber(json[@"difficulty"]).doubleValue ?: card.difficulty;
+    card.reviewCount = MBSyncNumber(json[@"reviewCount"]).integerValue;
+    card.lastRating = MBSyncNumber(json[@"lastRating"]).integerValue;
+    card.lastReviewAt = MBSyncDate(json[@"lastReviewAt"]);
+    card.dueAt = dueAt;
+    return card;
+}
+
+/// Review from a sync response, or nil when required fields are missing
+static MBReviewLogEntry *_Nullable MBSyncReviewEntry(NSDictionary *json) {
+    NSNumber *sequence = MBSyncNumber(json[@"sequence"]);
+    NSString *cardId = MBSyncString(json[@"cardId"]);
+    NSDate *reviewedAt = MBSyncDate(json[@"reviewedAt"]);
+    NSDate *dueAt = MBSyncDate(json[@"dueAt"]);
+    if (!sequence || !cardId || !reviewedAt || !dueAt) {
+        return nil;
+    }
+
+    MBReviewLogEntry *entry = [[MBReviewLogEntry alloc] init];
+    entry.sequence = sequence.longLongValue;
+    entry.cardId = cardId;
+    entry.rating = MBSyncNumber(json[@"rating"]).integerValue;
+    entry.reviewedAt = reviewedAt;
+    entry.stability = MBSyncNumber(json[@"stability"]).doubleValue;
+    entry.difficulty = MBSyncNumber(json[@"difficulty"]).doubleValue;
+    entry.dueAt = dueAt;
+    return entry;
+}
+
+static NSError *MBSyncError(MBCardSyncError code, NSString *description) {
+    return [NSError errorWithDomain:MBCardSyncErrorDomain
+                               code:code
+                           userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+#pragma mark - Manager
+
+typedef void (^MBCardSyncCompletion)(NSDictionary<NSString *, NSNumber *> *_Nullable totals,
+                                     NSError *_Nullable error);
+
+@interface MBCardSyncManager ()
+
+@property (nonatomic, strong, nullable) MBCardStore *store;
+@property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong) NSUserDefaults *defaults;
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong, nullable) NSURL *syncURL;
+@property (nonatomic, copy, nullable) NSString *authToken;
+/// Completions of the running sync; nil while idle
+@property (nonatomic, strong, nullable) NSMutableArray<MBCardSyncCompletion> *waiters;
+
+@end
+
+@implementation MBCardSyncManager
+
++ (instancetype)sharedManager {
+    static MBCardSyncManager *sharedManager = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        configuration.timeoutIntervalForRequest = 30;
+        sharedManager = [[MBCardSyncManager alloc] initWithStore:[MBCardStore sharedStore]
+                                                         session:[NSURLSession sessionWithConfiguration:configuration]
+                                                        defaults:[NSUserDefaults standardUserDefaults]];
+    });
+    return sharedManager;
+}
+
+- (instancetype)initWithStore:(nullable MBCardStore *)store
+                      session:(NSURLSession *)session
+                     defaults:(NSUserDefaults *)defaults {
+    self = [super init];
+    if (self) {
+        _store = store;
+        _session = session;
+        _defaults = defaults;
+        _queue = dispatch_queue_create("ai.membo.cardsync", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)configureWithURL:(NSURL *)url authToken:(nullable NSString *)authToken {
+    dispatch_async(self.queue, ^{
+        self.syncURL = url;
+        self.authToken = authToken;
+    });
+}
+
+- (void)syncWithCompletion:(nullable MBCardSyncCompletion)completion {
+    dispatch_async(self.queue, ^{
+        BOOL running = self.waiters != nil;
+        if (!running) {
+            self.waiters = [NSMutableArray array];
+        }
+        if (completion) {
+            [self.waiters addObject:completion];
+        }
+        if (running) {
+            return;
+        }
+
+        if (!self.store || !self.syncURL) {
+            [self finishWithTotals:nil error:MBSyncError(MBCardSyncErrorNotConfigured, @"Card sync is not configured")];
+            return;
+        }
+        NSMutableDictionary<NSString *, NSNumber *> *totals = [@{
+            MBCardSyncPushedKey: @0, MBCardSyncPulledKey: @0, MBCardSyncCardsKey: @0
+        } mutableCopy];
+        [self runRound:0 totals:totals];
+    });
+}
+
+#pragma mark - Private Methods
+
+/// Runs on _queue
+- (void)runRound:(NSUInteger)round totals:(NSMutableDictionary<NSString *, NSNumber *> *)totals {
+    NSError *error = nil;
+    NSArray<MBReviewLogEntry *> *pending = [self.store pendingReviewsWithLimit:kSyncPushLimit error:&error];
+    if (!pending) {
+        [self finishWithTotals:nil error:error];
+        return;
+    }
+
+    NSMutableArray<NSDictionary *> *reviews = [NSMutableArray arrayWithCapacity:pending.count];
+    for (MBReviewLogEntry *entry in pending) {
+        [reviews addObject:[entry dictionaryRepresentation]];
+    }
+    NSDictionary *body = @{
+        @"deviceId": [self deviceId],
+        @"reviews": reviews,
+        @"cursor": @([self.store lastRemoteSequence]),
+        @"cardsSince": @([self.defaults doubleForKey:kCardsSinceKey])
+    };
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:self.syncURL];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = [NSJSONSerialization dataWithJSONObject:body options:0 error:nil];
+    [request setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+    [request setValue:@"ios" forHTTPHeaderField:@"X-Membo-Platform"];
+    if (self.authToken.length) {
+        [request setValue:[@"Bearer " stringByAppendingString:self.authToken]
+       forHTTPHeaderField:@"Authorization"];
+    }
+
+    [[self.session dataTaskWithRequest:request
+                     completionHandler:^(NSData *data, NSURLResponse *response, NSError *requestError) {
+        dispatch_async(self.queue, ^{
+            NSInteger status = [response isKindOfClass:[NSHTTPURLResponse class]]
+                ? ((NSHTTPURLResponse *)response).statusCode : 0;
+            if (requestError || status != 200) {
+                [self finishWithTotals:nil error:requestError ?: MBSyncError(MBCardSyncErrorBadResponse,
+                    [NSString stringWithFormat:@"Sync failed with status %ld", (long)status])];
+                return;
+            }
+
+            NSError *applyError = nil;
+            BOOL hasMore = NO;
+            if (![self applyResponse:data pushed:pending.count totals:totals hasMore:&hasMore error:&applyError]) {
+                [self finishWithTotals:nil error:applyError];
+                return;
+            }
+
+            if (hasMore && round + 1 < kSyncMaxRounds) {
+                [self runRound:round + 1 totals:totals];
+            } else {
+                [self finishWithTotals:totals error:nil];
+            }
+        });
+    }] resume];
+}
+
+/// Runs on _queue. Acknowledges the push, then applies the pulled delta.
+- (BOOL)applyResponse:(NSData *)data
+               pushed:(NSUInteger)pushedCount
+               totals:(NSMutableDictionary<NSString *, NSNumber *> *)totals
+              hasMore:(BOOL *)hasMore
+                error:(NSError **)error {
+    id json = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+    NSDictionary *result = [json isKindOfClass:[NSDictionary class]] ? json[@"data"] : nil;
+    if (![result isKindOfClass:[NSDictionary class]]) {
+        if (error) {
+            *error = MBSyncError(MBCardSyncErrorBadResponse, @"Unreadable sync response");
+        }
+        return NO;
+    }
+
+    int64_t acknowledged = MBSyncNumber(result[@"acknowledged"]).longLongValue;
+    if (acknowledged > 0 && ![self.store acknowledgeReviewsThroughSequence:acknowledged error:error]) {
+        return NO;
+    }
+
+    NSMutableArray<MBReviewLogEntry *> *remote = [NSMutableArray array];
+    for (id entry in [result[@"reviews"] isKindOfClass:[NSArray class]] ? result[@"reviews"] : @[]) {
+        MBReviewLogEntry *review = [entry isKindOfClass:[NSDictionary class]] ? MBSyncReviewEntry(entry) : nil;
+        if (review) {
+            [remote addObject:review];
+        }
+    }
+    NSInteger applied = remote.count ? [self.store applyRemoteReviews:remote error:error] : 0;
+    if (applied < 0) {
+        return NO;
+    }
+
+    NSMutableArray<MBCardRecord *> *cards = [NSMutableArray array];
+    for (id entry in [result[@"cards"] isKindOfClass:[NSArray class]] ? result[@"cards"] : @[]) {
+        MBCardRecord *card = [entry isKindOfClass:[NSDictionary class]] ? MBSyncCardRecord(entry) : nil;
+        if (card) {
+            [cards addObject:card];
+        }
+    }
+    if (cards.count && ![self.store upsertCards:cards error:error]) {
+        return NO;
+    }
+
+    // The card cursor only moves once the cards it covers are stored
+    NSNumber *cardsSyncedAt = MBSyncNumber(result[@"cardsSyncedAt"]);
+    if (cardsSyncedAt) {
+        [self.defaults setDouble:cardsSyncedAt.doubleValue forKey:kCardsSinceKey];
+    }
+
+    totals[MBCardSyncPushedKey] = @(totals[MBCardSyncPushedKey].integerValue + (NSInteger)pushedCount);
+    totals[MBCardSyncPulledKey] = @(totals[MBCardSyncPulledKey].integerValue + applied);
+    totals[MBCardSyncCardsKey] = @(totals[MBCardSyncCardsKey].integerValue + (NSInteger)cards.count);
+
+    *hasMore = [MBSyncNumber(result[@"hasMore"]) boolValue] || pushedCount == kSyncPushLimit;
+    return YES;
+}
+
+/// Runs on _queue
+- (void)finishWithTotals:(nullable NSDictionary<NSString *, NSNumber *> *)totals error:(nullable NSError *)error {
+    NSArray<MBCardSyncCompletion> *waiters = self.waiters;
+    self.waiters = nil;
+    for (MBCardSyncCompletion completion in waiters) {
+        completion(totals ? [totals copy] : nil, error);
+    }
+}
+
+/// Stable per install, like the local review log the server keys pushes by
+- (NSString *)deviceId {
+    NSString *deviceId = [self.defaults stringForKey:kDeviceIdKey];
+    if (!deviceId) {
+        deviceId = [NSUUID UUID].UUIDString;
+        [self.defaults setObject:deviceId forKey:kDeviceIdKey];
+    }
+    return deviceId;
+}
+
+@end
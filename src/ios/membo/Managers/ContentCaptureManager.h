@@ -62,7 +62,9 @@ extern NSString *const kContentCaptureErrorDomain;
               completion:(void (^)(BOOL success, NSError * _Nullable error))completion;
 
 /**
- * Captures and processes Kindle book highlights asynchronously
+ * Captures and processes Kindle book highlights asynchronously. Highlights
+ * already captured for the book are skipped; if none are new, completes
+ * successfully without saving anything.
  *
  * @param highlights Array of highlight dictionaries
  * @param bookTitle Title of the Kindle book
@@ -72,6 +74,17 @@ extern NSString *const kContentCaptureErrorDomain;
                   bookTitle:(NSString *)bookTitle
                 completion:(void (^)(BOOL success, NSError * _Nullable error))completion;
 
+/**
+ * Incrementally imports a Kindle "My Clippings.txt" export. The file is
+ * streamed, highlights are deduplicated per book against everything captured
+ * before, and only new highlights are saved, in per-book batches.
+ *
+ * @param fileURL File URL of the export
+ * @param completion Block called with counts (imported, skipped, books) or an error
+ */
+- (void)importKindleClippingsAtURL:(NSURL *)fileURL
+                        completion:(void (^)(NSDictionary * _Nullable summary, NSError * _Nullable error))completion;
+
 /**
  * Synchronizes captured content with backend using retry logic
  *
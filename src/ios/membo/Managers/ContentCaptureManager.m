@@ -7,6 +7,8 @@
 //
 
 #import "ContentCaptureManager.h"
+#import "HighlightIndex.h"
+#import "KindleClippingsParser.h"
 
 // Error domain constant
 NSString *const kContentCaptureErrorDomain = @"ai.membo.ContentCapture";
@@ -19,6 +21,8 @@ NSString *const kContentCaptureErrorDomain = @"ai.membo.ContentCapture";
 @property (nonatomic, strong) NSOperationQueue *syncQueue;
 @property (nonatomic, strong) NSMutableDictionary *pendingOperations;
 @property (nonatomic, assign) NSInteger retryCount;
+@property (nonatomic, strong) dispatch_queue_t highlightQueue;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, MBHighlightIndex *> *highlightIndexes;
 
 @end
 
@@ -26,6 +30,7 @@ NSString *const kContentCaptureErrorDomain = @"ai.membo.ContentCapture";
 static ContentCaptureManager *sharedManager = nil;
 static const NSTimeInterval kSyncTimeout = 30.0;
 static const NSInteger kMaxRetryAttempts = 3;
+static const NSUInteger kKindleImportBatchSize = 500;
 
 @implementation ContentCaptureManager
 
@@ -47,6 +52,8 @@ static const NSInteger kMaxRetryAttempts = 3;
         _syncQueue.maxConcurrentOperationCount = 1;
         _pendingOperations = [NSMutableDictionary new];
         _retryCount = 0;
+        _highlightQueue = dispatch_queue_create("ai.membo.highlights", DISPATCH_QUEUE_SERIAL);
+        _highlightIndexes = [NSMutableDictionary new];
         
         // Register for memory warning notifications
         [[NSNotificationCenter defaultCenter] addObserver:self
@@ -172,44 +179,165 @@ static const NSInteger kMaxRetryAttempts = 3;
         return;
     }
     
-    NSString *fileName = [NSString stringWithFormat:@"kindle_%@_%@",
-                         bookTitle,
-                         [[NSUUID UUID] UUIDString]];
+    dispatch_async(self.highlightQueue, ^{
+        NSError *indexError = nil;
+        MBHighlightIndex *index = [self highlightIndexForBookTitle:bookTitle error:&indexError];
+        if (!index) {
+            self.lastError = indexError;
+            if (completion) completion(NO, indexError);
+            return;
+        }
+        
+        NSNumber *captureDate = @([[NSDate date] timeIntervalSince1970]);
+        NSMutableArray *newHighlights = [NSMutableArray array];
+        NSMutableData *fingerprints = [NSMutableData data];
+        NSMutableSet<NSNumber *> *seen = [NSMutableSet set];
+        
+        for (NSDictionary *highlight in highlights) {
+            NSString *text = [highlight isKindOfClass:[NSDictionary class]] ? highlight[@"text"] : nil;
+            if (![text isKindOfClass:[NSString class]] || !text.length) {
+                continue;
+            }
+            const char *utf8 = text.UTF8String;
+            uint64_t fingerprint = MBHighlightFingerprint(utf8, strlen(utf8));
+            if ([seen containsObject:@(fingerprint)] || [index containsFingerprint:fingerprint]) {
+                continue;
+            }
+            [seen addObject:@(fingerprint)];
+            
+            NSMutableDictionary *processed = [highlight mutableCopy];
+            // Keep the highlight's own time when the caller provides one
+            if (!processed[@"timestamp"]) {
+                processed[@"timestamp"] = captureDate;
+            }
+            processed[@"fingerprint"] = [NSString stringWithFormat:@"%016llx", fingerprint];
+            [newHighlights addObject:processed];
+            [fingerprints appendBytes:&fingerprint length:sizeof(fingerprint)];
+        }
+        
+        if (!newHighlights.count) {
+            if (completion) completion(YES, nil);
+            return;
+        }
+        [self saveKindleHighlights:newHighlights
+                         bookTitle:bookTitle
+                            author:nil
+                      fingerprints:fingerprints
+                        completion:completion];
+    });
+}
+
+- (void)importKindleClippingsAtURL:(NSURL *)fileURL
+                        completion:(void (^)(NSDictionary * _Nullable summary, NSError * _Nullable error))completion {
     
-    NSMutableArray *processedHighlights = [NSMutableArray array];
-    for (NSDictionary *highlight in highlights) {
-        NSMutableDictionary *processed = [highlight mutableCopy];
-        processed[@"timestamp"] = @([[NSDate date] timeIntervalSince1970]);
-        [processedHighlights addObject:processed];
+    if (!fileURL.isFileURL) {
+        NSError *error = errorWithCode(MEMBO_ERROR_VALIDATION, @{
+            @"message": @"A local clippings file is required"
+        });
+        if (completion) completion(nil, error);
+        return;
     }
     
-    NSDictionary *content = @{
-        @"bookTitle": bookTitle,
-        @"highlights": processedHighlights,
-        @"captureDate": @([[NSDate date] timeIntervalSince1970])
-    };
-    
-    NSData *contentData = [NSJSONSerialization dataWithJSONObject:content
-                                                         options:0
-                                                           error:nil];
-    
-    [self.fileManager saveContent:contentData
-                       fileName:fileName
-                    completion:^(BOOL success, NSError * _Nullable error) {
-        if (success) {
-            self.pendingOperations[fileName] = @{
-                @"type": @"kindle",
-                @"bookTitle": bookTitle,
-                @"highlightCount": @(highlights.count),
-                @"timestamp": @([[NSDate date] timeIntervalSince1970])
-            };
-            [self triggerSyncIfNeeded];
-            if (completion) completion(YES, nil);
-        } else {
-            self.lastError = error;
-            if (completion) completion(NO, error);
+    dispatch_async(self.highlightQueue, ^{
+        NSMutableDictionary<NSString *, NSMutableArray *> *batches = [NSMutableDictionary dictionary];
+        NSMutableDictionary<NSString *, NSMutableData *> *batchFingerprints = [NSMutableDictionary dictionary];
+        NSMutableDictionary<NSString *, NSString *> *authors = [NSMutableDictionary dictionary];
+        NSMutableSet<NSString *> *books = [NSMutableSet set];
+        NSNumber *captureDate = @([[NSDate date] timeIntervalSince1970]);
+        dispatch_group_t saves = dispatch_group_create();
+        
+        // Catches the same passage appearing twice within this export
+        MBFingerprintSet *seen = MBFingerprintSetCreate(kKindleImportBatchSize);
+        __block NSUInteger imported = 0;
+        __block NSUInteger skipped = 0;
+        __block NSError *firstError = nil;
+        
+        void (^flush)(NSString *) = ^(NSString *bookTitle) {
+            NSArray *batch = batches[bookTitle];
+            NSData *fingerprints = batchFingerprints[bookTitle];
+            [batches removeObjectForKey:bookTitle];
+            [batchFingerprints removeObjectForKey:bookTitle];
+            
+            dispatch_group_enter(saves);
+            [self saveKindleHighlights:batch
+                             bookTitle:bookTitle
+                                author:authors[bookTitle]
+                          fingerprints:fingerprints
+                            completion:^(BOOL success, NSError * _Nullable error) {
+                if (success) {
+                    imported += batch.count;
+                } else if (!firstError) {
+                    firstError = error;
+                }
+                dispatch_group_leave(saves);
+            }];
+        };
+        
+        NSError *parseError = nil;
+        BOOL parsed = seen && [MBKindleClippingsParser parseFileAtURL:fileURL
+                                                              handler:^(MBKindleClipping *clipping, BOOL *stop) {
+            // Notes and bookmarks are not captured
+            if (clipping.kind != MBClippingKindHighlight || !clipping.text.length) {
+                return;
+            }
+            NSString *bookTitle = clipping.bookTitle.length ? clipping.bookTitle : @"Unknown";
+            NSError *indexError = nil;
+            MBHighlightIndex *index = [self highlightIndexForBookTitle:bookTitle error:&indexError];
+            if (!index) {
+                firstError = firstError ?: indexError;
+                *stop = YES;
+                return;
+            }
+            
+            const char *title = bookTitle.UTF8String;
+            uint64_t importKey = clipping.fingerprint ^ (MBHighlightFingerprint(title, strlen(title)) * 0x9e3779b97f4a7c15ULL);
+            if (!MBFingerprintSetInsert(seen, importKey) || [index containsFingerprint:clipping.fingerprint]) {
+                skipped++;
+                return;
+            }
+            
+            [books addObject:bookTitle];
+            if (clipping.author && !authors[bookTitle]) {
+                authors[bookTitle] = clipping.author;
+            }
+            NSMutableArray *batch = batches[bookTitle] ?: (batches[bookTitle] = [NSMutableArray array]);
+            NSMutableData *fingerprints = batchFingerprints[bookTitle] ?: (batchFingerprints[bookTitle] = [NSMutableData data]);
+            
+            uint64_t fingerprint = clipping.fingerprint;
+            NSDate *addedOn = clipping.addedOn ? [[self kindleDateFormatter] dateFromString:clipping.addedOn] : nil;
+            [batch addObject:@{
+                @"text": clipping.text,
+                @"location": @(clipping.location),
+                @"timestamp": addedOn ? @(addedOn.timeIntervalSince1970) : captureDate,
+                @"fingerprint": [NSString stringWithFormat:@"%016llx", fingerprint]
+            }];
+            [fingerprints appendBytes:&fingerprint length:sizeof(fingerprint)];
+            
+            if (batch.count >= kKindleImportBatchSize) {
+                flush(bookTitle);
+            }
+        } error:&parseError];
+        
+        for (NSString *bookTitle in batches.allKeys) {
+            flush(bookTitle);
         }
-    }];
+        MBFingerprintSetFree(seen);
+        
+        dispatch_group_notify(saves, self.highlightQueue, ^{
+            NSError *error = parsed ? firstError : (parseError ?: errorWithCode(MEMBO_ERROR_INTERNAL, nil));
+            if (error) {
+                // Batches saved before the failure stay recorded, so a retry resumes
+                self.lastError = error;
+                if (completion) completion(nil, error);
+                return;
+            }
+            if (completion) completion(@{
+                @"imported": @(imported),
+                @"skipped": @(skipped),
+                @"books": @(books.count)
+            }, nil);
+        });
+    });
 }
 
 #pragma mark - Content Synchronization
@@ -247,6 +375,90 @@ static const NSInteger kMaxRetryAttempts = 3;
 
 #pragma mark - Private Methods
 
+/// Must be called on the highlight queue; completion runs there too
+- (void)saveKindleHighlights:(NSArray<NSDictionary *> *)highlights
+                   bookTitle:(NSString *)bookTitle
+                      author:(nullable NSString *)author
+                fingerprints:(NSData *)fingerprints
+                  completion:(void (^)(BOOL success, NSError * _Nullable error))completion {
+    NSMutableDictionary *content = [@{
+        @"bookTitle": bookTitle,
+        @"highlights": highlights,
+        @"captureDate": @([[NSDate date] timeIntervalSince1970])
+    } mutableCopy];
+    if (author) {
+        content[@"author"] = author;
+    }
+    
+    NSError *jsonError = nil;
+    NSData *contentData = [NSJSONSerialization dataWithJSONObject:content options:0 error:&jsonError];
+    if (!contentData) {
+        self.lastError = jsonError;
+        if (completion) completion(NO, jsonError);
+        return;
+    }
+    
+    // Titles can contain path separators; the index key is file-system safe
+    NSString *fileName = [NSString stringWithFormat:@"kindle_%@_%@",
+                         [MBHighlightIndex storageKeyForBookTitle:bookTitle],
+                         [[NSUUID UUID] UUIDString]];
+    
+    [self.fileManager saveContent:contentData
+                       fileName:fileName
+                    completion:^(BOOL success, NSError * _Nullable error) {
+        if (success) {
+            self.pendingOperations[fileName] = @{
+                @"type": @"kindle",
+                @"bookTitle": bookTitle,
+                @"highlightCount": @(highlights.count),
+                @"timestamp": @([[NSDate date] timeIntervalSince1970])
+            };
+            [self triggerSyncIfNeeded];
+        } else {
+            self.lastError = error;
+        }
+        
+        dispatch_async(self.highlightQueue, ^{
+            // Highlights count as captured only once their content is on disk
+            if (success) {
+                NSError *indexError = nil;
+                MBHighlightIndex *index = [self highlightIndexForBookTitle:bookTitle error:&indexError];
+                if (!index || ![index addFingerprints:fingerprints.bytes
+                                                count:fingerprints.length / sizeof(uint64_t)
+                                                error:&indexError]) {
+                    // Content is saved; these highlights may just be offered again
+                    NSLog(@"[ContentCapture] Failed to record captured highlights: %@", indexError.localizedDescription);
+                }
+            }
+            if (completion) completion(success, error);
+        });
+    }];
+}
+
+/// Must be called on the highlight queue
+- (nullable MBHighlightIndex *)highlightIndexForBookTitle:(NSString *)bookTitle error:(NSError **)error {
+    MBHighlightIndex *index = self.highlightIndexes[bookTitle];
+    if (!index) {
+        index = [MBHighlightIndex indexForBookTitle:bookTitle directory:nil error:error];
+        if (index) {
+            self.highlightIndexes[bookTitle] = index;
+        }
+    }
+    return index;
+}
+
+- (NSDateFormatter *)kindleDateFormatter {
+    // "Sunday, March 3, 2024 10:15:00 AM" as written by English-locale devices
+    static NSDateFormatter *formatter = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        formatter = [[NSDateFormatter alloc] init];
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"EEEE, MMMM d, yyyy h:mm:ss a";
+    });
+    return formatter;
+}
+
 - (void)syncFileWithName:(NSString *)fileName metadata:(NSDictionary *)metadata {
     [self.fileManager loadContent:fileName completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (data) {
@@ -282,6 +494,9 @@ static const NSInteger kMaxRetryAttempts = 3;
     [self.syncQueue cancelAllOperations];
     [self.pendingOperations removeAllObjects];
     self.retryCount = 0;
+    dispatch_async(self.highlightQueue, ^{
+        [self.highlightIndexes removeAllObjects];
+    });
 }
 
 @end
\ No newline at end of file
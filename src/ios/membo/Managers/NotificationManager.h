@@ -9,6 +9,9 @@
 #import <Foundation/Foundation.h>              // Foundation v17.0+
 #import <UserNotifications/UserNotifications.h>  // UserNotifications v12.0+
 #import "ErrorCodes.h"
+#import "ReminderPlanner.h"
+
+@class MBCardStore;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -91,6 +94,18 @@ NS_ASSUME_NONNULL_BEGIN
                  attachment:(nullable UNNotificationAttachment *)attachment
           completionHandler:(void (^)(NSError * _Nullable error))completionHandler;
 
+/**
+ * Plans study reminders from the local due forecast and applies only the
+ * difference to the reminders already scheduled. Keeps the total number of
+ * pending requests under the system cap, leaving room for a snooze.
+ *
+ * @param store Card store providing the due forecast
+ * @param completionHandler Block called on the main queue with the applied diff or an error
+ */
+- (void)planStudyRemindersFromStore:(MBCardStore *)store
+                  completionHandler:(nullable void (^)(MBReminderPlanDiff * _Nullable diff,
+                                                       NSError * _Nullable error))completionHandler;
+
 /**
  * Cancels all pending notifications and cleans up resources.
  *
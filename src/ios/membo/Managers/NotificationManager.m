@@ -7,6 +7,7 @@
 //
 
 #import "NotificationManager.h"
+#import "Utils/CardStore.h"
 
 #pragma mark - Constants
 
@@ -24,6 +25,12 @@ NSString * const MBNotificationKeyReminderId = @"reminderId";
 const NSTimeInterval MBNotificationDefaultSnoozeInterval = 900.0; // 15 minutes
 const NSUInteger MBNotificationMaxPendingReminders = 64;
 
+// Fixed identifier so repeated snoozes replace each other instead of piling up
+static NSString * const kSnoozeReminderIdentifier = @"ai.membo.snooze";
+
+// Pending slots kept free for a snooze when planning reminders
+static const NSUInteger kReservedSnoozeSlots = 1;
+
 #pragma mark - Private Interface
 
 @interface MBNotificationManager ()
@@ -135,9 +142,86 @@ static dispatch_once_t onceToken;
         return;
     }
     
+    [self scheduleReminderWithIdentifier:[[NSUUID UUID] UUIDString]
+                                    date:date
+                                   title:title
+                                    body:body
+                                userInfo:userInfo
+                              attachment:attachment
+                       completionHandler:completionHandler];
+}
+
+- (void)planStudyRemindersFromStore:(MBCardStore *)store
+                  completionHandler:(nullable void (^)(MBReminderPlanDiff * _Nullable,
+                                                       NSError * _Nullable))completionHandler {
     dispatch_async(self.notificationQueue, ^{
-        // Check if we've hit the maximum pending notifications
-        if (self.pendingNotifications.count >= MBNotificationMaxPendingReminders) {
+        [self.notificationCenter getPendingNotificationRequestsWithCompletionHandler:^(NSArray<UNNotificationRequest *> * _Nonnull requests) {
+            dispatch_async(self.notificationQueue, ^{
+                // Split planner-owned reminders from everything else sharing the cap
+                NSMutableDictionary<NSString *, NSNumber *> *scheduled = [NSMutableDictionary dictionary];
+                NSUInteger otherRequests = 0;
+                for (UNNotificationRequest *request in requests) {
+                    if ([request.identifier hasPrefix:MBPlannedReminderIdentifierPrefix]) {
+                        NSNumber *dueCount = request.content.userInfo[MBPlannedReminderDueCountKey];
+                        scheduled[request.identifier] = [dueCount isKindOfClass:[NSNumber class]] ? dueCount : @(-1);
+                    } else {
+                        otherRequests++;
+                    }
+                }
+
+                MBReminderPlannerConfig config = MBReminderPlannerDefaultConfig();
+                NSUInteger reserved = otherRequests + kReservedSnoozeSlots;
+                config.maxReminders = MBNotificationMaxPendingReminders > reserved ?
+                                      MBNotificationMaxPendingReminders - reserved : 0;
+
+                NSDate *now = [NSDate date];
+                NSError *storeError = nil;
+                NSData *dueTimestamps = [store dueTimestampsThroughDate:[now dateByAddingTimeInterval:config.horizon]
+                                                                  error:&storeError];
+                if (!dueTimestamps) {
+                    NSMutableDictionary *errorInfo = [NSMutableDictionary dictionaryWithObject:@"Failed to load due forecast"
+                                                                                        forKey:NSLocalizedDescriptionKey];
+                    errorInfo[NSUnderlyingErrorKey] = storeError;
+                    NSError *wrappedError = [self errorWithCode:MEMBO_ERROR_NOTIFICATION_FAILED userInfo:errorInfo];
+                    if (completionHandler) {
+                        dispatch_async(dispatch_get_main_queue(), ^{
+                            completionHandler(nil, wrappedError);
+                        });
+                    }
+                    return;
+                }
+
+                NSArray<MBPlannedReminder *> *plan = [MBReminderPlanner planWithDueTimestamps:dueTimestamps
+                                                                                  hourWeights:[MBReminderPlanner studyHourWeights]
+                                                                                          now:now
+                                                                                       config:config];
+                MBReminderPlanDiff *diff = [MBReminderPlanner diffPlan:plan againstScheduled:scheduled];
+                [self applyReminderPlanDiff:diff];
+
+                if (completionHandler) {
+                    dispatch_async(dispatch_get_main_queue(), ^{
+                        completionHandler(diff, nil);
+                    });
+                }
+            });
+        }];
+    });
+}
+
+#pragma mark - Private Helpers
+
+- (void)scheduleReminderWithIdentifier:(NSString *)identifier
+                                  date:(NSDate *)date
+                                 title:(NSString *)title
+                                  body:(NSString *)body
+                              userInfo:(nullable NSDictionary *)userInfo
+                            attachment:(nullable UNNotificationAttachment *)attachment
+                     completionHandler:(void (^)(NSError * _Nullable))completionHandler {
+    dispatch_async(self.notificationQueue, ^{
+        // Check if we've hit the maximum pending notifications; replacing an
+        // existing request does not take a new slot
+        if (!self.pendingNotifications[identifier] &&
+            self.pendingNotifications.count >= MBNotificationMaxPendingReminders) {
             NSError *error = [self errorWithCode:MEMBO_ERROR_NOTIFICATION_FAILED
                                       userInfo:@{
                 NSLocalizedDescriptionKey: @"Maximum pending notifications reached"
@@ -163,22 +247,8 @@ static dispatch_once_t onceToken;
             content.attachments = @[attachment];
         }
         
-        // Create trigger
-        NSCalendar *calendar = [NSCalendar currentCalendar];
-        NSDateComponents *components = [calendar components:(NSCalendarUnitYear |
-                                                          NSCalendarUnitMonth |
-                                                          NSCalendarUnitDay |
-                                                          NSCalendarUnitHour |
-                                                          NSCalendarUnitMinute |
-                                                          NSCalendarUnitSecond)
-                                                 fromDate:date];
-        
-        UNCalendarNotificationTrigger *trigger = [UNCalendarNotificationTrigger
-                                                 triggerWithDateMatchingComponents:components
-                                                 repeats:NO];
-        
         // Create request
-        NSString *identifier = [[NSUUID UUID] UUIDString];
+        UNNotificationTrigger *trigger = [self triggerForDate:date];
         UNNotificationRequest *request = [UNNotificationRequest requestWithIdentifier:identifier
                                                                           content:content
                                                                           trigger:trigger];
@@ -208,7 +278,51 @@ static dispatch_once_t onceToken;
     });
 }
 
-#pragma mark - Private Helpers
+- (void)applyReminderPlanDiff:(MBReminderPlanDiff *)diff {
+    if (diff.identifiersToRemove.count > 0) {
+        [self.notificationCenter removePendingNotificationRequestsWithIdentifiers:diff.identifiersToRemove];
+        [self.pendingNotifications removeObjectsForKeys:diff.identifiersToRemove];
+    }
+
+    for (MBPlannedReminder *reminder in diff.remindersToAdd) {
+        UNMutableNotificationContent *content = [[UNMutableNotificationContent alloc] init];
+        content.title = @"Time to review";
+        content.body = reminder.dueCount == 1 ?
+            @"1 card is ready for review" :
+            [NSString stringWithFormat:@"%lu cards are ready for review", (unsigned long)reminder.dueCount];
+        content.sound = [UNNotificationSound defaultSound];
+        content.categoryIdentifier = MBNotificationCategoryStudyReminder;
+        content.userInfo = @{
+            MBNotificationKeyReminderId: reminder.identifier,
+            MBPlannedReminderDueCountKey: @(reminder.dueCount)
+        };
+
+        // Re-adding an existing identifier replaces the scheduled request
+        UNNotificationRequest *request = [UNNotificationRequest requestWithIdentifier:reminder.identifier
+                                                                              content:content
+                                                                              trigger:[self triggerForDate:reminder.fireDate]];
+        [self.notificationCenter addNotificationRequest:request withCompletionHandler:^(NSError * _Nullable error) {
+            if (error) {
+                NSLog(@"Failed to schedule planned reminder %@: %@", reminder.identifier, error);
+            }
+        }];
+        self.pendingNotifications[reminder.identifier] = request;
+    }
+}
+
+- (UNNotificationTrigger *)triggerForDate:(NSDate *)date {
+    NSCalendar *calendar = [NSCalendar currentCalendar];
+    NSDateComponents *components = [calendar components:(NSCalendarUnitYear |
+                                                      NSCalendarUnitMonth |
+                                                      NSCalendarUnitDay |
+                                                      NSCalendarUnitHour |
+                                                      NSCalendarUnitMinute |
+                                                      NSCalendarUnitSecond)
+                                             fromDate:date];
+    
+    return [UNCalendarNotificationTrigger triggerWithDateMatchingComponents:components
+                                                                    repeats:NO];
+}
 
 - (void)registerNotificationCategories {
     UNNotificationAction *startStudyAction = [UNNotificationAction
@@ -273,12 +387,13 @@ didReceiveNotificationResponse:(UNNotificationResponse *)response
         UNNotificationRequest *originalRequest = response.notification.request;
         NSDate *newDate = [NSDate dateWithTimeIntervalSinceNow:MBNotificationDefaultSnoozeInterval];
         
-        [self scheduleStudyReminder:newDate
-                            title:originalRequest.content.title
-                             body:originalRequest.content.body
-                         userInfo:originalRequest.content.userInfo
-                      attachment:originalRequest.content.attachments.firstObject
-               completionHandler:^(NSError * _Nullable error) {
+        [self scheduleReminderWithIdentifier:kSnoozeReminderIdentifier
+                                        date:newDate
+                                       title:originalRequest.content.title
+                                        body:originalRequest.content.body
+                                    userInfo:originalRequest.content.userInfo
+                                  attachment:originalRequest.content.attachments.firstObject
+                           completionHandler:^(NSError * _Nullable error) {
             if (error) {
                 NSLog(@"Failed to snooze notification: %@", error);
             }
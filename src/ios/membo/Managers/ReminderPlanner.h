@@ -0,0 +1,162 @@
+//
+//  ReminderPlanner.h
+//  membo
+//
+//  Computes a compact set of study reminders from the local due forecast and
+//  the user's study-time histogram, and diffs it against the reminders that
+//  are already scheduled so only changes reach the notification center.
+//
+
+@import Foundation; // iOS SDK 12.0+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Number of hour-of-day buckets in the study-time histogram
+#define MB_REMINDER_HOURS_PER_DAY 24
+
+/// Identifier prefix of reminders owned by the planner
+extern NSString *const MBPlannedReminderIdentifierPrefix;
+
+/// User info key carrying the due-card count of a planned reminder
+extern NSString *const MBPlannedReminderDueCountKey;
+
+#pragma mark - Planning Core
+
+/**
+ * Planner tuning. Times are in seconds.
+ */
+typedef struct {
+    /// How far ahead to plan
+    NSTimeInterval horizon;
+    /// Minimum gap between two reminders
+    NSTimeInterval minimumSpacing;
+    /// Hard cap on reminders, usually the free pending-notification slots
+    NSUInteger maxReminders;
+    /// Weighted cards a reminder must bring in to be worth scheduling
+    double reminderCost;
+    /// Time for a waiting card's value to halve; 0 disables decay
+    NSTimeInterval stalenessHalfLife;
+    /// Seconds east of UTC, used to map fire times to hour of day
+    NSInteger utcOffset;
+} MBReminderPlannerConfig;
+
+/**
+ * One reminder chosen by the planner.
+ */
+typedef struct {
+    /// Fire time, seconds since 1970, on an hour boundary
+    NSTimeInterval fireTime;
+    /// Cards due by the fire time
+    uint32_t dueCount;
+    /// Cards that became due since the previous reminder
+    uint32_t newlyDueCount;
+} MBReminderSlot;
+
+/// Default configuration: 14-day horizon, 4-hour spacing, 63 reminders,
+/// 12-hour staleness half-life
+MBReminderPlannerConfig MBReminderPlannerDefaultConfig(void);
+
+/**
+ * Chooses reminder times maximizing the histogram-weighted number of newly
+ * due cards each reminder brings in, each card discounted by how long it
+ * waited since becoming due, minus `reminderCost` per reminder,
+ * subject to the spacing and count limits. Candidates are hour boundaries
+ * within the horizon; the choice is exact over those candidates.
+ *
+ * @param dueTimes Due timestamps (seconds since 1970), any order
+ * @param count Number of due timestamps
+ * @param hourWeights Relative likelihood of studying per local hour, >= 0
+ * @param now Planning reference time
+ * @param config Planner tuning
+ * @param slots Receives chosen reminders in ascending time order
+ * @param capacity Capacity of `slots`
+ * @return Number of reminders written
+ */
+NSUInteger MBPlanReminders(const double *dueTimes,
+                           NSUInteger count,
+                           const double hourWeights[MB_REMINDER_HOURS_PER_DAY],
+                           NSTimeInterval now,
+                           MBReminderPlannerConfig config,
+                           MBReminderSlot *slots,
+                           NSUInteger capacity);
+
+#pragma mark - Plan Objects
+
+/**
+ * A reminder to schedule. Identifiers are derived from the fire hour, so the
+ * same reminder keeps its identifier across replans.
+ */
+@interface MBPlannedReminder : NSObject
+
+@property (nonatomic, copy, readonly) NSString *identifier;
+@property (nonatomic, strong, readonly) NSDate *fireDate;
+@property (nonatomic, assign, readonly) NSUInteger dueCount;
+
+- (instancetype)initWithSlot:(MBReminderSlot)slot NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ * Changes needed to move the scheduled reminders to a new plan.
+ */
+@interface MBReminderPlanDiff : NSObject
+
+/// Reminders to add or replace
+@property (nonatomic, copy, readonly) NSArray<MBPlannedReminder *> *remindersToAdd;
+/// Identifiers of scheduled reminders that are no longer planned
+@property (nonatomic, copy, readonly) NSArray<NSString *> *identifiersToRemove;
+/// Scheduled reminders that already match the plan
+@property (nonatomic, assign, readonly) NSUInteger unchangedCount;
+
+/**
+ * Returns a JSON-ready summary for the bridge.
+ */
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+#pragma mark - Planner
+
+@interface MBReminderPlanner : NSObject
+
+/**
+ * Plans reminders from packed due timestamps.
+ *
+ * @param dueTimestamps Packed `double` seconds since 1970
+ * @param hourWeights 24 relative study likelihoods, index 0 = midnight local
+ * @param now Planning reference time
+ * @param config Planner tuning
+ * @return Reminders in ascending fire order
+ */
++ (NSArray<MBPlannedReminder *> *)planWithDueTimestamps:(NSData *)dueTimestamps
+                                            hourWeights:(NSArray<NSNumber *> *)hourWeights
+                                                    now:(NSDate *)now
+                                                 config:(MBReminderPlannerConfig)config;
+
+/**
+ * Diffs a plan against scheduled planner reminders.
+ *
+ * @param plan Desired reminders
+ * @param scheduled Scheduled planner reminders: identifier -> due count
+ * @return Minimal set of changes
+ */
++ (MBReminderPlanDiff *)diffPlan:(NSArray<MBPlannedReminder *> *)plan
+                 againstScheduled:(NSDictionary<NSString *, NSNumber *> *)scheduled;
+
+#pragma mark - Study-Time Histogram
+
+/**
+ * Records that a study session started, decaying older observations.
+ */
++ (void)recordStudySessionAtDate:(NSDate *)date;
+
+/**
+ * Returns the 24 hour-of-day weights learned from past sessions, falling
+ * back to a daytime prior until enough sessions are recorded.
+ */
++ (NSArray<NSNumber *> *)studyHourWeights;
+
+@end
+
+NS_ASSUME_NONNULL_END
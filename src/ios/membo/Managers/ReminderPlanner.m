@@ -0,0 +1,328 @@
+//
+//  ReminderPlanner.m
+//  membo
+//
+//  Reminder planning is a small dynamic program over hour-boundary candidates:
+//  f[k][s] is the best objective using k reminders with the last one at slot s.
+//  The due forecast is reduced to per-slot counts first, so deck size only
+//  affects a single linear bucketing pass. A card's value decays while it
+//  waits for a reminder; the decayed total brought in by a reminder at s after
+//  one at p is fresh[s] - fresh[p] * decay^(s - p), so transitions stay O(1).
+//
+
+#import "ReminderPlanner.h"
+
+#include <math.h>
+
+NSString *const MBPlannedReminderIdentifierPrefix = @"ai.membo.reminder.";
+NSString *const MBPlannedReminderDueCountKey = @"dueCount";
+
+static const NSTimeInterval kSlotDuration = 3600.0;
+
+// Longest horizon the planner accepts; bounds the DP table size
+static const NSTimeInterval kMaxHorizon = 30 * 86400.0;
+
+static NSString *const kStudyHourHistogramKey = @"ai.membo.studyHourHistogram";
+
+// Older sessions fade so the histogram tracks changing habits
+static const double kHistogramDecay = 0.97;
+
+// Weight of the daytime prior; outweighed after a handful of sessions
+static const double kHistogramPriorStrength = 1.0;
+
+#pragma mark - Planning Core
+
+MBReminderPlannerConfig MBReminderPlannerDefaultConfig(void) {
+    return (MBReminderPlannerConfig){
+        .horizon = 14 * 86400.0,
+        .minimumSpacing = 4 * 3600.0,
+        .maxReminders = 63,
+        .reminderCost = 5.0,
+        .stalenessHalfLife = 12 * 3600.0,
+        .utcOffset = [NSTimeZone localTimeZone].secondsFromGMT
+    };
+}
+
+NSUInteger MBPlanReminders(const double *dueTimes,
+                           NSUInteger count,
+                           const double hourWeights[MB_REMINDER_HOURS_PER_DAY],
+                           NSTimeInterval now,
+                           MBReminderPlannerConfig config,
+                           MBReminderSlot *slots,
+                           NSUInteger capacity) {
+    NSUInteger slotCount = (NSUInteger)(MIN(config.horizon, kMaxHorizon) / kSlotDuration);
+    NSUInteger maxReminders = MIN(MIN(config.maxReminders, capacity), slotCount);
+    if (maxReminders == 0) {
+        return 0;
+    }
+
+    double firstSlot = ceil(now / kSlotDuration) * kSlotDuration;
+    NSUInteger spacing = MAX((NSUInteger)1, (NSUInteger)ceil(config.minimumSpacing / kSlotDuration));
+
+    // Cards due by each slot; overdue cards count from the first slot on
+    uint32_t *dueBySlot = calloc(slotCount, sizeof(uint32_t));
+    double *weight = malloc(slotCount * sizeof(double));
+    double *fresh = malloc(slotCount * sizeof(double));
+    double *decayPow = malloc(slotCount * sizeof(double));
+    double *table = malloc((maxReminders + 1) * slotCount * sizeof(double));
+    int32_t *parent = malloc((maxReminders + 1) * slotCount * sizeof(int32_t));
+    if (!dueBySlot || !weight || !fresh || !decayPow || !table || !parent) {
+        free(dueBySlot);
+        free(weight);
+        free(fresh);
+        free(decayPow);
+        free(table);
+        free(parent);
+        return 0;
+    }
+
+    for (NSUInteger i = 0; i < count; i++) {
+        double offset = dueTimes[i] - firstSlot;
+        NSUInteger slot = offset <= 0 ? 0 : (NSUInteger)ceil(offset / kSlotDuration);
+        if (slot < slotCount) {
+            dueBySlot[slot]++;
+        }
+    }
+
+    // fresh[s]: cards due by slot s, each decayed by how long it has waited
+    double decay = config.stalenessHalfLife > 0 ? exp2(-kSlotDuration / config.stalenessHalfLife) : 1.0;
+    decayPow[0] = 1.0;
+    fresh[0] = dueBySlot[0];
+    for (NSUInteger s = 1; s < slotCount; s++) {
+        decayPow[s] = decayPow[s - 1] * decay;
+        fresh[s] = fresh[s - 1] * decay + dueBySlot[s];
+        dueBySlot[s] += dueBySlot[s - 1];
+    }
+
+    double maxWeight = 0;
+    for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+        maxWeight = MAX(maxWeight, hourWeights[h]);
+    }
+    for (NSUInteger s = 0; s < slotCount; s++) {
+        int64_t localHour = (int64_t)floor((firstSlot + s * kSlotDuration + config.utcOffset) / kSlotDuration);
+        int64_t hourOfDay = ((localHour % MB_REMINDER_HOURS_PER_DAY) + MB_REMINDER_HOURS_PER_DAY) % MB_REMINDER_HOURS_PER_DAY;
+        weight[s] = maxWeight > 0 ? MAX(hourWeights[hourOfDay], 0) / maxWeight : 1.0;
+    }
+
+    double best = 0;
+    NSUInteger bestCount = 0;
+    NSUInteger bestSlot = 0;
+
+    for (NSUInteger k = 1; k <= maxReminders; k++) {
+        double *row = table + k * slotCount;
+        const double *previousRow = table + (k - 1) * slotCount;
+        int32_t *parentRow = parent + k * slotCount;
+        BOOL reachable = NO;
+
+        for (NSUInteger s = 0; s < slotCount; s++) {
+            double value = -INFINITY;
+            int32_t from = -1;
+
+            if (k == 1) {
+                value = weight[s] * fresh[s];
+            } else if (s >= spacing) {
+                for (NSUInteger p = 0; p + spacing <= s; p++) {
+                    if (previousRow[p] == -INFINITY) {
+                        continue;
+                    }
+                    double gained = fresh[s] - fresh[p] * decayPow[s - p];
+                    double candidate = previousRow[p] + weight[s] * gained;
+                    if (candidate > value) {
+                        value = candidate;
+                        from = (int32_t)p;
+                    }
+                }
+            }
+
+            if (value == -INFINITY) {
+                row[s] = -INFINITY;
+                continue;
+            }
+
+            row[s] = value - config.reminderCost;
+            parentRow[s] = from;
+            reachable = YES;
+            if (row[s] > best) {
+                best = row[s];
+                bestCount = k;
+                bestSlot = s;
+            }
+        }
+
+        if (!reachable) {
+            break;
+        }
+    }
+
+    // Walk parents back from the best end state
+    NSUInteger slot = bestSlot;
+    for (NSUInteger k = bestCount; k >= 1; k--) {
+        int32_t previous = parent[k * slotCount + slot];
+        uint32_t dueBefore = previous >= 0 ? dueBySlot[previous] : 0;
+        slots[k - 1] = (MBReminderSlot){
+            .fireTime = firstSlot + slot * kSlotDuration,
+            .dueCount = dueBySlot[slot],
+            .newlyDueCount = dueBySlot[slot] - dueBefore
+        };
+        slot = (NSUInteger)MAX(previous, 0);
+    }
+
+    free(dueBySlot);
+    free(weight);
+    free(fresh);
+    free(decayPow);
+    free(table);
+    free(parent);
+    return bestCount;
+}
+
+#pragma mark - Plan Objects
+
+@implementation MBPlannedReminder
+
+- (instancetype)initWithSlot:(MBReminderSlot)slot {
+    self = [super init];
+    if (self) {
+        _fireDate = [NSDate dateWithTimeIntervalSince1970:slot.fireTime];
+        _dueCount = slot.dueCount;
+        _identifier = [NSString stringWithFormat:@"%@%lld", MBPlannedReminderIdentifierPrefix,
+                       (long long)(slot.fireTime / kSlotDuration)];
+    }
+    return self;
+}
+
+@end
+
+@implementation MBReminderPlanDiff
+
+- (instancetype)initWithRemindersToAdd:(NSArray<MBPlannedReminder *> *)remindersToAdd
+                   identifiersToRemove:(NSArray<NSString *> *)identifiersToRemove
+                        unchangedCount:(NSUInteger)unchangedCount {
+    self = [super init];
+    if (self) {
+        _remindersToAdd = [remindersToAdd copy];
+        _identifiersToRemove = [identifiersToRemove copy];
+        _unchangedCount = unchangedCount;
+    }
+    return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    NSMutableArray *added = [NSMutableArray arrayWithCapacity:self.remindersToAdd.count];
+    for (MBPlannedReminder *reminder in self.remindersToAdd) {
+        [added addObject:@{
+            @"id": reminder.identifier,
+            @"date": @(reminder.fireDate.timeIntervalSince1970),
+            @"dueCount": @(reminder.dueCount)
+        }];
+    }
+    return @{
+        @"added": added,
+        @"removed": self.identifiersToRemove,
+        @"unchanged": @(self.unchangedCount)
+    };
+}
+
+@end
+
+#pragma mark - Planner
+
+@implementation MBReminderPlanner
+
++ (NSArray<MBPlannedReminder *> *)planWithDueTimestamps:(NSData *)dueTimestamps
+                                            hourWeights:(NSArray<NSNumber *> *)hourWeights
+                                                    now:(NSDate *)now
+                                                 config:(MBReminderPlannerConfig)config {
+    double weights[MB_REMINDER_HOURS_PER_DAY];
+    for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+        weights[h] = h < hourWeights.count ? hourWeights[h].doubleValue : 0;
+    }
+
+    NSUInteger capacity = MAX(config.maxReminders, (NSUInteger)1);
+    MBReminderSlot *slots = calloc(capacity, sizeof(MBReminderSlot));
+    if (!slots) {
+        return @[];
+    }
+
+    NSUInteger planned = MBPlanReminders(dueTimestamps.bytes,
+                                         dueTimestamps.length / sizeof(double),
+                                         weights,
+                                         now.timeIntervalSince1970,
+                                         config,
+                                         slots,
+                                         capacity);
+
+    NSMutableArray<MBPlannedReminder *> *reminders = [NSMutableArray arrayWithCapacity:planned];
+    for (NSUInteger i = 0; i < planned; i++) {
+        [reminders addObject:[[MBPlannedReminder alloc] initWithSlot:slots[i]]];
+    }
+    free(slots);
+    return reminders;
+}
+
++ (MBReminderPlanDiff *)diffPlan:(NSArray<MBPlannedReminder *> *)plan
+                 againstScheduled:(NSDictionary<NSString *, NSNumber *> *)scheduled {
+    NSMutableArray<MBPlannedReminder *> *toAdd = [NSMutableArray array];
+    NSMutableSet<NSString *> *planned = [NSMutableSet setWithCapacity:plan.count];
+    NSUInteger unchanged = 0;
+
+    for (MBPlannedReminder *reminder in plan) {
+        [planned addObject:reminder.identifier];
+        NSNumber *scheduledCount = scheduled[reminder.identifier];
+        if (scheduledCount && scheduledCount.unsignedIntegerValue == reminder.dueCount) {
+            unchanged++;
+        } else {
+            // Same identifier replaces the scheduled request in place
+            [toAdd addObject:reminder];
+        }
+    }
+
+    NSMutableArray<NSString *> *toRemove = [NSMutableArray array];
+    for (NSString *identifier in scheduled) {
+        if (![planned containsObject:identifier]) {
+            [toRemove addObject:identifier];
+        }
+    }
+
+    return [[MBReminderPlanDiff alloc] initWithRemindersToAdd:toAdd
+                                          identifiersToRemove:toRemove
+                                               unchangedCount:unchanged];
+}
+
+#pragma mark - Study-Time Histogram
+
++ (void)recordStudySessionAtDate:(NSDate *)date {
+    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+    NSMutableArray<NSNumber *> *histogram = [self storedHistogram:defaults];
+
+    NSInteger hour = [[NSCalendar currentCalendar] component:NSCalendarUnitHour fromDate:date];
+    for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+        double value = histogram[h].doubleValue * kHistogramDecay + (h == (NSUInteger)hour ? 1.0 : 0.0);
+        histogram[h] = @(value);
+    }
+    [defaults setObject:histogram forKey:kStudyHourHistogramKey];
+}
+
++ (NSArray<NSNumber *> *)studyHourWeights {
+    NSArray<NSNumber *> *histogram = [self storedHistogram:[NSUserDefaults standardUserDefaults]];
+
+    NSMutableArray<NSNumber *> *weights = [NSMutableArray arrayWithCapacity:MB_REMINDER_HOURS_PER_DAY];
+    for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+        // Daytime prior: reminders between 08:00 and 21:59 unless history says otherwise
+        double prior = (h >= 8 && h <= 21) ? 1.0 : 0.05;
+        [weights addObject:@(histogram[h].doubleValue + prior * kHistogramPriorStrength)];
+    }
+    return weights;
+}
+
++ (NSMutableArray<NSNumber *> *)storedHistogram:(NSUserDefaults *)defaults {
+    NSArray *stored = [defaults arrayForKey:kStudyHourHistogramKey];
+    NSMutableArray<NSNumber *> *histogram = [NSMutableArray arrayWithCapacity:MB_REMINDER_HOURS_PER_DAY];
+    for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+        id value = h < stored.count ? stored[h] : nil;
+        [histogram addObject:[value isKindOfClass:[NSNumber class]] ? value : @0];
+    }
+    return histogram;
+}
+
+@end
@@ -10,6 +10,7 @@
 
 #import "Constants/StudyModes.h"
 #import "Utils/AudioSessionManager.h"
+#import "StudySessionActor.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -48,6 +49,13 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)didReceiveVoiceInput:(NSString *)input
                  confidence:(CGFloat)confidence;
 
+/**
+ * Called once per session actor drain with every event it produced, in order.
+ *
+ * @param events Ordered batch of session events
+ */
+- (void)didReceiveStudySessionEvents:(NSArray<MBStudySessionEvent *> *)events;
+
 @end
 
 #pragma mark - Class Interface
@@ -55,6 +63,8 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * Thread-safe singleton class managing study sessions and card scheduling
  * with comprehensive statistics tracking and voice learning support.
+ * Session state lives in an MBStudySessionActor; every mutating call posts
+ * a command and delegate callbacks are driven by the actor's event batches.
  */
 @interface StudyManager : NSObject
 
@@ -67,11 +77,14 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign, readonly) MBStudyMode currentMode;
 
 /// Current study mode configuration
-@property (nonatomic, strong, readonly) MBStudyModeConfig *currentConfig;
+@property (nonatomic, assign, readonly) MBStudyModeConfig currentConfig;
 
-/// Flag indicating if a study session is currently active
+/// Flag indicating if a study session is currently active or paused
 @property (nonatomic, assign, readonly) BOOL isSessionActive;
 
+/// Current state of the session state machine
+@property (nonatomic, assign, readonly) MBStudySessionState sessionState;
+
 /// Array of card IDs in the current study queue
 @property (nonatomic, strong, readonly) NSArray<NSString *> *currentCardQueue;
 
@@ -91,7 +104,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  * Starts a new study session with specified mode and configuration.
- * Implements thread-safe session initialization and resource setup.
+ * Posts a Start command and waits for the actor to apply it.
  *
  * @param mode The study mode to activate
  * @param config Configuration settings for the session
@@ -101,21 +114,43 @@ NS_ASSUME_NONNULL_BEGIN
                   config:(MBStudyModeConfig *)config;
 
 /**
- * Ends the current study session and processes results with enhanced statistics.
- * Performs thread-safe cleanup and delegate notification.
+ * Ends the current study session. Posts an End command and waits for the
+ * actor to apply it; statistics are delivered through the delegate.
  */
 - (void)endStudySession;
 
 /**
- * Thread-safe processing of user response for current card with voice support.
+ * Pauses the current study session. Ratings are rejected until resumed.
+ */
+- (void)pauseStudySession;
+
+/**
+ * Resumes a paused study session.
+ */
+- (void)resumeStudySession;
+
+/**
+ * Posts the user's response for the current card without waiting.
  *
  * @param confidence User's confidence rating (1-5)
  * @param voiceInput Optional voice input for voice-enabled mode
- * @return YES if processing was successful, NO otherwise
+ * @return YES if the response was posted to an active session, NO otherwise
  */
 - (BOOL)processCardResponse:(NSInteger)confidence
                 voiceInput:(nullable NSString *)voiceInput;
 
+/**
+ * Posts the user's response for the current card with a recognition score.
+ *
+ * @param confidence User's confidence rating (1-5)
+ * @param voiceInput Optional voice input for voice-enabled mode
+ * @param voiceConfidence Recognition confidence of the voice input (0-1)
+ * @return YES if the response was posted to an active session, NO otherwise
+ */
+- (BOOL)processCardResponse:(NSInteger)confidence
+                voiceInput:(nullable NSString *)voiceInput
+           voiceConfidence:(CGFloat)voiceConfidence;
+
 #pragma mark - Unavailable Initializers
 
 - (instancetype)init NS_UNAVAILABLE;
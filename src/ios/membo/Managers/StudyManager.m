@@ -3,24 +3,25 @@
 //  membo
 //
 //  Thread-safe implementation of study session management with FSRS scheduling
-//  and voice learning support.
+//  and voice learning support. All session mutations are posted to the
+//  session actor; no method re-enters a queue it may already be running on.
 //
 
 #import "StudyManager.h"
+#import "Utils/CardStore.h"
+#import "Utils/TraceRing.h"
+#import "NotificationManager.h"
 
 #pragma mark - Private Interface
 
-@interface StudyManager ()
+@interface StudyManager () <MBStudySessionActorDelegate>
 
-@property (nonatomic, weak, nullable) id<MBStudyManagerDelegate> delegate;
-@property (nonatomic, assign) MBStudyMode currentMode;
-@property (nonatomic, strong) MBStudyModeConfig *currentConfig;
-@property (nonatomic, assign) BOOL isSessionActive;
-@property (nonatomic, strong) NSArray<NSString *> *currentCardQueue;
+@property (nonatomic, strong) MBStudySessionActor *sessionActor;
+@property (atomic, strong) NSArray<NSString *> *currentCardQueue;
+// Session the card queue belongs to; events of other sessions leave it alone
+@property (atomic, assign) uint64_t queueSession;
+@property (nonatomic, assign) NSUInteger currentCardIndex;
 @property (nonatomic, strong) NSMutableDictionary *sessionStats;
-@property (nonatomic, strong) NSDate *sessionStartTime;
-@property (nonatomic, assign) NSUInteger totalCardsReviewed;
-@property (nonatomic, strong) NSMutableDictionary *voiceRecognitionStats;
 @property (nonatomic, strong) NSMutableArray *errorLog;
 
 @end
@@ -29,8 +30,6 @@
 
 static StudyManager *sharedInstance = nil;
 static dispatch_once_t onceToken;
-static dispatch_queue_t _syncQueue;
-static NSLock *_statsLock;
 
 #pragma mark - Implementation
 
@@ -38,13 +37,6 @@ static NSLock *_statsLock;
 
 #pragma mark - Lifecycle
 
-+ (void)initialize {
-    if (self == [StudyManager class]) {
-        _syncQueue = dispatch_queue_create("ai.membo.studymanager.sync", DISPATCH_QUEUE_SERIAL);
-        _statsLock = [[NSLock alloc] init];
-    }
-}
-
 + (instancetype)sharedInstance {
     dispatch_once(&onceToken, ^{
         sharedInstance = [[StudyManager alloc] initPrivate];
@@ -55,20 +47,18 @@ static NSLock *_statsLock;
 - (instancetype)initPrivate {
     self = [super init];
     if (self) {
-        _currentMode = MBStudyModeStandard;
-        _currentConfig = kMBDefaultStudyModeConfigs[@(MBStudyModeStandard)];
-        _isSessionActive = NO;
+        _sessionActor = [[MBStudySessionActor alloc] initWithDelegateQueue:dispatch_get_main_queue()];
+        _sessionActor.delegate = self;
         _currentCardQueue = @[];
         _sessionStats = [NSMutableDictionary dictionary];
-        _voiceRecognitionStats = [NSMutableDictionary dictionary];
         _errorLog = [NSMutableArray array];
-        
+
         // Register for system notifications
         [[NSNotificationCenter defaultCenter] addObserver:self
                                                selector:@selector(handleMemoryWarning)
                                                    name:UIApplicationDidReceiveMemoryWarningNotification
                                                  object:nil];
-        
+
         [[NSNotificationCenter defaultCenter] addObserver:self
                                                selector:@selector(handleAppStateTransition:)
                                                    name:UIApplicationWillResignActiveNotification
@@ -79,208 +69,243 @@ static NSLock *_statsLock;
 
 - (void)dealloc {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
-    [self endStudySession];
-    
-    dispatch_sync(_syncQueue, ^{
-        _currentCardQueue = nil;
-        _sessionStats = nil;
-        _voiceRecognitionStats = nil;
-        _errorLog = nil;
-        _delegate = nil;
-    });
+    [_sessionActor postEnd];
+}
+
+#pragma mark - State Accessors
+
+- (MBStudySessionState)sessionState {
+    return self.sessionActor.state;
+}
+
+- (BOOL)isSessionActive {
+    MBStudySessionState state = self.sessionActor.state;
+    return state == MBStudySessionStateActive || state == MBStudySessionStatePaused;
+}
+
+- (MBStudyMode)currentMode {
+    return self.sessionActor.mode;
+}
+
+- (MBStudyModeConfig)currentConfig {
+    return self.sessionActor.config;
 }
 
 #pragma mark - Session Management
 
 - (BOOL)startStudySession:(MBStudyMode)mode config:(MBStudyModeConfig *)config {
+    uint64_t traceStart = MBTraceBegin();
     if (self.isSessionActive) {
         [self logError:@"Attempted to start session while another is active"];
         return NO;
     }
-    
-    __block BOOL success = YES;
-    
-    dispatch_sync(_syncQueue, ^{
-        // Validate configuration
-        if (!config) {
-            config = kMBDefaultStudyModeConfigs[@(mode)];
-        }
-        
-        // Configure audio session for voice mode
-        if (mode == MBStudyModeVoice) {
-            success = [[AudioSessionManager sharedInstance] configureAudioSession];
-            if (!success) {
-                [self logError:@"Failed to configure audio session"];
-                return;
-            }
-        }
-        
-        // Initialize session state
-        self.currentMode = mode;
-        self.currentConfig = config;
-        self.sessionStartTime = [NSDate date];
-        self.totalCardsReviewed = 0;
-        
-        [self.sessionStats removeAllObjects];
-        [self.voiceRecognitionStats removeAllObjects];
-        
-        // Load initial card queue using FSRS algorithm
-        success = [self loadCardQueue];
-        
-        if (success) {
-            self.isSessionActive = YES;
-            
-            // Notify delegate on main thread
-            dispatch_async(dispatch_get_main_queue(), ^{
-                if ([self.delegate respondsToSelector:@selector(didStartStudySession:config:)]) {
-                    [self.delegate didStartStudySession:mode config:config];
-                }
-            });
-        }
-    });
-    
-    return success;
+
+    if (!config) {
+        [self logError:@"Attempted to start session without configuration"];
+        return NO;
+    }
+
+    // Configure audio session for voice mode before the session exists
+    if (mode == MBStudyModeVoice &&
+        ![[AudioSessionManager sharedInstance] configureAudioSession]) {
+        [self logError:@"Failed to configure audio session"];
+        return NO;
+    }
+
+    // Load initial card queue using FSRS algorithm. The last session's events may
+    // still be in flight to the delegate queue, so the queue is owned by no session
+    // until the Start ticket is known.
+    self.queueSession = 0;
+    if (![self loadCardQueueWithLimit:config->maxCardsPerSession]) {
+        [self logError:@"Failed to load card queue"];
+        return NO;
+    }
+
+    self.queueSession = [self.sessionActor postStartWithMode:mode
+                                                      config:*config
+                                                   cardCount:self.currentCardQueue.count];
+    [self.sessionActor waitUntilDrained];
+
+    if (self.sessionActor.state != MBStudySessionStateActive) {
+        [self logError:@"Study session configuration rejected"];
+        return NO;
+    }
+    MBTraceEnd(MBTraceSpanStudySessionStart, traceStart, (uint32_t)self.currentCardQueue.count);
+    return YES;
 }
 
 - (void)endStudySession {
     if (!self.isSessionActive) {
         return;
     }
-    
-    dispatch_sync(_syncQueue, ^{
-        // Calculate final statistics
-        NSTimeInterval duration = [[NSDate date] timeIntervalSinceDate:self.sessionStartTime];
-        
-        [_statsLock lock];
-        self.sessionStats[@"duration"] = @(duration);
-        self.sessionStats[@"totalCards"] = @(self.totalCardsReviewed);
-        self.sessionStats[@"completionRate"] = @(self.totalCardsReviewed / (float)self.currentCardQueue.count);
-        
-        if (self.currentMode == MBStudyModeVoice) {
-            self.sessionStats[@"voiceAccuracy"] = [self calculateVoiceAccuracy];
-            [[AudioSessionManager sharedInstance] deactivateAudioSession];
-        }
-        [_statsLock unlock];
-        
-        // Reset session state
-        self.isSessionActive = NO;
-        self.currentCardQueue = @[];
-        self.sessionStartTime = nil;
-        
-        // Notify delegate with final statistics
-        NSDictionary *finalStats = [self.sessionStats copy];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            if ([self.delegate respondsToSelector:@selector(didCompleteStudySession:)]) {
-                [self.delegate didCompleteStudySession:finalStats];
-            }
-        });
-    });
+
+    [self.sessionActor postEnd];
+    [self.sessionActor waitUntilDrained];
+}
+
+- (void)pauseStudySession {
+    [self.sessionActor postPause];
+}
+
+- (void)resumeStudySession {
+    [self.sessionActor postResume];
 }
 
 - (BOOL)processCardResponse:(NSInteger)confidence voiceInput:(nullable NSString *)voiceInput {
-    if (!self.isSessionActive) {
+    return [self processCardResponse:confidence voiceInput:voiceInput voiceConfidence:1.0];
+}
+
+- (BOOL)processCardResponse:(NSInteger)confidence
+                voiceInput:(nullable NSString *)voiceInput
+           voiceConfidence:(CGFloat)voiceConfidence {
+    if (self.sessionActor.state != MBStudySessionStateActive) {
         return NO;
     }
-    
-    __block BOOL success = YES;
-    
-    dispatch_sync(_syncQueue, ^{
-        // Process voice input if provided
-        if (voiceInput && self.currentMode == MBStudyModeVoice) {
-            CGFloat recognitionConfidence = [self processVoiceInput:voiceInput];
-            
-            dispatch_async(dispatch_get_main_queue(), ^{
-                if ([self.delegate respondsToSelector:@selector(didReceiveVoiceInput:confidence:)]) {
-                    [self.delegate didReceiveVoiceInput:voiceInput confidence:recognitionConfidence];
+
+    if (voiceInput && self.currentMode == MBStudyModeVoice) {
+        [self.sessionActor postVoiceInput:voiceInput confidence:voiceConfidence];
+    }
+    [self.sessionActor postRating:confidence];
+    return YES;
+}
+
+#pragma mark - MBStudySessionActorDelegate
+
+- (void)studySessionActor:(MBStudySessionActor *)actor
+            didEmitEvents:(NSArray<MBStudySessionEvent *> *)events {
+    id<MBStudyManagerDelegate> delegate = self.delegate;
+
+    for (MBStudySessionEvent *event in events) {
+        // Events of an earlier session can arrive after the next one has started
+        BOOL current = event.session == self.queueSession;
+        switch (event.type) {
+            case MBStudySessionEventStarted: {
+                [self.sessionStats removeAllObjects];
+                [MBReminderPlanner recordStudySessionAtDate:[NSDate date]];
+                if ([delegate respondsToSelector:@selector(didStartStudySession:config:)]) {
+                    MBStudyModeConfig config = actor.config;
+                    [delegate didStartStudySession:event.mode config:&config];
                 }
-            });
-        }
-        
-        // Update FSRS scheduling data
-        [self updateFSRSDataWithConfidence:confidence];
-        
-        // Update session statistics
-        [_statsLock lock];
-        self.totalCardsReviewed++;
-        [self updateSessionStats:confidence voiceInput:voiceInput];
-        [_statsLock unlock];
-        
-        // Check for session completion
-        if ([self shouldEndSession]) {
-            [self endStudySession];
+                break;
+            }
+            case MBStudySessionEventRated:
+                if (current) {
+                    [self updateFSRSDataWithConfidence:event.rating];
+                }
+                break;
+            case MBStudySessionEventVoiceReceived:
+                if ([delegate respondsToSelector:@selector(didReceiveVoiceInput:confidence:)]) {
+                    [delegate didReceiveVoiceInput:event.voiceInput confidence:event.voiceConfidence];
+                }
+                break;
+            case MBStudySessionEventCompleted:
+                // A newer voice session keeps the audio session it configured
+                if (event.mode == MBStudyModeVoice && (current || self.currentMode != MBStudyModeVoice)) {
+                    [[AudioSessionManager sharedInstance] deactivateAudioSession];
+                }
+                if (current) {
+                    self.currentCardQueue = @[];
+                    [self.sessionStats addEntriesFromDictionary:event.stats];
+                }
+                [self replanReminders];
+                if ([delegate respondsToSelector:@selector(didCompleteStudySession:)]) {
+                    [delegate didCompleteStudySession:event.stats];
+                }
+                break;
+            case MBStudySessionEventRejected:
+                [self logError:[NSString stringWithFormat:@"Command %ld rejected in state %ld",
+                                (long)event.command, (long)event.state]];
+                break;
+            default:
+                break;
         }
-    });
-    
-    return success;
+    }
+
+    if ([delegate respondsToSelector:@selector(didReceiveStudySessionEvents:)]) {
+        [delegate didReceiveStudySessionEvents:events];
+    }
 }
 
 #pragma mark - Private Methods
 
-- (BOOL)loadCardQueue {
-    // Implementation would integrate with FSRS algorithm
-    // to load and schedule cards based on review intervals
+- (BOOL)loadCardQueueWithLimit:(NSInteger)limit {
+    MBCardStore *store = [MBCardStore sharedStore];
+    if (!store) {
+        // No local store: run the session without a preloaded queue
+        self.currentCardQueue = @[];
+        return YES;
+    }
+
+    uint64_t traceStart = MBTraceBegin();
+    NSError *error = nil;
+    NSArray<NSString *> *cardIds = [store dueCardIdsAtDate:[NSDate date]
+                                                     limit:(NSUInteger)MAX(limit, 0)
+                                                     error:&error];
+    MBTraceEnd(MBTraceSpanStudyQueueLoad, traceStart, (uint32_t)cardIds.count);
+    if (!cardIds) {
+        [self logError:[NSString stringWithFormat:@"Card queue query failed: %@", error.localizedDescription]];
+        return NO;
+    }
+
+    self.currentCardQueue = cardIds;
+    self.currentCardIndex = 0;
     return YES;
 }
 
 - (void)updateFSRSDataWithConfidence:(NSInteger)confidence {
-    // Implementation would update FSRS scheduling data
-    // based on user response confidence
-}
-
-- (void)updateSessionStats:(NSInteger)confidence voiceInput:(nullable NSString *)voiceInput {
-    // Update comprehensive session statistics
-    [_statsLock lock];
-    NSNumber *currentCount = self.sessionStats[@(confidence)] ?: @0;
-    self.sessionStats[@(confidence)] = @(currentCount.integerValue + 1);
-    
-    if (voiceInput) {
-        [self updateVoiceStats:voiceInput];
+    NSArray<NSString *> *queue = self.currentCardQueue;
+    if (self.currentCardIndex >= queue.count) {
+        return;
     }
-    [_statsLock unlock];
-}
 
-- (void)updateVoiceStats:(NSString *)voiceInput {
-    // Track voice recognition statistics
-    NSMutableDictionary *stats = self.voiceRecognitionStats;
-    NSInteger totalAttempts = [stats[@"totalAttempts"] integerValue] + 1;
-    stats[@"totalAttempts"] = @(totalAttempts);
+    NSString *cardId = queue[self.currentCardIndex++];
+    __weak typeof(self) weakSelf = self;
+    [[MBCardStore sharedStore] enqueueReviewForCardId:cardId
+                                               rating:confidence
+                                           reviewedAt:[NSDate date]
+                                           completion:^(int64_t sequence, NSError * _Nullable error) {
+        if (error) {
+            [weakSelf logError:[NSString stringWithFormat:@"Failed to record review for %@: %@",
+                                cardId, error.localizedDescription]];
+        }
+    }];
 }
 
-- (NSNumber *)calculateVoiceAccuracy {
-    if (self.voiceRecognitionStats.count == 0) {
-        return @0;
+- (void)replanReminders {
+    MBCardStore *store = [MBCardStore sharedStore];
+    if (!store) {
+        return;
     }
-    
-    NSInteger totalAttempts = [self.voiceRecognitionStats[@"totalAttempts"] integerValue];
-    NSInteger successfulAttempts = [self.voiceRecognitionStats[@"successfulAttempts"] integerValue];
-    
-    return @(successfulAttempts / (float)totalAttempts);
-}
-
-- (BOOL)shouldEndSession {
-    return self.totalCardsReviewed >= self.currentConfig.maxCardsPerSession ||
-           [[NSDate date] timeIntervalSinceDate:self.sessionStartTime] >= self.currentConfig.sessionDuration;
+    // Queued reviews land first since the store applies them in order
+    [[MBNotificationManager sharedManager] planStudyRemindersFromStore:store completionHandler:^(MBReminderPlanDiff * _Nullable diff, NSError * _Nullable error) {
+        if (error) {
+            [self logError:[NSString stringWithFormat:@"Reminder planning failed: %@", error.localizedDescription]];
+        }
+    }];
 }
 
 - (void)logError:(NSString *)error {
     NSString *timestamp = [NSDateFormatter localizedStringFromDate:[NSDate date]
                                                        dateStyle:NSDateFormatterNoStyle
                                                        timeStyle:NSDateFormatterMediumStyle];
-    [self.errorLog addObject:@{@"timestamp": timestamp, @"error": error}];
+    @synchronized (self.errorLog) {
+        [self.errorLog addObject:@{@"timestamp": timestamp, @"error": error}];
+    }
 }
 
 #pragma mark - Notification Handlers
 
 - (void)handleMemoryWarning {
     // Handle low memory condition
-    [self.errorLog removeAllObjects];
-    [self.voiceRecognitionStats removeAllObjects];
+    @synchronized (self.errorLog) {
+        [self.errorLog removeAllObjects];
+    }
 }
 
 - (void)handleAppStateTransition:(NSNotification *)notification {
     if (self.isSessionActive) {
-        [self endStudySession];
+        [self.sessionActor postEnd];
     }
 }
 
-@end
\ No newline at end of file
+@end
@@ -0,0 +1,222 @@
+//
+//  StudySessionActor.h
+//  membo
+//
+//  Single-consumer study session state machine. Producers on any thread post
+//  commands to a lock-free MPSC queue; one serial drain applies them in order
+//  and delivers the resulting events to the delegate in batches.
+//
+
+@import Foundation; // iOS SDK 12.0+
+
+#import "Constants/StudyModes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark - Enumerations
+
+/**
+ * Explicit states of a study session.
+ */
+typedef NS_ENUM(NSInteger, MBStudySessionState) {
+    /// No session has been started yet
+    MBStudySessionStateIdle = 0,
+    /// Session is running and accepting ratings
+    MBStudySessionStateActive = 1,
+    /// Session is paused; ratings and voice input are rejected
+    MBStudySessionStatePaused = 2,
+    /// Session has finished; a new Start command is required
+    MBStudySessionStateEnded = 3
+};
+
+/**
+ * Commands accepted by the session actor.
+ */
+typedef NS_ENUM(NSInteger, MBStudySessionCommandType) {
+    MBStudySessionCommandStart = 0,
+    MBStudySessionCommandRate = 1,
+    MBStudySessionCommandVoice = 2,
+    MBStudySessionCommandPause = 3,
+    MBStudySessionCommandResume = 4,
+    MBStudySessionCommandEnd = 5
+};
+
+/**
+ * Events emitted by the session actor after applying a command.
+ */
+typedef NS_ENUM(NSInteger, MBStudySessionEventType) {
+    MBStudySessionEventStarted = 0,
+    MBStudySessionEventRated = 1,
+    MBStudySessionEventVoiceReceived = 2,
+    MBStudySessionEventPaused = 3,
+    MBStudySessionEventResumed = 4,
+    MBStudySessionEventCompleted = 5,
+    /// Command was not valid in the current state and had no effect
+    MBStudySessionEventRejected = 6
+};
+
+#pragma mark - Transition Function
+
+/**
+ * Pure transition function of the session state machine.
+ *
+ * @param state Current session state
+ * @param command Command to apply
+ * @param nextState Receives the resulting state when the command is accepted
+ * @return YES if the command is valid in the given state, NO otherwise
+ */
+BOOL MBStudySessionTransition(MBStudySessionState state,
+                              MBStudySessionCommandType command,
+                              MBStudySessionState *nextState);
+
+#pragma mark - Event
+
+/**
+ * Immutable record of a single state machine step.
+ */
+@interface MBStudySessionEvent : NSObject
+
+/// Kind of event
+@property (nonatomic, assign, readonly) MBStudySessionEventType type;
+
+/// Command that produced the event
+@property (nonatomic, assign, readonly) MBStudySessionCommandType command;
+
+/// Session state after the command was applied
+@property (nonatomic, assign, readonly) MBStudySessionState state;
+
+/// Ticket returned to the producer when the command was posted
+@property (nonatomic, assign, readonly) uint64_t ticket;
+
+/// Ticket of the Start command that began the event's session, 0 before the first session
+@property (nonatomic, assign, readonly) uint64_t session;
+
+/// Study mode of the session the event belongs to
+@property (nonatomic, assign, readonly) MBStudyMode mode;
+
+/// Rating for Rated events, 0 otherwise
+@property (nonatomic, assign, readonly) NSInteger rating;
+
+/// Recognized text for VoiceReceived events
+@property (nonatomic, copy, readonly, nullable) NSString *voiceInput;
+
+/// Recognition confidence for VoiceReceived events
+@property (nonatomic, assign, readonly) CGFloat voiceConfidence;
+
+/// Final statistics for Completed events
+@property (nonatomic, copy, readonly, nullable) NSDictionary<NSString *, NSNumber *> *stats;
+
+/// Nanoseconds between the command being posted and applied
+@property (nonatomic, assign, readonly) uint64_t queueLatencyNanos;
+
+/**
+ * Returns a bridge-friendly dictionary representation of the event.
+ */
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+@class MBStudySessionActor;
+
+#pragma mark - Delegate Protocol
+
+/**
+ * Receives event batches from the session actor on its delegate queue.
+ */
+@protocol MBStudySessionActorDelegate <NSObject>
+
+@required
+/**
+ * Called once per drain with every event produced by that drain, in order.
+ *
+ * @param actor The emitting actor
+ * @param events Ordered batch of events
+ */
+- (void)studySessionActor:(MBStudySessionActor *)actor
+            didEmitEvents:(NSArray<MBStudySessionEvent *> *)events;
+
+@end
+
+#pragma mark - Class Interface
+
+/**
+ * Study session actor. All session state is owned by a single consumer;
+ * posting never blocks and never re-enters the consumer.
+ */
+@interface MBStudySessionActor : NSObject
+
+/// Receiver of batched events
+@property (nonatomic, weak, nullable) id<MBStudySessionActorDelegate> delegate;
+
+/// Last state published by the consumer
+@property (nonatomic, assign, readonly) MBStudySessionState state;
+
+/// Study mode of the current or last session
+@property (nonatomic, assign, readonly) MBStudyMode mode;
+
+/// Configuration of the current or last session
+@property (nonatomic, assign, readonly) MBStudyModeConfig config;
+
+/**
+ * Creates an actor delivering events on the given serial queue.
+ *
+ * @param delegateQueue Queue for delegate callbacks, main queue if nil
+ */
+- (instancetype)initWithDelegateQueue:(nullable dispatch_queue_t)delegateQueue NS_DESIGNATED_INITIALIZER;
+
+#pragma mark - Commands
+
+/**
+ * Posts a Start command.
+ *
+ * @param mode Study mode for the new session
+ * @param config Session configuration; rejected if duration or card limits are invalid
+ * @param cardCount Number of cards queued for the session
+ * @return Ticket identifying the command in emitted events, and the session
+ *         of every event of the session it starts
+ */
+- (uint64_t)postStartWithMode:(MBStudyMode)mode
+                       config:(MBStudyModeConfig)config
+                    cardCount:(NSUInteger)cardCount;
+
+/**
+ * Posts a Rate command for the current card.
+ *
+ * @param rating Confidence rating (1-5)
+ * @return Ticket identifying the command in emitted events
+ */
+- (uint64_t)postRating:(NSInteger)rating;
+
+/**
+ * Posts a Voice command with a recognized answer.
+ *
+ * @param input Recognized text
+ * @param confidence Recognition confidence (0-1)
+ * @return Ticket identifying the command in emitted events
+ */
+- (uint64_t)postVoiceInput:(NSString *)input confidence:(CGFloat)confidence;
+
+/// Posts a Pause command
+- (uint64_t)postPause;
+
+/// Posts a Resume command
+- (uint64_t)postResume;
+
+/// Posts an End command
+- (uint64_t)postEnd;
+
+/**
+ * Blocks until every command posted before the call has been applied.
+ * Returns immediately when called from the actor's own queue.
+ */
+- (void)waitUntilDrained;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,557 @@
+//
+//  StudySessionActor.m
+//  membo
+//
+//  Lock-free MPSC command queue (Vyukov intrusive list) drained by a single
+//  consumer on a serial dispatch queue. Session state is only touched by the
+//  consumer, so no command ever waits on another command.
+//
+
+#import "StudySessionActor.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <time.h>
+#include <os/lock.h>
+
+#pragma mark - Constants
+
+/// Maximum number of events delivered to the delegate in one callback
+static const NSUInteger MBStudySessionMaxEventBatch = 256;
+
+/// Lowest and highest accepted confidence ratings
+static const NSInteger MBStudySessionMinRating = 1;
+static const NSInteger MBStudySessionMaxRating = 5;
+
+static const void *const kMBStudySessionActorQueueKey = &kMBStudySessionActorQueueKey;
+
+#pragma mark - Command Queue
+
+typedef struct MBCommandNode {
+    _Atomic(struct MBCommandNode *) next;
+    uint64_t ticket;
+    uint64_t postedAt;
+    MBStudySessionCommandType type;
+    MBStudyMode mode;
+    MBStudyModeConfig config;
+    NSUInteger cardCount;
+    NSInteger rating;
+    CGFloat confidence;
+    CFTypeRef voiceInput;
+} MBCommandNode;
+
+typedef struct {
+    _Atomic(MBCommandNode *) head;
+    MBCommandNode *tail;
+    MBCommandNode stub;
+} MBCommandQueue;
+
+static inline uint64_t MBMonotonicNanos(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+static void MBCommandQueueInit(MBCommandQueue *queue) {
+    atomic_init(&queue->stub.next, NULL);
+    atomic_init(&queue->head, &queue->stub);
+    queue->tail = &queue->stub;
+}
+
+/// Multi-producer push: one atomic exchange, then publish the link.
+static void MBCommandQueuePush(MBCommandQueue *queue, MBCommandNode *node) {
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    MBCommandNode *prev = atomic_exchange_explicit(&queue->head, node, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+/// Single-consumer pop. Returns NULL when empty or while a producer is mid-push.
+static MBCommandNode *MBCommandQueuePop(MBCommandQueue *queue) {
+    MBCommandNode *tail = queue->tail;
+    MBCommandNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    if (tail == &queue->stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
+
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != atomic_load_explicit(&queue->head, memory_order_acquire)) {
+        return NULL;
+    }
+
+    MBCommandQueuePush(queue, &queue->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+static void MBCommandNodeFree(MBCommandNode *node) {
+    if (node->voiceInput) {
+        CFRelease(node->voiceInput);
+    }
+    free(node);
+}
+
+#pragma mark - Transition Function
+
+BOOL MBStudySessionTransition(MBStudySessionState state,
+                              MBStudySessionCommandType command,
+                              MBStudySessionState *nextState) {
+    MBStudySessionState next = state;
+    BOOL valid = NO;
+
+    switch (state) {
+        case MBStudySessionStateIdle:
+        case MBStudySessionStateEnded:
+            if (command == MBStudySessionCommandStart) {
+                next = MBStudySessionStateActive;
+                valid = YES;
+            }
+            break;
+        case MBStudySessionStateActive:
+            switch (command) {
+                case MBStudySessionCommandRate:
+                case MBStudySessionCommandVoice:
+                    valid = YES;
+                    break;
+                case MBStudySessionCommandPause:
+                    next = MBStudySessionStatePaused;
+                    valid = YES;
+                    break;
+                case MBStudySessionCommandEnd:
+                    next = MBStudySessionStateEnded;
+                    valid = YES;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case MBStudySessionStatePaused:
+            if (command == MBStudySessionCommandResume) {
+                next = MBStudySessionStateActive;
+                valid = YES;
+            } else if (command == MBStudySessionCommandEnd) {
+                next = MBStudySessionStateEnded;
+                valid = YES;
+            }
+            break;
+    }
+
+    if (valid && nextState) {
+        *nextState = next;
+    }
+    return valid;
+}
+
+static BOOL MBStudySessionConfigIsValid(MBStudyModeConfig config) {
+    return config.sessionDuration > 0 &&
+           config.minCardsPerSession > 0 &&
+           config.maxCardsPerSession >= config.minCardsPerSession;
+}
+
+#pragma mark - Event
+
+@interface MBStudySessionEvent ()
+
+- (instancetype)initWithType:(MBStudySessionEventType)type
+                        node:(const MBCommandNode *)node
+                       state:(MBStudySessionState)state
+                     session:(uint64_t)session
+                        mode:(MBStudyMode)mode
+                       stats:(nullable NSDictionary<NSString *, NSNumber *> *)stats
+                   appliedAt:(uint64_t)appliedAt;
+
+@end
+
+@implementation MBStudySessionEvent
+
+- (instancetype)initWithType:(MBStudySessionEventType)type
+                        node:(const MBCommandNode *)node
+                       state:(MBStudySessionState)state
+                     session:(uint64_t)session
+                        mode:(MBStudyMode)mode
+                       stats:(nullable NSDictionary<NSString *, NSNumber *> *)stats
+                   appliedAt:(uint64_t)appliedAt {
+    self = [super init];
+    if (self) {
+        _type = type;
+        _command = node->type;
+        _state = state;
+        _ticket = node->ticket;
+        _session = session;
+        _mode = mode;
+        _rating = node->type == MBStudySessionCommandRate ? node->rating : 0;
+        _voiceInput = node->voiceInput ? [(__bridge NSString *)node->voiceInput copy] : nil;
+        _voiceConfidence = node->confidence;
+        _stats = [stats copy];
+        _queueLatencyNanos = appliedAt > node->postedAt ? appliedAt - node->postedAt : 0;
+    }
+    return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    NSMutableDictionary *dict = [NSMutableDictionary dictionaryWithDictionary:@{
+        @"type": @(self.type),
+        @"command": @(self.command),
+        @"state": @(self.state),
+        @"ticket": @(self.ticket),
+        @"session": @(self.session),
+        @"mode": @(self.mode)
+    }];
+    if (self.type == MBStudySessionEventRated) {
+        dict[@"rating"] = @(self.rating);
+    }
+    if (self.voiceInput) {
+        dict[@"voiceInput"] = self.voiceInput;
+        dict[@"voiceConfidence"] = @(self.voiceConfidence);
+    }
+    if (self.stats) {
+        dict[@"stats"] = self.stats;
+    }
+    return dict;
+}
+
+@end
+
+#pragma mark - Implementation
+
+@implementation MBStudySessionActor {
+    MBCommandQueue _queue;
+    _Atomic(uint64_t) _nextTicket;
+    _Atomic(uint64_t) _pending;
+    _Atomic(NSInteger) _publishedState;
+    _Atomic(NSInteger) _publishedMode;
+    os_unfair_lock _configLock;
+    MBStudyModeConfig _publishedConfig;
+
+    dispatch_queue_t _actorQueue;
+    dispatch_queue_t _delegateQueue;
+
+    // Consumer-owned session state; only touched on _actorQueue
+    MBStudySessionState _state;
+    uint64_t _session;
+    MBStudyMode _mode;
+    MBStudyModeConfig _config;
+    NSUInteger _cardCount;
+    NSUInteger _cardsReviewed;
+    NSUInteger _ratingCounts[MBStudySessionMaxRating + 1];
+    NSUInteger _voiceAttempts;
+    NSUInteger _voiceAccepted;
+    uint64_t _activeSince;
+    uint64_t _activeNanos;
+}
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithDelegateQueue:(nullable dispatch_queue_t)delegateQueue {
+    self = [super init];
+    if (self) {
+        MBCommandQueueInit(&_queue);
+        atomic_init(&_nextTicket, 1);
+        atomic_init(&_pending, 0);
+        atomic_init(&_publishedState, MBStudySessionStateIdle);
+        atomic_init(&_publishedMode, MBStudyModeStandard);
+        _configLock = OS_UNFAIR_LOCK_INIT;
+
+        _actorQueue = dispatch_queue_create("ai.membo.studysession.actor",
+                                            dispatch_queue_attr_make_with_qos_class(
+                                                DISPATCH_QUEUE_SERIAL,
+                                                QOS_CLASS_USER_INITIATED, 0));
+        dispatch_queue_set_specific(_actorQueue, kMBStudySessionActorQueueKey,
+                                    (__bridge void *)self, NULL);
+        _delegateQueue = delegateQueue ?: dispatch_get_main_queue();
+
+        _state = MBStudySessionStateIdle;
+        _mode = MBStudyModeStandard;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    MBCommandNode *node;
+    while ((node = MBCommandQueuePop(&_queue)) != NULL) {
+        if (node != &_queue.stub) {
+            MBCommandNodeFree(node);
+        }
+    }
+}
+
+#pragma mark - Published Snapshot
+
+- (MBStudySessionState)state {
+    return (MBStudySessionState)atomic_load_explicit(&_publishedState, memory_order_acquire);
+}
+
+- (MBStudyMode)mode {
+    return (MBStudyMode)atomic_load_explicit(&_publishedMode, memory_order_acquire);
+}
+
+- (MBStudyModeConfig)config {
+    os_unfair_lock_lock(&_configLock);
+    MBStudyModeConfig config = _publishedConfig;
+    os_unfair_lock_unlock(&_configLock);
+    return config;
+}
+
+#pragma mark - Commands
+
+- (uint64_t)postStartWithMode:(MBStudyMode)mode
+                       config:(MBStudyModeConfig)config
+                    cardCount:(NSUInteger)cardCount {
+    MBCommandNode *node = [self newNodeOfType:MBStudySessionCommandStart];
+    node->mode = mode;
+    node->config = config;
+    node->cardCount = cardCount;
+    return [self enqueueNode:node];
+}
+
+- (uint64_t)postRating:(NSInteger)rating {
+    MBCommandNode *node = [self newNodeOfType:MBStudySessionCommandRate];
+    node->rating = rating;
+    return [self enqueueNode:node];
+}
+
+- (uint64_t)postVoiceInput:(NSString *)input confidence:(CGFloat)confidence {
+    MBCommandNode *node = [self newNodeOfType:MBStudySessionCommandVoice];
+    node->voiceInput = CFBridgingRetain([input copy]);
+    node->confidence = confidence;
+    return [self enqueueNode:node];
+}
+
+- (uint64_t)postPause {
+    return [self enqueueNode:[self newNodeOfType:MBStudySessionCommandPause]];
+}
+
+- (uint64_t)postResume {
+    return [self enqueueNode:[self newNodeOfType:MBStudySessionCommandResume]];
+}
+
+- (uint64_t)postEnd {
+    return [self enqueueNode:[self newNodeOfType:MBStudySessionCommandEnd]];
+}
+
+- (void)waitUntilDrained {
+    if (dispatch_get_specific(kMBStudySessionActorQueueKey) == (__bridge void *)self) {
+        return;
+    }
+    dispatch_sync(_actorQueue, ^{
+        [self drain];
+    });
+}
+
+#pragma mark - Producer Side
+
+- (MBCommandNode *)newNodeOfType:(MBStudySessionCommandType)type {
+    MBCommandNode *node = calloc(1, sizeof(MBCommandNode));
+    node->type = type;
+    return node;
+}
+
+- (uint64_t)enqueueNode:(MBCommandNode *)node {
+    uint64_t ticket = atomic_fetch_add_explicit(&_nextTicket, 1, memory_order_relaxed);
+    node->ticket = ticket;
+    node->postedAt = MBMonotonicNanos();
+
+    // Count before linking so the consumer never observes more nodes than
+    // pending commands; only the producer that lifts the count off zero
+    // schedules a drain.
+    uint64_t previous = atomic_fetch_add_explicit(&_pending, 1, memory_order_acq_rel);
+    MBCommandQueuePush(&_queue, node);
+
+    if (previous == 0) {
+        dispatch_async(_actorQueue, ^{
+            [self drain];
+        });
+    }
+    return ticket;
+}
+
+#pragma mark - Consumer Side
+
+- (void)drain {
+    NSMutableArray<MBStudySessionEvent *> *batch = nil;
+
+    while (atomic_load_explicit(&_pending, memory_order_acquire) > 0) {
+        MBCommandNode *node = MBCommandQueuePop(&_queue);
+        if (node == NULL) {
+            // A producer has counted its command but not linked it yet
+            sched_yield();
+            continue;
+        }
+
+        if (!batch) {
+            batch = [NSMutableArray array];
+        }
+        [self applyNode:node events:batch];
+        MBCommandNodeFree(node);
+        atomic_fetch_sub_explicit(&_pending, 1, memory_order_acq_rel);
+
+        if (batch.count >= MBStudySessionMaxEventBatch) {
+            [self deliverEvents:batch];
+            batch = nil;
+        }
+    }
+
+    if (batch.count > 0) {
+        [self deliverEvents:batch];
+    }
+}
+
+- (void)deliverEvents:(NSArray<MBStudySessionEvent *> *)events {
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(_delegateQueue, ^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (strongSelf) {
+            [strongSelf.delegate studySessionActor:strongSelf didEmitEvents:events];
+        }
+    });
+}
+
+- (void)applyNode:(MBCommandNode *)node events:(NSMutableArray<MBStudySessionEvent *> *)events {
+    uint64_t now = MBMonotonicNanos();
+    MBStudySessionState nextState = _state;
+
+    if (!MBStudySessionTransition(_state, node->type, &nextState)) {
+        [events addObject:[self eventOfType:MBStudySessionEventRejected node:node stats:nil at:now]];
+        return;
+    }
+
+    switch (node->type) {
+        case MBStudySessionCommandStart:
+            if (!MBStudySessionConfigIsValid(node->config)) {
+                [events addObject:[self eventOfType:MBStudySessionEventRejected node:node stats:nil at:now]];
+                return;
+            }
+            [self resetSessionWithNode:node at:now];
+            [self publishState:nextState];
+            [events addObject:[self eventOfType:MBStudySessionEventStarted node:node stats:nil at:now]];
+            break;
+
+        case MBStudySessionCommandRate:
+            if (node->rating < MBStudySessionMinRating || node->rating > MBStudySessionMaxRating) {
+                [events addObject:[self eventOfType:MBStudySessionEventRejected node:node stats:nil at:now]];
+                return;
+            }
+            _cardsReviewed++;
+            _ratingCounts[node->rating]++;
+            [events addObject:[self eventOfType:MBStudySessionEventRated node:node stats:nil at:now]];
+
+            if ([self sessionLimitReachedAt:now]) {
+                [self finishSessionWithNode:node at:now events:events];
+            }
+            break;
+
+        case MBStudySessionCommandVoice:
+            if (_mode != MBStudyModeVoice) {
+                [events addObject:[self eventOfType:MBStudySessionEventRejected node:node stats:nil at:now]];
+                return;
+            }
+            _voiceAttempts++;
+            if (node->confidence >= _config.voiceConfidenceThreshold) {
+                _voiceAccepted++;
+            }
+            [events addObject:[self eventOfType:MBStudySessionEventVoiceReceived node:node stats:nil at:now]];
+            break;
+
+        case MBStudySessionCommandPause:
+            _activeNanos += now - _activeSince;
+            [self publishState:nextState];
+            [events addObject:[self eventOfType:MBStudySessionEventPaused node:node stats:nil at:now]];
+            break;
+
+        case MBStudySessionCommandResume:
+            _activeSince = now;
+            [self publishState:nextState];
+            [events addObject:[self eventOfType:MBStudySessionEventResumed node:node stats:nil at:now]];
+            break;
+
+        case MBStudySessionCommandEnd:
+            [self finishSessionWithNode:node at:now events:events];
+            break;
+    }
+}
+
+- (void)resetSessionWithNode:(const MBCommandNode *)node at:(uint64_t)now {
+    _session = node->ticket;
+    _mode = node->mode;
+    _config = node->config;
+    _cardCount = node->cardCount;
+    _cardsReviewed = 0;
+    memset(_ratingCounts, 0, sizeof(_ratingCounts));
+    _voiceAttempts = 0;
+    _voiceAccepted = 0;
+    _activeSince = now;
+    _activeNanos = 0;
+
+    atomic_store_explicit(&_publishedMode, _mode, memory_order_release);
+    os_unfair_lock_lock(&_configLock);
+    _publishedConfig = _config;
+    os_unfair_lock_unlock(&_configLock);
+}
+
+- (BOOL)sessionLimitReachedAt:(uint64_t)now {
+    NSTimeInterval elapsed = (_activeNanos + (now - _activeSince)) / (double)NSEC_PER_SEC;
+    return (NSInteger)_cardsReviewed >= _config.maxCardsPerSession ||
+           elapsed >= _config.sessionDuration;
+}
+
+- (void)finishSessionWithNode:(const MBCommandNode *)node
+                           at:(uint64_t)now
+                       events:(NSMutableArray<MBStudySessionEvent *> *)events {
+    if (_state == MBStudySessionStateActive) {
+        _activeNanos += now - _activeSince;
+    }
+    [self publishState:MBStudySessionStateEnded];
+    [events addObject:[self eventOfType:MBStudySessionEventCompleted
+                                   node:node
+                                  stats:[self finalStats]
+                                     at:now]];
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)finalStats {
+    NSMutableDictionary<NSString *, NSNumber *> *stats = [NSMutableDictionary dictionary];
+    stats[@"duration"] = @(_activeNanos / (double)NSEC_PER_SEC);
+    stats[@"totalCards"] = @(_cardsReviewed);
+    stats[@"completionRate"] = @(_cardCount > 0 ? _cardsReviewed / (double)_cardCount : 0.0);
+
+    for (NSInteger rating = MBStudySessionMinRating; rating <= MBStudySessionMaxRating; rating++) {
+        stats[[NSString stringWithFormat:@"rating%ld", (long)rating]] = @(_ratingCounts[rating]);
+    }
+
+    if (_mode == MBStudyModeVoice) {
+        stats[@"voiceAttempts"] = @(_voiceAttempts);
+        stats[@"voiceAccuracy"] = @(_voiceAttempts > 0 ? _voiceAccepted / (double)_voiceAttempts : 0.0);
+    }
+    return stats;
+}
+
+- (void)publishState:(MBStudySessionState)state {
+    _state = state;
+    atomic_store_explicit(&_publishedState, state, memory_order_release);
+}
+
+- (MBStudySessionEvent *)eventOfType:(MBStudySessionEventType)type
+                                node:(const MBCommandNode *)node
+                               stats:(nullable NSDictionary<NSString *, NSNumber *> *)stats
+                                  at:(uint64_t)now {
+    return [[MBStudySessionEvent alloc] initWithType:type
+                                                node:node
+                                               state:_state
+                                             session:_session
+                                                mode:_mode
+                                               stats:stats
+                                           appliedAt:now];
+}
+
+@end
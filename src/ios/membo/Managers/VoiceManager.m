@@ -7,6 +7,7 @@
 //
 
 #import "VoiceManager.h"
+#import "Utils/TraceRing.h"
 
 #pragma mark - Constants
 
@@ -86,6 +87,8 @@ static dispatch_queue_t voiceQueue;
 #pragma mark - Voice Recognition Control
 
 - (void)startVoiceRecognition:(void (^)(NSString * _Nullable, NSError * _Nullable))completion {
+    // Start latency spans from the request to the engine listening
+    uint64_t traceStart = MBTraceBegin();
     dispatch_async(voiceQueue, ^{
         if (self.isProcessing) {
             NSError *error = [NSError errorWithDomain:MBVoiceRecognitionErrorDomain
@@ -106,6 +109,7 @@ static dispatch_queue_t voiceQueue;
             
             // Configure and activate audio session
             if (![[AudioSessionManager sharedInstance] activateAudioSession]) {
+                MBTraceEnd(MBTraceSpanVoiceStart, traceStart, NO);
                 NSError *sessionError = [NSError errorWithDomain:MBVoiceRecognitionErrorDomain
                                                           code:VoiceRecognitionErrorAudioSession
                                                       userInfo:@{NSLocalizedDescriptionKey: @"Failed to activate audio session"}];
@@ -156,6 +160,7 @@ static dispatch_queue_t voiceQueue;
             // Start audio engine
             NSError *audioError = nil;
             if (![self.audioEngine startAndReturnError:&audioError]) {
+                MBTraceEnd(MBTraceSpanVoiceStart, traceStart, NO);
                 [self stopVoiceRecognition];
                 dispatch_async(dispatch_get_main_queue(), ^{
                     completion(nil, audioError);
@@ -166,6 +171,7 @@ static dispatch_queue_t voiceQueue;
             // Update state and start timeout timer
             self.currentState = VoiceRecognitionStateListening;
             self.isProcessing = YES;
+            MBTraceEnd(MBTraceSpanVoiceStart, traceStart, YES);
             
             [self startTimeoutTimer];
             
@@ -177,6 +183,7 @@ static dispatch_queue_t voiceQueue;
 
 - (void)stopVoiceRecognition {
     dispatch_async(voiceQueue, ^{
+        uint64_t traceStart = MBTraceBegin();
         [self.timeoutTimer invalidate];
         self.timeoutTimer = nil;
         
@@ -191,6 +198,7 @@ static dispatch_queue_t voiceQueue;
         
         self.currentState = VoiceRecognitionStateFinished;
         self.isProcessing = NO;
+        MBTraceEnd(MBTraceSpanVoiceStop, traceStart, YES);
         
         [self postStateChangeNotificationWithPreviousState:previousState];
     });
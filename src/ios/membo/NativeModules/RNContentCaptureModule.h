@@ -71,6 +71,18 @@ RCT_EXTERN_METHOD(captureKindleContent:(NSArray *)highlights
                   resolve:(RCTPromiseResolveBlock)resolve
                   reject:(RCTPromiseRejectBlock)reject)
 
+/**
+ * Incremental import of a Kindle "My Clippings.txt" export; only highlights
+ * not captured before are saved
+ *
+ * @param filePath Local path of the export file
+ * @param resolve Promise resolution block with imported, skipped and book counts
+ * @param reject Promise rejection block
+ */
+RCT_EXTERN_METHOD(importKindleClippings:(NSString *)filePath
+                  resolve:(RCTPromiseResolveBlock)resolve
+                  reject:(RCTPromiseRejectBlock)reject)
+
 /**
  * Reliable content synchronization with retry logic and conflict resolution
  *
@@ -175,6 +175,29 @@ RCT_EXPORT_METHOD(captureKindleContent:(NSArray *)highlights
     });
 }
 
+RCT_EXPORT_METHOD(importKindleClippings:(NSString *)filePath
+                  resolve:(RCTPromiseResolveBlock)resolve
+                  reject:(RCTPromiseRejectBlock)reject) {
+    // Validate input parameters
+    if (!filePath.length || ![[NSFileManager defaultManager] isReadableFileAtPath:filePath]) {
+        NSError *error = errorWithCode(MEMBO_ERROR_VALIDATION, @{
+            @"detail": @"Clippings file not found"
+        });
+        reject(@"VALIDATION_ERROR", error.localizedDescription, error);
+        return;
+    }
+    
+    // Parsing and dedup run on the manager's highlight queue
+    [_contentCaptureManager importKindleClippingsAtURL:[NSURL fileURLWithPath:filePath]
+                                            completion:^(NSDictionary * _Nullable summary, NSError * _Nullable error) {
+        if (summary) {
+            resolve(summary);
+        } else {
+            reject(@"KINDLE_ERROR", error.localizedDescription, error);
+        }
+    }];
+}
+
 RCT_EXPORT_METHOD(syncContent:(RCTPromiseResolveBlock)resolve
                   reject:(RCTPromiseRejectBlock)reject) {
     // Dispatch sync operation to serial queue
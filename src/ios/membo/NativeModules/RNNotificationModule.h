@@ -55,6 +55,17 @@ RCT_EXTERN_METHOD(scheduleStudyReminder:(NSDictionary *)options
                   resolve:(RCTPromiseResolveBlock)resolve
                   reject:(RCTPromiseRejectBlock)reject)
 
+/**
+ * Replans study reminders natively from the local due forecast, applying
+ * only changes to what is already scheduled.
+ * Exposed to JavaScript as `planStudyReminders`.
+ *
+ * @param resolve Promise resolve callback with added, removed and unchanged reminders
+ * @param reject Promise reject callback
+ */
+RCT_EXTERN_METHOD(planStudyReminders:(RCTPromiseResolveBlock)resolve
+                  reject:(RCTPromiseRejectBlock)reject)
+
 /**
  * Cancels all pending notifications.
  * Exposed to JavaScript as `cancelAllNotifications`.
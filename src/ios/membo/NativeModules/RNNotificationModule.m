@@ -7,6 +7,7 @@
 //
 
 #import "RNNotificationModule.h"
+#import "Utils/CardStore.h"
 
 @implementation RNNotificationModule {
     MBNotificationManager *_notificationManager;
@@ -139,6 +140,28 @@ RCT_EXPORT_METHOD(scheduleStudyReminder:(NSDictionary *)options
     });
 }
 
+RCT_EXPORT_METHOD(planStudyReminders:(RCTPromiseResolveBlock)resolve
+                  reject:(RCTPromiseRejectBlock)reject) {
+    MBCardStore *store = [MBCardStore sharedStore];
+    if (!store) {
+        reject(MEMBO_ERROR_SERVICE_UNAVAILABLE,
+               localizedMessageForErrorCode(MEMBO_ERROR_SERVICE_UNAVAILABLE, nil),
+               nil);
+        return;
+    }
+
+    [_notificationManager planStudyRemindersFromStore:store
+                                    completionHandler:^(MBReminderPlanDiff * _Nullable diff, NSError * _Nullable error) {
+        if (error) {
+            reject(MEMBO_ERROR_INTERNAL,
+                  localizedMessageForErrorCode(MEMBO_ERROR_INTERNAL, nil),
+                  error);
+            return;
+        }
+        resolve([diff dictionaryRepresentation]);
+    }];
+}
+
 RCT_EXPORT_METHOD(cancelAllNotifications:(RCTPromiseResolveBlock)resolve
                   reject:(RCTPromiseRejectBlock)reject) {
     dispatch_async(_notificationQueue, ^{
@@ -205,6 +228,12 @@ RCT_EXPORT_METHOD(getNotificationSettings:(RCTPromiseResolveBlock)resolve
             [self->_pendingNotifications removeObjectForKey:identifier];
         }];
     });
+
+    // Reviews may have happened on other devices; refresh reminders against the new forecast
+    MBCardStore *store = [MBCardStore sharedStore];
+    if (store) {
+        [_notificationManager planStudyRemindersFromStore:store completionHandler:nil];
+    }
 }
 
 @end
\ No newline at end of file
@@ -26,8 +26,6 @@ NS_ASSUME_NONNULL_BEGIN
 /// Shared instance of StudyManager for session management
 @property (nonatomic, strong) StudyManager *studyManager;
 
-/// Dedicated queue for thread-safe study operations
-@property (nonatomic, strong) dispatch_queue_t processingQueue;
 
 #pragma mark - React Native Methods
 
@@ -58,6 +56,24 @@ RCT_EXTERN_METHOD(submitCardResponse:(NSInteger)confidence
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject)
 
+/**
+ * Pauses the current study session.
+ *
+ * @param resolve Promise resolve callback
+ * @param reject Promise reject callback
+ */
+RCT_EXTERN_METHOD(pauseStudySession:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+
+/**
+ * Resumes a paused study session.
+ *
+ * @param resolve Promise resolve callback
+ * @param reject Promise reject callback
+ */
+RCT_EXTERN_METHOD(resumeStudySession:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+
 /**
  * Ends the current study session and processes results.
  *
@@ -67,6 +83,27 @@ RCT_EXTERN_METHOD(submitCardResponse:(NSInteger)confidence
 RCT_EXTERN_METHOD(endStudySession:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject)
 
+/**
+ * Sets the backend endpoint and credentials the offline card store syncs with.
+ *
+ * @param options Dictionary with `endpoint` and optional `authToken`
+ * @param resolve Promise resolve callback
+ * @param reject Promise reject callback
+ */
+RCT_EXTERN_METHOD(configureCardSync:(NSDictionary *)options
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+
+/**
+ * Pushes offline reviews, then pulls other devices' reviews and changed cards
+ * into the offline card store.
+ *
+ * @param resolve Resolves with pushed, pulled and cards counts
+ * @param reject Promise reject callback
+ */
+RCT_EXTERN_METHOD(syncCards:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+
 #pragma mark - Required RCTBridgeModule Methods
 
 /**
@@ -11,11 +11,13 @@
 #import "RNStudyModule.h"
 #import <React/RCTLog.h>
 #import <AVFoundation/AVFoundation.h>
+#import "Managers/CardSyncManager.h"
 
+// Bridge calls and StudyManager delegate callbacks both run on the main queue,
+// so _sessionStats needs no lock. Session work itself happens on the session
+// actor; bridge methods only post commands.
 @implementation RNStudyModule {
     StudyManager *_studyManager;
-    dispatch_queue_t _synchronizationQueue;
-    NSLock *_statsLock;
     NSMutableDictionary *_sessionStats;
     AudioSessionManager *_audioManager;
 }
@@ -28,14 +30,7 @@
         _studyManager = [StudyManager sharedInstance];
         _studyManager.delegate = self;
         
-        // Create synchronization queue with user-initiated QoS
-        _synchronizationQueue = dispatch_queue_create("ai.membo.studymodule.sync",
-                                                    dispatch_queue_attr_make_with_qos_class(
-                                                        DISPATCH_QUEUE_SERIAL,
-                                                        QOS_CLASS_USER_INITIATED, 0));
-        
-        // Initialize thread-safe statistics tracking
-        _statsLock = [[NSLock alloc] init];
+        // Initialize statistics tracking
         _sessionStats = [NSMutableDictionary dictionary];
         
         // Initialize audio session manager for voice features
@@ -60,131 +55,165 @@
     return NO;
 }
 
+- (dispatch_queue_t)methodQueue {
+    return dispatch_get_main_queue();
+}
+
 #pragma mark - Public Methods
 
 RCT_EXPORT_METHOD(startStudySession:(NSDictionary *)config
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
-    dispatch_async(_synchronizationQueue, ^{
-        @try {
-            // Validate study mode
-            NSNumber *modeNumber = config[@"mode"];
-            MBStudyMode mode = [modeNumber integerValue];
-            if (mode < MBStudyModeStandard || mode > MBStudyModeQuiz) {
-                reject(@"invalid_mode", @"Invalid study mode specified", nil);
+    @try {
+        // Validate study mode
+        NSNumber *modeNumber = config[@"mode"];
+        MBStudyMode mode = [modeNumber integerValue];
+        if (mode < MBStudyModeStandard || mode > MBStudyModeQuiz) {
+            reject(@"invalid_mode", @"Invalid study mode specified", nil);
+            return;
+        }
+        
+        // Create study mode configuration
+        MBStudyModeConfig modeConfig = {
+            .sessionDuration = [config[@"duration"] doubleValue] ?: MB_DEFAULT_SESSION_DURATION,
+            .allowVoiceInput = [config[@"enableVoice"] boolValue],
+            .showConfidenceButtons = [config[@"showConfidence"] boolValue] ?: YES,
+            .enableFSRS = [config[@"enableFSRS"] boolValue] ?: YES,
+            .minCardsPerSession = [config[@"minCards"] integerValue] ?: MB_MIN_CARDS_PER_SESSION,
+            .maxCardsPerSession = [config[@"maxCards"] integerValue] ?: MB_MAX_CARDS_PER_SESSION,
+            .voiceConfidenceThreshold = [config[@"voiceThreshold"] floatValue] ?: MB_DEFAULT_VOICE_CONFIDENCE_THRESHOLD,
+            .enableAutoAdvance = [config[@"autoAdvance"] boolValue],
+            .cardDisplayDuration = [config[@"cardDuration"] doubleValue] ?: 0.0,
+            .enableHapticFeedback = [config[@"hapticFeedback"] boolValue] ?: YES
+        };
+        
+        // Configure voice processing if enabled
+        if (modeConfig.allowVoiceInput) {
+            if (![self configureVoiceProcessing]) {
+                reject(@"voice_setup_failed", @"Failed to configure voice processing", nil);
                 return;
             }
-            
-            // Create study mode configuration
-            MBStudyModeConfig modeConfig = {
-                .sessionDuration = [config[@"duration"] doubleValue] ?: MB_DEFAULT_SESSION_DURATION,
-                .allowVoiceInput = [config[@"enableVoice"] boolValue],
-                .showConfidenceButtons = [config[@"showConfidence"] boolValue] ?: YES,
-                .enableFSRS = [config[@"enableFSRS"] boolValue] ?: YES,
-                .minCardsPerSession = [config[@"minCards"] integerValue] ?: MB_MIN_CARDS_PER_SESSION,
-                .maxCardsPerSession = [config[@"maxCards"] integerValue] ?: MB_MAX_CARDS_PER_SESSION,
-                .voiceConfidenceThreshold = [config[@"voiceThreshold"] floatValue] ?: MB_DEFAULT_VOICE_CONFIDENCE_THRESHOLD,
-                .enableAutoAdvance = [config[@"autoAdvance"] boolValue],
-                .cardDisplayDuration = [config[@"cardDuration"] doubleValue] ?: 0.0,
-                .enableHapticFeedback = [config[@"hapticFeedback"] boolValue] ?: YES
-            };
-            
-            // Configure voice processing if enabled
-            if (modeConfig.allowVoiceInput) {
-                if (![self configureVoiceProcessing]) {
-                    reject(@"voice_setup_failed", @"Failed to configure voice processing", nil);
-                    return;
-                }
-            }
-            
-            // Initialize session statistics
-            [_statsLock lock];
-            [_sessionStats removeAllObjects];
-            _sessionStats[@"startTime"] = @([[NSDate date] timeIntervalSince1970]);
-            _sessionStats[@"mode"] = @(mode);
-            [_statsLock unlock];
-            
-            // Start study session
-            if ([_studyManager startStudySession:mode config:&modeConfig]) {
-                resolve(@{@"success": @YES});
-            } else {
-                reject(@"session_start_failed", @"Failed to start study session", nil);
-            }
-        } @catch (NSException *exception) {
-            reject(@"unexpected_error", exception.reason, nil);
         }
-    });
+        
+        // Initialize session statistics
+        [_sessionStats removeAllObjects];
+        _sessionStats[@"startTime"] = @([[NSDate date] timeIntervalSince1970]);
+        _sessionStats[@"mode"] = @(mode);
+        
+        // Start study session
+        if ([_studyManager startStudySession:mode config:&modeConfig]) {
+            resolve(@{@"success": @YES});
+        } else {
+            reject(@"session_start_failed", @"Failed to start study session", nil);
+        }
+    } @catch (NSException *exception) {
+        reject(@"unexpected_error", exception.reason, nil);
+    }
 }
 
 RCT_EXPORT_METHOD(submitCardResponse:(NSInteger)confidence
                   voiceInput:(nullable NSString *)voiceInput
+                  voiceConfidence:(float)voiceConfidence
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
-    dispatch_async(_synchronizationQueue, ^{
-        @try {
-            // Validate confidence rating
-            if (confidence < 1 || confidence > 5) {
-                reject(@"invalid_confidence", @"Confidence rating must be between 1 and 5", nil);
-                return;
-            }
-            
-            // Update session statistics atomically
-            [_statsLock lock];
-            NSNumber *responses = _sessionStats[@"totalResponses"];
-            _sessionStats[@"totalResponses"] = @(responses.integerValue + 1);
-            _sessionStats[@"lastConfidence"] = @(confidence);
-            [_statsLock unlock];
-            
-            // Process card response
-            if ([_studyManager processCardResponse:confidence voiceInput:voiceInput]) {
-                resolve(@{
-                    @"success": @YES,
-                    @"confidence": @(confidence),
-                    @"hasVoiceInput": @(voiceInput != nil)
-                });
-            } else {
-                reject(@"response_failed", @"Failed to process card response", nil);
-            }
-        } @catch (NSException *exception) {
-            reject(@"unexpected_error", exception.reason, nil);
-        }
-    });
+    // Validate confidence rating
+    if (confidence < 1 || confidence > 5) {
+        reject(@"invalid_confidence", @"Confidence rating must be between 1 and 5", nil);
+        return;
+    }
+    
+    NSNumber *responses = _sessionStats[@"totalResponses"];
+    _sessionStats[@"totalResponses"] = @(responses.integerValue + 1);
+    _sessionStats[@"lastConfidence"] = @(confidence);
+    
+    // Post card response; the outcome arrives with the next event batch
+    if ([_studyManager processCardResponse:confidence
+                                voiceInput:voiceInput
+                           voiceConfidence:voiceConfidence]) {
+        resolve(@{
+            @"success": @YES,
+            @"confidence": @(confidence),
+            @"hasVoiceInput": @(voiceInput != nil)
+        });
+    } else {
+        reject(@"response_failed", @"No active study session", nil);
+    }
+}
+
+RCT_EXPORT_METHOD(pauseStudySession:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    if (_studyManager.sessionState != MBStudySessionStateActive) {
+        reject(@"pause_failed", @"No running study session", nil);
+        return;
+    }
+    [_studyManager pauseStudySession];
+    resolve(@{@"success": @YES});
+}
+
+RCT_EXPORT_METHOD(resumeStudySession:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    if (_studyManager.sessionState != MBStudySessionStatePaused) {
+        reject(@"resume_failed", @"No paused study session", nil);
+        return;
+    }
+    [_studyManager resumeStudySession];
+    resolve(@{@"success": @YES});
 }
 
 RCT_EXPORT_METHOD(endStudySession:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
-    dispatch_async(_synchronizationQueue, ^{
-        @try {
-            // Calculate final session statistics
-            [_statsLock lock];
-            _sessionStats[@"endTime"] = @([[NSDate date] timeIntervalSince1970]);
-            NSTimeInterval duration = [_sessionStats[@"endTime"] doubleValue] - 
-                                    [_sessionStats[@"startTime"] doubleValue];
-            _sessionStats[@"duration"] = @(duration);
-            [_statsLock unlock];
-            
-            // End study session
-            [_studyManager endStudySession];
-            
-            // Clean up voice processing if needed
-            if (_studyManager.currentConfig.allowVoiceInput) {
-                [_audioManager deactivateAudioSession];
-            }
-            
-            resolve(_sessionStats);
-        } @catch (NSException *exception) {
-            reject(@"unexpected_error", exception.reason, nil);
+    @try {
+        // Calculate final session statistics
+        _sessionStats[@"endTime"] = @([[NSDate date] timeIntervalSince1970]);
+        NSTimeInterval duration = [_sessionStats[@"endTime"] doubleValue] - 
+                                [_sessionStats[@"startTime"] doubleValue];
+        _sessionStats[@"duration"] = @(duration);
+        
+        // End study session
+        [_studyManager endStudySession];
+        
+        // Clean up voice processing if needed
+        if (_studyManager.currentConfig.allowVoiceInput) {
+            [_audioManager deactivateAudioSession];
+        }
+        
+        resolve([_sessionStats copy]);
+    } @catch (NSException *exception) {
+        reject(@"unexpected_error", exception.reason, nil);
+    }
+}
+
+RCT_EXPORT_METHOD(configureCardSync:(NSDictionary *)options
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    NSString *endpoint = [options[@"endpoint"] isKindOfClass:[NSString class]] ? options[@"endpoint"] : nil;
+    NSURL *url = endpoint ? [NSURL URLWithString:endpoint] : nil;
+    if (!url.scheme.length || !url.host.length) {
+        reject(@"invalid_endpoint", @"A card sync endpoint URL is required", nil);
+        return;
+    }
+
+    NSString *authToken = [options[@"authToken"] isKindOfClass:[NSString class]] ? options[@"authToken"] : nil;
+    [[MBCardSyncManager sharedManager] configureWithURL:url authToken:authToken];
+    resolve(@{@"success": @YES});
+}
+
+RCT_EXPORT_METHOD(syncCards:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    [[MBCardSyncManager sharedManager] syncWithCompletion:^(NSDictionary<NSString *, NSNumber *> *totals, NSError *error) {
+        if (totals) {
+            resolve(totals);
+        } else {
+            reject(@"sync_failed", error.localizedDescription ?: @"Card sync failed", error);
         }
-    });
+    }];
 }
 
 #pragma mark - MBStudyManagerDelegate Implementation
 
 - (void)didStartStudySession:(MBStudyMode)mode config:(MBStudyModeConfig *)config {
-    [_statsLock lock];
     _sessionStats[@"activeMode"] = @(mode);
     _sessionStats[@"voiceEnabled"] = @(config->allowVoiceInput);
-    [_statsLock unlock];
     
     [self sendEventWithName:@"studySessionStarted" body:@{
         @"mode": @(mode),
@@ -194,11 +223,19 @@ RCT_EXPORT_METHOD(endStudySession:(RCTPromiseResolveBlock)resolve
 }
 
 - (void)didCompleteStudySession:(NSDictionary<NSString *, NSNumber *> *)stats {
-    [_statsLock lock];
     [_sessionStats addEntriesFromDictionary:stats];
-    [_statsLock unlock];
     
-    [self sendEventWithName:@"studySessionCompleted" body:_sessionStats];
+    [self sendEventWithName:@"studySessionCompleted" body:[_sessionStats copy]];
+}
+
+- (void)didReceiveStudySessionEvents:(NSArray<MBStudySessionEvent *> *)events {
+    NSMutableArray *body = [NSMutableArray arrayWithCapacity:events.count];
+    for (MBStudySessionEvent *event in events) {
+        [body addObject:[event dictionaryRepresentation]];
+    }
+    
+    // One bridge crossing per actor drain instead of one per card
+    [self sendEventWithName:@"studySessionEvents" body:body];
 }
 
 #pragma mark - Private Methods
@@ -212,9 +249,7 @@ RCT_EXPORT_METHOD(endStudySession:(RCTPromiseResolveBlock)resolve
 
 - (void)handleMemoryWarning {
     // Clean up non-essential resources
-    [_statsLock lock];
     [_sessionStats removeObjectsForKeys:@[@"interimStats", @"debugInfo"]];
-    [_statsLock unlock];
 }
 
 - (void)dealloc {
@@ -0,0 +1,45 @@
+//
+//  RNTelemetryModule.h
+//  membo
+//
+//  React Native bridge for native trace upload. JavaScript owns the API base
+//  URL and session token, so it starts and stops the native collector.
+//
+
+#import <React/React.h>  // React Native iOS
+#import <Foundation/Foundation.h>  // iOS SDK 12.0+
+#import "Utils/TraceRing.h"
+#import "Constants/ErrorCodes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * RNTelemetryModule
+ * Controls periodic upload of native trace batches.
+ */
+@interface RNTelemetryModule : NSObject <RCTBridgeModule>
+
+/**
+ * Starts uploading trace batches to the telemetry endpoint.
+ *
+ * @param options Dictionary with `endpoint` (URL string), optional
+ *        `authToken` and optional `intervalMs` (default 60000)
+ * @param resolve Promise resolve callback
+ * @param reject Promise reject callback
+ */
+- (void)startTraceUpload:(NSDictionary *)options
+                resolver:(RCTPromiseResolveBlock)resolve
+                rejecter:(RCTPromiseRejectBlock)reject;
+
+/**
+ * Stops periodic upload after flushing pending spans.
+ *
+ * @param resolve Promise resolve callback
+ * @param reject Promise reject callback
+ */
+- (void)stopTraceUpload:(RCTPromiseResolveBlock)resolve
+               rejecter:(RCTPromiseRejectBlock)reject;
+
+@end
+
+NS_ASSUME_NONNULL_END
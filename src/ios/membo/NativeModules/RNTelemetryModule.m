@@ -0,0 +1,53 @@
+//
+//  RNTelemetryModule.m
+//  membo
+//
+//  React Native bridge for native trace upload.
+//
+
+#import "RNTelemetryModule.h"
+
+// Default drain interval when JavaScript does not supply one
+static const NSTimeInterval kDefaultTraceUploadInterval = 60.0;
+
+@implementation RNTelemetryModule
+
+#pragma mark - Lifecycle
+
++ (BOOL)requiresMainQueueSetup {
+    return NO;
+}
+
+RCT_EXPORT_MODULE(RNTelemetry)
+
+#pragma mark - Trace Upload Methods
+
+RCT_EXPORT_METHOD(startTraceUpload:(NSDictionary *)options
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    NSString *endpoint = [options[@"endpoint"] isKindOfClass:[NSString class]] ? options[@"endpoint"] : nil;
+    NSURL *url = endpoint ? [NSURL URLWithString:endpoint] : nil;
+    if (!url.scheme.length || !url.host.length) {
+        reject(MEMBO_ERROR_VALIDATION,
+               localizedMessageForErrorCode(MEMBO_ERROR_VALIDATION, nil),
+               nil);
+        return;
+    }
+
+    NSString *authToken = [options[@"authToken"] isKindOfClass:[NSString class]] ? options[@"authToken"] : nil;
+    NSNumber *intervalMs = [options[@"intervalMs"] isKindOfClass:[NSNumber class]] ? options[@"intervalMs"] : nil;
+    NSTimeInterval interval = intervalMs ? intervalMs.doubleValue / 1000.0 : kDefaultTraceUploadInterval;
+
+    [[MBTraceCollector sharedCollector] startUploadingToURL:url authToken:authToken interval:interval];
+    resolve(@YES);
+}
+
+RCT_EXPORT_METHOD(stopTraceUpload:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+    MBTraceCollector *collector = [MBTraceCollector sharedCollector];
+    [collector flush];
+    [collector stop];
+    resolve(@YES);
+}
+
+@end
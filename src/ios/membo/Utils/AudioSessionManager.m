@@ -8,6 +8,7 @@
 
 #import "Utils/AudioSessionManager.h"
 #import "Constants/VoiceConstants.h"
+#import "Utils/TraceRing.h"
 
 // Static instance variables
 static AudioSessionManager *sharedManager = nil;
@@ -74,6 +75,7 @@ static dispatch_queue_t audioQueue = nil;
 #pragma mark - Audio Session Configuration
 
 - (BOOL)configureAudioSession {
+    uint64_t traceStart = MBTraceBegin();
     __block BOOL success = NO;
     __block NSError *error = nil;
     
@@ -115,12 +117,14 @@ static dispatch_queue_t audioQueue = nil;
         [self.sessionState setObject:@(kAudioBitDepth) forKey:@"bitDepth"];
     });
     
+    MBTraceEnd(MBTraceSpanAudioConfigure, traceStart, success);
     return success;
 }
 
 #pragma mark - Session Management
 
 - (BOOL)activateAudioSession {
+    uint64_t traceStart = MBTraceBegin();
     __block BOOL success = NO;
     __block NSError *error = nil;
     
@@ -143,10 +147,12 @@ static dispatch_queue_t audioQueue = nil;
                                                           object:self];
     });
     
+    MBTraceEnd(MBTraceSpanAudioActivate, traceStart, success);
     return success;
 }
 
 - (BOOL)deactivateAudioSession {
+    uint64_t traceStart = MBTraceBegin();
     __block BOOL success = NO;
     __block NSError *error = nil;
     
@@ -171,6 +177,7 @@ static dispatch_queue_t audioQueue = nil;
                                                           object:self];
     });
     
+    MBTraceEnd(MBTraceSpanAudioDeactivate, traceStart, success);
     return success;
 }
 
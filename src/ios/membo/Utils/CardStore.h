@@ -0,0 +1,203 @@
+//
+//  CardStore.h
+//  membo
+//
+//  On-device SQLite store for cards, FSRS scheduling state and an append-only
+//  review log. Lets native study sessions run fully offline and sync by
+//  exchanging review-log deltas keyed by sequence number.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Error domain for card store failures
+extern NSString *const MBCardStoreErrorDomain;
+
+/**
+ * Error codes for card store operations.
+ */
+typedef NS_ENUM(NSInteger, MBCardStoreError) {
+    /// Database could not be opened or configured
+    MBCardStoreErrorOpenFailed = 2001,
+    /// Schema creation or migration failed
+    MBCardStoreErrorSchemaFailed = 2002,
+    /// A statement failed to prepare or execute
+    MBCardStoreErrorQueryFailed = 2003,
+    /// Referenced card does not exist
+    MBCardStoreErrorCardNotFound = 2004,
+    /// Invalid argument supplied by the caller
+    MBCardStoreErrorInvalidInput = 2005
+};
+
+#pragma mark - Records
+
+/**
+ * A card together with its FSRS scheduling state.
+ */
+@interface MBCardRecord : NSObject
+
+@property (nonatomic, copy) NSString *cardId;
+@property (nonatomic, copy, nullable) NSString *contentId;
+@property (nonatomic, copy) NSString *front;
+@property (nonatomic, copy) NSString *back;
+@property (nonatomic, assign) double stability;
+@property (nonatomic, assign) double difficulty;
+@property (nonatomic, assign) NSInteger reviewCount;
+@property (nonatomic, assign) NSInteger lastRating;
+@property (nonatomic, strong, nullable) NSDate *lastReviewAt;
+@property (nonatomic, strong) NSDate *dueAt;
+
+@end
+
+/**
+ * One entry of the append-only review log.
+ */
+@interface MBReviewLogEntry : NSObject
+
+/// Local sequence for entries read from the store; server sequence for entries being applied
+@property (nonatomic, assign) int64_t sequence;
+@property (nonatomic, copy) NSString *cardId;
+@property (nonatomic, assign) NSInteger rating;
+@property (nonatomic, strong) NSDate *reviewedAt;
+/// FSRS state after the review
+@property (nonatomic, assign) double stability;
+@property (nonatomic, assign) double difficulty;
+@property (nonatomic, strong) NSDate *dueAt;
+
+/**
+ * Returns a JSON-ready dictionary for sync payloads.
+ */
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+#pragma mark - Store
+
+/**
+ * SQLite-backed card store. Runs in WAL mode with prepared statements;
+ * all statements execute on a private serial queue.
+ */
+@interface MBCardStore : NSObject
+
+/**
+ * Returns the shared store located in Application Support.
+ */
++ (nullable instancetype)sharedStore;
+
+/**
+ * Opens (creating if needed) a store at the given path.
+ *
+ * @param path File system path of the database
+ * @param error Receives the failure reason
+ * @return Store instance, or nil on failure
+ */
+- (nullable instancetype)initWithPath:(NSString *)path error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+#pragma mark - Cards
+
+/**
+ * Inserts cards or updates their content in a single transaction. Scheduling
+ * state of a stored card is only replaced when the incoming card's last review
+ * is at least as recent, so local reviews not yet synced are kept.
+ *
+ * @param cards Cards to store
+ * @param error Receives the failure reason
+ * @return YES on success
+ */
+- (BOOL)upsertCards:(NSArray<MBCardRecord *> *)cards error:(NSError **)error;
+
+/**
+ * Returns IDs of cards due at or before the given date, most overdue first.
+ * Served by a single query over the due index.
+ *
+ * @param date Reference date
+ * @param limit Maximum number of IDs
+ * @param error Receives the failure reason
+ * @return Ordered card IDs, or nil on failure
+ */
+- (nullable NSArray<NSString *> *)dueCardIdsAtDate:(NSDate *)date
+                                             limit:(NSUInteger)limit
+                                             error:(NSError **)error;
+
+/**
+ * Returns the due times of all cards due at or before the given date,
+ * packed as `double` seconds since 1970 in due order. Feeds the reminder
+ * planner without materializing one object per card.
+ *
+ * @param date Forecast horizon
+ * @param error Receives the failure reason
+ * @return Packed due times, or nil on failure
+ */
+- (nullable NSData *)dueTimestampsThroughDate:(NSDate *)date error:(NSError **)error;
+
+/**
+ * Loads a single card with its scheduling state.
+ */
+- (nullable MBCardRecord *)cardWithId:(NSString *)cardId error:(NSError **)error;
+
+/// Number of stored cards
+- (NSUInteger)cardCount;
+
+#pragma mark - Reviews
+
+/**
+ * Applies a review: computes the next FSRS state, updates the card and
+ * appends to the review log in one transaction.
+ *
+ * @param cardId Reviewed card
+ * @param rating Confidence rating (1-5)
+ * @param reviewedAt Review time
+ * @param error Receives the failure reason
+ * @return Sequence number of the new log entry, or 0 on failure
+ */
+- (int64_t)recordReviewForCardId:(NSString *)cardId
+                          rating:(NSInteger)rating
+                      reviewedAt:(NSDate *)reviewedAt
+                           error:(NSError **)error;
+
+/**
+ * Queues a review on the store's queue without blocking the caller.
+ * Reviews queued from one thread are applied in order.
+ */
+- (void)enqueueReviewForCardId:(NSString *)cardId
+                        rating:(NSInteger)rating
+                    reviewedAt:(NSDate *)reviewedAt
+                    completion:(nullable void (^)(int64_t sequence, NSError * _Nullable error))completion;
+
+#pragma mark - Sync
+
+/**
+ * Returns local reviews not yet acknowledged by the server, oldest first.
+ *
+ * @param limit Maximum number of entries
+ * @param error Receives the failure reason
+ * @return Review log delta, or nil on failure
+ */
+- (nullable NSArray<MBReviewLogEntry *> *)pendingReviewsWithLimit:(NSUInteger)limit
+                                                            error:(NSError **)error;
+
+/**
+ * Records that the server has stored every local review up to a sequence.
+ */
+- (BOOL)acknowledgeReviewsThroughSequence:(int64_t)sequence error:(NSError **)error;
+
+/**
+ * Applies reviews made on other devices. Entries at or below the last
+ * applied server sequence are skipped; card state only moves forward in time.
+ *
+ * @param reviews Remote entries carrying server sequence numbers
+ * @param error Receives the failure reason
+ * @return Number of entries applied, or -1 on failure
+ */
+- (NSInteger)applyRemoteReviews:(NSArray<MBReviewLogEntry *> *)reviews error:(NSError **)error;
+
+/// Highest server sequence applied so far; send it as the pull cursor
+- (int64_t)lastRemoteSequence;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
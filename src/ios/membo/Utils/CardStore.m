@@ -0,0 +1,787 @@
+//
+//  CardStore.m
+//  membo
+//
+//  SQLite card store implementation. One connection, one serial queue and a
+//  fixed set of statements prepared at open time.
+//
+
+#import "CardStore.h"
+
+#include <sqlite3.h>
+#include <math.h>
+
+NSString *const MBCardStoreErrorDomain = @"ai.membo.cardstore";
+
+// Schema version stored in PRAGMA user_version
+static const int kCardStoreSchemaVersion = 1;
+
+// sync_state keys
+static const char *const kSyncKeyPushedSequence = "pushed_seq";
+static const char *const kSyncKeyPulledSequence = "pulled_seq";
+
+// review_log origins
+static const int kReviewOriginLocal = 0;
+static const int kReviewOriginRemote = 1;
+
+// FSRS defaults, matching the backend FSRSAlgorithm
+static const double kFSRSDefaultStability = 0.5;
+static const double kFSRSDefaultDifficulty = 0.3;
+static const double kFSRSMinIntervalDays = 4.0 / 24.0;
+static const double kFSRSMaxIntervalDays = 365.0;
+
+// An upserted card's scheduling state replaces the stored state unless the stored
+// card was reviewed later, e.g. offline after the server snapshot was taken
+#define MB_UPSERT_SCHEDULE(column) \
+    " " column " = CASE WHEN COALESCE(excluded.last_review_at, 0) >= COALESCE(cards.last_review_at, 0)" \
+    " THEN excluded." column " ELSE cards." column " END"
+
+static const char *const kSchemaSQL =
+    "CREATE TABLE IF NOT EXISTS cards ("
+    "  id TEXT PRIMARY KEY,"
+    "  content_id TEXT,"
+    "  front TEXT NOT NULL,"
+    "  back TEXT NOT NULL,"
+    "  stability REAL NOT NULL,"
+    "  difficulty REAL NOT NULL,"
+    "  review_count INTEGER NOT NULL DEFAULT 0,"
+    "  last_rating INTEGER NOT NULL DEFAULT 0,"
+    "  last_review_at INTEGER,"
+    "  due_at INTEGER NOT NULL,"
+    "  updated_at INTEGER NOT NULL"
+    ");"
+    "CREATE INDEX IF NOT EXISTS idx_cards_due ON cards(due_at, id);"
+    "CREATE TABLE IF NOT EXISTS review_log ("
+    "  seq INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  card_id TEXT NOT NULL,"
+    "  rating INTEGER NOT NULL,"
+    "  reviewed_at INTEGER NOT NULL,"
+    "  stability REAL NOT NULL,"
+    "  difficulty REAL NOT NULL,"
+    "  due_at INTEGER NOT NULL,"
+    "  origin INTEGER NOT NULL DEFAULT 0,"
+    "  remote_seq INTEGER"
+    ");"
+    "CREATE INDEX IF NOT EXISTS idx_review_log_card ON review_log(card_id, seq);"
+    "CREATE TRIGGER IF NOT EXISTS review_log_no_update BEFORE UPDATE ON review_log "
+    "  BEGIN SELECT RAISE(ABORT, 'review_log is append-only'); END;"
+    "CREATE TRIGGER IF NOT EXISTS review_log_no_delete BEFORE DELETE ON review_log "
+    "  BEGIN SELECT RAISE(ABORT, 'review_log is append-only'); END;"
+    "CREATE TABLE IF NOT EXISTS sync_state ("
+    "  key TEXT PRIMARY KEY,"
+    "  value INTEGER NOT NULL"
+    ");";
+
+#pragma mark - Helpers
+
+static inline int64_t MBMillisFromDate(NSDate *date) {
+    return (int64_t)llround(date.timeIntervalSince1970 * 1000.0);
+}
+
+static inline NSDate *MBDateFromMillis(int64_t millis) {
+    return [NSDate dateWithTimeIntervalSince1970:millis / 1000.0];
+}
+
+static inline void MBBindText(sqlite3_stmt *stmt, int index, NSString *_Nullable value) {
+    if (value) {
+        sqlite3_bind_text(stmt, index, value.UTF8String, -1, SQLITE_TRANSIENT);
+    } else {
+        sqlite3_bind_null(stmt, index);
+    }
+}
+
+static inline NSString *_Nullable MBColumnText(sqlite3_stmt *stmt, int column) {
+    const unsigned char *text = sqlite3_column_text(stmt, column);
+    return text ? [NSString stringWithUTF8String:(const char *)text] : nil;
+}
+
+/**
+ * Next FSRS state after a rating; same formulas as the backend scheduler
+ * without the tier, streak and voice adjustments.
+ */
+static void MBFSRSNextState(double stability, double difficulty, NSInteger rating,
+                            double *nextStability, double *nextDifficulty, double *intervalDays) {
+    double ratingFactor = 1.0 + rating / 5.0;
+
+    double newStability = fmax(stability * pow(ratingFactor, 1.0 - difficulty), kFSRSDefaultStability);
+
+    double newDifficulty = difficulty;
+    if (rating >= 4) {
+        newDifficulty *= 0.9;
+    } else if (rating <= 2) {
+        newDifficulty *= 1.1;
+    }
+    newDifficulty = fmax(0.1, fmin(0.9, newDifficulty));
+
+    double interval = pow(newStability * (1.0 - newDifficulty), 1.0 / ratingFactor);
+
+    *nextStability = newStability;
+    *nextDifficulty = newDifficulty;
+    *intervalDays = fmax(kFSRSMinIntervalDays, fmin(interval, kFSRSMaxIntervalDays));
+}
+
+#pragma mark - Records
+
+@implementation MBCardRecord
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _front = @"";
+        _back = @"";
+        _stability = kFSRSDefaultStability;
+        _difficulty = kFSRSDefaultDifficulty;
+        _dueAt = [NSDate date];
+        _cardId = @"";
+    }
+    return self;
+}
+
+@end
+
+@implementation MBReviewLogEntry
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    return @{
+        @"sequence": @(self.sequence),
+        @"cardId": self.cardId ?: @"",
+        @"rating": @(self.rating),
+        @"reviewedAt": @(MBMillisFromDate(self.reviewedAt)),
+        @"stability": @(self.stability),
+        @"difficulty": @(self.difficulty),
+        @"dueAt": @(MBMillisFromDate(self.dueAt))
+    };
+}
+
+@end
+
+#pragma mark - Store
+
+@implementation MBCardStore {
+    sqlite3 *_db;
+    dispatch_queue_t _queue;
+
+    sqlite3_stmt *_beginStmt;
+    sqlite3_stmt *_commitStmt;
+    sqlite3_stmt *_rollbackStmt;
+    sqlite3_stmt *_upsertCardStmt;
+    sqlite3_stmt *_selectDueStmt;
+    sqlite3_stmt *_selectDueTimesStmt;
+    sqlite3_stmt *_selectCardStmt;
+    sqlite3_stmt *_countCardsStmt;
+    sqlite3_stmt *_selectStateStmt;
+    sqlite3_stmt *_updateStateStmt;
+    sqlite3_stmt *_updateStateIfNewerStmt;
+    sqlite3_stmt *_insertReviewStmt;
+    sqlite3_stmt *_selectPendingStmt;
+    sqlite3_stmt *_selectSyncStmt;
+    sqlite3_stmt *_upsertSyncStmt;
+}
+
+#pragma mark - Lifecycle
+
++ (nullable instancetype)sharedStore {
+    static MBCardStore *sharedStore = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *supportURL = [[NSFileManager defaultManager] URLForDirectory:NSApplicationSupportDirectory
+                                                                   inDomain:NSUserDomainMask
+                                                          appropriateForURL:nil
+                                                                     create:YES
+                                                                      error:nil];
+        NSURL *directory = [supportURL URLByAppendingPathComponent:@"membo" isDirectory:YES];
+        [[NSFileManager defaultManager] createDirectoryAtURL:directory
+                                 withIntermediateDirectories:YES
+                                                  attributes:nil
+                                                       error:nil];
+
+        NSError *error = nil;
+        NSString *path = [directory URLByAppendingPathComponent:@"cards.sqlite"].path;
+        sharedStore = [[MBCardStore alloc] initWithPath:path error:&error];
+        if (!sharedStore) {
+            NSLog(@"[CardStore] Failed to open shared store: %@", error.localizedDescription);
+        }
+    });
+    return sharedStore;
+}
+
+- (nullable instancetype)initWithPath:(NSString *)path error:(NSError **)error {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _queue = dispatch_queue_create("ai.membo.cardstore", DISPATCH_QUEUE_SERIAL);
+
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX |
+                SQLITE_OPEN_FILEPROTECTION_COMPLETEUNTILFIRSTUSERAUTHENTICATION;
+    if (sqlite3_open_v2(path.fileSystemRepresentation, &_db, flags, NULL) != SQLITE_OK) {
+        [self fillError:error code:MBCardStoreErrorOpenFailed description:@"Failed to open card store"];
+        return nil;
+    }
+
+    if (![self exec:"PRAGMA journal_mode=WAL;"
+                     "PRAGMA synchronous=NORMAL;"
+                     "PRAGMA temp_store=MEMORY;"
+                     "PRAGMA cache_size=-8000;"
+               code:MBCardStoreErrorOpenFailed
+              error:error] ||
+        ![self migrateWithError:error] ||
+        ![self prepareStatementsWithError:error]) {
+        return nil;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    sqlite3_stmt *statements[] = {
+        _beginStmt, _commitStmt, _rollbackStmt, _upsertCardStmt, _selectDueStmt, _selectDueTimesStmt,
+        _selectCardStmt, _countCardsStmt, _selectStateStmt, _updateStateStmt,
+        _updateStateIfNewerStmt, _insertReviewStmt, _selectPendingStmt,
+        _selectSyncStmt, _upsertSyncStmt
+    };
+    for (size_t i = 0; i < sizeof(statements) / sizeof(statements[0]); i++) {
+        sqlite3_finalize(statements[i]);
+    }
+    sqlite3_close_v2(_db);
+}
+
+- (BOOL)migrateWithError:(NSError **)error {
+    sqlite3_stmt *stmt = NULL;
+    int version = 0;
+    if (sqlite3_prepare_v2(_db, "PRAGMA user_version;", -1, &stmt, NULL) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+
+    if (version >= kCardStoreSchemaVersion) {
+        return YES;
+    }
+
+    NSString *migration = [NSString stringWithFormat:@"BEGIN;%s PRAGMA user_version=%d; COMMIT;",
+                           kSchemaSQL, kCardStoreSchemaVersion];
+    if (![self exec:migration.UTF8String code:MBCardStoreErrorSchemaFailed error:error]) {
+        sqlite3_exec(_db, "ROLLBACK;", NULL, NULL, NULL);
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)prepareStatementsWithError:(NSError **)error {
+    struct { sqlite3_stmt **stmt; const char *sql; } statements[] = {
+        { &_beginStmt, "BEGIN IMMEDIATE" },
+        { &_commitStmt, "COMMIT" },
+        { &_rollbackStmt, "ROLLBACK" },
+        { &_upsertCardStmt,
+          "INSERT INTO cards (id, content_id, front, back, stability, difficulty,"
+          " review_count, last_rating, last_review_at, due_at, updated_at)"
+          " VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11)"
+          " ON CONFLICT(id) DO UPDATE SET content_id = excluded.content_id, front = excluded.front,"
+          " back = excluded.back, updated_at = excluded.updated_at,"
+          MB_UPSERT_SCHEDULE("stability") ","
+          MB_UPSERT_SCHEDULE("difficulty") ","
+          MB_UPSERT_SCHEDULE("review_count") ","
+          MB_UPSERT_SCHEDULE("last_rating") ","
+          MB_UPSERT_SCHEDULE("due_at") ","
+          MB_UPSERT_SCHEDULE("last_review_at") },
+        { &_selectDueStmt,
+          "SELECT id FROM cards WHERE due_at <= ?1 ORDER BY due_at, id LIMIT ?2" },
+        { &_selectDueTimesStmt,
+          "SELECT due_at FROM cards WHERE due_at <= ?1 ORDER BY due_at" },
+        { &_selectCardStmt,
+          "SELECT id, content_id, front, back, stability, difficulty, review_count,"
+          " last_rating, last_review_at, due_at FROM cards WHERE id = ?1" },
+        { &_countCardsStmt, "SELECT COUNT(*) FROM cards" },
+        { &_selectStateStmt, "SELECT stability, difficulty FROM cards WHERE id = ?1" },
+        { &_updateStateStmt,
+          "UPDATE cards SET stability = ?2, difficulty = ?3, review_count = review_count + 1,"
+          " last_rating = ?4, last_review_at = ?5, due_at = ?6, updated_at = ?7 WHERE id = ?1" },
+        { &_updateStateIfNewerStmt,
+          "UPDATE cards SET stability = ?2, difficulty = ?3, review_count = review_count + 1,"
+          " last_rating = ?4, last_review_at = ?5, due_at = ?6, updated_at = ?7"
+          " WHERE id = ?1 AND COALESCE(last_review_at, 0) <= ?5" },
+        { &_insertReviewStmt,
+          "INSERT INTO review_log (card_id, rating, reviewed_at, stability, difficulty, due_at,"
+          " origin, remote_seq) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)" },
+        { &_selectPendingStmt,
+          "SELECT seq, card_id, rating, reviewed_at, stability, difficulty, due_at FROM review_log"
+          " WHERE origin = 0 AND seq > ?1 ORDER BY seq LIMIT ?2" },
+        { &_selectSyncStmt, "SELECT value FROM sync_state WHERE key = ?1" },
+        { &_upsertSyncStmt, "INSERT OR REPLACE INTO sync_state (key, value) VALUES (?1, ?2)" }
+    };
+
+    for (size_t i = 0; i < sizeof(statements) / sizeof(statements[0]); i++) {
+        if (sqlite3_prepare_v3(_db, statements[i].sql, -1, SQLITE_PREPARE_PERSISTENT,
+                               statements[i].stmt, NULL) != SQLITE_OK) {
+            [self fillError:error code:MBCardStoreErrorSchemaFailed description:@"Failed to prepare statement"];
+            return NO;
+        }
+    }
+    return YES;
+}
+
+#pragma mark - Cards
+
+- (BOOL)upsertCards:(NSArray<MBCardRecord *> *)cards error:(NSError **)error {
+    __block BOOL success = YES;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        success = [self inTransaction:&blockError block:^BOOL(NSError **innerError) {
+            int64_t now = MBMillisFromDate([NSDate date]);
+            for (MBCardRecord *card in cards) {
+                sqlite3_stmt *stmt = self->_upsertCardStmt;
+                MBBindText(stmt, 1, card.cardId);
+                MBBindText(stmt, 2, card.contentId);
+                MBBindText(stmt, 3, card.front);
+                MBBindText(stmt, 4, card.back);
+                sqlite3_bind_double(stmt, 5, card.stability);
+                sqlite3_bind_double(stmt, 6, card.difficulty);
+                sqlite3_bind_int64(stmt, 7, card.reviewCount);
+                sqlite3_bind_int64(stmt, 8, card.lastRating);
+                if (card.lastReviewAt) {
+                    sqlite3_bind_int64(stmt, 9, MBMillisFromDate(card.lastReviewAt));
+                } else {
+                    sqlite3_bind_null(stmt, 9);
+                }
+                sqlite3_bind_int64(stmt, 10, MBMillisFromDate(card.dueAt));
+                sqlite3_bind_int64(stmt, 11, now);
+                if (![self stepDone:stmt error:innerError]) {
+                    return NO;
+                }
+            }
+            return YES;
+        }];
+    });
+
+    if (!success && error) {
+        *error = blockError;
+    }
+    return success;
+}
+
+- (nullable NSArray<NSString *> *)dueCardIdsAtDate:(NSDate *)date
+                                             limit:(NSUInteger)limit
+                                             error:(NSError **)error {
+    __block NSMutableArray<NSString *> *cardIds = nil;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        sqlite3_stmt *stmt = self->_selectDueStmt;
+        sqlite3_bind_int64(stmt, 1, MBMillisFromDate(date));
+        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)MIN(limit, (NSUInteger)INT64_MAX));
+
+        NSMutableArray<NSString *> *results = [NSMutableArray arrayWithCapacity:MIN(limit, (NSUInteger)1024)];
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            [results addObject:MBColumnText(stmt, 0)];
+        }
+        if (rc == SQLITE_DONE) {
+            cardIds = results;
+        } else {
+            [self fillError:&blockError code:MBCardStoreErrorQueryFailed description:@"Failed to load due cards"];
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    });
+
+    if (!cardIds && error) {
+        *error = blockError;
+    }
+    return cardIds;
+}
+
+- (nullable NSData *)dueTimestampsThroughDate:(NSDate *)date error:(NSError **)error {
+    __block NSMutableData *timestamps = nil;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        sqlite3_stmt *stmt = self->_selectDueTimesStmt;
+        sqlite3_bind_int64(stmt, 1, MBMillisFromDate(date));
+
+        NSMutableData *results = [NSMutableData data];
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            double seconds = sqlite3_column_int64(stmt, 0) / 1000.0;
+            [results appendBytes:&seconds length:sizeof(seconds)];
+        }
+        if (rc == SQLITE_DONE) {
+            timestamps = results;
+        } else {
+            [self fillError:&blockError code:MBCardStoreErrorQueryFailed description:@"Failed to load due forecast"];
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    });
+
+    if (!timestamps && error) {
+        *error = blockError;
+    }
+    return timestamps;
+}
+
+- (nullable MBCardRecord *)cardWithId:(NSString *)cardId error:(NSError **)error {
+    __block MBCardRecord *card = nil;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        sqlite3_stmt *stmt = self->_selectCardStmt;
+        MBBindText(stmt, 1, cardId);
+
+        int rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW) {
+            card = [[MBCardRecord alloc] init];
+            card.cardId = MBColumnText(stmt, 0);
+            card.contentId = MBColumnText(stmt, 1);
+            card.front = MBColumnText(stmt, 2) ?: @"";
+            card.back = MBColumnText(stmt, 3) ?: @"";
+            card.stability = sqlite3_column_double(stmt, 4);
+            card.difficulty = sqlite3_column_double(stmt, 5);
+            card.reviewCount = (NSInteger)sqlite3_column_int64(stmt, 6);
+            card.lastRating = (NSInteger)sqlite3_column_int64(stmt, 7);
+            if (sqlite3_column_type(stmt, 8) != SQLITE_NULL) {
+                card.lastReviewAt = MBDateFromMillis(sqlite3_column_int64(stmt, 8));
+            }
+            card.dueAt = MBDateFromMillis(sqlite3_column_int64(stmt, 9));
+        } else if (rc == SQLITE_DONE) {
+            blockError = [NSError errorWithDomain:MBCardStoreErrorDomain
+                                             code:MBCardStoreErrorCardNotFound
+                                         userInfo:@{NSLocalizedDescriptionKey: @"Card not found"}];
+        } else {
+            [self fillError:&blockError code:MBCardStoreErrorQueryFailed description:@"Failed to load card"];
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    });
+
+    if (!card && error) {
+        *error = blockError;
+    }
+    return card;
+}
+
+- (NSUInteger)cardCount {
+    __block NSUInteger count = 0;
+    dispatch_sync(_queue, ^{
+        if (sqlite3_step(self->_countCardsStmt) == SQLITE_ROW) {
+            count = (NSUInteger)sqlite3_column_int64(self->_countCardsStmt, 0);
+        }
+        sqlite3_reset(self->_countCardsStmt);
+    });
+    return count;
+}
+
+#pragma mark - Reviews
+
+- (int64_t)recordReviewForCardId:(NSString *)cardId
+                          rating:(NSInteger)rating
+                      reviewedAt:(NSDate *)reviewedAt
+                           error:(NSError **)error {
+    __block int64_t sequence = 0;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        sequence = [self applyReviewForCardId:cardId rating:rating reviewedAt:reviewedAt error:&blockError];
+    });
+
+    if (sequence == 0 && error) {
+        *error = blockError;
+    }
+    return sequence;
+}
+
+- (void)enqueueReviewForCardId:(NSString *)cardId
+                        rating:(NSInteger)rating
+                    reviewedAt:(NSDate *)reviewedAt
+                    completion:(nullable void (^)(int64_t sequence, NSError * _Nullable error))completion {
+    dispatch_async(_queue, ^{
+        NSError *error = nil;
+        int64_t sequence = [self applyReviewForCardId:cardId rating:rating reviewedAt:reviewedAt error:&error];
+        if (completion) {
+            completion(sequence, error);
+        }
+    });
+}
+
+/// Runs on _queue. Returns the new log sequence, or 0 on failure.
+- (int64_t)applyReviewForCardId:(NSString *)cardId
+                         rating:(NSInteger)rating
+                     reviewedAt:(NSDate *)reviewedAt
+                          error:(NSError **)error {
+    if (rating < 1 || rating > 5) {
+        if (error) {
+            *error = [NSError errorWithDomain:MBCardStoreErrorDomain
+                                         code:MBCardStoreErrorInvalidInput
+                                     userInfo:@{NSLocalizedDescriptionKey: @"Rating must be between 1 and 5"}];
+        }
+        return 0;
+    }
+
+    __block int64_t sequence = 0;
+    [self inTransaction:error block:^BOOL(NSError **innerError) {
+        sqlite3_stmt *select = self->_selectStateStmt;
+        MBBindText(select, 1, cardId);
+        int rc = sqlite3_step(select);
+        double stability = sqlite3_column_double(select, 0);
+        double difficulty = sqlite3_column_double(select, 1);
+        sqlite3_reset(select);
+        sqlite3_clear_bindings(select);
+
+        if (rc != SQLITE_ROW) {
+            if (innerError) {
+                *innerError = [NSError errorWithDomain:MBCardStoreErrorDomain
+                                                  code:MBCardStoreErrorCardNotFound
+                                              userInfo:@{NSLocalizedDescriptionKey: @"Card not found"}];
+            }
+            return NO;
+        }
+
+        double nextStability, nextDifficulty, intervalDays;
+        MBFSRSNextState(stability, difficulty, rating, &nextStability, &nextDifficulty, &intervalDays);
+
+        int64_t reviewedMillis = MBMillisFromDate(reviewedAt);
+        int64_t dueMillis = reviewedMillis + (int64_t)llround(intervalDays * 86400000.0);
+
+        if (![self bindAndStepStateUpdate:self->_updateStateStmt cardId:cardId rating:rating
+                                stability:nextStability difficulty:nextDifficulty
+                                 reviewed:reviewedMillis due:dueMillis error:innerError] ||
+            ![self bindAndStepReviewInsert:cardId rating:rating stability:nextStability
+                                difficulty:nextDifficulty reviewed:reviewedMillis due:dueMillis
+                                    origin:kReviewOriginLocal remoteSequence:0 error:innerError]) {
+            return NO;
+        }
+
+        sequence = sqlite3_last_insert_rowid(self->_db);
+        return YES;
+    }];
+    return sequence;
+}
+
+#pragma mark - Sync
+
+- (nullable NSArray<MBReviewLogEntry *> *)pendingReviewsWithLimit:(NSUInteger)limit
+                                                            error:(NSError **)error {
+    __block NSMutableArray<MBReviewLogEntry *> *entries = nil;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        sqlite3_stmt *stmt = self->_selectPendingStmt;
+        sqlite3_bind_int64(stmt, 1, [self syncValueForKey:kSyncKeyPushedSequence]);
+        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)MIN(limit, (NSUInteger)INT64_MAX));
+
+        NSMutableArray<MBReviewLogEntry *> *results = [NSMutableArray array];
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            MBReviewLogEntry *entry = [[MBReviewLogEntry alloc] init];
+            entry.sequence = sqlite3_column_int64(stmt, 0);
+            entry.cardId = MBColumnText(stmt, 1);
+            entry.rating = (NSInteger)sqlite3_column_int64(stmt, 2);
+            entry.reviewedAt = MBDateFromMillis(sqlite3_column_int64(stmt, 3));
+            entry.stability = sqlite3_column_double(stmt, 4);
+            entry.difficulty = sqlite3_column_double(stmt, 5);
+            entry.dueAt = MBDateFromMillis(sqlite3_column_int64(stmt, 6));
+            [results addObject:entry];
+        }
+        if (rc == SQLITE_DONE) {
+            entries = results;
+        } else {
+            [self fillError:&blockError code:MBCardStoreErrorQueryFailed description:@"Failed to read review log"];
+        }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    });
+
+    if (!entries && error) {
+        *error = blockError;
+    }
+    return entries;
+}
+
+- (BOOL)acknowledgeReviewsThroughSequence:(int64_t)sequence error:(NSError **)error {
+    __block BOOL success = NO;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        // The cursor never moves backwards, so late or duplicate acks are harmless
+        if (sequence <= [self syncValueForKey:kSyncKeyPushedSequence]) {
+            success = YES;
+            return;
+        }
+        success = [self setSyncValue:sequence forKey:kSyncKeyPushedSequence error:&blockError];
+    });
+
+    if (!success && error) {
+        *error = blockError;
+    }
+    return success;
+}
+
+- (NSInteger)applyRemoteReviews:(NSArray<MBReviewLogEntry *> *)reviews error:(NSError **)error {
+    NSArray<MBReviewLogEntry *> *ordered = [reviews sortedArrayUsingComparator:^NSComparisonResult(MBReviewLogEntry *a, MBReviewLogEntry *b) {
+        return a.sequence < b.sequence ? NSOrderedAscending : (a.sequence > b.sequence ? NSOrderedDescending : NSOrderedSame);
+    }];
+
+    __block NSInteger applied = 0;
+    __block NSError *blockError = nil;
+
+    dispatch_sync(_queue, ^{
+        BOOL success = [self inTransaction:&blockError block:^BOOL(NSError **innerError) {
+            int64_t cursor = [self syncValueForKey:kSyncKeyPulledSequence];
+
+            for (MBReviewLogEntry *entry in ordered) {
+                if (entry.sequence <= cursor) {
+                    continue;
+                }
+                int64_t reviewedMillis = MBMillisFromDate(entry.reviewedAt);
+                int64_t dueMillis = MBMillisFromDate(entry.dueAt);
+
+                if (![self bindAndStepReviewInsert:entry.cardId rating:entry.rating stability:entry.stability
+                                        difficulty:entry.difficulty reviewed:reviewedMillis due:dueMillis
+                                            origin:kReviewOriginRemote remoteSequence:entry.sequence
+                                             error:innerError] ||
+                    ![self bindAndStepStateUpdate:self->_updateStateIfNewerStmt cardId:entry.cardId
+                                           rating:entry.rating stability:entry.stability
+                                       difficulty:entry.difficulty reviewed:reviewedMillis
+                                              due:dueMillis error:innerError]) {
+                    return NO;
+                }
+                cursor = entry.sequence;
+                applied++;
+            }
+            return [self setSyncValue:cursor forKey:kSyncKeyPulledSequence error:innerError];
+        }];
+        if (!success) {
+            applied = -1;
+        }
+    });
+
+    if (applied < 0 && error) {
+        *error = blockError;
+    }
+    return applied;
+}
+
+- (int64_t)lastRemoteSequence {
+    __block int64_t value = 0;
+    dispatch_sync(_queue, ^{
+        value = [self syncValueForKey:kSyncKeyPulledSequence];
+    });
+    return value;
+}
+
+#pragma mark - Statement Helpers
+
+- (BOOL)bindAndStepStateUpdate:(sqlite3_stmt *)stmt
+                        cardId:(NSString *)cardId
+                        rating:(NSInteger)rating
+                     stability:(double)stability
+                    difficulty:(double)difficulty
+                      reviewed:(int64_t)reviewedMillis
+                           due:(int64_t)dueMillis
+                         error:(NSError **)error {
+    MBBindText(stmt, 1, cardId);
+    sqlite3_bind_double(stmt, 2, stability);
+    sqlite3_bind_double(stmt, 3, difficulty);
+    sqlite3_bind_int64(stmt, 4, rating);
+    sqlite3_bind_int64(stmt, 5, reviewedMillis);
+    sqlite3_bind_int64(stmt, 6, dueMillis);
+    sqlite3_bind_int64(stmt, 7, MBMillisFromDate([NSDate date]));
+    return [self stepDone:stmt error:error];
+}
+
+- (BOOL)bindAndStepReviewInsert:(NSString *)cardId
+                         rating:(NSInteger)rating
+                      stability:(double)stability
+                     difficulty:(double)difficulty
+                       reviewed:(int64_t)reviewedMillis
+                            due:(int64_t)dueMillis
+                         origin:(int)origin
+                 remoteSequence:(int64_t)remoteSequence
+                          error:(NSError **)error {
+    sqlite3_stmt *stmt = _insertReviewStmt;
+    MBBindText(stmt, 1, cardId);
+    sqlite3_bind_int64(stmt, 2, rating);
+    sqlite3_bind_int64(stmt, 3, reviewedMillis);
+    sqlite3_bind_double(stmt, 4, stability);
+    sqlite3_bind_double(stmt, 5, difficulty);
+    sqlite3_bind_int64(stmt, 6, dueMillis);
+    sqlite3_bind_int(stmt, 7, origin);
+    if (origin == kReviewOriginRemote) {
+        sqlite3_bind_int64(stmt, 8, remoteSequence);
+    } else {
+        sqlite3_bind_null(stmt, 8);
+    }
+    return [self stepDone:stmt error:error];
+}
+
+- (int64_t)syncValueForKey:(const char *)key {
+    sqlite3_stmt *stmt = _selectSyncStmt;
+    sqlite3_bind_text(stmt, 1, key, -1, SQLITE_STATIC);
+    int64_t value = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : 0;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return value;
+}
+
+- (BOOL)setSyncValue:(int64_t)value forKey:(const char *)key error:(NSError **)error {
+    sqlite3_stmt *stmt = _upsertSyncStmt;
+    sqlite3_bind_text(stmt, 1, key, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, value);
+    return [self stepDone:stmt error:error];
+}
+
+/// Steps a statement expected to produce no rows, then resets it.
+- (BOOL)stepDone:(sqlite3_stmt *)stmt error:(NSError **)error {
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        [self fillError:error code:MBCardStoreErrorQueryFailed description:@"Statement failed"];
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE;
+}
+
+/// Runs block inside BEGIN IMMEDIATE / COMMIT, rolling back when it returns NO.
+- (BOOL)inTransaction:(NSError **)error block:(BOOL (^)(NSError **innerError))block {
+    if (![self stepDone:_beginStmt error:error]) {
+        return NO;
+    }
+    if (!block(error)) {
+        [self stepDone:_rollbackStmt error:NULL];
+        return NO;
+    }
+    if (![self stepDone:_commitStmt error:error]) {
+        [self stepDone:_rollbackStmt error:NULL];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)exec:(const char *)sql code:(MBCardStoreError)code error:(NSError **)error {
+    char *message = NULL;
+    if (sqlite3_exec(_db, sql, NULL, NULL, &message) != SQLITE_OK) {
+        NSString *description = message ? [NSString stringWithUTF8String:message] : @"SQLite exec failed";
+        sqlite3_free(message);
+        if (error) {
+            *error = [NSError errorWithDomain:MBCardStoreErrorDomain
+                                         code:code
+                                     userInfo:@{NSLocalizedDescriptionKey: description}];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (void)fillError:(NSError **)error code:(MBCardStoreError)code description:(NSString *)description {
+    if (!error) {
+        return;
+    }
+    NSString *reason = _db ? [NSString stringWithUTF8String:sqlite3_errmsg(_db)] : @"";
+    *error = [NSError errorWithDomain:MBCardStoreErrorDomain
+                                 code:code
+                             userInfo:@{NSLocalizedDescriptionKey: description,
+                                        NSLocalizedFailureReasonErrorKey: reason}];
+}
+
+@end
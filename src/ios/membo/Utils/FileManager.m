@@ -7,6 +7,7 @@
 //
 
 #import "FileManager.h"
+#import "TraceRing.h"
 
 // Static variables
 static FileManager *sharedInstance = nil;
@@ -92,6 +93,7 @@ typedef NS_ENUM(NSInteger, FileManagerErrorCode) {
     }
     
     dispatch_async(fileOperationQueue, ^{
+        uint64_t traceStart = MBTraceBegin();
         NSString *filePath = [self contentPathForFileName:fileName];
         NSString *tempPath = [self.temporaryDirectory stringByAppendingPathComponent:
                             [NSUUID UUID].UUIDString];
@@ -107,6 +109,7 @@ typedef NS_ENUM(NSInteger, FileManagerErrorCode) {
                 [contentCache setObject:contentData forKey:fileName cost:contentData.length];
             }
         }
+        MBTraceEnd(MBTraceSpanFileWrite, traceStart, (uint32_t)MIN(contentData.length, UINT32_MAX));
         
         self.lastError = error;
         dispatch_async(dispatch_get_main_queue(), ^{
@@ -125,9 +128,11 @@ typedef NS_ENUM(NSInteger, FileManagerErrorCode) {
     }
     
     dispatch_async(fileOperationQueue, ^{
+        uint64_t traceStart = MBTraceBegin();
         NSString *filePath = [self contentPathForFileName:fileName];
         NSError *error = nil;
         NSData *data = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:&error];
+        MBTraceEnd(MBTraceSpanFileRead, traceStart, (uint32_t)MIN(data.length, UINT32_MAX));
         
         if (data) {
             [contentCache setObject:data forKey:fileName cost:data.length];
@@ -151,6 +156,7 @@ typedef NS_ENUM(NSInteger, FileManagerErrorCode) {
     }
     
     dispatch_async(fileOperationQueue, ^{
+        uint64_t traceStart = MBTraceBegin();
         NSString *fileName = [NSString stringWithFormat:@"%@%@.m4a", kFilePrefix, recordingId];
         NSString *filePath = [self.temporaryDirectory stringByAppendingPathComponent:fileName];
         
@@ -164,6 +170,7 @@ typedef NS_ENUM(NSInteger, FileManagerErrorCode) {
             };
             [self.fileManager setAttributes:attributes ofItemAtPath:filePath error:&error];
         }
+        MBTraceEnd(MBTraceSpanVoiceRecordingSave, traceStart, (uint32_t)MIN(audioData.length, UINT32_MAX));
         
         self.lastError = error;
         dispatch_async(dispatch_get_main_queue(), ^{
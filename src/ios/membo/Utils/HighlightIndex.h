@@ -0,0 +1,130 @@
+//
+//  HighlightIndex.h
+//  membo
+//
+//  Persistent per-book set of captured highlight fingerprints. A cuckoo filter
+//  answers "never seen" without touching disk; an exact fingerprint file backs
+//  it up so filter false positives never drop a new highlight.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Error domain for highlight index failures
+extern NSString *const MBHighlightIndexErrorDomain;
+
+/**
+ * Error codes for highlight index operations.
+ */
+typedef NS_ENUM(NSInteger, MBHighlightIndexError) {
+    /// Index files could not be read or created
+    MBHighlightIndexErrorOpenFailed = 3001,
+    /// Index files could not be written
+    MBHighlightIndexErrorWriteFailed = 3002
+};
+
+#pragma mark - Fingerprints
+
+/**
+ * Fingerprints highlight text. Case, surrounding whitespace and runs of
+ * whitespace are ignored, so the same passage re-exported with different
+ * line wrapping maps to the same value. Location is deliberately excluded:
+ * it shifts between book editions while the text does not.
+ *
+ * @param text UTF-8 highlight text
+ * @param length Length of `text` in bytes
+ * @return Non-zero 64-bit fingerprint
+ */
+uint64_t MBHighlightFingerprint(const char *text, size_t length);
+
+#pragma mark - Fingerprint Set
+
+/// Open-addressing hash set of 64-bit fingerprints
+typedef struct MBFingerprintSet MBFingerprintSet;
+
+MBFingerprintSet * _Nullable MBFingerprintSetCreate(size_t capacity);
+void MBFingerprintSetFree(MBFingerprintSet * _Nullable set);
+
+/// Returns true when the fingerprint was not already present
+bool MBFingerprintSetInsert(MBFingerprintSet *set, uint64_t fingerprint);
+bool MBFingerprintSetContains(const MBFingerprintSet *set, uint64_t fingerprint);
+size_t MBFingerprintSetCount(const MBFingerprintSet *set);
+
+#pragma mark - Cuckoo Filter
+
+/// Cuckoo filter with 16-bit tags in 4-way buckets (~0.01% false positives)
+typedef struct MBCuckooFilter MBCuckooFilter;
+
+/**
+ * Creates a filter sized for `capacity` fingerprints at 95% load.
+ */
+MBCuckooFilter * _Nullable MBCuckooFilterCreate(size_t capacity);
+void MBCuckooFilterFree(MBCuckooFilter * _Nullable filter);
+
+/**
+ * Adds a fingerprint. Returns false when the filter is too full to place it;
+ * the caller rebuilds a larger filter from the exact set.
+ */
+bool MBCuckooFilterInsert(MBCuckooFilter *filter, uint64_t fingerprint);
+bool MBCuckooFilterContains(const MBCuckooFilter *filter, uint64_t fingerprint);
+size_t MBCuckooFilterCount(const MBCuckooFilter *filter);
+
+/**
+ * Serialized form: 16-byte little-endian header (magic, version, bucket
+ * count, item count) followed by the bucket array.
+ */
+NSData *MBCuckooFilterSerialize(const MBCuckooFilter *filter);
+MBCuckooFilter * _Nullable MBCuckooFilterDeserialize(NSData *data);
+
+#pragma mark - Index
+
+/**
+ * Captured-highlight index for one book. Not thread-safe; callers confine
+ * each instance to one serial queue.
+ */
+@interface MBHighlightIndex : NSObject
+
+/// Number of captured highlights recorded for the book
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/**
+ * Opens the index for a book, creating empty files on first use.
+ *
+ * @param bookTitle Book title as exported by Kindle
+ * @param directory Directory holding index files; nil uses Application Support
+ * @param error Set when the index cannot be opened
+ */
++ (nullable instancetype)indexForBookTitle:(NSString *)bookTitle
+                                 directory:(nullable NSURL *)directory
+                                     error:(NSError **)error;
+
+/**
+ * Returns YES when the fingerprint was already captured. Most new highlights
+ * are rejected by the filter alone; the exact set is loaded only on a hit.
+ */
+- (BOOL)containsFingerprint:(uint64_t)fingerprint;
+
+/**
+ * Records captured fingerprints. Appends to the exact set file first, then
+ * rewrites the filter, so a crash in between only costs a filter rebuild.
+ *
+ * @param fingerprints Fingerprints to record
+ * @param count Number of fingerprints
+ * @param error Set when the index cannot be written
+ * @return YES on success
+ */
+- (BOOL)addFingerprints:(const uint64_t *)fingerprints
+                  count:(NSUInteger)count
+                  error:(NSError **)error;
+
+/**
+ * Stable file-system key for a book title.
+ */
++ (NSString *)storageKeyForBookTitle:(NSString *)bookTitle;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
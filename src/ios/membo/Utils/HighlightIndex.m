@@ -0,0 +1,583 @@
+//
+//  HighlightIndex.m
+//  membo
+//
+//  Per book, two files live under Application Support/membo/highlights:
+//  <key>.fpset is an append-only array of 64-bit fingerprints (the source of
+//  truth) and <key>.cuckoo is the serialized filter, rebuilt from the set
+//  whenever its item count disagrees with it.
+//
+
+#import "HighlightIndex.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+NSString *const MBHighlightIndexErrorDomain = @"ai.membo.highlightindex";
+
+static const uint32_t kCuckooMagic = 0x4643424D; // "MBCF"
+static const uint16_t kCuckooVersion = 1;
+static const size_t kCuckooHeaderSize = 24;
+static const size_t kCuckooBucketSize = 4;
+static const size_t kCuckooMaxKicks = 500;
+
+// Smallest filter created for a book; grows by doubling when full
+static const size_t kMinimumFilterCapacity = 1024;
+
+#pragma mark - Fingerprints
+
+static inline uint64_t MBMix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t MBHighlightFingerprint(const char *text, size_t length) {
+    // FNV-1a over lowercased text with whitespace runs folded to one space
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    BOOL pendingSpace = NO;
+    BOOL started = NO;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v') {
+            pendingSpace = started;
+            continue;
+        }
+        if (pendingSpace) {
+            hash = (hash ^ ' ') * 0x100000001b3ULL;
+            pendingSpace = NO;
+        }
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        hash = (hash ^ c) * 0x100000001b3ULL;
+        started = YES;
+    }
+    uint64_t fingerprint = MBMix64(hash);
+    return fingerprint ? fingerprint : 1;
+}
+
+#pragma mark - Fingerprint Set
+
+struct MBFingerprintSet {
+    uint64_t *slots;
+    size_t mask;
+    size_t count;
+};
+
+static size_t MBNextPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+MBFingerprintSet *MBFingerprintSetCreate(size_t capacity) {
+    MBFingerprintSet *set = calloc(1, sizeof(MBFingerprintSet));
+    if (!set) {
+        return NULL;
+    }
+    // Keep load under 70%
+    size_t slotCount = MBNextPowerOfTwo(MAX(capacity * 10 / 7 + 1, (size_t)16));
+    set->slots = calloc(slotCount, sizeof(uint64_t));
+    if (!set->slots) {
+        free(set);
+        return NULL;
+    }
+    set->mask = slotCount - 1;
+    return set;
+}
+
+void MBFingerprintSetFree(MBFingerprintSet *set) {
+    if (set) {
+        free(set->slots);
+        free(set);
+    }
+}
+
+static bool MBFingerprintSetGrow(MBFingerprintSet *set) {
+    size_t oldCount = set->mask + 1;
+    size_t newCount = oldCount * 2;
+    uint64_t *slots = calloc(newCount, sizeof(uint64_t));
+    if (!slots) {
+        return false;
+    }
+    for (size_t i = 0; i < oldCount; i++) {
+        uint64_t value = set->slots[i];
+        if (!value) {
+            continue;
+        }
+        size_t slot = (size_t)value & (newCount - 1);
+        while (slots[slot]) {
+            slot = (slot + 1) & (newCount - 1);
+        }
+        slots[slot] = value;
+    }
+    free(set->slots);
+    set->slots = slots;
+    set->mask = newCount - 1;
+    return true;
+}
+
+bool MBFingerprintSetInsert(MBFingerprintSet *set, uint64_t fingerprint) {
+    // Zero marks an empty slot; fingerprints are never zero
+    if (!fingerprint) {
+        fingerprint = 1;
+    }
+    if ((set->count + 1) * 10 > (set->mask + 1) * 7 && !MBFingerprintSetGrow(set)) {
+        return false;
+    }
+    size_t slot = (size_t)fingerprint & set->mask;
+    while (set->slots[slot]) {
+        if (set->slots[slot] == fingerprint) {
+            return false;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+    set->slots[slot] = fingerprint;
+    set->count++;
+    return true;
+}
+
+bool MBFingerprintSetContains(const MBFingerprintSet *set, uint64_t fingerprint) {
+    if (!fingerprint) {
+        fingerprint = 1;
+    }
+    size_t slot = (size_t)fingerprint & set->mask;
+    while (set->slots[slot]) {
+        if (set->slots[slot] == fingerprint) {
+            return true;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+    return false;
+}
+
+size_t MBFingerprintSetCount(const MBFingerprintSet *set) {
+    return set->count;
+}
+
+#pragma mark - Cuckoo Filter
+
+struct MBCuckooFilter {
+    uint16_t *tags;
+    uint32_t bucketMask;
+    uint32_t count;
+    // A tag evicted by a failed insert; kept so the filter never loses one
+    bool hasVictim;
+    uint32_t victimIndex;
+    uint16_t victimTag;
+    uint32_t kickState;
+};
+
+static inline uint16_t MBCuckooTag(uint64_t fingerprint) {
+    uint16_t tag = (uint16_t)(fingerprint >> 48);
+    return tag ? tag : 1;
+}
+
+static inline uint32_t MBCuckooAltIndex(const MBCuckooFilter *filter, uint32_t index, uint16_t tag) {
+    return (index ^ (tag * 0x5bd1e995u)) & filter->bucketMask;
+}
+
+static bool MBCuckooBucketInsert(MBCuckooFilter *filter, uint32_t index, uint16_t tag) {
+    uint16_t *bucket = filter->tags + (size_t)index * kCuckooBucketSize;
+    for (size_t i = 0; i < kCuckooBucketSize; i++) {
+        if (!bucket[i]) {
+            bucket[i] = tag;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool MBCuckooBucketContains(const MBCuckooFilter *filter, uint32_t index, uint16_t tag) {
+    const uint16_t *bucket = filter->tags + (size_t)index * kCuckooBucketSize;
+    return bucket[0] == tag || bucket[1] == tag || bucket[2] == tag || bucket[3] == tag;
+}
+
+static MBCuckooFilter *MBCuckooFilterAllocate(uint32_t bucketCount) {
+    MBCuckooFilter *filter = calloc(1, sizeof(MBCuckooFilter));
+    if (!filter) {
+        return NULL;
+    }
+    filter->tags = calloc((size_t)bucketCount * kCuckooBucketSize, sizeof(uint16_t));
+    if (!filter->tags) {
+        free(filter);
+        return NULL;
+    }
+    filter->bucketMask = bucketCount - 1;
+    filter->kickState = 0x9e3779b9u;
+    return filter;
+}
+
+MBCuckooFilter *MBCuckooFilterCreate(size_t capacity) {
+    size_t buckets = MBNextPowerOfTwo(MAX((size_t)ceil(capacity / (kCuckooBucketSize * 0.95)), (size_t)16));
+    if (buckets > UINT32_MAX) {
+        return NULL;
+    }
+    return MBCuckooFilterAllocate((uint32_t)buckets);
+}
+
+void MBCuckooFilterFree(MBCuckooFilter *filter) {
+    if (filter) {
+        free(filter->tags);
+        free(filter);
+    }
+}
+
+bool MBCuckooFilterInsert(MBCuckooFilter *filter, uint64_t fingerprint) {
+    if (filter->hasVictim) {
+        return false;
+    }
+
+    uint16_t tag = MBCuckooTag(fingerprint);
+    uint32_t index = (uint32_t)fingerprint & filter->bucketMask;
+    uint32_t alternate = MBCuckooAltIndex(filter, index, tag);
+    if (MBCuckooBucketInsert(filter, index, tag) || MBCuckooBucketInsert(filter, alternate, tag)) {
+        filter->count++;
+        return true;
+    }
+
+    // Both buckets full: evict random residents along the chain
+    index = (filter->kickState & 1) ? alternate : index;
+    for (size_t kick = 0; kick < kCuckooMaxKicks; kick++) {
+        filter->kickState = filter->kickState * 1664525u + 1013904223u;
+        uint16_t *slot = filter->tags + (size_t)index * kCuckooBucketSize + ((filter->kickState >> 16) & 3);
+        uint16_t evicted = *slot;
+        *slot = tag;
+        tag = evicted;
+        index = MBCuckooAltIndex(filter, index, tag);
+        if (MBCuckooBucketInsert(filter, index, tag)) {
+            filter->count++;
+            return true;
+        }
+    }
+
+    filter->hasVictim = true;
+    filter->victimIndex = index;
+    filter->victimTag = tag;
+    filter->count++;
+    return true;
+}
+
+bool MBCuckooFilterContains(const MBCuckooFilter *filter, uint64_t fingerprint) {
+    uint16_t tag = MBCuckooTag(fingerprint);
+    uint32_t index = (uint32_t)fingerprint & filter->bucketMask;
+    uint32_t alternate = MBCuckooAltIndex(filter, index, tag);
+    if (filter->hasVictim && filter->victimTag == tag &&
+        (filter->victimIndex == index || filter->victimIndex == alternate)) {
+        return true;
+    }
+    return MBCuckooBucketContains(filter, index, tag) || MBCuckooBucketContains(filter, alternate, tag);
+}
+
+size_t MBCuckooFilterCount(const MBCuckooFilter *filter) {
+    return filter->count;
+}
+
+NSData *MBCuckooFilterSerialize(const MBCuckooFilter *filter) {
+    size_t tagBytes = ((size_t)filter->bucketMask + 1) * kCuckooBucketSize * sizeof(uint16_t);
+    NSMutableData *data = [NSMutableData dataWithLength:kCuckooHeaderSize + tagBytes];
+    uint8_t *bytes = data.mutableBytes;
+
+    // Apple platforms are little-endian; the layout is written as-is
+    uint32_t bucketCount = filter->bucketMask + 1;
+    uint16_t flags = filter->hasVictim ? 1 : 0;
+    memcpy(bytes, &kCuckooMagic, 4);
+    memcpy(bytes + 4, &kCuckooVersion, 2);
+    memcpy(bytes + 6, &flags, 2);
+    memcpy(bytes + 8, &bucketCount, 4);
+    memcpy(bytes + 12, &filter->count, 4);
+    memcpy(bytes + 16, &filter->victimIndex, 4);
+    memcpy(bytes + 20, &filter->victimTag, 2);
+    memcpy(bytes + kCuckooHeaderSize, filter->tags, tagBytes);
+    return data;
+}
+
+MBCuckooFilter *MBCuckooFilterDeserialize(NSData *data) {
+    if (data.length < kCuckooHeaderSize) {
+        return NULL;
+    }
+    const uint8_t *bytes = data.bytes;
+    uint32_t magic, bucketCount, count, victimIndex;
+    uint16_t version, flags, victimTag;
+    memcpy(&magic, bytes, 4);
+    memcpy(&version, bytes + 4, 2);
+    memcpy(&flags, bytes + 6, 2);
+    memcpy(&bucketCount, bytes + 8, 4);
+    memcpy(&count, bytes + 12, 4);
+    memcpy(&victimIndex, bytes + 16, 4);
+    memcpy(&victimTag, bytes + 20, 2);
+
+    if (magic != kCuckooMagic || version != kCuckooVersion ||
+        bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0) {
+        return NULL;
+    }
+    size_t tagBytes = (size_t)bucketCount * kCuckooBucketSize * sizeof(uint16_t);
+    if (data.length != kCuckooHeaderSize + tagBytes) {
+        return NULL;
+    }
+
+    MBCuckooFilter *filter = MBCuckooFilterAllocate(bucketCount);
+    if (!filter) {
+        return NULL;
+    }
+    memcpy(filter->tags, bytes + kCuckooHeaderSize, tagBytes);
+    filter->count = count;
+    filter->hasVictim = (flags & 1) != 0;
+    filter->victimIndex = victimIndex & filter->bucketMask;
+    filter->victimTag = victimTag;
+    return filter;
+}
+
+#pragma mark - Index
+
+@implementation MBHighlightIndex {
+    NSURL *_setURL;
+    NSURL *_filterURL;
+    MBCuckooFilter *_filter;
+    MBFingerprintSet *_exact;
+}
+
++ (NSString *)storageKeyForBookTitle:(NSString *)bookTitle {
+    const char *utf8 = bookTitle.UTF8String ?: "";
+    return [NSString stringWithFormat:@"%016llx", (unsigned long long)MBHighlightFingerprint(utf8, strlen(utf8))];
+}
+
++ (nullable instancetype)indexForBookTitle:(NSString *)bookTitle
+                                 directory:(nullable NSURL *)directory
+                                     error:(NSError **)error {
+    if (!directory) {
+        NSURL *supportURL = [[NSFileManager defaultManager] URLForDirectory:NSApplicationSupportDirectory
+                                                                   inDomain:NSUserDomainMask
+                                                          appropriateForURL:nil
+                                                                     create:YES
+                                                                      error:error];
+        if (!supportURL) {
+            return nil;
+        }
+        directory = [supportURL URLByAppendingPathComponent:@"membo/highlights" isDirectory:YES];
+    }
+    if (![[NSFileManager defaultManager] createDirectoryAtURL:directory
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:error]) {
+        return nil;
+    }
+
+    NSString *key = [self storageKeyForBookTitle:bookTitle];
+    return [[self alloc] initWithSetURL:[directory URLByAppendingPathComponent:[key stringByAppendingPathExtension:@"fpset"]]
+                              filterURL:[directory URLByAppendingPathComponent:[key stringByAppendingPathExtension:@"cuckoo"]]
+                                  error:error];
+}
+
+- (nullable instancetype)initWithSetURL:(NSURL *)setURL filterURL:(NSURL *)filterURL error:(NSError **)error {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    _setURL = setURL;
+    _filterURL = filterURL;
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (![fileManager fileExistsAtPath:setURL.path] &&
+        ![fileManager createFileAtPath:setURL.path
+                              contents:nil
+                            attributes:@{NSFileProtectionKey: NSFileProtectionCompleteUntilFirstUserAuthentication}]) {
+        [self fillError:error code:MBHighlightIndexErrorOpenFailed description:@"Failed to create highlight index"];
+        return nil;
+    }
+
+    unsigned long long setSize = [[fileManager attributesOfItemAtPath:setURL.path error:nil] fileSize];
+    if (setSize % sizeof(uint64_t) != 0) {
+        // Drop a torn tail left by an interrupted append
+        setSize -= setSize % sizeof(uint64_t);
+        if (truncate(setURL.fileSystemRepresentation, (off_t)setSize) != 0) {
+            [self fillError:error code:MBHighlightIndexErrorOpenFailed description:@"Failed to repair highlight index"];
+            return nil;
+        }
+    }
+    _count = (NSUInteger)(setSize / sizeof(uint64_t));
+
+    NSData *filterData = [NSData dataWithContentsOfURL:filterURL];
+    _filter = filterData ? MBCuckooFilterDeserialize(filterData) : NULL;
+    if (!_filter || MBCuckooFilterCount(_filter) != _count) {
+        MBCuckooFilterFree(_filter);
+        _filter = NULL;
+        if (![self rebuildFilterWithError:error]) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    MBCuckooFilterFree(_filter);
+    MBFingerprintSetFree(_exact);
+}
+
+#pragma mark - Queries
+
+- (BOOL)containsFingerprint:(uint64_t)fingerprint {
+    if (!MBCuckooFilterContains(_filter, fingerprint)) {
+        return NO;
+    }
+    if (![self loadExactSetWithError:nil]) {
+        // Without the exact set, trust the filter rather than re-import
+        return YES;
+    }
+    return MBFingerprintSetContains(_exact, fingerprint);
+}
+
+#pragma mark - Updates
+
+- (BOOL)addFingerprints:(const uint64_t *)fingerprints
+                  count:(NSUInteger)count
+                  error:(NSError **)error {
+    // Duplicates within the batch are caught here, since neither the filter
+    // nor a lazily loaded exact set sees them until the batch is written
+    MBFingerprintSet *batch = MBFingerprintSetCreate(count);
+    if (!batch) {
+        [self fillError:error code:MBHighlightIndexErrorWriteFailed description:@"Out of memory updating highlight index"];
+        return NO;
+    }
+    NSMutableData *appended = [NSMutableData dataWithCapacity:count * sizeof(uint64_t)];
+    for (NSUInteger i = 0; i < count; i++) {
+        if (MBFingerprintSetContains(batch, fingerprints[i]) || [self containsFingerprint:fingerprints[i]]) {
+            continue;
+        }
+        MBFingerprintSetInsert(batch, fingerprints[i]);
+        [appended appendBytes:&fingerprints[i] length:sizeof(uint64_t)];
+    }
+    MBFingerprintSetFree(batch);
+    if (appended.length == 0) {
+        return YES;
+    }
+
+    if (![self appendToSetFile:appended error:error]) {
+        return NO;
+    }
+
+    const uint64_t *added = appended.bytes;
+    NSUInteger addedCount = appended.length / sizeof(uint64_t);
+    _count += addedCount;
+    for (NSUInteger i = 0; _exact && i < addedCount; i++) {
+        MBFingerprintSetInsert(_exact, added[i]);
+    }
+
+    BOOL full = NO;
+    for (NSUInteger i = 0; i < addedCount && !full; i++) {
+        full = !MBCuckooFilterInsert(_filter, added[i]);
+    }
+    if (full || _filter->hasVictim) {
+        return [self rebuildFilterWithError:error];
+    }
+    return [self writeFilterWithError:error];
+}
+
+#pragma mark - Private Methods
+
+- (BOOL)appendToSetFile:(NSData *)data error:(NSError **)error {
+    int fd = open(_setURL.fileSystemRepresentation, O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd < 0) {
+        [self fillError:error code:MBHighlightIndexErrorWriteFailed description:@"Failed to open highlight index"];
+        return NO;
+    }
+    const uint8_t *bytes = data.bytes;
+    size_t remaining = data.length;
+    while (remaining > 0) {
+        ssize_t written = write(fd, bytes, remaining);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            close(fd);
+            [self fillError:error code:MBHighlightIndexErrorWriteFailed description:@"Failed to write highlight index"];
+            return NO;
+        }
+        bytes += written;
+        remaining -= (size_t)written;
+    }
+    close(fd);
+    return YES;
+}
+
+- (BOOL)loadExactSetWithError:(NSError **)error {
+    if (_exact) {
+        return YES;
+    }
+    NSData *data = [NSData dataWithContentsOfURL:_setURL options:NSDataReadingMappedIfSafe error:error];
+    if (!data) {
+        return NO;
+    }
+    const uint64_t *values = data.bytes;
+    NSUInteger valueCount = MIN(data.length / sizeof(uint64_t), _count);
+    _exact = MBFingerprintSetCreate(MAX(valueCount * 2, kMinimumFilterCapacity));
+    if (!_exact) {
+        [self fillError:error code:MBHighlightIndexErrorOpenFailed description:@"Out of memory loading highlight index"];
+        return NO;
+    }
+    for (NSUInteger i = 0; i < valueCount; i++) {
+        MBFingerprintSetInsert(_exact, values[i]);
+    }
+    return YES;
+}
+
+- (BOOL)rebuildFilterWithError:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfURL:_setURL options:NSDataReadingMappedIfSafe error:error];
+    if (!data) {
+        return NO;
+    }
+    const uint64_t *values = data.bytes;
+    NSUInteger valueCount = MIN(data.length / sizeof(uint64_t), _count);
+
+    // Leave room to grow before the next rebuild
+    size_t capacity = MAX(valueCount * 2, kMinimumFilterCapacity);
+    for (;;) {
+        MBCuckooFilter *filter = MBCuckooFilterCreate(capacity);
+        if (!filter) {
+            [self fillError:error code:MBHighlightIndexErrorOpenFailed description:@"Out of memory building highlight filter"];
+            return NO;
+        }
+        BOOL placed = YES;
+        for (NSUInteger i = 0; i < valueCount && placed; i++) {
+            placed = MBCuckooFilterInsert(filter, values[i]) && !filter->hasVictim;
+        }
+        if (placed) {
+            MBCuckooFilterFree(_filter);
+            _filter = filter;
+            break;
+        }
+        MBCuckooFilterFree(filter);
+        capacity *= 2;
+    }
+    return [self writeFilterWithError:error];
+}
+
+- (BOOL)writeFilterWithError:(NSError **)error {
+    NSData *data = MBCuckooFilterSerialize(_filter);
+    NSDataWritingOptions options = NSDataWritingAtomic | NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication;
+    if (![data writeToURL:_filterURL options:options error:error]) {
+        return NO;
+    }
+    return YES;
+}
+
+- (void)fillError:(NSError **)error code:(MBHighlightIndexError)code description:(NSString *)description {
+    if (!error) {
+        return;
+    }
+    *error = [NSError errorWithDomain:MBHighlightIndexErrorDomain
+                                 code:code
+                             userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+@end
@@ -0,0 +1,107 @@
+//
+//  KindleClippingsParser.h
+//  membo
+//
+//  Streaming parser for Kindle "My Clippings.txt" exports. Input is consumed
+//  in arbitrary chunks, so multi-megabyte exports are parsed without holding
+//  the whole file in memory.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark - Parsing Core
+
+/**
+ * Kind of a clipping entry, taken from its metadata line.
+ */
+typedef NS_ENUM(NSInteger, MBClippingKind) {
+    MBClippingKindHighlight = 0,
+    MBClippingKindNote = 1,
+    MBClippingKindBookmark = 2
+};
+
+/**
+ * One parsed entry. Pointers reference parser-owned buffers and are valid only
+ * for the duration of the handler call; strings are not NUL-terminated.
+ */
+typedef struct {
+    const char *title;
+    size_t titleLength;
+    /// Author from the trailing "(Author)" of the title line, if any
+    const char *author;
+    size_t authorLength;
+    const char *text;
+    size_t textLength;
+    /// "Added on" value as written by the device, if any
+    const char *addedOn;
+    size_t addedOnLength;
+    /// First location of the range, 0 when absent
+    uint32_t location;
+    MBClippingKind kind;
+} MBClipping;
+
+/// Called for every complete entry; return false to stop parsing
+typedef bool (*MBClippingHandler)(const MBClipping *clipping, void * _Nullable context);
+
+typedef struct MBClippingsParser MBClippingsParser;
+
+MBClippingsParser * _Nullable MBClippingsParserCreate(MBClippingHandler handler, void * _Nullable context);
+void MBClippingsParserFree(MBClippingsParser * _Nullable parser);
+
+/**
+ * Feeds the next chunk of the export. Entries are emitted as soon as their
+ * separator line is seen.
+ *
+ * @return false once the handler asked to stop or memory ran out
+ */
+bool MBClippingsParserFeed(MBClippingsParser *parser, const char *bytes, size_t length);
+
+/**
+ * Flushes a trailing entry that is not followed by a separator.
+ */
+bool MBClippingsParserFinish(MBClippingsParser *parser);
+
+/// Entries dropped because they had no metadata line
+size_t MBClippingsParserMalformedCount(const MBClippingsParser *parser);
+
+#pragma mark - Clippings
+
+/**
+ * A parsed clipping with its text fingerprint.
+ */
+@interface MBKindleClipping : NSObject
+
+@property (nonatomic, copy, readonly) NSString *bookTitle;
+@property (nonatomic, copy, readonly, nullable) NSString *author;
+@property (nonatomic, copy, readonly) NSString *text;
+@property (nonatomic, copy, readonly, nullable) NSString *addedOn;
+@property (nonatomic, assign, readonly) NSUInteger location;
+@property (nonatomic, assign, readonly) MBClippingKind kind;
+/// MBHighlightFingerprint of the text
+@property (nonatomic, assign, readonly) uint64_t fingerprint;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+#pragma mark - Parser
+
+@interface MBKindleClippingsParser : NSObject
+
+/**
+ * Streams an export file in fixed-size chunks.
+ *
+ * @param url File URL of the export
+ * @param handler Called for each clipping in file order; set `stop` to end early
+ * @param error Set when the file cannot be read
+ * @return NO if the file could not be read
+ */
++ (BOOL)parseFileAtURL:(NSURL *)url
+               handler:(void (^)(MBKindleClipping *clipping, BOOL *stop))handler
+                 error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
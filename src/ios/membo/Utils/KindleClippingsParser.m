@@ -0,0 +1,357 @@
+//
+//  KindleClippingsParser.m
+//  membo
+//
+//  An entry is a title line, a metadata line ("- Your Highlight on page 3 |
+//  Location 40-42 | Added on ..."), a blank line, body lines, and a line of
+//  ten '=' characters. Lines are split in place when they fit in the current
+//  chunk and copied only when they straddle a chunk boundary.
+//
+
+#import "KindleClippingsParser.h"
+#import "HighlightIndex.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Read size for file parsing
+static const NSUInteger kClippingsChunkSize = 64 * 1024;
+
+#pragma mark - Buffers
+
+typedef struct {
+    char *bytes;
+    size_t length;
+    size_t capacity;
+} MBByteBuffer;
+
+static bool MBByteBufferAppend(MBByteBuffer *buffer, const char *bytes, size_t length) {
+    if (buffer->length + length > buffer->capacity) {
+        size_t capacity = MAX(buffer->capacity * 2, buffer->length + length);
+        capacity = MAX(capacity, (size_t)256);
+        char *grown = realloc(buffer->bytes, capacity);
+        if (!grown) {
+            return false;
+        }
+        buffer->bytes = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+    return true;
+}
+
+static bool MBByteBufferSet(MBByteBuffer *buffer, const char *bytes, size_t length) {
+    buffer->length = 0;
+    return MBByteBufferAppend(buffer, bytes, length);
+}
+
+#pragma mark - Parsing Core
+
+typedef enum {
+    MBClippingsStateTitle,
+    MBClippingsStateMeta,
+    MBClippingsStateBody
+} MBClippingsState;
+
+struct MBClippingsParser {
+    MBClippingHandler handler;
+    void *context;
+    MBClippingsState state;
+    MBByteBuffer line;
+    MBByteBuffer title;
+    MBByteBuffer meta;
+    MBByteBuffer text;
+    size_t malformed;
+    bool stopped;
+};
+
+static void MBTrim(const char **bytes, size_t *length) {
+    const char *start = *bytes;
+    const char *end = start + *length;
+    while (start < end && (*start == ' ' || *start == '\t' || *start == '\r' || *start == '\n')) {
+        start++;
+    }
+    while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) {
+        end--;
+    }
+    *bytes = start;
+    *length = (size_t)(end - start);
+}
+
+static const char *MBFind(const char *haystack, size_t length, const char *needle) {
+    size_t needleLength = strlen(needle);
+    if (needleLength > length) {
+        return NULL;
+    }
+    for (size_t i = 0; i + needleLength <= length; i++) {
+        if (haystack[i] == needle[0] && memcmp(haystack + i, needle, needleLength) == 0) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+static bool MBClippingsEmit(MBClippingsParser *parser) {
+    if (parser->meta.length == 0) {
+        if (parser->title.length > 0 || parser->text.length > 0) {
+            parser->malformed++;
+        }
+        return true;
+    }
+
+    MBClipping clipping = {0};
+    const char *meta = parser->meta.bytes;
+    size_t metaLength = parser->meta.length;
+
+    if (MBFind(meta, metaLength, "Bookmark")) {
+        clipping.kind = MBClippingKindBookmark;
+    } else if (MBFind(meta, metaLength, "Note")) {
+        clipping.kind = MBClippingKindNote;
+    } else {
+        clipping.kind = MBClippingKindHighlight;
+    }
+
+    const char *location = MBFind(meta, metaLength, "ocation ");
+    if (location) {
+        const char *end = meta + metaLength;
+        for (const char *p = location + 8; p < end && *p >= '0' && *p <= '9'; p++) {
+            clipping.location = clipping.location * 10 + (uint32_t)(*p - '0');
+        }
+    }
+
+    const char *addedOn = MBFind(meta, metaLength, "Added on ");
+    if (addedOn) {
+        clipping.addedOn = addedOn + 9;
+        clipping.addedOnLength = (size_t)(meta + metaLength - clipping.addedOn);
+        MBTrim(&clipping.addedOn, &clipping.addedOnLength);
+    }
+
+    // "Title (Author)": split on the last " (" when the line ends in ')'
+    clipping.title = parser->title.bytes;
+    clipping.titleLength = parser->title.length;
+    if (clipping.titleLength > 2 && clipping.title[clipping.titleLength - 1] == ')') {
+        for (size_t i = clipping.titleLength - 1; i > 0; i--) {
+            if (clipping.title[i] == '(' && clipping.title[i - 1] == ' ') {
+                clipping.author = clipping.title + i + 1;
+                clipping.authorLength = clipping.titleLength - i - 2;
+                clipping.titleLength = i - 1;
+                break;
+            }
+        }
+    }
+
+    clipping.text = parser->text.bytes;
+    clipping.textLength = parser->text.length;
+    MBTrim(&clipping.text, &clipping.textLength);
+
+    if (!parser->handler(&clipping, parser->context)) {
+        parser->stopped = true;
+        return false;
+    }
+    return true;
+}
+
+static void MBClippingsReset(MBClippingsParser *parser) {
+    parser->state = MBClippingsStateTitle;
+    parser->title.length = 0;
+    parser->meta.length = 0;
+    parser->text.length = 0;
+}
+
+static bool MBClippingsProcessLine(MBClippingsParser *parser, const char *line, size_t length) {
+    if (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+
+    if (length >= 10 && memcmp(line, "==========", 10) == 0) {
+        bool keepGoing = MBClippingsEmit(parser);
+        MBClippingsReset(parser);
+        return keepGoing;
+    }
+
+    switch (parser->state) {
+        case MBClippingsStateTitle: {
+            // Kindle writes a byte-order mark at the start of each entry
+            if (length >= 3 && memcmp(line, "\xEF\xBB\xBF", 3) == 0) {
+                line += 3;
+                length -= 3;
+            }
+            MBTrim(&line, &length);
+            if (length == 0) {
+                return true;
+            }
+            parser->state = MBClippingsStateMeta;
+            return MBByteBufferSet(&parser->title, line, length);
+        }
+        case MBClippingsStateMeta:
+            parser->state = MBClippingsStateBody;
+            return MBByteBufferSet(&parser->meta, line, length);
+        case MBClippingsStateBody:
+            if (parser->text.length == 0 && length == 0) {
+                return true;
+            }
+            if (parser->text.length > 0 && !MBByteBufferAppend(&parser->text, "\n", 1)) {
+                return false;
+            }
+            return MBByteBufferAppend(&parser->text, line, length);
+    }
+    return true;
+}
+
+MBClippingsParser *MBClippingsParserCreate(MBClippingHandler handler, void *context) {
+    MBClippingsParser *parser = calloc(1, sizeof(MBClippingsParser));
+    if (parser) {
+        parser->handler = handler;
+        parser->context = context;
+    }
+    return parser;
+}
+
+void MBClippingsParserFree(MBClippingsParser *parser) {
+    if (!parser) {
+        return;
+    }
+    free(parser->line.bytes);
+    free(parser->title.bytes);
+    free(parser->meta.bytes);
+    free(parser->text.bytes);
+    free(parser);
+}
+
+bool MBClippingsParserFeed(MBClippingsParser *parser, const char *bytes, size_t length) {
+    const char *end = bytes + length;
+    while (bytes < end && !parser->stopped) {
+        const char *newline = memchr(bytes, '\n', (size_t)(end - bytes));
+        if (!newline) {
+            return MBByteBufferAppend(&parser->line, bytes, (size_t)(end - bytes));
+        }
+
+        bool ok;
+        if (parser->line.length == 0) {
+            ok = MBClippingsProcessLine(parser, bytes, (size_t)(newline - bytes));
+        } else {
+            ok = MBByteBufferAppend(&parser->line, bytes, (size_t)(newline - bytes)) &&
+                 MBClippingsProcessLine(parser, parser->line.bytes, parser->line.length);
+            parser->line.length = 0;
+        }
+        if (!ok) {
+            return false;
+        }
+        bytes = newline + 1;
+    }
+    return !parser->stopped;
+}
+
+bool MBClippingsParserFinish(MBClippingsParser *parser) {
+    if (parser->stopped) {
+        return false;
+    }
+    if (parser->line.length > 0) {
+        if (!MBClippingsProcessLine(parser, parser->line.bytes, parser->line.length)) {
+            return false;
+        }
+        parser->line.length = 0;
+    }
+    bool ok = MBClippingsEmit(parser);
+    MBClippingsReset(parser);
+    return ok;
+}
+
+size_t MBClippingsParserMalformedCount(const MBClippingsParser *parser) {
+    return parser->malformed;
+}
+
+#pragma mark - Clippings
+
+@implementation MBKindleClipping
+
+- (instancetype)initWithClipping:(const MBClipping *)clipping {
+    self = [super init];
+    if (self) {
+        _bookTitle = [[NSString alloc] initWithBytes:clipping->title
+                                              length:clipping->titleLength
+                                            encoding:NSUTF8StringEncoding] ?: @"";
+        _author = clipping->author ? [[NSString alloc] initWithBytes:clipping->author
+                                                              length:clipping->authorLength
+                                                            encoding:NSUTF8StringEncoding] : nil;
+        _text = [[NSString alloc] initWithBytes:clipping->text
+                                         length:clipping->textLength
+                                       encoding:NSUTF8StringEncoding] ?: @"";
+        _addedOn = clipping->addedOn ? [[NSString alloc] initWithBytes:clipping->addedOn
+                                                                length:clipping->addedOnLength
+                                                              encoding:NSUTF8StringEncoding] : nil;
+        _location = clipping->location;
+        _kind = clipping->kind;
+        _fingerprint = MBHighlightFingerprint(clipping->text, clipping->textLength);
+    }
+    return self;
+}
+
+@end
+
+#pragma mark - Parser
+
+@implementation MBKindleClippingsParser
+
+static bool MBKindleClippingsBlockHandler(const MBClipping *clipping, void *context) {
+    void (^handler)(MBKindleClipping *, BOOL *) = (__bridge void (^)(MBKindleClipping *, BOOL *))context;
+    BOOL stop = NO;
+    @autoreleasepool {
+        handler([[MBKindleClipping alloc] initWithClipping:clipping], &stop);
+    }
+    return !stop;
+}
+
++ (BOOL)parseFileAtURL:(NSURL *)url
+               handler:(void (^)(MBKindleClipping *clipping, BOOL *stop))handler
+                 error:(NSError **)error {
+    NSInputStream *stream = [NSInputStream inputStreamWithURL:url];
+    [stream open];
+    if (!stream || stream.streamStatus == NSStreamStatusError) {
+        if (error) {
+            *error = stream.streamError ?: [NSError errorWithDomain:NSCocoaErrorDomain
+                                                               code:NSFileReadNoSuchFileError
+                                                           userInfo:@{NSURLErrorKey: url}];
+        }
+        return NO;
+    }
+
+    MBClippingsParser *parser = MBClippingsParserCreate(MBKindleClippingsBlockHandler, (__bridge void *)handler);
+    uint8_t *chunk = malloc(kClippingsChunkSize);
+    if (!parser || !chunk) {
+        MBClippingsParserFree(parser);
+        free(chunk);
+        [stream close];
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil];
+        }
+        return NO;
+    }
+
+    BOOL success = YES;
+    BOOL keepGoing = YES;
+    while (keepGoing) {
+        NSInteger read = [stream read:chunk maxLength:kClippingsChunkSize];
+        if (read < 0) {
+            if (error) {
+                *error = stream.streamError;
+            }
+            success = NO;
+            break;
+        }
+        if (read == 0) {
+            MBClippingsParserFinish(parser);
+            break;
+        }
+        keepGoing = MBClippingsParserFeed(parser, (const char *)chunk, (size_t)read);
+    }
+
+    [stream close];
+    free(chunk);
+    MBClippingsParserFree(parser);
+    return success;
+}
+
+@end
@@ -0,0 +1,117 @@
+//
+//  TraceRing.h
+//  membo
+//
+//  Low-overhead span tracing for native managers. Each thread records fixed-size
+//  spans into its own lock-free ring; a collector drains all rings into a
+//  compact binary batch and uploads it to the telemetry endpoint.
+//
+
+#import <Foundation/Foundation.h>
+#include <mach/mach_time.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Span identifiers. Values are part of the wire format and must stay in sync
+ * with the backend span table (core/monitoring/nativeTraceBatch.ts).
+ */
+typedef NS_ENUM(uint16_t, MBTraceSpan) {
+    MBTraceSpanVoiceStart = 1,
+    MBTraceSpanVoiceStop = 2,
+    MBTraceSpanAudioConfigure = 3,
+    MBTraceSpanAudioActivate = 4,
+    MBTraceSpanAudioDeactivate = 5,
+    MBTraceSpanFileWrite = 6,
+    MBTraceSpanFileRead = 7,
+    MBTraceSpanVoiceRecordingSave = 8,
+    MBTraceSpanStudySessionStart = 9,
+    MBTraceSpanStudyQueueLoad = 10
+};
+
+/// Batch header magic ("MBTR" little-endian)
+extern const uint32_t MBTraceBatchMagic;
+/// Batch format version
+extern const uint16_t MBTraceBatchVersion;
+/// Size of the batch header in bytes
+extern const size_t MBTraceBatchHeaderSize;
+/// Size of one span record in bytes
+extern const size_t MBTraceBatchRecordSize;
+/// Per-thread ring capacity in records
+extern const uint32_t MBTraceRingCapacity;
+
+#pragma mark - Recording
+
+/**
+ * Returns the start timestamp for a span. Raw monotonic ticks; converted to
+ * nanoseconds when the rings are drained.
+ */
+static inline uint64_t MBTraceBegin(void) {
+    return mach_absolute_time();
+}
+
+/**
+ * Records a span that started at `startTicks` and ends now.
+ * Lock-free and allocation-free except for the first span on a thread,
+ * which attaches that thread's ring. Drops the span when the ring is full.
+ *
+ * @param span Span identifier
+ * @param startTicks Value returned by MBTraceBegin
+ * @param arg Span-specific argument (byte count, success flag, ...)
+ */
+void MBTraceEnd(MBTraceSpan span, uint64_t startTicks, uint32_t arg);
+
+#pragma mark - Collection
+
+/**
+ * Drains every thread ring into the binary batch format. Safe to call from
+ * any thread; concurrent drains are serialized.
+ *
+ * Layout (little-endian): 32-byte header
+ *   u32 magic, u16 version, u16 record size, u32 record count, u32 dropped count,
+ *   u64 wall clock at drain (ms since epoch), u64 monotonic clock at drain (ns)
+ * followed by 24-byte records
+ *   u64 start (monotonic ns), u64 duration (ns), u16 span, u16 thread, u32 arg
+ *
+ * @param maxRecords Upper bound on records in the batch
+ * @return Batch data, or nil when there is nothing to report
+ */
+NSData *_Nullable MBTraceDrainBatch(NSUInteger maxRecords);
+
+/**
+ * Periodically drains trace rings and uploads batches to the backend.
+ */
+@interface MBTraceCollector : NSObject
+
+/// Whether periodic upload is running
+@property (nonatomic, readonly, getter=isRunning) BOOL running;
+
++ (instancetype)sharedCollector;
+
+/**
+ * Starts periodic upload. Restarts with the new settings if already running.
+ *
+ * @param url Telemetry ingestion endpoint
+ * @param authToken Bearer token for the request, if any
+ * @param interval Seconds between drains
+ */
+- (void)startUploadingToURL:(NSURL *)url
+                  authToken:(nullable NSString *)authToken
+                   interval:(NSTimeInterval)interval;
+
+/**
+ * Stops periodic upload. Spans keep being recorded until the rings fill.
+ */
+- (void)stop;
+
+/**
+ * Drains and uploads immediately.
+ */
+- (void)flush;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
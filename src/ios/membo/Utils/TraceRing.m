@@ -0,0 +1,325 @@
+//
+//  TraceRing.m
+//  membo
+//
+//  Per-thread single-producer rings registered in a lock-free list. The owning
+//  thread is the only writer of a ring's head; the drainer is the only writer
+//  of its tail, so recording needs no locks or read-modify-write atomics.
+//
+
+#import "TraceRing.h"
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include <os/lock.h>
+#include <libkern/OSByteOrder.h>
+
+const uint32_t MBTraceBatchMagic = 0x5254424D;
+const uint16_t MBTraceBatchVersion = 1;
+const size_t MBTraceBatchHeaderSize = 32;
+const size_t MBTraceBatchRecordSize = 24;
+const uint32_t MBTraceRingCapacity = 1024;
+
+// Must match MBTraceRingCapacity; power of two so the index is a mask
+#define MB_TRACE_RING_CAPACITY 1024u
+#define MB_TRACE_RING_MASK (MB_TRACE_RING_CAPACITY - 1u)
+
+// Records per upload; keeps a batch just under 100 KB
+static const NSUInteger kTraceUploadMaxRecords = 4096;
+
+#pragma mark - Ring
+
+typedef struct {
+    uint64_t startTicks;
+    uint64_t durationTicks;
+    uint32_t arg;
+    uint16_t span;
+} MBTraceSlot;
+
+typedef struct MBTraceRing {
+    // Written by the owning thread only
+    _Alignas(64) _Atomic(uint64_t) head;
+    // Incremented by the owning thread, taken and reset by the drainer
+    _Atomic(uint64_t) dropped;
+    // Written by the drainer only
+    _Alignas(64) _Atomic(uint64_t) tail;
+    _Atomic(bool) retired;
+    struct MBTraceRing *_Atomic next;
+    uint16_t thread;
+    MBTraceSlot slots[MB_TRACE_RING_CAPACITY];
+} MBTraceRing;
+
+static _Atomic(MBTraceRing *) gRingList = NULL;
+static _Atomic(uint16_t) gNextThreadIndex = 1;
+static _Thread_local MBTraceRing *tRing = NULL;
+static pthread_key_t gRingKey;
+static os_unfair_lock gDrainLock = OS_UNFAIR_LOCK_INIT;
+static mach_timebase_info_data_t gTimebase;
+
+static void MBTraceRetireRing(void *value) {
+    // Thread exit: the drainer frees the ring once it is empty
+    MBTraceRing *ring = value;
+    atomic_store_explicit(&ring->retired, true, memory_order_release);
+}
+
+static void MBTraceInitialize(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&gRingKey, MBTraceRetireRing);
+        mach_timebase_info(&gTimebase);
+    });
+}
+
+static MBTraceRing *MBTraceAttachThread(void) {
+    MBTraceInitialize();
+
+    MBTraceRing *ring = calloc(1, sizeof(MBTraceRing));
+    if (!ring) {
+        return NULL;
+    }
+    ring->thread = atomic_fetch_add_explicit(&gNextThreadIndex, 1, memory_order_relaxed);
+
+    MBTraceRing *head = atomic_load_explicit(&gRingList, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&ring->next, head, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&gRingList, &head, ring,
+                                                    memory_order_release, memory_order_relaxed));
+
+    pthread_setspecific(gRingKey, ring);
+    tRing = ring;
+    return ring;
+}
+
+static inline uint64_t MBTraceTicksToNanos(uint64_t ticks) {
+    return ticks * gTimebase.numer / gTimebase.denom;
+}
+
+#pragma mark - Recording
+
+void MBTraceEnd(MBTraceSpan span, uint64_t startTicks, uint32_t arg) {
+    uint64_t endTicks = mach_absolute_time();
+
+    MBTraceRing *ring = tRing;
+    if (__builtin_expect(ring == NULL, 0)) {
+        ring = MBTraceAttachThread();
+        if (!ring) {
+            return;
+        }
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= MB_TRACE_RING_CAPACITY) {
+        // A read-modify-write, so a drain resetting the count in between loses nothing
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    MBTraceSlot *slot = &ring->slots[head & MB_TRACE_RING_MASK];
+    slot->startTicks = startTicks;
+    slot->durationTicks = endTicks - startTicks;
+    slot->arg = arg;
+    slot->span = span;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+#pragma mark - Draining
+
+static inline uint8_t *MBTracePut16(uint8_t *cursor, uint16_t value) {
+    OSWriteLittleInt16(cursor, 0, value);
+    return cursor + sizeof(uint16_t);
+}
+
+static inline uint8_t *MBTracePut32(uint8_t *cursor, uint32_t value) {
+    OSWriteLittleInt32(cursor, 0, value);
+    return cursor + sizeof(uint32_t);
+}
+
+static inline uint8_t *MBTracePut64(uint8_t *cursor, uint64_t value) {
+    OSWriteLittleInt64(cursor, 0, value);
+    return cursor + sizeof(uint64_t);
+}
+
+NSData *_Nullable MBTraceDrainBatch(NSUInteger maxRecords) {
+    MBTraceInitialize();
+
+    os_unfair_lock_lock(&gDrainLock);
+
+    NSMutableData *batch = [NSMutableData dataWithLength:MBTraceBatchHeaderSize];
+    uint32_t recordCount = 0;
+    uint64_t dropped = 0;
+
+    MBTraceRing *listHead = atomic_load_explicit(&gRingList, memory_order_acquire);
+    MBTraceRing *previous = NULL;
+    MBTraceRing *ring = listHead;
+
+    while (ring) {
+        MBTraceRing *next = atomic_load_explicit(&ring->next, memory_order_relaxed);
+        bool retired = atomic_load_explicit(&ring->retired, memory_order_acquire);
+
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t available = MIN(head - tail, (uint64_t)(maxRecords - recordCount));
+
+        if (available > 0) {
+            NSUInteger offset = batch.length;
+            [batch increaseLengthBy:(NSUInteger)available * MBTraceBatchRecordSize];
+            uint8_t *cursor = (uint8_t *)batch.mutableBytes + offset;
+
+            for (uint64_t i = 0; i < available; i++) {
+                const MBTraceSlot *slot = &ring->slots[(tail + i) & MB_TRACE_RING_MASK];
+                cursor = MBTracePut64(cursor, MBTraceTicksToNanos(slot->startTicks));
+                cursor = MBTracePut64(cursor, MBTraceTicksToNanos(slot->durationTicks));
+                cursor = MBTracePut16(cursor, slot->span);
+                cursor = MBTracePut16(cursor, ring->thread);
+                cursor = MBTracePut32(cursor, slot->arg);
+            }
+            tail += available;
+            recordCount += (uint32_t)available;
+            atomic_store_explicit(&ring->tail, tail, memory_order_release);
+        }
+
+        // Each drop is counted by exactly one drain
+        dropped += atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+
+        // Producers only ever replace the list head, so interior nodes can be
+        // unlinked here without racing them
+        if (retired && tail == head && previous) {
+            atomic_store_explicit(&previous->next, next, memory_order_relaxed);
+            free(ring);
+        } else {
+            previous = ring;
+        }
+        ring = next;
+    }
+
+    os_unfair_lock_unlock(&gDrainLock);
+
+    if (recordCount == 0 && dropped == 0) {
+        return nil;
+    }
+
+    uint8_t *cursor = batch.mutableBytes;
+    cursor = MBTracePut32(cursor, MBTraceBatchMagic);
+    cursor = MBTracePut16(cursor, MBTraceBatchVersion);
+    cursor = MBTracePut16(cursor, (uint16_t)MBTraceBatchRecordSize);
+    cursor = MBTracePut32(cursor, recordCount);
+    cursor = MBTracePut32(cursor, (uint32_t)MIN(dropped, (uint64_t)UINT32_MAX));
+    cursor = MBTracePut64(cursor, (uint64_t)llround([NSDate date].timeIntervalSince1970 * 1000.0));
+    MBTracePut64(cursor, MBTraceTicksToNanos(mach_absolute_time()));
+
+    return batch;
+}
+
+#pragma mark - Collector
+
+@interface MBTraceCollector ()
+
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong, nullable) dispatch_source_t timer;
+@property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong, nullable) NSURL *uploadURL;
+@property (nonatomic, copy, nullable) NSString *authToken;
+
+@end
+
+@implementation MBTraceCollector
+
++ (instancetype)sharedCollector {
+    static MBTraceCollector *sharedCollector = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCollector = [[MBTraceCollector alloc] initPrivate];
+    });
+    return sharedCollector;
+}
+
+- (instancetype)initPrivate {
+    self = [super init];
+    if (self) {
+        _queue = dispatch_queue_create("ai.membo.trace", DISPATCH_QUEUE_SERIAL);
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        configuration.timeoutIntervalForRequest = 15;
+        configuration.allowsCellularAccess = YES;
+        _session = [NSURLSession sessionWithConfiguration:configuration];
+    }
+    return self;
+}
+
+- (BOOL)isRunning {
+    __block BOOL running = NO;
+    dispatch_sync(self.queue, ^{
+        running = self.timer != nil;
+    });
+    return running;
+}
+
+- (void)startUploadingToURL:(NSURL *)url
+                  authToken:(nullable NSString *)authToken
+                   interval:(NSTimeInterval)interval {
+    dispatch_async(self.queue, ^{
+        [self cancelTimer];
+        self.uploadURL = url;
+        self.authToken = authToken;
+
+        dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+        uint64_t intervalNanos = (uint64_t)(MAX(interval, 1.0) * NSEC_PER_SEC);
+        dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)intervalNanos),
+                                  intervalNanos, intervalNanos / 10);
+
+        __weak typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(timer, ^{
+            [weakSelf uploadPendingBatch];
+        });
+        dispatch_resume(timer);
+        self.timer = timer;
+    });
+}
+
+- (void)stop {
+    dispatch_async(self.queue, ^{
+        [self cancelTimer];
+    });
+}
+
+- (void)flush {
+    dispatch_async(self.queue, ^{
+        [self uploadPendingBatch];
+    });
+}
+
+#pragma mark - Private Methods
+
+- (void)cancelTimer {
+    if (self.timer) {
+        dispatch_source_cancel(self.timer);
+        self.timer = nil;
+    }
+}
+
+- (void)uploadPendingBatch {
+    if (!self.uploadURL) {
+        return;
+    }
+
+    NSData *batch = MBTraceDrainBatch(kTraceUploadMaxRecords);
+    if (!batch) {
+        return;
+    }
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:self.uploadURL];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = batch;
+    [request setValue:@"application/octet-stream" forHTTPHeaderField:@"Content-Type"];
+    [request setValue:@"ios" forHTTPHeaderField:@"X-Membo-Platform"];
+    if (self.authToken.length) {
+        [request setValue:[@"Bearer " stringByAppendingString:self.authToken]
+       forHTTPHeaderField:@"Authorization"];
+    }
+
+    // Telemetry is best effort: a failed batch is dropped rather than retried
+    [[self.session dataTaskWithRequest:request] resume];
+}
+
+@end
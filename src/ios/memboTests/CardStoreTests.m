@@ -0,0 +1,260 @@
+//
+//  CardStoreTests.m
+//  memboTests
+//
+//  Tests for the SQLite card store: due ordering, append-only review log,
+//  review-log sync cursors, plus queue load and review insert benchmarks.
+//
+
+@import XCTest;  // iOS SDK 12.0+
+#import <sqlite3.h>
+#import "Utils/CardStore.h"
+
+static const NSUInteger kBenchmarkCardCount = 50000;
+static const NSUInteger kBenchmarkQueueLimit = 200;
+static const NSUInteger kBenchmarkReviewCount = 1000;
+
+@interface CardStoreTests : XCTestCase
+
+@property (nonatomic, copy) NSString *databasePath;
+@property (nonatomic, strong) MBCardStore *store;
+
+@end
+
+@implementation CardStoreTests
+
+#pragma mark - Test Lifecycle
+
+- (void)setUp {
+    [super setUp];
+
+    NSString *fileName = [NSString stringWithFormat:@"cardstore-%@.sqlite", [NSUUID UUID].UUIDString];
+    self.databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:fileName];
+
+    NSError *error = nil;
+    self.store = [[MBCardStore alloc] initWithPath:self.databasePath error:&error];
+    XCTAssertNotNil(self.store, @"Store should open: %@", error);
+}
+
+- (void)tearDown {
+    self.store = nil;
+    for (NSString *suffix in @[@"", @"-wal", @"-shm"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.databasePath stringByAppendingString:suffix]
+                                                   error:nil];
+    }
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (NSArray<MBCardRecord *> *)cardsWithCount:(NSUInteger)count dueFrom:(NSDate *)start step:(NSTimeInterval)step {
+    NSMutableArray<MBCardRecord *> *cards = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        MBCardRecord *card = [[MBCardRecord alloc] init];
+        card.cardId = [NSString stringWithFormat:@"card-%06lu", (unsigned long)i];
+        card.front = [NSString stringWithFormat:@"Question %lu", (unsigned long)i];
+        card.back = [NSString stringWithFormat:@"Answer %lu", (unsigned long)i];
+        card.dueAt = [start dateByAddingTimeInterval:step * i];
+        [cards addObject:card];
+    }
+    return cards;
+}
+
+#pragma mark - Storage Tests
+
+- (void)testStoreUsesWriteAheadLog {
+    sqlite3 *db = NULL;
+    XCTAssertEqual(sqlite3_open_v2(self.databasePath.fileSystemRepresentation, &db, SQLITE_OPEN_READONLY, NULL), SQLITE_OK);
+
+    sqlite3_stmt *stmt = NULL;
+    sqlite3_prepare_v2(db, "PRAGMA journal_mode;", -1, &stmt, NULL);
+    XCTAssertEqual(sqlite3_step(stmt), SQLITE_ROW);
+    XCTAssertEqualObjects([NSString stringWithUTF8String:(const char *)sqlite3_column_text(stmt, 0)], @"wal");
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+- (void)testDueCardsAreOrderedAndLimited {
+    NSDate *now = [NSDate date];
+    NSArray<MBCardRecord *> *cards = [self cardsWithCount:10 dueFrom:[now dateByAddingTimeInterval:-3600] step:600];
+    // Insert in reverse to make sure ordering comes from the query
+    XCTAssertTrue([self.store upsertCards:cards.reverseObjectEnumerator.allObjects error:nil]);
+    XCTAssertEqual([self.store cardCount], 10u);
+
+    NSArray<NSString *> *due = [self.store dueCardIdsAtDate:now limit:100 error:nil];
+    NSArray<NSString *> *expected = @[@"card-000000", @"card-000001", @"card-000002",
+                                      @"card-000003", @"card-000004", @"card-000005", @"card-000006"];
+    XCTAssertEqualObjects(due, expected, @"Only overdue cards, most overdue first");
+
+    NSArray<NSString *> *limited = [self.store dueCardIdsAtDate:now limit:3 error:nil];
+    XCTAssertEqualObjects(limited, [expected subarrayWithRange:NSMakeRange(0, 3)]);
+}
+
+- (void)testRecordReviewUpdatesScheduleAndAppendsLog {
+    NSDate *now = [NSDate date];
+    [self.store upsertCards:[self cardsWithCount:1 dueFrom:now step:0] error:nil];
+
+    NSError *error = nil;
+    int64_t sequence = [self.store recordReviewForCardId:@"card-000000" rating:5 reviewedAt:now error:&error];
+    XCTAssertGreaterThan(sequence, 0, @"%@", error);
+
+    MBCardRecord *card = [self.store cardWithId:@"card-000000" error:nil];
+    XCTAssertEqual(card.reviewCount, 1);
+    XCTAssertEqual(card.lastRating, 5);
+    XCTAssertGreaterThan(card.stability, 0.5, @"Good rating should grow stability");
+    XCTAssertLessThan(card.difficulty, 0.3, @"Good rating should lower difficulty");
+    XCTAssertGreaterThanOrEqual([card.dueAt timeIntervalSinceDate:now], 4 * 3600 - 1, @"Minimum interval is 4 hours");
+
+    XCTAssertEqual([self.store recordReviewForCardId:@"missing" rating:3 reviewedAt:now error:&error], 0);
+    XCTAssertEqual(error.code, MBCardStoreErrorCardNotFound);
+
+    XCTAssertEqual([self.store recordReviewForCardId:@"card-000000" rating:9 reviewedAt:now error:&error], 0);
+    XCTAssertEqual(error.code, MBCardStoreErrorInvalidInput);
+}
+
+- (void)testReviewLogIsAppendOnly {
+    [self.store upsertCards:[self cardsWithCount:1 dueFrom:[NSDate date] step:0] error:nil];
+    [self.store recordReviewForCardId:@"card-000000" rating:3 reviewedAt:[NSDate date] error:nil];
+
+    sqlite3 *db = NULL;
+    sqlite3_open(self.databasePath.fileSystemRepresentation, &db);
+    XCTAssertNotEqual(sqlite3_exec(db, "UPDATE review_log SET rating = 1;", NULL, NULL, NULL), SQLITE_OK);
+    XCTAssertNotEqual(sqlite3_exec(db, "DELETE FROM review_log;", NULL, NULL, NULL), SQLITE_OK);
+    sqlite3_close(db);
+
+    XCTAssertEqual([self.store pendingReviewsWithLimit:10 error:nil].count, 1u);
+}
+
+#pragma mark - Sync Tests
+
+- (void)testPendingReviewsAdvanceWithAcknowledgement {
+    NSDate *now = [NSDate date];
+    [self.store upsertCards:[self cardsWithCount:3 dueFrom:now step:0] error:nil];
+
+    NSMutableArray<NSNumber *> *sequences = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; i++) {
+        NSString *cardId = [NSString stringWithFormat:@"card-%06lu", (unsigned long)i];
+        [sequences addObject:@([self.store recordReviewForCardId:cardId rating:4 reviewedAt:now error:nil])];
+    }
+
+    NSArray<MBReviewLogEntry *> *pending = [self.store pendingReviewsWithLimit:10 error:nil];
+    XCTAssertEqual(pending.count, 3u);
+    XCTAssertEqualObjects([pending valueForKey:@"sequence"], sequences);
+
+    XCTAssertTrue([self.store acknowledgeReviewsThroughSequence:sequences[1].longLongValue error:nil]);
+    pending = [self.store pendingReviewsWithLimit:10 error:nil];
+    XCTAssertEqual(pending.count, 1u);
+    XCTAssertEqualObjects(pending.firstObject.cardId, @"card-000002");
+
+    // A stale acknowledgement must not rewind the cursor
+    XCTAssertTrue([self.store acknowledgeReviewsThroughSequence:sequences[0].longLongValue error:nil]);
+    XCTAssertEqual([self.store pendingReviewsWithLimit:10 error:nil].count, 1u);
+}
+
+- (void)testRemoteReviewsApplyOnceAndNeverRewindState {
+    NSDate *now = [NSDate date];
+    [self.store upsertCards:[self cardsWithCount:1 dueFrom:now step:0] error:nil];
+    [self.store recordReviewForCardId:@"card-000000" rating:5 reviewedAt:now error:nil];
+    MBCardRecord *local = [self.store cardWithId:@"card-000000" error:nil];
+
+    MBReviewLogEntry *older = [[MBReviewLogEntry alloc] init];
+    older.sequence = 7;
+    older.cardId = @"card-000000";
+    older.rating = 1;
+    older.reviewedAt = [now dateByAddingTimeInterval:-86400];
+    older.stability = 0.5;
+    older.difficulty = 0.9;
+    older.dueAt = now;
+
+    MBReviewLogEntry *newer = [[MBReviewLogEntry alloc] init];
+    newer.sequence = 8;
+    newer.cardId = @"card-000000";
+    newer.rating = 4;
+    newer.reviewedAt = [now dateByAddingTimeInterval:60];
+    newer.stability = 3.0;
+    newer.difficulty = 0.2;
+    newer.dueAt = [now dateByAddingTimeInterval:3 * 86400];
+
+    XCTAssertEqual([self.store applyRemoteReviews:@[newer, older] error:nil], 2);
+    XCTAssertEqual([self.store lastRemoteSequence], 8);
+
+    MBCardRecord *merged = [self.store cardWithId:@"card-000000" error:nil];
+    XCTAssertEqualWithAccuracy(merged.stability, 3.0, 1e-9, @"Newest review wins");
+    XCTAssertNotEqualWithAccuracy(merged.stability, local.stability, 1e-9);
+
+    // Replaying the same delta is a no-op
+    XCTAssertEqual([self.store applyRemoteReviews:@[older, newer] error:nil], 0);
+
+    // Remote entries are never echoed back as pending local reviews
+    XCTAssertEqual([self.store pendingReviewsWithLimit:10 error:nil].count, 1u);
+}
+
+- (void)testUpsertKeepsNewerLocalSchedule {
+    NSDate *now = [NSDate date];
+    [self.store upsertCards:[self cardsWithCount:1 dueFrom:now step:0] error:nil];
+    [self.store recordReviewForCardId:@"card-000000" rating:5 reviewedAt:now error:nil];
+    MBCardRecord *local = [self.store cardWithId:@"card-000000" error:nil];
+
+    // Server snapshot taken before the offline review
+    MBCardRecord *snapshot = [self cardsWithCount:1 dueFrom:now step:0].firstObject;
+    snapshot.front = @"Edited question";
+    snapshot.stability = 9.0;
+    snapshot.reviewCount = 7;
+    snapshot.lastReviewAt = [now dateByAddingTimeInterval:-86400];
+    XCTAssertTrue([self.store upsertCards:@[snapshot] error:nil]);
+
+    MBCardRecord *merged = [self.store cardWithId:@"card-000000" error:nil];
+    XCTAssertEqualObjects(merged.front, @"Edited question", @"Content always follows the server");
+    XCTAssertEqualWithAccuracy(merged.stability, local.stability, 1e-9, @"Newer local review is kept");
+    XCTAssertEqual(merged.reviewCount, 1);
+    XCTAssertEqualObjects(merged.dueAt, local.dueAt);
+
+    // A snapshot that includes a later review replaces the local schedule
+    snapshot.lastReviewAt = [now dateByAddingTimeInterval:60];
+    XCTAssertTrue([self.store upsertCards:@[snapshot] error:nil]);
+    merged = [self.store cardWithId:@"card-000000" error:nil];
+    XCTAssertEqualWithAccuracy(merged.stability, 9.0, 1e-9);
+    XCTAssertEqual(merged.reviewCount, 7);
+}
+
+- (void)testReopenPreservesData {
+    [self.store upsertCards:[self cardsWithCount:5 dueFrom:[NSDate date] step:0] error:nil];
+    [self.store recordReviewForCardId:@"card-000000" rating:3 reviewedAt:[NSDate date] error:nil];
+    self.store = nil;
+
+    NSError *error = nil;
+    self.store = [[MBCardStore alloc] initWithPath:self.databasePath error:&error];
+    XCTAssertNotNil(self.store, @"%@", error);
+    XCTAssertEqual([self.store cardCount], 5u);
+    XCTAssertEqual([self.store pendingReviewsWithLimit:10 error:nil].count, 1u);
+}
+
+#pragma mark - Performance Tests
+
+- (void)testDueQueueLoadPerformanceAt50kCards {
+    NSDate *now = [NSDate date];
+    // Half the deck is overdue, half scheduled in the future
+    NSArray<MBCardRecord *> *cards = [self cardsWithCount:kBenchmarkCardCount
+                                                  dueFrom:[now dateByAddingTimeInterval:-(NSTimeInterval)kBenchmarkCardCount]
+                                                     step:2];
+    XCTAssertTrue([self.store upsertCards:cards error:nil]);
+
+    [self measureBlock:^{
+        NSArray<NSString *> *due = [self.store dueCardIdsAtDate:now limit:kBenchmarkQueueLimit error:nil];
+        XCTAssertEqual(due.count, kBenchmarkQueueLimit);
+    }];
+}
+
+- (void)testReviewInsertThroughput {
+    NSDate *now = [NSDate date];
+    XCTAssertTrue([self.store upsertCards:[self cardsWithCount:kBenchmarkReviewCount dueFrom:now step:0] error:nil]);
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < kBenchmarkReviewCount; i++) {
+            NSString *cardId = [NSString stringWithFormat:@"card-%06lu", (unsigned long)i];
+            [self.store recordReviewForCardId:cardId rating:(NSInteger)(i % 5) + 1 reviewedAt:now error:nil];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,178 @@
+//
+//  HighlightIndexTests.m
+//  memboTests
+//
+//  Tests for highlight fingerprints, the cuckoo filter and the persistent
+//  per-book highlight index.
+//
+
+@import XCTest;  // iOS SDK 12.0+
+#import "Utils/HighlightIndex.h"
+
+static const NSUInteger kExportSize = 50000;
+
+@interface HighlightIndexTests : XCTestCase
+
+@property (nonatomic, strong) NSURL *directory;
+
+@end
+
+@implementation HighlightIndexTests
+
+- (void)setUp {
+    [super setUp];
+    self.directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]
+                                isDirectory:YES];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.directory error:nil];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+static uint64_t MBTestFingerprint(NSUInteger i) {
+    NSString *text = [NSString stringWithFormat:@"Highlight number %lu from a long export", (unsigned long)i];
+    return MBHighlightFingerprint(text.UTF8String, strlen(text.UTF8String));
+}
+
+#pragma mark - Fingerprint Tests
+
+- (void)testFingerprintIgnoresCaseAndWhitespace {
+    const char *a = "  The Quick\n\tbrown   fox ";
+    const char *b = "the quick brown fox";
+    const char *c = "the quick brown fix";
+    XCTAssertEqual(MBHighlightFingerprint(a, strlen(a)), MBHighlightFingerprint(b, strlen(b)));
+    XCTAssertNotEqual(MBHighlightFingerprint(b, strlen(b)), MBHighlightFingerprint(c, strlen(c)));
+    XCTAssertNotEqual(MBHighlightFingerprint("", 0), 0u);
+}
+
+#pragma mark - Filter Tests
+
+- (void)testCuckooFilterHasNoFalseNegativesAndFewFalsePositives {
+    MBCuckooFilter *filter = MBCuckooFilterCreate(kExportSize);
+    for (NSUInteger i = 0; i < kExportSize; i++) {
+        XCTAssertTrue(MBCuckooFilterInsert(filter, MBTestFingerprint(i)));
+    }
+    for (NSUInteger i = 0; i < kExportSize; i++) {
+        XCTAssertTrue(MBCuckooFilterContains(filter, MBTestFingerprint(i)));
+    }
+
+    NSUInteger falsePositives = 0;
+    for (NSUInteger i = kExportSize; i < kExportSize * 5; i++) {
+        falsePositives += MBCuckooFilterContains(filter, MBTestFingerprint(i)) ? 1 : 0;
+    }
+    XCTAssertLessThan((double)falsePositives / (kExportSize * 4), 0.001);
+    MBCuckooFilterFree(filter);
+}
+
+- (void)testCuckooFilterRoundTrips {
+    MBCuckooFilter *filter = MBCuckooFilterCreate(1000);
+    for (NSUInteger i = 0; i < 1000; i++) {
+        MBCuckooFilterInsert(filter, MBTestFingerprint(i));
+    }
+    MBCuckooFilter *restored = MBCuckooFilterDeserialize(MBCuckooFilterSerialize(filter));
+    XCTAssertTrue(restored != NULL);
+    XCTAssertEqual(MBCuckooFilterCount(restored), 1000u);
+    for (NSUInteger i = 0; i < 1000; i++) {
+        XCTAssertTrue(MBCuckooFilterContains(restored, MBTestFingerprint(i)));
+    }
+
+    NSMutableData *corrupt = [MBCuckooFilterSerialize(filter) mutableCopy];
+    ((uint8_t *)corrupt.mutableBytes)[0] ^= 0xff;
+    XCTAssertTrue(MBCuckooFilterDeserialize(corrupt) == NULL);
+
+    MBCuckooFilterFree(filter);
+    MBCuckooFilterFree(restored);
+}
+
+#pragma mark - Index Tests
+
+- (void)testIndexPersistsAcrossReopen {
+    NSError *error = nil;
+    MBHighlightIndex *index = [MBHighlightIndex indexForBookTitle:@"Dune (Frank Herbert)" directory:self.directory error:&error];
+    XCTAssertNotNil(index, @"%@", error);
+
+    uint64_t fingerprints[3] = { MBTestFingerprint(1), MBTestFingerprint(2), MBTestFingerprint(1) };
+    XCTAssertTrue([index addFingerprints:fingerprints count:3 error:&error]);
+    XCTAssertEqual(index.count, 2u, @"Duplicates within a batch are recorded once");
+
+    MBHighlightIndex *reopened = [MBHighlightIndex indexForBookTitle:@"Dune (Frank Herbert)" directory:self.directory error:&error];
+    XCTAssertEqual(reopened.count, 2u);
+    XCTAssertTrue([reopened containsFingerprint:MBTestFingerprint(1)]);
+    XCTAssertTrue([reopened containsFingerprint:MBTestFingerprint(2)]);
+    XCTAssertFalse([reopened containsFingerprint:MBTestFingerprint(3)]);
+
+    MBHighlightIndex *otherBook = [MBHighlightIndex indexForBookTitle:@"Emma" directory:self.directory error:&error];
+    XCTAssertFalse([otherBook containsFingerprint:MBTestFingerprint(1)]);
+}
+
+- (void)testIndexRebuildsStaleFilterAndDropsTornTail {
+    NSError *error = nil;
+    MBHighlightIndex *index = [MBHighlightIndex indexForBookTitle:@"Book" directory:self.directory error:&error];
+    uint64_t first = MBTestFingerprint(10);
+    uint64_t second = MBTestFingerprint(11);
+    XCTAssertTrue([index addFingerprints:&first count:1 error:&error]);
+
+    // Simulate a crash after the set append but before the filter write,
+    // followed by a torn write
+    NSString *key = [MBHighlightIndex storageKeyForBookTitle:@"Book"];
+    NSURL *setURL = [self.directory URLByAppendingPathComponent:[key stringByAppendingPathExtension:@"fpset"]];
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingToURL:setURL error:&error];
+    [handle seekToEndOfFile];
+    [handle writeData:[NSData dataWithBytes:&second length:sizeof(second)]];
+    [handle writeData:[NSData dataWithBytes:"\x01\x02\x03" length:3]];
+    [handle closeFile];
+
+    MBHighlightIndex *reopened = [MBHighlightIndex indexForBookTitle:@"Book" directory:self.directory error:&error];
+    XCTAssertNotNil(reopened, @"%@", error);
+    XCTAssertEqual(reopened.count, 2u);
+    XCTAssertTrue([reopened containsFingerprint:first]);
+    XCTAssertTrue([reopened containsFingerprint:second]);
+}
+
+- (void)testIndexGrowsPastInitialFilter {
+    NSError *error = nil;
+    MBHighlightIndex *index = [MBHighlightIndex indexForBookTitle:@"Big Book" directory:self.directory error:&error];
+
+    uint64_t *fingerprints = malloc(kExportSize * sizeof(uint64_t));
+    for (NSUInteger i = 0; i < kExportSize; i++) {
+        fingerprints[i] = MBTestFingerprint(i);
+    }
+    for (NSUInteger offset = 0; offset < kExportSize; offset += 5000) {
+        XCTAssertTrue([index addFingerprints:fingerprints + offset count:5000 error:&error], @"%@", error);
+    }
+    XCTAssertEqual(index.count, kExportSize);
+    for (NSUInteger i = 0; i < kExportSize; i++) {
+        XCTAssertTrue([index containsFingerprint:fingerprints[i]]);
+    }
+    free(fingerprints);
+}
+
+#pragma mark - Performance Tests
+
+- (void)testNewHighlightLookupPerformance {
+    NSError *error = nil;
+    MBHighlightIndex *index = [MBHighlightIndex indexForBookTitle:@"Perf Book" directory:self.directory error:&error];
+    uint64_t *fingerprints = malloc(kExportSize * sizeof(uint64_t));
+    for (NSUInteger i = 0; i < kExportSize; i++) {
+        fingerprints[i] = MBTestFingerprint(i);
+    }
+    [index addFingerprints:fingerprints count:kExportSize error:&error];
+    for (NSUInteger i = 0; i < kExportSize; i++) {
+        fingerprints[i] = MBTestFingerprint(i + kExportSize);
+    }
+
+    // New highlights are the common case on re-import and should stay in the filter
+    [self measureBlock:^{
+        NSUInteger known = 0;
+        for (NSUInteger i = 0; i < kExportSize; i++) {
+            known += [index containsFingerprint:fingerprints[i]] ? 1 : 0;
+        }
+        XCTAssertEqual(known, 0u);
+    }];
+    free(fingerprints);
+}
+
+@end
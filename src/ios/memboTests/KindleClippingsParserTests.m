@@ -0,0 +1,232 @@
+//
+//  KindleClippingsParserTests.m
+//  memboTests
+//
+//  Tests for the streaming Kindle clippings parser and incremental import
+//  over a synthetic 50k-highlight export.
+//
+
+@import XCTest;  // iOS SDK 12.0+
+#import "Utils/KindleClippingsParser.h"
+#import "Utils/HighlightIndex.h"
+
+static const NSUInteger kExportHighlights = 50000;
+static const NSUInteger kExportBooks = 37;
+
+static NSString *const kSampleExport =
+    @"﻿Dune (Frank Herbert)\r\n"
+    @"- Your Highlight on page 12 | Location 171-173 | Added on Sunday, March 3, 2024 10:15:00 AM\r\n"
+    @"\r\n"
+    @"I must not fear.\r\n"
+    @"Fear is the mind-killer.\r\n"
+    @"==========\r\n"
+    @"﻿Dune (Frank Herbert)\r\n"
+    @"- Your Note on page 12 | Location 173 | Added on Sunday, March 3, 2024 10:16:00 AM\r\n"
+    @"\r\n"
+    @"Litany against fear\r\n"
+    @"==========\r\n"
+    @"﻿Emma\r\n"
+    @"- Your Bookmark at location 40 | Added on Monday, March 4, 2024 9:00:00 PM\r\n"
+    @"\r\n"
+    @"\r\n"
+    @"==========\r\n";
+
+@interface KindleClippingsParserTests : XCTestCase
+
+@property (nonatomic, strong) NSURL *directory;
+
+@end
+
+@implementation KindleClippingsParserTests
+
+- (void)setUp {
+    [super setUp];
+    self.directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]
+                                isDirectory:YES];
+    [[NSFileManager defaultManager] createDirectoryAtURL:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.directory error:nil];
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (NSURL *)writeExport:(NSString *)contents name:(NSString *)name {
+    NSURL *url = [self.directory URLByAppendingPathComponent:name];
+    [contents writeToURL:url atomically:YES encoding:NSUTF8StringEncoding error:nil];
+    return url;
+}
+
+- (NSURL *)syntheticExportWithHighlights:(NSUInteger)count offset:(NSUInteger)offset {
+    NSMutableString *contents = [NSMutableString stringWithCapacity:count * 200];
+    for (NSUInteger i = offset; i < offset + count; i++) {
+        [contents appendFormat:@"﻿Book %lu (Author %lu)\r\n"
+                               @"- Your Highlight on page %lu | Location %lu-%lu | Added on Sunday, March 3, 2024 10:%02lu:00 AM\r\n"
+                               @"\r\n"
+                               @"Highlight %lu wraps over\r\ntwo lines of text.\r\n"
+                               @"==========\r\n",
+         (unsigned long)(i % kExportBooks), (unsigned long)(i % kExportBooks),
+         (unsigned long)(i / 10 + 1), (unsigned long)(i + 100), (unsigned long)(i + 102), (unsigned long)(i % 60),
+         (unsigned long)i];
+    }
+    return [self writeExport:contents name:[NSString stringWithFormat:@"export-%lu-%lu.txt", (unsigned long)offset, (unsigned long)count]];
+}
+
+static bool MBCountingHandler(const MBClipping *clipping, void *context) {
+    NSUInteger *counts = context;
+    counts[0]++;
+    counts[1] ^= (NSUInteger)MBHighlightFingerprint(clipping->text, clipping->textLength) * counts[0];
+    counts[2] += clipping->location;
+    return true;
+}
+
+#pragma mark - Parsing Tests
+
+- (void)testParsesEntriesKindsAndMetadata {
+    NSMutableArray<MBKindleClipping *> *clippings = [NSMutableArray array];
+    NSError *error = nil;
+    BOOL parsed = [MBKindleClippingsParser parseFileAtURL:[self writeExport:kSampleExport name:@"sample.txt"]
+                                                  handler:^(MBKindleClipping *clipping, BOOL *stop) {
+        [clippings addObject:clipping];
+    } error:&error];
+
+    XCTAssertTrue(parsed, @"%@", error);
+    XCTAssertEqual(clippings.count, 3u);
+
+    MBKindleClipping *highlight = clippings[0];
+    XCTAssertEqualObjects(highlight.bookTitle, @"Dune");
+    XCTAssertEqualObjects(highlight.author, @"Frank Herbert");
+    XCTAssertEqualObjects(highlight.text, @"I must not fear.\nFear is the mind-killer.");
+    XCTAssertEqualObjects(highlight.addedOn, @"Sunday, March 3, 2024 10:15:00 AM");
+    XCTAssertEqual(highlight.location, 171u);
+    XCTAssertEqual(highlight.kind, MBClippingKindHighlight);
+
+    XCTAssertEqual(clippings[1].kind, MBClippingKindNote);
+    XCTAssertEqual(clippings[2].kind, MBClippingKindBookmark);
+    XCTAssertEqualObjects(clippings[2].bookTitle, @"Emma");
+    XCTAssertNil(clippings[2].author);
+    XCTAssertEqual(clippings[2].location, 40u);
+}
+
+- (void)testChunkBoundariesDoNotChangeResults {
+    NSData *data = [NSData dataWithContentsOfURL:[self syntheticExportWithHighlights:500 offset:0]];
+    const char *bytes = data.bytes;
+
+    NSUInteger whole[3] = {0};
+    MBClippingsParser *parser = MBClippingsParserCreate(MBCountingHandler, whole);
+    MBClippingsParserFeed(parser, bytes, data.length);
+    MBClippingsParserFinish(parser);
+    MBClippingsParserFree(parser);
+    XCTAssertEqual(whole[0], 500u);
+
+    for (size_t chunk = 1; chunk <= 4097; chunk = chunk * 3 + 1) {
+        NSUInteger split[3] = {0};
+        parser = MBClippingsParserCreate(MBCountingHandler, split);
+        for (size_t offset = 0; offset < data.length; offset += chunk) {
+            MBClippingsParserFeed(parser, bytes + offset, MIN(chunk, data.length - offset));
+        }
+        MBClippingsParserFinish(parser);
+        MBClippingsParserFree(parser);
+        XCTAssertEqual(split[0], whole[0], @"chunk %zu", chunk);
+        XCTAssertEqual(split[1], whole[1], @"chunk %zu", chunk);
+        XCTAssertEqual(split[2], whole[2], @"chunk %zu", chunk);
+    }
+}
+
+- (void)testTrailingEntryWithoutSeparatorIsEmitted {
+    NSString *export = @"Book\n- Your Highlight at location 5 | Added on Monday\n\nlast one";
+    __block NSUInteger count = 0;
+    [MBKindleClippingsParser parseFileAtURL:[self writeExport:export name:@"trailing.txt"]
+                                    handler:^(MBKindleClipping *clipping, BOOL *stop) {
+        count++;
+        XCTAssertEqualObjects(clipping.text, @"last one");
+    } error:nil];
+    XCTAssertEqual(count, 1u);
+}
+
+- (void)testHandlerCanStopEarly {
+    __block NSUInteger count = 0;
+    [MBKindleClippingsParser parseFileAtURL:[self syntheticExportWithHighlights:100 offset:0]
+                                    handler:^(MBKindleClipping *clipping, BOOL *stop) {
+        *stop = ++count == 10;
+    } error:nil];
+    XCTAssertEqual(count, 10u);
+}
+
+- (void)testMissingFileFails {
+    NSError *error = nil;
+    BOOL parsed = [MBKindleClippingsParser parseFileAtURL:[self.directory URLByAppendingPathComponent:@"missing.txt"]
+                                                  handler:^(MBKindleClipping *clipping, BOOL *stop) {}
+                                                    error:&error];
+    XCTAssertFalse(parsed);
+    XCTAssertNotNil(error);
+}
+
+#pragma mark - Incremental Import Tests
+
+- (NSUInteger)importNewHighlightsFromURL:(NSURL *)url indexes:(NSMutableDictionary<NSString *, MBHighlightIndex *> *)indexes {
+    NSMutableDictionary<NSString *, NSMutableData *> *captured = [NSMutableDictionary dictionary];
+    __block NSUInteger newCount = 0;
+
+    [MBKindleClippingsParser parseFileAtURL:url handler:^(MBKindleClipping *clipping, BOOL *stop) {
+        MBHighlightIndex *index = indexes[clipping.bookTitle];
+        if (!index) {
+            index = [MBHighlightIndex indexForBookTitle:clipping.bookTitle directory:self.directory error:nil];
+            indexes[clipping.bookTitle] = index;
+        }
+        if ([index containsFingerprint:clipping.fingerprint]) {
+            return;
+        }
+        uint64_t fingerprint = clipping.fingerprint;
+        NSMutableData *fingerprints = captured[clipping.bookTitle] ?: (captured[clipping.bookTitle] = [NSMutableData data]);
+        [fingerprints appendBytes:&fingerprint length:sizeof(fingerprint)];
+        newCount++;
+    } error:nil];
+
+    [captured enumerateKeysAndObjectsUsingBlock:^(NSString *book, NSMutableData *fingerprints, BOOL *stop) {
+        [indexes[book] addFingerprints:fingerprints.bytes count:fingerprints.length / sizeof(uint64_t) error:nil];
+    }];
+    return newCount;
+}
+
+- (void)testReimportEmitsOnlyNewHighlights {
+    NSMutableDictionary *indexes = [NSMutableDictionary dictionary];
+    NSURL *first = [self syntheticExportWithHighlights:kExportHighlights offset:0];
+    XCTAssertEqual([self importNewHighlightsFromURL:first indexes:indexes], kExportHighlights);
+
+    // Fresh indexes read back from disk, as after an app restart
+    [indexes removeAllObjects];
+    XCTAssertEqual([self importNewHighlightsFromURL:first indexes:indexes], 0u);
+
+    // A later export contains everything plus 1,000 new highlights
+    NSURL *grown = [self syntheticExportWithHighlights:kExportHighlights + 1000 offset:0];
+    XCTAssertEqual([self importNewHighlightsFromURL:grown indexes:indexes], 1000u);
+}
+
+#pragma mark - Performance Tests
+
+- (void)testParsePerformanceFor50kHighlights {
+    NSURL *url = [self syntheticExportWithHighlights:kExportHighlights offset:0];
+
+    [self measureBlock:^{
+        __block NSUInteger count = 0;
+        [MBKindleClippingsParser parseFileAtURL:url handler:^(MBKindleClipping *clipping, BOOL *stop) {
+            count++;
+        } error:nil];
+        XCTAssertEqual(count, kExportHighlights);
+    }];
+}
+
+- (void)testReimportPerformanceFor50kHighlights {
+    NSURL *url = [self syntheticExportWithHighlights:kExportHighlights offset:0];
+    NSMutableDictionary *indexes = [NSMutableDictionary dictionary];
+    [self importNewHighlightsFromURL:url indexes:indexes];
+
+    [self measureBlock:^{
+        XCTAssertEqual([self importNewHighlightsFromURL:url indexes:indexes], 0u);
+    }];
+}
+
+@end
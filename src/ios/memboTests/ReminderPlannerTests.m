@@ -0,0 +1,254 @@
+//
+//  ReminderPlannerTests.m
+//  memboTests
+//
+//  Tests for the reminder planner: cap and spacing on synthetic 100k-card
+//  decks, optimality against brute force, plan diffing and planning time.
+//
+
+@import XCTest;  // iOS SDK 12.0+
+#import "Managers/ReminderPlanner.h"
+
+static const NSUInteger kSyntheticDeckSize = 100000;
+static const NSTimeInterval kDay = 86400.0;
+static const NSTimeInterval kHour = 3600.0;
+
+// Fixed reference on an hour boundary, UTC
+static const NSTimeInterval kNow = 1699999200.0;
+
+@interface ReminderPlannerTests : XCTestCase
+@end
+
+@implementation ReminderPlannerTests
+
+#pragma mark - Helpers
+
+- (NSData *)syntheticDeckWithSeed:(long)seed {
+    srand48(seed);
+    NSMutableData *deck = [NSMutableData dataWithLength:kSyntheticDeckSize * sizeof(double)];
+    double *times = deck.mutableBytes;
+    for (NSUInteger i = 0; i < kSyntheticDeckSize; i++) {
+        // A tenth overdue, the rest spread over three weeks with a front-loaded tail
+        double u = drand48();
+        times[i] = u < 0.1 ? kNow - drand48() * 7 * kDay : kNow + pow(drand48(), 2) * 21 * kDay;
+    }
+    return deck;
+}
+
+- (MBReminderPlannerConfig)utcConfig {
+    MBReminderPlannerConfig config = MBReminderPlannerDefaultConfig();
+    config.utcOffset = 0;
+    return config;
+}
+
+static void MBUniformWeights(double weights[MB_REMINDER_HOURS_PER_DAY]) {
+    for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+        weights[h] = 1.0;
+    }
+}
+
+#pragma mark - Planning Tests
+
+- (void)testEmptyDeckSchedulesNothing {
+    double weights[MB_REMINDER_HOURS_PER_DAY];
+    MBUniformWeights(weights);
+    MBReminderSlot slots[8];
+
+    XCTAssertEqual(MBPlanReminders(NULL, 0, weights, kNow, [self utcConfig], slots, 8), 0u);
+}
+
+- (void)testSyntheticDeckRespectsCapAndSpacing {
+    NSData *deck = [self syntheticDeckWithSeed:7];
+    double weights[MB_REMINDER_HOURS_PER_DAY];
+    MBUniformWeights(weights);
+
+    MBReminderPlannerConfig config = [self utcConfig];
+    config.maxReminders = 20;
+    MBReminderSlot slots[64];
+
+    NSUInteger planned = MBPlanReminders(deck.bytes, kSyntheticDeckSize, weights, kNow, config, slots, 64);
+    XCTAssertGreaterThan(planned, 0u);
+    XCTAssertLessThanOrEqual(planned, config.maxReminders);
+
+    uint32_t newlyDueTotal = 0;
+    for (NSUInteger i = 0; i < planned; i++) {
+        XCTAssertGreaterThanOrEqual(slots[i].fireTime, kNow);
+        XCTAssertLessThan(slots[i].fireTime, kNow + config.horizon);
+        XCTAssertEqual(fmod(slots[i].fireTime, kHour), 0.0);
+        if (i > 0) {
+            XCTAssertGreaterThanOrEqual(slots[i].fireTime - slots[i - 1].fireTime, config.minimumSpacing);
+            XCTAssertGreaterThanOrEqual(slots[i].dueCount, slots[i - 1].dueCount);
+        }
+        newlyDueTotal += slots[i].newlyDueCount;
+    }
+    XCTAssertEqual(newlyDueTotal, slots[planned - 1].dueCount, @"Reminders partition the due cards");
+}
+
+- (void)testRemindersFollowStudyHours {
+    NSData *deck = [self syntheticDeckWithSeed:11];
+    double weights[MB_REMINDER_HOURS_PER_DAY] = {0};
+    weights[19] = 1.0;
+
+    MBReminderSlot slots[64];
+    NSUInteger planned = MBPlanReminders(deck.bytes, kSyntheticDeckSize, weights, kNow, [self utcConfig], slots, 64);
+    XCTAssertGreaterThan(planned, 0u);
+
+    for (NSUInteger i = 0; i < planned; i++) {
+        NSInteger hour = ((NSInteger)(slots[i].fireTime / kHour)) % 24;
+        XCTAssertEqual(hour, 19, @"Only the studied hour has weight");
+    }
+    XCTAssertLessThanOrEqual(planned, 14u, @"At most one reminder per day at that hour");
+}
+
+- (void)testSmallCardCountsAreNotWorthAReminder {
+    double due[] = { kNow + 2 * kHour, kNow + 30 * kHour };
+    double weights[MB_REMINDER_HOURS_PER_DAY];
+    MBUniformWeights(weights);
+    MBReminderSlot slots[8];
+
+    MBReminderPlannerConfig config = [self utcConfig];
+    config.reminderCost = 5.0;
+    XCTAssertEqual(MBPlanReminders(due, 2, weights, kNow, config, slots, 8), 0u);
+
+    config.reminderCost = 0.5;
+    XCTAssertGreaterThan(MBPlanReminders(due, 2, weights, kNow, config, slots, 8), 0u);
+}
+
+- (void)testPlanMatchesBruteForceOnSmallHorizon {
+    MBReminderPlannerConfig config = [self utcConfig];
+    config.horizon = 12 * kHour;
+    config.minimumSpacing = 2 * kHour;
+    config.maxReminders = 3;
+    config.reminderCost = 3.0;
+    config.stalenessHalfLife = 4 * kHour;
+
+    for (long seed = 1; seed <= 50; seed++) {
+        srand48(seed);
+        double due[40];
+        for (NSUInteger i = 0; i < 40; i++) {
+            due[i] = kNow + drand48() * 14 * kHour;
+        }
+        double weights[MB_REMINDER_HOURS_PER_DAY];
+        for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+            weights[h] = drand48();
+        }
+
+        // Enumerate every subset of the 12 hourly candidates, valuing each
+        // card by the time it waited since it became due
+        double maxWeight = 0;
+        for (NSUInteger h = 0; h < MB_REMINDER_HOURS_PER_DAY; h++) {
+            maxWeight = MAX(maxWeight, weights[h]);
+        }
+        double bruteBest = 0;
+        for (uint32_t mask = 1; mask < (1u << 12); mask++) {
+            if (__builtin_popcount(mask) > 3) {
+                continue;
+            }
+            double value = 0;
+            NSInteger previous = -100;
+            BOOL valid = YES;
+            for (NSInteger s = 0; s < 12; s++) {
+                if (!(mask & (1u << s))) {
+                    continue;
+                }
+                if (s - previous < 2) {
+                    valid = NO;
+                    break;
+                }
+                double fireTime = kNow + s * kHour;
+                double previousFire = kNow + previous * kHour;
+                double gained = 0;
+                for (NSUInteger i = 0; i < 40; i++) {
+                    if (due[i] <= fireTime && due[i] > previousFire) {
+                        double waited = fireTime - ceil(due[i] / kHour) * kHour;
+                        gained += exp2(-waited / config.stalenessHalfLife);
+                    }
+                }
+                double weight = weights[((NSInteger)(fireTime / kHour)) % 24] / maxWeight;
+                value += weight * gained - config.reminderCost;
+                previous = s;
+            }
+            if (valid) {
+                bruteBest = MAX(bruteBest, value);
+            }
+        }
+
+        MBReminderSlot slots[3];
+        NSUInteger planned = MBPlanReminders(due, 40, weights, kNow, config, slots, 3);
+        double plannedValue = 0;
+        double previousFire = -INFINITY;
+        for (NSUInteger i = 0; i < planned; i++) {
+            double gained = 0;
+            for (NSUInteger c = 0; c < 40; c++) {
+                if (due[c] <= slots[i].fireTime && due[c] > previousFire) {
+                    double waited = slots[i].fireTime - ceil(due[c] / kHour) * kHour;
+                    gained += exp2(-waited / config.stalenessHalfLife);
+                }
+            }
+            double weight = weights[((NSInteger)(slots[i].fireTime / kHour)) % 24] / maxWeight;
+            plannedValue += weight * gained - config.reminderCost;
+            previousFire = slots[i].fireTime;
+        }
+        XCTAssertEqualWithAccuracy(plannedValue, bruteBest, 1e-9, @"seed %ld", seed);
+    }
+}
+
+#pragma mark - Diff Tests
+
+- (void)testDiffAppliesOnlyChanges {
+    NSData *deck = [self syntheticDeckWithSeed:3];
+    NSArray<NSNumber *> *weights = [MBReminderPlanner studyHourWeights];
+    NSDate *now = [NSDate dateWithTimeIntervalSince1970:kNow];
+
+    NSArray<MBPlannedReminder *> *plan = [MBReminderPlanner planWithDueTimestamps:deck
+                                                                      hourWeights:weights
+                                                                              now:now
+                                                                           config:[self utcConfig]];
+    XCTAssertGreaterThan(plan.count, 1u);
+
+    NSMutableDictionary<NSString *, NSNumber *> *scheduled = [NSMutableDictionary dictionary];
+    for (MBPlannedReminder *reminder in plan) {
+        scheduled[reminder.identifier] = @(reminder.dueCount);
+    }
+
+    MBReminderPlanDiff *noop = [MBReminderPlanner diffPlan:plan againstScheduled:scheduled];
+    XCTAssertEqual(noop.remindersToAdd.count, 0u);
+    XCTAssertEqual(noop.identifiersToRemove.count, 0u);
+    XCTAssertEqual(noop.unchangedCount, plan.count);
+
+    // One stale count and one reminder that is no longer planned
+    scheduled[plan.firstObject.identifier] = @(plan.firstObject.dueCount + 1);
+    scheduled[@"ai.membo.reminder.1"] = @10;
+
+    MBReminderPlanDiff *diff = [MBReminderPlanner diffPlan:plan againstScheduled:scheduled];
+    XCTAssertEqual(diff.remindersToAdd.count, 1u);
+    XCTAssertEqualObjects(diff.remindersToAdd.firstObject.identifier, plan.firstObject.identifier);
+    XCTAssertEqualObjects(diff.identifiersToRemove, @[@"ai.membo.reminder.1"]);
+    XCTAssertEqual(diff.unchangedCount, plan.count - 1);
+}
+
+- (void)testReplanKeepsIdentifiersStable {
+    NSData *deck = [self syntheticDeckWithSeed:5];
+    NSArray<NSNumber *> *weights = [MBReminderPlanner studyHourWeights];
+    NSDate *now = [NSDate dateWithTimeIntervalSince1970:kNow];
+
+    NSArray *first = [MBReminderPlanner planWithDueTimestamps:deck hourWeights:weights now:now config:[self utcConfig]];
+    NSArray *second = [MBReminderPlanner planWithDueTimestamps:deck hourWeights:weights now:now config:[self utcConfig]];
+    XCTAssertEqualObjects([first valueForKey:@"identifier"], [second valueForKey:@"identifier"]);
+}
+
+#pragma mark - Performance Tests
+
+- (void)testPlanningTimeFor100kCards {
+    NSData *deck = [self syntheticDeckWithSeed:42];
+    NSArray<NSNumber *> *weights = [MBReminderPlanner studyHourWeights];
+    NSDate *now = [NSDate dateWithTimeIntervalSince1970:kNow];
+    MBReminderPlannerConfig config = [self utcConfig];
+
+    [self measureBlock:^{
+        NSArray *plan = [MBReminderPlanner planWithDueTimestamps:deck hourWeights:weights now:now config:config];
+        XCTAssertGreaterThan(plan.count, 0u);
+    }];
+}
+
+@end
@@ -0,0 +1,356 @@
+//
+//  StudySessionActorTests.m
+//  memboTests
+//
+//  Property-based ordering tests and per-rating latency benchmark for the
+//  study session actor.
+//
+
+@import XCTest;  // iOS SDK 12.0+
+#import "Managers/StudySessionActor.h"
+#import "Constants/StudyModes.h"
+
+static const NSInteger kTestMaxCards = 25;
+static const NSUInteger kRandomSequenceCount = 200;
+static const NSUInteger kRandomSequenceLength = 60;
+static const NSUInteger kProducerCount = 8;
+static const NSUInteger kRatingsPerProducer = 2000;
+static const NSUInteger kBenchmarkRatings = 1000;
+
+#pragma mark - Reference Model
+
+/// Straight-line model of the session rules, written independently of the actor.
+typedef struct {
+    MBStudySessionState state;
+    MBStudyMode mode;
+    NSInteger maxCards;
+    NSInteger reviewed;
+} MBReferenceSession;
+
+static NSArray<NSNumber *> *MBReferenceApply(MBReferenceSession *model,
+                                             MBStudySessionCommandType command,
+                                             MBStudyMode mode,
+                                             NSInteger rating) {
+    BOOL running = model->state == MBStudySessionStateActive;
+    BOOL paused = model->state == MBStudySessionStatePaused;
+    BOOL stopped = !running && !paused;
+
+    switch (command) {
+        case MBStudySessionCommandStart:
+            if (!stopped) break;
+            model->state = MBStudySessionStateActive;
+            model->mode = mode;
+            model->reviewed = 0;
+            return @[@(MBStudySessionEventStarted)];
+        case MBStudySessionCommandRate:
+            if (!running || rating < 1 || rating > 5) break;
+            model->reviewed++;
+            if (model->reviewed >= model->maxCards) {
+                model->state = MBStudySessionStateEnded;
+                return @[@(MBStudySessionEventRated), @(MBStudySessionEventCompleted)];
+            }
+            return @[@(MBStudySessionEventRated)];
+        case MBStudySessionCommandVoice:
+            if (!running || model->mode != MBStudyModeVoice) break;
+            return @[@(MBStudySessionEventVoiceReceived)];
+        case MBStudySessionCommandPause:
+            if (!running) break;
+            model->state = MBStudySessionStatePaused;
+            return @[@(MBStudySessionEventPaused)];
+        case MBStudySessionCommandResume:
+            if (!paused) break;
+            model->state = MBStudySessionStateActive;
+            return @[@(MBStudySessionEventResumed)];
+        case MBStudySessionCommandEnd:
+            if (stopped) break;
+            model->state = MBStudySessionStateEnded;
+            return @[@(MBStudySessionEventCompleted)];
+    }
+    return @[@(MBStudySessionEventRejected)];
+}
+
+#pragma mark - Test Case
+
+@interface StudySessionActorTests : XCTestCase <MBStudySessionActorDelegate>
+
+@property (nonatomic, strong) MBStudySessionActor *actor;
+@property (nonatomic, strong) dispatch_queue_t delegateQueue;
+@property (nonatomic, strong) NSMutableArray<MBStudySessionEvent *> *events;
+@property (nonatomic, assign) NSUInteger batchCount;
+@property (nonatomic, assign) uint64_t awaitedTicket;
+@property (nonatomic, strong, nullable) dispatch_semaphore_t ticketSemaphore;
+@property (nonatomic, assign) uint64_t highestTicket;
+@property (nonatomic, assign) MBStudyModeConfig testConfig;
+
+@end
+
+@implementation StudySessionActorTests
+
+#pragma mark - Test Lifecycle
+
+- (void)setUp {
+    [super setUp];
+
+    self.delegateQueue = dispatch_queue_create("ai.membo.tests.studysession", DISPATCH_QUEUE_SERIAL);
+    self.actor = [[MBStudySessionActor alloc] initWithDelegateQueue:self.delegateQueue];
+    self.actor.delegate = self;
+    self.events = [NSMutableArray array];
+    self.batchCount = 0;
+
+    self.testConfig = (MBStudyModeConfig){
+        .sessionDuration = 3600,
+        .allowVoiceInput = YES,
+        .showConfidenceButtons = YES,
+        .enableFSRS = YES,
+        .minCardsPerSession = 1,
+        .maxCardsPerSession = kTestMaxCards,
+        .voiceConfidenceThreshold = MB_DEFAULT_VOICE_CONFIDENCE_THRESHOLD,
+        .enableAutoAdvance = NO,
+        .cardDisplayDuration = 0,
+        .enableHapticFeedback = NO
+    };
+}
+
+- (void)tearDown {
+    self.actor.delegate = nil;
+    self.actor = nil;
+    self.events = nil;
+    self.ticketSemaphore = nil;
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+/// Waits until every posted command is applied and its events delivered.
+- (NSArray<MBStudySessionEvent *> *)settledEvents {
+    [self.actor waitUntilDrained];
+    __block NSArray<MBStudySessionEvent *> *snapshot;
+    dispatch_sync(self.delegateQueue, ^{
+        snapshot = [self.events copy];
+        [self.events removeAllObjects];
+    });
+    return snapshot;
+}
+
+- (MBStudyModeConfig)configWithMaxCards:(NSInteger)maxCards {
+    MBStudyModeConfig config = self.testConfig;
+    config.maxCardsPerSession = maxCards;
+    return config;
+}
+
+#pragma mark - Transition Tests
+
+- (void)testTransitionTable {
+    MBStudySessionState next = MBStudySessionStateIdle;
+
+    XCTAssertTrue(MBStudySessionTransition(MBStudySessionStateIdle, MBStudySessionCommandStart, &next));
+    XCTAssertEqual(next, MBStudySessionStateActive);
+    XCTAssertFalse(MBStudySessionTransition(MBStudySessionStateIdle, MBStudySessionCommandRate, &next));
+    XCTAssertFalse(MBStudySessionTransition(MBStudySessionStateActive, MBStudySessionCommandStart, &next));
+    XCTAssertTrue(MBStudySessionTransition(MBStudySessionStateActive, MBStudySessionCommandPause, &next));
+    XCTAssertEqual(next, MBStudySessionStatePaused);
+    XCTAssertFalse(MBStudySessionTransition(MBStudySessionStatePaused, MBStudySessionCommandRate, &next));
+    XCTAssertTrue(MBStudySessionTransition(MBStudySessionStatePaused, MBStudySessionCommandEnd, &next));
+    XCTAssertEqual(next, MBStudySessionStateEnded);
+    XCTAssertTrue(MBStudySessionTransition(MBStudySessionStateEnded, MBStudySessionCommandStart, &next));
+    XCTAssertFalse(MBStudySessionTransition(MBStudySessionStateEnded, MBStudySessionCommandEnd, &next));
+}
+
+- (void)testInvalidConfigurationIsRejected {
+    MBStudyModeConfig config = self.testConfig;
+    config.sessionDuration = 0;
+
+    [self.actor postStartWithMode:MBStudyModeStandard config:config cardCount:10];
+    NSArray<MBStudySessionEvent *> *events = [self settledEvents];
+
+    XCTAssertEqual(events.count, 1u);
+    XCTAssertEqual(events.firstObject.type, MBStudySessionEventRejected);
+    XCTAssertEqual(self.actor.state, MBStudySessionStateIdle);
+}
+
+- (void)testRatingAtCardLimitCompletesWithoutReentry {
+    [self.actor postStartWithMode:MBStudyModeStandard config:[self configWithMaxCards:3] cardCount:3];
+    [self.actor postRating:4];
+    [self.actor postRating:3];
+    [self.actor postRating:5];
+    [self.actor postRating:2];
+
+    NSArray<MBStudySessionEvent *> *events = [self settledEvents];
+    NSArray *types = [events valueForKey:@"type"];
+
+    XCTAssertEqualObjects(types, (@[@(MBStudySessionEventStarted),
+                                    @(MBStudySessionEventRated),
+                                    @(MBStudySessionEventRated),
+                                    @(MBStudySessionEventRated),
+                                    @(MBStudySessionEventCompleted),
+                                    @(MBStudySessionEventRejected)]));
+    MBStudySessionEvent *completed = events[4];
+    XCTAssertEqualObjects(completed.stats[@"totalCards"], @3);
+    XCTAssertEqualObjects(completed.stats[@"completionRate"], @1.0);
+    XCTAssertEqual(self.actor.state, MBStudySessionStateEnded);
+}
+
+- (void)testEventsCarryTheirSessionStartTicket {
+    uint64_t first = [self.actor postStartWithMode:MBStudyModeStandard config:self.testConfig cardCount:5];
+    [self.actor postRating:4];
+    [self.actor postEnd];
+    uint64_t second = [self.actor postStartWithMode:MBStudyModeStandard config:self.testConfig cardCount:5];
+    [self.actor postRating:3];
+
+    NSArray<MBStudySessionEvent *> *events = [self settledEvents];
+
+    XCTAssertEqual(events.count, 5u);
+    XCTAssertEqualObjects([events valueForKey:@"session"], (@[@(first), @(first), @(first), @(second), @(second)]));
+}
+
+#pragma mark - Property Tests
+
+- (void)testRandomCommandSequencesMatchReferenceModel {
+    for (NSUInteger sequence = 0; sequence < kRandomSequenceCount; sequence++) {
+        srand48((long)sequence);
+        MBStudySessionActor *actor = [[MBStudySessionActor alloc] initWithDelegateQueue:self.delegateQueue];
+        actor.delegate = self;
+        self.actor = actor;
+
+        NSInteger maxCards = 1 + (NSInteger)(drand48() * 8);
+        MBReferenceSession model = { MBStudySessionStateIdle, MBStudyModeStandard, maxCards, 0 };
+        NSMutableArray<NSNumber *> *expected = [NSMutableArray array];
+
+        for (NSUInteger step = 0; step < kRandomSequenceLength; step++) {
+            MBStudySessionCommandType command = (MBStudySessionCommandType)(drand48() * 6);
+            MBStudyMode mode = drand48() < 0.5 ? MBStudyModeStandard : MBStudyModeVoice;
+            NSInteger rating = (NSInteger)(drand48() * 7);
+
+            switch (command) {
+                case MBStudySessionCommandStart:
+                    [actor postStartWithMode:mode config:[self configWithMaxCards:maxCards] cardCount:maxCards];
+                    break;
+                case MBStudySessionCommandRate:
+                    [actor postRating:rating];
+                    break;
+                case MBStudySessionCommandVoice:
+                    [actor postVoiceInput:@"answer" confidence:0.9];
+                    break;
+                case MBStudySessionCommandPause:
+                    [actor postPause];
+                    break;
+                case MBStudySessionCommandResume:
+                    [actor postResume];
+                    break;
+                case MBStudySessionCommandEnd:
+                    [actor postEnd];
+                    break;
+            }
+            [expected addObjectsFromArray:MBReferenceApply(&model, command, mode, rating)];
+        }
+
+        NSArray<MBStudySessionEvent *> *events = [self settledEvents];
+        XCTAssertEqualObjects([events valueForKey:@"type"], expected,
+                              @"Event stream diverged from reference model for seed %lu", (unsigned long)sequence);
+        XCTAssertEqual(actor.state, model.state, @"Final state diverged for seed %lu", (unsigned long)sequence);
+
+        uint64_t previousTicket = 0;
+        for (MBStudySessionEvent *event in events) {
+            XCTAssertGreaterThanOrEqual(event.ticket, previousTicket, @"Single producer tickets must not reorder");
+            previousTicket = event.ticket;
+        }
+    }
+}
+
+- (void)testConcurrentProducersPreservePerProducerOrder {
+    MBStudyModeConfig config = [self configWithMaxCards:NSIntegerMax];
+    [self.actor postStartWithMode:MBStudyModeStandard config:config cardCount:0];
+    [self settledEvents];
+
+    // Each producer records its tickets in posting order
+    NSMutableArray<NSMutableArray<NSNumber *> *> *posted = [NSMutableArray array];
+    for (NSUInteger i = 0; i < kProducerCount; i++) {
+        [posted addObject:[NSMutableArray arrayWithCapacity:kRatingsPerProducer]];
+    }
+
+    MBStudySessionActor *actor = self.actor;
+    dispatch_apply(kProducerCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t producer) {
+        NSMutableArray<NSNumber *> *tickets = posted[producer];
+        for (NSUInteger i = 0; i < kRatingsPerProducer; i++) {
+            [tickets addObject:@([actor postRating:1 + (NSInteger)(i % 5)])];
+        }
+    });
+
+    NSArray<MBStudySessionEvent *> *events = [self settledEvents];
+    XCTAssertEqual(events.count, kProducerCount * kRatingsPerProducer, @"Every command must yield exactly one event");
+
+    NSMutableDictionary<NSNumber *, NSNumber *> *positionByTicket = [NSMutableDictionary dictionary];
+    [events enumerateObjectsUsingBlock:^(MBStudySessionEvent *event, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqual(event.type, MBStudySessionEventRated);
+        XCTAssertNil(positionByTicket[@(event.ticket)], @"Ticket delivered twice");
+        positionByTicket[@(event.ticket)] = @(idx);
+    }];
+
+    for (NSArray<NSNumber *> *tickets in posted) {
+        NSInteger previous = -1;
+        for (NSNumber *ticket in tickets) {
+            NSNumber *position = positionByTicket[ticket];
+            XCTAssertNotNil(position, @"Ticket %@ was lost", ticket);
+            XCTAssertGreaterThan(position.integerValue, previous, @"Producer order violated at ticket %@", ticket);
+            previous = position.integerValue;
+        }
+    }
+    XCTAssertLessThan(self.batchCount, events.count, @"Events should be delivered in batches");
+}
+
+#pragma mark - Performance Tests
+
+- (void)testRatingLatencyPerCommand {
+    MBStudyModeConfig config = [self configWithMaxCards:NSIntegerMax];
+    [self.actor postStartWithMode:MBStudyModeStandard config:config cardCount:0];
+    [self settledEvents];
+
+    [self measureBlock:^{
+        self.ticketSemaphore = dispatch_semaphore_create(0);
+        uint64_t lastTicket = 0;
+        for (NSUInteger i = 0; i < kBenchmarkRatings; i++) {
+            lastTicket = [self.actor postRating:4];
+        }
+        dispatch_sync(self.delegateQueue, ^{
+            if (self.highestTicket >= lastTicket) {
+                dispatch_semaphore_signal(self.ticketSemaphore);
+            } else {
+                self.awaitedTicket = lastTicket;
+            }
+        });
+        dispatch_semaphore_wait(self.ticketSemaphore, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC));
+    }];
+
+    NSArray<MBStudySessionEvent *> *events = [self settledEvents];
+    uint64_t totalNanos = 0;
+    for (MBStudySessionEvent *event in events) {
+        totalNanos += event.queueLatencyNanos;
+    }
+    NSLog(@"Mean post-to-apply latency per rating: %.0f ns over %lu ratings",
+          events.count > 0 ? totalNanos / (double)events.count : 0.0, (unsigned long)events.count);
+}
+
+#pragma mark - MBStudySessionActorDelegate
+
+- (void)studySessionActor:(MBStudySessionActor *)actor
+            didEmitEvents:(NSArray<MBStudySessionEvent *> *)events {
+    if (actor != self.actor) {
+        return;
+    }
+    self.batchCount++;
+    [self.events addObjectsFromArray:events];
+    self.highestTicket = MAX(self.highestTicket, events.lastObject.ticket);
+
+    if (self.ticketSemaphore && self.awaitedTicket != 0) {
+        for (MBStudySessionEvent *event in events) {
+            if (event.ticket == self.awaitedTicket) {
+                self.awaitedTicket = 0;
+                dispatch_semaphore_signal(self.ticketSemaphore);
+                break;
+            }
+        }
+    }
+}
+
+@end
@@ -0,0 +1,190 @@
+//
+//  TraceRingTests.m
+//  memboTests
+//
+//  Tests for the native trace ring: batch layout, overflow accounting,
+//  multi-thread recording and per-span overhead.
+//
+
+@import XCTest;  // iOS SDK 12.0+
+#import <libkern/OSByteOrder.h>
+#import "Utils/TraceRing.h"
+
+static const NSUInteger kThreadCount = 4;
+static const NSUInteger kSpansPerThread = 500;
+static const NSUInteger kOverheadRounds = 1000;
+static const double kMaxNanosPerSpan = 50.0;
+
+#pragma mark - Batch Parsing
+
+typedef struct {
+    uint64_t start;
+    uint64_t duration;
+    uint16_t span;
+    uint16_t thread;
+    uint32_t arg;
+} MBDecodedSpan;
+
+static NSArray<NSValue *> *MBDecodeBatch(NSData *batch, uint32_t *dropped) {
+    const uint8_t *bytes = batch.bytes;
+    NSCAssert(OSReadLittleInt32(bytes, 0) == MBTraceBatchMagic, @"Bad magic");
+    NSCAssert(OSReadLittleInt16(bytes, 4) == MBTraceBatchVersion, @"Bad version");
+    NSCAssert(OSReadLittleInt16(bytes, 6) == MBTraceBatchRecordSize, @"Bad record size");
+
+    uint32_t count = OSReadLittleInt32(bytes, 8);
+    if (dropped) {
+        *dropped = OSReadLittleInt32(bytes, 12);
+    }
+    NSCAssert(batch.length == MBTraceBatchHeaderSize + count * MBTraceBatchRecordSize, @"Bad length");
+
+    NSMutableArray<NSValue *> *spans = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t i = 0; i < count; i++) {
+        size_t offset = MBTraceBatchHeaderSize + i * MBTraceBatchRecordSize;
+        MBDecodedSpan span = {
+            .start = OSReadLittleInt64(bytes, offset),
+            .duration = OSReadLittleInt64(bytes, offset + 8),
+            .span = OSReadLittleInt16(bytes, offset + 16),
+            .thread = OSReadLittleInt16(bytes, offset + 18),
+            .arg = OSReadLittleInt32(bytes, offset + 20)
+        };
+        [spans addObject:[NSValue valueWithBytes:&span objCType:@encode(MBDecodedSpan)]];
+    }
+    return spans;
+}
+
+static MBDecodedSpan MBSpanAt(NSArray<NSValue *> *spans, NSUInteger index) {
+    MBDecodedSpan span;
+    [spans[index] getValue:&span];
+    return span;
+}
+
+@interface TraceRingTests : XCTestCase
+@end
+
+@implementation TraceRingTests
+
+#pragma mark - Test Lifecycle
+
+- (void)setUp {
+    [super setUp];
+    // Discard spans left by other tests
+    while (MBTraceDrainBatch(NSUIntegerMax)) {}
+}
+
+#pragma mark - Batch Tests
+
+- (void)testEmptyDrainReturnsNil {
+    XCTAssertNil(MBTraceDrainBatch(100));
+}
+
+- (void)testDrainProducesWellFormedBatch {
+    uint64_t start = MBTraceBegin();
+    usleep(1000);
+    MBTraceEnd(MBTraceSpanFileWrite, start, 4096);
+    MBTraceEnd(MBTraceSpanFileRead, MBTraceBegin(), 128);
+
+    NSData *batch = MBTraceDrainBatch(100);
+    XCTAssertNotNil(batch);
+
+    uint32_t dropped = 0;
+    NSArray<NSValue *> *spans = MBDecodeBatch(batch, &dropped);
+    XCTAssertEqual(spans.count, 2u);
+    XCTAssertEqual(dropped, 0u);
+
+    MBDecodedSpan write = MBSpanAt(spans, 0);
+    XCTAssertEqual(write.span, MBTraceSpanFileWrite);
+    XCTAssertEqual(write.arg, 4096u);
+    XCTAssertGreaterThanOrEqual(write.duration, 1000000u, @"Duration is in nanoseconds");
+
+    MBDecodedSpan read = MBSpanAt(spans, 1);
+    XCTAssertEqual(read.span, MBTraceSpanFileRead);
+    XCTAssertEqual(read.thread, write.thread);
+    XCTAssertGreaterThanOrEqual(read.start, write.start);
+}
+
+- (void)testDrainRespectsRecordLimit {
+    for (NSUInteger i = 0; i < 10; i++) {
+        MBTraceEnd(MBTraceSpanFileRead, MBTraceBegin(), (uint32_t)i);
+    }
+
+    NSArray<NSValue *> *first = MBDecodeBatch(MBTraceDrainBatch(4), NULL);
+    NSArray<NSValue *> *rest = MBDecodeBatch(MBTraceDrainBatch(100), NULL);
+    XCTAssertEqual(first.count, 4u);
+    XCTAssertEqual(rest.count, 6u);
+    XCTAssertEqual(MBSpanAt(rest, 0).arg, 4u, @"Remaining spans resume where the last drain stopped");
+}
+
+- (void)testFullRingCountsDroppedSpans {
+    for (NSUInteger i = 0; i < MBTraceRingCapacity + 10; i++) {
+        MBTraceEnd(MBTraceSpanAudioActivate, MBTraceBegin(), (uint32_t)i);
+    }
+
+    uint32_t dropped = 0;
+    NSArray<NSValue *> *spans = MBDecodeBatch(MBTraceDrainBatch(NSUIntegerMax), &dropped);
+    XCTAssertEqual(spans.count, MBTraceRingCapacity);
+    XCTAssertEqual(dropped, 10u);
+    XCTAssertEqual(MBSpanAt(spans, spans.count - 1).arg, MBTraceRingCapacity - 1, @"Newest spans are the ones dropped");
+}
+
+- (void)testConcurrentThreadsPreservePerThreadOrder {
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger t = 0; t < kThreadCount; t++) {
+        dispatch_group_enter(group);
+        [NSThread detachNewThreadWithBlock:^{
+            for (NSUInteger i = 0; i < kSpansPerThread; i++) {
+                MBTraceEnd(MBTraceSpanStudyQueueLoad, MBTraceBegin(), (uint32_t)i);
+            }
+            dispatch_group_leave(group);
+        }];
+    }
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0);
+
+    NSArray<NSValue *> *spans = MBDecodeBatch(MBTraceDrainBatch(NSUIntegerMax), NULL);
+    XCTAssertEqual(spans.count, kThreadCount * kSpansPerThread);
+
+    NSMutableDictionary<NSNumber *, NSNumber *> *nextArgByThread = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < spans.count; i++) {
+        MBDecodedSpan span = MBSpanAt(spans, i);
+        NSNumber *thread = @(span.thread);
+        XCTAssertEqual(span.arg, nextArgByThread[thread].unsignedIntValue);
+        nextArgByThread[thread] = @(span.arg + 1);
+    }
+    XCTAssertEqual(nextArgByThread.count, kThreadCount);
+}
+
+#pragma mark - Performance Tests
+
+- (void)testRecordOverheadPerSpan {
+    // Warm the thread's ring so attachment is not measured
+    MBTraceEnd(MBTraceSpanFileRead, MBTraceBegin(), 0);
+    MBTraceDrainBatch(NSUIntegerMax);
+
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+
+    uint64_t totalTicks = 0;
+    for (NSUInteger round = 0; round < kOverheadRounds; round++) {
+        uint64_t roundStart = mach_absolute_time();
+        for (uint32_t i = 0; i < MBTraceRingCapacity; i++) {
+            MBTraceEnd(MBTraceSpanFileRead, MBTraceBegin(), i);
+        }
+        totalTicks += mach_absolute_time() - roundStart;
+        MBTraceDrainBatch(NSUIntegerMax);
+    }
+
+    double nanosPerSpan = (double)totalTicks * timebase.numer / timebase.denom /
+                          (double)(kOverheadRounds * MBTraceRingCapacity);
+    NSLog(@"[TraceRingTests] %.1f ns per span", nanosPerSpan);
+#ifndef DEBUG
+    XCTAssertLessThan(nanosPerSpan, kMaxNanosPerSpan);
+#endif
+
+    [self measureBlock:^{
+        for (uint32_t i = 0; i < MBTraceRingCapacity; i++) {
+            MBTraceEnd(MBTraceSpanFileRead, MBTraceBegin(), i);
+        }
+        MBTraceDrainBatch(NSUIntegerMax);
+    }];
+}
+
+@end